@@ -3,11 +3,15 @@
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 
-static const char EMPTY_PAGE_DATA[PAGE_SIZE] = {0};
-
 BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager)
     : pool_size_(pool_size), disk_manager_(disk_manager) {
-  pages_ = new Page[pool_size_];
+  page_size_ = disk_manager_->GetPageSize();
+  // one contiguous allocation backs all frames, each page sees a page_size_ slice of it
+  page_data_ = new char[pool_size_ * page_size_];
+  pages_ = static_cast<Page *>(::operator new[](pool_size_ * sizeof(Page)));
+  for (size_t i = 0; i < pool_size_; i++) {
+    new (pages_ + i) Page(page_data_ + i * page_size_, page_size_);
+  }
   replacer_ = new LRUReplacer(pool_size_);
   for (size_t i = 0; i < pool_size_; i++) {
     free_list_.emplace_back(i);
@@ -18,11 +22,16 @@ BufferPoolManager::~BufferPoolManager() {
   for (auto page : page_table_) {
     FlushPage(page.first);
   }
-  delete[] pages_;
+  for (size_t i = 0; i < pool_size_; i++) {
+    pages_[i].~Page();
+  }
+  ::operator delete[](pages_);
+  delete[] page_data_;
   delete replacer_;
 }
 
 Page *BufferPoolManager::FetchPage(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   frame_id_t frame_id;
   // 1.     Search the page table for the requested page (P).
   // 1.1    If P exists, pin it and return it immediately.
@@ -49,7 +58,7 @@ Page *BufferPoolManager::FetchPage(page_id_t page_id) {
     }
 
     // 3.     Delete R from the page table and insert P.
-    page_table_.erase(page_id);
+    page_table_.erase(r->page_id_);
     page_table_[page_id] = frame_id;
 
     // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
@@ -62,7 +71,8 @@ Page *BufferPoolManager::FetchPage(page_id_t page_id) {
   }
 }
 
-Page *BufferPoolManager::NewPage(page_id_t &page_id) {
+Page *BufferPoolManager::NewPage(page_id_t &page_id, uint32_t space_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   // 0.   Make sure you call AllocatePage!
 
 
@@ -75,16 +85,20 @@ Page *BufferPoolManager::NewPage(page_id_t &page_id) {
   }
   if(i == pool_size_) return nullptr ;
 
+  page_id_t new_page = AllocatePage(space_id);
+  if (new_page == INVALID_PAGE_ID) return nullptr;
+
   // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
   frame_id_t victim_frame_id;
   if(!free_list_.empty()){
     victim_frame_id = free_list_.front();
     free_list_.pop_front();
   }else{
-    if(!replacer_->Victim(&victim_frame_id)) return nullptr;
+    if(!replacer_->Victim(&victim_frame_id)){
+      DeallocatePage(new_page);
+      return nullptr;
+    }
   }
-
-  page_id_t new_page = AllocatePage();
   Page *p = pages_ + victim_frame_id;
   if(p->is_dirty_){
     p->is_dirty_ = false;
@@ -105,6 +119,7 @@ Page *BufferPoolManager::NewPage(page_id_t &page_id) {
 }
 
 bool BufferPoolManager::DeletePage(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   // 0.   Make sure you call DeallocatePage!
   disk_manager_->DeAllocatePage(page_id);
   // 1.   Search the page table for the requested page (P).
@@ -118,6 +133,8 @@ bool BufferPoolManager::DeletePage(page_id_t page_id) {
     if (p->pin_count_) return false;
     // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
     page_table_.erase(page_id);
+    // the frame moves to the free list, so the replacer must not hand it out as a victim as well
+    replacer_->Pin(frame_id);
     p->pin_count_ = 0;
     p->page_id_ = INVALID_PAGE_ID;
     p->is_dirty_ = false;
@@ -127,6 +144,7 @@ bool BufferPoolManager::DeletePage(page_id_t page_id) {
 }
 
 bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   if(page_table_.count(page_id) == 0) return true;
   frame_id_t frame_id = page_table_[page_id];
   Page *p = pages_ + frame_id;
@@ -141,6 +159,7 @@ bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
 }
 
 bool BufferPoolManager::FlushPage(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   if(page_table_.count(page_id) == 0) return false;
   frame_id_t frame_id = page_table_[page_id];
   Page *p = pages_ + frame_id;
@@ -149,8 +168,8 @@ bool BufferPoolManager::FlushPage(page_id_t page_id) {
   return true;
 }
 
-page_id_t BufferPoolManager::AllocatePage() {
-  int next_page_id = disk_manager_->AllocatePage();
+page_id_t BufferPoolManager::AllocatePage(uint32_t space_id) {
+  int next_page_id = disk_manager_->AllocatePage(space_id);
   return next_page_id;
 }
 
@@ -159,11 +178,13 @@ void BufferPoolManager::DeallocatePage(__attribute__((unused)) page_id_t page_id
 }
 
 bool BufferPoolManager::IsPageFree(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   return disk_manager_->IsPageFree(page_id);
 }
 
 // Only used for debug
 bool BufferPoolManager::CheckAllUnpinned() {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   bool res = true;
   for (size_t i = 0; i < pool_size_; i++) {
     if (pages_[i].pin_count_ != 0) {
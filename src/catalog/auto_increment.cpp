@@ -0,0 +1,61 @@
+#include "catalog/auto_increment.h"
+
+#include <algorithm>
+
+AutoIncrement::AutoIncrement(uint32_t column_index, int32_t limit, Reserve reserve)
+    : column_index_(column_index), next_(limit), limit_(limit), reserve_(std::move(reserve)) {}
+
+bool AutoIncrement::Fill(Row &row) {
+  Field *&field = row.GetFields()[column_index_];
+  if (!field->IsNull()) {
+    char buf[sizeof(int32_t)];
+    field->SerializeTo(buf);
+    return Observe(MACH_READ_INT32(buf));
+  }
+  int32_t value;
+  if (!Next(value)) {
+    return false;
+  }
+  delete field;
+  field = new Field(TypeId::kTypeInt, value);
+  return true;
+}
+
+bool AutoIncrement::Next(int32_t &value) {
+  int64_t next = next_.fetch_add(1);
+  if (next > INT32_MAX) {
+    return false;
+  }
+  // the common case: the value lies in the block reserved already
+  if (next >= limit_.load() && !ReserveAbove(next)) {
+    return false;
+  }
+  value = static_cast<int32_t>(next);
+  return true;
+}
+
+bool AutoIncrement::Observe(int32_t value) {
+  int64_t next = next_.load();
+  while (next <= value && !next_.compare_exchange_weak(next, static_cast<int64_t>(value) + 1)) {
+  }
+  return value < limit_.load() || ReserveAbove(value);
+}
+
+bool AutoIncrement::ReserveAbove(int64_t value) {
+  std::lock_guard<std::mutex> lock(reserve_latch_);
+  int64_t limit = limit_.load();
+  if (value < limit) {
+    return true;
+  }
+  // the limit is an int, so the counter is exhausted at the largest int and the last block may be short
+  if (value >= INT32_MAX) {
+    return false;
+  }
+  int64_t new_limit = std::min<int64_t>(value + AUTO_INCREMENT_CACHE_SIZE, INT32_MAX);
+  // the limit is written before any value below it is used, so a restart never hands one out again
+  if (!reserve_(static_cast<int32_t>(new_limit))) {
+    return false;
+  }
+  limit_.store(new_limit);
+  return true;
+}
@@ -1,6 +1,24 @@
 #include "catalog/catalog.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "page/dictionary_page.h"
 #include "page/index_roots_page.h"
 
+/** Order of index keys, field by field. */
+static bool KeyLess(const Row &a, const Row &b) {
+  for (size_t i = 0; i < a.GetFieldCount(); i++) {
+    if (a.GetField(i)->CompareLessThan(*b.GetField(i)) == CmpBool::kTrue) {
+      return true;
+    }
+    if (a.GetField(i)->CompareGreaterThan(*b.GetField(i)) == CmpBool::kTrue) {
+      return false;
+    }
+  }
+  return false;
+}
+
 void CatalogMeta::SerializeTo(char *buf) const {
     ASSERT(GetSerializedSize() <= PAGE_SIZE, "Failed to serialize catalog metadata to disk.");
     MACH_WRITE_UINT32(buf, CATALOG_METADATA_MAGIC_NUM);
@@ -74,39 +92,69 @@ CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManag
     }else{
         Page *meta_page = buffer_pool_manager_->FetchPage(CATALOG_META_PAGE_ID);
         catalog_meta_ = CatalogMeta::DeserializeFrom(meta_page->GetData());
-        auto table_cnt = catalog_meta_->GetTableMetaPages()->size();
-        auto index_cnt = catalog_meta_->GetIndexMetaPages()->size();
-        for(unsigned long i=0; i < table_cnt; i++){
-            page_id_t page_id = catalog_meta_->GetTableMetaPages()->at(i);
+        for(auto &table_meta_page : *catalog_meta_->GetTableMetaPages()){
+            page_id_t page_id = table_meta_page.second;
             Page *page = buffer_pool_manager_->FetchPage(page_id);
             char *table_buf = page->GetData();
-            TableMetadata *table_meta;
+            TableMetadata *table_meta = nullptr;
             TableMetadata::DeserializeFrom(table_buf, table_meta);
-            TableHeap *table_heap = TableHeap::Create(buffer_pool_manager_, table_meta->GetFirstPageId() + 1,
-                                                      table_meta->GetSchema(), log_manager_, lock_manager_);
+            // a partitioned table has no heap, its partitions are tables of their own
+            TableHeap *table_heap = nullptr;
+            if(table_meta->GetPartitionScheme() == nullptr){
+                table_heap = TableHeap::Create(buffer_pool_manager_, table_meta->GetFirstPageId(),
+                                               table_meta->GetFreeSpaceMapPageId(), table_meta->GetSchema(),
+                                               log_manager_, lock_manager_, table_meta->GetStorage());
+            }
             TableInfo *table_info = TableInfo::Create();
             table_info->Init(table_meta, table_heap);
+            if(table_meta->HasAutoIncrement()){
+                InitAutoIncrement(table_info);
+            }
+            InitDictionaries(table_info);
             table_names_[table_meta->GetTableName()] = table_meta->GetTableId();
             tables_[table_meta->GetTableId()] = table_info;
-            buffer_pool_manager_->UnpinPage(page_id, true);
+            buffer_pool_manager_->UnpinPage(page_id, false);
         }
-        for(unsigned long i = 0; i < index_cnt; i++){
-            page_id_t page_id = catalog_meta_->GetIndexMetaPages()->at(i);
+        for(auto &iter : tables_){
+            PartitionScheme *scheme = iter.second->GetPartitionScheme();
+            if(scheme == nullptr){
+                continue;
+            }
+            std::vector<TableInfo *> partitions;
+            for(uint32_t i = 0; i < scheme->GetPartitionCount(); i++){
+                TableInfo *partition = nullptr;
+                if(GetTable(scheme->GetTableId(i), partition) != DB_SUCCESS){
+                    LOG(ERROR) << "Partition " << scheme->GetPartitionName(i) << " of table "
+                               << iter.second->GetTableName() << " is missing." << std::endl;
+                    continue;
+                }
+                partitions.push_back(partition);
+            }
+            iter.second->SetPartitions(std::move(partitions));
+        }
+        for(auto &index_meta_page : *catalog_meta_->GetIndexMetaPages()){
+            page_id_t page_id = index_meta_page.second;
             Page *page = buffer_pool_manager_->FetchPage(page_id);
             char *index_buf = page->GetData();
-            IndexMetadata *index_meta;
+            IndexMetadata *index_meta = nullptr;
             IndexMetadata::DeserializeFrom(index_buf, index_meta);
             table_id_t table_id = index_meta->GetTableId();
             TableInfo *table_info = nullptr;
-            assert(GetTable(table_id, table_info) == DB_SUCCESS);
+            if(GetTable(table_id, table_info) != DB_SUCCESS){
+                LOG(ERROR) << "Index " << index_meta->GetIndexName() << " refers to a missing table." << std::endl;
+                delete index_meta;
+                buffer_pool_manager_->UnpinPage(page_id, false);
+                continue;
+            }
             string table_name = table_info->GetTableName();
             IndexInfo *index_info = IndexInfo::Create();
             index_info->Init(index_meta, table_info, buffer_pool_manager_);
             string index_name = index_info->GetIndexName();
-            indexes_[i] = index_info;
-            index_names_[table_name][index_name] = i;
-            buffer_pool_manager_->UnpinPage(page_id, true);
+            indexes_[index_meta->GetIndexId()] = index_info;
+            index_names_[table_name][index_name] = index_meta->GetIndexId();
+            buffer_pool_manager_->UnpinPage(page_id, false);
         }
+        buffer_pool_manager_->UnpinPage(CATALOG_META_PAGE_ID, false);
     }
 }
 
@@ -125,21 +173,92 @@ CatalogManager::~CatalogManager() {
 }
 
 dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schema,
-                                    Transaction *txn, TableInfo *&table_info) {
+                                    Transaction *txn, TableInfo *&table_info, uint32_t space_id,
+                                    TableStorage storage, bool temporary, PartitionScheme *partitions,
+                                    const std::vector<std::string> &cluster_key) {
+  std::unique_ptr<PartitionScheme> scheme(partitions);
   if(table_names_.find(table_name) != table_names_.end()){
     return DB_TABLE_ALREADY_EXIST;
   }
-  table_id_t table_id = catalog_meta_->GetNextTableId();
-  page_id_t page_id;
-  buffer_pool_manager_->NewPage(page_id);
-  page_id_t first_page_id;
-  buffer_pool_manager_->NewPage(first_page_id);
-  TableMetadata *table_meta = TableMetadata::Create(table_id, table_name, first_page_id, schema);
-  TableHeap *table_heap = TableHeap::Create(buffer_pool_manager_, schema, txn, log_manager_, lock_manager_);
+  if(temporary){
+    if(scheme != nullptr){
+      return DB_FAILED;
+    }
+    storage = TableStorage::kMemory;
+  }
+  // a page of a column table has to hold one row at least
+  if(storage == TableStorage::kColumn && ColumnLayout(schema, buffer_pool_manager_->GetPageSize()).GetCapacity() == 0){
+    return DB_FAILED;
+  }
+  // a leaf of a clustered table has to hold a few rows
+  std::vector<uint32_t> key_map;
+  if(storage == TableStorage::kClustered){
+    for(const auto &column_name : cluster_key){
+      uint32_t column_index;
+      if(schema->GetColumnIndex(column_name, column_index) != DB_SUCCESS){
+        return DB_COLUMN_NAME_NOT_EXIST;
+      }
+      key_map.push_back(column_index);
+    }
+    if(key_map.empty() || !ClusteredTable::CanStore(buffer_pool_manager_->GetPageSize(), schema, key_map)){
+      return DB_FAILED;
+    }
+  }
+  // the partitions come first, so the partitioned table knows their ids when its meta data is written
+  std::vector<TableInfo *> partition_tables;
+  if(scheme != nullptr){
+    if(scheme->GetPartitionCount() == 0 || scheme->GetColumnIndex() >= schema->GetColumnCount()){
+      return DB_FAILED;
+    }
+    for(uint32_t i = 0; i < scheme->GetPartitionCount(); i++){
+      if(table_names_.count(PartitionScheme::GetTableName(table_name, scheme->GetPartitionName(i))) != 0){
+        return DB_TABLE_ALREADY_EXIST;
+      }
+    }
+    for(uint32_t i = 0; i < scheme->GetPartitionCount(); i++){
+      TableInfo *partition = nullptr;
+      // every partition has a schema of its own, as it has when the catalog is loaded from disk
+      dberr_t ret = CreateTable(PartitionScheme::GetTableName(table_name, scheme->GetPartitionName(i)),
+                                Schema::DeepCopySchema(schema), txn, partition, space_id, storage, false, nullptr,
+                                cluster_key);
+      if(ret != DB_SUCCESS){
+        for(auto created : partition_tables){
+          DropTable(created->GetTableName());
+        }
+        return ret;
+      }
+      scheme->SetTableId(i, partition->GetTableId());
+      partition_tables.push_back(partition);
+    }
+  }
+  table_id_t table_id = NextTableId();
+  page_id_t page_id = INVALID_PAGE_ID;
+  // a temporary table has no meta page, nothing of it is written to disk
+  if(!temporary){
+    if(buffer_pool_manager_->NewPage(page_id) == nullptr){
+      return DB_FAILED;
+    }
+    buffer_pool_manager_->UnpinPage(page_id, false);
+  }
+  TableHeap *table_heap = nullptr;
+  TableMetadata *table_meta = nullptr;
+  if(scheme == nullptr){
+    table_heap = TableHeap::Create(buffer_pool_manager_, schema, txn, log_manager_, lock_manager_, space_id, storage,
+                                   key_map, NextIndexId());
+    table_meta = TableMetadata::Create(table_id, table_name, table_heap->GetFirstPageId(),
+                                       table_heap->GetFreeSpaceMapPageId(), schema, storage);
+  }else{
+    table_meta = TableMetadata::Create(table_id, table_name, INVALID_PAGE_ID, INVALID_PAGE_ID, schema, storage,
+                                       scheme.release());
+  }
   table_info = TableInfo::Create();
-  table_info->Init(table_meta, table_heap);
+  table_info->Init(table_meta, table_heap, temporary);
+  table_info->SetPartitions(std::move(partition_tables));
   table_names_[table_name] = table_id;
   tables_[table_id] = table_info;
+  if(temporary){
+    return DB_SUCCESS;
+  }
   catalog_meta_->table_meta_pages_[table_id] = page_id;
   Page *table_page = buffer_pool_manager_->FetchPage(page_id);
   char *buf = table_page->GetData();
@@ -169,13 +288,30 @@ dberr_t CatalogManager::GetTables(vector<TableInfo *> &tables) const {
 
 dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string &index_name,
                                     const std::vector<std::string> &index_keys, Transaction *txn,
-                                    IndexInfo *&index_info, const string &index_type) {
+                                    IndexInfo *&index_info, const string &index_type, uint32_t space_id) {
   if(table_names_.find(table_name) == table_names_.end()){
     return DB_TABLE_NOT_EXIST;
   }
   table_id_t table_id = table_names_[table_name];
   TableInfo *table_info = nullptr;
   if(GetTable(table_name, table_info) != DB_SUCCESS) return DB_FAILED;
+  // a partitioned table has local indexes only, one on each partition under the same name
+  if(table_info->IsPartitioned()){
+    for(auto partition : table_info->GetPartitions()){
+      dberr_t ret = CreateIndex(partition->GetTableName(), index_name, index_keys, txn, index_info, index_type,
+                                space_id);
+      if(ret != DB_SUCCESS){
+        for(auto created : table_info->GetPartitions()){
+          if(created == partition){
+            break;
+          }
+          DropIndex(created->GetTableName(), index_name);
+        }
+        return ret;
+      }
+    }
+    return DB_SUCCESS;
+  }
   Schema *schema = table_info->GetSchema();
   uint32_t col_index = 0;
   std::vector<uint32_t> key_attr;
@@ -190,28 +326,41 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
     return DB_INDEX_ALREADY_EXIST;
   }
 
-  page_id_t page_id;
-  buffer_pool_manager_->NewPage(page_id);
-  page_id_t root_page_id;
-  Page *root_page = buffer_pool_manager_->NewPage(root_page_id);
-  auto leaf_page = reinterpret_cast<BPlusTreeLeafPage *>(root_page->GetData());
-  index_id_t index_id = catalog_meta_->GetNextIndexId();
-  auto *index_roots_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
-  index_roots_page->Insert(index_id, root_page_id);
-  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
-  IndexMetadata *index_meta = IndexMetadata::Create(index_id, index_name, table_id, key_attr);
+  // an index of a table in memory takes no root page, and one of a temporary table no meta page either. An index of
+  // a table in an LSM tree is an LSM tree as well, it registers the manifest of its tree itself
+  TableStorage storage = table_info->GetTableHeap()->GetStorage();
+  bool own_root = storage == TableStorage::kMemory || storage == TableStorage::kLsm;
+  page_id_t page_id = INVALID_PAGE_ID;
+  Page *index_page = nullptr;
+  if(!table_info->IsTemporary()){
+    index_page = buffer_pool_manager_->NewPage(page_id);
+    if(index_page == nullptr){
+      return DB_FAILED;
+    }
+  }
+  index_id_t index_id = NextIndexId();
+  if(!own_root){
+    page_id_t root_page_id;
+    buffer_pool_manager_->NewPage(root_page_id, space_id);
+    auto *index_roots_page =
+        reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+    index_roots_page->Insert(index_id, root_page_id);
+    buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+    buffer_pool_manager_->UnpinPage(root_page_id, true);
+  }
+  IndexMetadata *index_meta = IndexMetadata::Create(index_id, index_name, table_id, key_attr, space_id, index_type);
   IndexInfo *new_index = IndexInfo::Create();
   new_index->Init(index_meta, table_info, buffer_pool_manager_);
   index_info = new_index;
   indexes_[index_id] = new_index;
   index_names_[table_name][index_name] = index_id;
-  catalog_meta_->index_meta_pages_[index_id] = page_id;
-  Page* index_page = buffer_pool_manager_->FetchPage(page_id);
-  char* buf = index_page->GetData();
-  index_meta->SerializeTo(buf);
+  if(index_page != nullptr){
+    catalog_meta_->index_meta_pages_[index_id] = page_id;
+    index_meta->SerializeTo(index_page->GetData());
+  }
 
   //插入entry
-  for(auto iter = table_info->GetTableHeap()->Begin(txn); iter != table_info->GetTableHeap()->End(); iter++){
+  for(auto iter = table_info->GetTableHeap()->Begin(txn); iter != table_info->GetTableHeap()->End(); ++iter){
     //投影
     vector<Field> key_field;
     for (auto column : index_info->GetIndexKeySchema()->GetColumns()) {
@@ -222,9 +371,10 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
     Row key(key_field);
     index_info->GetIndex()->InsertEntry(key, (*iter).GetRowId(), txn);
   }
-  buffer_pool_manager_->FlushPage(page_id);
-  buffer_pool_manager_->UnpinPage(page_id, true);
-  buffer_pool_manager_->UnpinPage(root_page_id, true);
+  if(index_page != nullptr){
+    buffer_pool_manager_->FlushPage(page_id);
+    buffer_pool_manager_->UnpinPage(page_id, true);
+  }
   return DB_SUCCESS;
 }
 
@@ -263,15 +413,607 @@ dberr_t CatalogManager::DropTable(const string &table_name) {
   if(GetTable(table_name, table_info) != DB_SUCCESS){
     return DB_TABLE_NOT_EXIST;
   }
-  else{
-    table_id_t table_id = table_info->GetTableId();
-    page_id_t page_id = table_info->GetRootPageId();
-    buffer_pool_manager_->DeletePage(page_id);
-    table_names_.erase(table_name);
-    tables_.erase(table_id);
-    catalog_meta_->table_meta_pages_.erase(table_id);
+  // a partition goes away with DropPartition only, the partitioned table takes all of them along
+  if(table_info->GetParent() != nullptr){
+    return DB_FAILED;
+  }
+  std::vector<TableInfo *> partitions = table_info->GetPartitions();
+  table_info->SetPartitions({});
+  for(auto partition : partitions){
+    DropTable(partition->GetTableName());
+  }
+  // 先删掉表上的索引
+  std::vector<std::string> index_names;
+  for(const auto &iter : index_names_[table_name]){
+    index_names.push_back(iter.first);
+  }
+  for(const auto &index_name : index_names){
+    DropIndex(table_name, index_name);
+  }
+  index_names_.erase(table_name);
+  table_id_t table_id = table_info->GetTableId();
+  bool temporary = table_info->IsTemporary();
+  // 表的页交给后台释放，这里只把它从catalog里摘掉
+  ReclaimTableHeap(table_info->ReplaceTableHeap(nullptr));
+  std::vector<std::pair<uint32_t, page_id_t>> dictionaries = table_info->GetTableMetadata()->GetDictionaries();
+  table_names_.erase(table_name);
+  tables_.erase(table_id);
+  delete table_info;
+  if(temporary){
     return DB_SUCCESS;
   }
+  for(const auto &dictionary : dictionaries){
+    page_id_t page_id = dictionary.second;
+    while(page_id != INVALID_PAGE_ID){
+      auto page = reinterpret_cast<DictionaryPage *>(buffer_pool_manager_->FetchPage(page_id));
+      if(page == nullptr){
+        break;
+      }
+      page_id_t next_page_id = page->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(page->GetDictionaryPageId(), false);
+      buffer_pool_manager_->DeletePage(page->GetDictionaryPageId());
+      page_id = next_page_id;
+    }
+  }
+  buffer_pool_manager_->DeletePage(catalog_meta_->table_meta_pages_[table_id]);
+  catalog_meta_->table_meta_pages_.erase(table_id);
+  return FlushCatalogMetaPage();
+}
+
+dberr_t CatalogManager::TruncateTable(const string &table_name, Transaction *txn) {
+  TableInfo *table_info = nullptr;
+  if (GetTable(table_name, table_info) != DB_SUCCESS) {
+    return DB_TABLE_NOT_EXIST;
+  }
+  if (table_info->IsPartitioned()) {
+    for (auto partition : table_info->GetPartitions()) {
+      if (TruncateTable(partition->GetTableName(), txn) != DB_SUCCESS) {
+        return DB_FAILED;
+      }
+    }
+    return DB_SUCCESS;
+  }
+  TableHeap *old_table_heap = table_info->GetTableHeap();
+  TableStorage storage = old_table_heap->GetStorage();
+  uint32_t space_id = storage == TableStorage::kMemory ? DEFAULT_TABLESPACE_ID
+                                                       : DiskManager::GetTablespaceId(old_table_heap->GetFirstPageId());
+  // a clustered heap takes the key of the old one and trees of its own, the old trees are freed after it
+  std::vector<uint32_t> cluster_key;
+  if (storage == TableStorage::kClustered) {
+    cluster_key = old_table_heap->GetClusteredHeap()->GetKeyMap();
+  }
+  TableHeap *table_heap = TableHeap::Create(buffer_pool_manager_, table_info->GetSchema(), txn, log_manager_,
+                                            lock_manager_, space_id, storage, cluster_key, NextIndexId());
+  std::vector<IndexInfo *> indexes;
+  GetTableIndexes(table_name, indexes);
+  for (auto index_info : indexes) {
+    if (index_info->GetIndex()->Truncate(&page_reclaimer_) != DB_SUCCESS) {
+      LOG(ERROR) << "Index " << index_info->GetIndexName() << " of table " << table_name << " can not be emptied."
+                 << std::endl;
+      ReclaimTableHeap(table_heap);
+      return DB_FAILED;
+    }
+  }
+  ReclaimTableHeap(table_info->ReplaceTableHeap(table_heap));
+  // the table meta now names the first page and the free space map of the new heap
+  return FlushTableMeta(table_info);
+}
+
+dberr_t CatalogManager::AddPartition(const string &table_name, const string &partition_name, const Field *bound,
+                                     Transaction *txn) {
+  TableInfo *table_info = nullptr;
+  if (GetTable(table_name, table_info) != DB_SUCCESS) {
+    return DB_TABLE_NOT_EXIST;
+  }
+  PartitionScheme *scheme = table_info->GetPartitionScheme();
+  uint32_t index;
+  if (scheme == nullptr || scheme->GetKind() != PartitionKind::kRange ||
+      scheme->FindPartition(partition_name, index)) {
+    return DB_FAILED;
+  }
+  // the new partition takes the storage and the local indexes of the first one
+  TableInfo *first = table_info->GetPartitions().front();
+  TableHeap *first_heap = first->GetTableHeap();
+  uint32_t space_id = first_heap->GetStorage() == TableStorage::kMemory
+                          ? DEFAULT_TABLESPACE_ID
+                          : DiskManager::GetTablespaceId(first_heap->GetFirstPageId());
+  std::vector<std::string> cluster_key;
+  if (first_heap->GetStorage() == TableStorage::kClustered) {
+    for (auto column_index : first_heap->GetClusteredHeap()->GetKeyMap()) {
+      cluster_key.push_back(first->GetSchema()->GetColumn(column_index)->GetName());
+    }
+  }
+  if (!scheme->AddPartition(partition_name, 0, bound)) {
+    return DB_FAILED;
+  }
+  TableInfo *partition = nullptr;
+  dberr_t ret = CreateTable(PartitionScheme::GetTableName(table_name, partition_name),
+                            Schema::DeepCopySchema(table_info->GetSchema()), txn, partition, space_id,
+                            first_heap->GetStorage(), false, nullptr, cluster_key);
+  if (ret != DB_SUCCESS) {
+    scheme->RemovePartition(scheme->GetPartitionCount() - 1);
+    return ret;
+  }
+  scheme->SetTableId(scheme->GetPartitionCount() - 1, partition->GetTableId());
+  std::vector<TableInfo *> partitions = table_info->GetPartitions();
+  partitions.push_back(partition);
+  table_info->SetPartitions(std::move(partitions));
+  std::vector<IndexInfo *> indexes;
+  GetTableIndexes(first->GetTableName(), indexes);
+  for (auto index_info : indexes) {
+    std::vector<std::string> index_keys;
+    for (auto column : index_info->GetIndexKeySchema()->GetColumns()) {
+      index_keys.push_back(column->GetName());
+    }
+    IndexInfo *new_index = nullptr;
+    CreateIndex(partition->GetTableName(), index_info->GetIndexName(), index_keys, txn, new_index,
+                index_info->GetIndexType(), index_info->GetTablespaceId());
+  }
+  return FlushTableMeta(table_info);
+}
+
+dberr_t CatalogManager::DropPartition(const string &table_name, const string &partition_name) {
+  TableInfo *table_info = nullptr;
+  if (GetTable(table_name, table_info) != DB_SUCCESS) {
+    return DB_TABLE_NOT_EXIST;
+  }
+  PartitionScheme *scheme = table_info->GetPartitionScheme();
+  uint32_t index;
+  // the rows of a hash partition would belong to the others, and a table keeps one partition at least
+  if (scheme == nullptr || scheme->GetKind() != PartitionKind::kRange ||
+      !scheme->FindPartition(partition_name, index) || scheme->GetPartitionCount() == 1) {
+    return DB_FAILED;
+  }
+  std::vector<TableInfo *> partitions = table_info->GetPartitions();
+  TableInfo *partition = partitions[index];
+  partitions.erase(partitions.begin() + index);
+  table_info->SetPartitions(std::move(partitions));
+  scheme->RemovePartition(index);
+  dberr_t ret = FlushTableMeta(table_info);
+  if (ret != DB_SUCCESS) {
+    return ret;
+  }
+  return DropTable(partition->GetTableName());
+}
+
+dberr_t CatalogManager::TruncatePartition(const string &table_name, const string &partition_name, Transaction *txn) {
+  TableInfo *table_info = nullptr;
+  if (GetTable(table_name, table_info) != DB_SUCCESS) {
+    return DB_TABLE_NOT_EXIST;
+  }
+  PartitionScheme *scheme = table_info->GetPartitionScheme();
+  uint32_t index;
+  if (scheme == nullptr || !scheme->FindPartition(partition_name, index)) {
+    return DB_FAILED;
+  }
+  return TruncateTable(table_info->GetPartitions()[index]->GetTableName(), txn);
+}
+
+dberr_t CatalogManager::AddColumn(const string &table_name, Column *column) {
+  std::unique_ptr<Column> new_column(column);
+  TableInfo *table_info = nullptr;
+  if (GetTable(table_name, table_info) != DB_SUCCESS) {
+    return DB_TABLE_NOT_EXIST;
+  }
+  uint32_t column_index;
+  if (table_info->GetSchema()->GetColumnIndex(column->GetName(), column_index) == DB_SUCCESS ||
+      (column->GetDefault() != nullptr && column->GetDefault()->GetTypeId() != column->GetType())) {
+    return DB_FAILED;
+  }
+  // only a tuple that is read back through Row::DeserializeFrom gets the default, a column page and a row kept in
+  // memory have the fields of the schema they were written with
+  TableHeap *table_heap = table_info->IsPartitioned() ? table_info->GetPartitions().front()->GetTableHeap()
+                                                      : table_info->GetTableHeap();
+  if (table_heap->GetStorage() != TableStorage::kRow && table_heap->GetStorage() != TableStorage::kLsm) {
+    return DB_FAILED;
+  }
+  for (auto partition : table_info->GetPartitions()) {
+    if (AddColumn(partition->GetTableName(), new Column(column)) != DB_SUCCESS) {
+      return DB_FAILED;
+    }
+  }
+  table_info->GetSchema()->AddColumn(new_column.release());
+  return FlushTableMeta(table_info);
+}
+
+dberr_t CatalogManager::SetAutoIncrement(const string &table_name, const string &column_name) {
+  TableInfo *table_info = nullptr;
+  if (GetTable(table_name, table_info) != DB_SUCCESS) {
+    return DB_TABLE_NOT_EXIST;
+  }
+  uint32_t column_index;
+  if (table_info->GetSchema()->GetColumnIndex(column_name, column_index) != DB_SUCCESS) {
+    return DB_COLUMN_NAME_NOT_EXIST;
+  }
+  if (table_info->GetSchema()->GetColumn(column_index)->GetType() != TypeId::kTypeInt || table_info->IsPartitioned() ||
+      table_info->GetTableMetadata()->HasAutoIncrement()) {
+    return DB_FAILED;
+  }
+  // the values start above those the table has
+  int64_t start = 1;
+  TableHeap *table_heap = table_info->GetTableHeap();
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+    const Field *field = iter->GetField(column_index);
+    if (!field->IsNull()) {
+      char buf[sizeof(int32_t)];
+      field->SerializeTo(buf);
+      start = std::max<int64_t>(start, static_cast<int64_t>(MACH_READ_INT32(buf)) + 1);
+    }
+  }
+  if (start > INT32_MAX) {
+    return DB_FAILED;
+  }
+  table_info->GetTableMetadata()->SetAutoIncrement(column_index, static_cast<int32_t>(start));
+  InitAutoIncrement(table_info);
+  return FlushTableMeta(table_info);
+}
+
+void CatalogManager::InitAutoIncrement(TableInfo *table_info) {
+  TableMetadata *table_meta = table_info->GetTableMetadata();
+  uint32_t column_index = table_meta->GetAutoIncrementColumn();
+  table_info->SetAutoIncrement(
+      new AutoIncrement(column_index, table_meta->GetAutoIncrementLimit(), [this, table_info, column_index](int32_t limit) {
+        table_info->GetTableMetadata()->SetAutoIncrement(column_index, limit);
+        return FlushTableMeta(table_info) == DB_SUCCESS;
+      }));
+}
+
+dberr_t CatalogManager::SetDictionary(const string &table_name, const string &column_name) {
+  TableInfo *table_info = nullptr;
+  if (GetTable(table_name, table_info) != DB_SUCCESS) {
+    return DB_TABLE_NOT_EXIST;
+  }
+  uint32_t column_index;
+  if (table_info->GetSchema()->GetColumnIndex(column_name, column_index) != DB_SUCCESS) {
+    return DB_COLUMN_NAME_NOT_EXIST;
+  }
+  Column *column = table_info->GetSchema()->GetColumns()[column_index];
+  if (column->GetType() != TypeId::kTypeChar || column->GetLength() > OVERFLOW_THRESHOLD ||
+      column->IsDictionaryEncoded() || table_info->IsPartitioned() || table_info->IsTemporary()) {
+    return DB_FAILED;
+  }
+  // the rows of the table would hold values where codes are expected
+  TableHeap *table_heap = table_info->GetTableHeap();
+  if (table_heap->GetStorage() != TableStorage::kRow || table_heap->Begin(nullptr) != table_heap->End()) {
+    return DB_FAILED;
+  }
+  page_id_t first_page_id;
+  auto page = reinterpret_cast<DictionaryPage *>(
+      buffer_pool_manager_->NewPage(first_page_id, DiskManager::GetTablespaceId(table_heap->GetFirstPageId())));
+  if (page == nullptr) {
+    return DB_FAILED;
+  }
+  page->Init(first_page_id);
+  buffer_pool_manager_->UnpinPage(first_page_id, true);
+  column->SetDictionaryEncoded();
+  table_info->GetTableMetadata()->AddDictionary(column_index, first_page_id);
+  InitDictionaries(table_info);
+  return FlushTableMeta(table_info);
+}
+
+void CatalogManager::InitDictionaries(TableInfo *table_info) {
+  for (const auto &entry : table_info->GetTableMetadata()->GetDictionaries()) {
+    Column *column = table_info->GetSchema()->GetColumns()[entry.first];
+    if (column->GetDictionary() != nullptr) {
+      continue;
+    }
+    std::vector<std::string> values;
+    page_id_t last_page_id = entry.second;
+    for (page_id_t page_id = entry.second; page_id != INVALID_PAGE_ID;) {
+      auto page = reinterpret_cast<DictionaryPage *>(buffer_pool_manager_->FetchPage(page_id));
+      ASSERT(page != nullptr, "Can not read the dictionary of a column.");
+      page->GetValues(values);
+      last_page_id = page_id;
+      page_id = page->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(last_page_id, false);
+    }
+    auto dictionary = std::make_shared<Dictionary>([this, last_page_id](const std::string &value) mutable {
+      return AppendDictionaryValue(last_page_id, value);
+    });
+    dictionary->Load(values);
+    column->SetDictionary(std::move(dictionary));
+  }
+}
+
+bool CatalogManager::AppendDictionaryValue(page_id_t &last_page_id, const std::string &value) {
+  auto page = reinterpret_cast<DictionaryPage *>(buffer_pool_manager_->FetchPage(last_page_id));
+  if (page == nullptr) {
+    return false;
+  }
+  if (page->Append(value)) {
+    buffer_pool_manager_->FlushPage(last_page_id);
+    buffer_pool_manager_->UnpinPage(last_page_id, true);
+    return true;
+  }
+  // the last page is full, the value starts a new one behind it
+  page_id_t new_page_id;
+  auto new_page = reinterpret_cast<DictionaryPage *>(
+      buffer_pool_manager_->NewPage(new_page_id, DiskManager::GetTablespaceId(last_page_id)));
+  if (new_page == nullptr) {
+    buffer_pool_manager_->UnpinPage(last_page_id, false);
+    return false;
+  }
+  new_page->Init(new_page_id);
+  if (!new_page->Append(value)) {
+    buffer_pool_manager_->UnpinPage(new_page_id, false);
+    buffer_pool_manager_->DeletePage(new_page_id);
+    buffer_pool_manager_->UnpinPage(last_page_id, false);
+    return false;
+  }
+  buffer_pool_manager_->FlushPage(new_page_id);
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+  page->SetNextPageId(new_page_id);
+  buffer_pool_manager_->FlushPage(last_page_id);
+  buffer_pool_manager_->UnpinPage(last_page_id, true);
+  last_page_id = new_page_id;
+  return true;
+}
+
+dberr_t CatalogManager::FlushTableMeta(TableInfo *table_info) {
+  if (table_info->IsTemporary()) {
+    return DB_SUCCESS;
+  }
+  page_id_t meta_page_id = catalog_meta_->table_meta_pages_[table_info->GetTableId()];
+  Page *meta_page = buffer_pool_manager_->FetchPage(meta_page_id);
+  if (meta_page == nullptr) {
+    return DB_FAILED;
+  }
+  table_info->GetTableMetadata()->SerializeTo(meta_page->GetData());
+  buffer_pool_manager_->FlushPage(meta_page_id);
+  buffer_pool_manager_->UnpinPage(meta_page_id, true);
+  return DB_SUCCESS;
+}
+
+dberr_t CatalogManager::FlushIndexMeta(IndexInfo *index_info) {
+  auto meta_page_id = catalog_meta_->index_meta_pages_.find(index_info->GetIndexMetadata()->GetIndexId());
+  // the index of a temporary table has no meta page
+  if (meta_page_id == catalog_meta_->index_meta_pages_.end()) {
+    return DB_SUCCESS;
+  }
+  Page *meta_page = buffer_pool_manager_->FetchPage(meta_page_id->second);
+  if (meta_page == nullptr) {
+    return DB_FAILED;
+  }
+  index_info->GetIndexMetadata()->SerializeTo(meta_page->GetData());
+  buffer_pool_manager_->FlushPage(meta_page_id->second);
+  buffer_pool_manager_->UnpinPage(meta_page_id->second, true);
+  return DB_SUCCESS;
+}
+
+void CatalogManager::ReclaimTableHeap(TableHeap *table_heap) {
+  if (table_heap == nullptr) {
+    return;
+  }
+  // the trees of a clustered heap leave the index roots page now, their ids may be handed out again right away
+  if (table_heap->GetStorage() == TableStorage::kClustered) {
+    table_heap->GetClusteredHeap()->Destroy(&page_reclaimer_);
+    page_reclaimer_.Submit([table_heap] { delete table_heap; });
+    return;
+  }
+  // the schema the heap reads its overflow chains with is never freed, so it outlives the table meta data
+  page_reclaimer_.Submit([table_heap] {
+    table_heap->FreeTableHeap();
+    delete table_heap;
+  });
+}
+
+dberr_t CatalogManager::VacuumTable(const string &table_name, uint32_t &pages_reclaimed, uint32_t &rows_moved,
+                                    Transaction *txn) {
+  TableInfo *table_info = nullptr;
+  if (GetTable(table_name, table_info) != DB_SUCCESS) {
+    return DB_TABLE_NOT_EXIST;
+  }
+  if (table_info->IsPartitioned()) {
+    pages_reclaimed = 0;
+    rows_moved = 0;
+    for (auto partition : table_info->GetPartitions()) {
+      uint32_t partition_pages = 0, partition_rows = 0;
+      if (VacuumTable(partition->GetTableName(), partition_pages, partition_rows, txn) != DB_SUCCESS) {
+        return DB_FAILED;
+      }
+      pages_reclaimed += partition_pages;
+      rows_moved += partition_rows;
+    }
+    return DB_SUCCESS;
+  }
+  TableHeap *table_heap = table_info->GetTableHeap();
+  std::vector<std::pair<RowId, RowId>> moved_rids;
+  pages_reclaimed = table_heap->Vacuum(moved_rids, txn);
+  rows_moved = moved_rids.size();
+  std::vector<IndexInfo *> indexes;
+  GetTableIndexes(table_name, indexes);
+  if (indexes.empty()) {
+    return DB_SUCCESS;
+  }
+  // the rows have moved for good, so every pair is applied, and an index that missed one is built again from the heap
+  std::vector<bool> stale(indexes.size(), false);
+  for (const auto &moved : moved_rids) {
+    Row row(moved.second);
+    if (!table_heap->GetTuple(&row, txn)) {
+      LOG(ERROR) << "Vacuumed row of table " << table_name << " can not be read back." << std::endl;
+      stale.assign(indexes.size(), true);
+      break;
+    }
+    for (size_t i = 0; i < indexes.size(); i++) {
+      Row key_row;
+      row.GetKeyFromRow(table_info->GetSchema(), indexes[i]->GetIndexKeySchema(), key_row);
+      if (!stale[i] && indexes[i]->GetIndex()->UpdateEntry(key_row, moved.first, moved.second, txn) != DB_SUCCESS) {
+        LOG(WARNING) << "Index " << indexes[i]->GetIndexName() << " has no entry for a vacuumed row, rebuilding it."
+                     << std::endl;
+        stale[i] = true;
+      }
+    }
+  }
+  dberr_t ret = DB_SUCCESS;
+  for (size_t i = 0; i < indexes.size(); i++) {
+    if (stale[i] && RebuildIndex(table_info, indexes[i], txn) != DB_SUCCESS) {
+      ret = DB_FAILED;
+    }
+  }
+  return ret;
+}
+
+dberr_t CatalogManager::RebuildIndex(TableInfo *table_info, IndexInfo *index_info, Transaction *txn) {
+  if (index_info->GetIndex()->Truncate(&page_reclaimer_) != DB_SUCCESS) {
+    LOG(ERROR) << "Index " << index_info->GetIndexName() << " can not be emptied." << std::endl;
+    return DB_FAILED;
+  }
+  TableHeap *table_heap = table_info->GetTableHeap();
+  std::vector<Row> keys;
+  for (auto iter = table_heap->Begin(txn); iter != table_heap->End(); ++iter) {
+    keys.emplace_back();
+    iter->GetKeyFromRow(table_info->GetSchema(), index_info->GetIndexKeySchema(), keys.back());
+    keys.back().SetRowId(iter->GetRowId());
+  }
+  std::vector<const Row *> sorted_keys;
+  sorted_keys.reserve(keys.size());
+  for (auto &key : keys) {
+    sorted_keys.push_back(&key);
+  }
+  std::sort(sorted_keys.begin(), sorted_keys.end(), [](const Row *a, const Row *b) { return KeyLess(*a, *b); });
+  if (index_info->GetIndex()->InsertSortedEntries(sorted_keys, txn) != DB_SUCCESS) {
+    LOG(ERROR) << "Index " << index_info->GetIndexName() << " can not be rebuilt." << std::endl;
+    return DB_FAILED;
+  }
+  return DB_SUCCESS;
+}
+
+dberr_t CatalogManager::ClusterTable(const string &table_name, const string &index_name, Transaction *txn) {
+  TableInfo *table_info = nullptr;
+  if (GetTable(table_name, table_info) != DB_SUCCESS) {
+    return DB_TABLE_NOT_EXIST;
+  }
+  if (table_info->IsPartitioned()) {
+    for (auto partition : table_info->GetPartitions()) {
+      dberr_t ret = ClusterTable(partition->GetTableName(), index_name, txn);
+      if (ret != DB_SUCCESS) {
+        return ret;
+      }
+    }
+    return DB_SUCCESS;
+  }
+  IndexInfo *cluster_index = nullptr;
+  if (GetIndex(table_name, index_name, cluster_index) != DB_SUCCESS) {
+    return DB_INDEX_NOT_FOUND;
+  }
+  TableHeap *old_table_heap = table_info->GetTableHeap();
+  TableStorage storage = old_table_heap->GetStorage();
+  auto *tree = dynamic_cast<BPlusTreeIndex *>(cluster_index->GetIndex());
+  if ((storage != TableStorage::kRow && storage != TableStorage::kColumn) || tree == nullptr) {
+    LOG(WARNING) << "Only tables stored by row or by column can be clustered." << std::endl;
+    return DB_FAILED;
+  }
+  // read the heap once, then lay its rows out in the order the index walks them
+  std::vector<Row> heap_rows;
+  std::unordered_map<int64_t, size_t> positions;
+  for (auto iter = old_table_heap->Begin(txn); iter != old_table_heap->End(); ++iter) {
+    positions.emplace(iter->GetRowId().Get(), heap_rows.size());
+    heap_rows.emplace_back(*iter);
+  }
+  std::vector<Row> rows;
+  rows.reserve(heap_rows.size());
+  std::vector<bool> taken(heap_rows.size(), false);
+  for (auto iter = tree->GetBeginIterator(); iter != tree->GetEndIterator(); ++iter) {
+    auto position = positions.find((*iter).second.Get());
+    if (position != positions.end() && !taken[position->second]) {
+      taken[position->second] = true;
+      rows.emplace_back(std::move(heap_rows[position->second]));
+    }
+  }
+  for (size_t i = 0; i < heap_rows.size(); i++) {
+    if (!taken[i]) {
+      rows.emplace_back(std::move(heap_rows[i]));
+    }
+  }
+  heap_rows.clear();
+  TableHeap *table_heap =
+      TableHeap::Create(buffer_pool_manager_, table_info->GetSchema(), txn, log_manager_, lock_manager_,
+                        DiskManager::GetTablespaceId(old_table_heap->GetFirstPageId()), storage);
+  if (table_heap == nullptr || !table_heap->BulkInsertTuples(rows, txn)) {
+    LOG(ERROR) << "Rows of table " << table_name << " can not be written to a new heap." << std::endl;
+    ReclaimTableHeap(table_heap);
+    return DB_FAILED;
+  }
+  // the trees of every index with the new row ids are built next to the old ones, nothing the table reads changes
+  // until all of them are there
+  std::vector<IndexInfo *> indexes;
+  GetTableIndexes(table_name, indexes);
+  std::vector<page_id_t> root_page_ids;
+  auto abandon = [&]() {
+    for (auto root_page_id : root_page_ids) {
+      BPlusTree::FreeTree(buffer_pool_manager_, root_page_id);
+    }
+    ReclaimTableHeap(table_heap);
+    return DB_FAILED;
+  };
+  for (auto index_info : indexes) {
+    auto *index = dynamic_cast<BPlusTreeIndex *>(index_info->GetIndex());
+    std::vector<Row> keys(rows.size());
+    std::vector<const Row *> sorted_keys;
+    sorted_keys.reserve(keys.size());
+    for (size_t j = 0; j < rows.size(); j++) {
+      rows[j].GetKeyFromRow(table_info->GetSchema(), index_info->GetIndexKeySchema(), keys[j]);
+      keys[j].SetRowId(rows[j].GetRowId());
+      sorted_keys.push_back(&keys[j]);
+    }
+    std::sort(sorted_keys.begin(), sorted_keys.end(), [](const Row *a, const Row *b) { return KeyLess(*a, *b); });
+    page_id_t root_page_id = INVALID_PAGE_ID;
+    if (index == nullptr || index->BuildSortedTree(sorted_keys, root_page_id) != DB_SUCCESS) {
+      LOG(ERROR) << "Index " << index_info->GetIndexName() << " of table " << table_name << " can not be rebuilt."
+                 << std::endl;
+      return abandon();
+    }
+    root_page_ids.push_back(root_page_id);
+  }
+  // the old heap stays in place if the table cannot point at the new one
+  table_info->ReplaceTableHeap(table_heap);
+  if (FlushTableMeta(table_info) != DB_SUCCESS) {
+    table_info->ReplaceTableHeap(old_table_heap);
+    return abandon();
+  }
+  ReclaimTableHeap(old_table_heap);
+  // the new heap holds the rows in the order they were inserted in
+  positions.clear();
+  for (size_t i = 0; i < rows.size(); i++) {
+    positions.emplace(rows[i].GetRowId().Get(), i);
+  }
+  dberr_t ret = DB_SUCCESS;
+  for (size_t i = 0; i < indexes.size(); i++) {
+    dynamic_cast<BPlusTreeIndex *>(indexes[i]->GetIndex())->ReplaceTree(root_page_ids[i], &page_reclaimer_);
+    indexes[i]->GetIndexMetadata()->SetCorrelation(MeasureCorrelation(indexes[i], positions));
+    if (FlushIndexMeta(indexes[i]) != DB_SUCCESS) {
+      ret = DB_FAILED;
+    }
+  }
+  return ret;
+}
+
+double CatalogManager::MeasureCorrelation(IndexInfo *index_info,
+                                          const std::unordered_map<int64_t, size_t> &positions) {
+  auto *tree = dynamic_cast<BPlusTreeIndex *>(index_info->GetIndex());
+  if (tree == nullptr) {
+    return NAN;
+  }
+  double n = 0, sum_x = 0, sum_y = 0, sum_xx = 0, sum_yy = 0, sum_xy = 0;
+  for (auto iter = tree->GetBeginIterator(); iter != tree->GetEndIterator(); ++iter) {
+    auto position = positions.find((*iter).second.Get());
+    if (position == positions.end()) {
+      continue;
+    }
+    double x = n, y = position->second;
+    n++;
+    sum_x += x;
+    sum_y += y;
+    sum_xx += x * x;
+    sum_yy += y * y;
+    sum_xy += x * y;
+  }
+  double var_x = n * sum_xx - sum_x * sum_x;
+  double var_y = n * sum_yy - sum_y * sum_y;
+  if (n < 2 || var_x <= 0 || var_y <= 0) {
+    return NAN;
+  }
+  return (n * sum_xy - sum_x * sum_y) / std::sqrt(var_x * var_y);
 }
 
 dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_name) {
@@ -280,23 +1022,79 @@ dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_
   if(GetTable(table_name, table_info) != DB_SUCCESS ){
     return DB_TABLE_NOT_EXIST;
   }
+  if(table_info->IsPartitioned()){
+    dberr_t ret = DB_INDEX_NOT_FOUND;
+    for(auto partition : table_info->GetPartitions()){
+      if(DropIndex(partition->GetTableName(), index_name) == DB_SUCCESS){
+        ret = DB_SUCCESS;
+      }
+    }
+    return ret;
+  }
   if(GetIndex(table_name, index_name, index_info) != DB_SUCCESS){
     return DB_INDEX_NOT_FOUND;
   }
   index_id_t index_id = index_names_[table_name][index_name];
+  // B+树的页交给后台释放
+  index_info->GetIndex()->Destroy(&page_reclaimer_);
   index_names_[table_name].erase(index_name);
   indexes_.erase(index_id);
+  delete index_info;
+  if(table_info->IsTemporary()){
+    return DB_SUCCESS;
+  }
   page_id_t page_id = catalog_meta_->index_meta_pages_[index_id];
+  catalog_meta_->index_meta_pages_.erase(index_id);
   buffer_pool_manager_->DeletePage(page_id);
+  return FlushCatalogMetaPage();
+}
+
+dberr_t CatalogManager::DropTemporaryTables() {
+  std::vector<std::string> table_names;
+  for (const auto &iter : tables_) {
+    if (iter.second->IsTemporary()) {
+      table_names.push_back(iter.second->GetTableName());
+    }
+  }
+  for (const auto &table_name : table_names) {
+    if (DropTable(table_name) != DB_SUCCESS) {
+      return DB_FAILED;
+    }
+  }
   return DB_SUCCESS;
 }
 
+table_id_t CatalogManager::NextTableId() const {
+  table_id_t table_id = catalog_meta_->GetNextTableId();
+  for (const auto &iter : tables_) {
+    table_id = std::max(table_id, iter.first + 1);
+  }
+  return table_id;
+}
+
+index_id_t CatalogManager::NextIndexId() const {
+  index_id_t index_id = catalog_meta_->GetNextIndexId();
+  for (const auto &iter : indexes_) {
+    index_id = std::max(index_id, iter.first + 1);
+  }
+  for (const auto &iter : tables_) {
+    TableHeap *table_heap = iter.second->GetTableHeap();
+    if (table_heap != nullptr && table_heap->GetStorage() == TableStorage::kClustered) {
+      for (auto tree_id : table_heap->GetClusteredHeap()->GetIndexIds()) {
+        index_id = std::max(index_id, tree_id + 1);
+      }
+    }
+  }
+  return index_id;
+}
+
 
 dberr_t CatalogManager::FlushCatalogMetaPage() const {
   Page* meta = buffer_pool_manager_->FetchPage(CATALOG_META_PAGE_ID);
-  char* buf = reinterpret_cast<char *>(meta);
+  char* buf = meta->GetData();
   catalog_meta_->SerializeTo(buf);
   buffer_pool_manager_->FlushPage(CATALOG_META_PAGE_ID); // 暂时注释掉，可能导致重复写入的问题
+  buffer_pool_manager_->UnpinPage(CATALOG_META_PAGE_ID, false);
   return DB_SUCCESS;
 }
 
@@ -0,0 +1,476 @@
+#include "catalog/database_vacuum.h"
+
+#include <memory>
+#include <queue>
+
+#include "catalog/catalog.h"
+#include "glog/logging.h"
+#include "page/b_plus_tree_internal_page.h"
+#include "page/b_plus_tree_leaf_page.h"
+#include "page/clustered_meta_page.h"
+#include "page/column_page.h"
+#include "page/compressed_block_page.h"
+#include "page/dictionary_page.h"
+#include "page/free_space_map_page.h"
+#include "page/index_roots_page.h"
+#include "page/lsm_filter_page.h"
+#include "page/lsm_manifest_page.h"
+#include "page/lsm_run_page.h"
+#include "page/overflow_page.h"
+#include "page/table_page.h"
+
+DatabaseVacuum::DatabaseVacuum(DiskManager *disk_manager)
+    : disk_manager_(disk_manager), page_size_(disk_manager->GetPageSize()) {}
+
+dberr_t DatabaseVacuum::Run(VacuumStats &stats) {
+  stats.bytes_before_ = disk_manager_->GetFileSize();
+  CollectLivePages();
+  stats.live_pages_ = live_pages_.size();
+  stats.heap_locality_before_ = GetHeapLocality(false);
+  stats.heap_locality_after_ = GetHeapLocality(true);
+  uint32_t allocated_pages = 0;
+  for (auto space_id : disk_manager_->GetTablespaceIds()) {
+    allocated_pages += disk_manager_->GetAllocatedPages(space_id);
+  }
+  stats.released_pages_ = allocated_pages > live_pages_.size() ? allocated_pages - live_pages_.size() : 0;
+  for (auto &iter : new_ids_) {
+    if (iter.first != iter.second) {
+      stats.moved_pages_++;
+    }
+  }
+  MovePages();
+  for (auto space_id : disk_manager_->GetTablespaceIds()) {
+    disk_manager_->ShrinkTablespace(space_id, space_page_counts_[space_id]);
+  }
+  stats.bytes_after_ = disk_manager_->GetFileSize();
+  return DB_SUCCESS;
+}
+
+void DatabaseVacuum::AddLivePage(page_id_t page_id, PageKind kind) {
+  ASSERT(new_ids_.find(page_id) == new_ids_.end(), "Page is referred to twice.");
+  uint32_t space_id = DiskManager::GetTablespaceId(page_id);
+  page_id_t new_page_id = static_cast<page_id_t>(space_id << TABLESPACE_PAGE_BITS) | space_page_counts_[space_id]++;
+  live_pages_.emplace_back(page_id, kind);
+  new_ids_[page_id] = new_page_id;
+  kinds_[page_id] = kind;
+}
+
+void DatabaseVacuum::AddLsmTree(page_id_t manifest_page_id) {
+  std::unique_ptr<char[]> buf(new char[page_size_]);
+  Page page(buf.get(), page_size_);
+  auto *manifest_page = static_cast<LsmManifestPage *>(&page);
+  auto *run_page = static_cast<LsmRunPage *>(&page);
+  auto *filter_page = static_cast<LsmFilterPage *>(&page);
+  std::vector<LsmManifestPage::RunRecord> runs;
+  while (manifest_page_id != INVALID_PAGE_ID) {
+    AddLivePage(manifest_page_id, PageKind::kLsmManifest);
+    disk_manager_->ReadPage(manifest_page_id, buf.get());
+    for (uint32_t i = 0; i < manifest_page->GetCount(); i++) {
+      runs.push_back(manifest_page->GetRecord(i));
+    }
+    manifest_page_id = manifest_page->GetNextPageId();
+  }
+  // a run, its fences and its filter are each a chain of their own
+  for (auto &run : runs) {
+    for (page_id_t page_id = run.first_page_id_; page_id != INVALID_PAGE_ID; page_id = run_page->GetNextPageId()) {
+      AddLivePage(page_id, PageKind::kLsmRun);
+      disk_manager_->ReadPage(page_id, buf.get());
+    }
+    for (page_id_t page_id = run.fence_page_id_; page_id != INVALID_PAGE_ID; page_id = run_page->GetNextPageId()) {
+      AddLivePage(page_id, PageKind::kLsmFence);
+      disk_manager_->ReadPage(page_id, buf.get());
+    }
+    for (page_id_t page_id = run.filter_page_id_; page_id != INVALID_PAGE_ID;
+         page_id = filter_page->GetNextPageId()) {
+      AddLivePage(page_id, PageKind::kLsmFilter);
+      disk_manager_->ReadPage(page_id, buf.get());
+    }
+  }
+}
+
+void DatabaseVacuum::AddTree(page_id_t root_page_id, PageKind kind) {
+  std::unique_ptr<char[]> buf(new char[page_size_]);
+  auto *tree_page = reinterpret_cast<BPlusTreePage *>(buf.get());
+  std::queue<page_id_t> pages;
+  pages.push(root_page_id);
+  while (!pages.empty()) {
+    page_id_t page_id = pages.front();
+    pages.pop();
+    AddLivePage(page_id, kind);
+    disk_manager_->ReadPage(page_id, buf.get());
+    if (tree_page->GetPageType() != IndexPageType::INTERNAL_PAGE) {
+      continue;
+    }
+    auto *internal_page = reinterpret_cast<InternalPage *>(buf.get());
+    for (int i = 0; i < internal_page->GetSize(); i++) {
+      pages.push(internal_page->ValueAt(i));
+    }
+  }
+}
+
+void DatabaseVacuum::CollectLivePages() {
+  std::unique_ptr<char[]> buf(new char[page_size_]);
+  disk_manager_->ReadPage(CATALOG_META_PAGE_ID, buf.get());
+  std::unique_ptr<CatalogMeta> catalog_meta(CatalogMeta::DeserializeFrom(buf.get()));
+  // metadata first, the catalog reads all of it whenever the database is opened
+  AddLivePage(CATALOG_META_PAGE_ID, PageKind::kCatalogMeta);
+  AddLivePage(INDEX_ROOTS_PAGE_ID, PageKind::kIndexRoots);
+  for (auto &iter : *catalog_meta->GetTableMetaPages()) {
+    AddLivePage(iter.second, PageKind::kTableMeta);
+  }
+  for (auto &iter : *catalog_meta->GetIndexMetaPages()) {
+    AddLivePage(iter.second, PageKind::kIndexMeta);
+  }
+  // then every table heap in chain order, followed by its free space map, the overflow chains of its values and the
+  // dictionaries of its encoded columns
+  Page page(buf.get(), page_size_);
+  auto *table_page = static_cast<TablePage *>(&page);
+  auto *fsm_page = static_cast<FreeSpaceMapPage *>(&page);
+  auto *overflow_page = static_cast<OverflowPage *>(&page);
+  auto *dictionary_page = static_cast<DictionaryPage *>(&page);
+  auto *block_page = static_cast<CompressedBlockPage *>(&page);
+  std::unordered_map<table_id_t, TableStorage> storages;
+  for (auto &iter : *catalog_meta->GetTableMetaPages()) {
+    disk_manager_->ReadPage(iter.second, buf.get());
+    TableMetadata *table_meta = nullptr;
+    TableMetadata::DeserializeFrom(buf.get(), table_meta);
+    storages[table_meta->GetTableId()] = table_meta->GetStorage();
+    if (table_meta->GetStorage() == TableStorage::kLsm) {
+      page_id_t manifest_page_id = table_meta->GetFirstPageId();
+      delete table_meta->GetSchema();
+      delete table_meta;
+      AddLsmTree(manifest_page_id);
+      continue;
+    }
+    if (table_meta->GetStorage() == TableStorage::kClustered) {
+      page_id_t meta_page_id = table_meta->GetFirstPageId();
+      delete table_meta->GetSchema();
+      delete table_meta;
+      AddLivePage(meta_page_id, PageKind::kClusteredMeta);
+      disk_manager_->ReadPage(meta_page_id, buf.get());
+      auto *meta_page = static_cast<ClusteredMetaPage *>(&page);
+      std::vector<index_id_t> tree_ids{meta_page->GetPrimaryIndexId(), meta_page->GetRowIdIndexId()};
+      disk_manager_->ReadPage(INDEX_ROOTS_PAGE_ID, buf.get());
+      std::vector<page_id_t> root_page_ids;
+      for (auto tree_id : tree_ids) {
+        page_id_t root_page_id;
+        if (reinterpret_cast<IndexRootsPage *>(buf.get())->GetRootId(tree_id, &root_page_id) &&
+            root_page_id != INVALID_PAGE_ID) {
+          root_page_ids.push_back(root_page_id);
+        }
+        clustered_tree_ids_.push_back(tree_id);
+      }
+      for (auto root_page_id : root_page_ids) {
+        AddTree(root_page_id, PageKind::kClusteredTree);
+      }
+      continue;
+    }
+    page_id_t page_id = table_meta->GetFirstPageId();
+    page_id_t fsm_page_id = table_meta->GetFreeSpaceMapPageId();
+    PageKind heap_kind = PageKind::kTableHeap;
+    if (table_meta->GetStorage() == TableStorage::kColumn) {
+      heap_kind = PageKind::kColumnHeap;
+    } else if (table_meta->GetStorage() == TableStorage::kCompressed) {
+      heap_kind = PageKind::kCompressedBlock;
+    }
+    // the schema is needed again to find and rewrite the overflow references in the tuples
+    schemas_.emplace_back(table_meta->GetSchema());
+    Schema *schema = schemas_.back().get();
+    std::vector<std::pair<uint32_t, page_id_t>> dictionaries = table_meta->GetDictionaries();
+    delete table_meta;
+    heap_chains_.emplace_back();
+    std::vector<page_id_t> overflows;
+    while (page_id != INVALID_PAGE_ID) {
+      AddLivePage(page_id, heap_kind);
+      heap_chains_.back().push_back(page_id);
+      disk_manager_->ReadPage(page_id, buf.get());
+      if (heap_kind == PageKind::kTableHeap) {
+        heap_schemas_[page_id] = schema;
+        table_page->RemapOverflows(schema, [&overflows](page_id_t first_page_id) {
+          overflows.push_back(first_page_id);
+          return first_page_id;
+        });
+      }
+      page_id = heap_kind == PageKind::kCompressedBlock ? block_page->GetNextPageId() : table_page->GetNextPageId();
+    }
+    while (fsm_page_id != INVALID_PAGE_ID) {
+      AddLivePage(fsm_page_id, PageKind::kFreeSpaceMap);
+      disk_manager_->ReadPage(fsm_page_id, buf.get());
+      fsm_page_id = fsm_page->GetNextPageId();
+    }
+    for (auto overflow_page_id : overflows) {
+      while (overflow_page_id != INVALID_PAGE_ID) {
+        AddLivePage(overflow_page_id, PageKind::kOverflow);
+        disk_manager_->ReadPage(overflow_page_id, buf.get());
+        overflow_page_id = overflow_page->GetNextPageId();
+      }
+    }
+    for (auto &dictionary : dictionaries) {
+      for (page_id_t dictionary_page_id = dictionary.second; dictionary_page_id != INVALID_PAGE_ID;) {
+        AddLivePage(dictionary_page_id, PageKind::kDictionary);
+        disk_manager_->ReadPage(dictionary_page_id, buf.get());
+        dictionary_page_id = dictionary_page->GetNextPageId();
+      }
+    }
+  }
+  // and every B+ tree level by level, an index of a table in an LSM tree is an LSM tree whose manifest is registered
+  // as its root
+  std::vector<std::pair<page_id_t, TableStorage>> indexes;
+  for (auto &iter : *catalog_meta->GetIndexMetaPages()) {
+    disk_manager_->ReadPage(iter.second, buf.get());
+    IndexMetadata *index_meta = nullptr;
+    IndexMetadata::DeserializeFrom(buf.get(), index_meta);
+    TableStorage storage = storages[index_meta->GetTableId()];
+    delete index_meta;
+    disk_manager_->ReadPage(INDEX_ROOTS_PAGE_ID, buf.get());
+    page_id_t root_page_id;
+    if (reinterpret_cast<IndexRootsPage *>(buf.get())->GetRootId(iter.first, &root_page_id) &&
+        root_page_id != INVALID_PAGE_ID) {
+      indexes.emplace_back(root_page_id, storage);
+    }
+  }
+  for (auto &index : indexes) {
+    if (index.second == TableStorage::kLsm) {
+      AddLsmTree(index.first);
+    } else {
+      AddTree(index.first, index.second == TableStorage::kClustered ? PageKind::kClusteredTree : PageKind::kIndexTree);
+    }
+  }
+}
+
+page_id_t DatabaseVacuum::Remap(page_id_t page_id) const {
+  auto iter = new_ids_.find(page_id);
+  return iter == new_ids_.end() ? page_id : iter->second;
+}
+
+void DatabaseVacuum::RemapPage(page_id_t new_page_id, PageKind kind, char *buf) {
+  switch (kind) {
+    case PageKind::kCatalogMeta: {
+      std::unique_ptr<CatalogMeta> catalog_meta(CatalogMeta::DeserializeFrom(buf));
+      for (auto &iter : *catalog_meta->GetTableMetaPages()) {
+        iter.second = Remap(iter.second);
+      }
+      for (auto &iter : *catalog_meta->GetIndexMetaPages()) {
+        iter.second = Remap(iter.second);
+      }
+      catalog_meta->SerializeTo(buf);
+      break;
+    }
+    case PageKind::kIndexRoots: {
+      // the catalog meta page keeps its page id and remapping it leaves the index ids alone
+      std::unique_ptr<char[]> meta_buf(new char[page_size_]);
+      disk_manager_->ReadPage(CATALOG_META_PAGE_ID, meta_buf.get());
+      std::unique_ptr<CatalogMeta> catalog_meta(CatalogMeta::DeserializeFrom(meta_buf.get()));
+      auto *roots_page = reinterpret_cast<IndexRootsPage *>(buf);
+      std::vector<index_id_t> index_ids = clustered_tree_ids_;
+      for (auto &iter : *catalog_meta->GetIndexMetaPages()) {
+        index_ids.push_back(iter.first);
+      }
+      for (auto index_id : index_ids) {
+        page_id_t root_page_id;
+        if (roots_page->GetRootId(index_id, &root_page_id)) {
+          roots_page->Update(index_id, Remap(root_page_id));
+        }
+      }
+      break;
+    }
+    case PageKind::kTableMeta: {
+      TableMetadata *table_meta = nullptr;
+      TableMetadata::DeserializeFrom(buf, table_meta);
+      table_meta->root_page_id_ = Remap(table_meta->root_page_id_);
+      table_meta->fsm_page_id_ = Remap(table_meta->fsm_page_id_);
+      for (auto &dictionary : table_meta->dictionaries_) {
+        dictionary.second = Remap(dictionary.second);
+      }
+      table_meta->SerializeTo(buf);
+      delete table_meta->GetSchema();
+      delete table_meta;
+      break;
+    }
+    case PageKind::kIndexMeta:
+      break;
+    case PageKind::kTableHeap: {
+      Page page(buf, page_size_);
+      auto *table_page = static_cast<TablePage *>(&page);
+      Schema *schema = heap_schemas_.at(table_page->GetTablePageId());
+      memcpy(buf, &new_page_id, sizeof(page_id_t));
+      table_page->SetPrevPageId(Remap(table_page->GetPrevPageId()));
+      table_page->SetNextPageId(Remap(table_page->GetNextPageId()));
+      table_page->RemapForwards([this](page_id_t page_id) { return Remap(page_id); });
+      table_page->RemapOverflows(schema, [this](page_id_t page_id) { return Remap(page_id); });
+      break;
+    }
+    case PageKind::kColumnHeap: {
+      // rows of a column page never move, only the links of the chain change
+      Page page(buf, page_size_);
+      auto *column_page = static_cast<ColumnPage *>(&page);
+      memcpy(buf, &new_page_id, sizeof(page_id_t));
+      column_page->SetPrevPageId(Remap(column_page->GetPrevPageId()));
+      column_page->SetNextPageId(Remap(column_page->GetNextPageId()));
+      break;
+    }
+    case PageKind::kCompressedBlock: {
+      // the rows of a block never move, only the links of the chain change
+      Page page(buf, page_size_);
+      auto *block_page = static_cast<CompressedBlockPage *>(&page);
+      memcpy(buf, &new_page_id, sizeof(page_id_t));
+      block_page->SetNextPageId(Remap(block_page->GetNextPageId()));
+      break;
+    }
+    case PageKind::kOverflow: {
+      Page page(buf, page_size_);
+      auto *overflow_page = static_cast<OverflowPage *>(&page);
+      memcpy(buf, &new_page_id, sizeof(page_id_t));
+      overflow_page->SetNextPageId(Remap(overflow_page->GetNextPageId()));
+      break;
+    }
+    case PageKind::kDictionary: {
+      Page page(buf, page_size_);
+      auto *dictionary_page = static_cast<DictionaryPage *>(&page);
+      memcpy(buf, &new_page_id, sizeof(page_id_t));
+      dictionary_page->SetNextPageId(Remap(dictionary_page->GetNextPageId()));
+      break;
+    }
+    case PageKind::kFreeSpaceMap: {
+      Page page(buf, page_size_);
+      auto *fsm_page = static_cast<FreeSpaceMapPage *>(&page);
+      memcpy(buf, &new_page_id, sizeof(page_id_t));
+      fsm_page->SetNextPageId(Remap(fsm_page->GetNextPageId()));
+      for (uint32_t i = 0; i < fsm_page->GetCount(); i++) {
+        fsm_page->SetHeapPageId(i, Remap(fsm_page->GetHeapPageId(i)));
+      }
+      break;
+    }
+    case PageKind::kLsmManifest: {
+      Page page(buf, page_size_);
+      auto *manifest_page = static_cast<LsmManifestPage *>(&page);
+      memcpy(buf, &new_page_id, sizeof(page_id_t));
+      manifest_page->SetNextPageId(Remap(manifest_page->GetNextPageId()));
+      for (uint32_t i = 0; i < manifest_page->GetCount(); i++) {
+        LsmManifestPage::RunRecord record = manifest_page->GetRecord(i);
+        record.first_page_id_ = Remap(record.first_page_id_);
+        record.fence_page_id_ = Remap(record.fence_page_id_);
+        record.filter_page_id_ = Remap(record.filter_page_id_);
+        manifest_page->SetRecord(i, record);
+      }
+      break;
+    }
+    case PageKind::kLsmRun: {
+      // runs never change, only the links of the chain do
+      Page page(buf, page_size_);
+      auto *run_page = static_cast<LsmRunPage *>(&page);
+      memcpy(buf, &new_page_id, sizeof(page_id_t));
+      run_page->SetNextPageId(Remap(run_page->GetNextPageId()));
+      break;
+    }
+    case PageKind::kLsmFence: {
+      Page page(buf, page_size_);
+      auto *fence_page = static_cast<LsmRunPage *>(&page);
+      memcpy(buf, &new_page_id, sizeof(page_id_t));
+      fence_page->SetNextPageId(Remap(fence_page->GetNextPageId()));
+      // the page id is the whole value, the last bytes of each entry
+      std::string key;
+      std::string value;
+      bool deleted;
+      for (uint32_t offset = LsmRunPage::GetFirstOffset(); offset < fence_page->GetDataEnd();) {
+        offset = fence_page->ReadEntry(offset, &key, &value, &deleted);
+        page_id_t run_page_id;
+        memcpy(&run_page_id, value.data(), sizeof(page_id_t));
+        run_page_id = Remap(run_page_id);
+        memcpy(buf + offset - sizeof(page_id_t), &run_page_id, sizeof(page_id_t));
+      }
+      break;
+    }
+    case PageKind::kLsmFilter: {
+      Page page(buf, page_size_);
+      auto *filter_page = static_cast<LsmFilterPage *>(&page);
+      memcpy(buf, &new_page_id, sizeof(page_id_t));
+      filter_page->SetNextPageId(Remap(filter_page->GetNextPageId()));
+      break;
+    }
+    case PageKind::kClusteredMeta:
+      // the trees are found through the index roots page, the meta page only names itself
+      memcpy(buf, &new_page_id, sizeof(page_id_t));
+      break;
+    case PageKind::kIndexTree:
+    case PageKind::kClusteredTree: {
+      auto *tree_page = reinterpret_cast<BPlusTreePage *>(buf);
+      tree_page->SetPageId(new_page_id);
+      tree_page->SetParentPageId(Remap(tree_page->GetParentPageId()));
+      if (tree_page->IsLeafPage()) {
+        auto *leaf_page = reinterpret_cast<LeafPage *>(buf);
+        leaf_page->SetNextPageId(Remap(leaf_page->GetNextPageId()));
+        for (int i = 0; i < leaf_page->GetSize() && kind == PageKind::kIndexTree; i++) {
+          RowId rid = leaf_page->ValueAt(i);
+          leaf_page->SetValueAt(i, RowId(Remap(rid.GetPageId()), rid.GetSlotNum()));
+        }
+      } else {
+        auto *internal_page = reinterpret_cast<InternalPage *>(buf);
+        for (int i = 0; i < internal_page->GetSize(); i++) {
+          internal_page->SetValueAt(i, Remap(internal_page->ValueAt(i)));
+        }
+      }
+      break;
+    }
+  }
+}
+
+void DatabaseVacuum::MovePages() {
+  // new page id -> old page id of the page moving there
+  std::unordered_map<page_id_t, page_id_t> sources;
+  for (auto &iter : new_ids_) {
+    sources[iter.second] = iter.first;
+  }
+  std::unique_ptr<char[]> buf(new char[page_size_]);
+  std::unordered_map<page_id_t, bool> done;
+  auto move_chain = [&](page_id_t target) {
+    // target is either free or already saved aside, pull in the page that moves there and continue with its slot
+    auto source = sources.find(target);
+    while (source != sources.end() && !done[source->second]) {
+      page_id_t old_page_id = source->second;
+      disk_manager_->ReadPage(old_page_id, buf.get());
+      RemapPage(target, kinds_[old_page_id], buf.get());
+      disk_manager_->WritePage(target, buf.get());
+      done[old_page_id] = true;
+      target = old_page_id;
+      source = sources.find(target);
+    }
+  };
+  // chains that start at a slot no live page occupies
+  for (auto &iter : new_ids_) {
+    if (new_ids_.find(iter.second) == new_ids_.end()) {
+      move_chain(iter.second);
+    }
+  }
+  // the remaining pages form cycles, keep one page of each cycle aside while the others move
+  std::unique_ptr<char[]> saved(new char[page_size_]);
+  for (auto &live_page : live_pages_) {
+    page_id_t page_id = live_page.first;
+    if (done[page_id]) {
+      continue;
+    }
+    disk_manager_->ReadPage(page_id, saved.get());
+    done[page_id] = true;
+    move_chain(page_id);
+    // the chain stops at the slot the saved page moves to
+    page_id_t target = new_ids_[page_id];
+    RemapPage(target, live_page.second, saved.get());
+    disk_manager_->WritePage(target, saved.get());
+  }
+}
+
+double DatabaseVacuum::GetHeapLocality(bool remapped) const {
+  uint32_t links = 0;
+  uint32_t sequential_links = 0;
+  for (auto &chain : heap_chains_) {
+    for (size_t i = 1; i < chain.size(); i++) {
+      page_id_t prev = remapped ? Remap(chain[i - 1]) : chain[i - 1];
+      page_id_t next = remapped ? Remap(chain[i]) : chain[i];
+      links++;
+      if (next == prev + 1) {
+        sequential_links++;
+      }
+    }
+  }
+  return links == 0 ? 1.0 : static_cast<double>(sequential_links) / links;
+}
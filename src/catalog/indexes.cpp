@@ -1,12 +1,18 @@
 #include "catalog/indexes.h"
 
 IndexMetadata::IndexMetadata(const index_id_t index_id, const std::string &index_name, const table_id_t table_id,
-                             const std::vector<uint32_t> &key_map)
-    : index_id_(index_id), index_name_(index_name), table_id_(table_id), key_map_(key_map) {}
+                             const std::vector<uint32_t> &key_map, uint32_t space_id, const std::string &index_type)
+    : index_id_(index_id),
+      index_name_(index_name),
+      table_id_(table_id),
+      key_map_(key_map),
+      space_id_(space_id),
+      index_type_(index_type) {}
 
 IndexMetadata *IndexMetadata::Create(const index_id_t index_id, const string &index_name, const table_id_t table_id,
-                                     const vector<uint32_t> &key_map) {
-  return new IndexMetadata(index_id, index_name, table_id, key_map);
+                                     const vector<uint32_t> &key_map, uint32_t space_id,
+                                     const std::string &index_type) {
+  return new IndexMetadata(index_id, index_name, table_id, key_map, space_id, index_type);
 }
 
 uint32_t IndexMetadata::SerializeTo(char *buf) const {
@@ -35,14 +41,26 @@ uint32_t IndexMetadata::SerializeTo(char *buf) const {
         MACH_WRITE_UINT32(buf, col_index);
         buf += 4;
     }
+    // tablespace
+    MACH_WRITE_UINT32(buf, space_id_);
+    buf += 4;
+    // index type
+    MACH_WRITE_UINT32(buf, index_type_.length());
+    buf += 4;
+    MACH_WRITE_STRING(buf, index_type_);
+    buf += index_type_.length();
+    // correlation
+    MACH_WRITE_TO(double, buf, correlation_);
+    buf += 8;
     ASSERT(buf - p == ofs, "Unexpected serialize size.");
     return ofs;
 }
 
 uint32_t IndexMetadata::GetSerializedSize() const {
     uint32_t cnt = 0;
-    cnt += 20;
+    cnt += 36;
     cnt += index_name_.length();
+    cnt += index_type_.length();
     cnt += 4 * key_map_.size();
     return cnt;
 }
@@ -77,15 +95,28 @@ uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta) {
         buf += 4;
         key_map.push_back(key_index);
     }
+    // tablespace
+    uint32_t space_id = MACH_READ_UINT32(buf);
+    buf += 4;
+    // index type
+    len = MACH_READ_UINT32(buf);
+    buf += 4;
+    std::string index_type(buf, len);
+    buf += len;
+    // correlation
+    double correlation = MACH_READ_FROM(double, buf);
+    buf += 8;
     // allocate space for index meta data
-    index_meta = new IndexMetadata(index_id, index_name, table_id, key_map);
+    index_meta = new IndexMetadata(index_id, index_name, table_id, key_map, space_id, index_type);
+    index_meta->correlation_ = correlation;
     return buf - p;
 }
 
 Index *IndexInfo::CreateIndex(BufferPoolManager *buffer_pool_manager, const string &index_type) {
   size_t max_size = 0;
   for (auto col : key_schema_->GetColumns()) {
-    max_size += col->GetLength();
+    // an encoded column keeps the code of its value
+    max_size += col->IsDictionaryEncoded() ? sizeof(int32_t) : col->GetLength();
   }
 
   if (index_type == "bptree") {
@@ -106,5 +137,10 @@ Index *IndexInfo::CreateIndex(BufferPoolManager *buffer_pool_manager, const stri
   } else {
     return nullptr;
   }
-  return new BPlusTreeIndex(meta_data_->index_id_, key_schema_, max_size, buffer_pool_manager);
+  return new BPlusTreeIndex(meta_data_->index_id_, key_schema_, max_size, buffer_pool_manager, meta_data_->space_id_);
+}
+
+Index *IndexInfo::CreateMemoryIndex(const string &index_type) {
+  auto kind = index_type == "hash" ? MemoryIndex::Kind::kHash : MemoryIndex::Kind::kOrdered;
+  return new MemoryIndex(meta_data_->index_id_, key_schema_, kind);
 }
@@ -0,0 +1,190 @@
+#include "catalog/partition.h"
+
+#include "common/macros.h"
+
+PartitionScheme::PartitionScheme(PartitionKind kind, uint32_t column_index, TypeId type)
+    : kind_(kind), column_index_(column_index), type_(type) {}
+
+bool PartitionScheme::AddPartition(const std::string &name, table_id_t table_id, const Field *bound) {
+  if (kind_ == PartitionKind::kHash && bound != nullptr) {
+    return false;
+  }
+  if (bound != nullptr && (bound->IsNull() || bound->GetTypeId() != type_)) {
+    return false;
+  }
+  // nothing goes above MAXVALUE, and every bound lies above the one before
+  if (kind_ == PartitionKind::kRange && !partitions_.empty()) {
+    const Field *last = partitions_.back().bound_.get();
+    if (last == nullptr || (bound != nullptr && last->CompareLessThan(*bound) != CmpBool::kTrue)) {
+      return false;
+    }
+  }
+  Partition partition;
+  partition.name_ = name;
+  partition.table_id_ = table_id;
+  if (bound != nullptr) {
+    partition.bound_ = std::make_unique<Field>(*bound);
+  }
+  partitions_.push_back(std::move(partition));
+  return true;
+}
+
+void PartitionScheme::RemovePartition(uint32_t index) {
+  ASSERT(index < partitions_.size(), "Invalid partition.");
+  partitions_.erase(partitions_.begin() + index);
+}
+
+bool PartitionScheme::Locate(const Field &value, uint32_t &index) const {
+  if (partitions_.empty() || (!value.IsNull() && value.GetTypeId() != type_)) {
+    return false;
+  }
+  if (value.IsNull()) {
+    index = 0;
+    return true;
+  }
+  if (kind_ == PartitionKind::kHash) {
+    index = HashValue(value) % partitions_.size();
+    return true;
+  }
+  // the first partition whose bound lies above the value
+  uint32_t low = 0, high = partitions_.size();
+  while (low < high) {
+    uint32_t mid = (low + high) / 2;
+    const Field *bound = partitions_[mid].bound_.get();
+    if (bound == nullptr || value.CompareLessThan(*bound) == CmpBool::kTrue) {
+      high = mid;
+    } else {
+      low = mid + 1;
+    }
+  }
+  index = low;
+  return low < partitions_.size();
+}
+
+bool PartitionScheme::MayMatch(uint32_t index, CompareOp op, const Field &constant) const {
+  if (constant.IsNull() || constant.GetTypeId() != type_) {
+    return true;
+  }
+  if (kind_ == PartitionKind::kHash) {
+    uint32_t match;
+    return op != CompareOp::kEqual || (Locate(constant, match) && match == index);
+  }
+  // the partition holds the values in [lower, upper), either end may be open
+  const Field *lower = index == 0 ? nullptr : partitions_[index - 1].bound_.get();
+  const Field *upper = partitions_[index].bound_.get();
+  bool above_lower = lower == nullptr || lower->CompareLessThanEquals(constant) == CmpBool::kTrue;
+  bool below_upper = upper == nullptr || constant.CompareLessThan(*upper) == CmpBool::kTrue;
+  switch (op) {
+    case CompareOp::kEqual:
+      return above_lower && below_upper;
+    case CompareOp::kLessThan:
+      return lower == nullptr || lower->CompareLessThan(constant) == CmpBool::kTrue;
+    case CompareOp::kLessThanEquals:
+      return above_lower;
+    case CompareOp::kGreaterThan:
+    case CompareOp::kGreaterThanEquals:
+      return below_upper;
+    default:
+      return true;
+  }
+}
+
+bool PartitionScheme::FindPartition(const std::string &name, uint32_t &index) const {
+  for (uint32_t i = 0; i < partitions_.size(); i++) {
+    if (partitions_[i].name_ == name) {
+      index = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool PartitionScheme::IsUnbounded() const {
+  return kind_ == PartitionKind::kRange && !partitions_.empty() && partitions_.back().bound_ == nullptr;
+}
+
+uint32_t PartitionScheme::SerializeTo(char *buf) const {
+  char *p = buf;
+  MACH_WRITE_UINT32(buf, static_cast<uint32_t>(kind_));
+  buf += 4;
+  MACH_WRITE_UINT32(buf, column_index_);
+  buf += 4;
+  MACH_WRITE_UINT32(buf, partitions_.size());
+  buf += 4;
+  for (auto &partition : partitions_) {
+    MACH_WRITE_UINT32(buf, partition.name_.length());
+    buf += 4;
+    MACH_WRITE_STRING(buf, partition.name_);
+    buf += partition.name_.length();
+    MACH_WRITE_TO(table_id_t, buf, partition.table_id_);
+    buf += 4;
+    MACH_WRITE_UINT32(buf, partition.bound_ != nullptr);
+    buf += 4;
+    if (partition.bound_ != nullptr) {
+      buf += partition.bound_->SerializeTo(buf);
+    }
+  }
+  return buf - p;
+}
+
+uint32_t PartitionScheme::GetSerializedSize() const {
+  uint32_t size = 12;
+  for (auto &partition : partitions_) {
+    size += 12 + partition.name_.length();
+    if (partition.bound_ != nullptr) {
+      size += partition.bound_->GetSerializedSize();
+    }
+  }
+  return size;
+}
+
+uint32_t PartitionScheme::DeserializeFrom(char *buf, const Schema *schema, PartitionScheme *&scheme) {
+  char *p = buf;
+  auto kind = static_cast<PartitionKind>(MACH_READ_UINT32(buf));
+  buf += 4;
+  uint32_t column_index = MACH_READ_UINT32(buf);
+  buf += 4;
+  uint32_t count = MACH_READ_UINT32(buf);
+  buf += 4;
+  TypeId type = schema->GetColumn(column_index)->GetType();
+  scheme = new PartitionScheme(kind, column_index, type);
+  for (uint32_t i = 0; i < count; i++) {
+    Partition partition;
+    uint32_t len = MACH_READ_UINT32(buf);
+    buf += 4;
+    partition.name_ = std::string(buf, len);
+    buf += len;
+    partition.table_id_ = MACH_READ_FROM(table_id_t, buf);
+    buf += 4;
+    bool bounded = MACH_READ_UINT32(buf) != 0;
+    buf += 4;
+    if (bounded) {
+      Field *bound = nullptr;
+      buf += Field::DeserializeFrom(buf, type, &bound, false);
+      partition.bound_.reset(bound);
+    }
+    scheme->partitions_.push_back(std::move(partition));
+  }
+  return buf - p;
+}
+
+uint32_t PartitionScheme::HashValue(const Field &value) {
+  // FNV-1a over the bytes of the value, the same on every run so rows stay in their partitions
+  char buf[sizeof(uint32_t)];
+  const char *data = buf;
+  uint32_t len = sizeof(buf);
+  if (value.GetTypeId() == TypeId::kTypeChar) {
+    data = value.GetData();
+    len = value.GetLength();
+  } else {
+    value.SerializeTo(buf);
+  }
+  uint32_t hash = 2166136261u;
+  for (uint32_t i = 0; i < len; i++) {
+    hash = (hash ^ static_cast<uint8_t>(data[i])) * 16777619u;
+  }
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6bu;
+  hash ^= hash >> 13;
+  return hash;
+}
@@ -18,17 +18,47 @@ uint32_t TableMetadata::SerializeTo(char *buf) const {
     // table heap root page id
     MACH_WRITE_TO(page_id_t, buf, root_page_id_);
     buf += 4;
+    // free space map page id
+    MACH_WRITE_TO(page_id_t, buf, fsm_page_id_);
+    buf += 4;
+    // storage of the table heap
+    MACH_WRITE_UINT32(buf, static_cast<uint32_t>(storage_));
+    buf += 4;
     // table schema
     buf += schema_->SerializeTo(buf);
+    // partition scheme, if the table is partitioned
+    MACH_WRITE_UINT32(buf, partitions_ != nullptr);
+    buf += 4;
+    if (partitions_ != nullptr) {
+        buf += partitions_->SerializeTo(buf);
+    }
+    // auto_increment column, and the limit of the values it may have handed out
+    MACH_WRITE_UINT32(buf, auto_increment_column_);
+    buf += 4;
+    MACH_WRITE_INT32(buf, auto_increment_limit_);
+    buf += 4;
+    // dictionary encoded columns, and the first page of their dictionaries
+    MACH_WRITE_UINT32(buf, dictionaries_.size());
+    buf += 4;
+    for (const auto &dictionary : dictionaries_) {
+        MACH_WRITE_UINT32(buf, dictionary.first);
+        buf += 4;
+        MACH_WRITE_TO(page_id_t, buf, dictionary.second);
+        buf += 4;
+    }
     ASSERT(buf - p == ofs, "Unexpected serialize size.");
     return ofs;
 }
 
 uint32_t TableMetadata::GetSerializedSize() const {
     uint32_t cnt = 0;
-    cnt += 16;
+    cnt += 40;
     cnt += table_name_.length();
+    cnt += dictionaries_.size() * 8;
     cnt += schema_->GetSerializedSize();
+    if (partitions_ != nullptr) {
+        cnt += partitions_->GetSerializedSize();
+    }
     return cnt;
 }
 
@@ -52,11 +82,44 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta) {
     // table heap root page id
     page_id_t root_page_id = MACH_READ_FROM(page_id_t, buf);
     buf += 4;
+    // free space map page id
+    page_id_t fsm_page_id = MACH_READ_FROM(page_id_t, buf);
+    buf += 4;
+    // storage of the table heap
+    auto storage = static_cast<TableStorage>(MACH_READ_UINT32(buf));
+    buf += 4;
     // table schema
     TableSchema *schema = nullptr;
     buf += TableSchema::DeserializeFrom(buf, schema);
+    // partition scheme
+    PartitionScheme *partitions = nullptr;
+    bool partitioned = MACH_READ_UINT32(buf) != 0;
+    buf += 4;
+    if (partitioned) {
+        buf += PartitionScheme::DeserializeFrom(buf, schema, partitions);
+    }
+    // auto_increment column
+    uint32_t auto_increment_column = MACH_READ_UINT32(buf);
+    buf += 4;
+    int32_t auto_increment_limit = MACH_READ_INT32(buf);
+    buf += 4;
+    // dictionary encoded columns
+    uint32_t dictionary_count = MACH_READ_UINT32(buf);
+    buf += 4;
+    std::vector<std::pair<uint32_t, page_id_t>> dictionaries;
+    for (uint32_t i = 0; i < dictionary_count; i++) {
+        uint32_t column_index = MACH_READ_UINT32(buf);
+        buf += 4;
+        page_id_t first_page_id = MACH_READ_FROM(page_id_t, buf);
+        buf += 4;
+        dictionaries.emplace_back(column_index, first_page_id);
+    }
     // allocate space for table metadata
-    table_meta = new TableMetadata(table_id, table_name, root_page_id, schema);
+    table_meta = new TableMetadata(table_id, table_name, root_page_id, fsm_page_id, schema, storage, partitions);
+    table_meta->SetAutoIncrement(auto_increment_column, auto_increment_limit);
+    for (const auto &dictionary : dictionaries) {
+        table_meta->AddDictionary(dictionary.first, dictionary.second);
+    }
     return buf - p;
 }
 
@@ -66,10 +129,19 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta) {
  * @param heap Memory heap passed by TableInfo
  */
 TableMetadata *TableMetadata::Create(table_id_t table_id, std::string table_name, page_id_t root_page_id,
-                                     TableSchema *schema) {
+                                     page_id_t fsm_page_id, TableSchema *schema, TableStorage storage,
+                                     PartitionScheme *partitions) {
   // allocate space for table metadata
-  return new TableMetadata(table_id, table_name, root_page_id, schema);
+  return new TableMetadata(table_id, table_name, root_page_id, fsm_page_id, schema, storage, partitions);
 }
 
-TableMetadata::TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema)
-    : table_id_(table_id), table_name_(table_name), root_page_id_(root_page_id), schema_(schema) {}
+TableMetadata::TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id,
+                             page_id_t fsm_page_id, TableSchema *schema, TableStorage storage,
+                             PartitionScheme *partitions)
+    : table_id_(table_id),
+      table_name_(table_name),
+      root_page_id_(root_page_id),
+      fsm_page_id_(fsm_page_id),
+      storage_(storage),
+      schema_(schema),
+      partitions_(partitions) {}
@@ -3,16 +3,23 @@
 //
 #include "common/instance.h"
 
-DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer_pool_size)
+#include <algorithm>
+#include <chrono>
+
+#include "glog/logging.h"
+
+DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer_pool_size, uint32_t page_size)
     : db_file_name_(std::move(db_name)), init_(init) {
   // Init database file if needed
   db_file_name_ = "./databases/"+db_file_name_;
   if (init_) {
-    remove(db_file_name_.c_str());
+    DiskManager::RemoveDatabaseFiles(db_file_name_);
   }
   // Initialize components
-  disk_mgr_ = new DiskManager(db_file_name_);
-  bpm_ = new BufferPoolManager(buffer_pool_size, disk_mgr_);
+  disk_mgr_ = new DiskManager(db_file_name_, page_size);
+  // larger pages get proportionally fewer frames, so the pool keeps the same memory footprint
+  size_t frames = std::max<size_t>(1, static_cast<size_t>(buffer_pool_size) * PAGE_SIZE / disk_mgr_->GetPageSize());
+  bpm_ = new BufferPoolManager(frames, disk_mgr_);
 
   // Allocate static page for db storage engine
   if (init) {
@@ -42,6 +49,7 @@ DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer
 }
 
 DBStorageEngine::~DBStorageEngine() {
+  StopAutoVacuum();
   delete catalog_mgr_;
   delete bpm_;
   delete disk_mgr_;
@@ -50,3 +58,58 @@ DBStorageEngine::~DBStorageEngine() {
 std::unique_ptr<ExecuteContext> DBStorageEngine::MakeExecuteContext(Transaction *txn) {
   return std::make_unique<ExecuteContext>(txn, catalog_mgr_, bpm_);
 }
+
+dberr_t DBStorageEngine::VacuumDatabase(VacuumStats &stats) {
+  // the vacuum moves pages behind the back of the buffer pool, so everything cached is written back and dropped first
+  size_t frames = bpm_->GetPoolSize();
+  delete catalog_mgr_;
+  delete bpm_;
+  dberr_t ret = DatabaseVacuum(disk_mgr_).Run(stats);
+  bpm_ = new BufferPoolManager(frames, disk_mgr_);
+  catalog_mgr_ = new CatalogManager(bpm_, nullptr, nullptr, false);
+  return ret;
+}
+
+void DBStorageEngine::StartAutoVacuum(uint32_t interval_ms, double free_space_ratio) {
+  StopAutoVacuum();
+  auto_vacuum_stop_ = false;
+  auto_vacuum_thread_ = std::thread(&DBStorageEngine::AutoVacuumLoop, this, interval_ms, free_space_ratio);
+}
+
+void DBStorageEngine::StopAutoVacuum() {
+  if (!auto_vacuum_thread_.joinable()) {
+    return;
+  }
+  {
+    std::scoped_lock<std::mutex> lock(auto_vacuum_latch_);
+    auto_vacuum_stop_ = true;
+  }
+  auto_vacuum_cv_.notify_all();
+  auto_vacuum_thread_.join();
+}
+
+void DBStorageEngine::AutoVacuumLoop(uint32_t interval_ms, double free_space_ratio) {
+  std::unique_lock<std::mutex> lock(auto_vacuum_latch_);
+  auto stopped = [this] { return auto_vacuum_stop_; };
+  while (!auto_vacuum_cv_.wait_for(lock, std::chrono::milliseconds(interval_ms), stopped)) {
+    std::scoped_lock<std::recursive_mutex> statement_lock(statement_latch_);
+    std::vector<TableInfo *> tables;
+    catalog_mgr_->GetTables(tables);
+    for (auto table_info : tables) {
+      TableHeap *table_heap = table_info->GetTableHeap();
+      // a partitioned table has no heap, its partitions are vacuumed as tables of their own
+      if (table_heap == nullptr) {
+        continue;
+      }
+      double ratio = table_heap->GetFreeSpaceRatio();
+      // a heap whose free space adds up to less than a page has nothing to give back
+      if (ratio < free_space_ratio || ratio * table_heap->GetPageCount() < 1) {
+        continue;
+      }
+      uint32_t pages_reclaimed = 0, rows_moved = 0;
+      catalog_mgr_->VacuumTable(table_info->GetTableName(), pages_reclaimed, rows_moved, nullptr);
+      LOG(INFO) << "Auto vacuum of table " << table_info->GetTableName() << " reclaimed " << pages_reclaimed
+                << " pages." << std::endl;
+    }
+  }
+}
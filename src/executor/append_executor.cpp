@@ -0,0 +1,24 @@
+#include "executor/executors/append_executor.h"
+
+AppendExecutor::AppendExecutor(ExecuteContext *exec_ctx, const AppendPlanNode *plan,
+                               std::vector<std::unique_ptr<AbstractExecutor>> &&child_executors)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executors_(std::move(child_executors)) {}
+
+void AppendExecutor::Init() {
+  cursor_ = 0;
+  if (!child_executors_.empty()) {
+    child_executors_[0]->Init();
+  }
+}
+
+bool AppendExecutor::Next(Row *row, RowId *rid) {
+  while (cursor_ < child_executors_.size()) {
+    if (child_executors_[cursor_]->Next(row, rid)) {
+      return true;
+    }
+    if (++cursor_ < child_executors_.size()) {
+      child_executors_[cursor_]->Init();
+    }
+  }
+  return false;
+}
@@ -0,0 +1,329 @@
+#include "executor/bulk_loader.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <numeric>
+
+BulkLoader::BulkLoader(TableInfo *table_info, std::vector<IndexInfo *> indexes, Transaction *txn)
+    : table_info_(table_info), schema_(table_info->GetSchema()), indexes_(std::move(indexes)), txn_(txn) {
+  for (auto index_info : indexes_) {
+    std::vector<uint32_t> columns;
+    for (auto column : index_info->GetIndexKeySchema()->GetColumns()) {
+      uint32_t column_index;
+      schema_->GetColumnIndex(column->GetName(), column_index);
+      columns.push_back(column_index);
+    }
+    key_columns_.push_back(std::move(columns));
+    keys_.emplace_back();
+  }
+  batch_.reserve(BATCH_SIZE);
+}
+
+dberr_t BulkLoader::LoadCsv(const std::string &file_name, uint64_t &row_count) {
+  row_count = 0;
+  std::ifstream in(file_name, std::ios::in | std::ios::binary);
+  if (!in.is_open()) {
+    std::cout << "Cannot open the file!" << std::endl;
+    return DB_FAILED;
+  }
+  // the indexes of an empty table are empty as well, so new keys only need to be checked against each other
+  table_was_empty_ = table_info_->GetTableHeap()->Begin(txn_) == table_info_->GetTableHeap()->End();
+  std::unique_ptr<char[]> chunk(new char[CHUNK_SIZE]);
+  std::vector<std::string> values;
+  std::string value;
+  bool in_quotes = false;
+  // a quote inside a quoted field either closes it or, doubled, stands for a quote
+  bool quote_pending = false;
+  bool field_quoted = false;
+  bool success = true;
+  auto end_field = [&]() {
+    values.push_back(std::move(value));
+    value.clear();
+  };
+  auto end_record = [&]() {
+    bool blank = values.empty() && value.empty() && !field_quoted;
+    end_field();
+    line_++;
+    if (!blank) {
+      success = AddRecord(values) && (batch_.size() < BATCH_SIZE || FlushBatch());
+    }
+    values.clear();
+    field_quoted = false;
+  };
+  while (success && in) {
+    in.read(chunk.get(), CHUNK_SIZE);
+    std::streamsize size = in.gcount();
+    for (std::streamsize i = 0; i < size && success; i++) {
+      char ch = chunk[i];
+      if (quote_pending) {
+        quote_pending = false;
+        if (ch == '"') {
+          value.push_back('"');
+          continue;
+        }
+        in_quotes = false;
+      }
+      if (in_quotes) {
+        if (ch == '"') {
+          quote_pending = true;
+        } else {
+          value.push_back(ch);
+        }
+      } else if (ch == ',') {
+        end_field();
+      } else if (ch == '\n') {
+        end_record();
+      } else if (ch == '"' && value.empty() && !field_quoted) {
+        in_quotes = true;
+        field_quoted = true;
+      } else if (ch != '\r') {
+        value.push_back(ch);
+      }
+    }
+  }
+  if (success && in_quotes && !quote_pending) {
+    std::cout << "Unterminated quoted field in line " << line_ + 1 << "." << std::endl;
+    success = false;
+  }
+  // the last record may miss its newline
+  if (success && (!value.empty() || field_quoted || !values.empty())) {
+    end_record();
+  }
+  return Finish(success, row_count);
+}
+
+dberr_t BulkLoader::LoadRows(AbstractExecutor *source, bool drain, uint64_t &row_count) {
+  row_count = 0;
+  table_was_empty_ = table_info_->GetTableHeap()->Begin(txn_) == table_info_->GetTableHeap()->End();
+  source->Init();
+  std::vector<Row> drained;
+  Row row;
+  RowId rid;
+  bool success = true;
+  while (success && source->Next(&row, &rid)) {
+    line_++;
+    if (drain) {
+      drained.push_back(std::move(row));
+    } else {
+      success = AddRow(row) && (batch_.size() < BATCH_SIZE || FlushBatch());
+    }
+  }
+  for (size_t i = 0; success && i < drained.size(); i++) {
+    line_ = i + 1;
+    success = AddRow(drained[i]) && (batch_.size() < BATCH_SIZE || FlushBatch());
+  }
+  return Finish(success, row_count);
+}
+
+dberr_t BulkLoader::Finish(bool success, uint64_t &row_count) {
+  success = success && FlushBatch() && BuildIndexes();
+  if (!success) {
+    Rollback();
+    return DB_FAILED;
+  }
+  row_count = loaded_rids_.size();
+  return DB_SUCCESS;
+}
+
+bool BulkLoader::AddRecord(const std::vector<std::string> &values) {
+  if (values.size() != schema_->GetColumnCount()) {
+    std::cout << "Line " << line_ << " has " << values.size() << " fields, expect " << schema_->GetColumnCount()
+              << "." << std::endl;
+    return false;
+  }
+  AutoIncrement *auto_increment = table_info_->GetAutoIncrement();
+  std::vector<Field> fields;
+  fields.reserve(values.size());
+  for (uint32_t i = 0; i < values.size(); i++) {
+    const Column *column = schema_->GetColumn(i);
+    const std::string &value = values[i];
+    char *end = nullptr;
+    switch (column->GetType()) {
+      case TypeId::kTypeInt: {
+        // an empty auto_increment value takes the next value of the counter
+        if (value.empty() && auto_increment != nullptr && auto_increment->GetColumnIndex() == i) {
+          fields.emplace_back(TypeId::kTypeInt);
+          break;
+        }
+        long number = strtol(value.c_str(), &end, 10);
+        if (value.empty() || *end != '\0' || number < INT32_MIN || number > INT32_MAX) {
+          std::cout << "Line " << line_ << ": '" << value << "' is not an int." << std::endl;
+          return false;
+        }
+        fields.emplace_back(TypeId::kTypeInt, static_cast<int32_t>(number));
+        break;
+      }
+      case TypeId::kTypeFloat: {
+        float number = strtof(value.c_str(), &end);
+        if (value.empty() || *end != '\0') {
+          std::cout << "Line " << line_ << ": '" << value << "' is not a float." << std::endl;
+          return false;
+        }
+        fields.emplace_back(TypeId::kTypeFloat, number);
+        break;
+      }
+      case TypeId::kTypeChar: {
+        if (value.size() > column->GetLength()) {
+          std::cout << "Line " << line_ << ": value of column " << column->GetName() << " is longer than "
+                    << column->GetLength() << " characters." << std::endl;
+          return false;
+        }
+        fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(value.c_str()), value.size(), true);
+        break;
+      }
+      default:
+        std::cout << "Line " << line_ << ": unsupported column type." << std::endl;
+        return false;
+    }
+  }
+  Row row(fields);
+  if (auto_increment != nullptr && !auto_increment->Fill(row)) {
+    std::cout << "Line " << line_ << ": no value is left for the auto_increment column." << std::endl;
+    return false;
+  }
+  batch_.push_back(std::move(row));
+  return true;
+}
+
+bool BulkLoader::AddRow(Row &row) {
+  if (row.GetFieldCount() != schema_->GetColumnCount()) {
+    std::cout << "Row " << line_ << " has " << row.GetFieldCount() << " fields, expect " << schema_->GetColumnCount()
+              << "." << std::endl;
+    return false;
+  }
+  AutoIncrement *auto_increment = table_info_->GetAutoIncrement();
+  if (auto_increment != nullptr && row.GetField(auto_increment->GetColumnIndex())->GetTypeId() == TypeId::kTypeInt &&
+      !auto_increment->Fill(row)) {
+    std::cout << "Row " << line_ << ": no value is left for the auto_increment column." << std::endl;
+    return false;
+  }
+  for (uint32_t i = 0; i < row.GetFieldCount(); i++) {
+    const Column *column = schema_->GetColumn(i);
+    const Field *field = row.GetField(i);
+    if (field->GetTypeId() != column->GetType()) {
+      std::cout << "Row " << line_ << ": value of column " << column->GetName() << " has the wrong type." << std::endl;
+      return false;
+    }
+    if (field->IsNull() && !column->IsNullable()) {
+      std::cout << "Row " << line_ << ": column " << column->GetName() << " cannot be null." << std::endl;
+      return false;
+    }
+    if (column->GetType() == TypeId::kTypeChar && !field->IsNull() && field->GetLength() > column->GetLength()) {
+      std::cout << "Row " << line_ << ": value of column " << column->GetName() << " is longer than "
+                << column->GetLength() << " characters." << std::endl;
+      return false;
+    }
+  }
+  batch_.push_back(std::move(row));
+  return true;
+}
+
+bool BulkLoader::FlushBatch() {
+  if (batch_.empty()) {
+    return true;
+  }
+  bool success = table_info_->GetTableHeap()->BulkInsertTuples(batch_, txn_);
+  for (auto &row : batch_) {
+    // rows behind a failure were not inserted and still carry no row id
+    if (row.GetRowId().GetPageId() == INVALID_PAGE_ID) {
+      break;
+    }
+    loaded_rids_.push_back(row.GetRowId());
+    for (size_t i = 0; i < indexes_.size(); i++) {
+      std::vector<Field> key_fields;
+      for (auto column_index : key_columns_[i]) {
+        key_fields.emplace_back(*row.GetField(column_index));
+      }
+      keys_[i].emplace_back(key_fields);
+      keys_[i].back().SetRowId(row.GetRowId());
+    }
+  }
+  batch_.clear();
+  if (!success) {
+    std::cout << "The tuple is too large." << std::endl;
+  }
+  return success;
+}
+
+bool BulkLoader::BuildIndexes() {
+  auto less = [](const Row &a, const Row &b) {
+    for (size_t i = 0; i < a.GetFieldCount(); i++) {
+      if (a.GetField(i)->CompareLessThan(*b.GetField(i)) == CmpBool::kTrue) {
+        return true;
+      }
+      if (a.GetField(i)->CompareGreaterThan(*b.GetField(i)) == CmpBool::kTrue) {
+        return false;
+      }
+    }
+    return false;
+  };
+  auto key_string = [](const Row &key) {
+    std::string text = key.GetField(0)->toString();
+    for (size_t i = 1; i < key.GetFieldCount(); i++) {
+      text += ", " + key.GetField(i)->toString();
+    }
+    return key.GetFieldCount() > 1 ? "(" + text + ")" : text;
+  };
+  std::vector<std::vector<uint32_t>> orders(indexes_.size());
+  // check every unique index before touching any of them
+  for (size_t i = 0; i < indexes_.size(); i++) {
+    auto &keys = keys_[i];
+    auto &order = orders[i];
+    order.resize(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return less(keys[a], keys[b]); });
+    std::string index_name = indexes_[i]->GetIndexName();
+    if (index_name.find("unique") == std::string::npos && index_name != "primary") {
+      continue;
+    }
+    for (size_t j = 0; j < order.size(); j++) {
+      std::vector<RowId> duplicate;
+      if ((j > 0 && !less(keys[order[j - 1]], keys[order[j]])) ||
+          (!table_was_empty_ && indexes_[i]->GetIndex()->ScanKey(keys[order[j]], duplicate, txn_) == DB_SUCCESS && !duplicate.empty())) {
+        std::cout << "Duplicated key " << key_string(keys[order[j]]) << " in index " << index_name << "." << std::endl;
+        return false;
+      }
+    }
+  }
+  // in key order an empty B+ tree is built bottom up, and a filled one at least finds its leaves in the buffer pool
+  for (size_t i = 0; i < indexes_.size(); i++) {
+    std::vector<const Row *> sorted_keys;
+    sorted_keys.reserve(orders[i].size());
+    for (auto j : orders[i]) {
+      sorted_keys.push_back(&keys_[i][j]);
+    }
+    if (indexes_[i]->GetIndex()->InsertSortedEntries(sorted_keys, txn_) != DB_SUCCESS) {
+      std::cout << "Failed to insert the loaded rows into index " << indexes_[i]->GetIndexName() << "." << std::endl;
+      RemoveIndexEntries(i + 1);
+      return false;
+    }
+  }
+  for (auto &keys : keys_) {
+    keys.clear();
+  }
+  return true;
+}
+
+void BulkLoader::RemoveIndexEntries(size_t index_count) {
+  for (size_t i = 0; i < index_count; i++) {
+    for (auto &key : keys_[i]) {
+      // a failed insert may have stopped anywhere, and an entry of the same key from before the load has to stay
+      std::vector<RowId> result;
+      if (indexes_[i]->GetIndex()->ScanKey(key, result, txn_) == DB_SUCCESS &&
+          std::find(result.begin(), result.end(), key.GetRowId()) != result.end()) {
+        indexes_[i]->GetIndex()->RemoveEntry(key, key.GetRowId(), txn_);
+      }
+    }
+    keys_[i].clear();
+  }
+}
+
+void BulkLoader::Rollback() {
+  TableHeap *table_heap = table_info_->GetTableHeap();
+  for (auto &rid : loaded_rids_) {
+    table_heap->ApplyDelete(rid, txn_);
+  }
+  loaded_rids_.clear();
+}
@@ -3,13 +3,17 @@
 #include <dirent.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <algorithm>
 #include <fstream>
 #include <chrono>
 
 #include "common/result_writer.h"
+#include "executor/bulk_loader.h"
+#include "executor/executors/append_executor.h"
 #include "executor/executors/delete_executor.h"
 #include "executor/executors/index_scan_executor.h"
 #include "executor/executors/insert_executor.h"
+#include "executor/executors/parallel_seq_scan_executor.h"
 #include "executor/executors/seq_scan_executor.h"
 #include "executor/executors/update_executor.h"
 #include "executor/executors/values_executor.h"
@@ -43,7 +47,16 @@ std::unique_ptr<AbstractExecutor> ExecuteEngine::CreateExecutor(ExecuteContext *
   switch (plan->GetType()) {
     // Create a new sequential scan executor
     case PlanType::SeqScan: {
-      return std::make_unique<SeqScanExecutor>(exec_ctx, dynamic_cast<const SeqScanPlanNode *>(plan.get()));
+      auto seq_scan_plan = dynamic_cast<const SeqScanPlanNode *>(plan.get());
+      // a clustered table is read by one thread, in key order
+      TableInfo *table_info = nullptr;
+      bool clustered = exec_ctx->GetCatalog()->GetTable(seq_scan_plan->GetTableName(), table_info) == DB_SUCCESS &&
+                       table_info->GetTableHeap() != nullptr &&
+                       table_info->GetTableHeap()->GetStorage() == TableStorage::kClustered;
+      if (exec_ctx->GetScanThreads() > 1 && !clustered) {
+        return std::make_unique<ParallelSeqScanExecutor>(exec_ctx, seq_scan_plan);
+      }
+      return std::make_unique<SeqScanExecutor>(exec_ctx, seq_scan_plan);
     }
     // Create a new index scan executor
     case PlanType::IndexScan: {
@@ -69,6 +82,14 @@ std::unique_ptr<AbstractExecutor> ExecuteEngine::CreateExecutor(ExecuteContext *
     case PlanType::Values: {
       return std::make_unique<ValuesExecutor>(exec_ctx, dynamic_cast<const ValuesPlanNode *>(plan.get()));
     }
+    case PlanType::Append: {
+      auto append_plan = dynamic_cast<const AppendPlanNode *>(plan.get());
+      std::vector<std::unique_ptr<AbstractExecutor>> child_executors;
+      for (const auto &child : append_plan->GetChildren()) {
+        child_executors.push_back(CreateExecutor(exec_ctx, child));
+      }
+      return std::make_unique<AppendExecutor>(exec_ctx, append_plan, std::move(child_executors));
+    }
     default:
       throw std::logic_error("Unsupported plan type.");
   }
@@ -104,8 +125,15 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
   }
   auto start_time = std::chrono::system_clock::now();
   unique_ptr<ExecuteContext> context(nullptr);
-  if(!current_db_.empty())
+  // keeps the auto vacuum of the database away while the statement runs, a dropped database takes its latch along
+  std::unique_lock<std::recursive_mutex> statement_lock;
+  if(!current_db_.empty()) {
     context = dbs_[current_db_]->MakeExecuteContext(nullptr);
+    context->SetScanThreads(scan_threads_);
+    if(ast->type_ != kNodeDropDB) {
+      statement_lock = std::unique_lock<std::recursive_mutex>(dbs_[current_db_]->statement_latch_);
+    }
+  }
   switch (ast->type_) {
     case kNodeCreateDB:
       return ExecuteCreateDatabase(ast, context.get());
@@ -119,8 +147,20 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
       return ExecuteShowTables(ast, context.get());
     case kNodeCreateTable:
       return ExecuteCreateTable(ast, context.get());
+    case kNodeCreateTablespace:
+      return ExecuteCreateTablespace(ast, context.get());
+    case kNodeVacuumDB:
+      return ExecuteVacuumDatabase(ast, context.get());
+    case kNodeVacuumTable:
+      return ExecuteVacuumTable(ast, context.get());
     case kNodeDropTable:
       return ExecuteDropTable(ast, context.get());
+    case kNodeTruncateTable:
+      return ExecuteTruncateTable(ast, context.get());
+    case kNodeClusterTable:
+      return ExecuteClusterTable(ast, context.get());
+    case kNodeAlterTable:
+      return ExecuteAlterTable(ast, context.get());
     case kNodeShowIndexes:
       return ExecuteShowIndexes(ast, context.get());
     case kNodeCreateIndex:
@@ -133,10 +173,14 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
       return ExecuteTrxCommit(ast, context.get());
     case kNodeTrxRollback:
       return ExecuteTrxRollback(ast, context.get());
+    case kNodeCopy:
+      return ExecuteCopy(ast, context.get());
     case kNodeExecFile:
       return ExecuteExecfile(ast, context.get());
     case kNodeQuit:
       return ExecuteQuit(ast, context.get());
+    case kNodeSet:
+      return ExecuteSet(ast, context.get());
     default:
       break;
   }
@@ -146,7 +190,9 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
   try {
     planner.PlanQuery(ast);
     // Execute the query.
-    ExecutePlan(planner.plan_, &result_set, nullptr, context.get());
+    if (ExecutePlan(planner.plan_, &result_set, nullptr, context.get()) != DB_SUCCESS) {
+      return DB_FAILED;
+    }
   } catch (const exception &ex) {
     std::cout << "Error Encountered in Planner: " << ex.what() << std::endl;
     return DB_FAILED;
@@ -158,7 +204,9 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
   std::stringstream ss;
   ResultWriter writer(ss);
 
-  if (planner.plan_->GetType() == PlanType::SeqScan || planner.plan_->GetType() == PlanType::IndexScan) {
+  // the scans of the partitions of a table are appended, under a plan with their output schema
+  if (planner.plan_->GetType() == PlanType::SeqScan || planner.plan_->GetType() == PlanType::IndexScan ||
+      (planner.plan_->GetType() == PlanType::Append && planner.plan_->OutputSchema() != nullptr)) {
     auto schema = planner.plan_->OutputSchema();
     auto num_of_columns = schema->GetColumnCount();
     if (!result_set.empty()) {
@@ -243,11 +291,20 @@ dberr_t ExecuteEngine::ExecuteCreateDatabase(pSyntaxNode ast, ExecuteContext *co
   __clock_t start_time, end_time;
   start_time = clock();
   string db_name = ast->child_->val_;
-  DBStorageEngine *db = new DBStorageEngine(db_name, true);
   if(dbs_.find(db_name) != dbs_.end()){
     cout << "Can't create database '" << db_name << "';" ;
     return DB_ALREADY_EXIST;
   }
+  uint32_t page_size = PAGE_SIZE;
+  auto option = ast->child_->next_;
+  if(option != nullptr && option->type_ == kNodeOption && strcmp(option->val_, "page_size") == 0){
+    page_size = atoi(option->child_->val_);
+    if(!DiskManager::IsValidPageSize(page_size)){
+      cout << "Invalid page size " << option->child_->val_ << ", expect 4096, 8192, 16384 or 32768." << endl;
+      return DB_FAILED;
+    }
+  }
+  DBStorageEngine *db = new DBStorageEngine(db_name, true, DEFAULT_BUFFER_POOL_SIZE, page_size);
   dbs_.insert(pair<string, DBStorageEngine *>(db_name, db));
   end_time = clock();
   cout << "Successfully create database '" << db_name << "' in" << (double)(end_time-start_time)/CLOCKS_PER_SEC << "sec." << endl;
@@ -325,6 +382,10 @@ dberr_t ExecuteEngine::ExecuteShowTables(pSyntaxNode ast, ExecuteContext *contex
   cout << "+--------------------+" << endl;
   std::vector<TableInfo*> tables;
   dbs_[current_db_]->catalog_mgr_->GetTables(tables);
+  // the tables holding the partitions of a table are not listed
+  tables.erase(std::remove_if(tables.begin(), tables.end(),
+                              [](TableInfo *it) { return PartitionScheme::IsPartitionTableName(it->GetTableName()); }),
+               tables.end());
   for(auto it : tables)
     cout << "| " << setw(18) << left << it->GetTableName() << " |" << endl;
   cout << "+====================+" << endl;
@@ -333,6 +394,86 @@ dberr_t ExecuteEngine::ExecuteShowTables(pSyntaxNode ast, ExecuteContext *contex
   return DB_SUCCESS;
 }
 
+/**
+ * Read a constant of a statement as a value of the given type, null stays null.
+ * @return false if the constant does not have the type
+ */
+static bool MakeValue(pSyntaxNode value, TypeId type, std::unique_ptr<Field> &field) {
+  if(value->type_ == kNodeNull){
+    field = std::make_unique<Field>(type);
+  }else if(type == kTypeInt && value->type_ == kNodeNumber && strchr(value->val_, '.') == nullptr){
+    field = std::make_unique<Field>(kTypeInt, atoi(value->val_));
+  }else if(type == kTypeFloat && value->type_ == kNodeNumber){
+    field = std::make_unique<Field>(kTypeFloat, static_cast<float>(atof(value->val_)));
+  }else if(type == kTypeChar && value->type_ == kNodeString){
+    field = std::make_unique<Field>(kTypeChar, value->val_, strlen(value->val_), true);
+  }else{
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Read the bound of a range partition, nullptr for MAXVALUE.
+ * @return false if the bound does not have the type of the partition column
+ */
+static bool MakePartitionBound(pSyntaxNode partition, TypeId type, std::unique_ptr<Field> &bound) {
+  pSyntaxNode value = partition->child_->next_;
+  bound.reset();
+  return value == nullptr || MakeValue(value, type, bound);
+}
+
+/**
+ * partition by range (column) (partition p values less than (v), ...)
+ * partition by hash (column) (partition p, ...) | partitions n
+ * @return the scheme, nullptr after printing what is wrong with it
+ */
+static PartitionScheme *MakePartitionScheme(pSyntaxNode option, const vector<Column *> &columns) {
+  string kind = option->child_->val_;
+  string column_name = option->child_->next_->val_;
+  pSyntaxNode definition = option->child_->next_->next_;
+  auto column = std::find_if(columns.begin(), columns.end(), [&](Column *col) { return col->GetName() == column_name; });
+  if(column == columns.end()){
+    cout << "Partition column '" << column_name << "' doesn't exist!" << endl;
+    return nullptr;
+  }
+  uint32_t column_index = column - columns.begin();
+  std::unique_ptr<PartitionScheme> scheme;
+  if(kind == "range"){
+    scheme = std::make_unique<PartitionScheme>(PartitionKind::kRange, column_index, (*column)->GetType());
+  }else if(kind == "hash"){
+    scheme = std::make_unique<PartitionScheme>(PartitionKind::kHash, column_index, (*column)->GetType());
+  }else{
+    cout << "Unknown partitioning '" << kind << "', expect range or hash." << endl;
+    return nullptr;
+  }
+  if(definition->type_ == kNodeNumber){
+    int count = atoi(definition->val_);
+    if(scheme->GetKind() != PartitionKind::kHash || count <= 0 || strchr(definition->val_, '.') != nullptr){
+      cout << "Partitions " << definition->val_ << " needs a positive number of hash partitions." << endl;
+      return nullptr;
+    }
+    for(int i = 0; i < count; i++){
+      scheme->AddPartition("p" + to_string(i), 0);
+    }
+    return scheme.release();
+  }
+  for(; definition != nullptr; definition = definition->next_){
+    string name = definition->child_->val_;
+    uint32_t index;
+    std::unique_ptr<Field> bound;
+    // a range partition names its bound, a hash partition has none
+    bool has_bound = definition->val_ != nullptr || definition->child_->next_ != nullptr;
+    if(scheme->FindPartition(name, index) || has_bound != (scheme->GetKind() == PartitionKind::kRange) ||
+       !MakePartitionBound(definition, (*column)->GetType(), bound) ||
+       !scheme->AddPartition(name, 0, bound.get())){
+      cout << "Invalid partition '" << name << "'." << endl;
+      return nullptr;
+    }
+  }
+  return scheme.release();
+}
+
 dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
   LOG(INFO) << "ExecuteCreateTable" << std::endl;
@@ -344,10 +485,24 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
   }
   start_time = clock();
   string table_name = ast->child_->val_;
+  if(PartitionScheme::IsPartitionTableName(table_name)){
+    cout << "Table name '" << table_name << "' can't contain '#'." << endl;
+    return DB_FAILED;
+  }
   auto ptr = ast->child_->next_;
   vector<Column *>columns;
   vector<string> primary_keys;
   vector<string> unique_index;
+  string auto_increment;
+  vector<string> dictionary_columns;
+  uint32_t space_id = DEFAULT_TABLESPACE_ID;
+  TableStorage storage = TableStorage::kRow;
+  // create temporary table: a table in memory that lasts as long as the session
+  bool temporary = ast->val_ != nullptr && strcmp(ast->val_, "temporary") == 0;
+  bool in_memory = temporary;
+  bool in_lsm = false;
+  pSyntaxNode partition_ptr = nullptr;
+  pSyntaxNode select_ptr = nullptr;
 
   while(ptr != nullptr){
     if(ptr->type_ == kNodeColumnDefinitionList){
@@ -372,6 +527,15 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
             }
             col_def_ptr = col_def_ptr->next_;
             continue;
+          }else if(strcmp(col_def_ptr->val_, "auto_increment") == 0){
+            if(!auto_increment.empty()){
+              cout << "A table can have only one auto_increment column." << endl;
+              for(auto col : columns) delete col;
+              return DB_FAILED;
+            }
+            auto_increment = col_def_ptr->child_->val_;
+          }else if(strcmp(col_def_ptr->val_, "dictionary") == 0){
+            dictionary_columns.push_back(col_def_ptr->child_->val_);
           }
         }
 
@@ -384,6 +548,11 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
             cout << "Invalid input!" << endl;
             return DB_FAILED;
           }
+          // long values go to overflow pages, so the page size does not limit a char column
+          if(static_cast<uint32_t>(char_num) >= VARCHAR_MAX_LEN){
+            cout << "Char length " << char_num << " exceeds the maximum of " << VARCHAR_MAX_LEN << "." << endl;
+            return DB_FAILED;
+          }
         }else if(col_type == "int"){
           type = kTypeInt;
         }else if(col_type == "float"){
@@ -392,6 +561,17 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
           cout << "Invalid input!" << endl;
           return DB_FAILED;
         }
+        if(col_name == auto_increment && type != kTypeInt){
+          cout << "An auto_increment column must be an int." << endl;
+          for(auto col : columns) delete col;
+          return DB_FAILED;
+        }
+        if(type != kTypeChar &&
+           std::find(dictionary_columns.begin(), dictionary_columns.end(), col_name) != dictionary_columns.end()){
+          cout << "Only a char column can be dictionary encoded." << endl;
+          for(auto col : columns) delete col;
+          return DB_FAILED;
+        }
 
         Column *col;
         if(type == kTypeChar){
@@ -402,22 +582,178 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
         columns.push_back(col);
         col_def_ptr = col_def_ptr->next_;
       }
+    }else if(ptr->type_ == kNodeOption && strcmp(ptr->val_, "tablespace") == 0){
+      if(dbs_[current_db_]->disk_mgr_->GetTablespaceId(ptr->child_->val_, space_id) != DB_SUCCESS){
+        cout << "Tablespace '" << ptr->child_->val_ << "' doesn't exist!" << endl;
+        for(auto col : columns) delete col;
+        return DB_FAILED;
+      }
+    }else if(ptr->type_ == kNodeOption && strcmp(ptr->val_, "storage") == 0){
+      // storage = row | column | compressed | clustered
+      if(strcmp(ptr->child_->val_, "row") == 0){
+        storage = TableStorage::kRow;
+      }else if(strcmp(ptr->child_->val_, "column") == 0){
+        storage = TableStorage::kColumn;
+      }else if(strcmp(ptr->child_->val_, "compressed") == 0){
+        storage = TableStorage::kCompressed;
+      }else if(strcmp(ptr->child_->val_, "clustered") == 0){
+        storage = TableStorage::kClustered;
+      }else{
+        cout << "Unknown storage '" << ptr->child_->val_ << "', expect row, column, compressed or clustered." << endl;
+        for(auto col : columns) delete col;
+        return DB_FAILED;
+      }
+    }else if(ptr->type_ == kNodeOption && strcmp(ptr->val_, "engine") == 0){
+      // engine = disk | memory | lsm
+      if(strcmp(ptr->child_->val_, "memory") == 0){
+        in_memory = true;
+      }else if(strcmp(ptr->child_->val_, "lsm") == 0 && !temporary){
+        in_lsm = true;
+      }else if(strcmp(ptr->child_->val_, "disk") != 0 && strcmp(ptr->child_->val_, "lsm") != 0){
+        cout << "Unknown engine '" << ptr->child_->val_ << "', expect disk, memory or lsm." << endl;
+        for(auto col : columns) delete col;
+        return DB_FAILED;
+      }else if(temporary){
+        cout << "A temporary table is always kept in memory." << endl;
+        for(auto col : columns) delete col;
+        return DB_FAILED;
+      }
+    }else if(ptr->type_ == kNodeOption && strcmp(ptr->val_, "partition") == 0){
+      partition_ptr = ptr;
+    }else if(ptr->type_ == kNodeSelect){
+      select_ptr = ptr;
     }
     ptr = ptr->next_;
   }
+  // create table ... as select: 列取自select读的表，建表后整批插入select的结果
+  AbstractPlanNodeRef select_plan = nullptr;
+  if(select_ptr != nullptr){
+    if(partition_ptr != nullptr){
+      cout << "A table created from a select cannot be partitioned." << endl;
+      return DB_FAILED;
+    }
+    Planner planner(context);
+    try{
+      planner.PlanQuery(select_ptr);
+    }catch(const exception &ex){
+      cout << "Error Encountered in Planner: " << ex.what() << endl;
+      return DB_FAILED;
+    }
+    select_plan = planner.plan_;
+    TableInfo *source = nullptr;
+    context->GetCatalog()->GetTable(select_ptr->child_->next_->val_, source);
+    uint32_t i = 0;
+    for(auto out_column : select_plan->OutputSchema()->GetColumns()){
+      uint32_t col_idx;
+      source->GetSchema()->GetColumnIndex(out_column->GetName(), col_idx);
+      const Column *column = source->GetSchema()->GetColumn(col_idx);
+      for(auto col : columns){
+        if(col->GetName() == column->GetName()){
+          cout << "Column '" << column->GetName() << "' is selected twice." << endl;
+          for(auto col : columns) delete col;
+          return DB_FAILED;
+        }
+      }
+      if(column->GetType() == kTypeChar){
+        columns.push_back(new Column(column->GetName(), kTypeChar, column->GetLength(), i++, column->IsNullable(), false));
+      }else{
+        columns.push_back(new Column(column->GetName(), column->GetType(), i++, column->IsNullable(), false));
+      }
+    }
+  }
+  // 分区表：每个分区是一张独立的表
+  PartitionScheme *partitions = nullptr;
+  if(partition_ptr != nullptr){
+    if(!auto_increment.empty()){
+      cout << "A partitioned table cannot have an auto_increment column." << endl;
+      for(auto col : columns) delete col;
+      return DB_FAILED;
+    }
+    if(!dictionary_columns.empty()){
+      cout << "A partitioned table cannot have a dictionary encoded column." << endl;
+      for(auto col : columns) delete col;
+      return DB_FAILED;
+    }
+    if(temporary){
+      cout << "A temporary table cannot be partitioned." << endl;
+      for(auto col : columns) delete col;
+      return DB_FAILED;
+    }
+    partitions = MakePartitionScheme(partition_ptr, columns);
+    if(partitions == nullptr){
+      for(auto col : columns) delete col;
+      return DB_FAILED;
+    }
+    // 每个分区各建一份索引，只在分区内查重，所以主键和unique列必须含分区列，同一个键才总落在同一个分区
+    const string &partition_column = columns[partitions->GetColumnIndex()]->GetName();
+    bool keys_partitioned =
+        primary_keys.empty() || std::find(primary_keys.begin(), primary_keys.end(), partition_column) != primary_keys.end();
+    for(auto &unique_column : unique_index){
+      keys_partitioned = keys_partitioned && unique_column == partition_column;
+    }
+    if(!keys_partitioned){
+      cout << "A primary key or unique column of a partitioned table must include the partition column '"
+           << partition_column << "'." << endl;
+      for(auto col : columns) delete col;
+      delete partitions;
+      return DB_FAILED;
+    }
+  }
+  if(in_memory){
+    storage = TableStorage::kMemory;
+  }else if(in_lsm){
+    storage = TableStorage::kLsm;
+  }
+  // 聚簇表按主键存行
+  if(storage == TableStorage::kClustered && primary_keys.empty()){
+    cout << "A clustered table needs a primary key." << endl;
+    for(auto col : columns) delete col;
+    delete partitions;
+    return DB_FAILED;
+  }
   TableSchema *schema = new TableSchema(columns, true); // is_manage是啥，直接写成true了
   TableInfo *table_info;
   IndexInfo *index_info;
-  auto ret = context->GetCatalog()->CreateTable(table_name, schema, context->GetTransaction(), table_info);
-  // 为primary创建索引
-  if(ret == DB_SUCCESS && !primary_keys.empty()){
-    context->GetCatalog()->CreateIndex(table_name, "primary", primary_keys, context->GetTransaction(), index_info, "bptree");
+  auto ret = context->GetCatalog()->CreateTable(table_name, schema, context->GetTransaction(), table_info, space_id,
+                                                storage, temporary, partitions, primary_keys);
+  if(ret == DB_FAILED && storage == TableStorage::kColumn){
+    cout << "A row of table '" << table_name << "' does not fit into a column page." << endl;
+  }
+  if(ret == DB_FAILED && storage == TableStorage::kClustered){
+    cout << "A page cannot hold enough rows of table '" << table_name << "' to cluster them." << endl;
+  }
+  if(ret == DB_SUCCESS && !auto_increment.empty()){
+    ret = context->GetCatalog()->SetAutoIncrement(table_name, auto_increment);
+    if(ret != DB_SUCCESS){
+      context->GetCatalog()->DropTable(table_name);
+    }
+  }
+  // 字典编码的列：值存在catalog页里，行和索引只存code
+  for(size_t i = 0; ret == DB_SUCCESS && i < dictionary_columns.size(); i++){
+    ret = context->GetCatalog()->SetDictionary(table_name, dictionary_columns[i]);
+    if(ret != DB_SUCCESS){
+      cout << "Column '" << dictionary_columns[i] << "' cannot be dictionary encoded." << endl;
+      context->GetCatalog()->DropTable(table_name);
+    }
+  }
+  // 为primary创建索引，索引和表放在同一个表空间；聚簇表的主键树就是主键索引，不再另建
+  if(ret == DB_SUCCESS && !primary_keys.empty() && storage != TableStorage::kClustered){
+    context->GetCatalog()->CreateIndex(table_name, "primary", primary_keys, context->GetTransaction(), index_info, "bptree",
+                                       space_id);
   }
   if(ret == DB_SUCCESS && !unique_index.empty()){
     for(int i=0; i < unique_index.size(); i++){
       vector<string>key;
       key.push_back(unique_index[i]);
-      context->GetCatalog()->CreateIndex(table_name, "unique" + to_string(i), key, context->GetTransaction(), index_info, "bptree");
+      context->GetCatalog()->CreateIndex(table_name, "unique" + to_string(i), key, context->GetTransaction(), index_info,
+                                         "bptree", space_id);
+    }
+  }
+  if(ret == DB_SUCCESS && select_plan != nullptr){
+    auto insert_plan = std::make_shared<InsertPlanNode>(nullptr, select_plan, table_name);
+    if(ExecutePlan(insert_plan, nullptr, context->GetTransaction(), context) != DB_SUCCESS){
+      context->GetCatalog()->DropTable(table_name);
+      return DB_FAILED;
     }
   }
   end_time = clock();
@@ -426,6 +762,101 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
   return ret;
 }
 
+dberr_t ExecuteEngine::ExecuteCreateTablespace(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteCreateTablespace" << std::endl;
+#endif
+  if(current_db_.empty()){
+    cout << "You haven't chosen a database!" << endl;
+    return DB_FAILED;
+  }
+  string space_name = ast->child_->val_;
+  string location;
+  auto option = ast->child_->next_;
+  if(option != nullptr && option->type_ == kNodeOption && strcmp(option->val_, "location") == 0){
+    location = option->child_->val_;
+  }
+  uint32_t space_id;
+  auto disk_mgr = dbs_[current_db_]->disk_mgr_;
+  auto ret = disk_mgr->CreateTablespace(space_name, location, space_id);
+  if(ret == DB_ALREADY_EXIST){
+    if(disk_mgr->GetTablespaceId(space_name, space_id) == DB_SUCCESS){
+      cout << "Tablespace '" << space_name << "' already exists!" << endl;
+    }else{
+      cout << "Data file of tablespace '" << space_name << "' already exists!" << endl;
+    }
+  }else if(ret == DB_FAILED){
+    cout << "Too many tablespaces!" << endl;
+  }else{
+    cout << "Successfully create tablespace '" << space_name << "'." << endl;
+  }
+  return ret;
+}
+
+dberr_t ExecuteEngine::ExecuteVacuumDatabase(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteVacuumDatabase" << std::endl;
+#endif
+  if(current_db_.empty()){
+    cout << "You haven't chosen a database!" << endl;
+    return DB_FAILED;
+  }
+  clock_t start_time = clock();
+  VacuumStats stats;
+  auto ret = dbs_[current_db_]->VacuumDatabase(stats);
+  clock_t end_time = clock();
+  if(ret != DB_SUCCESS){
+    return ret;
+  }
+  cout << "Vacuumed database '" << current_db_ << "': " << stats.moved_pages_ << " of " << stats.live_pages_
+       << " pages moved, " << stats.released_pages_ << " unused pages released, "
+       << stats.bytes_before_ - stats.bytes_after_ << " bytes reclaimed (" << stats.bytes_before_ << " -> "
+       << stats.bytes_after_ << ")." << endl;
+  cout << "Sequential table heap pages: " << stats.heap_locality_before_ * 100 << "% -> "
+       << stats.heap_locality_after_ * 100 << "% (" << (double)(end_time - start_time) / CLOCKS_PER_SEC << " sec)"
+       << endl;
+  return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecuteVacuumTable(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteVacuumTable" << std::endl;
+#endif
+  if(current_db_.empty()){
+    cout << "You haven't chosen a database!" << endl;
+    return DB_FAILED;
+  }
+  string table_name = ast->child_->val_;
+  TableInfo *table_info = nullptr;
+  if(PartitionScheme::IsPartitionTableName(table_name) ||
+     context->GetCatalog()->GetTable(table_name, table_info) != DB_SUCCESS){
+    return DB_TABLE_NOT_EXIST;
+  }
+  // the heap pages of a partitioned table are those of its partitions
+  auto page_count = [table_info]() {
+    if(!table_info->IsPartitioned()){
+      return table_info->GetTableHeap()->GetPageCount();
+    }
+    uint32_t pages = 0;
+    for(auto partition : table_info->GetPartitions()){
+      pages += partition->GetTableHeap()->GetPageCount();
+    }
+    return pages;
+  };
+  uint32_t pages_before = page_count();
+  uint32_t pages_reclaimed = 0, rows_moved = 0;
+  clock_t start_time = clock();
+  auto ret = context->GetCatalog()->VacuumTable(table_name, pages_reclaimed, rows_moved, context->GetTransaction());
+  clock_t end_time = clock();
+  if(ret != DB_SUCCESS){
+    return ret;
+  }
+  cout << "Vacuumed table '" << table_name << "': " << pages_reclaimed << " pages reclaimed, " << pages_before
+       << " -> " << page_count() << " heap pages, " << rows_moved << " rows moved ("
+       << (double)(end_time - start_time) / CLOCKS_PER_SEC << " sec)." << endl;
+  return DB_SUCCESS;
+}
+
 dberr_t ExecuteEngine::ExecuteDropTable(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
   LOG(INFO) << "ExecuteDropTable" << std::endl;
@@ -439,23 +870,172 @@ dberr_t ExecuteEngine::ExecuteDropTable(pSyntaxNode ast, ExecuteContext *context
     return DB_FAILED;
   }
   TableInfo *table_info = nullptr;
-  if(dbs_[current_db_]->catalog_mgr_->GetTable(table_name, table_info) == DB_TABLE_NOT_EXIST)
+  if(PartitionScheme::IsPartitionTableName(table_name) ||
+     dbs_[current_db_]->catalog_mgr_->GetTable(table_name, table_info) == DB_TABLE_NOT_EXIST)
   {
     cout << "Invalid table!" << endl;
     return DB_TABLE_NOT_EXIST;
   }
+  // 表上的索引由catalog一并删除
   dbs_[current_db_]->catalog_mgr_->DropTable(table_name);
-  vector<IndexInfo *> index_names;
-  dbs_[current_db_]->catalog_mgr_->GetTableIndexes(table_name, index_names);
-  // 也要删除索引
-  for(auto index_name : index_names){
-    dbs_[current_db_]->catalog_mgr_->DropIndex(table_name, index_name->GetIndexName());
-  }
   end_time = clock();
   cout << "Successfully drop table '" << table_name << "' in " << (double)(end_time - start_time) / CLOCKS_PER_SEC << "sec." << endl;
   return DB_SUCCESS;
 }
 
+dberr_t ExecuteEngine::ExecuteTruncateTable(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteTruncateTable" << std::endl;
+#endif
+  if(current_db_.empty()){
+    cout << "You haven't chosen a database!" << endl;
+    return DB_FAILED;
+  }
+  string table_name = ast->child_->val_;
+  if(PartitionScheme::IsPartitionTableName(table_name)){
+    return DB_TABLE_NOT_EXIST;
+  }
+  clock_t start_time = clock();
+  // 换上空的堆和空的索引，旧的页由后台释放
+  auto ret = context->GetCatalog()->TruncateTable(table_name, context->GetTransaction());
+  clock_t end_time = clock();
+  if(ret != DB_SUCCESS){
+    return ret;
+  }
+  cout << "Truncated table '" << table_name << "' in " << (double)(end_time - start_time) / CLOCKS_PER_SEC << " sec."
+       << endl;
+  return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecuteClusterTable(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteClusterTable" << std::endl;
+#endif
+  if(current_db_.empty()){
+    cout << "You haven't chosen a database!" << endl;
+    return DB_FAILED;
+  }
+  string table_name = ast->child_->val_;
+  string index_name = ast->child_->next_->val_;
+  if(PartitionScheme::IsPartitionTableName(table_name)){
+    return DB_TABLE_NOT_EXIST;
+  }
+  clock_t start_time = clock();
+  // 按索引顺序重写整个堆，索引随之重建
+  auto ret = context->GetCatalog()->ClusterTable(table_name, index_name, context->GetTransaction());
+  clock_t end_time = clock();
+  if(ret != DB_SUCCESS){
+    return ret;
+  }
+  cout << "Clustered table '" << table_name << "' on index '" << index_name << "' in "
+       << (double)(end_time - start_time) / CLOCKS_PER_SEC << " sec." << endl;
+  return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecuteAlterTable(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteAlterTable" << std::endl;
+#endif
+  if(current_db_.empty()){
+    cout << "You haven't chosen a database!" << endl;
+    return DB_FAILED;
+  }
+  string table_name = ast->child_->val_;
+  pSyntaxNode option = ast->child_->next_;
+  TableInfo *table_info = nullptr;
+  if(PartitionScheme::IsPartitionTableName(table_name) ||
+     context->GetCatalog()->GetTable(table_name, table_info) != DB_SUCCESS){
+    return DB_TABLE_NOT_EXIST;
+  }
+  string action = option->val_;
+  if(action == "add column"){
+    return ExecuteAddColumn(table_info, option, context);
+  }
+  if(!table_info->IsPartitioned()){
+    cout << "Table '" << table_name << "' is not partitioned." << endl;
+    return DB_FAILED;
+  }
+  string partition_name = option->child_->type_ == kNodePartition ? option->child_->child_->val_ : option->child_->val_;
+  clock_t start_time = clock();
+  dberr_t ret = DB_FAILED;
+  if(action == "add partition"){
+    PartitionScheme *scheme = table_info->GetPartitionScheme();
+    TypeId type = table_info->GetSchema()->GetColumn(scheme->GetColumnIndex())->GetType();
+    std::unique_ptr<Field> bound;
+    bool has_bound = option->child_->val_ != nullptr || option->child_->child_->next_ != nullptr;
+    if(scheme->GetKind() != PartitionKind::kRange || !has_bound || !MakePartitionBound(option->child_, type, bound)){
+      cout << "Only range partitions with a bound can be added." << endl;
+      return DB_FAILED;
+    }
+    ret = context->GetCatalog()->AddPartition(table_name, partition_name, bound.get(), context->GetTransaction());
+  }else if(action == "drop partition"){
+    // 分区的页和整张表一样由后台释放
+    ret = context->GetCatalog()->DropPartition(table_name, partition_name);
+  }else if(action == "truncate partition"){
+    ret = context->GetCatalog()->TruncatePartition(table_name, partition_name, context->GetTransaction());
+  }
+  clock_t end_time = clock();
+  if(ret != DB_SUCCESS){
+    cout << "Can't " << action << " '" << partition_name << "' of table '" << table_name << "'." << endl;
+    return DB_FAILED;
+  }
+  cout << "Altered table '" << table_name << "': " << action << " '" << partition_name << "' in "
+       << (double)(end_time - start_time) / CLOCKS_PER_SEC << " sec." << endl;
+  return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecuteAddColumn(TableInfo *table_info, pSyntaxNode option, ExecuteContext *context) {
+  // alter table t add column c type [default v]
+  pSyntaxNode definition = option->child_;
+  pSyntaxNode default_ptr = definition->next_;
+  string table_name = table_info->GetTableName();
+  string col_name = definition->child_->val_;
+  string col_type = definition->child_->next_->val_;
+  if(definition->val_ != nullptr){
+    cout << "An added column cannot be unique, the rows there are would share its default." << endl;
+    return DB_FAILED;
+  }
+  Column *column;
+  if(col_type == "char"){
+    pSyntaxNode length = definition->child_->next_->child_;
+    int char_num = atoi(length->val_);
+    if(char_num < 0 || strchr(length->val_, '.') != nullptr || static_cast<uint32_t>(char_num) >= VARCHAR_MAX_LEN){
+      cout << "Invalid input!" << endl;
+      return DB_FAILED;
+    }
+    column = new Column(col_name, kTypeChar, char_num, 0, true, false);
+  }else if(col_type == "int"){
+    column = new Column(col_name, kTypeInt, 0, true, false);
+  }else if(col_type == "float"){
+    column = new Column(col_name, kTypeFloat, 0, true, false);
+  }else{
+    cout << "Invalid input!" << endl;
+    return DB_FAILED;
+  }
+  if(default_ptr != nullptr){
+    std::unique_ptr<Field> default_value;
+    if(!MakeValue(default_ptr, column->GetType(), default_value) ||
+       (column->GetType() == kTypeChar && !default_value->IsNull() && default_value->GetLength() > column->GetLength())){
+      cout << "Default of column '" << col_name << "' does not match its type." << endl;
+      delete column;
+      return DB_FAILED;
+    }
+    column->SetDefault(default_value->IsNull() ? nullptr : default_value.get());
+  }
+  clock_t start_time = clock();
+  // 只改表的schema，已有的行在读出时补上默认值
+  dberr_t ret = context->GetCatalog()->AddColumn(table_name, column);
+  clock_t end_time = clock();
+  if(ret != DB_SUCCESS){
+    cout << "Can't add column '" << col_name << "' to table '" << table_name
+         << "', it exists already or the table is not stored by row or lsm." << endl;
+    return DB_FAILED;
+  }
+  cout << "Altered table '" << table_name << "': add column '" << col_name << "' in "
+       << (double)(end_time - start_time) / CLOCKS_PER_SEC << " sec." << endl;
+  return DB_SUCCESS;
+}
+
 dberr_t ExecuteEngine::ExecuteShowIndexes(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
   LOG(INFO) << "ExecuteShowIndexes" << std::endl;
@@ -477,6 +1057,9 @@ dberr_t ExecuteEngine::ExecuteShowIndexes(pSyntaxNode ast, ExecuteContext *conte
   cout << "+---------+-----------+----------+--------------+--------------+----------+------------+" << endl;
   for(auto table: tables){  // 遍历该数据库的所有表
     string table_name = table->GetTableName();
+    if(PartitionScheme::IsPartitionTableName(table_name)){
+      continue;
+    }
 
     vector<IndexInfo *> indexes;
     context->GetCatalog()->GetTableIndexes(table_name, indexes);
@@ -530,14 +1113,27 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
     index_keys_ptr = index_keys_ptr->next_;
   }
 
-  auto index_type_ptr = ast->child_->next_->next_->next_;
   string index_type = "bptree";
-  if(index_type_ptr != nullptr){
-    index_type = index_type_ptr->child_->val_;
+  uint32_t space_id = DEFAULT_TABLESPACE_ID;
+  for(auto option_ptr = ast->child_->next_->next_->next_; option_ptr != nullptr; option_ptr = option_ptr->next_){
+    if(option_ptr->type_ == kNodeIndexType){
+      index_type = option_ptr->child_->val_;
+    }else if(option_ptr->type_ == kNodeOption && strcmp(option_ptr->val_, "tablespace") == 0){
+      if(dbs_[current_db_]->disk_mgr_->GetTablespaceId(option_ptr->child_->val_, space_id) != DB_SUCCESS){
+        cout << "Tablespace '" << option_ptr->child_->val_ << "' doesn't exist!" << endl;
+        return DB_FAILED;
+      }
+    }else if(option_ptr->type_ == kNodeOption && strcmp(option_ptr->val_, "storage") == 0){
+      cout << "An index has no storage option!" << endl;
+      return DB_FAILED;
+    }
   }
 
   IndexInfo *index_info;
-  auto ret = context->GetCatalog()->CreateIndex(table_name, index_name, index_keys, context->GetTransaction(), index_info, index_type);
+  auto ret = PartitionScheme::IsPartitionTableName(table_name)
+                 ? DB_TABLE_NOT_EXIST
+                 : context->GetCatalog()->CreateIndex(table_name, index_name, index_keys, context->GetTransaction(),
+                                                      index_info, index_type, space_id);
   if(ret == DB_TABLE_NOT_EXIST){
     cout << "Invalid table name!" << endl;
   }else if(ret == DB_COLUMN_NAME_NOT_EXIST){
@@ -570,6 +1166,10 @@ dberr_t ExecuteEngine::ExecuteDropIndex(pSyntaxNode ast, ExecuteContext *context
   string index_name = ast->child_->val_;
   int drop_cnt = 0;
   for(auto table : tables){
+    // the partitioned table drops the index of each of its partitions
+    if(table->GetParent() != nullptr){
+      continue;
+    }
     string table_name = table->GetTableName();
     if(context->GetCatalog()->DropIndex(table_name, index_name) == DB_SUCCESS){
       cout << "Drop index '" << index_name << "' on table '" << table_name << "';"<< endl;
@@ -612,6 +1212,40 @@ int yyparse(void);
 #include "parser/minisql_lex.h"
 #include "parser/parser.h"
 }
+dberr_t ExecuteEngine::ExecuteCopy(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteCopy" << std::endl;
+#endif
+  if(current_db_.empty()){
+    cout << "You haven't chosen a database!" << endl;
+    return DB_FAILED;
+  }
+  string table_name = ast->child_->val_;
+  string file_name = ast->child_->next_->val_;
+  TableInfo *table_info = nullptr;
+  if(PartitionScheme::IsPartitionTableName(table_name) ||
+     context->GetCatalog()->GetTable(table_name, table_info) != DB_SUCCESS){
+    return DB_TABLE_NOT_EXIST;
+  }
+  if(table_info->IsPartitioned()){
+    cout << "Copy into partitioned table '" << table_name << "' is not supported, use insert instead." << endl;
+    return DB_FAILED;
+  }
+  vector<IndexInfo *> indexes;
+  context->GetCatalog()->GetTableIndexes(table_name, indexes);
+  clock_t start_time = clock();
+  BulkLoader loader(table_info, indexes, context->GetTransaction());
+  uint64_t row_count = 0;
+  auto ret = loader.LoadCsv(file_name, row_count);
+  clock_t end_time = clock();
+  if(ret != DB_SUCCESS){
+    return ret;
+  }
+  cout << "Copied " << row_count << " rows into table '" << table_name << "' ("
+       << (double)(end_time - start_time) / CLOCKS_PER_SEC << " sec)." << endl;
+  return DB_SUCCESS;
+}
+
 dberr_t ExecuteEngine::ExecuteExecfile(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
   LOG(INFO) << "ExecuteExecfile" << std::endl;
@@ -672,3 +1306,25 @@ dberr_t ExecuteEngine::ExecuteQuit(pSyntaxNode ast, ExecuteContext *context) {
   ASSERT(ast->type_ == kNodeQuit, "Unexpected node type.");
   return DB_QUIT;
 }
+
+dberr_t ExecuteEngine::ExecuteSet(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteSet" << std::endl;
+#endif
+  string name = ast->child_->val_;
+  string value = ast->child_->next_->val_;
+  // 会话级设置，对之后的语句生效，不需要选中数据库
+  if(name == "scan_threads"){
+    char *end = nullptr;
+    long threads = strtol(value.c_str(), &end, 10);
+    if(*end != '\0' || threads < 1 || threads > MAX_SCAN_THREADS){
+      cout << "scan_threads must be an integer from 1 to " << MAX_SCAN_THREADS << "." << endl;
+      return DB_FAILED;
+    }
+    scan_threads_ = static_cast<uint32_t>(threads);
+    cout << "Sequential scans run on " << scan_threads_ << " thread(s)." << endl;
+    return DB_SUCCESS;
+  }
+  cout << "Unknown setting '" << name << "'." << endl;
+  return DB_FAILED;
+}
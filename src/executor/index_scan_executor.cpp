@@ -1,4 +1,7 @@
 #include "executor/executors/index_scan_executor.h"
+
+#include <algorithm>
+
 #include "planner/expressions/constant_value_expression.h"
 #include "planner/expressions/logic_expression.h"
 /**
@@ -19,9 +22,7 @@ bool IndexScanExecutor::Next(Row *row, RowId *rid) {
     if(time_ >= results_.size()){
       return false;
     }
-    rid = &results_[time_];
-    row->SetRowId(*rid);
-    table_->GetTableHeap()->GetTuple(row, exec_ctx_->GetTransaction());
+    ReadRow(results_[time_], row, rid);
     time_++;
     return true;
   }
@@ -36,14 +37,31 @@ bool IndexScanExecutor::Next(Row *row, RowId *rid) {
     }
   }
   if(results_.empty()) return false;
-  rid = &results_[0];
-  row->SetRowId(*rid);
-  table_->GetTableHeap()->GetTuple(row, exec_ctx_->GetTransaction());
+  if(plan_->heap_order_){
+    std::sort(results_.begin(), results_.end(),
+              [](const RowId &a, const RowId &b) { return a.Get() < b.Get(); });
+  }
+  ReadRow(results_[0], row, rid);
 
   time_++;
   return true;
 }
 
+void IndexScanExecutor::ReadRow(const RowId &result, Row *row, RowId *rid) {
+  Row tuple(result);
+  table_->GetTableHeap()->GetTuple(&tuple, exec_ctx_->GetTransaction());
+  // 和顺序扫描一样只输出select的列
+  vector<Field> output;
+  for (auto column : plan_->OutputSchema()->GetColumns()) {
+    uint32_t col_idx;
+    table_->GetSchema()->GetColumnIndex(column->GetName(), col_idx);
+    output.push_back(*tuple.GetField(col_idx));
+  }
+  *row = Row(output);
+  row->SetRowId(result);
+  *rid = result;
+}
+
 void IndexScanExecutor::GetResult(ComparisonExpression *cmp_child, vector<RowId> &results)
 {
   // 获取比较符号
@@ -3,8 +3,29 @@
 //
 
 #include "executor/executors/insert_executor.h"
+#include "executor/bulk_loader.h"
+#include "executor/plans/index_scan_plan.h"
+#include "executor/plans/seq_scan_plan.h"
 #include "executor/plans/values_plan.h"
 
+// a select that scans the table it inserts into must be read to the end first, or it would read its own rows
+static bool ReadsTable(const AbstractPlanNode *plan, const std::string &table_name) {
+  if (plan->GetType() == PlanType::SeqScan &&
+      dynamic_cast<const SeqScanPlanNode *>(plan)->GetTableName() == table_name) {
+    return true;
+  }
+  if (plan->GetType() == PlanType::IndexScan &&
+      dynamic_cast<const IndexScanPlanNode *>(plan)->GetTableName() == table_name) {
+    return true;
+  }
+  for (const auto &child : plan->GetChildren()) {
+    if (ReadsTable(child.get(), table_name)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 InsertExecutor::InsertExecutor(ExecuteContext *exec_ctx, const InsertPlanNode *plan,
                                std::unique_ptr<AbstractExecutor> &&child_executor)
     : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
@@ -13,6 +34,7 @@ void InsertExecutor::Init() {
   CatalogManager *catalog = exec_ctx_->GetCatalog();
   TableInfo *table;
   assert(catalog->GetTable(plan_->GetTableName(), table) == DB_SUCCESS);
+  table_info_ = table;
   table_heap_ = table->GetTableHeap();
   exec_ctx_->GetCatalog()->GetTableIndexes(table->GetTableName(), index_info_);
   unique_index_ = nullptr;
@@ -26,6 +48,16 @@ void InsertExecutor::Init() {
 }
 
 bool InsertExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
+  if(plan_->GetChildPlan()->GetType() != PlanType::Values){
+    // insert ... select: 整批追加到新页，索引最后排序后批量建立
+    BulkLoader loader(table_info_, index_info_, exec_ctx_->GetTransaction());
+    uint64_t row_count = 0;
+    bool drain = ReadsTable(plan_->GetChildPlan().get(), plan_->GetTableName());
+    if(loader.LoadRows(child_executor_.get(), drain, row_count) != DB_SUCCESS){
+      throw std::runtime_error("no row of the select was inserted into table " + plan_->GetTableName());
+    }
+    return false;
+  }
   vector<Field> fields;
   ValuesPlanNode *values_plan_node = (ValuesPlanNode *)plan_->GetChildPlan().get();
   auto values = values_plan_node->values_;
@@ -37,8 +69,20 @@ bool InsertExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
   }
 
   Row tuple(fields);
+  // auto_increment列的null取下一个值
+  AutoIncrement *auto_increment = table_info_->GetAutoIncrement();
+  if(auto_increment != nullptr && !auto_increment->Fill(tuple)){
+    cout << "No value is left for the auto_increment column." << endl;
+    return false;
+  }
+  // 聚簇表没有primary索引，主键重复时主键树插不进去
   if(!table_heap_->InsertTuple(tuple, exec_ctx_->GetTransaction())){
-    cout << "The tuple is too large." << endl;
+    if(table_heap_->GetStorage() == TableStorage::kClustered){
+      cout << "The tuple is too large or its primary key is taken." << endl;
+    }else{
+      cout << "The tuple is too large." << endl;
+    }
+    return false;
   }
 
   // 插入index
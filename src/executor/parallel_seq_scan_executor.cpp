@@ -0,0 +1,101 @@
+#include "executor/executors/parallel_seq_scan_executor.h"
+
+#include <algorithm>
+
+ParallelSeqScanExecutor::ParallelSeqScanExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+ParallelSeqScanExecutor::~ParallelSeqScanExecutor() { StopWorkers(); }
+
+void ParallelSeqScanExecutor::Init() {
+  StopWorkers();
+  CatalogManager *catalog = exec_ctx_->GetCatalog();
+  dberr_t __attribute__((unused)) result = catalog->GetTable(plan_->GetTableName(), table_);
+  ASSERT(result == DB_SUCCESS, "Table to scan does not exist.");
+  page_ids_ = table_->GetTableHeap()->GetPageIds();
+  column_indexes_.clear();
+  for (auto column : plan_->OutputSchema()->GetColumns()) {
+    uint32_t column_index;
+    table_->GetSchema()->GetColumnIndex(column->GetName(), column_index);
+    column_indexes_.push_back(column_index);
+  }
+  column_mask_ = plan_->GetColumnMask(table_->GetSchema());
+  zone_map_ = plan_->filter_predicate_ != nullptr
+                  ? &table_->GetTableHeap()->GetZoneMap(exec_ctx_->GetTransaction())
+                  : nullptr;
+  size_t morsel_count = (page_ids_.size() + SCAN_MORSEL_PAGES - 1) / SCAN_MORSEL_PAGES;
+  results_.assign(morsel_count, {});
+  done_.assign(morsel_count, false);
+  next_morsel_ = 0;
+  stopped_ = false;
+  morsel_pos_ = 0;
+  row_pos_ = 0;
+  size_t worker_count = std::min<size_t>(exec_ctx_->GetScanThreads(), morsel_count);
+  for (size_t i = 0; i < worker_count; i++) {
+    workers_.emplace_back(&ParallelSeqScanExecutor::ScanMorsels, this);
+  }
+}
+
+void ParallelSeqScanExecutor::StopWorkers() {
+  stopped_ = true;
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+}
+
+void ParallelSeqScanExecutor::ScanMorsels() {
+  TableHeap *table_heap = table_->GetTableHeap();
+  std::vector<Row> rows;
+  size_t row_count;
+  for (size_t morsel = next_morsel_++; morsel < results_.size() && !stopped_; morsel = next_morsel_++) {
+    std::vector<Row> output;
+    size_t end = std::min<size_t>(page_ids_.size(), (morsel + 1) * SCAN_MORSEL_PAGES);
+    for (size_t i = morsel * SCAN_MORSEL_PAGES; i < end; i++) {
+      if (zone_map_ != nullptr && !plan_->MayMatch(*zone_map_, page_ids_[i])) {
+        continue;
+      }
+      table_heap->ReadPage(page_ids_[i], rows, row_count, exec_ctx_->GetTransaction(), column_mask_);
+      for (size_t j = 0; j < row_count; j++) {
+        if (plan_->filter_predicate_ != nullptr &&
+            plan_->filter_predicate_->Evaluate(&rows[j]).CompareEquals(Field(kTypeInt, 1)) != kTrue) {
+          continue;
+        }
+        std::vector<Field> fields;
+        fields.reserve(column_indexes_.size());
+        for (auto column_index : column_indexes_) {
+          fields.push_back(*rows[j].GetField(column_index));
+        }
+        output.emplace_back(fields);
+        output.back().SetRowId(rows[j].GetRowId());
+      }
+    }
+    std::scoped_lock<std::mutex> lock(results_latch_);
+    results_[morsel] = std::move(output);
+    done_[morsel] = true;
+    morsel_done_.notify_all();
+  }
+}
+
+bool ParallelSeqScanExecutor::Next(Row *row, RowId *rid) {
+  while (morsel_pos_ < results_.size()) {
+    if (row_pos_ == 0) {
+      // the workers claim morsels in order, so the one handed out next is always being scanned or done
+      std::unique_lock<std::mutex> lock(results_latch_);
+      morsel_done_.wait(lock, [this] { return done_[morsel_pos_]; });
+    }
+    if (row_pos_ < results_[morsel_pos_].size()) {
+      break;
+    }
+    // a morsel handed out completely is not needed any more
+    std::vector<Row>().swap(results_[morsel_pos_]);
+    morsel_pos_++;
+    row_pos_ = 0;
+  }
+  if (morsel_pos_ == results_.size()) {
+    return false;
+  }
+  *row = results_[morsel_pos_][row_pos_++];
+  *rid = row->GetRowId();
+  return true;
+}
@@ -2,6 +2,7 @@
 // Created by njz on 2023/1/17.
 //
 #include "executor/executors/seq_scan_executor.h"
+#include <algorithm>
 #include <iomanip>
 
 /**
@@ -15,31 +16,205 @@ void SeqScanExecutor::Init() {
   CatalogManager *catalog = exec_ctx_->GetCatalog();
   assert(catalog->GetTable(plan_->GetTableName(), table_) == DB_SUCCESS);
   heap_ = table_->GetTableHeap();
-  iter_ = table_->GetTableHeap()->Begin(exec_ctx_->GetTransaction());
+  // 聚簇表按主键顺序读主键树，where里主键和常量的比较直接定位要读的键
+  bool clustered = heap_->GetStorage() == TableStorage::kClustered;
+  key_low_.reset();
+  key_high_.reset();
+  key_point_ = false;
+  key_after_ = false;
+  key_done_ = false;
+  if (clustered) {
+    SetKeyRange(plan_->filter_predicate_.get());
+  }
+  page_ids_ = clustered ? std::vector<page_id_t>() : heap_->GetPageIds();
+  // long values of columns the scan does not read stay in their overflow chains
+  column_mask_ = plan_->GetColumnMask(table_->GetSchema());
+  zone_map_ = plan_->filter_predicate_ != nullptr && !clustered ? &heap_->GetZoneMap(exec_ctx_->GetTransaction())
+                                                                 : nullptr;
+  // 字典编码的列读出code，where直接比较code，输出时再查字典
+  if (plan_->code_predicate_ != nullptr) {
+    code_schema_.reset(Schema::DeepCopySchema(table_->GetSchema()));
+    for (auto column : code_schema_->GetColumns()) {
+      column->SetDictionary(nullptr);
+    }
+  }
+  // 列存的表，where只是int/float列和常量比较的and时，按页用kernel过滤
+  column_scan_.reset();
+  if (heap_->GetStorage() == TableStorage::kColumn && plan_->filter_predicate_ != nullptr) {
+    column_scan_ = std::make_unique<ColumnScan>(heap_, exec_ctx_->GetTransaction());
+    if (!AddColumnFilters(plan_->filter_predicate_.get(), *column_scan_)) {
+      column_scan_.reset();
+    }
+  }
+  page_pos_ = 0;
+  row_count_ = 0;
+  row_pos_ = 0;
+  pages_skipped_ = 0;
 }
 
 bool SeqScanExecutor::Next(Row *row, RowId *rid) {
-  if(iter_ == heap_->End()){ //如果是结尾
-    return false;
-  }else{
-    if(plan_->filter_predicate_ != nullptr){  // 有where
-      while( plan_->filter_predicate_->Evaluate(&*iter_).CompareEquals(Field(kTypeInt, 1)) != kTrue ){
-        iter_++;
-        if(iter_ == heap_->End()){
+  while (true) {
+    while (row_pos_ == row_count_) {  // 当前页读完了，读下一页
+      if (heap_->GetStorage() == TableStorage::kClustered) {
+        if (!ReadKeyBatch()) {
           return false;
         }
+        continue;
+      }
+      if (page_pos_ == page_ids_.size()) {
+        return false;
+      }
+      page_id_t page_id = page_ids_[page_pos_++];
+      row_pos_ = 0;
+      row_count_ = 0;
+      // 区间排除了where条件的页整页跳过
+      if (zone_map_ != nullptr && !plan_->MayMatch(*zone_map_, page_id)) {
+        pages_skipped_++;
+        continue;
+      }
+      if (column_scan_ != nullptr && column_scan_->SelectPage(page_id, selection_) == 0) {
+        continue;
+      }
+      heap_->ReadPage(page_id, rows_, row_count_, exec_ctx_->GetTransaction(), column_mask_, code_schema_.get());
+    }
+    Row &cur = rows_[row_pos_++];
+    const AbstractExpressionRef &predicate = code_schema_ != nullptr ? plan_->code_predicate_ : plan_->filter_predicate_;
+    if (column_scan_ != nullptr) {  // where已经按页过滤过了
+      uint32_t slot = cur.GetRowId().GetSlotNum();
+      if (((selection_[slot / 64] >> (slot % 64)) & 1) == 0) {
+        continue;
       }
+    } else if(predicate != nullptr &&  // 有where
+       predicate->Evaluate(&cur).CompareEquals(Field(kTypeInt, 1)) != kTrue){
+      continue;
     }
     // 找到了
     vector<Field> output;
     for (auto column : plan_->OutputSchema()->GetColumns()) {
       uint32_t col_idx;
       table_->GetSchema()->GetColumnIndex(column->GetName(), col_idx);
-      output.push_back(*(*iter_).GetField(col_idx));
+      Field *field = cur.GetField(col_idx);
+      if (code_schema_ != nullptr && code_schema_->GetColumn(col_idx)->IsDictionaryEncoded()) {
+        output.emplace_back(*DecodeField(col_idx, field));
+        continue;
+      }
+      output.push_back(*field);
     }
     *row = Row(output);
-    *rid = (*iter_).GetRowId();
-    iter_++;
+    *rid = cur.GetRowId();
+    return true;
+  }
+}
+
+std::unique_ptr<Field> SeqScanExecutor::DecodeField(uint32_t column_index, const Field *code) const {
+  if (code->IsNull()) {
+    return std::make_unique<Field>(TypeId::kTypeChar);
+  }
+  char buf[sizeof(int32_t)];
+  code->SerializeTo(buf);
+  return std::unique_ptr<Field>(table_->GetSchema()->GetColumn(column_index)->GetDictionary()->Decode(MACH_READ_INT32(buf)));
+}
+
+bool SeqScanExecutor::AddColumnFilters(AbstractExpression *expression, ColumnScan &scan) {
+  if (expression->GetType() == ExpressionType::LogicExpression) {
+    return static_cast<LogicExpression *>(expression)->logic_type_ == LogicType::And &&
+           AddColumnFilters(expression->GetChildAt(0).get(), scan) &&
+           AddColumnFilters(expression->GetChildAt(1).get(), scan);
+  }
+  uint32_t column_index;
+  CompareOp op;
+  const Field *constant;
+  return SeqScanPlanNode::GetComparison(expression, column_index, op, constant) &&
+         scan.AddFilter(column_index, op, *constant) == DB_SUCCESS;
+}
+
+void SeqScanExecutor::SetKeyRange(AbstractExpression *predicate) {
+  const std::vector<uint32_t> &key_map = heap_->GetClusteredHeap()->GetKeyMap();
+  const Schema *schema = table_->GetSchema();
+  std::vector<const Field *> equal(key_map.size(), nullptr);
+  const Field *low = nullptr;
+  const Field *high = nullptr;
+  // 只有最外层and起来的比较能缩小范围，范围取闭区间，读出的行还会再过一遍where
+  std::vector<AbstractExpression *> expressions;
+  if (predicate != nullptr) {
+    expressions.push_back(predicate);
+  }
+  while (!expressions.empty()) {
+    AbstractExpression *expression = expressions.back();
+    expressions.pop_back();
+    if (expression->GetType() == ExpressionType::LogicExpression) {
+      if (static_cast<LogicExpression *>(expression)->logic_type_ == LogicType::And) {
+        expressions.push_back(expression->GetChildAt(0).get());
+        expressions.push_back(expression->GetChildAt(1).get());
+      }
+      continue;
+    }
+    uint32_t column_index;
+    CompareOp op;
+    const Field *constant;
+    if (!SeqScanPlanNode::GetComparison(expression, column_index, op, constant) || constant->IsNull() ||
+        constant->GetTypeId() != schema->GetColumn(column_index)->GetType() ||
+        schema->GetColumn(column_index)->IsDictionaryEncoded()) {
+      continue;
+    }
+    auto pos = std::find(key_map.begin(), key_map.end(), column_index);
+    if (pos == key_map.end()) {
+      continue;
+    }
+    if (op == CompareOp::kEqual) {
+      equal[pos - key_map.begin()] = constant;
+    } else if (key_map.size() == 1 && (op == CompareOp::kGreaterThan || op == CompareOp::kGreaterThanEquals)) {
+      if (low == nullptr || constant->CompareGreaterThan(*low) == CmpBool::kTrue) {
+        low = constant;
+      }
+    } else if (key_map.size() == 1 && (op == CompareOp::kLessThan || op == CompareOp::kLessThanEquals)) {
+      if (high == nullptr || constant->CompareLessThan(*high) == CmpBool::kTrue) {
+        high = constant;
+      }
+    }
+  }
+  if (std::find(equal.begin(), equal.end(), nullptr) == equal.end()) {
+    std::vector<Field> fields;
+    for (auto field : equal) {
+      fields.emplace_back(*field);
+    }
+    key_low_ = std::make_unique<Row>(fields);
+    key_point_ = true;
+    return;
+  }
+  if (low != nullptr) {
+    std::vector<Field> fields;
+    fields.emplace_back(*low);
+    key_low_ = std::make_unique<Row>(fields);
+  }
+  if (high != nullptr) {
+    std::vector<Field> fields;
+    fields.emplace_back(*high);
+    key_high_ = std::make_unique<Row>(fields);
+  }
+}
+
+bool SeqScanExecutor::ReadKeyBatch() {
+  row_pos_ = 0;
+  row_count_ = 0;
+  if (key_done_) {
+    return false;
+  }
+  ClusteredHeap *clustered_heap = heap_->GetClusteredHeap();
+  if (key_point_) {
+    key_done_ = true;
+    if (rows_.empty()) {
+      rows_.resize(1);
+    }
+    row_count_ = clustered_heap->GetTupleByKey(*key_low_, &rows_[0]) ? 1 : 0;
     return true;
   }
+  Row last_key;
+  if (!clustered_heap->ReadKeyRange(key_low_.get(), key_after_, key_high_.get(), rows_, row_count_, last_key)) {
+    key_done_ = true;
+    return false;
+  }
+  key_low_ = std::make_unique<Row>(last_key);
+  key_after_ = true;
+  return true;
 }
@@ -14,19 +14,45 @@ UpdateExecutor::UpdateExecutor(ExecuteContext *exec_ctx, const UpdatePlanNode *p
 void UpdateExecutor::Init() {
   exec_ctx_->GetCatalog()->GetTable(plan_->GetTableName(), table_);
   heap_ = table_->GetTableHeap();
+  exec_ctx_->GetCatalog()->GetTableIndexes(plan_->GetTableName(), index_info_);
   child_executor_->Init();
 }
 
 bool UpdateExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
+  Row old_row;
   Row update_row;
   RowId update_rid;
-  if(child_executor_->Next(&update_row, &update_rid)){
-    update_row = GenerateUpdatedTuple(update_row);
-  }else{
-    return false;
+  do {
+    if (!child_executor_->Next(&old_row, &update_rid)) {
+      return false;
+    }
+    // a row that moved further down the table shows up in the scan again
+  } while (!updated_rids_.insert(update_rid.Get()).second);
+  update_row = GenerateUpdatedTuple(old_row);
+  // the row keeps its row id even when it moves, so only indexes whose key changed need work
+  if (!heap_->UpdateTuple(update_row, update_rid, exec_ctx_->GetTransaction())) {
+    return true;
   }
-  heap_->UpdateTuple(update_row, update_rid, exec_ctx_->GetTransaction());
-
+  uint64_t writes = 0;
+  uint64_t saved = 0;
+  for (auto index_info : index_info_) {
+    Row old_key;
+    Row new_key;
+    old_row.GetKeyFromRow(table_->GetSchema(), index_info->GetIndexKeySchema(), old_key);
+    update_row.GetKeyFromRow(table_->GetSchema(), index_info->GetIndexKeySchema(), new_key);
+    bool key_changed = false;
+    for (uint32_t i = 0; i < old_key.GetFieldCount() && !key_changed; i++) {
+      key_changed = old_key.GetField(i)->CompareEquals(*new_key.GetField(i)) != CmpBool::kTrue;
+    }
+    if (!key_changed) {
+      saved += 2;
+      continue;
+    }
+    index_info->GetIndex()->RemoveEntry(old_key, update_rid, exec_ctx_->GetTransaction());
+    index_info->GetIndex()->InsertEntry(new_key, update_rid, exec_ctx_->GetTransaction());
+    writes += 2;
+  }
+  exec_ctx_->AddIndexWrites(writes, saved);
   return true;
 }
 
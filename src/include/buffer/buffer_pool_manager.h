@@ -24,7 +24,10 @@ class BufferPoolManager {
 
   bool FlushPage(page_id_t page_id);
 
-  Page *NewPage(page_id_t &page_id);
+  /**
+   * Allocate a page in the given tablespace and pin it in the pool.
+   */
+  Page *NewPage(page_id_t &page_id, uint32_t space_id = DEFAULT_TABLESPACE_ID);
 
   bool DeletePage(page_id_t page_id);
 
@@ -32,11 +35,20 @@ class BufferPoolManager {
 
   bool CheckAllUnpinned();
 
+  /** @return the size in bytes of every page in this pool */
+  uint32_t GetPageSize() const { return page_size_; }
+
+  /** @return the number of frames in this pool */
+  size_t GetPoolSize() const { return pool_size_; }
+
+  /** @return the disk manager behind this pool, for structures that write their pages without caching them */
+  DiskManager *GetDiskManager() const { return disk_manager_; }
+
  private:
   /**
    * Allocate new page (operations like create index/table) For now just keep an increasing counter
    */
-  page_id_t AllocatePage();
+  page_id_t AllocatePage(uint32_t space_id);
 
   /**
    * Deallocate page (operations like drop index/table) Need bitmap in header page for tracking pages
@@ -47,7 +59,9 @@ class BufferPoolManager {
 
  private:
   size_t pool_size_;                                 // number of pages in buffer pool
+  uint32_t page_size_;                               // page size of the underlying database file
   Page *pages_;                                      // array of pages
+  char *page_data_;                                  // frame memory shared by all pages
   DiskManager *disk_manager_;                        // pointer to the disk manager.
   unordered_map<page_id_t, frame_id_t> page_table_;  // to keep track of pages
   Replacer *replacer_;                               // to find an unpinned page for replacement
@@ -0,0 +1,64 @@
+#ifndef MINISQL_AUTO_INCREMENT_H
+#define MINISQL_AUTO_INCREMENT_H
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+#include "common/config.h"
+#include "record/row.h"
+
+/**
+ * AutoIncrement hands out the values of the auto_increment column of a table.
+ *
+ * The table metadata keeps a limit: every value below it may have been handed out already, none above it has. Values
+ * are taken from an in memory counter, and only when the counter reaches the limit is a block of the next
+ * AUTO_INCREMENT_CACHE_SIZE values reserved by moving the limit up and writing it to the catalog. Inserters share the
+ * counter without a latch, the latch only orders the reservations. After a restart the counter starts at the limit, so
+ * the values reserved but not handed out before are skipped and no value is handed out twice.
+ */
+class AutoIncrement {
+ public:
+  /** Writes a new limit to the catalog, false if it could not be written */
+  using Reserve = std::function<bool(int32_t limit)>;
+
+  AutoIncrement(uint32_t column_index, int32_t limit, Reserve reserve);
+
+  /**
+   * Give a null value of the column the next value of the counter. A value given by the inserter is kept, and the
+   * counter moves past it so it is not handed out again later.
+   * @return false if no value is left or the limit could not be written
+   */
+  bool Fill(Row &row);
+
+  /**
+   * @return the next value of the counter
+   */
+  bool Next(int32_t &value);
+
+  /**
+   * Move the counter past a value that was given explicitly.
+   */
+  bool Observe(int32_t value);
+
+  inline uint32_t GetColumnIndex() const { return column_index_; }
+
+  /** @return the limit last written to the catalog */
+  inline int32_t GetLimit() const { return static_cast<int32_t>(limit_.load()); }
+
+ private:
+  /**
+   * Move the limit above the value, in blocks of AUTO_INCREMENT_CACHE_SIZE but no further than the largest int.
+   * @return false if the value is the largest int or the limit could not be written
+   */
+  bool ReserveAbove(int64_t value);
+
+ private:
+  uint32_t column_index_;
+  std::atomic<int64_t> next_;
+  std::atomic<int64_t> limit_;
+  Reserve reserve_;
+  std::mutex reserve_latch_;
+};
+
+#endif  // MINISQL_AUTO_INCREMENT_H
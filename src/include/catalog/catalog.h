@@ -10,6 +10,7 @@
 #include "catalog/table.h"
 #include "common/config.h"
 #include "common/dberr.h"
+#include "storage/page_reclaimer.h"
 #include "transaction/lock_manager.h"
 #include "transaction/log_manager.h"
 #include "transaction/transaction.h"
@@ -76,27 +77,177 @@ class CatalogManager {
 
   ~CatalogManager();
 
-  dberr_t CreateTable(const std::string &table_name, TableSchema *schema, Transaction *txn, TableInfo *&table_info);
+  /**
+   * Create a table whose heap lives in the given tablespace, the catalog entry itself always stays in the database
+   * file. A table stored by column fails if a page cannot hold a single row of the schema. A table stored in memory
+   * keeps its catalog entry but none of its rows when the database is opened again.
+   *
+   * A temporary table is stored in memory and has no catalog entry on disk at all, it lasts until the catalog goes
+   * away or DropTemporaryTables is called.
+   *
+   * A partitioned table takes the scheme over and gets a table of its own for every partition, see PartitionScheme.
+   * It cannot be temporary.
+   *
+   * A clustered table orders its rows by the columns of cluster_key, its primary key, and fails without one or if a
+   * page cannot hold a few rows of the schema.
+   */
+  dberr_t CreateTable(const std::string &table_name, TableSchema *schema, Transaction *txn, TableInfo *&table_info,
+                      uint32_t space_id = DEFAULT_TABLESPACE_ID, TableStorage storage = TableStorage::kRow,
+                      bool temporary = false, PartitionScheme *partitions = nullptr,
+                      const std::vector<std::string> &cluster_key = {});
 
   dberr_t GetTable(const std::string &table_name, TableInfo *&table_info);
 
   dberr_t GetTables(std::vector<TableInfo *> &tables) const;
 
+  /**
+   * Create an index on a table and fill it with the rows of the table. A table stored in memory gets an index in
+   * memory, a hash index for the type "hash" and an ordered one otherwise, any other table a B+ tree.
+   */
   dberr_t CreateIndex(const std::string &table_name, const std::string &index_name,
                       const std::vector<std::string> &index_keys, Transaction *txn, IndexInfo *&index_info,
-                      const string &index_type);
+                      const string &index_type, uint32_t space_id = DEFAULT_TABLESPACE_ID);
 
   dberr_t GetIndex(const std::string &table_name, const std::string &index_name, IndexInfo *&index_info) const;
 
   dberr_t GetTableIndexes(const std::string &table_name, std::vector<IndexInfo *> &indexes) const;
 
+  /**
+   * Drop a table and its indexes. Their pages are freed in the background by the page reclaimer, so the call takes
+   * the same time for any size of table.
+   */
   dberr_t DropTable(const std::string &table_name);
 
   dberr_t DropIndex(const std::string &table_name, const std::string &index_name);
 
+  /**
+   * Drop all temporary tables, at the end of the session that created them.
+   */
+  dberr_t DropTemporaryTables();
+
+  /**
+   * Empty a table: a new empty heap takes the place of the old one and every index of the table is emptied, the old
+   * pages go to the page reclaimer. The schema, the storage and the tablespace stay as they are.
+   */
+  dberr_t TruncateTable(const std::string &table_name, Transaction *txn);
+
+  /**
+   * Append a range partition to a partitioned table, with the storage and the indexes of the other partitions. The
+   * bound has to lie above the bounds of all partitions there are, nullptr stands for MAXVALUE.
+   */
+  dberr_t AddPartition(const std::string &table_name, const std::string &partition_name, const Field *bound,
+                       Transaction *txn);
+
+  /**
+   * Drop a range partition together with its rows, as fast as DropTable. The last partition of a table and hash
+   * partitions cannot be dropped.
+   */
+  dberr_t DropPartition(const std::string &table_name, const std::string &partition_name);
+
+  dberr_t TruncatePartition(const std::string &table_name, const std::string &partition_name, Transaction *txn);
+
+  /**
+   * Add a column behind the others without touching a single row: the column goes into the schema with the next
+   * version and its default, rows written before read the default for it. Only tables stored by row or in an lsm tree
+   * can add columns. The catalog takes the column over.
+   */
+  dberr_t AddColumn(const std::string &table_name, Column *column);
+
+  /**
+   * Make an int column of a table auto_increment, see AutoIncrement. Its values start above the largest one the table
+   * holds. A partitioned table and a table with an auto_increment column already cannot have another one.
+   */
+  dberr_t SetAutoIncrement(const std::string &table_name, const std::string &column_name);
+
+  /**
+   * Dictionary encode a char column of an empty table, see Dictionary: its values are kept in catalog pages and the
+   * rows and index keys of the table store their codes. Only columns no longer than OVERFLOW_THRESHOLD of tables
+   * stored by row can be encoded, partitioned and temporary tables cannot.
+   */
+  dberr_t SetDictionary(const std::string &table_name, const std::string &column_name);
+
+  /**
+   * @return the reclaimer freeing the pages of dropped and truncated tables and indexes
+   */
+  inline PageReclaimer *GetPageReclaimer() { return &page_reclaimer_; }
+
+  /**
+   * Compact the heap of a table, see TableHeap::Vacuum, and point the index entries of the rows that moved to their
+   * new row ids. An index that cannot take one of the new row ids is rebuilt from the compacted heap.
+   * @param[out] pages_reclaimed number of pages freed
+   * @param[out] rows_moved number of rows with a new row id
+   */
+  dberr_t VacuumTable(const std::string &table_name, uint32_t &pages_reclaimed, uint32_t &rows_moved,
+                      Transaction *txn);
+
+  /**
+   * Rewrite the heap of a table in the key order of one of its indexes: a new heap takes the rows in that order, rows
+   * the index does not hold behind the others, and every index gets a new tree with the new row ids. Heap and trees
+   * are built next to the old ones and only swapped in once all of them are, so a table that cannot be clustered is
+   * left as it was. The old heap and trees go to the page reclaimer. Afterwards each index records the correlation of
+   * its key order with the heap order, which the planner reads, see IndexMetadata::SetCorrelation. Rows inserted later
+   * are not kept in order.
+   *
+   * Only tables stored by row or by column can be clustered, a partitioned table clusters each partition on its own.
+   */
+  dberr_t ClusterTable(const std::string &table_name, const std::string &index_name, Transaction *txn);
+
  private:
   dberr_t DropTable(table_id_t table_id);
 
+  /**
+   * @return an id no table has, temporary tables included, which the catalog meta does not know of
+   */
+  table_id_t NextTableId() const;
+
+  /**
+   * @return an id no index has, the trees of clustered tables included, which the catalog meta does not know of
+   */
+  index_id_t NextIndexId() const;
+
+  /**
+   * Hand a heap no catalog entry refers to any more to the page reclaimer, which frees its pages and deletes it.
+   */
+  void ReclaimTableHeap(TableHeap *table_heap);
+
+  /**
+   * Write the meta data of a table to its page again, after its heap or its partitions changed.
+   */
+  dberr_t FlushTableMeta(TableInfo *table_info);
+
+  /**
+   * Write the meta data of an index to its page again, after its correlation changed.
+   */
+  dberr_t FlushIndexMeta(IndexInfo *index_info);
+
+  /**
+   * Empty an index and insert the keys of all rows of its table again, in key order.
+   */
+  dberr_t RebuildIndex(TableInfo *table_info, IndexInfo *index_info, Transaction *txn);
+
+  /**
+   * Correlate the rank of each entry of a B+ tree index with the position of its row in the heap.
+   * @param positions position in heap order of every row, by row id
+   * @return the Pearson correlation, NaN for other indexes or if it is undefined
+   */
+  double MeasureCorrelation(IndexInfo *index_info, const std::unordered_map<int64_t, size_t> &positions);
+
+  /**
+   * Hand the values of the auto_increment column of a table out from the limit in its meta data, reserving the next
+   * blocks through the meta page.
+   */
+  void InitAutoIncrement(TableInfo *table_info);
+
+  /**
+   * Read the dictionaries of the encoded columns of a table back from their pages and attach them to the columns.
+   */
+  void InitDictionaries(TableInfo *table_info);
+
+  /**
+   * Append a value to a dictionary whose chain of pages ends at the given page, linking a new page when it is full.
+   */
+  bool AppendDictionaryValue(page_id_t &last_page_id, const std::string &value);
+
   dberr_t FlushCatalogMetaPage() const;
 
   dberr_t LoadTable(const table_id_t table_id, const page_id_t page_id);
@@ -118,6 +269,8 @@ class CatalogManager {
   // map for indexes: table_name->index_name->indexes
   std::unordered_map<std::string, std::unordered_map<std::string, index_id_t>> index_names_;
   std::unordered_map<index_id_t, IndexInfo *> indexes_;
+  // declared last so that it finishes freeing pages before anything else of the catalog goes away
+  PageReclaimer page_reclaimer_;
 };
 
 #endif  // MINISQL_CATALOG_H
@@ -0,0 +1,125 @@
+#ifndef MINISQL_DATABASE_VACUUM_H
+#define MINISQL_DATABASE_VACUUM_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "common/dberr.h"
+#include "record/schema.h"
+#include "storage/disk_manager.h"
+
+/**
+ * Outcome of a vacuum run.
+ */
+struct VacuumStats {
+  uint64_t bytes_before_{0};
+  uint64_t bytes_after_{0};
+  uint32_t live_pages_{0};
+  // live pages that had to change their page id
+  uint32_t moved_pages_{0};
+  // allocated pages no catalog structure referred to, e.g. left behind by a crash
+  uint32_t released_pages_{0};
+  // share of table heap page links that point to the physically next page, before and after
+  double heap_locality_before_{0};
+  double heap_locality_after_{0};
+};
+
+/**
+ * DatabaseVacuum compacts the files of a database: every live page is moved toward the front of its tablespace and
+ * the tail of each file is cut off.
+ *
+ * Live pages are found by walking the catalog: the catalog meta page, the index roots page, the table and index meta
+ * pages, the table heap chains each followed by its free space map, the overflow chains of its values and the
+ * dictionary pages of its encoded columns, and the B+ trees. They are laid out again in that order, so a table heap becomes one run of consecutive pages and the
+ * levels of a B+ tree follow each other with the leaves in key order. The LSM trees of tables and indexes stored in
+ * them (see LsmTree) take the place of the heap chain or the B+ tree, their manifest followed by every run. The blocks of a
+ * compressed heap (see CompressedHeap) are a heap chain of their own. A clustered heap (see ClusteredHeap) takes its
+ * meta page followed by its trees, whose ids the index roots page keeps next to those of the indexes. Its row ids, and
+ * those in the indexes of its table, are not page ids and stay as they are. Every page reference is rewritten on the way,
+ * including the row ids kept in the B+ tree leaves, the heap pages listed in the free space maps and the overflow
+ * chains referred to from tuples. Any allocated page the walk does not reach is released, so a new kind of page must
+ * be taught to the walk before it can be vacuumed safely.
+ *
+ * The vacuum works directly on the disk manager: the buffer pool of the database must be flushed and dropped before
+ * Run and rebuilt afterwards.
+ */
+class DatabaseVacuum {
+ public:
+  explicit DatabaseVacuum(DiskManager *disk_manager);
+
+  dberr_t Run(VacuumStats &stats);
+
+ private:
+  enum class PageKind {
+    kCatalogMeta,
+    kIndexRoots,
+    kTableMeta,
+    kIndexMeta,
+    kTableHeap,
+    kColumnHeap,
+    kFreeSpaceMap,
+    kOverflow,
+    kDictionary,
+    kIndexTree,
+    kLsmManifest,
+    kLsmRun,
+    // the fences of an LSM run, their values are page ids
+    kLsmFence,
+    kLsmFilter,
+    kCompressedBlock,
+    kClusteredMeta,
+    // a B+ tree of a clustered table or an index of one, its row ids are no page ids
+    kClusteredTree
+  };
+
+  /**
+   * Collect the live pages in their new order, together with the table heap chains for the locality statistics.
+   */
+  void CollectLivePages();
+
+  void AddLivePage(page_id_t page_id, PageKind kind);
+
+  /**
+   * Collect the manifest chain of an LSM tree followed by its runs, each run one after another.
+   */
+  void AddLsmTree(page_id_t manifest_page_id);
+
+  /**
+   * Collect the pages of a B+ tree level by level, which leaves the leaves in key order.
+   */
+  void AddTree(page_id_t root_page_id, PageKind kind);
+
+  page_id_t Remap(page_id_t page_id) const;
+
+  /**
+   * Rewrite all page references held by the page, which is about to be written as new_page_id.
+   */
+  void RemapPage(page_id_t new_page_id, PageKind kind, char *buf);
+
+  /**
+   * Move the live pages to their new ids, following each chain of moves from a free slot or around a cycle so that
+   * every page is read and written once.
+   */
+  void MovePages();
+
+  double GetHeapLocality(bool remapped) const;
+
+ private:
+  DiskManager *disk_manager_;
+  uint32_t page_size_;
+  std::vector<std::pair<page_id_t, PageKind>> live_pages_;
+  // old page id -> new page id
+  std::unordered_map<page_id_t, page_id_t> new_ids_;
+  std::unordered_map<page_id_t, PageKind> kinds_;
+  std::unordered_map<uint32_t, uint32_t> space_page_counts_;
+  std::vector<std::vector<page_id_t>> heap_chains_;
+  // the schemas of the tables, and the one of every row heap page by its old page id, to read its tuples
+  std::vector<std::unique_ptr<Schema>> schemas_;
+  std::unordered_map<page_id_t, Schema *> heap_schemas_;
+  // the index ids of the trees of clustered heaps, which the catalog meta does not list
+  std::vector<index_id_t> clustered_tree_ids_;
+};
+
+#endif  // MINISQL_DATABASE_VACUUM_H
@@ -1,6 +1,7 @@
 #ifndef MINISQL_INDEXES_H
 #define MINISQL_INDEXES_H
 
+#include <cmath>
 #include <memory>
 
 #include "catalog/table.h"
@@ -8,6 +9,8 @@
 #include "common/rowid.h"
 #include "index/b_plus_tree_index.h"
 #include "index/generic_key.h"
+#include "index/lsm_index.h"
+#include "index/memory_index.h"
 #include "record/schema.h"
 
 class IndexMetadata {
@@ -15,7 +18,8 @@ class IndexMetadata {
 
  public:
   static IndexMetadata *Create(const index_id_t index_id, const std::string &index_name, const table_id_t table_id,
-                               const std::vector<uint32_t> &key_map);
+                               const std::vector<uint32_t> &key_map, uint32_t space_id = DEFAULT_TABLESPACE_ID,
+                               const std::string &index_type = "bptree");
 
   uint32_t SerializeTo(char *buf) const;
 
@@ -33,11 +37,28 @@ class IndexMetadata {
 
   inline index_id_t GetIndexId() const { return index_id_; }
 
+  inline uint32_t GetTablespaceId() const { return space_id_; }
+
+  inline const std::string &GetIndexType() const { return index_type_; }
+
+  /**
+   * @return whether the correlation of the index is known, see SetCorrelation
+   */
+  inline bool HasCorrelation() const { return !std::isnan(correlation_); }
+
+  inline double GetCorrelation() const { return correlation_; }
+
+  /**
+   * Record how closely the order of the keys follows the order of the rows in the heap, from -1 (reversed) through 0
+   * (unrelated) to 1 (the same), see CatalogManager::ClusterTable.
+   */
+  inline void SetCorrelation(double correlation) { correlation_ = correlation; }
+
  private:
   IndexMetadata() = delete;
 
   explicit IndexMetadata(const index_id_t index_id, const std::string &index_name, const table_id_t table_id,
-                         const std::vector<uint32_t> &key_map);
+                         const std::vector<uint32_t> &key_map, uint32_t space_id, const std::string &index_type);
 
  private:
   static constexpr uint32_t INDEX_METADATA_MAGIC_NUM = 344528;
@@ -45,6 +66,9 @@ class IndexMetadata {
   std::string index_name_;
   table_id_t table_id_;
   std::vector<uint32_t> key_map_; /** The mapping of index key to tuple key */
+  uint32_t space_id_;             /** The tablespace holding the pages of the index */
+  std::string index_type_;        /** The type asked for at create index, see IndexInfo::CreateIndex */
+  double correlation_{NAN};       /** The correlation of key order and heap order, NaN until it is measured */
 };
 
 /**
@@ -66,8 +90,16 @@ class IndexInfo {
     // Step2: mapping index key to key schema
     auto schema = table_info->GetSchema();
     key_schema_ = Schema::ShallowCopySchema(schema, meta_data_->GetKeyMapping());
-    // Step3: call CreateIndex to create the index
-    index_ = CreateIndex(buffer_pool_manager, "bptree");  // index_name_?
+    // Step3: call CreateIndex to create the index, a table in memory gets an index in memory as well and a table in
+    // an LSM tree an index in an LSM tree
+    TableStorage storage = table_info->GetTableHeap()->GetStorage();
+    if (storage == TableStorage::kMemory) {
+      index_ = CreateMemoryIndex(meta_data_->GetIndexType());
+    } else if (storage == TableStorage::kLsm) {
+      index_ = new LsmIndex(meta_data_->index_id_, key_schema_, buffer_pool_manager, meta_data_->space_id_);
+    } else {
+      index_ = CreateIndex(buffer_pool_manager, "bptree");
+    }
   }
 
   inline Index *GetIndex() { return index_; }
@@ -76,11 +108,22 @@ class IndexInfo {
 
   IndexSchema *GetIndexKeySchema() { return key_schema_; }
 
+  uint32_t GetTablespaceId() { return meta_data_->GetTablespaceId(); }
+
+  const std::string &GetIndexType() { return meta_data_->GetIndexType(); }
+
+  inline IndexMetadata *GetIndexMetadata() { return meta_data_; }
+
  private:
   explicit IndexInfo() : meta_data_{nullptr}, index_{nullptr}, key_schema_{nullptr} {}
 
   Index *CreateIndex(BufferPoolManager *buffer_pool_manager, const string &index_type);
 
+  /**
+   * @return a hash index for the type "hash", an ordered index for any other
+   */
+  Index *CreateMemoryIndex(const string &index_type);
+
  private:
   IndexMetadata *meta_data_;
   Index *index_;
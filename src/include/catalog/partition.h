@@ -0,0 +1,113 @@
+#ifndef MINISQL_PARTITION_H
+#define MINISQL_PARTITION_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/compare_op.h"
+#include "common/config.h"
+#include "record/field.h"
+#include "record/schema.h"
+
+enum class PartitionKind : uint32_t { kRange = 1, kHash = 2 };
+
+/**
+ * A partition scheme splits the rows of a table by the value of one column. Each partition is a table of its own in
+ * the catalog, with its own heap and its own local indexes, named after the table and the partition (see
+ * GetTableName). The partitioned table itself has no heap, the scheme only lists the table ids of its partitions.
+ *
+ * Range partitions are ordered by their bounds: a row goes to the first partition whose bound is larger than its
+ * value, the last partition may have no bound (MAXVALUE) and takes all values above the others. Hash partitions take
+ * the rows whose value hashes to their position. A null value goes to the first partition of either kind.
+ *
+ *  Format (size in byte):
+ *  -------------------------------------------------------------------------------------------------
+ *  | Kind (4) | ColumnIndex (4) | Count (4) | NameLength_1 (4) | Name_1 | TableId_1 (4) | Bounded_1 (4) |
+ *  -------------------------------------------------------------------------------------------------
+ *  | Bound_1 | NameLength_2 (4) | ... |
+ *  ------------------------------------
+ */
+class PartitionScheme {
+ public:
+  PartitionScheme(PartitionKind kind, uint32_t column_index, TypeId type);
+
+  /**
+   * Append a partition. A range partition without a bound takes all values above the others.
+   * @return false if the bound does not lie above the one before, does not have the type of the column, or if a hash
+   * partition is given a bound
+   */
+  bool AddPartition(const std::string &name, table_id_t table_id, const Field *bound = nullptr);
+
+  void RemovePartition(uint32_t index);
+
+  /**
+   * @return the position of the partition that takes rows with the given value, false if the value lies above the
+   * bounds of all range partitions
+   */
+  bool Locate(const Field &value, uint32_t &index) const;
+
+  /**
+   * @return false if no row of the partition can have a value that compares true against the constant
+   */
+  bool MayMatch(uint32_t index, CompareOp op, const Field &constant) const;
+
+  /** @return the position of the partition with the given name, false if there is none */
+  bool FindPartition(const std::string &name, uint32_t &index) const;
+
+  inline PartitionKind GetKind() const { return kind_; }
+
+  inline uint32_t GetColumnIndex() const { return column_index_; }
+
+  inline uint32_t GetPartitionCount() const { return partitions_.size(); }
+
+  inline const std::string &GetPartitionName(uint32_t index) const { return partitions_[index].name_; }
+
+  inline table_id_t GetTableId(uint32_t index) const { return partitions_[index].table_id_; }
+
+  inline void SetTableId(uint32_t index, table_id_t table_id) { partitions_[index].table_id_ = table_id; }
+
+  /** @return true if the last range partition has no bound */
+  bool IsUnbounded() const;
+
+  uint32_t SerializeTo(char *buf) const;
+
+  uint32_t GetSerializedSize() const;
+
+  /**
+   * Read a scheme back, the bounds have the type of the partition column in the schema.
+   */
+  static uint32_t DeserializeFrom(char *buf, const Schema *schema, PartitionScheme *&scheme);
+
+  /**
+   * @return the name of the table in the catalog that holds a partition
+   */
+  static std::string GetTableName(const std::string &table_name, const std::string &partition_name) {
+    return table_name + "#" + partition_name;
+  }
+
+  /**
+   * @return true if the name is that of the table holding a partition, no statement names such a table directly
+   */
+  static bool IsPartitionTableName(const std::string &table_name) {
+    return table_name.find('#') != std::string::npos;
+  }
+
+ private:
+  struct Partition {
+    std::string name_;
+    table_id_t table_id_;
+    // the values of a range partition lie below its bound, nullptr for MAXVALUE and for hash partitions
+    std::unique_ptr<Field> bound_;
+  };
+
+  static uint32_t HashValue(const Field &value);
+
+ private:
+  PartitionKind kind_;
+  uint32_t column_index_;
+  TypeId type_;
+  std::vector<Partition> partitions_;
+};
+
+#endif  // MINISQL_PARTITION_H
@@ -3,15 +3,19 @@
 
 #include <memory>
 
+#include "catalog/auto_increment.h"
+#include "catalog/partition.h"
 #include "glog/logging.h"
 #include "record/schema.h"
 #include "storage/table_heap.h"
 
 class TableMetadata {
   friend class TableInfo;
+  friend class DatabaseVacuum;
 
  public:
   ~TableMetadata() { //delete schema_;
+    delete partitions_;
   }
 
   uint32_t SerializeTo(char *buf) const;
@@ -21,10 +25,12 @@ class TableMetadata {
   static uint32_t DeserializeFrom(char *buf, TableMetadata *&table_meta);
 
   /*
-   * will create new table schema and owned by mem heap
+   * will create new table schema and owned by mem heap, the partition scheme of a partitioned table is owned by the
+   * metadata as well
    */
   static TableMetadata *Create(table_id_t table_id, std::string table_name, page_id_t root_page_id,
-                               TableSchema *schema);
+                               page_id_t fsm_page_id, TableSchema *schema,
+                               TableStorage storage = TableStorage::kRow, PartitionScheme *partitions = nullptr);
 
   inline table_id_t GetTableId() const { return table_id_; }
 
@@ -32,19 +38,54 @@ class TableMetadata {
 
   inline uint32_t GetFirstPageId() const { return root_page_id_; }
 
+  inline page_id_t GetFreeSpaceMapPageId() const { return fsm_page_id_; }
+
   inline Schema *GetSchema() const { return schema_; }
 
+  inline TableStorage GetStorage() const { return storage_; }
+
+  /** @return the partition scheme of a partitioned table, nullptr for any other */
+  inline PartitionScheme *GetPartitionScheme() const { return partitions_; }
+
+  /** @return true if a column of the table is auto_increment */
+  inline bool HasAutoIncrement() const { return auto_increment_column_ != INVALID_COLUMN_INDEX; }
+
+  inline uint32_t GetAutoIncrementColumn() const { return auto_increment_column_; }
+
+  /** @return the limit of the auto_increment values, see AutoIncrement */
+  inline int32_t GetAutoIncrementLimit() const { return auto_increment_limit_; }
+
+  inline void SetAutoIncrement(uint32_t column_index, int32_t limit) {
+    auto_increment_column_ = column_index;
+    auto_increment_limit_ = limit;
+  }
+
+  /** @return the dictionary encoded columns of the table, and the first page of their dictionaries */
+  inline const std::vector<std::pair<uint32_t, page_id_t>> &GetDictionaries() const { return dictionaries_; }
+
+  inline void AddDictionary(uint32_t column_index, page_id_t first_page_id) {
+    dictionaries_.emplace_back(column_index, first_page_id);
+  }
+
  private:
   TableMetadata() = delete;
 
-  TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema);
+  TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, page_id_t fsm_page_id,
+                TableSchema *schema, TableStorage storage, PartitionScheme *partitions);
 
  private:
   static constexpr uint32_t TABLE_METADATA_MAGIC_NUM = 344528;
+  static constexpr uint32_t INVALID_COLUMN_INDEX = UINT32_MAX;
   table_id_t table_id_;
   std::string table_name_;
   page_id_t root_page_id_;
+  page_id_t fsm_page_id_;
+  TableStorage storage_;
   Schema *schema_;
+  PartitionScheme *partitions_;
+  uint32_t auto_increment_column_{INVALID_COLUMN_INDEX};
+  int32_t auto_increment_limit_{0};
+  std::vector<std::pair<uint32_t, page_id_t>> dictionaries_;
 };
 
 /**
@@ -59,13 +100,31 @@ class TableInfo {
     delete table_heap_;
   }
 
-  void Init(TableMetadata *table_meta, TableHeap *table_heap) {
+  void Init(TableMetadata *table_meta, TableHeap *table_heap, bool temporary = false) {
     table_meta_ = table_meta;
     table_heap_ = table_heap;
+    temporary_ = temporary;
   }
 
   inline TableHeap *GetTableHeap() const { return table_heap_; }
 
+  /**
+   * Put another heap in place of the current one, the meta data follows it. A table about to be dropped gives its
+   * heap up with nullptr.
+   * @return the old heap, owned by the caller from then on
+   */
+  TableHeap *ReplaceTableHeap(TableHeap *table_heap) {
+    TableHeap *old_table_heap = table_heap_;
+    table_heap_ = table_heap;
+    if (table_heap != nullptr) {
+      table_meta_->root_page_id_ = table_heap->GetFirstPageId();
+      table_meta_->fsm_page_id_ = table_heap->GetFreeSpaceMapPageId();
+    }
+    return old_table_heap;
+  }
+
+  inline TableMetadata *GetTableMetadata() const { return table_meta_; }
+
   inline table_id_t GetTableId() const { return table_meta_->table_id_; }
 
   inline std::string GetTableName() const { return table_meta_->table_name_; }
@@ -74,12 +133,58 @@ class TableInfo {
 
   inline page_id_t GetRootPageId() const { return table_meta_->root_page_id_; }
 
+  /**
+   * @return true for a table of the session only, which has no catalog entry on disk
+   */
+  inline bool IsTemporary() const { return temporary_; }
+
+  /**
+   * @return true for a table split into partitions, which has no heap of its own
+   */
+  inline bool IsPartitioned() const { return table_meta_->partitions_ != nullptr; }
+
+  inline PartitionScheme *GetPartitionScheme() const { return table_meta_->partitions_; }
+
+  /**
+   * @return the values of the auto_increment column of the table, nullptr if it has none
+   */
+  inline AutoIncrement *GetAutoIncrement() const { return auto_increment_.get(); }
+
+  inline void SetAutoIncrement(AutoIncrement *auto_increment) { auto_increment_.reset(auto_increment); }
+
+  /**
+   * @return the tables holding the partitions in the order of the partition scheme, empty unless partitioned
+   */
+  inline const std::vector<TableInfo *> &GetPartitions() const { return partitions_; }
+
+  /**
+   * Link the tables of the partitions to a partitioned table, in the order of its partition scheme.
+   */
+  void SetPartitions(std::vector<TableInfo *> partitions) {
+    for (auto partition : partitions_) {
+      partition->parent_ = nullptr;
+    }
+    partitions_ = std::move(partitions);
+    for (auto partition : partitions_) {
+      partition->parent_ = this;
+    }
+  }
+
+  /**
+   * @return the partitioned table of a table that holds one of its partitions, nullptr for any other
+   */
+  inline TableInfo *GetParent() const { return parent_; }
+
  private:
   explicit TableInfo(){};
 
  private:
   TableMetadata *table_meta_;
   TableHeap *table_heap_;
+  bool temporary_{false};
+  std::vector<TableInfo *> partitions_;
+  TableInfo *parent_{nullptr};
+  std::unique_ptr<AutoIncrement> auto_increment_;
 };
 
 #endif  // MINISQL_TABLE_H
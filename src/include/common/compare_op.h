@@ -0,0 +1,9 @@
+#ifndef MINISQL_COMPARE_OP_H
+#define MINISQL_COMPARE_OP_H
+
+/**
+ * How a column is compared with a constant, for the scan kernels, the zone maps and partition pruning.
+ */
+enum class CompareOp { kEqual, kNotEqual, kLessThan, kLessThanEquals, kGreaterThan, kGreaterThanEquals };
+
+#endif  // MINISQL_COMPARE_OP_H
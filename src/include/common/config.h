@@ -13,11 +13,36 @@ static constexpr int META_PAGE_ID = 0;          // physical page id of the disk
 static constexpr int CATALOG_META_PAGE_ID = 0;  // logical page id of the catalog meta data
 static constexpr int INDEX_ROOTS_PAGE_ID = 1;   // logical page id of the index roots
 
-static constexpr int PAGE_SIZE = 4096;                  // size of a data page in byte
+static constexpr int PAGE_SIZE = 4096;                  // default size of a data page in byte
+static constexpr int MAX_PAGE_SIZE = 32768;             // largest page size a database can be created with
 static constexpr int DEFAULT_BUFFER_POOL_SIZE = 20480;  // default size of buffer pool
+static constexpr uint64_t DEFAULT_FILE_GROWTH_SIZE = 1 << 20;  // data files grow in chunks of this many bytes
+static constexpr uint32_t DEFAULT_SCAN_THREADS = 1;           // worker threads of a sequential scan, 1 scans serially
+static constexpr uint32_t MAX_SCAN_THREADS = 64;               // most threads `set scan_threads` accepts
+static constexpr uint32_t SCAN_MORSEL_PAGES = 16;              // heap pages a parallel scan worker claims at a time
+static constexpr uint32_t MAX_INSERTION_PAGES = 64;            // threads a heap keeps an insert target page for
+static constexpr double AUTO_VACUUM_FREE_SPACE_RATIO = 0.5;    // auto vacuum compacts heaps that are this much free space
+static constexpr uint32_t AUTO_INCREMENT_CACHE_SIZE = 1000;     // auto_increment values a table reserves at a time
+static constexpr double CLUSTERED_CORRELATION = 0.9;  // an index scan reads rows in key order above this correlation
+
+static constexpr int TABLESPACE_PAGE_BITS = 24;    // low bits of a page id address a page inside its tablespace
+static constexpr uint32_t MAX_TABLESPACES = 128;   // the remaining bits of a non-negative page id name the tablespace
+static constexpr uint32_t DEFAULT_TABLESPACE_ID = 0;  // tablespace of the database file itself
 
 static constexpr uint32_t FIELD_NULL_LEN = UINT32_MAX;
-static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;  // max length of varchar
+static constexpr uint32_t VARCHAR_MAX_LEN = 1 << 20;  // max length of varchar, long values live in overflow pages
+static constexpr uint32_t OVERFLOW_THRESHOLD = 256;   // char values longer than this are stored out of the tuple
+static constexpr uint32_t OVERFLOW_PREFIX_SIZE = 16;  // bytes of an overflowed value kept in the tuple
+static constexpr uint32_t DICTIONARY_MAX_SIZE = 1 << 16;  // distinct values of a dictionary encoded char column
+
+static constexpr uint32_t LSM_MEMTABLE_SIZE = 4 << 20;    // bytes of entries a memtable takes before it is flushed
+static constexpr uint32_t LSM_L0_RUNS = 4;                // runs level 0 of an LSM tree holds before a compaction
+static constexpr uint32_t LSM_LEVEL_RATIO = 10;           // each level of an LSM tree is this much larger than the last
+static constexpr uint32_t LSM_BLOOM_BITS_PER_KEY = 10;    // bloom filter bits per key of an LSM run
+static constexpr uint32_t LSM_ROWS_PER_PAGE = 256;        // rows of an LSM table heap that make up one virtual page
+
+static constexpr uint32_t CLUSTERED_ROWS_PER_PAGE = 256;       // row ids of a clustered table heap on one virtual page
+static constexpr uint32_t CLUSTERED_ROW_ID_CACHE_SIZE = 4096;  // row ids a clustered table heap reserves at a time
 
 // static std::string DB_META_FILE = "minisql.meta.db";
 
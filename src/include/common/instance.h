@@ -1,11 +1,15 @@
 #ifndef MINISQL_INSTANCE_H
 #define MINISQL_INSTANCE_H
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/catalog.h"
+#include "catalog/database_vacuum.h"
 #include "common/config.h"
 #include "common/dberr.h"
 #include "common/macros.h"
@@ -14,18 +18,50 @@
 
 class DBStorageEngine {
  public:
-  explicit DBStorageEngine(std::string db_name, bool init = true, uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE);
+  /**
+   * @param page_size page size of a newly created database, an existing one keeps the size it was created with
+   */
+  explicit DBStorageEngine(std::string db_name, bool init = true, uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE,
+                           uint32_t page_size = PAGE_SIZE);
 
   ~DBStorageEngine();
 
   std::unique_ptr<ExecuteContext> MakeExecuteContext(Transaction *txn);
 
+  /**
+   * Compact the database files, see DatabaseVacuum. The buffer pool and the catalog are rebuilt, so no pointer into
+   * either may be held across the call.
+   */
+  dberr_t VacuumDatabase(VacuumStats &stats);
+
+  /**
+   * Start a background thread that wakes up every interval_ms milliseconds and vacuums each table whose heap is at
+   * least free_space_ratio free space and could give back a page. It runs between statements, see statement_latch_.
+   */
+  void StartAutoVacuum(uint32_t interval_ms, double free_space_ratio = AUTO_VACUUM_FREE_SPACE_RATIO);
+
+  /**
+   * Stop the auto vacuum thread if it runs, waiting for a vacuum in progress.
+   */
+  void StopAutoVacuum();
+
  public:
   DiskManager *disk_mgr_;
   BufferPoolManager *bpm_;
   CatalogManager *catalog_mgr_;
   std::string db_file_name_;
   bool init_;
+  // held while a statement runs against this database, the auto vacuum takes it before touching any table
+  std::recursive_mutex statement_latch_;
+
+ private:
+  void AutoVacuumLoop(uint32_t interval_ms, double free_space_ratio);
+
+ private:
+  std::thread auto_vacuum_thread_;
+  std::mutex auto_vacuum_latch_;
+  std::condition_variable auto_vacuum_cv_;
+  bool auto_vacuum_stop_{false};
 };
 
 #endif  // MINISQL_INSTANCE_H
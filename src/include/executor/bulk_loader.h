@@ -0,0 +1,94 @@
+#ifndef MINISQL_BULK_LOADER_H
+#define MINISQL_BULK_LOADER_H
+
+#include <string>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "common/dberr.h"
+#include "executor/executors/abstract_executor.h"
+
+/**
+ * BulkLoader implements `copy <table> from "<file>"`: it reads a CSV file and appends its rows to a table without
+ * going through the parser, the planner or the per-row index maintenance of the insert executor. The rows of
+ * `insert into <table> select ...` and `create table <table> as select ...` are appended the same way (see LoadRows).
+ *
+ * The file is read in large chunks and parsed with a small state machine: fields are separated by ',' and records by
+ * a newline, and a field may be quoted with '"' to hold separators, newlines or '""' for a quote. Blank lines are
+ * skipped. Parsed rows are appended to the table heap in batches that fill pages one after another. Index
+ * entries are collected while loading, sorted by key and inserted at the end, after the unique indexes were checked
+ * for duplicates. Any error rolls back the rows loaded so far and leaves the table as it was.
+ */
+class BulkLoader {
+ public:
+  BulkLoader(TableInfo *table_info, std::vector<IndexInfo *> indexes, Transaction *txn);
+
+  /**
+   * Load all rows of a CSV file into the table.
+   * @param[out] row_count number of rows loaded
+   */
+  dberr_t LoadCsv(const std::string &file_name, uint64_t &row_count);
+
+  /**
+   * Load all rows an executor produces into the table, they must have the columns of the table in their order.
+   * @param drain read every row before the first one is appended, for a source that scans the table itself
+   * @param[out] row_count number of rows loaded
+   */
+  dberr_t LoadRows(AbstractExecutor *source, bool drain, uint64_t &row_count);
+
+ private:
+  /**
+   * Turn the fields of one record into a row of the table and add it to the pending batch.
+   */
+  bool AddRecord(const std::vector<std::string> &values);
+
+  /**
+   * Check a row produced by an executor against the schema and move it into the pending batch.
+   */
+  bool AddRow(Row &row);
+
+  /**
+   * Append what is left of the batch and build the indexes, or roll back if loading failed on the way.
+   */
+  dberr_t Finish(bool success, uint64_t &row_count);
+
+  /**
+   * Append the pending batch to the table heap and collect its index keys.
+   */
+  bool FlushBatch();
+
+  /**
+   * Sort the collected keys of every index, check the unique ones and insert all entries. If an index fails to take
+   * its entries, the ones inserted so far are removed again from it and the indexes before it.
+   */
+  bool BuildIndexes();
+
+  /**
+   * Remove the collected entries of the first index_count indexes that made it into them.
+   */
+  void RemoveIndexEntries(size_t index_count);
+
+  /**
+   * Remove all rows loaded so far from the table heap.
+   */
+  void Rollback();
+
+ private:
+  static constexpr size_t CHUNK_SIZE = 1 << 20;
+  static constexpr size_t BATCH_SIZE = 4096;
+
+  TableInfo *table_info_;
+  Schema *schema_;
+  std::vector<IndexInfo *> indexes_;
+  Transaction *txn_;
+  // number of the record being parsed, for error messages
+  uint64_t line_{0};
+  bool table_was_empty_{false};
+  std::vector<Row> batch_;
+  std::vector<RowId> loaded_rids_;
+  // per index: the column positions of its key in the table, and the keys collected so far with their row ids
+  std::vector<std::vector<uint32_t>> key_columns_;
+  std::vector<std::vector<Row>> keys_;
+};
+
+#endif  // MINISQL_BULK_LOADER_H
@@ -34,6 +34,22 @@ class ExecuteContext {
   /** @return the buffer pool manager */
   BufferPoolManager *GetBufferPoolManager() { return bpm_; }
 
+  /** @return the number of worker threads a sequential scan may use */
+  uint32_t GetScanThreads() const { return scan_threads_; }
+
+  void SetScanThreads(uint32_t scan_threads) { scan_threads_ = scan_threads; }
+
+  /** @return the number of index entries written by updates, removals and insertions counted apart */
+  uint64_t GetIndexWrites() const { return index_writes_; }
+
+  /** @return the number of index entry writes updates left out because no key column changed */
+  uint64_t GetIndexWritesSaved() const { return index_writes_saved_; }
+
+  void AddIndexWrites(uint64_t writes, uint64_t saved) {
+    index_writes_ += writes;
+    index_writes_saved_ += saved;
+  }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -41,6 +57,11 @@ class ExecuteContext {
   CatalogManager *catalog_;
   /** The buffer pool manager associated with this executor context */
   BufferPoolManager *bpm_;
+  /** The number of worker threads a sequential scan may use */
+  uint32_t scan_threads_{DEFAULT_SCAN_THREADS};
+  /** Index entries written and saved by updates */
+  uint64_t index_writes_{0};
+  uint64_t index_writes_saved_{0};
 };
 
 #endif  // MINISQL_EXECUTE_CONTEXT_H
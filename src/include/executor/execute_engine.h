@@ -25,7 +25,9 @@ class ExecuteEngine {
   ExecuteEngine();
 
   ~ExecuteEngine() {
+    // the session ends, its temporary tables go with it
     for (auto it : dbs_) {
+      it.second->catalog_mgr_->DropTemporaryTables();
       delete it.second;
     }
   }
@@ -40,6 +42,11 @@ class ExecuteEngine {
 
   void ExecuteInformation(dberr_t result);
 
+  /**
+   * Let sequential scans of later statements run on the given number of threads.
+   */
+  void SetScanThreads(uint32_t scan_threads) { scan_threads_ = scan_threads; }
+
  private:
   static std::unique_ptr<AbstractExecutor> CreateExecutor(ExecuteContext *exec_ctx, const AbstractPlanNodeRef &plan);
 
@@ -55,8 +62,22 @@ class ExecuteEngine {
 
   dberr_t ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *context);
 
+  dberr_t ExecuteCreateTablespace(pSyntaxNode ast, ExecuteContext *context);
+
+  dberr_t ExecuteVacuumDatabase(pSyntaxNode ast, ExecuteContext *context);
+
+  dberr_t ExecuteVacuumTable(pSyntaxNode ast, ExecuteContext *context);
+
   dberr_t ExecuteDropTable(pSyntaxNode ast, ExecuteContext *context);
 
+  dberr_t ExecuteTruncateTable(pSyntaxNode ast, ExecuteContext *context);
+
+  dberr_t ExecuteClusterTable(pSyntaxNode ast, ExecuteContext *context);
+
+  dberr_t ExecuteAlterTable(pSyntaxNode ast, ExecuteContext *context);
+
+  dberr_t ExecuteAddColumn(TableInfo *table_info, pSyntaxNode option, ExecuteContext *context);
+
   dberr_t ExecuteShowIndexes(pSyntaxNode ast, ExecuteContext *context);
 
   dberr_t ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *context);
@@ -69,13 +90,18 @@ class ExecuteEngine {
 
   dberr_t ExecuteTrxRollback(pSyntaxNode ast, ExecuteContext *context);
 
+  dberr_t ExecuteCopy(pSyntaxNode ast, ExecuteContext *context);
+
   dberr_t ExecuteExecfile(pSyntaxNode ast, ExecuteContext *context);
 
   dberr_t ExecuteQuit(pSyntaxNode ast, ExecuteContext *context);
 
+  dberr_t ExecuteSet(pSyntaxNode ast, ExecuteContext *context);
+
  private:
   std::unordered_map<std::string, DBStorageEngine *> dbs_; /** all opened databases */
   std::string current_db_;                                 /** current database */
+  uint32_t scan_threads_{DEFAULT_SCAN_THREADS};            /** worker threads of a sequential scan */
 };
 
 #endif  // MINISQL_EXECUTE_ENGINE_H
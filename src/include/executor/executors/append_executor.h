@@ -0,0 +1,48 @@
+#ifndef MINISQL_APPEND_EXECUTOR_H
+#define MINISQL_APPEND_EXECUTOR_H
+
+#include <memory>
+#include <vector>
+
+#include "executor/execute_context.h"
+#include "executor/executors/abstract_executor.h"
+#include "executor/plans/append_plan.h"
+
+/**
+ * The AppendExecutor yields the rows of its child executors, one child after the other. A child is initialized only
+ * when the one before it has no rows left.
+ */
+class AppendExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new AppendExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The append plan to be executed
+   * @param child_executors The executors of the children of the plan, in order
+   */
+  AppendExecutor(ExecuteContext *exec_ctx, const AppendPlanNode *plan,
+                 std::vector<std::unique_ptr<AbstractExecutor>> &&child_executors);
+
+  /** Initialize the append */
+  void Init() override;
+
+  /**
+   * Yield the next row of the current child.
+   * @param[out] row The next row produced by the child
+   * @param[out] rid The next row RID produced by the child
+   * @return `true` if a row was produced, `false` if no child has rows left
+   */
+  bool Next(Row *row, RowId *rid) override;
+
+  /** @return The output schema for the append */
+  const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
+
+ private:
+  /** The append plan node to be executed */
+  const AppendPlanNode *plan_;
+  std::vector<std::unique_ptr<AbstractExecutor>> child_executors_;
+  /** The child whose rows come next */
+  size_t cursor_{0};
+};
+
+#endif  // MINISQL_APPEND_EXECUTOR_H
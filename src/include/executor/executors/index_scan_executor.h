@@ -43,5 +43,7 @@ class IndexScanExecutor : public AbstractExecutor {
   vector<RowId> results_;
   int time_;
   void GetResult(ComparisonExpression *cmp_child, vector<RowId> &results);
+  /** Read the row of a result, with the columns of the output schema. */
+  void ReadRow(const RowId &result, Row *row, RowId *rid);
   vector<RowId> intersection(const vector<RowId> &a, const vector<RowId> &b);
 };
\ No newline at end of file
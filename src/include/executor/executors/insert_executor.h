@@ -12,7 +12,8 @@
 /**
  * InsertExecutor executes an insert on a table.
  *
- * Inserted values are always pulled from a child executor.
+ * Inserted values are always pulled from a child executor. The rows of a select are appended in bulk (see BulkLoader),
+ * all of them or none.
  */
 class InsertExecutor : public AbstractExecutor {
  public:
@@ -45,6 +46,7 @@ class InsertExecutor : public AbstractExecutor {
   /** The insert plan node to be executed*/
   const InsertPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> child_executor_;
+  TableInfo *table_info_;
   TableHeap *table_heap_;
   TableIterator iter_;
   vector<IndexInfo *> index_info_;
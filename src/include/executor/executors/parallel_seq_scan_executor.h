@@ -0,0 +1,78 @@
+#ifndef MINISQL_PARALLEL_SEQ_SCAN_EXECUTOR_H
+#define MINISQL_PARALLEL_SEQ_SCAN_EXECUTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "executor/execute_context.h"
+#include "executor/executors/abstract_executor.h"
+#include "executor/plans/seq_scan_plan.h"
+
+/**
+ * ParallelSeqScanExecutor runs a sequential scan on several threads. The page directory of the table heap is cut
+ * into morsels of SCAN_MORSEL_PAGES pages, and every worker claims the next unscanned morsel until none is left,
+ * filtering and projecting its rows on the way and skipping the pages the zone map rules out. The workers start in
+ * Init and run in the background, Next hands out the output of each morsel as soon as that morsel is done. Morsels
+ * are handed out in their order, so the rows come out in the same order as from a serial scan.
+ */
+class ParallelSeqScanExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new ParallelSeqScanExecutor instance.
+   * @param exec_ctx The executor context, it tells the number of threads to use
+   * @param plan The sequential scan plan to be executed
+   */
+  ParallelSeqScanExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode *plan);
+
+  /** Stop the workers that are still scanning */
+  ~ParallelSeqScanExecutor() override;
+
+  /** Start the workers on the whole table */
+  void Init() override;
+
+  /**
+   * Yield the next row of the scan.
+   * @param[out] row The next row produced by the scan
+   * @param[out] rid The next row RID produced by the scan
+   * @return `true` if a row was produced, `false` if there are no more rows
+   */
+  bool Next(Row *row, RowId *rid) override;
+
+  /** @return The output schema for the sequential scan */
+  const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
+
+ private:
+  /** Claim and scan morsels until all are taken, run by every worker */
+  void ScanMorsels();
+
+  /** Make the workers give up at their next morsel and wait for them */
+  void StopWorkers();
+
+  /** The sequential scan plan node to be executed */
+  const SeqScanPlanNode *plan_;
+  TableInfo *table_{nullptr};
+  /** Page directory of the table taken at Init */
+  std::vector<page_id_t> page_ids_;
+  /** Position in the table schema of every output column */
+  std::vector<uint32_t> column_indexes_;
+  /** The table columns read for the output or the predicate, see SeqScanPlanNode::GetColumnMask */
+  std::vector<bool> column_mask_;
+  /** Zone map of the table to skip pages with, only for a scan with a predicate */
+  const ZoneMap *zone_map_{nullptr};
+  std::atomic<size_t> next_morsel_{0};
+  std::atomic<bool> stopped_{false};
+  std::vector<std::thread> workers_;
+  /** Output rows of every morsel, filled in by the worker that scanned it */
+  std::vector<std::vector<Row>> results_;
+  /** Whether each morsel is done, guarded by results_latch_ */
+  std::vector<bool> done_;
+  std::mutex results_latch_;
+  std::condition_variable morsel_done_;
+  size_t morsel_pos_{0};
+  size_t row_pos_{0};
+};
+
+#endif  // MINISQL_PARALLEL_SEQ_SCAN_EXECUTOR_H
@@ -5,14 +5,22 @@
 #ifndef MINISQL_SEQ_SCAN_EXECUTOR_H
 #define MINISQL_SEQ_SCAN_EXECUTOR_H
 
+#include <memory>
 #include <vector>
 
 #include "executor/execute_context.h"
 #include "executor/executors/abstract_executor.h"
 #include "executor/plans/seq_scan_plan.h"
+#include "storage/column_scan.h"
 
 /**
- * The SeqScanExecutor executor executes a sequential table scan.
+ * The SeqScanExecutor executor executes a sequential table scan. It reads the heap a page at a time along the page
+ * directory taken at Init, and skips the pages whose zone map rules out the predicate without reading them. A plan
+ * with a predicate on codes reads the codes of the dictionary encoded columns and only decodes those of the output.
+ * On a heap stored by column, a predicate that only ands comparisons of int and float columns with constants is
+ * checked a page at a time by a ColumnScan, and only the rows it selects are returned. A clustered heap is read in
+ * primary key order from its primary tree, and comparisons of the primary key with constants narrow down the keys read:
+ * equality on every key column looks up one row, bounds on a single key column read a range.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -37,12 +45,63 @@ class SeqScanExecutor : public AbstractExecutor {
   /** @return The output schema for the sequential scan */
   const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
 
+  /** @return the number of pages the zone map let the scan skip */
+  size_t GetPagesSkipped() const { return pages_skipped_; }
+
+  /** @return true if the predicate is checked by a column scan instead of row by row */
+  bool UsesColumnScan() const { return column_scan_ != nullptr; }
+
  private:
+  /** @return the value of the code of an encoded column */
+  std::unique_ptr<Field> DecodeField(uint32_t column_index, const Field *code) const;
+
+  /**
+   * Add the comparisons of the predicate to the scan as filters.
+   * @return false if the predicate is not an and of comparisons the scan can filter by
+   */
+  static bool AddColumnFilters(AbstractExpression *expression, ColumnScan &scan);
+
+  /**
+   * Set the primary key range of a scan of a clustered heap from the comparisons the predicate ands.
+   */
+  void SetKeyRange(AbstractExpression *predicate);
+
+  /**
+   * Read the next rows of a clustered heap in key order into rows_.
+   * @return false if the key range is read
+   */
+  bool ReadKeyBatch();
+
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
   TableInfo *table_;
   TableHeap *heap_;
-  TableIterator iter_;
+  /** Page directory of the table taken at Init */
+  std::vector<page_id_t> page_ids_;
+  size_t page_pos_{0};
+  /** The table columns read for the output or the predicate */
+  std::vector<bool> column_mask_;
+  /** Zone map of the table, only for a scan with a predicate */
+  const ZoneMap *zone_map_{nullptr};
+  /** The table schema without dictionaries the rows are read with, only for a plan with a predicate on codes */
+  std::unique_ptr<Schema> code_schema_;
+  /** The predicate as filters over the column pages, nullptr to evaluate it row by row */
+  std::unique_ptr<ColumnScan> column_scan_;
+  /** The slots of the current page that pass the filters of column_scan_, a bit per slot */
+  std::vector<uint64_t> selection_;
+  /** The primary keys a scan of a clustered heap reads from and up to, nullptr for an open side */
+  std::unique_ptr<Row> key_low_;
+  std::unique_ptr<Row> key_high_;
+  /** The scan looks up the single key key_low_ */
+  bool key_point_{false};
+  /** The scan goes on behind key_low_, the last key of the batch before */
+  bool key_after_{false};
+  bool key_done_{false};
+  /** Rows of the current page, only the first row_count_ belong to it */
+  std::vector<Row> rows_;
+  size_t row_count_{0};
+  size_t row_pos_{0};
+  size_t pages_skipped_{0};
 };
 
 #endif  // MINISQL_SEQ_SCAN_EXECUTOR_H
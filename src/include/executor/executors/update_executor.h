@@ -5,6 +5,8 @@
 #ifndef MINISQL_UPDATE_EXECUTOR_H
 #define MINISQL_UPDATE_EXECUTOR_H
 
+#include <unordered_set>
+
 #include "executor/execute_context.h"
 #include "executor/executors/abstract_executor.h"
 #include "executor/plans/update_plan.h"
@@ -59,6 +61,8 @@ class UpdateExecutor : public AbstractExecutor {
   std::unique_ptr<AbstractExecutor> child_executor_;
   TableInfo *table_;
   TableHeap *heap_;
+  /** The rows updated so far, which the child may return again after they moved */
+  std::unordered_set<int64_t> updated_rids_;
 };
 
 #endif  // MINISQL_UPDATE_EXECUTOR_H
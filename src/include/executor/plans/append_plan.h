@@ -0,0 +1,25 @@
+#ifndef MINISQL_APPEND_PLAN_H
+#define MINISQL_APPEND_PLAN_H
+
+#include "abstract_plan.h"
+
+/**
+ * The AppendPlanNode runs its children one after the other and passes their rows on, it puts together the plans of
+ * the partitions of a partitioned table. A select has the output schema of its scans, a statement that changes rows
+ * has none.
+ */
+class AppendPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new AppendPlanNode.
+   * @param output The output schema of the children, nullptr if they do not produce rows
+   * @param children The plans to run, in order
+   */
+  AppendPlanNode(const Schema *output, std::vector<AbstractPlanNodeRef> children)
+      : AbstractPlanNode(output, std::move(children)) {}
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::Append; }
+};
+
+#endif  // MINISQL_APPEND_PLAN_H
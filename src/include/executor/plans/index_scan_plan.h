@@ -42,6 +42,9 @@ class IndexScanPlanNode : public AbstractPlanNode {
   /** Whether there are indexes on all columns in the predicate*/
   bool need_filter_ = true;
 
+  /** Whether the rows are read in the order of the heap instead of the order of the keys */
+  bool heap_order_ = false;
+
   /** The predicate to filter in IndexScan.*/
   AbstractExpressionRef filter_predicate_;
 };
\ No newline at end of file
@@ -8,6 +8,11 @@
 #include "abstract_plan.h"
 #include "catalog/catalog.h"
 #include "planner/expressions/abstract_expression.h"
+#include "planner/expressions/column_value_expression.h"
+#include "planner/expressions/comparison_expression.h"
+#include "planner/expressions/constant_value_expression.h"
+#include "planner/expressions/logic_expression.h"
+#include "storage/zone_map.h"
 
 class SeqScanPlanNode : public AbstractPlanNode {
  public:
@@ -29,11 +34,207 @@ class SeqScanPlanNode : public AbstractPlanNode {
 
   AbstractExpressionRef GetPredicate() const { return filter_predicate_; }
 
+  /**
+   * @return for every column of the table whether the scan reads it, for the output or for the predicate
+   */
+  std::vector<bool> GetColumnMask(const Schema *table_schema) const {
+    std::vector<bool> columns(table_schema->GetColumnCount(), false);
+    for (auto column : OutputSchema()->GetColumns()) {
+      uint32_t column_index;
+      if (table_schema->GetColumnIndex(column->GetName(), column_index) == DB_SUCCESS) {
+        columns[column_index] = true;
+      }
+    }
+    std::vector<AbstractExpression *> expressions;
+    if (filter_predicate_ != nullptr) {
+      expressions.push_back(filter_predicate_.get());
+    }
+    while (!expressions.empty()) {
+      AbstractExpression *expression = expressions.back();
+      expressions.pop_back();
+      if (expression->GetType() == ExpressionType::ColumnExpression) {
+        columns[static_cast<ColumnValueExpression *>(expression)->GetColIdx()] = true;
+      }
+      for (auto &child : expression->GetChildren()) {
+        expressions.push_back(child.get());
+      }
+    }
+    return columns;
+  }
+
+  /**
+   * @return false if the zone map of the table rules out the predicate for every row of the page, comparisons of a
+   * column with a constant are checked and everything else may match
+   */
+  bool MayMatch(const ZoneMap &zone_map, page_id_t page_id) const {
+    return filter_predicate_ == nullptr ||
+           MayMatch(filter_predicate_.get(), [&](uint32_t column_index, CompareOp op, const Field &constant) {
+             return zone_map.MayMatch(page_id, column_index, op, constant);
+           });
+  }
+
+  /**
+   * Walk a predicate and ask the check whether a comparison of a column with a constant may be true, the check is
+   * called as check(column_index, op, constant). And and or combine the answers, everything else may match.
+   * @return false if the predicate is false for every row the check rules out
+   */
+  template <typename Check>
+  static bool MayMatch(AbstractExpression *expression, const Check &check) {
+    if (expression->GetType() == ExpressionType::LogicExpression) {
+      bool left = MayMatch(expression->GetChildAt(0).get(), check);
+      bool right = MayMatch(expression->GetChildAt(1).get(), check);
+      return static_cast<LogicExpression *>(expression)->logic_type_ == LogicType::And ? left && right
+                                                                                         : left || right;
+    }
+    uint32_t column_index;
+    CompareOp op;
+    const Field *constant;
+    if (!GetComparison(expression, column_index, op, constant)) {
+      return true;
+    }
+    return check(column_index, op, *constant);
+  }
+
+  /**
+   * Read a comparison of a column with a constant, either way round.
+   * @return false if the expression is no such comparison, or compares by is null or not null
+   */
+  static bool GetComparison(AbstractExpression *expression, uint32_t &column_index, CompareOp &op,
+                            const Field *&constant) {
+    if (expression->GetType() != ExpressionType::ComparisonExpression) {
+      return false;
+    }
+    AbstractExpression *column = expression->GetChildAt(0).get();
+    AbstractExpression *value = expression->GetChildAt(1).get();
+    std::string comp_type = static_cast<ComparisonExpression *>(expression)->GetComparisonType();
+    // a constant on the left compares the other way round
+    if (column->GetType() == ExpressionType::ConstantExpression) {
+      std::swap(column, value);
+      if (comp_type[0] == '<' && comp_type != "<>") {
+        comp_type[0] = '>';
+      } else if (comp_type[0] == '>') {
+        comp_type[0] = '<';
+      }
+    }
+    if (column->GetType() != ExpressionType::ColumnExpression ||
+        value->GetType() != ExpressionType::ConstantExpression) {
+      return false;
+    }
+    if (comp_type == "=") {
+      op = CompareOp::kEqual;
+    } else if (comp_type == "<>") {
+      op = CompareOp::kNotEqual;
+    } else if (comp_type == "<") {
+      op = CompareOp::kLessThan;
+    } else if (comp_type == "<=") {
+      op = CompareOp::kLessThanEquals;
+    } else if (comp_type == ">") {
+      op = CompareOp::kGreaterThan;
+    } else if (comp_type == ">=") {
+      op = CompareOp::kGreaterThanEquals;
+    } else {
+      // is null and not null
+      return false;
+    }
+    column_index = static_cast<ColumnValueExpression *>(column)->GetColIdx();
+    constant = &static_cast<ConstantValueExpression *>(value)->val_;
+    return true;
+  }
+
+  /**
+   * Rewrite a predicate for a scan that reads the codes of the dictionary encoded columns, see TableHeap::ReadPage:
+   * an encoded column compared with a constant by = or <> compares its code with the code of the constant instead,
+   * a constant the dictionary does not know gets a code no value has.
+   * @return the rewritten predicate, nullptr if no encoded column is compared that way or one is used in another way
+   */
+  static AbstractExpressionRef EncodePredicate(const AbstractExpressionRef &predicate, const Schema *table_schema) {
+    AbstractExpressionRef encoded;
+    bool rewritten = false;
+    if (predicate == nullptr || !EncodePredicate(predicate, table_schema, encoded, rewritten) || !rewritten) {
+      return nullptr;
+    }
+    return encoded;
+  }
+
   /** The table name */
   std::string table_name_;
 
   /** The predicate to filter in SeqScan.*/
   AbstractExpressionRef filter_predicate_;
+
+  /** The predicate on the codes of the encoded columns, see EncodePredicate, nullptr to scan the values */
+  AbstractExpressionRef code_predicate_;
+
+ private:
+  static bool IsEncodedColumn(AbstractExpression *expression, const Schema *table_schema) {
+    return expression->GetType() == ExpressionType::ColumnExpression &&
+           table_schema->GetColumn(static_cast<ColumnValueExpression *>(expression)->GetColIdx())
+               ->IsDictionaryEncoded();
+  }
+
+  static bool UsesEncodedColumn(AbstractExpression *expression, const Schema *table_schema) {
+    if (IsEncodedColumn(expression, table_schema)) {
+      return true;
+    }
+    for (auto &child : expression->GetChildren()) {
+      if (UsesEncodedColumn(child.get(), table_schema)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static bool EncodePredicate(const AbstractExpressionRef &expression, const Schema *table_schema,
+                              AbstractExpressionRef &encoded, bool &rewritten) {
+    if (expression->GetType() == ExpressionType::LogicExpression) {
+      AbstractExpressionRef left, right;
+      if (!EncodePredicate(expression->GetChildAt(0), table_schema, left, rewritten) ||
+          !EncodePredicate(expression->GetChildAt(1), table_schema, right, rewritten)) {
+        return false;
+      }
+      encoded = std::make_shared<LogicExpression>(left, right,
+                                                  static_cast<LogicExpression *>(expression.get())->logic_type_);
+      return true;
+    }
+    if (expression->GetType() != ExpressionType::ComparisonExpression) {
+      encoded = expression;
+      return !UsesEncodedColumn(expression.get(), table_schema);
+    }
+    auto comparison = static_cast<ComparisonExpression *>(expression.get());
+    std::string comp_type = comparison->GetComparisonType();
+    const AbstractExpressionRef &left = expression->GetChildAt(0);
+    const AbstractExpressionRef &right = expression->GetChildAt(1);
+    bool left_encoded = IsEncodedColumn(left.get(), table_schema);
+    bool right_encoded = IsEncodedColumn(right.get(), table_schema);
+    if (!left_encoded && !right_encoded) {
+      encoded = expression;
+      return !UsesEncodedColumn(expression.get(), table_schema);
+    }
+    // a null code reads as a null field
+    if (comp_type == "is" || comp_type == "not") {
+      encoded = expression;
+      return true;
+    }
+    const AbstractExpressionRef &constant = left_encoded ? right : left;
+    if ((comp_type != "=" && comp_type != "<>") || constant->GetType() != ExpressionType::ConstantExpression) {
+      return false;
+    }
+    const Field &value = static_cast<ConstantValueExpression *>(constant.get())->val_;
+    const AbstractExpressionRef &column = left_encoded ? left : right;
+    Dictionary *dictionary =
+        table_schema->GetColumn(static_cast<ColumnValueExpression *>(column.get())->GetColIdx())->GetDictionary();
+    // no value has a negative code
+    int32_t code = -1;
+    if (dictionary != nullptr) {
+      dictionary->Lookup(value, code);
+    }
+    auto code_constant = std::make_shared<ConstantValueExpression>(
+        value.IsNull() ? Field(TypeId::kTypeInt) : Field(TypeId::kTypeInt, code));
+    encoded = left_encoded ? std::make_shared<ComparisonExpression>(column, code_constant, comp_type)
+                           : std::make_shared<ComparisonExpression>(code_constant, column, comp_type);
+    rewritten = true;
+    return true;
+  }
 };
 
 #endif  // MINISQL_SEQ_SCAN_PLAN_H
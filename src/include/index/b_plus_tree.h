@@ -1,6 +1,7 @@
 #ifndef MINISQL_B_PLUS_TREE_H
 #define MINISQL_B_PLUS_TREE_H
 
+#include <fstream>
 #include <queue>
 #include <string>
 #include <vector>
@@ -9,6 +10,7 @@
 #include "page/b_plus_tree_internal_page.h"
 #include "page/b_plus_tree_leaf_page.h"
 #include "page/b_plus_tree_page.h"
+#include "storage/page_reclaimer.h"
 #include "transaction/transaction.h"
 
 /**
@@ -27,14 +29,39 @@ class BPlusTree {
 
  public:
   explicit BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager, const KeyManager &comparator,
-                     int leaf_max_size = UNDEFINED_SIZE, int internal_max_size = UNDEFINED_SIZE);
+                     int leaf_max_size = UNDEFINED_SIZE, int internal_max_size = UNDEFINED_SIZE,
+                     uint32_t space_id = DEFAULT_TABLESPACE_ID, int internal_key_size = UNDEFINED_SIZE);
 
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
 
+  // Returns the number of levels of this B+ tree, 0 if it is empty.
+  int GetDepth();
+
   // Insert a key-value pair into this B+ tree.
   bool Insert(GenericKey *key, const RowId &value, Transaction *transaction = nullptr);
 
+  // Replace the value of a key in its leaf, returns false if the key does not map to old_value.
+  bool UpdateValue(const GenericKey *key, const RowId &old_value, const RowId &new_value,
+                   Transaction *transaction = nullptr);
+
+  // Copy the whole key stored for an equal key into result, for keys that carry bytes behind the ones compared.
+  bool GetKey(const GenericKey *key, GenericKey *result, Transaction *transaction = nullptr);
+
+  // Overwrite the key stored for an equal key with the given one, returns false if there is none.
+  bool ReplaceKey(GenericKey *key, Transaction *transaction = nullptr);
+
+  // Build an empty B+ tree bottom up from pairs in ascending key order, returns false if the tree is not empty.
+  bool BulkLoad(const std::vector<GenericKey *> &keys, const std::vector<RowId> &values,
+                Transaction *transaction = nullptr);
+
+  // Build a B+ tree bottom up from pairs in ascending key order next to this one, which is left as it is. Returns the
+  // root page id of the new tree, INVALID_PAGE_ID if its pages could not be allocated.
+  page_id_t BuildTree(const std::vector<GenericKey *> &keys, const std::vector<RowId> &values);
+
+  // Make the tree of BuildTree this B+ tree, the pages of the old one go to the reclaimer.
+  void ReplaceTree(page_id_t root_page_id, PageReclaimer *reclaimer);
+
   // Remove a key and its value from this B+ tree.
   void Remove(const GenericKey *key, Transaction *transaction = nullptr);
 
@@ -56,13 +83,20 @@ class BPlusTree {
   // destroy the b plus tree
   void Destroy(page_id_t current_page_id = INVALID_PAGE_ID);
 
+  // Hand the pages of this B+ tree to the reclaimer to be freed in the background. The tree is left with a blank root
+  // like a new one if new_root is set, and with no root at all otherwise. Returns false if no root could be allocated.
+  bool Detach(PageReclaimer *reclaimer, bool new_root);
+
+  // Free all pages of the tree below and including the given page, without looking at the index roots page.
+  static void FreeTree(BufferPoolManager *buffer_pool_manager, page_id_t root_page_id);
+
   void PrintTree(std::ofstream &out) {
     if (IsEmpty()) {
       return;
     }
     out << "digraph G {" << std::endl;
     Page *root_page = buffer_pool_manager_->FetchPage(root_page_id_);
-    auto *node = reinterpret_cast<BPlusTreePage *>(root_page);
+    auto *node = reinterpret_cast<BPlusTreePage *>(root_page->GetData());
     ToGraph(node, buffer_pool_manager_, out);
     out << "}" << std::endl;
   }
@@ -108,6 +142,10 @@ class BPlusTree {
   KeyManager processor_;
   int leaf_max_size_;
   int internal_max_size_;
+  // tablespace all pages of this tree are allocated in
+  uint32_t space_id_;
+  // bytes of a key internal pages keep, the fields the key manager compares have to be among them
+  int internal_key_size_;
 };
 
 #endif  // MINISQL_B_PLUS_TREE_H
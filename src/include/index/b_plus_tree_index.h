@@ -7,16 +7,35 @@
 
 class BPlusTreeIndex : public Index {
  public:
-  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size, BufferPoolManager *buffer_pool_manager);
+  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size, BufferPoolManager *buffer_pool_manager,
+                 uint32_t space_id = DEFAULT_TABLESPACE_ID);
 
   dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
 
+  dberr_t InsertSortedEntries(const std::vector<const Row *> &keys, Transaction *txn) override;
+
   dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) override;
 
+  dberr_t UpdateEntry(const Row &key, RowId old_row_id, RowId new_row_id, Transaction *txn) override;
+
   dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn, string compare_operator = "=") override;
 
   dberr_t Destroy() override;
 
+  dberr_t Destroy(PageReclaimer *reclaimer) override;
+
+  dberr_t Truncate(PageReclaimer *reclaimer) override;
+
+  /**
+   * Build a tree of the keys, in ascending order and with their row ids, next to the tree of the index, which is left
+   * as it is until ReplaceTree. The new tree is freed with BPlusTree::FreeTree if it is not used.
+   * @param[out] root_page_id the root of the new tree
+   */
+  dberr_t BuildSortedTree(const std::vector<const Row *> &keys, page_id_t &root_page_id);
+
+  /** Make the tree of BuildSortedTree the tree of the index, the old tree goes to the reclaimer. */
+  void ReplaceTree(page_id_t root_page_id, PageReclaimer *reclaimer);
+
   IndexIterator GetBeginIterator();
 
   IndexIterator GetBeginIterator(GenericKey *key);
@@ -24,6 +43,10 @@ class BPlusTreeIndex : public Index {
   IndexIterator GetEndIterator();
 
  protected:
+  /** Serialize keys into one buffer, the index keys point into it. */
+  void SerializeSortedKeys(const std::vector<const Row *> &keys, std::unique_ptr<char[]> &key_buf,
+                           std::vector<GenericKey *> &index_keys, std::vector<RowId> &row_ids);
+
   // comparator for key
   KeyManager processor_;
   // container
@@ -2,9 +2,11 @@
 #define MINISQL_INDEX_H
 
 #include <memory>
+#include <string>
 
 #include "common/dberr.h"
 #include "record/row.h"
+#include "storage/page_reclaimer.h"
 #include "transaction/transaction.h"
 
 class Index {
@@ -15,13 +17,46 @@ class Index {
 
   virtual dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) = 0;
 
+  /**
+   * Insert entries whose keys are unique, in ascending order and not in the index yet, the row id of each entry is
+   * the one of its key row. Indexes that build faster from sorted input override this.
+   */
+  virtual dberr_t InsertSortedEntries(const std::vector<const Row *> &keys, Transaction *txn) {
+    for (auto key : keys) {
+      if (InsertEntry(*key, key->GetRowId(), txn) != DB_SUCCESS) {
+        return DB_FAILED;
+      }
+    }
+    return DB_SUCCESS;
+  }
+
   virtual dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) = 0;
 
+  /**
+   * Point the entry of a key at the new place of its row. Indexes that can change a row id in place override this.
+   */
+  virtual dberr_t UpdateEntry(const Row &key, RowId old_row_id, RowId new_row_id, Transaction *txn) {
+    if (RemoveEntry(key, old_row_id, txn) != DB_SUCCESS) {
+      return DB_FAILED;
+    }
+    return InsertEntry(key, new_row_id, txn);
+  }
+
   virtual dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn,
-                          string compare_operator = "=") = 0;
+                          std::string compare_operator = "=") = 0;
 
   virtual dberr_t Destroy() = 0;
 
+  /**
+   * Destroy the index, its pages are handed to the reclaimer instead of being freed here.
+   */
+  virtual dberr_t Destroy(PageReclaimer *reclaimer) = 0;
+
+  /**
+   * Remove all entries at once, the pages that held them are handed to the reclaimer instead of being freed here.
+   */
+  virtual dberr_t Truncate(PageReclaimer *reclaimer) = 0;
+
  protected:
   index_id_t index_id_;
   IndexSchema *key_schema_;
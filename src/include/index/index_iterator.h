@@ -27,6 +27,9 @@ class IndexIterator {
   bool operator!=(const IndexIterator &itr) const;
 
  private:
+  // Step onto the first pair of another leaf.
+  void MoveToPage(page_id_t page_id);
+
   page_id_t current_page_id{INVALID_PAGE_ID};
   LeafPage *page{nullptr};
   int item_index{0};
@@ -0,0 +1,65 @@
+#ifndef MINISQL_LSM_INDEX_H
+#define MINISQL_LSM_INDEX_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "buffer/buffer_pool_manager.h"
+#include "index/index.h"
+#include "storage/lsm_tree.h"
+
+/**
+ * An index of a table stored in an LSM tree (see TableStorage::kLsm), kept in an LSM tree of its own so that inserts
+ * into the table never update a B+ tree in place. The key fields are encoded into a byte string whose memcmp order is
+ * the order of the fields, the value is the row id. The manifest of the tree is registered in the index roots page
+ * under the index id, the same as the root of a B+ tree. Keys are unique: an insert looks the key up first, which
+ * the bloom filters of the runs keep cheap for new keys.
+ */
+class LsmIndex : public Index {
+ public:
+  /**
+   * Open the tree registered for the index, or create and register one for a new index.
+   */
+  LsmIndex(index_id_t index_id, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager,
+           uint32_t space_id = DEFAULT_TABLESPACE_ID);
+
+  dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  dberr_t UpdateEntry(const Row &key, RowId old_row_id, RowId new_row_id, Transaction *txn) override;
+
+  dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn,
+                  std::string compare_operator = "=") override;
+
+  dberr_t Destroy() override;
+
+  dberr_t Destroy(PageReclaimer *reclaimer) override;
+
+  dberr_t Truncate(PageReclaimer *reclaimer) override;
+
+  inline LsmTree *GetTree() { return tree_.get(); }
+
+  /**
+   * @return the key fields as a byte string ordered like the fields: a null flag per field, then an int or a float
+   * in big-endian order with its sign fixed up, or the bytes of a char value with 0x00 escaped and ending in 0x00 0x00
+   */
+  static std::string EncodeKey(const Row &key);
+
+ private:
+  static std::string EncodeRowId(const RowId &row_id);
+
+  static RowId DecodeRowId(const std::string &value);
+
+  /** Drop the entry of the index from the index roots page. */
+  void Unregister();
+
+ private:
+  BufferPoolManager *buffer_pool_manager_;
+  std::unique_ptr<LsmTree> tree_;
+  // makes the lookup and the write of an insert one step
+  std::mutex insert_latch_;
+};
+
+#endif  // MINISQL_LSM_INDEX_H
@@ -0,0 +1,65 @@
+#ifndef MINISQL_MEMORY_INDEX_H
+#define MINISQL_MEMORY_INDEX_H
+
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "index/index.h"
+
+/**
+ * An index of a table stored in memory. Its entries live in a std::map ordered by the key fields, or in a hash table
+ * keyed by the serialized key fields for point lookups only, and take no pages. A hash index answers the other
+ * operators of ScanKey with a pass over all of its entries. Keys are unique, the same as in a B+ tree index.
+ */
+class MemoryIndex : public Index {
+ public:
+  enum class Kind { kOrdered, kHash };
+
+  MemoryIndex(index_id_t index_id, IndexSchema *key_schema, Kind kind);
+
+  dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  dberr_t UpdateEntry(const Row &key, RowId old_row_id, RowId new_row_id, Transaction *txn) override;
+
+  dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn,
+                  std::string compare_operator = "=") override;
+
+  dberr_t Destroy() override;
+
+  dberr_t Destroy(PageReclaimer *reclaimer) override;
+
+  dberr_t Truncate(PageReclaimer *reclaimer) override;
+
+  inline Kind GetKind() const { return kind_; }
+
+ private:
+  struct KeyLess {
+    bool operator()(const Row &a, const Row &b) const;
+  };
+
+  struct HashEntry {
+    Row key_;
+    RowId row_id_;
+  };
+
+  /** @return the serialized key fields, the key of the hash table */
+  std::string HashKey(const Row &key) const;
+
+  /** @return a copy of the key fields that the entry keeps */
+  static Row CopyKey(const Row &key);
+
+  /** @return true if the fields of row compare true against the fields of key with the operator */
+  static bool Matches(const Row &row, const Row &key, const std::string &compare_operator);
+
+ private:
+  Kind kind_;
+  std::map<Row, RowId, KeyLess> ordered_;
+  std::unordered_map<std::string, HashEntry> hashed_;
+  std::shared_mutex latch_;
+};
+
+#endif  // MINISQL_MEMORY_INDEX_H
@@ -9,7 +9,8 @@
 #include "page/b_plus_tree_page.h"
 
 #define INTERNAL_PAGE_HEADER_SIZE 28
-#define INTERNAL_PAGE_SIZE ((PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (processor_.GetKeySize() + sizeof(page_id_t)) - 1)
+#define INTERNAL_PAGE_SIZE(page_size, key_size) \
+  (((page_size) - INTERNAL_PAGE_HEADER_SIZE) / ((key_size) + sizeof(page_id_t)) - 1)
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
@@ -71,7 +72,7 @@ class BPlusTreeInternalPage : public BPlusTreePage {
 
   void CopyFirstFrom(page_id_t value, BufferPoolManager *buffer_pool_manager);
 
-  char data_[PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE];
+  char data_[0];  // spans the rest of the page, whose size is chosen per database
 };
 
 using InternalPage = BPlusTreeInternalPage;
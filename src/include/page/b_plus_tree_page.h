@@ -31,6 +31,8 @@ class BPlusTreePage {
 
   bool IsRootPage() const;
 
+  IndexPageType GetPageType() const;
+
   void SetPageType(IndexPageType page_type);
 
   int GetKeySize() const;
@@ -0,0 +1,63 @@
+#ifndef MINISQL_CLUSTERED_META_PAGE_H
+#define MINISQL_CLUSTERED_META_PAGE_H
+
+/**
+ * The first page of a table heap stored in a clustered table (see ClusteredHeap). It names the trees of the table by
+ * their index ids, lists the primary key columns and records how far row ids are reserved, so the table opens again
+ * without its catalog entry knowing any of it.
+ *
+ *  Format (size in byte):
+ *  --------------------------------------------------------------------------------------------------------
+ *  | PageId (4) | LSN (4) | PrimaryIndexId (4) | RowIdIndexId (4) | ReservedRowIds (8) | KeyCount (4) | ...
+ *  --------------------------------------------------------------------------------------------------------
+ *  | KeyColumn_1 (4) | KeyColumn_2 (4) | ... |
+ *  -----------------------------------------
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "page/page.h"
+
+class ClusteredMetaPage : public Page {
+ public:
+  void Init(page_id_t page_id, index_id_t primary_index_id, index_id_t row_id_index_id,
+            const std::vector<uint32_t> &key_map) {
+    memcpy(GetData(), &page_id, sizeof(page_id));
+    memcpy(GetData() + OFFSET_PRIMARY_INDEX_ID, &primary_index_id, sizeof(index_id_t));
+    memcpy(GetData() + OFFSET_ROW_ID_INDEX_ID, &row_id_index_id, sizeof(index_id_t));
+    SetReservedRowIds(0);
+    uint32_t key_count = key_map.size();
+    memcpy(GetData() + OFFSET_KEY_COUNT, &key_count, sizeof(uint32_t));
+    memcpy(GetData() + SIZE_HEADER, key_map.data(), key_count * sizeof(uint32_t));
+  }
+
+  page_id_t GetMetaPageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  index_id_t GetPrimaryIndexId() { return *reinterpret_cast<index_id_t *>(GetData() + OFFSET_PRIMARY_INDEX_ID); }
+
+  index_id_t GetRowIdIndexId() { return *reinterpret_cast<index_id_t *>(GetData() + OFFSET_ROW_ID_INDEX_ID); }
+
+  /** @return the row ids below this one may have been handed out */
+  uint64_t GetReservedRowIds() { return *reinterpret_cast<uint64_t *>(GetData() + OFFSET_RESERVED_ROW_IDS); }
+
+  void SetReservedRowIds(uint64_t reserved) {
+    memcpy(GetData() + OFFSET_RESERVED_ROW_IDS, &reserved, sizeof(uint64_t));
+  }
+
+  std::vector<uint32_t> GetKeyMap() {
+    uint32_t key_count = *reinterpret_cast<uint32_t *>(GetData() + OFFSET_KEY_COUNT);
+    std::vector<uint32_t> key_map(key_count);
+    memcpy(key_map.data(), GetData() + SIZE_HEADER, key_count * sizeof(uint32_t));
+    return key_map;
+  }
+
+ private:
+  static constexpr size_t OFFSET_PRIMARY_INDEX_ID = 8;
+  static constexpr size_t OFFSET_ROW_ID_INDEX_ID = 12;
+  static constexpr size_t OFFSET_RESERVED_ROW_IDS = 16;
+  static constexpr size_t OFFSET_KEY_COUNT = 24;
+  static constexpr size_t SIZE_HEADER = 28;
+};
+
+#endif  // MINISQL_CLUSTERED_META_PAGE_H
@@ -0,0 +1,182 @@
+#ifndef MINISQL_COLUMN_PAGE_H
+#define MINISQL_COLUMN_PAGE_H
+
+/**
+ * PAX page format: a column page holds up to Capacity rows of a table, each column of them in a minipage of its own.
+ * A minipage is a null bitmap followed by the values of the column in slot order, every value in a cell of fixed
+ * width: 4 bytes for int and float, a 4 byte length and the column length for char. A scan of one column only reads
+ * its minipage, and int and float minipages are plain arrays the scan kernels (see ColumnKernels) work on directly.
+ *
+ *  Format (size in byte):
+ *  ---------------------------------------------------------------------------------------------
+ *  | PageId (4) | LSN (4) | PrevPageId (4) | NextPageId (4) | TupleCount (4) | Reserved (4) |
+ *  ---------------------------------------------------------------------------------------------
+ *  | Used bitmap | Deleted bitmap | Null bitmap_1 | Values_1 | ... | Null bitmap_N | Values_N |
+ *  ---------------------------------------------------------------------------------------------
+ *
+ * The header up to NextPageId is laid out as in TablePage, so the chain of a heap can be walked with either page.
+ * A slot holds a tuple while its bit in the used bitmap is set, the deleted bitmap marks deletes not applied yet.
+ * Bitmaps are made of 64-bit words and every bitmap and minipage starts 8-byte aligned. Where the minipages start
+ * depends on the schema only, it is worked out once per heap by ColumnLayout.
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/rowid.h"
+#include "page/page.h"
+#include "record/row.h"
+
+class ColumnLayout {
+ public:
+  ColumnLayout(const Schema *schema, uint32_t page_size);
+
+  /** @return the number of rows a page holds, 0 if a single row does not fit */
+  inline uint32_t GetCapacity() const { return capacity_; }
+
+  /** @return the number of 64-bit words of every bitmap */
+  inline uint32_t GetBitmapWords() const { return bitmap_words_; }
+
+  inline uint32_t GetColumnCount() const { return types_.size(); }
+
+  inline TypeId GetType(uint32_t column) const { return types_[column]; }
+
+  /** @return the width of a value cell of the column, the length prefix of a char value included */
+  inline uint32_t GetWidth(uint32_t column) const { return widths_[column]; }
+
+  inline uint32_t GetNullBitmapOffset(uint32_t column) const { return null_offsets_[column]; }
+
+  inline uint32_t GetValuesOffset(uint32_t column) const { return value_offsets_[column]; }
+
+  /**
+   * The share of a page one slot stands for. Free space of a column page is counted in slots of this size, so the
+   * free space map works for both kinds of page.
+   */
+  inline uint32_t GetSlotSpace() const { return slot_space_; }
+
+  /**
+   * @return true if the row matches the schema and all of its values fit into their cells
+   */
+  bool CanStore(const Row &row) const;
+
+  static constexpr uint32_t SIZE_COLUMN_PAGE_HEADER = 24;
+
+ private:
+  /** @return the bytes taken by a page of the given capacity */
+  uint32_t GetPageBytes(uint32_t capacity) const;
+
+ private:
+  uint32_t page_size_;
+  uint32_t capacity_{0};
+  uint32_t bitmap_words_{0};
+  uint32_t slot_space_{0};
+  std::vector<TypeId> types_;
+  std::vector<uint32_t> widths_;
+  std::vector<uint32_t> null_offsets_;
+  std::vector<uint32_t> value_offsets_;
+};
+
+class ColumnPage : public Page {
+ public:
+  void Init(page_id_t page_id, page_id_t prev_id);
+
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  page_id_t GetPrevPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_PREV_PAGE_ID); }
+
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  void SetPrevPageId(page_id_t prev_page_id) {
+    memcpy(GetData() + OFFSET_PREV_PAGE_ID, &prev_page_id, sizeof(page_id_t));
+  }
+
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  /** @return the number of slots in use, rows with a pending delete included */
+  uint32_t GetTupleCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_COUNT); }
+
+  /**
+   * Put the row into the first free slot, the caller checks that the layout can store it.
+   */
+  bool InsertTuple(Row &row, const ColumnLayout &layout);
+
+  bool MarkDelete(const RowId &rid, const ColumnLayout &layout);
+
+  /**
+   * Overwrite the values of a visible tuple, a row always fits into the cells of the one it replaces.
+   */
+  bool UpdateTuple(const Row &row, const RowId &rid, const ColumnLayout &layout);
+
+  void ApplyDelete(const RowId &rid, const ColumnLayout &layout);
+
+  void RollbackDelete(const RowId &rid, const ColumnLayout &layout);
+
+  bool GetTuple(Row *row, const ColumnLayout &layout);
+
+  bool GetFirstTupleRid(RowId *first_rid, const ColumnLayout &layout);
+
+  bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid, const ColumnLayout &layout);
+
+  /** @return true if a delete on this page is not applied yet */
+  bool HasPendingDelete(const ColumnLayout &layout);
+
+  uint32_t GetFreeSpaceRemaining(const ColumnLayout &layout) {
+    return (layout.GetCapacity() - GetTupleCount()) * layout.GetSlotSpace();
+  }
+
+  /** @return the slots in use, a set bit per slot */
+  const uint64_t *GetUsedBitmap() { return reinterpret_cast<uint64_t *>(GetData() + SIZE_HEADER); }
+
+  /** @return the slots whose delete is pending */
+  const uint64_t *GetDeletedBitmap(const ColumnLayout &layout) {
+    return reinterpret_cast<uint64_t *>(GetData() + SIZE_HEADER + layout.GetBitmapWords() * sizeof(uint64_t));
+  }
+
+  /** @return the slots whose value of the column is null */
+  const uint64_t *GetNullBitmap(uint32_t column, const ColumnLayout &layout) {
+    return reinterpret_cast<uint64_t *>(GetData() + layout.GetNullBitmapOffset(column));
+  }
+
+  /** @return the value cells of the column, in slot order */
+  const char *GetValues(uint32_t column, const ColumnLayout &layout) {
+    return GetData() + layout.GetValuesOffset(column);
+  }
+
+  /**
+   * Write the visible slots of the page into a bitmap of the layout's size.
+   * @return the number of visible slots
+   */
+  uint32_t GetVisibleBitmap(uint64_t *bitmap, const ColumnLayout &layout);
+
+ private:
+  void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
+
+  uint64_t *GetBitmap(uint32_t offset) { return reinterpret_cast<uint64_t *>(GetData() + offset); }
+
+  static bool TestBit(const uint64_t *bitmap, uint32_t slot) { return (bitmap[slot / 64] >> (slot % 64)) & 1; }
+
+  static void SetBit(uint64_t *bitmap, uint32_t slot, bool value) {
+    if (value) {
+      bitmap[slot / 64] |= uint64_t(1) << (slot % 64);
+    } else {
+      bitmap[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+    }
+  }
+
+  /** @return the slot of the row id if it holds a visible tuple of this page, -1 otherwise */
+  int GetVisibleSlot(const RowId &rid, const ColumnLayout &layout);
+
+  void WriteValues(uint32_t slot, const Row &row, const ColumnLayout &layout);
+
+ private:
+  static_assert(sizeof(page_id_t) == 4);
+  static constexpr size_t SIZE_HEADER = ColumnLayout::SIZE_COLUMN_PAGE_HEADER;
+  static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
+  static constexpr size_t OFFSET_TUPLE_COUNT = 16;
+};
+
+#endif  // MINISQL_COLUMN_PAGE_H
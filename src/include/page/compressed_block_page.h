@@ -0,0 +1,50 @@
+#ifndef MINISQL_COMPRESSED_BLOCK_PAGE_H
+#define MINISQL_COMPRESSED_BLOCK_PAGE_H
+
+/**
+ * One page of a compressed heap (see CompressedHeap), holding a single compressed block of rows (see CompressedBlock).
+ * The pages form a chain in insert order. Every page but the last one holds a sealed block that never grows again,
+ * the block of the last page takes new rows until it is full. BlockSize is the number of bytes of the block image.
+ *
+ *  Format (size in byte):
+ *  -------------------------------------------------------------------
+ *  | PageId (4) | LSN (4) | NextPageId (4) | BlockSize (4) | Block |
+ *  -------------------------------------------------------------------
+ */
+
+#include <cstring>
+
+#include "page/page.h"
+
+class CompressedBlockPage : public Page {
+ public:
+  void Init(page_id_t page_id) {
+    memcpy(GetData(), &page_id, sizeof(page_id));
+    SetNextPageId(INVALID_PAGE_ID);
+    SetBlockSize(0);
+  }
+
+  page_id_t GetBlockPageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  uint32_t GetBlockSize() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_BLOCK_SIZE); }
+
+  void SetBlockSize(uint32_t size) { memcpy(GetData() + OFFSET_BLOCK_SIZE, &size, sizeof(uint32_t)); }
+
+  char *GetBlock() { return GetData() + SIZE_HEADER; }
+
+  /** @return the room a page of the given size has for its block */
+  static uint32_t GetCapacity(uint32_t page_size) { return page_size - SIZE_HEADER; }
+
+ private:
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 8;
+  static constexpr size_t OFFSET_BLOCK_SIZE = 12;
+  static constexpr size_t SIZE_HEADER = 16;
+};
+
+#endif  // MINISQL_COMPRESSED_BLOCK_PAGE_H
@@ -0,0 +1,84 @@
+#ifndef MINISQL_DICTIONARY_PAGE_H
+#define MINISQL_DICTIONARY_PAGE_H
+
+/**
+ * One page of the dictionary of a dictionary encoded column (see Dictionary), a chain of pages that lists the values
+ * of the column in the order of their codes. The first page of the chain is recorded in the table meta data and never
+ * moves, values are only ever appended to the last page.
+ *
+ *  Format (size in byte):
+ *  ---------------------------------------------------------------------------------------------------
+ *  | PageId (4) | LSN (4) | NextPageId (4) | Count (4) | DataSize (4) | Length_1 (4) | Value_1 | ... |
+ *  ---------------------------------------------------------------------------------------------------
+ */
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "page/page.h"
+
+class DictionaryPage : public Page {
+ public:
+  void Init(page_id_t page_id) {
+    memcpy(GetData(), &page_id, sizeof(page_id));
+    SetNextPageId(INVALID_PAGE_ID);
+    SetCount(0);
+    SetDataSize(0);
+  }
+
+  page_id_t GetDictionaryPageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  uint32_t GetCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_COUNT); }
+
+  /**
+   * Append a value behind the others.
+   * @return false if the page has no room left for it
+   */
+  bool Append(const std::string &value) {
+    uint32_t data_size = GetDataSize();
+    if (SIZE_HEADER + data_size + sizeof(uint32_t) + value.size() > GetPageSize()) {
+      return false;
+    }
+    auto length = static_cast<uint32_t>(value.size());
+    memcpy(GetData() + SIZE_HEADER + data_size, &length, sizeof(uint32_t));
+    memcpy(GetData() + SIZE_HEADER + data_size + sizeof(uint32_t), value.data(), value.size());
+    SetDataSize(data_size + sizeof(uint32_t) + length);
+    SetCount(GetCount() + 1);
+    return true;
+  }
+
+  /**
+   * Append the values of the page to the given ones, in the order they were written.
+   */
+  void GetValues(std::vector<std::string> &values) {
+    const char *data = GetData() + SIZE_HEADER;
+    for (uint32_t i = 0; i < GetCount(); i++) {
+      uint32_t length;
+      memcpy(&length, data, sizeof(uint32_t));
+      values.emplace_back(data + sizeof(uint32_t), length);
+      data += sizeof(uint32_t) + length;
+    }
+  }
+
+ private:
+  uint32_t GetDataSize() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_DATA_SIZE); }
+
+  void SetCount(uint32_t count) { memcpy(GetData() + OFFSET_COUNT, &count, sizeof(uint32_t)); }
+
+  void SetDataSize(uint32_t size) { memcpy(GetData() + OFFSET_DATA_SIZE, &size, sizeof(uint32_t)); }
+
+ private:
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 8;
+  static constexpr size_t OFFSET_COUNT = 12;
+  static constexpr size_t OFFSET_DATA_SIZE = 16;
+  static constexpr size_t SIZE_HEADER = 20;
+};
+
+#endif  // MINISQL_DICTIONARY_PAGE_H
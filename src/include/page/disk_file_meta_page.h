@@ -5,10 +5,10 @@
 
 #include "page/bitmap_page.h"
 
-static constexpr page_id_t MAX_VALID_PAGE_ID = (PAGE_SIZE - 8) / 4 * BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
-
 class DiskFileMetaPage {
  public:
+  uint32_t GetPageSize() { return page_size_; }
+
   uint32_t GetExtentNums() { return num_extents_; }
 
   uint32_t GetAllocatedPages() { return num_allocated_pages_; }
@@ -20,7 +20,13 @@ class DiskFileMetaPage {
     return extent_used_page_[extent_id];
   }
 
+  /**
+   * @return the number of extents a meta page of the given size can keep track of
+   */
+  static constexpr uint32_t GetMaxExtentNums(uint32_t page_size) { return (page_size - 3 * sizeof(uint32_t)) / 4; }
+
  public:
+  uint32_t page_size_{0};  // chosen when the database file is created, 0 for a fresh file
   uint32_t num_allocated_pages_{0};
   uint32_t num_extents_{0};  // each extent consists with a bit map and BIT_MAP_SIZE pages
   uint32_t extent_used_page_[0];
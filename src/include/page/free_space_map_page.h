@@ -0,0 +1,98 @@
+#ifndef MINISQL_FREE_SPACE_MAP_PAGE_H
+#define MINISQL_FREE_SPACE_MAP_PAGE_H
+
+/**
+ * One page of the free space map of a table heap. The map is a chain of such pages that lists every page of the heap
+ * in chain order, together with a coarse measure of how much free space the page has left.
+ *
+ * Free space is kept as a category of one byte: category c means at least c * (page_size / 256) bytes are free, so
+ * the map may underestimate the space of a page but never overestimates it.
+ *
+ *  Format (size in byte):
+ *  ------------------------------------------------------------------------------------------------
+ *  | PageId (4) | LSN (4) | NextPageId (4) | Count (4) | HeapPageId_1 (4) | ... | Category_1 (1) | ... |
+ *  ------------------------------------------------------------------------------------------------
+ */
+
+#include <cstring>
+
+#include "page/page.h"
+
+class FreeSpaceMapPage : public Page {
+ public:
+  void Init(page_id_t page_id) {
+    memcpy(GetData(), &page_id, sizeof(page_id));
+    SetNextPageId(INVALID_PAGE_ID);
+    SetCount(0);
+  }
+
+  page_id_t GetFreeSpaceMapPageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  uint32_t GetCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_COUNT); }
+
+  bool IsFull() { return GetCount() == GetCapacity(GetPageSize()); }
+
+  /**
+   * Append a heap page to the map, the caller checks that the page is not full.
+   */
+  void Append(page_id_t heap_page_id, uint8_t category) {
+    uint32_t index = GetCount();
+    SetCount(index + 1);
+    SetHeapPageId(index, heap_page_id);
+    SetCategory(index, category);
+  }
+
+  page_id_t GetHeapPageId(uint32_t index) {
+    return *reinterpret_cast<page_id_t *>(GetData() + SIZE_HEADER + index * sizeof(page_id_t));
+  }
+
+  void SetHeapPageId(uint32_t index, page_id_t heap_page_id) {
+    memcpy(GetData() + SIZE_HEADER + index * sizeof(page_id_t), &heap_page_id, sizeof(page_id_t));
+  }
+
+  uint8_t GetCategory(uint32_t index) {
+    return *reinterpret_cast<uint8_t *>(GetData() + GetCategoryOffset(GetPageSize()) + index);
+  }
+
+  void SetCategory(uint32_t index, uint8_t category) {
+    *reinterpret_cast<uint8_t *>(GetData() + GetCategoryOffset(GetPageSize()) + index) = category;
+  }
+
+  /** @return the number of heap pages one map page of the given size can describe */
+  static constexpr uint32_t GetCapacity(uint32_t page_size) {
+    return (page_size - SIZE_HEADER) / (sizeof(page_id_t) + sizeof(uint8_t));
+  }
+
+  /** @return the category of a page with free_bytes bytes of free space, rounded down */
+  static uint8_t ToCategory(uint32_t free_bytes, uint32_t page_size) {
+    uint32_t category = free_bytes / (page_size / CATEGORY_COUNT);
+    return static_cast<uint8_t>(category < CATEGORY_COUNT ? category : CATEGORY_COUNT - 1);
+  }
+
+  /** @return the smallest category that guarantees needed_bytes bytes of free space, rounded up */
+  static uint32_t ToNeededCategory(uint32_t needed_bytes, uint32_t page_size) {
+    uint32_t unit = page_size / CATEGORY_COUNT;
+    return (needed_bytes + unit - 1) / unit;
+  }
+
+ private:
+  void SetCount(uint32_t count) { memcpy(GetData() + OFFSET_COUNT, &count, sizeof(uint32_t)); }
+
+  static constexpr uint32_t GetCategoryOffset(uint32_t page_size) {
+    return SIZE_HEADER + GetCapacity(page_size) * sizeof(page_id_t);
+  }
+
+ private:
+  static constexpr uint32_t CATEGORY_COUNT = 256;
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 8;
+  static constexpr size_t OFFSET_COUNT = 12;
+  static constexpr size_t SIZE_HEADER = 16;
+};
+
+#endif  // MINISQL_FREE_SPACE_MAP_PAGE_H
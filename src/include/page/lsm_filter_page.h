@@ -0,0 +1,63 @@
+#ifndef MINISQL_LSM_FILTER_PAGE_H
+#define MINISQL_LSM_FILTER_PAGE_H
+
+/**
+ * One page of the bloom filter of a sorted run of an LSM tree (see LsmTree). The filter is written once with its run,
+ * as BloomFilter::SerializeTo lays it out, cut into a chain of such pages, and freed with the run. Length is the
+ * number of filter bytes the page holds.
+ *
+ *  Format (size in byte):
+ *  ------------------------------------------------------------------
+ *  | PageId (4) | LSN (4) | NextPageId (4) | Length (4) | Bytes ... |
+ *  ------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "page/page.h"
+
+class LsmFilterPage : public Page {
+ public:
+  void Init(page_id_t page_id) {
+    memcpy(GetData(), &page_id, sizeof(page_id));
+    SetNextPageId(INVALID_PAGE_ID);
+    SetLength(0);
+  }
+
+  page_id_t GetFilterPageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  uint32_t GetLength() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_LENGTH); }
+
+  const char *GetBytes() { return GetData() + SIZE_HEADER; }
+
+  /**
+   * Fill the page with the first bytes of data, as many as it holds.
+   * @return the number of bytes taken
+   */
+  uint32_t Fill(const char *data, uint32_t length) {
+    uint32_t taken = std::min(length, GetCapacity(GetPageSize()));
+    memcpy(GetData() + SIZE_HEADER, data, taken);
+    SetLength(taken);
+    return taken;
+  }
+
+  /** @return the number of filter bytes one page of the given size holds */
+  static constexpr uint32_t GetCapacity(uint32_t page_size) { return page_size - SIZE_HEADER; }
+
+ private:
+  void SetLength(uint32_t length) { memcpy(GetData() + OFFSET_LENGTH, &length, sizeof(uint32_t)); }
+
+ private:
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 8;
+  static constexpr size_t OFFSET_LENGTH = 12;
+  static constexpr size_t SIZE_HEADER = 16;
+};
+
+#endif  // MINISQL_LSM_FILTER_PAGE_H
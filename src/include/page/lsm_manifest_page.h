@@ -0,0 +1,81 @@
+#ifndef MINISQL_LSM_MANIFEST_PAGE_H
+#define MINISQL_LSM_MANIFEST_PAGE_H
+
+/**
+ * One page of the manifest of an LSM tree (see LsmTree), a chain of pages that lists the sorted runs of the tree.
+ * The first page of the chain names the tree and never moves. Runs are listed level by level, the runs of level 0
+ * newest first and those of deeper levels in key order. Each record gives the first page of the run chain, its length
+ * in pages, its entry count, and the first pages of the fence chain and the filter chain of the run.
+ *
+ *  Format (size in byte):
+ *  -------------------------------------------------------------------------------------------------------
+ *  | PageId (4) | LSN (4) | NextPageId (4) | Count (4) | Level_1 (4) | FirstPageId_1 (4) | PageCount_1 (4) |
+ *  -------------------------------------------------------------------------------------------------------
+ *  | EntryCount_1 (4) | FencePageId_1 (4) | FilterPageId_1 (4) | Level_2 (4) | ... |
+ *  -------------------------------------------------------------------------------
+ */
+
+#include <cstring>
+
+#include "page/page.h"
+
+class LsmManifestPage : public Page {
+ public:
+  struct RunRecord {
+    uint32_t level_;
+    page_id_t first_page_id_;
+    uint32_t page_count_;
+    uint32_t entry_count_;
+    page_id_t fence_page_id_;
+    page_id_t filter_page_id_;
+  };
+
+  void Init(page_id_t page_id) {
+    memcpy(GetData(), &page_id, sizeof(page_id));
+    SetNextPageId(INVALID_PAGE_ID);
+    SetCount(0);
+  }
+
+  page_id_t GetManifestPageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  uint32_t GetCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_COUNT); }
+
+  RunRecord GetRecord(uint32_t index) {
+    RunRecord record;
+    memcpy(&record, GetData() + SIZE_HEADER + index * SIZE_RECORD, SIZE_RECORD);
+    return record;
+  }
+
+  void SetRecord(uint32_t index, const RunRecord &record) {
+    memcpy(GetData() + SIZE_HEADER + index * SIZE_RECORD, &record, SIZE_RECORD);
+  }
+
+  /**
+   * Append a record, the caller keeps the count within the capacity.
+   */
+  void Append(const RunRecord &record) {
+    uint32_t count = GetCount();
+    SetRecord(count, record);
+    SetCount(count + 1);
+  }
+
+  /** @return the number of run records one manifest page of the given size holds */
+  static constexpr uint32_t GetCapacity(uint32_t page_size) { return (page_size - SIZE_HEADER) / SIZE_RECORD; }
+
+ private:
+  void SetCount(uint32_t count) { memcpy(GetData() + OFFSET_COUNT, &count, sizeof(uint32_t)); }
+
+ private:
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 8;
+  static constexpr size_t OFFSET_COUNT = 12;
+  static constexpr size_t SIZE_HEADER = 16;
+  static constexpr size_t SIZE_RECORD = 24;
+};
+
+#endif  // MINISQL_LSM_MANIFEST_PAGE_H
@@ -0,0 +1,115 @@
+#ifndef MINISQL_LSM_RUN_PAGE_H
+#define MINISQL_LSM_RUN_PAGE_H
+
+/**
+ * One page of a sorted run of an LSM tree (see LsmTree). A run is a chain of such pages written once, one after
+ * another, and never changed until it is freed as a whole. Its entries are sorted by key across the chain, each one
+ * lies within a single page. A delete is kept as a tombstone, an entry whose value length is TOMBSTONE. DataEnd is
+ * the offset behind the last entry.
+ *
+ * The fences of a run are a chain of the same pages, written behind the run. Each of their entries has the first key
+ * of a run page as its key and the id of that page as its 4 byte value, a last entry has the last key of the run and
+ * INVALID_PAGE_ID.
+ *
+ *  Format (size in byte):
+ *  -----------------------------------------------------------------------------------------------------------
+ *  | PageId (4) | LSN (4) | NextPageId (4) | Count (4) | DataEnd (4) | KeyLength_1 (4) | ValueLength_1 (4) |
+ *  -----------------------------------------------------------------------------------------------------------
+ *  | Key_1 | Value_1 | KeyLength_2 (4) | ... |
+ *  -------------------------------------------
+ */
+
+#include <cstring>
+#include <string>
+
+#include "page/page.h"
+
+class LsmRunPage : public Page {
+ public:
+  void Init(page_id_t page_id) {
+    memcpy(GetData(), &page_id, sizeof(page_id));
+    SetNextPageId(INVALID_PAGE_ID);
+    SetCount(0);
+    SetDataEnd(SIZE_HEADER);
+  }
+
+  page_id_t GetRunPageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  uint32_t GetCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_COUNT); }
+
+  /**
+   * Append an entry behind the last one, the caller keeps the keys in order.
+   * @return false if the page has no room left for it
+   */
+  bool Append(const std::string &key, const std::string &value, bool deleted) {
+    uint32_t size = GetEntrySize(key, value, deleted);
+    uint32_t data_end = GetDataEnd();
+    if (data_end + size > GetPageSize()) {
+      return false;
+    }
+    char *buf = GetData() + data_end;
+    uint32_t key_length = key.size();
+    uint32_t value_length = deleted ? TOMBSTONE : value.size();
+    memcpy(buf, &key_length, sizeof(uint32_t));
+    memcpy(buf + 4, &value_length, sizeof(uint32_t));
+    memcpy(buf + 8, key.data(), key.size());
+    if (!deleted) {
+      memcpy(buf + 8 + key.size(), value.data(), value.size());
+    }
+    SetDataEnd(data_end + size);
+    SetCount(GetCount() + 1);
+    return true;
+  }
+
+  /**
+   * Read the entry at the given byte offset of the page, the first one is at GetFirstOffset(). The value of a
+   * tombstone is left empty.
+   * @return the offset of the entry behind it, GetDataEnd() behind the last one
+   */
+  uint32_t ReadEntry(uint32_t offset, std::string *key, std::string *value, bool *deleted) {
+    const char *buf = GetData() + offset;
+    uint32_t key_length = *reinterpret_cast<const uint32_t *>(buf);
+    uint32_t value_length = *reinterpret_cast<const uint32_t *>(buf + 4);
+    key->assign(buf + 8, key_length);
+    *deleted = value_length == TOMBSTONE;
+    if (*deleted) {
+      value->clear();
+      return offset + 8 + key_length;
+    }
+    value->assign(buf + 8 + key_length, value_length);
+    return offset + 8 + key_length + value_length;
+  }
+
+  uint32_t GetDataEnd() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_DATA_END); }
+
+  static constexpr uint32_t GetFirstOffset() { return SIZE_HEADER; }
+
+  /** @return the bytes an entry takes in a page */
+  static uint32_t GetEntrySize(const std::string &key, const std::string &value, bool deleted) {
+    return 8 + key.size() + (deleted ? 0 : value.size());
+  }
+
+  /** @return the largest entry a run page of the given size holds */
+  static constexpr uint32_t GetCapacity(uint32_t page_size) { return page_size - SIZE_HEADER; }
+
+  static constexpr uint32_t TOMBSTONE = UINT32_MAX;
+
+ private:
+  void SetCount(uint32_t count) { memcpy(GetData() + OFFSET_COUNT, &count, sizeof(uint32_t)); }
+
+  void SetDataEnd(uint32_t data_end) { memcpy(GetData() + OFFSET_DATA_END, &data_end, sizeof(uint32_t)); }
+
+ private:
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 8;
+  static constexpr size_t OFFSET_COUNT = 12;
+  static constexpr size_t OFFSET_DATA_END = 16;
+  static constexpr size_t SIZE_HEADER = 20;
+};
+
+#endif  // MINISQL_LSM_RUN_PAGE_H
@@ -0,0 +1,60 @@
+#ifndef MINISQL_OVERFLOW_PAGE_H
+#define MINISQL_OVERFLOW_PAGE_H
+
+/**
+ * One page of an overflow chain. A char value too long to be kept in its tuple is cut into pieces that fill a chain
+ * of overflow pages, the tuple only keeps a prefix of the value and the id of the first page (see Row). A chain is
+ * written once when its value is stored and freed as a whole when the value is replaced or deleted, it never changes
+ * in between.
+ *
+ *  Format (size in byte):
+ *  -----------------------------------------------------------------
+ *  | PageId (4) | LSN (4) | NextPageId (4) | DataSize (4) | Data ... |
+ *  -----------------------------------------------------------------
+ */
+
+#include <cstring>
+
+#include "page/page.h"
+
+class OverflowPage : public Page {
+ public:
+  void Init(page_id_t page_id) {
+    memcpy(GetData(), &page_id, sizeof(page_id));
+    SetNextPageId(INVALID_PAGE_ID);
+    SetDataSize(0);
+  }
+
+  page_id_t GetOverflowPageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  uint32_t GetDataSize() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_DATA_SIZE); }
+
+  const char *GetValueData() { return GetData() + SIZE_HEADER; }
+
+  /**
+   * Fill the page with a piece of a value, the caller keeps it within the capacity.
+   */
+  void SetValueData(const char *data, uint32_t size) {
+    memcpy(GetData() + SIZE_HEADER, data, size);
+    SetDataSize(size);
+  }
+
+  /** @return the bytes of a value one overflow page of the given size holds */
+  static constexpr uint32_t GetCapacity(uint32_t page_size) { return page_size - SIZE_HEADER; }
+
+ private:
+  void SetDataSize(uint32_t size) { memcpy(GetData() + OFFSET_DATA_SIZE, &size, sizeof(uint32_t)); }
+
+ private:
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 8;
+  static constexpr size_t OFFSET_DATA_SIZE = 12;
+  static constexpr size_t SIZE_HEADER = 16;
+};
+
+#endif  // MINISQL_OVERFLOW_PAGE_H
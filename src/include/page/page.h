@@ -3,6 +3,7 @@
 
 #include <cstring>
 #include <iostream>
+#include <memory>
 #include <shared_mutex>
 
 #include "common/config.h"
@@ -20,8 +21,11 @@ class Page {
  public:
   DISALLOW_COPY(Page)
 
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
+  /** Constructor. Owns a zeroed buffer of the default page size. */
+  Page() : owned_data_(new char[PAGE_SIZE]), data_(owned_data_.get()) { ResetMemory(); }
+
+  /** Constructor used by the buffer pool manager, the page views page_size bytes of frame memory it does not own. */
+  Page(char *data, uint32_t page_size) : data_(data), page_size_(page_size) {}
 
   /** Default destructor. */
   ~Page() = default;
@@ -29,6 +33,9 @@ class Page {
   /** @return the actual data contained within this page */
   inline char *GetData() { return data_; }
 
+  /** @return the size in bytes of the data buffer, i.e. the page size of the database this page belongs to */
+  inline uint32_t GetPageSize() const { return page_size_; }
+
   /** @return the page id of this page */
   inline page_id_t GetPageId() { return page_id_; }
 
@@ -66,10 +73,14 @@ class Page {
 
  private:
   /** Zeroes out the data that is held within the page. */
-  inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }
+  inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, page_size_); }
 
+  /** Backing memory of a page that is not part of a buffer pool. */
+  std::unique_ptr<char[]> owned_data_;
   /** The actual data that is stored within a page. */
-  char data_[PAGE_SIZE]{};
+  char *data_{nullptr};
+  /** The size of data_ in bytes. */
+  uint32_t page_size_{PAGE_SIZE};
   /** The ID of this page. */
   page_id_t page_id_ = INVALID_PAGE_ID;
   /** The pin count of this page. */
@@ -15,9 +15,15 @@
  *  ----------------------------------------------------------------
  *  | TupleCount (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
  *  ----------------------------------------------------------------
+ *
+ *  The top bits of a tuple size are flags. Besides the delete mark, a slot may hold a forwarding stub: the row of the
+ *  slot grew out of its page and lives in another one, the stub keeps the row id of the new place (8 bytes) so that
+ *  the row id the indexes know stays valid. The moved tuple is flagged as well and its serialized row id is the one of
+ *  its home slot, which is what scans report for it.
  **/
 
 #include <cstring>
+#include <functional>
 
 #include "common/macros.h"
 #include "common/rowid.h"
@@ -49,8 +55,13 @@ class TablePage : public Page {
 
   bool MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
 
-  bool UpdateTuple(Row new_row, Row *old_row, Schema *schema, Transaction *txn, LockManager *lock_manager,
-                   LogManager *log_manager);
+  /**
+   * Update a tuple where it is, the tuples before it shift to make room.
+   * @return 1 if the tuple was updated, 0 if the slot does not exist, 2 if the tuple is deleted or a forwarding stub,
+   * 3 if the page has not enough free space for the new row
+   */
+  int UpdateTuple(Row new_row, Row *old_row, Schema *schema, Transaction *txn, LockManager *lock_manager,
+                  LogManager *log_manager);
 
   void ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_manager);
 
@@ -58,10 +69,59 @@ class TablePage : public Page {
 
   bool GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager *lock_manager);
 
+  /**
+   * Insert a row that moved here from its home slot in another page, the row id of the row must be that home slot.
+   * @param[out] new_rid where the tuple was put
+   */
+  bool InsertMovedTuple(const Row &row, Schema *schema, RowId *new_rid);
+
+  /**
+   * @return true if the slot of rid holds a forwarding stub, deleted or not, and then the place of its row in target
+   */
+  bool GetForward(const RowId &rid, RowId *target);
+
+  /**
+   * Turn the live tuple or the forwarding stub at a slot into a stub that points to target.
+   */
+  void SetForward(uint32_t slot_num, const RowId &target);
+
+  /**
+   * Put a row back into the slot of its forwarding stub, if the page has room for it.
+   */
+  bool ReplaceForward(uint32_t slot_num, Row &row, Schema *schema);
+
+  /** Rewrite the page ids of the row ids kept by forwarding stubs and moved tuples, for pages that get renumbered */
+  void RemapForwards(const std::function<page_id_t(page_id_t)> &remap);
+
+  /**
+   * Collect the first overflow page of every value of the tuple at a slot that lives in an overflow chain. A deleted
+   * tuple still owns its chains until the delete is applied, a forwarding stub owns none.
+   */
+  void GetOverflows(uint32_t slot_num, Schema *schema, std::vector<page_id_t> &first_page_ids);
+
+  /**
+   * Rewrite the first overflow page of every overflowed value of the tuples of this page, deleted ones included.
+   * Used to renumber the chains and, with a remap that keeps the page id, to find them.
+   */
+  void RemapOverflows(Schema *schema, const std::function<page_id_t(page_id_t)> &remap);
+
   bool GetFirstTupleRid(RowId *first_rid);
 
   bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid);
 
+  uint32_t GetFreeSpaceRemaining() {
+    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
+  }
+
+  /** @return true if a tuple of this page is marked deleted and the delete is not applied yet */
+  bool HasPendingDelete();
+
+  /** @return true if every slot of this page holds a live tuple */
+  bool IsCompact();
+
+  /** @return true if the page holds a forwarding stub or a tuple moved in from another page */
+  bool HasForwarding();
+
  private:
   uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
 
@@ -73,10 +133,6 @@ class TablePage : public Page {
 
   void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
 
-  uint32_t GetFreeSpaceRemaining() {
-    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
-  }
-
   uint32_t GetTupleOffsetAtSlot(uint32_t slot_num) {
     return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
   }
@@ -99,9 +155,26 @@ class TablePage : public Page {
 
   static uint32_t UnsetDeletedFlag(uint32_t tuple_size) { return static_cast<uint32_t>(tuple_size & (~DELETE_MASK)); }
 
+  static bool IsForward(uint32_t tuple_size) { return static_cast<bool>(tuple_size & FORWARD_MASK); }
+
+  static bool IsMoved(uint32_t tuple_size) { return static_cast<bool>(tuple_size & MOVED_MASK); }
+
+  /** @return the number of bytes a tuple takes, without the flags of its size */
+  static uint32_t GetTupleLength(uint32_t tuple_size) {
+    return static_cast<uint32_t>(tuple_size & ~(DELETE_MASK | FORWARD_MASK | MOVED_MASK));
+  }
+
+  /**
+   * Give the tuple at a slot new_size bytes, the tuples before it shift, the caller checks that the page has room.
+   * The content of the tuple is undefined afterwards and its size is set to new_size without flags.
+   */
+  void ResizeTuple(uint32_t slot_num, uint32_t new_size);
+
  private:
   static_assert(sizeof(page_id_t) == 4);
   static constexpr uint64_t DELETE_MASK = (1U << (8 * sizeof(uint32_t) - 1));
+  static constexpr uint64_t FORWARD_MASK = (1U << (8 * sizeof(uint32_t) - 2));
+  static constexpr uint64_t MOVED_MASK = (1U << (8 * sizeof(uint32_t) - 3));
   static constexpr size_t SIZE_TABLE_PAGE_HEADER = 24;
   static constexpr size_t SIZE_TUPLE = 8;
   static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
@@ -112,7 +185,11 @@ class TablePage : public Page {
   static constexpr size_t OFFSET_TUPLE_SIZE = 28;
 
  public:
-  static constexpr size_t SIZE_MAX_ROW = PAGE_SIZE - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE;
+  /** @return the largest serialized row that fits into an empty table page of the given size */
+  static constexpr size_t GetMaxRowSize(uint32_t page_size) { return page_size - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE; }
+
+  /** @return the free space a row of the given serialized size takes up once inserted */
+  static constexpr uint32_t GetSpaceNeeded(uint32_t serialized_size) { return serialized_size + SIZE_TUPLE; }
 };
 
 #endif
\ No newline at end of file
@@ -7,6 +7,8 @@
   int yyerror(char* error);
 %}
 
+%define api.header.include {"parser/minisql_yacc.h"}
+
 %union {
 	pSyntaxNode syntax_node;
 }
@@ -17,6 +19,8 @@
 %token <syntax_node> ON FROM WHERE INTO SET VALUES PRIMARY KEY UNIQUE
 %token <syntax_node> CHAR INT FLOAT AND OR NOT IS FLAGNULL
 %token <syntax_node> IDENTIFIER STRING NUMBER EQ NE LE GE
+%token <syntax_node> PAGESIZE TABLESPACE LOCATION VACUUM COPY STORAGE TRUNCATE ENGINE TEMPORARY
+%token <syntax_node> PARTITION PARTITIONS BY LESS THAN MAXVALUE ALTER ADD COLUMN DEFAULT AS AUTOINCREMENT DICTIONARY CLUSTER
 
 %type <syntax_node> start sql
 %type <syntax_node> sql_create_database sql_drop_database sql_show_databases sql_use_database
@@ -28,6 +32,9 @@
 %type <syntax_node> connector where_conditions where_condition
 %type <syntax_node> sql_insert sql_delete sql_update update_values update_value
 %type <syntax_node> sql_quit sql_exec_file
+%type <syntax_node> sql_create_tablespace table_options table_option
+%type <syntax_node> sql_vacuum sql_copy sql_truncate sql_cluster sql_set
+%type <syntax_node> partition_definition_list partition_definition sql_alter_table name
 
 %%
 
@@ -45,12 +52,19 @@ sql:
   | sql_use_database { $$ = $1; }
   | sql_show_tables { $$ = $1; }
   | sql_create_table { $$ = $1; }
+  | sql_create_tablespace { $$ = $1; }
+  | sql_vacuum { $$ = $1; }
+  | sql_truncate { $$ = $1; }
+  | sql_cluster { $$ = $1; }
+  | sql_set { $$ = $1; }
+  | sql_alter_table { $$ = $1; }
   | sql_drop_table { $$ = $1; }
   | sql_create_index { $$ = $1; }
   | sql_drop_index { $$ = $1; }
   | sql_show_indexes { $$ = $1; }
   | sql_select { $$ = $1; }
   | sql_insert { $$ = $1; }
+  | sql_copy { $$ = $1; }
   | sql_delete { $$ = $1; }
   | sql_update { $$ = $1; }
   | sql_trx_begin { $$ = $1; }
@@ -61,14 +75,21 @@ sql:
   ;
 
 sql_create_database:
-  CREATE DATABASE IDENTIFIER {
+  CREATE DATABASE name {
+    $$ = CreateSyntaxNode(kNodeCreateDB, NULL);
+    SyntaxNodeAddChildren($$, $3);
+  }
+  | CREATE DATABASE name PAGESIZE EQ NUMBER {
     $$ = CreateSyntaxNode(kNodeCreateDB, NULL);
+    pSyntaxNode option_node = CreateSyntaxNode(kNodeOption, "page_size");
+    SyntaxNodeAddChildren(option_node, $6);
     SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, option_node);
   }
   ;
 
 sql_drop_database:
-  DROP DATABASE IDENTIFIER {
+  DROP DATABASE name {
     $$ = CreateSyntaxNode(kNodeDropDB, NULL);
     SyntaxNodeAddChildren($$, $3);
   }
@@ -81,7 +102,7 @@ sql_show_databases:
   ;
 
 sql_use_database:
-  USE IDENTIFIER {
+  USE name {
     $$ = CreateSyntaxNode(kNodeUseDB, NULL);
     SyntaxNodeAddChildren($$, $2);
   }
@@ -94,21 +115,202 @@ sql_show_tables:
   ;
 
 sql_create_table:
-  CREATE TABLE IDENTIFIER '(' column_definition_list ')' {
+  CREATE TABLE name '(' column_definition_list ')' table_options {
     $$ = CreateSyntaxNode(kNodeCreateTable, NULL);
     pSyntaxNode list_node = CreateSyntaxNode(kNodeColumnDefinitionList, NULL);
     SyntaxNodeAddChildren(list_node, $5);
     SyntaxNodeAddChildren($$, $3);
     SyntaxNodeAddChildren($$, list_node);
+    SyntaxNodeAddChildren($$, $7);
+  }
+  | CREATE TEMPORARY TABLE name '(' column_definition_list ')' table_options {
+    $$ = CreateSyntaxNode(kNodeCreateTable, "temporary");
+    pSyntaxNode list_node = CreateSyntaxNode(kNodeColumnDefinitionList, NULL);
+    SyntaxNodeAddChildren(list_node, $6);
+    SyntaxNodeAddChildren($$, $4);
+    SyntaxNodeAddChildren($$, list_node);
+    SyntaxNodeAddChildren($$, $8);
+  }
+  | CREATE TABLE name table_options AS sql_select {
+    $$ = CreateSyntaxNode(kNodeCreateTable, NULL);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, $4);
+    SyntaxNodeAddChildren($$, $6);
+  }
+  ;
+
+table_options:
+  table_option table_options {
+    $$ = $1;
+    SyntaxNodeAddSibling($$, $2);
+  }
+  | {
+    $$ = NULL;
+  }
+  ;
+
+table_option:
+  TABLESPACE name {
+    $$ = CreateSyntaxNode(kNodeOption, "tablespace");
+    SyntaxNodeAddChildren($$, $2);
+  }
+  | STORAGE EQ name {
+    $$ = CreateSyntaxNode(kNodeOption, "storage");
+    SyntaxNodeAddChildren($$, $3);
+  }
+  | ENGINE EQ name {
+    $$ = CreateSyntaxNode(kNodeOption, "engine");
+    SyntaxNodeAddChildren($$, $3);
+  }
+  | PARTITION BY name '(' name ')' '(' partition_definition_list ')' {
+    $$ = CreateSyntaxNode(kNodeOption, "partition");
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, $5);
+    SyntaxNodeAddChildren($$, $8);
+  }
+  | PARTITION BY name '(' name ')' PARTITIONS NUMBER {
+    $$ = CreateSyntaxNode(kNodeOption, "partition");
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, $5);
+    SyntaxNodeAddChildren($$, $8);
+  }
+  ;
+
+partition_definition_list:
+  partition_definition ',' partition_definition_list {
+    $$ = $1;
+    SyntaxNodeAddSibling($$, $3);
+  }
+  | partition_definition {
+    $$ = $1;
+  }
+  ;
+
+partition_definition:
+  PARTITION name VALUES LESS THAN '(' column_value ')' {
+    $$ = CreateSyntaxNode(kNodePartition, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddChildren($$, $7);
+  }
+  | PARTITION name VALUES LESS THAN MAXVALUE {
+    $$ = CreateSyntaxNode(kNodePartition, "maxvalue");
+    SyntaxNodeAddChildren($$, $2);
+  }
+  | PARTITION name VALUES LESS THAN '(' MAXVALUE ')' {
+    $$ = CreateSyntaxNode(kNodePartition, "maxvalue");
+    SyntaxNodeAddChildren($$, $2);
+  }
+  | PARTITION name {
+    $$ = CreateSyntaxNode(kNodePartition, NULL);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  ;
+
+sql_vacuum:
+  VACUUM DATABASE {
+    $$ = CreateSyntaxNode(kNodeVacuumDB, NULL);
+  }
+  | VACUUM name {
+    $$ = CreateSyntaxNode(kNodeVacuumTable, NULL);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  | VACUUM TABLE name {
+    $$ = CreateSyntaxNode(kNodeVacuumTable, NULL);
+    SyntaxNodeAddChildren($$, $3);
+  }
+  ;
+
+sql_truncate:
+  TRUNCATE name {
+    $$ = CreateSyntaxNode(kNodeTruncateTable, NULL);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  | TRUNCATE TABLE name {
+    $$ = CreateSyntaxNode(kNodeTruncateTable, NULL);
+    SyntaxNodeAddChildren($$, $3);
+  }
+  ;
+
+sql_cluster:
+  CLUSTER name USING name {
+    $$ = CreateSyntaxNode(kNodeClusterTable, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddChildren($$, $4);
+  }
+  | CLUSTER TABLE name USING name {
+    $$ = CreateSyntaxNode(kNodeClusterTable, NULL);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, $5);
+  }
+  ;
+
+sql_set:
+  SET IDENTIFIER EQ NUMBER {
+    $$ = CreateSyntaxNode(kNodeSet, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddChildren($$, $4);
+  }
+  ;
+
+sql_alter_table:
+  ALTER TABLE name ADD COLUMN column_definition {
+    $$ = CreateSyntaxNode(kNodeAlterTable, NULL);
+    pSyntaxNode option_node = CreateSyntaxNode(kNodeOption, "add column");
+    SyntaxNodeAddChildren(option_node, $6);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, option_node);
+  }
+  | ALTER TABLE name ADD COLUMN column_definition DEFAULT column_value {
+    $$ = CreateSyntaxNode(kNodeAlterTable, NULL);
+    pSyntaxNode option_node = CreateSyntaxNode(kNodeOption, "add column");
+    SyntaxNodeAddChildren(option_node, $6);
+    SyntaxNodeAddChildren(option_node, $8);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, option_node);
+  }
+  | ALTER TABLE name ADD partition_definition {
+    $$ = CreateSyntaxNode(kNodeAlterTable, NULL);
+    pSyntaxNode option_node = CreateSyntaxNode(kNodeOption, "add partition");
+    SyntaxNodeAddChildren(option_node, $5);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, option_node);
+  }
+  | ALTER TABLE name DROP PARTITION name {
+    $$ = CreateSyntaxNode(kNodeAlterTable, NULL);
+    pSyntaxNode option_node = CreateSyntaxNode(kNodeOption, "drop partition");
+    SyntaxNodeAddChildren(option_node, $6);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, option_node);
+  }
+  | ALTER TABLE name TRUNCATE PARTITION name {
+    $$ = CreateSyntaxNode(kNodeAlterTable, NULL);
+    pSyntaxNode option_node = CreateSyntaxNode(kNodeOption, "truncate partition");
+    SyntaxNodeAddChildren(option_node, $6);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, option_node);
+  }
+  ;
+
+sql_create_tablespace:
+  CREATE TABLESPACE name {
+    $$ = CreateSyntaxNode(kNodeCreateTablespace, NULL);
+    SyntaxNodeAddChildren($$, $3);
+  }
+  | CREATE TABLESPACE name LOCATION STRING {
+    $$ = CreateSyntaxNode(kNodeCreateTablespace, NULL);
+    pSyntaxNode option_node = CreateSyntaxNode(kNodeOption, "location");
+    SyntaxNodeAddChildren(option_node, $5);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, option_node);
   }
   ;
 
 column_list:
-  IDENTIFIER ',' column_list {
+  name ',' column_list {
     $$ = $1;
     SyntaxNodeAddSibling($$, $3);
   }
-  | IDENTIFIER {
+  | name {
     $$ = $1;
   }
   ;
@@ -128,12 +330,22 @@ column_definition_list:
   ;
 
 column_definition:
-  IDENTIFIER column_type UNIQUE {
+  name column_type UNIQUE {
     $$ = CreateSyntaxNode(kNodeColumnDefinition, "unique");
     SyntaxNodeAddChildren($$, $1);
     SyntaxNodeAddChildren($$, $2);
   }
-  | IDENTIFIER column_type {
+  | name column_type AUTOINCREMENT {
+    $$ = CreateSyntaxNode(kNodeColumnDefinition, "auto_increment");
+    SyntaxNodeAddChildren($$, $1);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  | name column_type DICTIONARY {
+    $$ = CreateSyntaxNode(kNodeColumnDefinition, "dictionary");
+    SyntaxNodeAddChildren($$, $1);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  | name column_type {
     $$ = CreateSyntaxNode(kNodeColumnDefinition, NULL);
     SyntaxNodeAddChildren($$, $1);
     SyntaxNodeAddChildren($$, $2);
@@ -154,22 +366,23 @@ column_type:
   ;
 
 sql_drop_table:
-  DROP TABLE IDENTIFIER {
+  DROP TABLE name {
     $$ = CreateSyntaxNode(kNodeDropTable, NULL);
     SyntaxNodeAddChildren($$, $3);
   }
   ;
 
 sql_create_index:
-  CREATE INDEX IDENTIFIER ON IDENTIFIER '(' column_list ')' {
+  CREATE INDEX name ON name '(' column_list ')' table_options {
     $$ = CreateSyntaxNode(kNodeCreateIndex, NULL);
     SyntaxNodeAddChildren($$, $3);
     SyntaxNodeAddChildren($$, $5);
     pSyntaxNode index_keys_node = CreateSyntaxNode(kNodeColumnList, "index keys");
     SyntaxNodeAddChildren(index_keys_node, $7);
     SyntaxNodeAddChildren($$, index_keys_node);
+    SyntaxNodeAddChildren($$, $9);
   }
-  | CREATE INDEX IDENTIFIER ON IDENTIFIER '(' column_list ')' USING IDENTIFIER {
+  | CREATE INDEX name ON name '(' column_list ')' USING name table_options {
       $$ = CreateSyntaxNode(kNodeCreateIndex, NULL);
       SyntaxNodeAddChildren($$, $3);
       SyntaxNodeAddChildren($$, $5);
@@ -179,11 +392,12 @@ sql_create_index:
       pSyntaxNode index_type_node = CreateSyntaxNode(kNodeIndexType, "index type");
       SyntaxNodeAddChildren(index_type_node, $10);
       SyntaxNodeAddChildren($$, index_type_node);
+      SyntaxNodeAddChildren($$, $11);
   }
   ;
 
 sql_drop_index:
-  DROP INDEX IDENTIFIER {
+  DROP INDEX name {
     $$ = CreateSyntaxNode(kNodeDropIndex, NULL);
     SyntaxNodeAddChildren($$, $3);
   }
@@ -196,12 +410,12 @@ sql_show_indexes:
   ;
 
 sql_select:
-  SELECT select_columns FROM IDENTIFIER {
+  SELECT select_columns FROM name {
     $$ = CreateSyntaxNode(kNodeSelect, NULL);
     SyntaxNodeAddChildren($$, $2);
     SyntaxNodeAddChildren($$, $4);
   }
-  | SELECT select_columns FROM IDENTIFIER WHERE where_conditions {
+  | SELECT select_columns FROM name WHERE where_conditions {
     $$ = CreateSyntaxNode(kNodeSelect, NULL);
     SyntaxNodeAddChildren($$, $2);
     SyntaxNodeAddChildren($$, $4);
@@ -242,7 +456,7 @@ connector:
   ;
 
 where_condition:
-  IDENTIFIER operator column_value {
+  name operator column_value {
     $$ = $2;
     SyntaxNodeAddChildren($$, $1);
     SyntaxNodeAddChildren($$, $3);
@@ -289,13 +503,18 @@ operator:
   ;
 
 sql_insert:
-  INSERT INTO IDENTIFIER VALUES '(' column_values ')' {
+  INSERT INTO name VALUES '(' column_values ')' {
     $$ = CreateSyntaxNode(kNodeInsert, NULL);
     SyntaxNodeAddChildren($$, $3);
     pSyntaxNode col_val_node = CreateSyntaxNode(kNodeColumnValues, NULL);
     SyntaxNodeAddChildren(col_val_node, $6);
     SyntaxNodeAddChildren($$, col_val_node);
   }
+  | INSERT INTO name sql_select {
+    $$ = CreateSyntaxNode(kNodeInsert, NULL);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, $4);
+  }
   ;
 
 column_values:
@@ -308,12 +527,20 @@ column_values:
   }
   ;
 
+sql_copy:
+  COPY name FROM STRING {
+    $$ = CreateSyntaxNode(kNodeCopy, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddChildren($$, $4);
+  }
+  ;
+
 sql_delete:
-  DELETE FROM IDENTIFIER {
+  DELETE FROM name {
     $$ = CreateSyntaxNode(kNodeDelete, NULL);
     SyntaxNodeAddChildren($$, $3);
   }
-  | DELETE FROM IDENTIFIER WHERE where_conditions {
+  | DELETE FROM name WHERE where_conditions {
     $$ = CreateSyntaxNode(kNodeDelete, NULL);
     SyntaxNodeAddChildren($$, $3);
     pSyntaxNode condition_node = CreateSyntaxNode(kNodeConditions, NULL);
@@ -323,14 +550,14 @@ sql_delete:
   ;
 
 sql_update:
-  UPDATE IDENTIFIER SET update_values {
+  UPDATE name SET update_values {
     $$ = CreateSyntaxNode(kNodeUpdate, NULL);
     SyntaxNodeAddChildren($$, $2);
     pSyntaxNode upd_values_node = CreateSyntaxNode(kNodeUpdateValues, NULL);
     SyntaxNodeAddChildren(upd_values_node, $4);
     SyntaxNodeAddChildren($$, upd_values_node);
   }
-  | UPDATE IDENTIFIER SET update_values WHERE where_conditions {
+  | UPDATE name SET update_values WHERE where_conditions {
     $$ = CreateSyntaxNode(kNodeUpdate, NULL);
     SyntaxNodeAddChildren($$, $2);
     // update values
@@ -355,7 +582,7 @@ update_values:
   ;
 
 update_value:
-  IDENTIFIER EQ column_value {
+  name EQ column_value {
     $$ = CreateSyntaxNode(kNodeUpdateValue, NULL);
     SyntaxNodeAddChildren($$, $1);
     SyntaxNodeAddChildren($$, $3);
@@ -393,8 +620,36 @@ sql_exec_file:
   }
   ;
 
+/* a name may be spelled like an option keyword, the keyword only means the option where one is expected */
+name:
+  IDENTIFIER { $$ = $1; }
+  | PAGESIZE { $$ = $1; }
+  | TABLESPACE { $$ = $1; }
+  | LOCATION { $$ = $1; }
+  | VACUUM { $$ = $1; }
+  | COPY { $$ = $1; }
+  | STORAGE { $$ = $1; }
+  | TRUNCATE { $$ = $1; }
+  | ENGINE { $$ = $1; }
+  | TEMPORARY { $$ = $1; }
+  | PARTITION { $$ = $1; }
+  | PARTITIONS { $$ = $1; }
+  | BY { $$ = $1; }
+  | LESS { $$ = $1; }
+  | THAN { $$ = $1; }
+  | MAXVALUE { $$ = $1; }
+  | ALTER { $$ = $1; }
+  | ADD { $$ = $1; }
+  | COLUMN { $$ = $1; }
+  | DEFAULT { $$ = $1; }
+  | AS { $$ = $1; }
+  | AUTOINCREMENT { $$ = $1; }
+  | DICTIONARY { $$ = $1; }
+  | CLUSTER { $$ = $1; }
+  ;
+
 %%
 int yyerror(char* error) {
 	MinisqlParserSetError(error);
 	return 0;
-}
\ No newline at end of file
+}
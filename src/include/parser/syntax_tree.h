@@ -43,7 +43,17 @@ typedef enum {
   kNodeIndexType,            /** type of index */
   kNodeTrxBegin,             /** begin transaction command */
   kNodeTrxCommit,            /** commit transaction command */
-  kNodeTrxRollback           /** rollback transaction command */
+  kNodeTrxRollback,          /** rollback transaction command */
+  kNodeOption,               /** named option of a statement, eg: page_size, tablespace, the value is its child */
+  kNodeCreateTablespace,     /** create tablespace command */
+  kNodeVacuumDB,             /** vacuum database command */
+  kNodeCopy,                 /** copy table from csv file command */
+  kNodeVacuumTable,          /** vacuum table command */
+  kNodeTruncateTable,        /** truncate table command */
+  kNodePartition,            /** partition definition, contains the partition identifier and its bound, "maxvalue" without bound */
+  kNodeAlterTable,           /** alter table command */
+  kNodeClusterTable,         /** cluster table using index command */
+  kNodeSet                   /** set command, changes a setting of the session */
 } SyntaxNodeType;
 
 /**
@@ -7,6 +7,7 @@
 
 #include "common/instance.h"
 #include "executor/plans/abstract_plan.h"
+#include "executor/plans/append_plan.h"
 #include "executor/plans/delete_plan.h"
 #include "executor/plans/index_scan_plan.h"
 #include "executor/plans/insert_plan.h"
@@ -52,6 +53,16 @@ class Planner {
 
   /** The maximum size allowed for VARCHAR columns */
   static constexpr const uint32_t MAX_VARCHAR_SIZE = 128;
+
+ private:
+  /** Scan one table for a select, by an index if one fits the conditions. */
+  AbstractPlanNodeRef PlanScan(const Schema *out_schema, const std::string &table_name,
+                               const std::shared_ptr<SelectStatement> &statement);
+
+  /**
+   * @return the partitions of a partitioned table that may hold rows for the predicate, the others are pruned
+   */
+  std::vector<TableInfo *> PrunePartitions(TableInfo *table_info, const AbstractExpressionRef &predicate);
 };
 
 #endif  // MINISQL_PLANNER_H
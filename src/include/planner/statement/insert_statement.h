@@ -6,8 +6,8 @@
 #define MINISQL_INSERT_STATEMENT_H
 
 #include "abstract_statement.h"
+#include "select_statement.h"
 
-class SelectStatement;
 class InsertStatement : public AbstractStatement {
  public:
   explicit InsertStatement(pSyntaxNode ast, ExecuteContext *context) : AbstractStatement(ast, context) {}
@@ -19,7 +19,8 @@ class InsertStatement : public AbstractStatement {
     switch (ast->type_) {
       case kNodeIdentifier: {
         TableInfo *info = nullptr;
-        if (context_->GetCatalog()->GetTable(ast->val_, info) != DB_SUCCESS) {
+        if (PartitionScheme::IsPartitionTableName(ast->val_) ||
+            context_->GetCatalog()->GetTable(ast->val_, info) != DB_SUCCESS) {
           std::stringstream error_info;
           error_info << "the table " << ast->val_ << " is not exist.";
           throw std::logic_error(error_info.str());
@@ -31,6 +32,11 @@ class InsertStatement : public AbstractStatement {
         MakeInsertValues(ast->child_);
         break;
       }
+      case kNodeSelect: {
+        select_ = std::make_shared<SelectStatement>(ast, context_);
+        select_->SyntaxTree2Statement(ast->child_);
+        break;
+      }
       default:
         throw std::logic_error("the ast_type is not supported in planner yet");
     }
@@ -64,7 +70,7 @@ class InsertStatement : public AbstractStatement {
   std::string table_name_;
 
   /** Bound Select statement, used in "insert into t1 select..." */
-  SelectStatement *select_ = nullptr;
+  std::shared_ptr<SelectStatement> select_ = nullptr;
 
   /** If raw insert, bound raw values. */
   std::vector<std::vector<AbstractExpressionRef>> raw_values_;
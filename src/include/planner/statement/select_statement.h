@@ -18,7 +18,8 @@ class SelectStatement : public AbstractStatement {
     switch (ast->type_) {
       case kNodeIdentifier: {
         TableInfo *info = nullptr;
-        if (context_->GetCatalog()->GetTable(ast->val_, info) != DB_SUCCESS) {
+        if (PartitionScheme::IsPartitionTableName(ast->val_) ||
+            context_->GetCatalog()->GetTable(ast->val_, info) != DB_SUCCESS) {
           std::stringstream error_info;
           error_info << "the table " << ast->val_ << " is not exist.";
           throw std::logic_error(error_info.str());
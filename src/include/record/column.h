@@ -1,9 +1,12 @@
 #ifndef MINISQL_COLUMN_H
 #define MINISQL_COLUMN_H
 
+#include <memory>
 #include <string>
 
 #include "common/macros.h"
+#include "record/dictionary.h"
+#include "record/field.h"
 #include "record/types.h"
 
 class Column {
@@ -30,6 +33,35 @@ class Column {
 
   TypeId GetType() const { return type_; }
 
+  /**
+   * @return the version of the schema that added the column by alter table, 0 for a column the table was created with
+   */
+  uint32_t GetVersion() const { return version_; }
+
+  /**
+   * @return the value of the column in rows written before it was added, nullptr for null
+   */
+  const Field *GetDefault() const { return default_.get(); }
+
+  void SetDefault(const Field *default_value) {
+    default_.reset(default_value == nullptr ? nullptr : new Field(*default_value));
+  }
+
+  /**
+   * @return true if tuples and index keys keep a code from the dictionary of the column in place of its char values,
+   * see Row
+   */
+  bool IsDictionaryEncoded() const { return dictionary_encoded_; }
+
+  void SetDictionaryEncoded() { dictionary_encoded_ = true; }
+
+  /**
+   * @return the dictionary of an encoded column, nullptr if none was attached, then its values are read as their codes
+   */
+  Dictionary *GetDictionary() const { return dictionary_.get(); }
+
+  void SetDictionary(std::shared_ptr<Dictionary> dictionary) { dictionary_ = std::move(dictionary); }
+
   uint32_t SerializeTo(char *buf) const;
 
   uint32_t GetSerializedSize() const;
@@ -38,6 +70,10 @@ class Column {
 
  private:
   static constexpr uint32_t COLUMN_MAGIC_NUM = 210928;
+  // a column added by alter table is followed by its version and its default
+  static constexpr uint32_t VERSIONED_COLUMN_MAGIC_NUM = 210929;
+  // a dictionary encoded column, always one the table was created with
+  static constexpr uint32_t ENCODED_COLUMN_MAGIC_NUM = 210930;
   std::string name_;
   TypeId type_;
   uint32_t len_{0};  // for char type this is the maximum byte length of the string data,
@@ -45,6 +81,10 @@ class Column {
   uint32_t table_ind_{0};  // column position in table
   bool nullable_{false};   // whether the column can be null
   bool unique_{false};     // whether the column is unique
+  uint32_t version_{0};    // version of the schema that added the column
+  std::unique_ptr<Field> default_;  // value of the column in older rows, nullptr for null
+  bool dictionary_encoded_{false};  // whether the values are stored as dictionary codes
+  std::shared_ptr<Dictionary> dictionary_;  // attached by the catalog, shared by the copies of the column
 };
 
 #endif  // MINISQL_COLUMN_H
@@ -0,0 +1,77 @@
+#ifndef MINISQL_DICTIONARY_H
+#define MINISQL_DICTIONARY_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "record/field.h"
+
+/**
+ * The dictionary of a dictionary encoded char column. Every distinct value of the column gets a code, its position
+ * in the dictionary, and tuples and index keys store the code in place of the value (see Row). Codes are handed out
+ * in the order the values first show up and never change, so the dictionary only grows.
+ *
+ * Values are appended to the catalog pages of the dictionary (see DictionaryPage) before their code is handed out, a
+ * tuple never refers to a code the pages do not know. Reading a value back takes no latch, the values live in chunks
+ * that never move once allocated.
+ */
+class Dictionary {
+ public:
+  /** Writes a new value behind the others in the catalog, false if it could not be written */
+  using Append = std::function<bool(const std::string &value)>;
+
+  explicit Dictionary(Append append);
+
+  /**
+   * Take over the values read back from the catalog, in the order of their codes.
+   */
+  void Load(const std::vector<std::string> &values);
+
+  /**
+   * @return the code of a char value, which is added to the dictionary if it has none yet. False if the dictionary
+   * is full or the value could not be written.
+   */
+  bool Encode(const Field &value, int32_t &code);
+
+  /**
+   * @return the code of a char value, false if the value is not in the dictionary
+   */
+  bool Lookup(const Field &value, int32_t &code) const;
+
+  /**
+   * @return a new char field holding the value of a code
+   */
+  Field *Decode(int32_t code) const;
+
+  /**
+   * @return the smallest value in the dictionary larger than the given one, nullptr if there is none
+   */
+  Field *FindCeiling(const Field &value) const;
+
+  /** @return the number of values in the dictionary */
+  inline uint32_t GetSize() const { return size_.load(std::memory_order_acquire); }
+
+ private:
+  const std::string &GetValue(int32_t code) const {
+    return chunks_[code / CHUNK_SIZE][code % CHUNK_SIZE];
+  }
+
+  static constexpr uint32_t CHUNK_SIZE = 256;
+
+ private:
+  Append append_;
+  // code -> value, a chunk is allocated when its first value is added
+  std::unique_ptr<std::string[]> chunks_[DICTIONARY_MAX_SIZE / CHUNK_SIZE];
+  std::atomic<uint32_t> size_{0};
+  // value -> code, only read and written under the latch
+  std::unordered_map<std::string, int32_t> codes_;
+  mutable std::mutex latch_;
+};
+
+#endif  // MINISQL_DICTIONARY_H
@@ -9,6 +9,19 @@
 #include "record/field.h"
 #include "record/schema.h"
 
+/**
+ * A char value of a row that is stored in an overflow chain (see OverflowPage). In the tuple the value takes its
+ * length with OVERFLOW_FLAG set, its first OVERFLOW_PREFIX_SIZE bytes and the id of the first page of the chain.
+ * A row read from a tuple holds the prefix in the field until the table heap resolves the value.
+ */
+struct OverflowRef {
+  uint32_t field_index_;
+  page_id_t first_page_id_;
+  uint32_t length_;
+  // the field holds the whole value, not only its prefix
+  bool resolved_;
+};
+
 /**
  *  Row format:
  * -------------------------------------------
@@ -19,7 +32,9 @@
  * | Field Nums | Null bitmap |
  * -------------------------------------------
  *
- *
+ * A value of a dictionary encoded column is written as its code (4 bytes, NULL_CODE for null), which the table heap
+ * adds to the dictionary before the row is stored (see Column::IsDictionaryEncoded). Without a dictionary attached to the column
+ * the value is read back as an int field holding the code, and such a field is written back as it is.
  */
 class Row {
  public:
@@ -35,6 +50,7 @@ class Row {
   }
 
   void destroy() {
+    overflows_.clear();
     if (!fields_.empty()) {
       for (auto field : fields_) {
         delete field;
@@ -64,6 +80,16 @@ class Row {
     for (auto &field : other.fields_) {
       fields_.push_back(new Field(*field));
     }
+    overflows_ = other.overflows_;
+  }
+
+  /**
+   * Row move function, takes over the fields of other
+   */
+  Row(Row &&other) noexcept
+      : rid_(other.rid_), fields_(std::move(other.fields_)), overflows_(std::move(other.overflows_)) {
+    other.fields_.clear();
+    other.overflows_.clear();
   }
 
   /**
@@ -75,6 +101,7 @@ class Row {
     for (auto &field : other.fields_) {
       fields_.push_back(new Field(*field));
     }
+    overflows_ = other.overflows_;
     return *this;
   }
 
@@ -83,7 +110,11 @@ class Row {
    */
   uint32_t SerializeTo(char *buf, Schema *schema) const;
 
-  uint32_t DeserializeFrom(char *buf, Schema *schema);
+  /**
+   * Read a row back. A row written before columns were added to the schema has fewer fields, the added columns get
+   * their defaults unless fill_defaults is false, then the row keeps the fields it was written with.
+   */
+  uint32_t DeserializeFrom(char *buf, Schema *schema, bool fill_defaults = true);
 
   /**
    * For empty row, return 0
@@ -107,10 +138,38 @@ class Row {
 
   inline size_t GetFieldCount() const { return fields_.size(); }
 
+  /**
+   * @return the values of this row kept in overflow chains, a field without one is serialized into the tuple
+   */
+  inline std::vector<OverflowRef> &GetOverflows() { return overflows_; }
+
+  inline const std::vector<OverflowRef> &GetOverflows() const { return overflows_; }
+
+  /** set in the serialized length of a char value that lives in an overflow chain */
+  static constexpr uint32_t OVERFLOW_FLAG = 1U << 31;
+
+  /** the code a null value of a dictionary encoded column is written as */
+  static constexpr int32_t NULL_CODE = -1;
+
  private:
+  /** @return the overflow chain of a field, or nullptr if it is kept in the tuple */
+  const OverflowRef *FindOverflow(uint32_t field_index) const;
+
+  /**
+   * @return the code of a value of a dictionary encoded column, which is in the dictionary already
+   */
+  int32_t GetCode(const Column *column, uint32_t field_index) const;
+
+  /**
+   * @return the number of fields written to a tuple. A null value takes no bytes and cannot be told apart when read
+   * back, so null fields of added columns without a default are left off the end and read back as the default.
+   */
+  uint32_t GetStoredFieldCount(const Schema *schema) const;
+
   static constexpr uint32_t ROW_MAGIC_NUM = 202306;
   RowId rid_{};
   std::vector<Field *> fields_; /** Make sure that all field ptr are destructed*/
+  std::vector<OverflowRef> overflows_;
 };
 
 #endif  // MINISQL_ROW_H
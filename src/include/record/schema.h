@@ -39,6 +39,17 @@ class Schema {
 
   inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
 
+  /**
+   * Append a column added by alter table, it comes with the next version of the schema. The rows written before
+   * keep their fields and read the default of the column in its place, see Row::DeserializeFrom.
+   */
+  void AddColumn(Column *column);
+
+  /**
+   * @return the number of times a column was added to the schema, 0 for a schema as it was created
+   */
+  uint32_t GetVersion() const;
+
   /**
    * Shallow copy schema, only used in index
    *
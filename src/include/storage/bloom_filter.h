@@ -0,0 +1,49 @@
+#ifndef MINISQL_BLOOM_FILTER_H
+#define MINISQL_BLOOM_FILTER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * A bloom filter over the keys of a sorted run of an LSM tree. A lookup that the filter rules out skips the run
+ * without reading any of its pages. The filter takes bits_per_key bits for every key it is built for and probes the
+ * number of bits that keeps false positives lowest for that size, about 1% at 10 bits per key. It is written next to
+ * its run and read back when the tree is opened.
+ */
+class BloomFilter {
+ public:
+  BloomFilter() = default;
+
+  /**
+   * Size an empty filter for the given number of keys.
+   */
+  BloomFilter(uint32_t key_count, uint32_t bits_per_key);
+
+  void Add(const std::string &key);
+
+  /**
+   * @return false if the key was never added, true if it may have been
+   */
+  bool MayContain(const std::string &key) const;
+
+  /** @return the bytes SerializeTo writes */
+  uint32_t GetSerializedSize() const;
+
+  void SerializeTo(char *buf) const;
+
+  /**
+   * Replace the filter with the one a SerializeTo call wrote.
+   */
+  void DeserializeFrom(const char *buf);
+
+ private:
+  static uint64_t Hash(const std::string &key);
+
+ private:
+  std::vector<uint64_t> bits_;
+  uint64_t bit_count_{0};
+  uint32_t probes_{1};
+};
+
+#endif  // MINISQL_BLOOM_FILTER_H
@@ -0,0 +1,159 @@
+#ifndef MINISQL_CLUSTERED_HEAP_H
+#define MINISQL_CLUSTERED_HEAP_H
+
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/rowid.h"
+#include "record/row.h"
+#include "record/schema.h"
+#include "storage/clustered_table.h"
+#include "storage/page_reclaimer.h"
+
+/**
+ * ClusteredHeap keeps the rows of a table created with STORAGE = clustered (see TableStorage::kClustered) in a
+ * ClusteredTable, ordered by the primary key of the table in the leaves of its tree. Its first page is a meta page
+ * (see ClusteredMetaPage) that names the trees of the table.
+ *
+ * Rows move between leaves as the tree splits and merges, so the row id of a row is not where it lives but a number
+ * from a sequence, cut into virtual pages of CLUSTERED_ROWS_PER_PAGE rows and a slot like the row ids of an LsmHeap.
+ * The row id tree of the table finds the row of a row id, and scans read the virtual pages in row id order: a delete
+ * or an update during a scan never moves a row the scan has yet to reach, or one it has read already. A scan in key
+ * order reads the primary tree in batches instead (see ReadKeyRange), an update that changes the primary key may move
+ * a row ahead of it there. The sequence
+ * is reserved CLUSTERED_ROW_ID_CACHE_SIZE numbers at a time in the meta page, so no row id comes back after a reopen.
+ *
+ * A delete is only marked in memory until it is applied, which removes the row from all trees. An update keeps the
+ * row id, one that changes the primary key moves the row to its new place in the tree.
+ */
+class ClusteredHeap {
+ public:
+  /**
+   * Create an empty heap with its primary key on the columns of key_map. Its trees take the index ids first_index_id
+   * and first_index_id + 1.
+   * @return nullptr if its meta page could not be allocated or a page can not hold a few rows of the schema
+   */
+  static ClusteredHeap *Create(BufferPoolManager *buffer_pool_manager, Schema *schema,
+                               const std::vector<uint32_t> &key_map, index_id_t first_index_id, uint32_t space_id);
+
+  /**
+   * Open the heap with the given meta page.
+   */
+  static ClusteredHeap *Open(BufferPoolManager *buffer_pool_manager, Schema *schema, page_id_t meta_page_id);
+
+  /**
+   * Insert a row under the next row id, its row id is set to it.
+   * @return false if the row is too large or its primary key is taken
+   */
+  bool InsertTuple(Row &row);
+
+  /**
+   * Hide a row from reads until the delete is applied or rolled back.
+   * @return false if there is no such row
+   */
+  bool MarkDelete(const RowId &rid);
+
+  /**
+   * Replace a row that is not marked deleted, it keeps its row id.
+   * @return false if there is no such row, the row is too large or its new primary key is taken
+   */
+  bool UpdateTuple(Row &row, const RowId &rid);
+
+  void ApplyDelete(const RowId &rid);
+
+  void RollbackDelete(const RowId &rid);
+
+  /**
+   * Read the row with the row id of row into row.
+   * @return false if there is no such row or it is marked deleted
+   */
+  bool GetTuple(Row *row);
+
+  /**
+   * Read the row with the primary key given by the fields of key into row.
+   * @return false if there is no such row or it is marked deleted
+   */
+  bool GetTupleByKey(const Row &key, Row *row);
+
+  /**
+   * Read the next batch of at most CLUSTERED_ROWS_PER_PAGE rows in primary key order, from the key low on up to and
+   * including the key high, and put the visible ones into the front of rows. nullptr leaves a side open, the rows
+   * already in rows are reused.
+   * @param after skip the row with the key low, the last one of the batch before
+   * @param[out] last_key the primary key of the last row of the batch, visible or not, to read the next batch after
+   * @return false if the batch is empty, the range is read then
+   */
+  bool ReadKeyRange(const Row *low, bool after, const Row *high, std::vector<Row> &rows, size_t &row_count,
+                    Row &last_key);
+
+  /**
+   * Read the visible rows of a virtual page into the front of rows, the rows already in it are reused.
+   * @return the id of the next virtual page that has rows, or INVALID_PAGE_ID if there is none
+   */
+  page_id_t ReadPage(page_id_t page_id, std::vector<Row> &rows, size_t &row_count);
+
+  /**
+   * @return the ids of the virtual pages that have rows, in order
+   */
+  std::vector<page_id_t> GetPageIds();
+
+  /**
+   * @return the id of the meta page, which never changes
+   */
+  inline page_id_t GetMetaPageId() const { return meta_page_id_; }
+
+  /**
+   * @return the index ids of the primary tree and of the row id tree
+   */
+  inline std::vector<index_id_t> GetIndexIds() const { return {primary_index_id_, primary_index_id_ + 1}; }
+
+  /**
+   * @return the columns of the primary key
+   */
+  inline const std::vector<uint32_t> &GetKeyMap() const { return table_->GetKeyMap(); }
+
+  inline ClusteredTable *GetTable() { return table_.get(); }
+
+  /**
+   * Free the trees and the meta page. With a reclaimer their pages are handed to it, the roots are taken out of the
+   * index roots page before this returns either way.
+   */
+  void Destroy(PageReclaimer *reclaimer = nullptr);
+
+ private:
+  ClusteredHeap(BufferPoolManager *buffer_pool_manager, page_id_t meta_page_id, index_id_t primary_index_id,
+                ClusteredTable *table);
+
+  /**
+   * @return the primary key of a row, as the key of ClusteredTable::GetRow and RemoveRow
+   */
+  Row GetKey(const Row &row) const;
+
+  static bool SameKey(const Row &key, const Row &other);
+
+  /**
+   * @return the next row id, reserving more of them in the meta page if the reserved ones are used up. The caller holds
+   * the latch.
+   */
+  RowId NextRowId();
+
+  static RowId ToRowId(uint64_t sequence);
+
+ private:
+  BufferPoolManager *buffer_pool_manager_;
+  page_id_t meta_page_id_;
+  index_id_t primary_index_id_;
+  std::unique_ptr<ClusteredTable> table_;
+  // the trees of the table are not latched themselves, one operation at a time works on them
+  std::mutex latch_;
+  uint64_t next_sequence_{0};
+  uint64_t reserved_sequence_{0};
+  // rows whose delete is marked but not applied
+  std::unordered_set<int64_t> marked_;
+};
+
+#endif  // MINISQL_CLUSTERED_HEAP_H
@@ -0,0 +1,237 @@
+#ifndef MINISQL_CLUSTERED_TABLE_H
+#define MINISQL_CLUSTERED_TABLE_H
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "index/b_plus_tree.h"
+#include "index/generic_key.h"
+#include "record/row.h"
+#include "record/schema.h"
+#include "storage/page_reclaimer.h"
+
+/**
+ * ClusteredTable keeps the rows of a table in the leaves of a B+ tree on its primary key, an index-organized table,
+ * where a TableHeap keeps them apart from its primary key index. A lookup by key walks one tree down to the row, and a
+ * range of keys is read from neighbouring leaves in key order instead of from one random heap page for each row.
+ *
+ * The tree is a BPlusTree with a wide key. An entry holds the primary key, padded to its largest serialized size, and
+ * the row after it:
+ * ---------------------------------------------
+ * | Primary key (key_size_) | Row (row_size_) |
+ * ---------------------------------------------
+ * KeyManager compares the fields of the primary key in front only, so the tree orders the entries by key and carries
+ * the rows along. Internal pages keep the primary key of their separators only and have the fanout of a primary key
+ * index. The RowId values of the tree are unused.
+ *
+ * Rows move between leaves as the tree splits and merges, so a secondary index can not point at a RowId. Its entries
+ * are keyed by the secondary key followed by the primary key of the row, so rows may share a secondary key, and a
+ * lookup walks the entries of the secondary key and finds each row through the primary tree.
+ *
+ * A table stored this way behind a TableHeap (see ClusteredHeap) still hands out row ids. The row id tree keeps the
+ * row id a row was inserted with next to its primary key, and the row keeps it in its entry.
+ *
+ * Rows take no overflow chains here, each has to fit the largest size of its schema. The trees record their roots in
+ * the index roots page under the index ids given, the table opens again with the same ids.
+ */
+class ClusteredTable {
+ public:
+  /**
+   * Create an empty table with its primary key on the columns of key_map, or open it if the index roots page has a
+   * tree for index_id already.
+   * @return nullptr if a page can not hold a few rows of the schema
+   */
+  static ClusteredTable *Create(BufferPoolManager *buffer_pool_manager, Schema *schema,
+                                const std::vector<uint32_t> &key_map, index_id_t index_id,
+                                uint32_t space_id = DEFAULT_TABLESPACE_ID);
+
+  /**
+   * @return true if a page of the given size holds a few entries of a table of the schema with its primary key on the
+   * columns of key_map
+   */
+  static bool CanStore(uint32_t page_size, const Schema *schema, const std::vector<uint32_t> &key_map);
+
+  /**
+   * Add a secondary index on the columns of key_map, or open it as Create does. The rows in the table are indexed when
+   * it is new.
+   * @return DB_FAILED if a page can not hold a few keys
+   */
+  dberr_t CreateSecondaryIndex(const std::vector<uint32_t> &key_map, index_id_t index_id);
+
+  /**
+   * Add the row id tree, or open it as Create does. The rows in the table are indexed when it is new.
+   */
+  dberr_t CreateRowIdIndex(index_id_t index_id);
+
+  /**
+   * Insert a row into the primary tree and all secondary indexes, under the row id it carries.
+   * @return DB_FAILED if the row is too large or its primary key is taken, the table is left as it was then
+   */
+  dberr_t InsertRow(const Row &row, Transaction *txn);
+
+  /**
+   * Replace the row with the same primary key, the secondary indexes follow the keys that change. The row keeps the row
+   * id it was inserted with.
+   * @return DB_KEY_NOT_FOUND if there is no such row, DB_FAILED if the row is too large
+   */
+  dberr_t UpdateRow(const Row &row, Transaction *txn);
+
+  /**
+   * Remove the row with the primary key given by the fields of key.
+   */
+  dberr_t RemoveRow(const Row &key, Transaction *txn);
+
+  /**
+   * Read the row with the primary key given by the fields of key.
+   */
+  dberr_t GetRow(const Row &key, Row &row, Transaction *txn);
+
+  /**
+   * Append the rows with the key given by the fields of key in the secondary index index_id to rows, in primary key
+   * order.
+   */
+  dberr_t GetRowsBySecondary(index_id_t index_id, const Row &key, std::vector<Row> &rows, Transaction *txn);
+
+  /**
+   * Read the row with the given row id.
+   * @return DB_INDEX_NOT_FOUND if the table has no row id tree
+   */
+  dberr_t GetRowByRowId(const RowId &rid, Row &row, Transaction *txn);
+
+  /**
+   * Append the rows from low up to but not including high in key order to rows, nullptr leaves a side open.
+   * @param include_high take the row with the key high as well
+   * @param limit the most rows to append
+   */
+  dberr_t ScanRange(const Row *low, const Row *high, std::vector<Row> &rows, bool include_high = false,
+                    size_t limit = std::numeric_limits<size_t>::max());
+
+  /**
+   * Read the rows whose row ids are on the given page of row ids into the front of rows, in row id order, the rows
+   * already in it are reused. Each read starts from the root of the row id tree, so the trees may change in between.
+   * @return the next page of row ids that has rows, or INVALID_PAGE_ID if there is none
+   */
+  page_id_t ReadRowIdPage(page_id_t page_id, std::vector<Row> &rows, size_t &row_count, Transaction *txn);
+
+  /**
+   * @return the pages of row ids that have rows, in order
+   */
+  std::vector<page_id_t> GetRowIdPages();
+
+  /**
+   * Free the pages of all trees and take their roots out of the index roots page. With a reclaimer the pages are
+   * handed to it instead, the roots are gone before this returns either way.
+   */
+  void Destroy(PageReclaimer *reclaimer = nullptr);
+
+  /**
+   * @return the columns of the primary key
+   */
+  inline const std::vector<uint32_t> &GetKeyMap() const { return primary_->key_map_; }
+
+  /**
+   * @return the bytes an entry of the primary tree takes, without its RowId
+   */
+  inline uint32_t GetEntrySize() const { return primary_->entry_size_; }
+
+  /**
+   * @return the number of levels of the primary tree
+   */
+  inline int GetDepth() const { return primary_->tree_->GetDepth(); }
+
+ private:
+  /**
+   * A tree of the table with its key columns. Entries are the key padded to key_size_ and a payload of the rest of
+   * entry_size_: the row in the primary tree, the primary key in the row id tree. A secondary tree has the primary key
+   * columns behind its own in the key and no payload.
+   */
+  struct KeyTree {
+    index_id_t index_id_;
+    std::vector<uint32_t> key_map_;
+    // the leading key columns a lookup gives, the rest of a secondary key is the primary key
+    uint32_t lookup_count_;
+    std::unique_ptr<Schema> key_schema_;
+    uint32_t key_size_;
+    uint32_t entry_size_;
+    std::unique_ptr<KeyManager> processor_;
+    std::unique_ptr<BPlusTree> tree_;
+  };
+
+  ClusteredTable(BufferPoolManager *buffer_pool_manager, Schema *schema, uint32_t space_id)
+      : buffer_pool_manager_(buffer_pool_manager), schema_(schema), space_id_(space_id) {}
+
+  /**
+   * Set up a tree for the columns of key_map, its root is allocated if the index roots page has none for index_id.
+   * @param key_schema the schema of the key, the tree takes it over
+   * @return nullptr if a page can not hold a few entries, true in is_new if the tree is new
+   */
+  std::unique_ptr<KeyTree> OpenTree(const std::vector<uint32_t> &key_map, Schema *key_schema, index_id_t index_id,
+                                    uint32_t payload_size, bool *is_new);
+
+  /**
+   * @return true if a page of the given size holds a few entries of a tree with keys and entries of the given sizes
+   */
+  static bool FitsPage(uint32_t page_size, uint32_t key_size, uint32_t entry_size);
+
+  /**
+   * Serialize the key of a row in a table tree into the front of the entry, padded with zeros to key_size_.
+   */
+  void WriteKey(const KeyTree &key_tree, const Row &row, char *entry) const;
+
+  /**
+   * Serialize the fields of key, which are the key columns already, into the front of the entry.
+   */
+  void WriteSearchKey(const KeyTree &key_tree, const Row &key, char *entry) const;
+
+  /**
+   * Build the entry of the row id tree for a row, the primary key of the row is its payload.
+   */
+  void WriteRowIdEntry(const Row &row, char *entry) const;
+
+  /**
+   * Serialize a row id as the key of the row id tree into the front of the entry.
+   */
+  void WriteRowIdKey(const RowId &rid, char *entry) const;
+
+  /**
+   * @return the first page of row ids from the given one on that has rows, or INVALID_PAGE_ID if there is none
+   */
+  page_id_t SeekRowIdPage(page_id_t page_id);
+
+  /**
+   * Insert the entries of a row into the row id tree and the secondary trees.
+   * @return false if an entry is taken, the entries inserted before it are removed again
+   */
+  bool InsertIndexEntries(const Row &row, Transaction *txn);
+
+  /**
+   * Remove the entries of a row from the row id tree and the secondary trees.
+   */
+  void RemoveIndexEntries(const Row &row, Transaction *txn);
+
+  /**
+   * @return less than, equal to or greater than 0 as the key columns of row order before, with or after the fields of
+   * key
+   */
+  static int CompareKey(const KeyTree &key_tree, const Row &row, const Row &key);
+
+  KeyTree *FindSecondary(index_id_t index_id);
+
+  /**
+   * @return the largest size a row of the schema serializes to
+   */
+  static uint32_t MaxSerializedSize(const Schema *schema);
+
+  static inline GenericKey *AsKey(char *entry) { return reinterpret_cast<GenericKey *>(entry); }
+
+ private:
+  BufferPoolManager *buffer_pool_manager_;
+  Schema *schema_;
+  uint32_t space_id_;
+  std::unique_ptr<KeyTree> primary_;
+  std::unique_ptr<KeyTree> row_ids_;
+  std::vector<std::unique_ptr<KeyTree>> secondaries_;
+};
+
+#endif  // MINISQL_CLUSTERED_TABLE_H
@@ -0,0 +1,47 @@
+#ifndef MINISQL_COLUMN_KERNELS_H
+#define MINISQL_COLUMN_KERNELS_H
+
+#include <cstdint>
+
+#include "common/compare_op.h"
+
+/**
+ * Scan kernels over the int and float minipages of column pages (see ColumnPage). A kernel works on the values of
+ * one page as a plain array together with a selection, a bitmap with a bit per slot in 64-bit words: filters clear
+ * the bits of the slots that do not pass, aggregates and projections read the slots whose bit is set. Words without
+ * a selected slot are skipped.
+ *
+ * Filters and sums compare and add four values at a time with SSE2, which every x86-64 cpu has, and fall back to
+ * scalar code elsewhere. Projections copy whole words of selected slots at once and pick the others bit by bit.
+ */
+class ColumnKernels {
+ public:
+  /**
+   * Keep the selected slots among the first count whose value compares true against the constant.
+   */
+  static void FilterInt(const int32_t *values, uint32_t count, CompareOp op, int32_t constant, uint64_t *selection);
+
+  static void FilterFloat(const float *values, uint32_t count, CompareOp op, float constant, uint64_t *selection);
+
+  /**
+   * Drop the slots set in bitmap, the nulls of a column for example, from the selection.
+   */
+  static void Exclude(const uint64_t *bitmap, uint32_t count, uint64_t *selection);
+
+  /** @return the number of selected slots among the first count */
+  static uint32_t Count(const uint64_t *selection, uint32_t count);
+
+  static int64_t SumInt(const int32_t *values, uint32_t count, const uint64_t *selection);
+
+  static double SumFloat(const float *values, uint32_t count, const uint64_t *selection);
+
+  /**
+   * Append the values of the selected slots to out in slot order.
+   * @return the number of values written
+   */
+  static uint32_t ProjectInt(const int32_t *values, uint32_t count, const uint64_t *selection, int32_t *out);
+
+  static uint32_t ProjectFloat(const float *values, uint32_t count, const uint64_t *selection, float *out);
+};
+
+#endif  // MINISQL_COLUMN_KERNELS_H
@@ -0,0 +1,83 @@
+#ifndef MINISQL_COLUMN_SCAN_H
+#define MINISQL_COLUMN_SCAN_H
+
+#include <functional>
+#include <vector>
+
+#include "common/dberr.h"
+#include "storage/column_kernels.h"
+#include "storage/table_heap.h"
+
+/**
+ * ColumnScan answers single-column questions about a table stored by column without building rows: it walks the
+ * heap a page at a time, starts from the visible slots of the page, narrows them down with the filters and then
+ * counts, sums or projects one column of what is left. Only the minipages of the columns involved are read.
+ *
+ * Filters and aggregates take int and float columns, a null never passes a filter and is not summed.
+ */
+class ColumnScan {
+ public:
+  ColumnScan(TableHeap *table_heap, Transaction *txn);
+
+  /**
+   * Keep only the rows whose value of the column compares true against the constant.
+   * @return DB_FAILED if the heap is not stored by column, or the column is not an int or float column of the type
+   * of the constant
+   */
+  dberr_t AddFilter(uint32_t column_index, CompareOp op, const Field &constant);
+
+  /**
+   * @param[out] count the number of rows that pass the filters
+   */
+  dberr_t Count(uint64_t &count);
+
+  /**
+   * @param[out] sum the sum of the non-null values of the column over the rows that pass the filters
+   * @param[out] count the number of values summed
+   */
+  dberr_t Sum(uint32_t column_index, double &sum, uint64_t &count);
+
+  /**
+   * Collect the non-null values of an int column of the rows that pass the filters, in scan order.
+   */
+  dberr_t ProjectInt(uint32_t column_index, std::vector<int32_t> &values);
+
+  dberr_t ProjectFloat(uint32_t column_index, std::vector<float> &values);
+
+  /**
+   * Find the rows of one page of the heap that pass the filters, for a scan that reads the page by row afterwards.
+   * @param[out] selection a bit per slot of the page, set for the rows that pass
+   * @return the number of rows that pass
+   */
+  uint32_t SelectPage(page_id_t page_id, std::vector<uint64_t> &selection);
+
+ private:
+  struct Filter {
+    uint32_t column_index_;
+    CompareOp op_;
+    int32_t int_constant_;
+    float float_constant_;
+  };
+
+  /** @return true if the heap is stored by column and the column holds values of the type */
+  bool IsColumnOf(uint32_t column_index, TypeId type) const;
+
+  /**
+   * Narrow the visible slots of the page down to those that pass the filters and are not null in the column given.
+   * @return false if no slot of the page is visible
+   */
+  bool Select(ColumnPage *page, uint32_t column_index, uint64_t *selection);
+
+  /**
+   * Call func with every page of the heap and the selection of its rows that pass the filters, the nulls of the
+   * column given are dropped from the selection as well. The page stays pinned and latched meanwhile.
+   */
+  void ForEachPage(uint32_t column_index, const std::function<void(ColumnPage *, const uint64_t *)> &func);
+
+ private:
+  TableHeap *table_heap_;
+  [[maybe_unused]] Transaction *txn_;
+  std::vector<Filter> filters_;
+};
+
+#endif  // MINISQL_COLUMN_SCAN_H
@@ -0,0 +1,163 @@
+#ifndef MINISQL_COMPRESSED_BLOCK_H
+#define MINISQL_COMPRESSED_BLOCK_H
+
+#include <cstdint>
+#include <vector>
+
+#include "common/config.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+/**
+ * Writes values of any width up to 64 bits into a stream of bits, most significant bit first.
+ */
+class BitWriter {
+ public:
+  void Write(uint64_t value, uint32_t bits);
+
+  /** Drop the bits written after the first given ones */
+  void Truncate(size_t bits);
+
+  inline size_t GetBitCount() const { return bits_; }
+
+  inline const std::vector<uint8_t> &GetBytes() const { return bytes_; }
+
+ private:
+  std::vector<uint8_t> bytes_;
+  size_t bits_{0};
+};
+
+/**
+ * Reads back the values of a BitWriter.
+ */
+class BitReader {
+ public:
+  explicit BitReader(const char *data) : data_(reinterpret_cast<const uint8_t *>(data)) {}
+
+  uint64_t Read(uint32_t bits);
+
+  /** Read a value written with its low bits only, extending its sign */
+  int64_t ReadSigned(uint32_t bits);
+
+ private:
+  const uint8_t *data_;
+  size_t offset_{0};
+};
+
+/**
+ * The rows of a page of a compressed heap (see CompressedHeap), stored column by column. Each column has a bit stream
+ * of its own, encoded by its type:
+ *  - int: the first value as it is, then the change of the difference between neighbouring values (delta of delta)
+ *    in a prefix code: '0' for no change, '10', '110' and '1110' for 7, 9 and 12 bit changes, '1111' for any other.
+ *    Timestamps taken at a steady rate cost one bit a row.
+ *  - float: the first value as it is, then the XOR of each value with the one before (Gorilla): '0' for the same
+ *    value, '10' for a XOR whose meaningful bits fit into those of the XOR before, '11' with the count of its leading
+ *    zeros (5 bits), the count of its meaningful bits (5 bits) and the meaningful bits otherwise.
+ *  - char: the length (16 bits) and the bytes.
+ * A value of a nullable column starts with a bit that tells if it is null, a null value has no other bits. A column
+ * also keeps the number of its values that are not null and their minimum and maximum, so the bounds of a block are
+ * known without decoding it.
+ *
+ * Rows are never changed once in a block, a delete only sets the bit of the row in the deleted bitmap behind the
+ * streams. The row id of a row is the page of its block and its position in the block.
+ *
+ *  Format (size in byte):
+ *  ------------------------------------------------------------------------------------------
+ *  | RowCount (4) | Count_1 (4) | Min_1 (4) | Max_1 (4) | Bits_1 (4) | ... | Stream_1 | ... |
+ *  ------------------------------------------------------------------------------------------
+ *  | Deleted ((RowCount + 7) / 8) |
+ *  --------------------------------
+ */
+class CompressedBlock {
+ public:
+  explicit CompressedBlock(Schema *schema);
+
+  /**
+   * Add a row behind the others, unless the block would not fit into capacity bytes any more.
+   * @return false if the row does not fit, the block is left as it was
+   */
+  bool Append(const Row &row, uint32_t capacity);
+
+  /**
+   * Take over the rows of a block image written before, so that more rows can be appended to it.
+   */
+  void Load(const char *buf, uint32_t size);
+
+  /**
+   * Mark the row at slot as deleted.
+   */
+  void SetDeleted(uint32_t slot);
+
+  inline uint32_t GetRowCount() const { return row_count_; }
+
+  /** @return the number of bytes of the block image */
+  uint32_t GetSerializedSize() const;
+
+  void SerializeTo(char *buf) const;
+
+  /**
+   * Decode the rows of a block image into the front of rows, the rows already in it are reused. Their row ids are
+   * (page_id, slot).
+   * @param with_deleted whether deleted rows are read as well
+   * @return the number of rows read
+   */
+  static size_t Decode(const char *buf, Schema *schema, page_id_t page_id, std::vector<Row> &rows,
+                       bool with_deleted = false);
+
+  /**
+   * Read the smallest and the largest value of every column of a block image into min_row and max_row, a column
+   * without values is null in both. Only char columns are decoded, the bounds of the others are in the header.
+   */
+  static void ReadBounds(const char *buf, Schema *schema, Row &min_row, Row &max_row);
+
+  static bool IsDeleted(const char *buf, Schema *schema, uint32_t slot);
+
+  /**
+   * Mark the row at slot of a block image as deleted.
+   */
+  static void SetDeleted(char *buf, Schema *schema, uint32_t slot);
+
+ private:
+  /** what a column stream needs to know to encode its next value */
+  struct ColumnState {
+    uint32_t count_{0};
+    // the last value not null, the bits of a float
+    int64_t prev_{0};
+    int64_t prev_delta_{0};
+    // the meaningful bits of the last XOR of a float column
+    uint32_t leading_{0};
+    uint32_t trailing_{0};
+    bool window_{false};
+    int32_t int_min_{0};
+    int32_t int_max_{0};
+    float float_min_{0};
+    float float_max_{0};
+  };
+
+  void AppendValue(uint32_t column_index, const Field &field);
+
+  /** @return a new field holding the next value of a column stream */
+  static Field *ReadValue(BitReader &reader, const Column *column, ColumnState &state);
+
+  static void WriteDeltaOfDelta(BitWriter &stream, int64_t delta_of_delta);
+
+  static int64_t ReadDeltaOfDelta(BitReader &reader);
+
+  static void WriteXor(BitWriter &stream, uint32_t value, ColumnState &state);
+
+  static uint32_t ReadXor(BitReader &reader, uint32_t prev, uint32_t &leading, uint32_t &trailing);
+
+  /** @return the offset of the deleted bitmap of a block image */
+  static uint32_t GetDeletedOffset(const char *buf, uint32_t column_count);
+
+  static constexpr uint32_t SIZE_COLUMN_HEADER = 16;
+
+ private:
+  Schema *schema_;
+  uint32_t row_count_{0};
+  std::vector<ColumnState> states_;
+  std::vector<BitWriter> streams_;
+  std::vector<uint8_t> deleted_;
+};
+
+#endif  // MINISQL_COMPRESSED_BLOCK_H
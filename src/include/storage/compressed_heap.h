@@ -0,0 +1,129 @@
+#ifndef MINISQL_COMPRESSED_HEAP_H
+#define MINISQL_COMPRESSED_HEAP_H
+
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/rowid.h"
+#include "page/compressed_block_page.h"
+#include "record/row.h"
+#include "record/schema.h"
+#include "storage/compressed_block.h"
+
+/**
+ * CompressedHeap keeps the rows of a table created with STORAGE = compressed (see TableStorage::kCompressed), an
+ * append-only table for series of readings. Its pages form a chain (see CompressedBlockPage), each holding a block of
+ * rows encoded by column (see CompressedBlock). Rows are appended to the block of the last page, which is written back
+ * after every insert. A block that has no room for the next row is sealed: it never changes again but for the deleted
+ * bits of its rows, and a new page is linked behind it. The row id of a row is the page of its block and its position
+ * in the block, so it never changes either.
+ *
+ * Rows can not be updated. A delete is only marked in memory until it is applied, which sets the deleted bit of the
+ * row in its block.
+ */
+class CompressedHeap {
+ public:
+  /**
+   * Create an empty heap whose pages live in the given tablespace.
+   * @return nullptr if its first page could not be allocated
+   */
+  static CompressedHeap *Create(BufferPoolManager *buffer_pool_manager, Schema *schema, uint32_t space_id);
+
+  /**
+   * Open the heap starting at the given page, the block of its last page takes the next rows.
+   */
+  static CompressedHeap *Open(BufferPoolManager *buffer_pool_manager, Schema *schema, page_id_t first_page_id);
+
+  /**
+   * Append a row behind the others, its row id is set to where it went.
+   * @return false if the row does not fit into an empty block or no page could be allocated
+   */
+  bool InsertTuple(Row &row);
+
+  /**
+   * Append a batch of rows, writing the block of the last page once at the end.
+   * @return false if a row could not be appended, the rows before it stay in the heap
+   */
+  bool InsertTuples(std::vector<Row> &rows);
+
+  /**
+   * Hide a row from reads until the delete is applied or rolled back.
+   * @return false if there is no such row
+   */
+  bool MarkDelete(const RowId &rid);
+
+  void ApplyDelete(const RowId &rid);
+
+  void RollbackDelete(const RowId &rid);
+
+  /**
+   * Read the row with the row id of row into row.
+   * @return false if there is no such row or it is deleted
+   */
+  bool GetTuple(Row *row);
+
+  /**
+   * Decode the visible rows of a block into the front of rows, the rows already in it are reused.
+   * @return the id of the page after it, or INVALID_PAGE_ID for the last one
+   */
+  page_id_t ReadPage(page_id_t page_id, std::vector<Row> &rows, size_t &row_count);
+
+  /**
+   * Read the smallest and the largest values of each column of a block, see CompressedBlock::ReadBounds.
+   * @return false if the block has no rows
+   */
+  bool ReadBounds(page_id_t page_id, Row &min_row, Row &max_row);
+
+  /**
+   * @return the ids of all pages of the heap in chain order
+   */
+  std::vector<page_id_t> GetPageIds();
+
+  /**
+   * @return the id of the first page, which never changes, or INVALID_PAGE_ID once the heap is destroyed
+   */
+  inline page_id_t GetFirstPageId() const { return first_page_id_; }
+
+  uint32_t GetBlockCount() const;
+
+  /**
+   * Free all pages of the heap.
+   */
+  void Destroy();
+
+ private:
+  CompressedHeap(BufferPoolManager *buffer_pool_manager, Schema *schema);
+
+  /**
+   * Append a row to the open block, sealing it and starting a new one if the row does not fit. The caller holds the
+   * latch and writes the open block back.
+   */
+  bool AppendRow(Row &row);
+
+  /**
+   * Write the open block into the last page.
+   */
+  void WriteOpenBlock();
+
+  /** @return true if the delete of the row is marked and not applied yet */
+  bool IsMarked(const RowId &rid);
+
+ private:
+  BufferPoolManager *buffer_pool_manager_;
+  Schema *schema_;
+  uint32_t capacity_;
+  page_id_t first_page_id_{INVALID_PAGE_ID};
+  // the pages in chain order, the last one holds the open block
+  std::vector<page_id_t> page_ids_;
+  std::unique_ptr<CompressedBlock> open_block_;
+  mutable std::mutex latch_;
+  // rows whose delete is marked but not applied
+  std::unordered_set<int64_t> marked_;
+  std::mutex marked_latch_;
+};
+
+#endif  // MINISQL_COMPRESSED_HEAP_H
@@ -0,0 +1,124 @@
+#ifndef MINISQL_DISK_FILE_H
+#define MINISQL_DISK_FILE_H
+
+#include <mutex>
+#include <string>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "page/bitmap_page.h"
+#include "page/disk_file_meta_page.h"
+
+/**
+ * DiskFile manages the pages of a single data file: its meta page, the free page bitmaps and the data pages.
+ *
+ * Disk page storage format: (Free Page BitMap Size = (page_size - 8) * 8, we note it as N)
+ * | Meta Page | Free Page BitMap 1 | Page 1 | Page 2 | ....
+ *      | Page N | Free Page BitMap 2 | Page N+1 | ... | Page 2N | ... |
+ *
+ * Page reads and writes are positional, so they need no latch and run in parallel with each other; the latch only
+ * serializes changes to the allocation state.
+ *
+ * Instead of growing by one page whenever a write lands past the end of the file, the file space is reserved with
+ * fallocate in chunks of the growth size as soon as a page beyond the reserved space is allocated, which keeps the
+ * file contiguous on disk and spares the file system a size update per appended page.
+ */
+class DiskFile {
+ public:
+  DiskFile(const std::string &file_name, uint32_t page_size);
+
+  ~DiskFile();
+
+  /**
+   * @return true if a data file can be created with this page size
+   */
+  static bool IsValidPageSize(uint32_t page_size) {
+    return page_size == 4096 || page_size == 8192 || page_size == 16384 || page_size == 32768;
+  }
+
+  /**
+   * Read the page with the given page id within this file
+   */
+  void ReadPage(page_id_t logical_page_id, char *page_data);
+
+  /**
+   * Write the page with the given page id within this file
+   */
+  void WritePage(page_id_t logical_page_id, const char *page_data);
+
+  /**
+   * @return page id of a newly allocated page within this file, INVALID_PAGE_ID if the file is full
+   */
+  page_id_t AllocatePage();
+
+  void DeAllocatePage(page_id_t logical_page_id);
+
+  bool IsPageFree(page_id_t logical_page_id);
+
+  /**
+   * Keep exactly the pages [0, page_count) allocated, free every page after them and cut the file right after the
+   * last kept page. The caller is responsible for having moved all live data into the kept range.
+   * @return number of bytes the file shrank by
+   */
+  uint64_t Shrink(uint32_t page_count);
+
+  /**
+   * @return current size of the file in bytes
+   */
+  uint64_t GetFileSize();
+
+  uint32_t GetAllocatedPages() { return reinterpret_cast<DiskFileMetaPage *>(meta_data_)->GetAllocatedPages(); }
+
+  /**
+   * Set the number of bytes the file grows by at a time, 0 grows it page by page as pages get written.
+   */
+  void SetGrowthSize(uint64_t growth_size);
+
+  uint64_t GetGrowthSize() const { return growth_size_; }
+
+  /**
+   * Write back the meta page and close the file, called once on shut down.
+   */
+  void Close();
+
+  char *GetMetaData() { return meta_data_; }
+
+  const std::string &GetFileName() const { return file_name_; }
+
+  uint32_t GetPageSize() const { return page_size_; }
+
+  size_t GetBitmapSize() const { return bitmap_size_; }
+
+ private:
+  /**
+   * Invoke func with the bitmap page held in buffer, typed after the page size of this file
+   */
+  template <typename Func>
+  bool VisitBitmap(char *buffer, Func &&func);
+
+  void ReadPhysicalPage(page_id_t physical_page_id, char *page_data);
+
+  void WritePhysicalPage(page_id_t physical_page_id, const char *page_data);
+
+  page_id_t MapPageId(page_id_t logical_page_id) const;
+
+  /**
+   * Make sure the file has room for the physical page, reserving a whole chunk of the growth size if it has not.
+   */
+  void Reserve(page_id_t physical_page_id);
+
+ private:
+  std::string file_name_;
+  int fd_{-1};
+  // guards the meta page and the bitmap pages
+  std::recursive_mutex latch_;
+  bool closed_{false};
+  uint32_t page_size_;
+  size_t bitmap_size_;
+  char *meta_data_{nullptr};
+  uint64_t growth_size_{DEFAULT_FILE_GROWTH_SIZE};
+  // bytes of the file known to be backed by disk space, the file size unless fallocate is unavailable
+  uint64_t reserved_size_{0};
+};
+
+#endif  // MINISQL_DISK_FILE_H
@@ -2,27 +2,38 @@
 #define DISK_MGR_H
 
 #include <atomic>
-#include <fstream>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "common/config.h"
+#include "common/dberr.h"
 #include "common/macros.h"
 #include "page/bitmap_page.h"
 #include "page/disk_file_meta_page.h"
+#include "storage/disk_file.h"
 
 /**
  * DiskManager takes care of the allocation and de allocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
  *
- * Disk page storage format: (Free Page BitMap Size = PAGE_SIZE * 8, we note it as N)
- * | Meta Page | Free Page BitMap 1 | Page 1 | Page 2 | ....
- *      | Page N | Free Page BitMap 2 | Page N+1 | ... | Page 2N | ... |
+ * A database consists of the database file itself (tablespace 0) and any number of tablespaces created later, each
+ * of them a separate DiskFile with its own meta page and bitmaps, see DiskFile for the file format. The tablespace of
+ * a page is kept in the high bits of its page id:
+ * | 0 (1 bit) | tablespace id (7 bits) | page id inside the tablespace file (24 bits) |
+ * so every page of tablespace 0 keeps the id it had before tablespaces existed.
+ *
+ * Tablespaces are registered in a small text file next to the database file, one "id name path" line each,
+ * the path running to the end of the line so that it may hold spaces.
+ * The page size is chosen when the database file is created and recorded in its meta page, reopening an existing
+ * database always uses the recorded size regardless of the one passed to the constructor.
  */
 class DiskManager {
  public:
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, uint32_t page_size = PAGE_SIZE);
 
   ~DiskManager() {
     if (!closed) {
@@ -30,6 +41,31 @@ class DiskManager {
     }
   }
 
+  /**
+   * @return true if a database file can be created with this page size
+   */
+  static bool IsValidPageSize(uint32_t page_size) { return DiskFile::IsValidPageSize(page_size); }
+
+  /**
+   * @return the tablespace the page belongs to
+   */
+  static uint32_t GetTablespaceId(page_id_t page_id) { return static_cast<uint32_t>(page_id) >> TABLESPACE_PAGE_BITS; }
+
+  /**
+   * Remove the database file together with the files of all its tablespaces.
+   */
+  static void RemoveDatabaseFiles(const std::string &db_file);
+
+  /**
+   * @return the page size of this database in bytes
+   */
+  uint32_t GetPageSize() const { return files_[DEFAULT_TABLESPACE_ID]->GetPageSize(); }
+
+  /**
+   * @return the number of pages each extent of the database file can hold
+   */
+  size_t GetBitmapSize() const { return files_[DEFAULT_TABLESPACE_ID]->GetBitmapSize(); }
+
   /**
    * Read page from specific page_id
    * Note: page_id = 0 is reserved for free page bit map
@@ -44,9 +80,10 @@ class DiskManager {
 
   /**
    * Get next free page from disk
+   * @param space_id tablespace to place the page in
    * @return logical page id of allocated page
    */
-  page_id_t AllocatePage();
+  page_id_t AllocatePage(uint32_t space_id = DEFAULT_TABLESPACE_ID);
 
   /**
    * Free this page and reset bit map
@@ -59,47 +96,87 @@ class DiskManager {
   bool IsPageFree(page_id_t logical_page_id);
 
   /**
-   * Shut down the disk manager and close all the file resources.
+   * Create a tablespace backed by a new data file.
+   * @param path location of the data file, an empty path puts it next to the database file
+   * @param[out] space_id id of the new tablespace
+   * @return DB_ALREADY_EXIST if the name is taken or the data file already exists,
+   *         DB_FAILED if no more tablespaces can be created
    */
-  void Close();
+  dberr_t CreateTablespace(const std::string &name, const std::string &path, uint32_t &space_id);
 
   /**
-   * Get Meta Page
-   * Note: Used only for debug
+   * Look up a tablespace by name, the database file itself is named "default".
    */
-  char *GetMetaData() { return meta_data_; }
+  dberr_t GetTablespaceId(const std::string &name, uint32_t &space_id);
 
-  static constexpr size_t BITMAP_SIZE = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+  /**
+   * @return ids of all tablespaces of the database, including the database file itself
+   */
+  std::vector<uint32_t> GetTablespaceIds();
+
+  /**
+   * @return number of pages allocated in the tablespace
+   */
+  uint32_t GetAllocatedPages(uint32_t space_id);
 
- private:
   /**
-   * Helper function to get disk file size
+   * Keep only the first page_count pages of the tablespace and give the rest of its file back to the file system,
+   * see DiskFile::Shrink.
+   * @return number of bytes reclaimed
    */
-  int GetFileSize(const std::string &file_name);
+  uint64_t ShrinkTablespace(uint32_t space_id, uint32_t page_count);
 
   /**
-   * Read physical page from disk
+   * @return total size in bytes of the database file and all tablespace files
    */
-  void ReadPhysicalPage(page_id_t physical_page_id, char *page_data);
+  uint64_t GetFileSize();
 
   /**
-   * Write data to physical page in disk
+   * Set the number of bytes the data files grow by at a time, for the database file and every tablespace.
+   * 0 lets the files grow page by page as pages get written.
    */
-  void WritePhysicalPage(page_id_t physical_page_id, const char *page_data);
+  void SetGrowthSize(uint64_t growth_size);
+
+  uint64_t GetGrowthSize() const { return growth_size_; }
 
   /**
-   * Map logical page id to physical page id
+   * Shut down the disk manager and close all the file resources.
+   */
+  void Close();
+
+  /**
+   * Get Meta Page of the database file
+   * Note: Used only for debug
    */
-  page_id_t MapPageId(page_id_t logical_page_id);
+  char *GetMetaData() { return files_[DEFAULT_TABLESPACE_ID]->GetMetaData(); }
+
+  /** Extent capacity of a database file using the default page size */
+  static constexpr size_t BITMAP_SIZE = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+
+ private:
+  /**
+   * @return the file holding the page, the page id inside that file is returned through local_page_id
+   */
+  DiskFile *GetFile(page_id_t logical_page_id, page_id_t &local_page_id);
+
+  static std::string GetTablespaceFileName(const std::string &db_file) { return db_file + ".tablespaces"; }
+
+  void LoadTablespaces();
+
+  /** Read one line of the tablespace list. */
+  static bool ReadTablespaceEntry(std::istream &in, uint32_t &space_id, std::string &name, std::string &path);
+
+  void SaveTablespaces();
 
  private:
-  // stream to write db file
-  std::fstream db_io_;
   std::string file_name_;
-  // with multiple buffer pool instances, need to protect file access
-  std::recursive_mutex db_io_latch_;
+  // protects tablespace creation, page I/O never takes it
+  std::mutex space_latch_;
   bool closed{false};
-  char meta_data_[PAGE_SIZE];
+  uint64_t growth_size_{DEFAULT_FILE_GROWTH_SIZE};
+  // indexed by tablespace id, slots are filled once and never replaced while the database is open
+  std::unique_ptr<DiskFile> files_[MAX_TABLESPACES];
+  std::unordered_map<std::string, uint32_t> space_names_;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,98 @@
+#ifndef MINISQL_LSM_HEAP_H
+#define MINISQL_LSM_HEAP_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rowid.h"
+#include "record/row.h"
+#include "record/schema.h"
+#include "storage/lsm_tree.h"
+
+/**
+ * LsmHeap keeps the rows of a table created with ENGINE = lsm (see TableStorage::kLsm) in an LSM tree, keyed by a
+ * sequence number that grows with every insert and never comes back. The row id of a row is its sequence number cut
+ * into a virtual page of LSM_ROWS_PER_PAGE rows and a slot, and the key is the number in big-endian order, so a
+ * virtual page is a key range of the tree and scans read them in insert order the same way they read heap pages.
+ *
+ * An insert is a write into the memtable of the tree and touches no page. A delete is only marked in memory until it
+ * is applied, which writes a tombstone. Rows are never moved, an update writes the new row under the same key.
+ */
+class LsmHeap {
+ public:
+  /**
+   * Keep the rows in the given tree, the heap takes it over. Its last key tells where the sequence goes on.
+   */
+  LsmHeap(LsmTree *tree, Schema *schema);
+
+  /**
+   * Write a row under the next sequence number, its row id is set to it.
+   * @return false if the row does not fit into a page of the tree
+   */
+  bool InsertTuple(Row &row);
+
+  /**
+   * Hide a row from reads until the delete is applied or rolled back.
+   * @return false if there is no such row
+   */
+  bool MarkDelete(const RowId &rid);
+
+  /**
+   * Replace a row that is not marked deleted, it keeps its row id.
+   */
+  bool UpdateTuple(const Row &row, const RowId &rid);
+
+  void ApplyDelete(const RowId &rid);
+
+  void RollbackDelete(const RowId &rid);
+
+  /**
+   * Read the row with the row id of row into row.
+   * @return false if there is no such row or it is marked deleted
+   */
+  bool GetTuple(Row *row);
+
+  /**
+   * Read the visible rows of a virtual page into the front of rows, the rows already in it are reused.
+   * @return the id of the virtual page after it, or INVALID_PAGE_ID for the last one
+   */
+  page_id_t ReadPage(page_id_t page_id, std::vector<Row> &rows, size_t &row_count);
+
+  /**
+   * @return the ids of all virtual pages in order, some of them may have no rows left
+   */
+  std::vector<page_id_t> GetPageIds();
+
+  /**
+   * @return the id of the first virtual page, or INVALID_PAGE_ID if no row was ever inserted
+   */
+  page_id_t GetFirstPageId();
+
+  inline LsmTree *GetTree() { return tree_.get(); }
+
+ private:
+  static uint64_t ToSequence(const RowId &rid);
+
+  static RowId ToRowId(uint64_t sequence);
+
+  static std::string ToKey(uint64_t sequence);
+
+  static uint64_t FromKey(const std::string &key);
+
+  /** @return true if the delete of the row is marked and not applied yet */
+  bool IsMarked(uint64_t sequence);
+
+ private:
+  std::unique_ptr<LsmTree> tree_;
+  Schema *schema_;
+  std::atomic<uint64_t> next_sequence_{0};
+  // rows whose delete is marked but not applied
+  std::unordered_set<uint64_t> marked_;
+  std::mutex marked_latch_;
+};
+
+#endif  // MINISQL_LSM_HEAP_H
@@ -0,0 +1,229 @@
+#ifndef MINISQL_LSM_TREE_H
+#define MINISQL_LSM_TREE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "page/lsm_manifest_page.h"
+#include "storage/bloom_filter.h"
+#include "storage/disk_manager.h"
+#include "storage/page_reclaimer.h"
+
+/**
+ * What an LSM tree has on disk and how much work it did, for tests and benchmarks.
+ */
+struct LsmStats {
+  // runs and pages of every level, level 0 first
+  std::vector<uint32_t> level_runs_;
+  std::vector<uint32_t> level_pages_;
+  uint64_t flushes_{0};
+  uint64_t compactions_{0};
+  // run lookups a bloom filter answered without reading a page
+  uint64_t bloom_skips_{0};
+  // writes that waited for the previous memtable to be flushed
+  uint64_t write_stalls_{0};
+};
+
+/**
+ * An LSM tree maps byte string keys to byte string values, ordered by memcmp. It is the storage of a table created
+ * with ENGINE = lsm (see TableStorage::kLsm) and of the indexes of such a table (see LsmIndex), for tables that take
+ * far more writes than reads.
+ *
+ * Writes go into an in-memory sorted memtable only. A full memtable is frozen and a background thread writes it out
+ * as an immutable sorted run, a chain of LsmRunPage pages allocated and written one after another straight through
+ * the disk manager, so runs never pass through the buffer pool. Runs are leveled: level 0 takes flushed memtables
+ * until it holds LSM_L0_RUNS of them, then all of them are merged with level 1. Every deeper level is a sequence of
+ * runs in key order that do not overlap, each about as large as a memtable, and the level as a whole may grow
+ * LSM_LEVEL_RATIO times as large as the one above. A level that outgrows its size hands one run at a time to the next,
+ * taking turns through its key range. A merge reads and rewrites only the runs of the next level that overlap the
+ * runs it takes, so the write cost of a compaction does not grow with the size of the level below. A delete writes a
+ * tombstone that hides older values of its key until a merge into the deepest level drops it. Writers only wait when
+ * a memtable fills up before the previous one is on disk.
+ *
+ * A lookup reads the memtables and then the runs from new to old, each run is skipped unless its key range and its
+ * bloom filter may contain the key, and otherwise costs a single page read found with the first key of every page.
+ * Scans merge all sources in key order. Runs are reference counted, so readers keep the runs they started with while
+ * a compaction replaces them, and the pages of a replaced run are freed with its last reference.
+ *
+ * The runs of a tree are listed in its manifest (see LsmManifestPage), rewritten after every flush and compaction.
+ * Its first page names the tree and never moves. The page fences and the bloom filter of a run are written behind it
+ * in chains of their own, so opening a tree reads those and none of the run pages. Deleting a tree flushes its
+ * memtables the way a full one is flushed, nothing written is lost on a clean shutdown.
+ */
+class LsmTree {
+ public:
+  /**
+   * Create an empty tree whose pages all live in the given tablespace.
+   */
+  static LsmTree *Create(DiskManager *disk_manager, uint32_t space_id = DEFAULT_TABLESPACE_ID,
+                         size_t memtable_size = LSM_MEMTABLE_SIZE);
+
+  /**
+   * Open the tree of the given manifest page, reading the fences and filters of its runs.
+   */
+  static LsmTree *Open(DiskManager *disk_manager, page_id_t manifest_page_id,
+                       size_t memtable_size = LSM_MEMTABLE_SIZE);
+
+  ~LsmTree();
+
+  /**
+   * Write the value of a key, replacing the one it has.
+   * @return false if the entry does not fit into a run page
+   */
+  bool Put(const std::string &key, const std::string &value);
+
+  void Delete(const std::string &key);
+
+  /**
+   * @return true if the key has a value, it is copied into value
+   */
+  bool Get(const std::string &key, std::string *value);
+
+  /**
+   * Append the entries with keys in [low, high) to entries in key order, an empty high has no upper bound.
+   */
+  void Scan(const std::string &low, const std::string &high, std::vector<std::pair<std::string, std::string>> &entries);
+
+  /**
+   * @return true if any key was written, the largest one, deleted or not, is copied into key
+   */
+  bool GetLastKey(std::string *key);
+
+  /**
+   * Write the memtable out and wait until the background thread has nothing left to do.
+   */
+  void Flush();
+
+  /**
+   * Remove all entries at once. The runs are handed to the reclaimer, their pages are freed when it gets to them.
+   */
+  void Clear(PageReclaimer *reclaimer = nullptr);
+
+  /**
+   * Free all pages of the tree, its manifest included. Nothing is flushed when the tree is deleted afterwards.
+   */
+  void Destroy();
+
+  inline page_id_t GetManifestPageId() const { return manifest_page_ids_.front(); }
+
+  /** @return the largest key and value size together that Put accepts */
+  inline uint32_t GetMaxEntrySize() const { return max_entry_size_; }
+
+  LsmStats GetStats();
+
+ private:
+  struct Entry {
+    std::string value_;
+    bool deleted_;
+  };
+
+  using Memtable = std::map<std::string, Entry>;
+
+  struct Run;
+
+  // the runs of every level, level 0 newest first, replaced as a whole on every change
+  using Version = std::vector<std::vector<std::shared_ptr<Run>>>;
+
+  class Cursor;
+  class MemtableCursor;
+  class RunCursor;
+  class MergeCursor;
+
+  LsmTree(DiskManager *disk_manager, page_id_t manifest_page_id, size_t memtable_size);
+
+  void Write(const std::string &key, Entry entry);
+
+  /**
+   * Freeze the memtable for the background thread, waiting for the one frozen before, the caller holds the latch.
+   */
+  void RotateMemtable(std::unique_lock<std::mutex> &lock);
+
+  void BackgroundWork();
+
+  void StopBackgroundWork();
+
+  /**
+   * @return the level that has to be merged into the next one, or -1, the caller holds the latch
+   */
+  int PickCompaction() const;
+
+  /**
+   * Merge a level into the next one and install the result.
+   */
+  void Compact(int level);
+
+  /**
+   * Write the entries of a cursor into a new run, up to max_pages pages of them if that is not 0.
+   * @param drop_tombstones true if no older run can hold a value that a tombstone still has to hide
+   * @param key_count the keys to size the bloom filter for
+   * @return the run, or nullptr if no entry was left to write
+   */
+  std::shared_ptr<Run> WriteRun(Cursor &cursor, bool drop_tombstones, uint32_t key_count, size_t max_pages = 0);
+
+  /**
+   * Write the fence and filter chains of a run whose pages are written.
+   */
+  void WriteRunIndex(Run &run);
+
+  std::shared_ptr<Run> ReadRun(const LsmManifestPage::RunRecord &record);
+
+  /**
+   * Rewrite the manifest to list the runs of a version.
+   */
+  void WriteManifest(const Version &version);
+
+  void ReadManifest();
+
+  /** @return true if the run holds the key, found is set to the entry then */
+  bool FindInRun(const Run &run, const std::string &key, Entry *found, char *buf);
+
+  /** @return the size a level of one run may grow to before it is merged into the next */
+  uint64_t GetLevelTarget(size_t level) const;
+
+ private:
+  DiskManager *disk_manager_;
+  uint32_t space_id_;
+  uint32_t page_size_;
+  uint32_t max_entry_size_;
+  size_t memtable_size_;
+  // the pages a run of level 1 or deeper is cut at
+  size_t run_pages_;
+  // the manifest chain, the first page never changes
+  std::vector<page_id_t> manifest_page_ids_;
+  std::mutex manifest_latch_;
+
+  // guards the memtables, the version and the state of the background thread
+  std::mutex latch_;
+  Memtable memtable_;
+  size_t memtable_bytes_{0};
+  // the frozen memtable being flushed, if any
+  std::shared_ptr<const Memtable> immutable_;
+  std::shared_ptr<const Version> version_;
+  // wakes the background thread up
+  std::condition_variable work_cv_;
+  // wakes writers up that wait for the frozen memtable to be flushed
+  std::condition_variable writer_cv_;
+  // wakes up Flush and Clear when the background thread goes idle
+  std::condition_variable idle_cv_;
+  bool busy_{false};
+  bool stop_{false};
+  bool destroyed_{false};
+  std::thread thread_;
+  // the last key of the run each level handed to the next one, only the background thread uses them
+  std::vector<std::string> compact_keys_;
+
+  std::atomic<uint64_t> flushes_{0};
+  std::atomic<uint64_t> compactions_{0};
+  std::atomic<uint64_t> bloom_skips_{0};
+  std::atomic<uint64_t> write_stalls_{0};
+};
+
+#endif  // MINISQL_LSM_TREE_H
@@ -0,0 +1,96 @@
+#ifndef MINISQL_MEMORY_HEAP_H
+#define MINISQL_MEMORY_HEAP_H
+
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rowid.h"
+#include "record/row.h"
+
+/**
+ * MemoryHeap keeps the rows of a table stored in memory (see TableStorage::kMemory) as Row objects, so reading one
+ * takes no buffer pool pin, no slot lookup and no deserialization. The rows sit in chunks of ROWS_PER_CHUNK slots,
+ * which play the part of the pages of a table heap: a row id is the chunk and the slot of its row, and scans read a
+ * chunk at a time. Rows never move, a freed slot is reused by a later insert.
+ *
+ * Nothing of a memory heap is written to disk, its rows are gone once the heap is deleted.
+ */
+class MemoryHeap {
+ public:
+  MemoryHeap() = default;
+
+  /**
+   * Copy a row into a free slot, its row id is set to the slot.
+   */
+  void InsertTuple(Row &row);
+
+  /**
+   * Hide a row from reads until the delete is applied or rolled back.
+   * @return false if there is no such row
+   */
+  bool MarkDelete(const RowId &rid);
+
+  /**
+   * Replace a row that is not marked deleted, it keeps its row id.
+   */
+  bool UpdateTuple(const Row &row, const RowId &rid);
+
+  /**
+   * Free the slot of a row.
+   */
+  void ApplyDelete(const RowId &rid);
+
+  void RollbackDelete(const RowId &rid);
+
+  /**
+   * Copy the row with the row id of row into row.
+   * @return false if there is no such row or it is marked deleted
+   */
+  bool GetTuple(Row *row);
+
+  /**
+   * Copy the visible rows of a chunk into the front of rows, the rows already in it are reused.
+   * @return the id of the chunk after it, or INVALID_PAGE_ID for the last one
+   */
+  page_id_t ReadChunk(page_id_t chunk_id, std::vector<Row> &rows, size_t &row_count);
+
+  /**
+   * @return the ids of all chunks in order
+   */
+  std::vector<page_id_t> GetChunkIds();
+
+  /**
+   * @return the id of the first chunk, or INVALID_PAGE_ID if the heap has no chunk yet
+   */
+  page_id_t GetFirstChunkId();
+
+  /**
+   * Drop all rows and chunks.
+   */
+  void Clear();
+
+  static constexpr uint32_t ROWS_PER_CHUNK = 256;
+
+ private:
+  enum class SlotState : uint8_t { kFree, kLive, kDeleted };
+
+  struct Chunk {
+    Row rows_[ROWS_PER_CHUNK];
+    SlotState states_[ROWS_PER_CHUNK]{};
+  };
+
+  /** @return the slot of a row id, or nullptr if it is outside of the heap */
+  SlotState *FindSlot(const RowId &rid);
+
+ private:
+  std::vector<std::unique_ptr<Chunk>> chunks_;
+  // slots freed by deletes, taken before the chunks grow
+  std::vector<RowId> free_slots_;
+  // slots of the last chunk not used yet
+  uint32_t next_slot_{ROWS_PER_CHUNK};
+  std::shared_mutex latch_;
+};
+
+#endif  // MINISQL_MEMORY_HEAP_H
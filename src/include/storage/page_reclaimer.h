@@ -0,0 +1,57 @@
+#ifndef MINISQL_PAGE_RECLAIMER_H
+#define MINISQL_PAGE_RECLAIMER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * PageReclaimer frees the pages of dropped and truncated tables and indexes on a background thread, so that DROP and
+ * TRUNCATE only unlink them from the catalog and return at once, however large they are. A task handed over frees
+ * pages nothing refers to any more: the catalog already points elsewhere and no one else touches them, so the tasks
+ * need no latch beyond those of the buffer pool.
+ *
+ * Tasks run one after another in the order they came. The reclaimer finishes all of them before it is destroyed. If
+ * the database goes down first, the pages of the tasks left stay allocated until a VACUUM DATABASE releases them
+ * (see DatabaseVacuum), they are never reachable again.
+ */
+class PageReclaimer {
+ public:
+  PageReclaimer() = default;
+
+  ~PageReclaimer();
+
+  /**
+   * Queue a task that frees unreachable pages, the thread is started with the first one.
+   */
+  void Submit(std::function<void()> task);
+
+  /**
+   * Block until every task submitted so far has run.
+   */
+  void Wait();
+
+  /**
+   * @return the number of tasks submitted and not finished yet
+   */
+  size_t GetPendingCount();
+
+ private:
+  void Run();
+
+ private:
+  std::thread thread_;
+  std::mutex latch_;
+  // wakes the thread up for a new task or to stop
+  std::condition_variable task_cv_;
+  // wakes up the callers of Wait when the queue runs empty
+  std::condition_variable idle_cv_;
+  std::deque<std::function<void()>> tasks_;
+  // the task being run is still counted as pending
+  size_t pending_{0};
+  bool stop_{false};
+};
+
+#endif  // MINISQL_PAGE_RECLAIMER_H
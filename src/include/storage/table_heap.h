@@ -1,45 +1,163 @@
 #ifndef MINISQL_TABLE_HEAP_H
 #define MINISQL_TABLE_HEAP_H
 
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
+#include "page/column_page.h"
+#include "page/free_space_map_page.h"
 #include "page/header_page.h"
+#include "page/overflow_page.h"
 #include "page/table_page.h"
+#include "storage/clustered_heap.h"
+#include "storage/compressed_heap.h"
+#include "storage/lsm_heap.h"
+#include "storage/memory_heap.h"
 #include "storage/table_iterator.h"
+#include "storage/zone_map.h"
 #include "transaction/lock_manager.h"
 #include "transaction/log_manager.h"
 
 class TableIterator;
+
+/**
+ * How the pages of a table heap hold its rows: kRow puts each row into a slotted table page (see TablePage), kColumn
+ * splits the rows of a page into a minipage per column (see ColumnPage) for scans that read few columns. kMemory keeps
+ * the rows in memory only (see MemoryHeap), the heap has no pages at all. kLsm writes the rows into an LSM tree (see
+ * LsmHeap) for tables that take many more inserts than reads. kCompressed appends the rows to compressed blocks (see
+ * CompressedHeap) for series of readings that are never updated. kClustered keeps the rows in a B+ tree ordered by
+ * the primary key of the table (see ClusteredHeap).
+ */
+enum class TableStorage : uint32_t { kRow = 0, kColumn = 1, kMemory = 2, kLsm = 3, kCompressed = 4, kClustered = 5 };
+
+/**
+ * A table heap is a chain of table pages. Each heap keeps a free space map (see FreeSpaceMapPage) next to its pages,
+ * so an insert goes straight to a page with room instead of walking the chain, and a new page is linked behind the
+ * cached last page. The map is loaded into memory when the heap is opened and written through on every change.
+ *
+ * Each thread that inserts into a heap keeps the page it inserted into last as its target page and goes on with it
+ * while the row fits. The map only hands out pages no other thread holds as its target, so concurrent inserts latch
+ * different pages and only take the latch of the map to pick a page and to record its free space.
+ *
+ * A heap stored by column chains column pages instead. Its rows never move and a column page counts its free space
+ * in slots, otherwise both kinds of heap behave the same.
+ *
+ * A heap stored by row keeps char values longer than OVERFLOW_THRESHOLD out of its tuples, in overflow chains of
+ * their own (see OverflowPage), and moves out the longest of the shorter ones as well while a row does not fit into
+ * a page. The tuple keeps a short prefix and the first page of the chain, so tuples stay small and a scan that does
+ * not need a long column never reads its chains. Each value owns its chain: it is written with the tuple and freed
+ * when the tuple is updated or its delete is applied.
+ *
+ * Scans may skip pages with the zone map of the heap (see ZoneMap), every row written to a page widens its ranges.
+ *
+ * A heap stored in memory hands every operation to its MemoryHeap, whose chunks of rows stand in for the pages: the
+ * page ids of its row ids, of ReadPage and of GetPageIds are chunk ids. It has no free space map and no overflow
+ * chains, and its rows are lost when the heap is deleted.
+ *
+ * A heap stored in an LSM tree hands every operation to its LsmHeap the same way, with virtual pages of consecutive
+ * row ids in place of the chunks. Its first page id is the manifest of the tree, it has no free space map and no
+ * overflow chains either.
+ *
+ * A compressed heap hands every operation to its CompressedHeap, whose blocks are the pages of the heap. It has no
+ * free space map and no overflow chains, its rows can not be updated, and the zone map of its blocks is taken from
+ * their bounds without decoding them.
+ *
+ * A clustered heap hands every operation to its ClusteredHeap, with virtual pages of consecutive row ids like a heap
+ * in an LSM tree. Its first page id is the meta page of its trees, it has no free space map and no overflow chains.
+ */
 class TableHeap {
   friend class TableIterator;
+  friend class ColumnScan;
 
  public:
+  /**
+   * Create a new table heap whose pages all live in the given tablespace.
+   * @param cluster_key the primary key columns of a clustered heap, whose trees take the index ids from first_index_id
+   * on (see ClusteredHeap::Create)
+   */
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn,
-                           LogManager *log_manager, LockManager *lock_manager) {
-    auto *table_heap = new TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager);
-    auto first_page = static_cast<TablePage *>(table_heap->buffer_pool_manager_->NewPage(table_heap->first_page_id_));
+                           LogManager *log_manager, LockManager *lock_manager,
+                           uint32_t space_id = DEFAULT_TABLESPACE_ID, TableStorage storage = TableStorage::kRow,
+                           const std::vector<uint32_t> &cluster_key = {}, index_id_t first_index_id = 0) {
+    auto *table_heap = new TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager, storage);
+    if (storage == TableStorage::kMemory) {
+      table_heap->first_page_id_ = INVALID_PAGE_ID;
+      return table_heap;
+    }
+    if (storage == TableStorage::kLsm) {
+      auto *tree = LsmTree::Create(buffer_pool_manager->GetDiskManager(), space_id);
+      table_heap->first_page_id_ = tree->GetManifestPageId();
+      table_heap->lsm_heap_ = std::make_unique<LsmHeap>(tree, schema);
+      return table_heap;
+    }
+    if (storage == TableStorage::kCompressed) {
+      table_heap->compressed_heap_.reset(CompressedHeap::Create(buffer_pool_manager, schema, space_id));
+      assert(table_heap->compressed_heap_ != nullptr);
+      table_heap->first_page_id_ = table_heap->compressed_heap_->GetFirstPageId();
+      return table_heap;
+    }
+    if (storage == TableStorage::kClustered) {
+      table_heap->clustered_heap_.reset(
+          ClusteredHeap::Create(buffer_pool_manager, schema, cluster_key, first_index_id, space_id));
+      assert(table_heap->clustered_heap_ != nullptr);
+      table_heap->first_page_id_ = table_heap->clustered_heap_->GetMetaPageId();
+      return table_heap;
+    }
+    auto first_page = table_heap->buffer_pool_manager_->NewPage(table_heap->first_page_id_, space_id);
     assert(first_page != nullptr);
     first_page->WLatch();
-    first_page->Init(table_heap->first_page_id_, INVALID_PAGE_ID, table_heap->log_manager_, txn);
+    table_heap->InitPage(first_page, table_heap->first_page_id_, INVALID_PAGE_ID, txn);
     first_page->WUnlatch();
     table_heap->buffer_pool_manager_->UnpinPage(table_heap->first_page_id_, true);
+    table_heap->InitFreeSpaceMap(space_id);
     return table_heap;
   }
 
-  static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                           LogManager *log_manager, LockManager *lock_manager) {
-    return new TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager);
+  static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id,
+                           page_id_t free_space_map_page_id, Schema *schema, LogManager *log_manager,
+                           LockManager *lock_manager, TableStorage storage = TableStorage::kRow) {
+    auto *table_heap = new TableHeap(buffer_pool_manager, first_page_id, free_space_map_page_id, schema, log_manager,
+                                     lock_manager, storage);
+    // a heap stored in memory starts out empty every time its table is opened, one in an LSM tree reads its manifest
+    if (storage == TableStorage::kLsm) {
+      table_heap->lsm_heap_ =
+          std::make_unique<LsmHeap>(LsmTree::Open(buffer_pool_manager->GetDiskManager(), first_page_id), schema);
+    } else if (storage == TableStorage::kCompressed) {
+      table_heap->compressed_heap_.reset(CompressedHeap::Open(buffer_pool_manager, schema, first_page_id));
+    } else if (storage == TableStorage::kClustered) {
+      table_heap->clustered_heap_.reset(ClusteredHeap::Open(buffer_pool_manager, schema, first_page_id));
+    } else if (storage != TableStorage::kMemory) {
+      table_heap->LoadFreeSpaceMap();
+    }
+    return table_heap;
   }
 
   ~TableHeap() {}
 
   /**
-   * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
+   * Insert a tuple into the table. If the tuple is too large (>= page_size) even with its long values in overflow
+   * chains, return false.
    * @param[in/out] row Tuple Row to insert, the rid of the inserted tuple is wrapped in object row
    * @param[in] txn The transaction performing the insert
    * @return true iff the insert is successful
    */
   bool InsertTuple(Row &row, Transaction *txn);
 
+  /**
+   * Append a batch of tuples to the end of the table, filling the last page and then new pages one after another
+   * without consulting the free space map. Used by bulk loads.
+   * @param[in/out] rows Tuples to insert, the rid of every inserted tuple is wrapped in its row
+   * @param[in] txn The transaction performing the insert
+   * @return true iff all tuples were inserted, otherwise the tuples before the first failure stay in the table
+   */
+  bool BulkInsertTuples(std::vector<Row> &rows, Transaction *txn);
+
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
    * @param[in] rid Resource id of the tuple of delete
@@ -49,7 +167,9 @@ class TableHeap {
   bool MarkDelete(const RowId &rid, Transaction *txn);
 
   /**
-   * if the new tuple is too large to fit in the old page, return false (will delete and insert)
+   * Update a tuple, in its page if it fits there. A row that outgrows its page moves to another one and leaves a
+   * forwarding stub in its slot, so its row id stays valid and indexes need no change. A moved row that has to move
+   * again goes back to its home page if it fits there and otherwise replaces its old copy, stubs never chain.
    * @param[in] row Tuple of new row
    * @param[in] rid Rid of the old tuple
    * @param[in] txn Transaction performing the update
@@ -72,34 +192,64 @@ class TableHeap {
   void RollbackDelete(const RowId &rid, Transaction *txn);
 
   /**
-   * Read a tuple from the table.
+   * Read a tuple from the table, values kept in overflow chains included.
    * @param[in/out] row Output variable for the tuple, row id of the tuple is wrapped in row
    * @param[in] txn transaction performing the read
    * @return true if the read was successful (i.e. the tuple exists)
    */
   bool GetTuple(Row *row, Transaction *txn);
 
+  /**
+   * Read all visible tuples of one heap page.
+   * @param[out] rows buffer for the tuples, rows already in it are reused and it only grows
+   * @param[out] row_count number of tuples read into the front of rows
+   * @param columns the columns the caller reads, a value of another column that lives in an overflow chain is left
+   * as its prefix; empty reads all columns
+   * @param schema the schema a heap stored by row reads its tuples with, nullptr for that of the heap. A copy whose
+   * encoded columns have no dictionary reads their codes, see Row
+   * @return the id of the page behind it in the chain
+   */
+  page_id_t ReadPage(page_id_t page_id, std::vector<Row> &rows, size_t &row_count, Transaction *txn,
+                     const std::vector<bool> &columns = {}, Schema *schema = nullptr);
+
+  /**
+   * Free all pages of the heap: its chain, the overflow chains of its tuples and its free space map. A heap stored in
+   * memory drops its rows, one stored in an LSM tree frees the tree, a compressed one its blocks and a clustered one
+   * its trees.
+   */
   void FreeTableHeap() {
-    auto next_page_id = first_page_id_;
-    while (next_page_id != INVALID_PAGE_ID) {
-      auto old_page_id = next_page_id;
-      auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(old_page_id));
-      assert(page != nullptr);
-      next_page_id = page->GetNextPageId();
-      buffer_pool_manager_->UnpinPage(old_page_id, false);
-      buffer_pool_manager_->DeletePage(old_page_id);
+    if (storage_ == TableStorage::kMemory) {
+      memory_heap_->Clear();
+      return;
+    }
+    if (storage_ == TableStorage::kLsm) {
+      lsm_heap_->GetTree()->Destroy();
+      return;
+    }
+    if (storage_ == TableStorage::kCompressed) {
+      compressed_heap_->Destroy();
+      return;
+    }
+    if (storage_ == TableStorage::kClustered) {
+      clustered_heap_->Destroy();
+      return;
+    }
+    DeleteTable(first_page_id_);
+    for (auto page_id : fsm_page_ids_) {
+      buffer_pool_manager_->DeletePage(page_id);
     }
   }
 
   /**
-   * Free table heap and release storage in disk file
+   * Free the heap pages from the given one to the end of the chain, or the whole heap for INVALID_PAGE_ID.
    */
   void DeleteTable(page_id_t page_id = INVALID_PAGE_ID);
 
   /**
+   * @param columns the columns the scan reads, see ReadPage
    * @return the begin iterator of this table
    */
-  TableIterator Begin(Transaction *txn);
+  TableIterator Begin(Transaction *txn, const std::vector<bool> &columns = {});
 
   /**
    * @return the end iterator of this table
@@ -107,35 +257,274 @@ class TableHeap {
   TableIterator End();
 
   /**
-   * @return the id of the first page of this table
+   * @return the id of the first page of this table, the manifest of the tree for a heap stored in an LSM tree, the meta
+   * page of a clustered heap
    */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /**
+   * @return the id of the first page of the free space map of this table, INVALID_PAGE_ID for a heap without pages
+   */
+  inline page_id_t GetFreeSpaceMapPageId() const {
+    return fsm_page_ids_.empty() ? INVALID_PAGE_ID : fsm_page_ids_.front();
+  }
+
+  /**
+   * @return how the pages of this heap hold its rows
+   */
+  inline TableStorage GetStorage() const { return storage_; }
+
+  /**
+   * @return the trees of a clustered heap, nullptr for any other
+   */
+  inline ClusteredHeap *GetClusteredHeap() { return clustered_heap_.get(); }
+
+  /**
+   * @return the number of pages in this table heap
+   */
+  inline uint32_t GetPageCount() const {
+    return storage_ == TableStorage::kCompressed ? compressed_heap_->GetBlockCount() : heap_page_ids_.size();
+  }
+
+  /**
+   * @return the share of the heap's pages that is free space, as far as the free space map knows
+   */
+  double GetFreeSpaceRatio();
+
+  /**
+   * Compact the heap: the live tuples of every page are moved into the free space of the pages before it, the pages
+   * left over are rebuilt so their tuples take the first slots, and pages that end up empty are unlinked and freed.
+   * Pages with a delete that is not applied yet or with forwarded rows are left as they are. The first page is always
+   * kept. A heap stored by column or in memory is left as it is, its rows do not move.
+   * @param[out] moved_rids the old and the new row id of every tuple that moved, for the caller to fix up indexes
+   * @return the number of pages freed, heap and free space map pages together
+   */
+  uint32_t Vacuum(std::vector<std::pair<RowId, RowId>> &moved_rids, Transaction *txn);
+
+  /**
+   * @return the page directory of this heap, the ids of all its pages in chain order, so that scans can split the heap
+   * into page ranges
+   */
+  std::vector<page_id_t> GetPageIds();
+
+  /**
+   * @return the zone map of this heap, filled with a pass over the heap if no scan asked for it before
+   */
+  const ZoneMap &GetZoneMap(Transaction *txn);
+
 private:
   /**
    * create table heap and initialize first page
    */
   explicit TableHeap(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn,
-                     LogManager *log_manager, LockManager *lock_manager) :
+                     LogManager *log_manager, LockManager *lock_manager, TableStorage storage) :
           buffer_pool_manager_(buffer_pool_manager),
           schema_(schema),
+          zone_map_(schema),
           log_manager_(log_manager),
           lock_manager_(lock_manager) {
     first_page_id_ = 0;
+    InitStorage(storage);
   };
 
-  explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                     LogManager *log_manager, LockManager *lock_manager)
+  explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id,
+                     page_id_t free_space_map_page_id, Schema *schema, LogManager *log_manager,
+                     LockManager *lock_manager, TableStorage storage)
       : buffer_pool_manager_(buffer_pool_manager),
         first_page_id_(first_page_id),
+        fsm_page_ids_{free_space_map_page_id},
         schema_(schema),
+        zone_map_(schema),
         log_manager_(log_manager),
-        lock_manager_(lock_manager) {}
+        lock_manager_(lock_manager) {
+    InitStorage(storage);
+  }
+
+  /**
+   * Set up the page layout of a heap stored by column, once for all of its pages, or the rows of a heap in memory.
+   * The LSM tree, the compressed blocks and the trees of a clustered heap are set up by Create.
+   */
+  void InitStorage(TableStorage storage) {
+    storage_ = storage;
+    if (storage_ == TableStorage::kColumn) {
+      column_layout_ = std::make_unique<ColumnLayout>(schema_, buffer_pool_manager_->GetPageSize());
+    } else if (storage_ == TableStorage::kMemory) {
+      memory_heap_ = std::make_unique<MemoryHeap>();
+      fsm_page_ids_.clear();
+    } else if (storage_ == TableStorage::kLsm || storage_ == TableStorage::kCompressed ||
+               storage_ == TableStorage::kClustered) {
+      fsm_page_ids_.clear();
+    }
+  }
+
+  /**
+   * Format a new page of the heap, a table page or a column page depending on the storage.
+   */
+  void InitPage(Page *page, page_id_t page_id, page_id_t prev_id, Transaction *txn);
+
+  /**
+   * @return the free space of a latched page of the heap, in the units of the free space map
+   */
+  uint32_t GetFreeSpace(Page *page);
+
+  /**
+   * @return true if the row can go into an empty page of the heap at all
+   */
+  bool CanStore(const Row &row);
+
+  /**
+   * @return the free space the row takes up once inserted
+   */
+  uint32_t GetSpaceNeeded(const Row &row);
+
+  /**
+   * Insert a row into a latched page of the heap.
+   */
+  bool InsertInPage(Page *page, Row &row, Transaction *txn);
+
+  /**
+   * Create the free space map of a new heap, listing its first page.
+   */
+  void InitFreeSpaceMap(uint32_t space_id);
+
+  /**
+   * Read the free space map of an existing heap into memory.
+   */
+  void LoadFreeSpaceMap();
+
+  /**
+   * @return a heap page whose free space is known to be at least needed bytes and that is no thread's target page, or
+   * INVALID_PAGE_ID if there is none
+   */
+  page_id_t FindPageWithSpace(uint32_t needed);
+
+  /**
+   * @return the target page of the calling thread if the row fits into it, or else the page of the map it holds as its
+   * target from now on, a new one if no other page has room. INVALID_PAGE_ID if no page could be allocated.
+   */
+  page_id_t ClaimInsertionPage(uint32_t needed, Transaction *txn);
+
+  /**
+   * Link a new page behind the last page of the heap and add it to the free space map.
+   * @return the id of the new page, or INVALID_PAGE_ID if no page could be allocated
+   */
+  page_id_t AppendPage(Transaction *txn);
+
+  /**
+   * Record the free space of a heap page, writing the map page only if the category changes.
+   */
+  void UpdateFreeSpace(page_id_t page_id, uint32_t free_bytes);
+
+  /**
+   * Move an updated row that does not fit into its page any more, the caller holds no latch.
+   */
+  bool MoveTuple(Row &row, const RowId &rid, Transaction *txn);
+
+  /**
+   * Apply the delete of a tuple in its page, without following a forwarding stub.
+   * @return the free space left in the page
+   */
+  uint32_t DeleteInPage(const RowId &rid, Transaction *txn);
+
+  /**
+   * Replace the free space map with the given heap pages and their free space, freeing map pages no longer needed.
+   * @return the number of map pages freed
+   */
+  uint32_t RewriteFreeSpaceMap(const std::vector<page_id_t> &page_ids, const std::vector<uint32_t> &free_bytes);
+
+  /**
+   * Read the visible tuples of a latched page into the front of rows.
+   * @return the number of tuples read
+   */
+  size_t ReadLiveRows(TablePage *page, std::vector<Row> &rows, Transaction *txn, Schema *schema);
+
+  size_t ReadLiveRows(ColumnPage *page, std::vector<Row> &rows);
+
+  /**
+   * The single-page operations of a heap stored by column, the public ones call them.
+   */
+  bool MarkColumnDelete(const RowId &rid);
+
+  bool UpdateColumnTuple(Row &row, const RowId &rid);
+
+  void ApplyColumnDelete(const RowId &rid);
+
+  void RollbackColumnDelete(const RowId &rid);
+
+  bool GetColumnTuple(Row *row);
+
+  /**
+   * Update a tuple of a heap stored by row, whose long values are in their chains already.
+   */
+  bool UpdateRowTuple(Row &row, const RowId &rid, Transaction *txn);
+
+  /**
+   * Prepare a row for a heap stored by row: the values of its dictionary encoded columns get their codes, and its
+   * long values, and the longest others while it does not fit into a page, are written to new overflow chains that
+   * the row refers to from then on. Values the row only holds the prefix of are read first.
+   * @return false if no page could be allocated for a chain or a dictionary is full, the row then refers to no chain
+   */
+  bool ExternalizeValues(Row &row);
+
+  /**
+   * Free the chains a row refers to, for a row that was not stored after all.
+   */
+  void DropOverflows(Row &row);
+
+  /**
+   * Read the values a row holds only the prefix of, for the columns given or for all if columns is empty.
+   */
+  void ResolveOverflows(Row &row, const std::vector<bool> &columns);
+
+  /**
+   * Write a value into a new overflow chain in the tablespace of the heap.
+   * @return false if a page could not be allocated, nothing is left behind then
+   */
+  bool WriteOverflow(const char *data, uint32_t length, page_id_t &first_page_id);
+
+  void ReadOverflow(page_id_t first_page_id, uint32_t length, char *data);
+
+  void FreeOverflow(page_id_t first_page_id);
+
+  /**
+   * Collect the chains owned by the tuple of a row id, following its forwarding stub.
+   */
+  void GetTupleOverflows(const RowId &rid, std::vector<page_id_t> &first_page_ids);
+
+  /**
+   * Free the chains owned by the tuples of a page that is about to be freed.
+   */
+  void FreeOverflows(TablePage *page);
 
  private:
   BufferPoolManager *buffer_pool_manager_;
   page_id_t first_page_id_;
+  // the heap pages in chain order, the last one is where new pages get linked
+  std::vector<page_id_t> heap_page_ids_;
+  // free space map pages in chain order, the first one is recorded in the table meta
+  std::vector<page_id_t> fsm_page_ids_;
+  // heap page id -> position in the map
+  std::unordered_map<page_id_t, uint32_t> fsm_slots_;
+  // in-memory copy of the map's categories, and the heap pages ordered by category to find one with room quickly
+  std::vector<uint8_t> fsm_categories_;
+  std::set<std::pair<uint8_t, uint32_t>> pages_by_free_space_;
+  // the target page of each inserting thread and the set of them, see ClaimInsertionPage
+  std::unordered_map<std::thread::id, page_id_t> insertion_pages_;
+  std::unordered_set<page_id_t> claimed_pages_;
+  std::mutex fsm_latch_;
   Schema *schema_;
+  TableStorage storage_{TableStorage::kRow};
+  // where the minipages of a column page start, only for a heap stored by column
+  std::unique_ptr<ColumnLayout> column_layout_;
+  // the rows of a heap stored in memory
+  std::unique_ptr<MemoryHeap> memory_heap_;
+  // the rows of a heap stored in an LSM tree
+  std::unique_ptr<LsmHeap> lsm_heap_;
+  // the rows of a compressed heap
+  std::unique_ptr<CompressedHeap> compressed_heap_;
+  // the rows of a clustered heap
+  std::unique_ptr<ClusteredHeap> clustered_heap_;
+  ZoneMap zone_map_;
   [[maybe_unused]] LogManager *log_manager_;
   [[maybe_unused]] LockManager *lock_manager_;
 };
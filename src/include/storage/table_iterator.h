@@ -1,6 +1,8 @@
 #ifndef MINISQL_TABLE_ITERATOR_H
 #define MINISQL_TABLE_ITERATOR_H
 
+#include <vector>
+
 #include "common/rowid.h"
 #include "record/row.h"
 #include "table_heap.h"
@@ -8,15 +10,21 @@
 
 class TableHeap;
 
+/**
+ * TableIterator walks a table heap a page at a time: it pins a page once, decodes all of its visible tuples into a
+ * buffer and hands them out from there, then moves on to the next page of the chain. The buffer keeps its rows when
+ * the next page is decoded, so a scan does not allocate a row per tuple.
+ *
+ * The rows of a page are read when the iterator reaches the page, changes made to it later are not seen. An iterator
+ * given the columns it reads leaves the values of the other columns that live in overflow chains as their prefix.
+ */
 class TableIterator {
-public:
-  // you may define your own constructor based on your member variables
+ public:
   explicit TableIterator();
 
-  explicit TableIterator(const TableIterator &other);
-
-  explicit TableIterator(TableHeap *table_heap, Row row_, Transaction *txn_);
+  TableIterator(const TableIterator &other);
 
+  TableIterator(TableHeap *table_heap, page_id_t page_id, Transaction *txn, std::vector<bool> columns = {});
 
   virtual ~TableIterator();
 
@@ -28,17 +36,33 @@ public:
 
   Row *operator->();
 
-  TableIterator &operator=(const TableIterator &itr) noexcept;
+  TableIterator &operator=(const TableIterator &itr);
 
   TableIterator &operator++();
 
+  /**
+   * Postfix increment copies the buffered page, prefer ++iter.
+   */
   TableIterator operator++(int);
 
-private:
-  // add your own private member variables here
-  TableHeap *tableHeap;
-  Row row;
-  Transaction *txn;
+ private:
+  /**
+   * Decode the visible tuples of the page into the buffer, moving on along the chain while a page has none.
+   */
+  void LoadPage(page_id_t page_id);
+
+  RowId GetRowId() const { return pos_ < row_count_ ? rows_[pos_].GetRowId() : RowId(); }
+
+ private:
+  TableHeap *table_heap_{nullptr};
+  Transaction *txn_{nullptr};
+  // the columns read, empty for all
+  std::vector<bool> columns_;
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  // only the first row_count_ rows belong to the current page, the others wait to be reused
+  std::vector<Row> rows_;
+  size_t row_count_{0};
+  size_t pos_{0};
 };
 
 #endif  // MINISQL_TABLE_ITERATOR_H
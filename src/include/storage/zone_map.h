@@ -0,0 +1,82 @@
+#ifndef MINISQL_ZONE_MAP_H
+#define MINISQL_ZONE_MAP_H
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/compare_op.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+/**
+ * A zone map keeps the smallest and the largest value of every int, float and char column for each page of a table
+ * heap, so a scan can skip the pages whose ranges rule out its predicate. Char values are summarized by their first
+ * PREFIX_SIZE bytes, which every tuple keeps inline even when the value lives in an overflow chain.
+ *
+ * The ranges only ever widen: a row written to a page widens the ranges of the page, a deleted row leaves them as they
+ * are, so they cover the page but may be wider than needed. The map lives in memory only. The heap fills it with one
+ * pass over its pages the first time a scan asks for it (see TableHeap::GetZoneMap), and drops it when rows move
+ * between pages. Until a map is complete, every page may match.
+ */
+class ZoneMap {
+ public:
+  explicit ZoneMap(const Schema *schema);
+
+  /**
+   * Start filling an empty map, the rows written meanwhile already widen it.
+   * @return a number to finish the build with, 0 if another build is running or the map is complete
+   */
+  uint64_t StartBuild();
+
+  /**
+   * Mark the map complete, unless it was dropped since the build started.
+   */
+  void FinishBuild(uint64_t build);
+
+  /**
+   * Drop what the map knows, the next scan builds it again.
+   */
+  void Clear();
+
+  /**
+   * Widen the ranges of a page so that they cover the values of the row.
+   */
+  void Widen(page_id_t page_id, const Row &row);
+
+  /**
+   * @return false only if the map is complete and no row of the page can have a value of the column that compares
+   * true against the constant
+   */
+  bool MayMatch(page_id_t page_id, uint32_t column_index, CompareOp op, const Field &constant) const;
+
+  static constexpr uint32_t PREFIX_SIZE = OVERFLOW_PREFIX_SIZE;
+
+ private:
+  /** the range of one column in one page, empty while the page has no non-null value of the column */
+  struct Zone {
+    bool empty_{true};
+    int32_t int_min_{0};
+    int32_t int_max_{0};
+    float float_min_{0};
+    float float_max_{0};
+    std::string char_min_;
+    std::string char_max_;
+  };
+
+  enum class State { kEmpty, kBuilding, kComplete };
+
+  template <typename T>
+  static bool MayMatchRange(const T &min, const T &max, CompareOp op, const T &constant, bool prefix);
+
+ private:
+  std::vector<TypeId> types_;
+  std::unordered_map<page_id_t, std::vector<Zone>> zones_;
+  State state_{State::kEmpty};
+  // counts the builds, so a build that outlived a Clear does not complete the map
+  uint64_t build_{0};
+  mutable std::mutex latch_;
+};
+
+#endif  // MINISQL_ZONE_MAP_H
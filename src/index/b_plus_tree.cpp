@@ -1,6 +1,8 @@
 #include "index/b_plus_tree.h"
 
+#include <algorithm>
 #include <string>
+#include <utility>
 
 #include "glog/logging.h"
 #include "index/basic_comparator.h"
@@ -8,38 +10,120 @@
 #include "page/index_roots_page.h"
 
 BPlusTree::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager, const KeyManager &KM,
-                     int leaf_max_size, int internal_max_size)
+                     int leaf_max_size, int internal_max_size, uint32_t space_id, int internal_key_size)
     : index_id_(index_id),
       buffer_pool_manager_(buffer_pool_manager),
       processor_(KM),
       leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {
+      internal_max_size_(internal_max_size),
+      space_id_(space_id),
+      internal_key_size_(internal_key_size == UNDEFINED_SIZE ? KM.GetKeySize() : internal_key_size) {
   auto *indexRootsPage = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
   if(!indexRootsPage->GetRootId(index_id, &root_page_id_)){
     root_page_id_ = INVALID_PAGE_ID;
   }
   buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
-  BPlusTreeLeafPage *root_page = reinterpret_cast<BPlusTreeLeafPage *>(buffer_pool_manager_->FetchPage(root_page_id_));
-  root_page->Init(root_page_id_, INVALID_PAGE_ID, KM.GetKeySize(), leaf_max_size_);
-  internal_max_size_ = INTERNAL_PAGE_SIZE;
-  leaf_max_size_ = LEAF_PAGE_SIZE;
+  // fanout follows the page size of the database unless the caller asks for a specific one
+  if (internal_max_size_ == UNDEFINED_SIZE) {
+    internal_max_size_ = INTERNAL_PAGE_SIZE(buffer_pool_manager_->GetPageSize(), internal_key_size_);
+  }
+  if (leaf_max_size_ == UNDEFINED_SIZE) {
+    leaf_max_size_ = LEAF_PAGE_SIZE(buffer_pool_manager_->GetPageSize());
+  }
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  // the catalog hands over a blank root page for a new index, an existing tree is left untouched
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  auto *root_page = reinterpret_cast<BPlusTreeLeafPage *>(page->GetData());
+  bool blank = root_page->GetPageType() == IndexPageType::INVALID_INDEX_PAGE;
+  if (blank) {
+    root_page->Init(root_page_id_, INVALID_PAGE_ID, KM.GetKeySize(), leaf_max_size_);
+  }
+  buffer_pool_manager_->UnpinPage(root_page_id_, blank);
+}
+
+/*
+ * @return the number of levels from the root down to the leaves, 0 for an empty tree
+ */
+int BPlusTree::GetDepth() {
+  if (IsEmpty()) {
+    return 0;
+  }
+  int depth = 1;
+  page_id_t page_id = root_page_id_;
+  while (true) {
+    Page *page = buffer_pool_manager_->FetchPage(page_id);
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (node->IsLeafPage()) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      return depth;
+    }
+    page_id_t child_id = reinterpret_cast<InternalPage *>(node)->ValueAt(0);
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = child_id;
+    depth++;
+  }
 }
 
 void BPlusTree::Destroy(page_id_t current_page_id) {
-  Page *page = buffer_pool_manager_->FetchPage(current_page_id);
-  auto *node = reinterpret_cast<BPlusTreePage *>(page);
-  if(node->IsLeafPage()){ // 如果是叶子，直接删
-    buffer_pool_manager_->UnpinPage(current_page_id, true);
-    buffer_pool_manager_->DeletePage(current_page_id);
+  if(current_page_id == INVALID_PAGE_ID){ // 删除整棵树
+    if(IsEmpty()) return;
+    FreeTree(buffer_pool_manager_, root_page_id_);
+    root_page_id_ = INVALID_PAGE_ID;
+    auto *index_roots_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+    index_roots_page->Delete(index_id_);
+    buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
     return;
-  }else{  // 不是的话，先删孩子，然后删掉这一页
-    for(int i = 0; i < node->GetSize(); i++){
-      auto *internalPage = reinterpret_cast<BPlusTreeInternalPage *>(node);
-      page_id_t child_id = internalPage->ValueAt(i);
-      Destroy(child_id);
+  }
+  FreeTree(buffer_pool_manager_, current_page_id);
+}
+
+bool BPlusTree::Detach(PageReclaimer *reclaimer, bool new_root) {
+  page_id_t old_root_page_id = root_page_id_;
+  if (new_root) {
+    // 换上一个空的根，和新建的索引一样
+    page_id_t new_root_page_id;
+    Page *page = buffer_pool_manager_->NewPage(new_root_page_id, space_id_);
+    if (page == nullptr) {
+      return false;
     }
-    buffer_pool_manager_->UnpinPage(current_page_id, true);
-    buffer_pool_manager_->DeletePage(current_page_id);
+    reinterpret_cast<LeafPage *>(page->GetData())
+        ->Init(new_root_page_id, INVALID_PAGE_ID, processor_.GetKeySize(), leaf_max_size_);
+    buffer_pool_manager_->UnpinPage(new_root_page_id, true);
+    root_page_id_ = new_root_page_id;
+    UpdateRootPageId(old_root_page_id == INVALID_PAGE_ID ? 1 : 0);
+  } else if (old_root_page_id != INVALID_PAGE_ID) {
+    root_page_id_ = INVALID_PAGE_ID;
+    auto *index_roots_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+    index_roots_page->Delete(index_id_);
+    buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+  }
+  if (old_root_page_id == INVALID_PAGE_ID) {
+    return true;
+  }
+  // the task must not touch the tree object, the index may be dropped before it runs
+  BufferPoolManager *buffer_pool_manager = buffer_pool_manager_;
+  reclaimer->Submit([buffer_pool_manager, old_root_page_id] { FreeTree(buffer_pool_manager, old_root_page_id); });
+  return true;
+}
+
+void BPlusTree::FreeTree(BufferPoolManager *buffer_pool_manager, page_id_t root_page_id) {
+  std::vector<page_id_t> pages{root_page_id};
+  while (!pages.empty()) {
+    page_id_t page_id = pages.back();
+    pages.pop_back();
+    Page *page = buffer_pool_manager->FetchPage(page_id);
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    // 不是叶子的话，孩子也要删
+    if (!node->IsLeafPage()) {
+      auto *internal_page = reinterpret_cast<InternalPage *>(node);
+      for (int i = 0; i < node->GetSize(); i++) {
+        pages.push_back(internal_page->ValueAt(i));
+      }
+    }
+    buffer_pool_manager->UnpinPage(page_id, false);
+    buffer_pool_manager->DeletePage(page_id);
   }
 }
 
@@ -71,6 +155,71 @@ bool BPlusTree::GetValue(const GenericKey *key, std::vector<RowId> &result, Tran
   return is_find;
 }
 
+/*
+ * Replace the value associated with input key, the tree keeps its shape
+ * @return : true means key exists and was associated with old_value
+ */
+bool BPlusTree::UpdateValue(const GenericKey *key, const RowId &old_value, const RowId &new_value,
+                            Transaction *transaction) {
+  if (IsEmpty()) {
+    return false;
+  }
+  Page *page = FindLeafPage(key);
+  assert(page != nullptr);
+  auto *leaf = reinterpret_cast<BPlusTreeLeafPage *>(page->GetData());
+  int index = leaf->KeyIndex(key, processor_);
+  bool is_find = index < leaf->GetSize() && processor_.CompareKeys(key, leaf->KeyAt(index)) == 0 &&
+                 leaf->ValueAt(index) == old_value;
+  if (is_find) {
+    leaf->SetValueAt(index, new_value);
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), is_find);
+  return is_find;
+}
+
+/*
+ * Find the key equal to the input key in its leaf and copy all key_size bytes
+ * of it, the bytes the key manager does not compare included
+ * @return : true means key exists
+ */
+bool BPlusTree::GetKey(const GenericKey *key, GenericKey *result, Transaction *transaction) {
+  if (IsEmpty()) {
+    return false;
+  }
+  Page *page = FindLeafPage(key);
+  assert(page != nullptr);
+  auto *leaf = reinterpret_cast<BPlusTreeLeafPage *>(page->GetData());
+  int index = leaf->KeyIndex(key, processor_);
+  bool is_find = index < leaf->GetSize() && processor_.CompareKeys(key, leaf->KeyAt(index)) == 0;
+  if (is_find) {
+    memmove(result, leaf->KeyAt(index), processor_.GetKeySize());
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  return is_find;
+}
+
+/*
+ * Overwrite the key equal to the input key in its leaf, the order of the
+ * leaf does not change. Copies of it in internal pages keep their old bytes,
+ * only the compared ones matter there
+ * @return : true means key exists
+ */
+bool BPlusTree::ReplaceKey(GenericKey *key, Transaction *transaction) {
+  if (IsEmpty()) {
+    return false;
+  }
+  Page *page = FindLeafPage(key);
+  assert(page != nullptr);
+  auto *leaf = reinterpret_cast<BPlusTreeLeafPage *>(page->GetData());
+  int index = leaf->KeyIndex(key, processor_);
+  bool is_find = index < leaf->GetSize() && processor_.CompareKeys(key, leaf->KeyAt(index)) == 0;
+  if (is_find) {
+    leaf->SetKeyAt(index, key);
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), is_find);
+  return is_find;
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -89,6 +238,134 @@ bool BPlusTree::Insert(GenericKey *key, const RowId &value, Transaction *transac
     return InsertIntoLeaf(key, value, transaction);
   }
 }
+/*
+ * A blank root handed over by the catalog counts as an empty tree and is replaced by the one built.
+ */
+bool BPlusTree::BulkLoad(const std::vector<GenericKey *> &keys, const std::vector<RowId> &values,
+                         Transaction *transaction) {
+  bool has_root_record = !IsEmpty();
+  if (has_root_record) {
+    Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+    auto *root = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    bool blank = root->IsLeafPage() && root->GetSize() == 0;
+    buffer_pool_manager_->UnpinPage(root_page_id_, false);
+    if (!blank) {
+      return false;
+    }
+  }
+  if (keys.empty()) {
+    return true;
+  }
+  page_id_t root_page_id = BuildTree(keys, values);
+  if (root_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  if (has_root_record) {
+    buffer_pool_manager_->DeletePage(root_page_id_);
+  }
+  root_page_id_ = root_page_id;
+  UpdateRootPageId(has_root_record ? 0 : 1);
+  return true;
+}
+
+/*
+ * Build the tree from sorted pairs without a single key comparison: the leaves are filled from left to right, then
+ * every internal level is built on top of the one below until a level has one node, which becomes the root. Nodes
+ * of a level share the entries evenly, so none of them is less than half full.
+ */
+page_id_t BPlusTree::BuildTree(const std::vector<GenericKey *> &keys, const std::vector<RowId> &values) {
+  ASSERT(keys.size() == values.size(), "Every key needs a value.");
+  // every page built so far, freed again if one cannot be allocated
+  std::vector<page_id_t> built;
+  auto abandon = [this, &built] {
+    for (auto page_id : built) {
+      buffer_pool_manager_->DeletePage(page_id);
+    }
+    return INVALID_PAGE_ID;
+  };
+  // the page ids of the level being built and the smallest key below each of them
+  std::vector<page_id_t> level_pages;
+  std::vector<GenericKey *> level_keys;
+  int count = static_cast<int>(keys.size());
+  // no pairs make a blank root, like a new tree has
+  int node_count = std::max(1, (count + leaf_max_size_ - 1) / leaf_max_size_);
+  int pos = 0;
+  LeafPage *prev_leaf = nullptr;
+  for (int i = 0; i < node_count; i++) {
+    int size = count / node_count + (i < count % node_count ? 1 : 0);
+    page_id_t page_id;
+    Page *page = buffer_pool_manager_->NewPage(page_id, space_id_);
+    if (page == nullptr) {
+      if (prev_leaf != nullptr) {
+        buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+      }
+      return abandon();
+    }
+    built.push_back(page_id);
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    leaf->Init(page_id, INVALID_PAGE_ID, processor_.GetKeySize(), leaf_max_size_);
+    for (int j = 0; j < size; j++) {
+      leaf->SetKeyAt(j, keys[pos + j]);
+      leaf->SetValueAt(j, values[pos + j]);
+    }
+    leaf->SetSize(size);
+    if (prev_leaf != nullptr) {
+      prev_leaf->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+    }
+    prev_leaf = leaf;
+    level_pages.push_back(page_id);
+    level_keys.push_back(size > 0 ? keys[pos] : nullptr);
+    pos += size;
+  }
+  buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+  // an internal page splits once it reaches its max size, so it holds one child less
+  int fanout = internal_max_size_ - 1;
+  while (level_pages.size() > 1) {
+    std::vector<page_id_t> parent_pages;
+    std::vector<GenericKey *> parent_keys;
+    count = static_cast<int>(level_pages.size());
+    node_count = (count + fanout - 1) / fanout;
+    pos = 0;
+    for (int i = 0; i < node_count; i++) {
+      int size = count / node_count + (i < count % node_count ? 1 : 0);
+      page_id_t page_id;
+      Page *page = buffer_pool_manager_->NewPage(page_id, space_id_);
+      if (page == nullptr) {
+        return abandon();
+      }
+      built.push_back(page_id);
+      auto *node = reinterpret_cast<InternalPage *>(page->GetData());
+      node->Init(page_id, INVALID_PAGE_ID, internal_key_size_, internal_max_size_);
+      for (int j = 0; j < size; j++) {
+        node->SetKeyAt(j, level_keys[pos + j]);
+        node->SetValueAt(j, level_pages[pos + j]);
+        Page *child_page = buffer_pool_manager_->FetchPage(level_pages[pos + j]);
+        reinterpret_cast<BPlusTreePage *>(child_page->GetData())->SetParentPageId(page_id);
+        buffer_pool_manager_->UnpinPage(level_pages[pos + j], true);
+      }
+      node->SetSize(size);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      parent_pages.push_back(page_id);
+      parent_keys.push_back(level_keys[pos]);
+      pos += size;
+    }
+    level_pages = std::move(parent_pages);
+    level_keys = std::move(parent_keys);
+  }
+  return level_pages[0];
+}
+
+void BPlusTree::ReplaceTree(page_id_t root_page_id, PageReclaimer *reclaimer) {
+  page_id_t old_root_page_id = root_page_id_;
+  root_page_id_ = root_page_id;
+  UpdateRootPageId(old_root_page_id == INVALID_PAGE_ID ? 1 : 0);
+  if (old_root_page_id != INVALID_PAGE_ID) {
+    BufferPoolManager *buffer_pool_manager = buffer_pool_manager_;
+    reclaimer->Submit([buffer_pool_manager, old_root_page_id] { FreeTree(buffer_pool_manager, old_root_page_id); });
+  }
+}
+
 /*
  * Insert constant key & value pair into an empty tree
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
@@ -96,7 +373,7 @@ bool BPlusTree::Insert(GenericKey *key, const RowId &value, Transaction *transac
  * tree's root page id and insert entry directly into leaf page.
  */
 void BPlusTree::StartNewTree(GenericKey *key, const RowId &value) {
-  Page *root_page = buffer_pool_manager_->NewPage(root_page_id_);
+  Page *root_page = buffer_pool_manager_->NewPage(root_page_id_, space_id_);
   auto leaf_page = reinterpret_cast<BPlusTreeLeafPage *>(root_page->GetData());
   leaf_page->Init(root_page_id_, INVALID_PAGE_ID, processor_.GetKeySize(), leaf_max_size_);
   leaf_page->Insert(key, value, processor_);
@@ -142,9 +419,9 @@ bool BPlusTree::InsertIntoLeaf(GenericKey *key, const RowId &value, Transaction
  */
 BPlusTreeInternalPage *BPlusTree::Split(InternalPage *node, Transaction *transaction) {
   page_id_t new_page_id;
-  Page *new_page = buffer_pool_manager_->NewPage(new_page_id);
+  Page *new_page = buffer_pool_manager_->NewPage(new_page_id, space_id_);
   auto new_node = reinterpret_cast<InternalPage *>(new_page->GetData());
-  new_node->Init(new_page_id, node->GetParentPageId(), processor_.GetKeySize(), internal_max_size_);
+  new_node->Init(new_page_id, node->GetParentPageId(), internal_key_size_, internal_max_size_);
   node->MoveHalfTo(new_node, buffer_pool_manager_);
   buffer_pool_manager_->UnpinPage(new_page_id, true);
   return new_node;
@@ -152,7 +429,7 @@ BPlusTreeInternalPage *BPlusTree::Split(InternalPage *node, Transaction *transac
 
 BPlusTreeLeafPage *BPlusTree::Split(LeafPage *node, Transaction *transaction) {
   page_id_t new_page_id;
-  Page *new_page = buffer_pool_manager_->NewPage(new_page_id);
+  Page *new_page = buffer_pool_manager_->NewPage(new_page_id, space_id_);
   auto new_node = reinterpret_cast<LeafPage *>(new_page->GetData());
   new_node->Init(new_page_id, node->GetParentPageId(), processor_.GetKeySize(), leaf_max_size_);
   node->MoveHalfTo(new_node);
@@ -172,9 +449,9 @@ BPlusTreeLeafPage *BPlusTree::Split(LeafPage *node, Transaction *transaction) {
 void BPlusTree::InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlusTreePage *new_node,
                                  Transaction *transaction) {
   if(old_node->IsRootPage()){
-    Page *new_page = buffer_pool_manager_->NewPage(root_page_id_);
+    Page *new_page = buffer_pool_manager_->NewPage(root_page_id_, space_id_);
     auto *new_root = reinterpret_cast<InternalPage *>(new_page->GetData());
-    new_root->Init(root_page_id_, INVALID_PAGE_ID, processor_.GetKeySize(), internal_max_size_);
+    new_root->Init(root_page_id_, INVALID_PAGE_ID, internal_key_size_, internal_max_size_);
     new_root->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
     old_node->SetParentPageId(new_root->GetPageId());
     new_node->SetParentPageId(new_root->GetPageId());
@@ -257,13 +534,14 @@ bool BPlusTree::CoalesceOrRedistribute(N *&node, Transaction *transaction) {
     buffer_pool_manager_->UnpinPage(sibling_page->GetPageId(), true);
     return false; // no deletion
   }else{
+    // the merge may swap node and sibling, the pages to unpin stay the ones fetched here
+    page_id_t parent_page_id = parent_page->GetPageId();
     bool parent_need_del = Coalesce(sibling_node, node, parent_node, parent_index, transaction);
+    buffer_pool_manager_->UnpinPage(parent_page_id, true);
+    buffer_pool_manager_->UnpinPage(sibling_page_id, true);
     if(parent_need_del){
-      buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
       buffer_pool_manager_->DeletePage(parent_node->GetPageId());
     }
-    buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
-    buffer_pool_manager_->UnpinPage(sibling_page->GetPageId(), true);
     return true;
   }
 }
@@ -281,30 +559,13 @@ bool BPlusTree::CoalesceOrRedistribute(N *&node, Transaction *transaction) {
  */
 bool BPlusTree::Coalesce(LeafPage *&neighbor_node, LeafPage *&node, InternalPage *&parent, int index,
                          Transaction *transaction) {
+  // the right page always moves into the left one, so the keys stay in order and the left page keeps its
+  // predecessor in the leaf chain; the caller then deletes the right page through node
   if(index == 0){ // neighbor在右边
-    Page *first_page = FindLeafPage(node->KeyAt(1), INVALID_PAGE_ID, true);
-    LeafPage *first_node = reinterpret_cast<LeafPage*>(first_page->GetData());
-    if(node->GetPageId() != first_node->GetPageId()){
-      while(true){
-        if(first_node->GetNextPageId() == node->GetPageId()){
-          first_node->SetNextPageId(neighbor_node->GetPageId());
-          break;
-        }
-        page_id_t next_page_id = first_node->GetNextPageId();
-        Page *next_page = buffer_pool_manager_->FetchPage(next_page_id);
-        LeafPage *next_node = reinterpret_cast<LeafPage *>(next_page->GetData());
-        buffer_pool_manager_->UnpinPage(next_page_id, false);
-        first_node = next_node;
-      }
-    }
-    buffer_pool_manager_->UnpinPage(first_page->GetPageId(), false);
-    node->MoveAllTo(neighbor_node);
-    // first是value还是key?
-    parent->SetKeyAt(1, parent->KeyAt(0));
-
-  }else{
-    node->MoveAllTo(neighbor_node);
+    std::swap(neighbor_node, node);
+    index = 1;
   }
+  node->MoveAllTo(neighbor_node);
   parent->Remove(index);
   return CoalesceOrRedistribute(parent, transaction);
 }
@@ -312,12 +573,10 @@ bool BPlusTree::Coalesce(LeafPage *&neighbor_node, LeafPage *&node, InternalPage
 bool BPlusTree::Coalesce(InternalPage *&neighbor_node, InternalPage *&node, InternalPage *&parent, int index,
                          Transaction *transaction) {
   if(index == 0){
-    node->MoveAllTo(neighbor_node, parent->KeyAt(1), buffer_pool_manager_);
-    parent->SetKeyAt(1, parent->KeyAt(0));
-  }else{
-    node->MoveAllTo(neighbor_node, parent->KeyAt(index), buffer_pool_manager_);
-
+    std::swap(neighbor_node, node);
+    index = 1;
   }
+  node->MoveAllTo(neighbor_node, parent->KeyAt(index), buffer_pool_manager_);
   parent->Remove(index);
   return CoalesceOrRedistribute(parent, transaction);
 }
@@ -354,8 +613,7 @@ void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, in
     parent_page->SetKeyAt(1, neighbor_node->KeyAt(0));
     buffer_pool_manager_->UnpinPage(parent_page_id, true);
   }else{
-    GenericKey *mid_key = neighbor_node->KeyAt(neighbor_node->GetSize()-1);
-    neighbor_node->MoveLastToFrontOf(node, mid_key, buffer_pool_manager_);
+    neighbor_node->MoveLastToFrontOf(node, parent_page->KeyAt(index), buffer_pool_manager_);
     parent_page->SetKeyAt(index, node->KeyAt(0));
     buffer_pool_manager_->UnpinPage(parent_page_id, true);
   }
@@ -380,6 +638,12 @@ bool BPlusTree::AdjustRoot(BPlusTreePage *old_root_node) {
     page_id_t child_page_id = old_root->RemoveAndReturnOnlyChild();
     root_page_id_ = child_page_id;
     UpdateRootPageId(0);
+    // the child is the root now, and the old root goes
+    Page *child_page = buffer_pool_manager_->FetchPage(child_page_id);
+    reinterpret_cast<BPlusTreePage *>(child_page->GetData())->SetParentPageId(INVALID_PAGE_ID);
+    buffer_pool_manager_->UnpinPage(child_page_id, true);
+    buffer_pool_manager_->UnpinPage(old_root_node->GetPageId(), true);
+    return true;
   }else if(old_root_node->IsLeafPage() && old_root_node->GetSize() == 0){
     // case 2 直接删树
     root_page_id_ = INVALID_PAGE_ID;
@@ -425,10 +689,20 @@ IndexIterator BPlusTree::Begin(const GenericKey *key) {
  * @return : index iterator
  */
 IndexIterator BPlusTree::End() {
-  Page *page = FindLeafPage(nullptr, root_page_id_, false);
-  LeafPage *node = reinterpret_cast<LeafPage *>(page->GetData());
-  buffer_pool_manager_->UnpinPage(root_page_id_, false);
-  return IndexIterator(node->GetPageId(), buffer_pool_manager_, node->GetSize());
+  // 沿每层最右的孩子走到最右的叶子，迭代器走完所有叶子后停在它的末尾
+  page_id_t page_id = root_page_id_;
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (!node->IsLeafPage()) {
+    page_id_t child_page_id = reinterpret_cast<InternalPage *>(node)->ValueAt(node->GetSize() - 1);
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = child_page_id;
+    page = buffer_pool_manager_->FetchPage(page_id);
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  }
+  int size = node->GetSize();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return IndexIterator(page_id, buffer_pool_manager_, size);
 }
 
 /*****************************************************************************
@@ -469,7 +743,7 @@ Page *BPlusTree::FindLeafPage(const GenericKey *key, page_id_t page_id, bool lef
  */
 void BPlusTree::UpdateRootPageId(int insert_record) {
   Page *root_page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
-  IndexRootsPage *root_node = reinterpret_cast<IndexRootsPage *>(root_page);
+  IndexRootsPage *root_node = reinterpret_cast<IndexRootsPage *>(root_page->GetData());
   if(insert_record == 0){
     // update
     root_node->Update(index_id_, root_page_id_);
@@ -4,10 +4,10 @@
 #include "index/generic_key.h"
 #include "utils/tree_file_mgr.h"
 BPlusTreeIndex::BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size,
-                               BufferPoolManager *buffer_pool_manager)
+                               BufferPoolManager *buffer_pool_manager, uint32_t space_id)
     : Index(index_id, key_schema),
       processor_(key_schema_, key_size),
-      container_(index_id, buffer_pool_manager, processor_) {}
+      container_(index_id, buffer_pool_manager, processor_, UNDEFINED_SIZE, UNDEFINED_SIZE, space_id) {}
 
 dberr_t BPlusTreeIndex::InsertEntry(const Row &key, RowId row_id, Transaction *txn) {
   // ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
@@ -27,6 +27,47 @@ dberr_t BPlusTreeIndex::InsertEntry(const Row &key, RowId row_id, Transaction *t
   return DB_SUCCESS;
 }
 
+dberr_t BPlusTreeIndex::InsertSortedEntries(const std::vector<const Row *> &keys, Transaction *txn) {
+  // an empty tree is built bottom up, otherwise the entries go in one by one
+  std::unique_ptr<char[]> key_buf;
+  std::vector<GenericKey *> index_keys;
+  std::vector<RowId> row_ids;
+  SerializeSortedKeys(keys, key_buf, index_keys, row_ids);
+  if (container_.BulkLoad(index_keys, row_ids, txn)) {
+    return DB_SUCCESS;
+  }
+  for (size_t i = 0; i < index_keys.size(); i++) {
+    if (!container_.Insert(index_keys[i], row_ids[i], txn)) {
+      return DB_FAILED;
+    }
+  }
+  return DB_SUCCESS;
+}
+
+dberr_t BPlusTreeIndex::BuildSortedTree(const std::vector<const Row *> &keys, page_id_t &root_page_id) {
+  std::unique_ptr<char[]> key_buf;
+  std::vector<GenericKey *> index_keys;
+  std::vector<RowId> row_ids;
+  SerializeSortedKeys(keys, key_buf, index_keys, row_ids);
+  root_page_id = container_.BuildTree(index_keys, row_ids);
+  return root_page_id == INVALID_PAGE_ID ? DB_FAILED : DB_SUCCESS;
+}
+
+void BPlusTreeIndex::ReplaceTree(page_id_t root_page_id, PageReclaimer *reclaimer) {
+  container_.ReplaceTree(root_page_id, reclaimer);
+}
+
+void BPlusTreeIndex::SerializeSortedKeys(const std::vector<const Row *> &keys, std::unique_ptr<char[]> &key_buf,
+                                         std::vector<GenericKey *> &index_keys, std::vector<RowId> &row_ids) {
+  key_buf.reset(new char[keys.size() * processor_.GetKeySize()]);
+  for (size_t i = 0; i < keys.size(); i++) {
+    auto *index_key = reinterpret_cast<GenericKey *>(key_buf.get() + i * processor_.GetKeySize());
+    processor_.SerializeFromKey(index_key, *keys[i], key_schema_);
+    index_keys.push_back(index_key);
+    row_ids.push_back(keys[i]->GetRowId());
+  }
+}
+
 dberr_t BPlusTreeIndex::RemoveEntry(const Row &key, RowId row_id, Transaction *txn) {
   GenericKey *index_key = processor_.InitKey();
   processor_.SerializeFromKey(index_key, key, key_schema_);
@@ -36,7 +77,73 @@ dberr_t BPlusTreeIndex::RemoveEntry(const Row &key, RowId row_id, Transaction *t
   return DB_SUCCESS;
 }
 
+dberr_t BPlusTreeIndex::UpdateEntry(const Row &key, RowId old_row_id, RowId new_row_id, Transaction *txn) {
+  GenericKey *index_key = processor_.InitKey();
+  processor_.SerializeFromKey(index_key, key, key_schema_);
+
+  bool status = container_.UpdateValue(index_key, old_row_id, new_row_id, txn);
+  delete index_key;
+  if (!status) {
+    return DB_FAILED;
+  }
+  return DB_SUCCESS;
+}
+
 dberr_t BPlusTreeIndex::ScanKey(const Row &key, vector<RowId> &result, Transaction *txn, string compare_operator) {
+  // a value of an encoded column that is not in its dictionary has no code, no entry is equal to it and a range
+  // starts at the next larger value the dictionary has
+  for (uint32_t i = 0; i < key_schema_->GetColumnCount() && i < key.GetFieldCount(); i++) {
+    Dictionary *dictionary = key_schema_->GetColumn(i)->GetDictionary();
+    int32_t code;
+    if (dictionary == nullptr || key.GetField(i)->IsNull() || dictionary->Lookup(*key.GetField(i), code)) {
+      continue;
+    }
+    if (compare_operator == "=") {
+      return DB_KEY_NOT_FOUND;
+    }
+    if (compare_operator == "<>") {
+      for (auto iter = GetBeginIterator(); iter != GetEndIterator(); ++iter) {
+        result.emplace_back((*iter).second);
+      }
+      return result.empty() ? DB_KEY_NOT_FOUND : DB_SUCCESS;
+    }
+    // the ceiling of one column does not bound a key of several, so compare the key of every entry instead. The
+    // entries are in key order and none equals the key, the matches are those before it or those after it
+    if (key_schema_->GetColumnCount() != 1) {
+      bool lower = compare_operator == "<" || compare_operator == "<=";
+      for (auto iter = GetBeginIterator(); iter != GetEndIterator(); ++iter) {
+        Row entry_key(INVALID_ROWID);
+        processor_.DeserializeToKey((*iter).first, entry_key, key_schema_);
+        bool before = false;
+        for (uint32_t j = 0; j < key_schema_->GetColumnCount() && j < key.GetFieldCount(); j++) {
+          if (entry_key.GetField(j)->CompareLessThan(*key.GetField(j)) == CmpBool::kTrue) {
+            before = true;
+            break;
+          }
+          if (entry_key.GetField(j)->CompareGreaterThan(*key.GetField(j)) == CmpBool::kTrue) {
+            break;
+          }
+        }
+        if (before != lower) {
+          if (lower) {
+            break;
+          }
+          continue;
+        }
+        result.emplace_back((*iter).second);
+      }
+      return result.empty() ? DB_KEY_NOT_FOUND : DB_SUCCESS;
+    }
+    std::unique_ptr<Field> ceiling(dictionary->FindCeiling(*key.GetField(i)));
+    bool lower = compare_operator == "<" || compare_operator == "<=";
+    if (ceiling == nullptr) {
+      return lower ? ScanKey(key, result, txn, "<>") : DB_KEY_NOT_FOUND;
+    }
+    vector<Field> fields;
+    fields.emplace_back(*ceiling);
+    Row ceiling_key(fields);
+    return ScanKey(ceiling_key, result, txn, lower ? "<" : ">=");
+  }
   GenericKey *index_key = processor_.InitKey();
   processor_.SerializeFromKey(index_key, key, key_schema_);
   if (compare_operator == "=") {
@@ -83,6 +190,15 @@ dberr_t BPlusTreeIndex::Destroy() {
   return DB_SUCCESS;
 }
 
+dberr_t BPlusTreeIndex::Destroy(PageReclaimer *reclaimer) {
+  container_.Detach(reclaimer, false);
+  return DB_SUCCESS;
+}
+
+dberr_t BPlusTreeIndex::Truncate(PageReclaimer *reclaimer) {
+  return container_.Detach(reclaimer, true) ? DB_SUCCESS : DB_FAILED;
+}
+
 IndexIterator BPlusTreeIndex::GetBeginIterator() {
   return container_.Begin();
 }
@@ -7,7 +7,11 @@ IndexIterator::IndexIterator() = default;
 
 IndexIterator::IndexIterator(page_id_t page_id, BufferPoolManager *bpm, int index)
     : current_page_id(page_id), item_index(index), buffer_pool_manager(bpm) {
-  page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id));
+  page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id)->GetData());
+  // a key past the last one of its leaf starts at the front of the next leaf, so that it equals an iterator moved there
+  while (item_index >= page->GetSize() && page->GetNextPageId() != INVALID_PAGE_ID) {
+    MoveToPage(page->GetNextPageId());
+  }
 }
 
 IndexIterator::~IndexIterator() {
@@ -23,9 +27,7 @@ IndexIterator &IndexIterator::operator++() {
   if(item_index == page->GetSize()-1){  // 最后一个
     page_id_t next_page_id = page->GetNextPageId();
     if(next_page_id != INVALID_PAGE_ID){  // 下一页非空
-      item_index = 0;
-      Page *next_page = buffer_pool_manager->FetchPage(next_page_id);
-      page = reinterpret_cast<LeafPage *>(next_page->GetData());
+      MoveToPage(next_page_id);
     }else{  // 下一页为空
       item_index++;
     }
@@ -41,4 +43,13 @@ bool IndexIterator::operator==(const IndexIterator &itr) const {
 
 bool IndexIterator::operator!=(const IndexIterator &itr) const {
   return !(*this == itr);
-}
\ No newline at end of file
+}
+
+void IndexIterator::MoveToPage(page_id_t page_id) {
+  // 换页时放开当前页，记下新页号，比较和析构都看的是它
+  Page *next_page = buffer_pool_manager->FetchPage(page_id);
+  buffer_pool_manager->UnpinPage(current_page_id, false);
+  current_page_id = page_id;
+  page = reinterpret_cast<LeafPage *>(next_page->GetData());
+  item_index = 0;
+}
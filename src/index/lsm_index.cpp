@@ -0,0 +1,164 @@
+#include "index/lsm_index.h"
+
+#include "page/index_roots_page.h"
+
+LsmIndex::LsmIndex(index_id_t index_id, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager,
+                   uint32_t space_id)
+    : Index(index_id, key_schema), buffer_pool_manager_(buffer_pool_manager) {
+  auto *index_roots_page =
+      reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  page_id_t manifest_page_id;
+  if (index_roots_page->GetRootId(index_id, &manifest_page_id)) {
+    tree_.reset(LsmTree::Open(buffer_pool_manager_->GetDiskManager(), manifest_page_id));
+    buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+    return;
+  }
+  tree_.reset(LsmTree::Create(buffer_pool_manager_->GetDiskManager(), space_id));
+  index_roots_page->Insert(index_id, tree_->GetManifestPageId());
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+}
+
+dberr_t LsmIndex::InsertEntry(const Row &key, RowId row_id, [[maybe_unused]] Transaction *txn) {
+  std::string encoded_key = EncodeKey(key);
+  std::string value;
+  std::scoped_lock<std::mutex> lock(insert_latch_);
+  if (tree_->Get(encoded_key, &value)) {
+    return DB_FAILED;
+  }
+  return tree_->Put(encoded_key, EncodeRowId(row_id)) ? DB_SUCCESS : DB_FAILED;
+}
+
+dberr_t LsmIndex::RemoveEntry(const Row &key, [[maybe_unused]] RowId row_id, [[maybe_unused]] Transaction *txn) {
+  // a key maps to one row only, a tombstone for the key removes it without reading it first
+  tree_->Delete(EncodeKey(key));
+  return DB_SUCCESS;
+}
+
+dberr_t LsmIndex::UpdateEntry(const Row &key, RowId old_row_id, RowId new_row_id,
+                               [[maybe_unused]] Transaction *txn) {
+  std::string encoded_key = EncodeKey(key);
+  std::string value;
+  std::scoped_lock<std::mutex> lock(insert_latch_);
+  if (!tree_->Get(encoded_key, &value) || !(DecodeRowId(value) == old_row_id)) {
+    return DB_FAILED;
+  }
+  return tree_->Put(encoded_key, EncodeRowId(new_row_id)) ? DB_SUCCESS : DB_FAILED;
+}
+
+dberr_t LsmIndex::ScanKey(const Row &key, std::vector<RowId> &result, [[maybe_unused]] Transaction *txn,
+                          std::string compare_operator) {
+  std::string encoded_key = EncodeKey(key);
+  if (compare_operator == "=") {
+    std::string value;
+    if (tree_->Get(encoded_key, &value)) {
+      result.push_back(DecodeRowId(value));
+    }
+    return result.empty() ? DB_KEY_NOT_FOUND : DB_SUCCESS;
+  }
+  // encoded keys are prefix free, so the key with a 0x00 appended is the smallest one above it
+  std::string low;
+  std::string high;
+  if (compare_operator == ">") {
+    low = encoded_key + '\0';
+  } else if (compare_operator == ">=") {
+    low = encoded_key;
+  } else if (compare_operator == "<") {
+    high = encoded_key;
+  } else if (compare_operator == "<=") {
+    high = encoded_key + '\0';
+  } else if (compare_operator != "<>") {
+    return DB_KEY_NOT_FOUND;
+  }
+  std::vector<std::pair<std::string, std::string>> entries;
+  tree_->Scan(low, high, entries);
+  for (const auto &entry : entries) {
+    if (compare_operator != "<>" || entry.first != encoded_key) {
+      result.push_back(DecodeRowId(entry.second));
+    }
+  }
+  return result.empty() ? DB_KEY_NOT_FOUND : DB_SUCCESS;
+}
+
+dberr_t LsmIndex::Destroy() {
+  Unregister();
+  tree_->Destroy();
+  return DB_SUCCESS;
+}
+
+dberr_t LsmIndex::Destroy(PageReclaimer *reclaimer) {
+  Unregister();
+  // the task must not touch the index object, the index may be deleted before it runs
+  LsmTree *tree = tree_.release();
+  reclaimer->Submit([tree] {
+    tree->Destroy();
+    delete tree;
+  });
+  return DB_SUCCESS;
+}
+
+dberr_t LsmIndex::Truncate(PageReclaimer *reclaimer) {
+  tree_->Clear(reclaimer);
+  return DB_SUCCESS;
+}
+
+void LsmIndex::Unregister() {
+  auto *index_roots_page =
+      reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  index_roots_page->Delete(index_id_);
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+}
+
+std::string LsmIndex::EncodeKey(const Row &key) {
+  std::string bytes;
+  for (size_t i = 0; i < key.GetFieldCount(); i++) {
+    const Field *field = key.GetField(i);
+    // nulls sort first
+    if (field->IsNull()) {
+      bytes.push_back('\0');
+      continue;
+    }
+    bytes.push_back('\1');
+    if (field->GetTypeId() == TypeId::kTypeChar) {
+      const char *data = field->GetData();
+      for (uint32_t j = 0; j < field->GetLength(); j++) {
+        bytes.push_back(data[j]);
+        if (data[j] == '\0') {
+          bytes.push_back('\xff');
+        }
+      }
+      bytes.append(2, '\0');
+      continue;
+    }
+    char buf[sizeof(uint32_t)];
+    field->SerializeTo(buf);
+    uint32_t bits;
+    memcpy(&bits, buf, sizeof(uint32_t));
+    if (field->GetTypeId() == TypeId::kTypeInt) {
+      bits ^= 0x80000000u;
+    } else {
+      // negative floats sort in reverse, their bits are flipped
+      bits = (bits & 0x80000000u) ? ~bits : bits ^ 0x80000000u;
+    }
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      bytes.push_back(static_cast<char>(bits >> shift & 0xff));
+    }
+  }
+  return bytes;
+}
+
+std::string LsmIndex::EncodeRowId(const RowId &row_id) {
+  std::string value(sizeof(page_id_t) + sizeof(uint32_t), '\0');
+  page_id_t page_id = row_id.GetPageId();
+  uint32_t slot_num = row_id.GetSlotNum();
+  memcpy(value.data(), &page_id, sizeof(page_id_t));
+  memcpy(value.data() + sizeof(page_id_t), &slot_num, sizeof(uint32_t));
+  return value;
+}
+
+RowId LsmIndex::DecodeRowId(const std::string &value) {
+  page_id_t page_id;
+  uint32_t slot_num;
+  memcpy(&page_id, value.data(), sizeof(page_id_t));
+  memcpy(&slot_num, value.data() + sizeof(page_id_t), sizeof(uint32_t));
+  return RowId(page_id, slot_num);
+}
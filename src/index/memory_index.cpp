@@ -0,0 +1,143 @@
+#include "index/memory_index.h"
+
+#include <memory>
+#include <mutex>
+
+MemoryIndex::MemoryIndex(index_id_t index_id, IndexSchema *key_schema, Kind kind)
+    : Index(index_id, key_schema), kind_(kind) {}
+
+bool MemoryIndex::KeyLess::operator()(const Row &a, const Row &b) const {
+  for (size_t i = 0; i < a.GetFieldCount(); i++) {
+    if (a.GetField(i)->CompareLessThan(*b.GetField(i)) == CmpBool::kTrue) {
+      return true;
+    }
+    if (b.GetField(i)->CompareLessThan(*a.GetField(i)) == CmpBool::kTrue) {
+      return false;
+    }
+  }
+  return false;
+}
+
+dberr_t MemoryIndex::InsertEntry(const Row &key, RowId row_id, [[maybe_unused]] Transaction *txn) {
+  std::unique_lock<std::shared_mutex> lock(latch_);
+  bool inserted;
+  if (kind_ == Kind::kHash) {
+    inserted = hashed_.emplace(HashKey(key), HashEntry{CopyKey(key), row_id}).second;
+  } else {
+    inserted = ordered_.emplace(CopyKey(key), row_id).second;
+  }
+  return inserted ? DB_SUCCESS : DB_FAILED;
+}
+
+dberr_t MemoryIndex::RemoveEntry(const Row &key, [[maybe_unused]] RowId row_id, [[maybe_unused]] Transaction *txn) {
+  std::unique_lock<std::shared_mutex> lock(latch_);
+  if (kind_ == Kind::kHash) {
+    hashed_.erase(HashKey(key));
+  } else {
+    ordered_.erase(key);
+  }
+  return DB_SUCCESS;
+}
+
+dberr_t MemoryIndex::UpdateEntry(const Row &key, RowId old_row_id, RowId new_row_id,
+                                 [[maybe_unused]] Transaction *txn) {
+  std::unique_lock<std::shared_mutex> lock(latch_);
+  if (kind_ == Kind::kHash) {
+    auto iter = hashed_.find(HashKey(key));
+    if (iter == hashed_.end() || !(iter->second.row_id_ == old_row_id)) {
+      return DB_FAILED;
+    }
+    iter->second.row_id_ = new_row_id;
+  } else {
+    auto iter = ordered_.find(key);
+    if (iter == ordered_.end() || !(iter->second == old_row_id)) {
+      return DB_FAILED;
+    }
+    iter->second = new_row_id;
+  }
+  return DB_SUCCESS;
+}
+
+dberr_t MemoryIndex::ScanKey(const Row &key, std::vector<RowId> &result, [[maybe_unused]] Transaction *txn,
+                             std::string compare_operator) {
+  std::shared_lock<std::shared_mutex> lock(latch_);
+  if (kind_ == Kind::kHash) {
+    if (compare_operator == "=") {
+      auto iter = hashed_.find(HashKey(key));
+      if (iter != hashed_.end()) {
+        result.push_back(iter->second.row_id_);
+      }
+    } else {
+      // a hash table knows no order, every entry is compared
+      for (const auto &iter : hashed_) {
+        if (Matches(iter.second.key_, key, compare_operator)) {
+          result.push_back(iter.second.row_id_);
+        }
+      }
+    }
+  } else {
+    auto begin = ordered_.begin();
+    auto end = ordered_.end();
+    if (compare_operator == "=") {
+      begin = ordered_.find(key);
+      end = begin == ordered_.end() ? begin : std::next(begin);
+    } else if (compare_operator == ">") {
+      begin = ordered_.upper_bound(key);
+    } else if (compare_operator == ">=") {
+      begin = ordered_.lower_bound(key);
+    } else if (compare_operator == "<") {
+      end = ordered_.lower_bound(key);
+    } else if (compare_operator == "<=") {
+      end = ordered_.upper_bound(key);
+    }
+    for (auto iter = begin; iter != end; ++iter) {
+      if (compare_operator != "<>" || Matches(iter->first, key, compare_operator)) {
+        result.push_back(iter->second);
+      }
+    }
+  }
+  return result.empty() ? DB_KEY_NOT_FOUND : DB_SUCCESS;
+}
+
+dberr_t MemoryIndex::Destroy() {
+  std::unique_lock<std::shared_mutex> lock(latch_);
+  ordered_.clear();
+  hashed_.clear();
+  return DB_SUCCESS;
+}
+
+dberr_t MemoryIndex::Destroy([[maybe_unused]] PageReclaimer *reclaimer) { return Destroy(); }
+
+dberr_t MemoryIndex::Truncate([[maybe_unused]] PageReclaimer *reclaimer) { return Destroy(); }
+
+std::string MemoryIndex::HashKey(const Row &key) const {
+  uint32_t size = 0;
+  for (size_t i = 0; i < key.GetFieldCount(); i++) {
+    size += key.GetField(i)->GetSerializedSize();
+  }
+  std::string bytes(size, '\0');
+  char *buf = bytes.data();
+  for (size_t i = 0; i < key.GetFieldCount(); i++) {
+    buf += key.GetField(i)->SerializeTo(buf);
+  }
+  return bytes;
+}
+
+Row MemoryIndex::CopyKey(const Row &key) {
+  Row copy(key);
+  copy.SetRowId(RowId());
+  copy.GetOverflows().clear();
+  return copy;
+}
+
+bool MemoryIndex::Matches(const Row &row, const Row &key, const std::string &compare_operator) {
+  bool less = KeyLess()(row, key);
+  bool greater = KeyLess()(key, row);
+  if (compare_operator == "=") return !less && !greater;
+  if (compare_operator == "<>") return less || greater;
+  if (compare_operator == "<") return less;
+  if (compare_operator == "<=") return !greater;
+  if (compare_operator == ">") return greater;
+  if (compare_operator == ">=") return !less;
+  return false;
+}
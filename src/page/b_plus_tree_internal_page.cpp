@@ -103,6 +103,8 @@ void InternalPage::PopulateNewRoot(const page_id_t &old_value, GenericKey *new_k
  */
 int InternalPage::InsertNodeAfter(const page_id_t &old_value, GenericKey *new_key, const page_id_t &new_value) {
   int i = ValueIndex(old_value);
+  // shift the pairs behind old_value, a split in the middle of the page must not overwrite its right neighbour
+  memmove(PairPtrAt(i + 2), PairPtrAt(i + 1), (GetSize() - i - 1) * pair_size);
   SetKeyAt(i+1, new_key);
   SetValueAt(i+1, new_value);
   IncreaseSize(1);
@@ -131,7 +133,7 @@ void InternalPage::MoveHalfTo(InternalPage *recipient, BufferPoolManager *buffer
 void InternalPage::CopyNFrom(void *src, int size, BufferPoolManager *buffer_pool_manager) {
   int start = GetSize();
   PairCopy(data_ + start * pair_size, src, size);
-  SetSize(size);
+  SetSize(start + size);
   for(int i=0; i<size; i++){
     page_id_t child_id = ValueAt(start + i);
     Page *page = buffer_pool_manager->FetchPage(child_id);
@@ -208,6 +210,7 @@ void InternalPage::MoveFirstToEndOf(InternalPage *recipient, GenericKey *middle_
  */
 void InternalPage::CopyLastFrom(GenericKey *key, const page_id_t value, BufferPoolManager *buffer_pool_manager) {
   SetKeyAt(GetSize(), key);
+  SetValueAt(GetSize(), value);
   IncreaseSize(1);
   Page *child = buffer_pool_manager->FetchPage(value);
   auto *node = reinterpret_cast<BPlusTreePage *>(child->GetData());
@@ -225,12 +228,10 @@ void InternalPage::CopyLastFrom(GenericKey *key, const page_id_t value, BufferPo
 void InternalPage::MoveLastToFrontOf(InternalPage *recipient, GenericKey *middle_key,
                                      BufferPoolManager *buffer_pool_manager) {
   int last = GetSize()-1;
+  // the old first child of the recipient is now bounded by the middle key, the last key here moves up to the parent
+  recipient->SetKeyAt(0, middle_key);
   recipient->CopyFirstFrom(ValueAt(last), buffer_pool_manager);
-  page_id_t child_id = ValueAt(last);
-  Page *page = buffer_pool_manager->FetchPage(child_id);
-  auto *child = reinterpret_cast<BPlusTreePage *>(page->GetData());
-  child->SetParentPageId(recipient->GetPageId());
-  buffer_pool_manager->UnpinPage(child->GetPageId(), true);
+  recipient->SetKeyAt(0, KeyAt(last));
   Remove(last);
 }
 
@@ -244,12 +245,10 @@ void InternalPage::CopyFirstFrom(const page_id_t value, BufferPoolManager *buffe
   b_page->SetParentPageId(GetPageId());
   buffer_pool_manager->UnpinPage(value, true);
 
-  auto key = KeyAt(ValueIndex(value));
   for(int i=GetSize(); i>=1; i--){
     SetKeyAt(i, KeyAt(i-1));
     SetValueAt(i, ValueAt(i-1));
   }
   SetValueAt(0, value);
-  SetKeyAt(0, key);
   IncreaseSize(1);
 }
\ No newline at end of file
@@ -148,7 +148,7 @@ void LeafPage::MoveHalfTo(LeafPage *recipient) {
 void LeafPage::CopyNFrom(void *src, int size) {
   int start = GetSize();
   PairCopy(data_ + start * pair_size, src, size);
-  SetSize(size);
+  SetSize(start + size);
 }
 
 /*****************************************************************************
@@ -198,10 +198,8 @@ int LeafPage::RemoveAndDeleteRecord(const GenericKey *key, const KeyManager &KM)
  * to update the next_page id in the sibling page
  */
 void LeafPage::MoveAllTo(LeafPage *recipient) {
-  int start = recipient->GetSize();
-  recipient->CopyNFrom(data_+start, GetSize());
+  recipient->CopyNFrom(data_, GetSize());
   recipient->SetNextPageId(GetNextPageId());
-  recipient->IncreaseSize(GetSize());
   SetNextPageId(INVALID_PAGE_ID);
   SetSize(0);
 }
@@ -13,6 +13,10 @@ bool BPlusTreePage::IsRootPage() const {
   return parent_page_id_ == INVALID_PAGE_ID;
 }
 
+IndexPageType BPlusTreePage::GetPageType() const {
+  return page_type_;
+}
+
 void BPlusTreePage::SetPageType(IndexPageType page_type) {
   page_type_ = page_type;
 }
@@ -7,7 +7,7 @@ bool BitmapPage<PageSize>::AllocatePage(uint32_t &page_offset) {
   uint32_t byte_num = page_offset / 8;
   uint32_t bit_num = page_offset % 8;
   auto page_num = GetMaxSupportedSize();
-  if(page_offset == GetMaxSupportedSize() || (bytes[byte_num] >> bit_num) & 1){
+  if(page_offset >= GetMaxSupportedSize() || (bytes[byte_num] >> bit_num) & 1){
     for(uint32_t i = 0; i < page_num; i++){
       if(IsPageFree(i)){
         page_offset = i;
@@ -59,4 +59,10 @@ template class BitmapPage<1024>;
 
 template class BitmapPage<2048>;
 
-template class BitmapPage<4096>;
\ No newline at end of file
+template class BitmapPage<4096>;
+
+template class BitmapPage<8192>;
+
+template class BitmapPage<16384>;
+
+template class BitmapPage<32768>;
@@ -0,0 +1,199 @@
+#include "page/column_page.h"
+
+static uint32_t AlignTo8(uint32_t bytes) { return (bytes + 7) & ~7U; }
+
+ColumnLayout::ColumnLayout(const Schema *schema, uint32_t page_size) : page_size_(page_size) {
+  // a used and a deleted bit per row, and a null bit and a value cell per column
+  uint32_t row_bits = 2;
+  for (auto column : schema->GetColumns()) {
+    uint32_t width = column->GetType() == TypeId::kTypeChar ? sizeof(uint32_t) + column->GetLength() : 4;
+    types_.push_back(column->GetType());
+    widths_.push_back(width);
+    row_bits += 1 + 8 * width;
+  }
+  null_offsets_.resize(types_.size());
+  value_offsets_.resize(types_.size());
+  if (page_size > SIZE_COLUMN_PAGE_HEADER) {
+    capacity_ = (page_size - SIZE_COLUMN_PAGE_HEADER) * 8 / row_bits;
+  }
+  // alignment takes a few bytes per minipage on top
+  while (capacity_ > 0 && GetPageBytes(capacity_) > page_size) {
+    capacity_--;
+  }
+  bitmap_words_ = (capacity_ + 63) / 64;
+  uint32_t offset = SIZE_COLUMN_PAGE_HEADER + 2 * bitmap_words_ * sizeof(uint64_t);
+  for (size_t i = 0; i < types_.size(); i++) {
+    null_offsets_[i] = offset;
+    offset += bitmap_words_ * sizeof(uint64_t);
+    value_offsets_[i] = offset;
+    offset += AlignTo8(capacity_ * widths_[i]);
+  }
+  slot_space_ = capacity_ == 0 ? page_size : (page_size - SIZE_COLUMN_PAGE_HEADER) / capacity_;
+}
+
+uint32_t ColumnLayout::GetPageBytes(uint32_t capacity) const {
+  uint32_t bitmap_bytes = (capacity + 63) / 64 * sizeof(uint64_t);
+  uint32_t bytes = SIZE_COLUMN_PAGE_HEADER + 2 * bitmap_bytes;
+  for (auto width : widths_) {
+    bytes += bitmap_bytes + AlignTo8(capacity * width);
+  }
+  return bytes;
+}
+
+bool ColumnLayout::CanStore(const Row &row) const {
+  if (capacity_ == 0 || row.GetFieldCount() != types_.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < types_.size(); i++) {
+    Field *field = row.GetField(i);
+    if (field->GetTypeId() != types_[i]) {
+      return false;
+    }
+    if (types_[i] == TypeId::kTypeChar && !field->IsNull() && field->GetLength() > widths_[i] - sizeof(uint32_t)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ColumnPage::Init(page_id_t page_id, page_id_t prev_id) {
+  memset(GetData(), 0, GetPageSize());
+  memcpy(GetData(), &page_id, sizeof(page_id));
+  SetPrevPageId(prev_id);
+  SetNextPageId(INVALID_PAGE_ID);
+  SetTupleCount(0);
+}
+
+bool ColumnPage::InsertTuple(Row &row, const ColumnLayout &layout) {
+  uint32_t capacity = layout.GetCapacity();
+  if (GetTupleCount() >= capacity) {
+    return false;
+  }
+  uint64_t *used = GetBitmap(SIZE_HEADER);
+  uint32_t slot = capacity;
+  for (uint32_t i = 0; i < layout.GetBitmapWords(); i++) {
+    if (~used[i] != 0) {
+      slot = i * 64 + __builtin_ctzll(~used[i]);
+      break;
+    }
+  }
+  if (slot >= capacity) {
+    return false;
+  }
+  SetBit(used, slot, true);
+  WriteValues(slot, row, layout);
+  SetTupleCount(GetTupleCount() + 1);
+  row.SetRowId(RowId(GetTablePageId(), slot));
+  return true;
+}
+
+bool ColumnPage::MarkDelete(const RowId &rid, const ColumnLayout &layout) {
+  int slot = GetVisibleSlot(rid, layout);
+  if (slot < 0) {
+    return false;
+  }
+  SetBit(GetBitmap(SIZE_HEADER + layout.GetBitmapWords() * sizeof(uint64_t)), slot, true);
+  return true;
+}
+
+bool ColumnPage::UpdateTuple(const Row &row, const RowId &rid, const ColumnLayout &layout) {
+  int slot = GetVisibleSlot(rid, layout);
+  if (slot < 0) {
+    return false;
+  }
+  WriteValues(slot, row, layout);
+  return true;
+}
+
+void ColumnPage::ApplyDelete(const RowId &rid, const ColumnLayout &layout) {
+  uint32_t slot = rid.GetSlotNum();
+  uint64_t *used = GetBitmap(SIZE_HEADER);
+  ASSERT(slot < layout.GetCapacity() && TestBit(used, slot), "Cannot have empty tuple.");
+  SetBit(used, slot, false);
+  SetBit(GetBitmap(SIZE_HEADER + layout.GetBitmapWords() * sizeof(uint64_t)), slot, false);
+  SetTupleCount(GetTupleCount() - 1);
+}
+
+void ColumnPage::RollbackDelete(const RowId &rid, const ColumnLayout &layout) {
+  uint32_t slot = rid.GetSlotNum();
+  ASSERT(slot < layout.GetCapacity() && TestBit(GetUsedBitmap(), slot), "We can't have empty tuples.");
+  SetBit(GetBitmap(SIZE_HEADER + layout.GetBitmapWords() * sizeof(uint64_t)), slot, false);
+}
+
+bool ColumnPage::GetTuple(Row *row, const ColumnLayout &layout) {
+  int slot = GetVisibleSlot(row->GetRowId(), layout);
+  if (slot < 0) {
+    return false;
+  }
+  // a row read into again drops its old fields
+  row->destroy();
+  std::vector<Field *> &fields = row->GetFields();
+  fields.resize(layout.GetColumnCount(), nullptr);
+  for (uint32_t i = 0; i < layout.GetColumnCount(); i++) {
+    char *cell = GetData() + layout.GetValuesOffset(i) + slot * layout.GetWidth(i);
+    Field::DeserializeFrom(cell, layout.GetType(i), &fields[i], TestBit(GetNullBitmap(i, layout), slot));
+  }
+  return true;
+}
+
+bool ColumnPage::GetFirstTupleRid(RowId *first_rid, const ColumnLayout &layout) {
+  return GetNextTupleRid(RowId(GetTablePageId(), static_cast<uint32_t>(-1)), first_rid, layout);
+}
+
+bool ColumnPage::GetNextTupleRid(const RowId &cur_rid, RowId *next_rid, const ColumnLayout &layout) {
+  const uint64_t *used = GetUsedBitmap();
+  const uint64_t *deleted = GetDeletedBitmap(layout);
+  // the slot behind the current one, wrapping -1 around to 0
+  uint32_t slot = cur_rid.GetSlotNum() + 1;
+  for (uint32_t i = slot / 64; i < layout.GetBitmapWords(); i++) {
+    uint64_t visible = used[i] & ~deleted[i];
+    if (i == slot / 64) {
+      visible &= ~uint64_t(0) << (slot % 64);
+    }
+    if (visible != 0) {
+      next_rid->Set(GetTablePageId(), i * 64 + __builtin_ctzll(visible));
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ColumnPage::HasPendingDelete(const ColumnLayout &layout) {
+  const uint64_t *deleted = GetDeletedBitmap(layout);
+  for (uint32_t i = 0; i < layout.GetBitmapWords(); i++) {
+    if (deleted[i] != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+uint32_t ColumnPage::GetVisibleBitmap(uint64_t *bitmap, const ColumnLayout &layout) {
+  const uint64_t *used = GetUsedBitmap();
+  const uint64_t *deleted = GetDeletedBitmap(layout);
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < layout.GetBitmapWords(); i++) {
+    bitmap[i] = used[i] & ~deleted[i];
+    count += __builtin_popcountll(bitmap[i]);
+  }
+  return count;
+}
+
+int ColumnPage::GetVisibleSlot(const RowId &rid, const ColumnLayout &layout) {
+  uint32_t slot = rid.GetSlotNum();
+  if (slot >= layout.GetCapacity() || !TestBit(GetUsedBitmap(), slot) || TestBit(GetDeletedBitmap(layout), slot)) {
+    return -1;
+  }
+  return static_cast<int>(slot);
+}
+
+void ColumnPage::WriteValues(uint32_t slot, const Row &row, const ColumnLayout &layout) {
+  for (uint32_t i = 0; i < layout.GetColumnCount(); i++) {
+    Field *field = row.GetField(i);
+    char *cell = GetData() + layout.GetValuesOffset(i) + slot * layout.GetWidth(i);
+    // the cell of a null keeps zeros, the kernels read it without looking at the null bit first
+    memset(cell, 0, layout.GetWidth(i));
+    field->SerializeTo(cell);
+    SetBit(GetBitmap(layout.GetNullBitmapOffset(i)), slot, field->IsNull());
+  }
+}
@@ -4,7 +4,7 @@ void TablePage::Init(page_id_t page_id, page_id_t prev_id, LogManager *log_mgr,
   memcpy(GetData(), &page_id, sizeof(page_id));
   SetPrevPageId(prev_id);
   SetNextPageId(INVALID_PAGE_ID);
-  SetFreeSpacePointer(PAGE_SIZE);
+  SetFreeSpacePointer(GetPageSize());
   SetTupleCount(0);
 }
 
@@ -61,46 +61,56 @@ bool TablePage::MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock
   return true;
 }
 
-bool TablePage::UpdateTuple(Row new_row, Row *old_row, Schema *schema, Transaction *txn,
-                            LockManager *lock_manager, LogManager *log_manager) {
+int TablePage::UpdateTuple(Row new_row, Row *old_row, Schema *schema, Transaction *txn,
+                           LockManager *lock_manager, LogManager *log_manager) {
   ASSERT(old_row != nullptr && old_row->GetRowId().Get() != INVALID_ROWID.Get(), "invalid old row.");
   uint32_t serialized_size = new_row.GetSerializedSize(schema);
   ASSERT(serialized_size > 0, "Can not have empty row.");
   uint32_t slot_num = old_row->GetRowId().GetSlotNum();
   // If the slot number is invalid, abort.
   if (slot_num >= GetTupleCount()) {
-    return false;
+    return 0;
   }
   uint32_t tuple_size = GetTupleSize(slot_num);
-  // If the tuple is deleted, abort.
-  if (IsDeleted(tuple_size)) {
-    return false;
+  // If the tuple is deleted, abort. A stub has no row to update here.
+  if (IsDeleted(tuple_size) || IsForward(tuple_size)) {
+    return 2;
   }
+  bool moved = IsMoved(tuple_size);
+  tuple_size = GetTupleLength(tuple_size);
   // If there is not enough space to update, we need to update via delete followed by an insert (not enough space).
   if (GetFreeSpaceRemaining() + tuple_size < serialized_size) {
-    return false;
+    return 3;
   }
   // Copy out the old value.
-  uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  uint32_t __attribute__((unused)) read_bytes = old_row->DeserializeFrom(GetData() + tuple_offset, schema);
+  uint32_t __attribute__((unused)) read_bytes =
+      old_row->DeserializeFrom(GetData() + GetTupleOffsetAtSlot(slot_num), schema);
   ASSERT(tuple_size == read_bytes, "Unexpected behavior in tuple deserialize.");
+  // a moved tuple keeps the row id of its home slot
+  new_row.SetRowId(moved ? old_row->GetRowId() : RowId(GetTablePageId(), slot_num));
+  old_row->SetRowId(RowId(GetTablePageId(), slot_num));
+  ResizeTuple(slot_num, serialized_size);
+  new_row.SerializeTo(GetData() + GetTupleOffsetAtSlot(slot_num), schema);
+  SetTupleSize(slot_num, moved ? static_cast<uint32_t>(serialized_size | MOVED_MASK) : serialized_size);
+  return 1;
+}
+
+void TablePage::ResizeTuple(uint32_t slot_num, uint32_t new_size) {
+  uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
+  uint32_t tuple_size = GetTupleLength(GetTupleSize(slot_num));
   uint32_t free_space_pointer = GetFreeSpacePointer();
   ASSERT(tuple_offset >= free_space_pointer, "Offset should appear after current free space position.");
-  memmove(GetData() + free_space_pointer + tuple_size - serialized_size, GetData() + free_space_pointer,
+  memmove(GetData() + free_space_pointer + tuple_size - new_size, GetData() + free_space_pointer,
           tuple_offset - free_space_pointer);
-  SetFreeSpacePointer(free_space_pointer + tuple_size - serialized_size);
-  new_row.SetRowId(old_row->GetRowId());
-  new_row.SerializeTo(GetData() + tuple_offset + tuple_size - serialized_size, schema);
-  SetTupleSize(slot_num, serialized_size);
-
-  // Update all tuple offsets.
+  SetFreeSpacePointer(free_space_pointer + tuple_size - new_size);
+  // Update all tuple offsets, the tuple itself included.
   for (uint32_t i = 0; i < GetTupleCount(); ++i) {
     uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
     if (GetTupleSize(i) > 0 && tuple_offset_i < tuple_offset + tuple_size) {
-      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size - new_row.GetSerializedSize(schema));
+      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size - new_size);
     }
   }
-  return true;
+  SetTupleSize(slot_num, new_size);
 }
 
 void TablePage::ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_manager) {
@@ -108,11 +118,8 @@ void TablePage::ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_
   ASSERT(slot_num < GetTupleCount(), "Cannot have more slots than tuples.");
 
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  uint32_t tuple_size = GetTupleSize(slot_num);
-  // Check if this is a delete operation, i.e. commit a delete.
-  if (IsDeleted(tuple_size)) {
-    tuple_size = UnsetDeletedFlag(tuple_size);
-  }
+  // Check if this is a delete operation, i.e. commit a delete. Stubs and moved tuples go the same way.
+  uint32_t tuple_size = GetTupleLength(GetTupleSize(slot_num));
 
   uint32_t free_space_pointer = GetFreeSpacePointer();
   ASSERT(tuple_offset >= free_space_pointer, "Free space appears before tuples.");
@@ -153,21 +160,122 @@ bool TablePage::GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager
   }
   // Otherwise get the current tuple size too.
   uint32_t tuple_size = GetTupleSize(slot_num);
-  // If the tuple is deleted, abort the transaction.
-  if (IsDeleted(tuple_size)) {
+  // If the tuple is deleted, abort the transaction. A stub is followed by the table heap.
+  if (IsDeleted(tuple_size) || IsForward(tuple_size)) {
     return false;
   }
   // At this point, we have at least a shared lock on the RID. Copy the tuple data into our result.
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
+  RowId rid = row->GetRowId();
   uint32_t __attribute__((unused)) read_bytes = row->DeserializeFrom(GetData() + tuple_offset, schema);
-  ASSERT(tuple_size == read_bytes, "Unexpected behavior in tuple deserialize.");
+  ASSERT(GetTupleLength(tuple_size) == read_bytes, "Unexpected behavior in tuple deserialize.");
+  // the row id stored with the tuple goes stale when vacuum moves the page, the caller's one is authoritative,
+  // except for a moved tuple whose stored row id is its home slot
+  if (!IsMoved(tuple_size)) {
+    row->SetRowId(rid);
+  }
+  return true;
+}
+
+bool TablePage::InsertMovedTuple(const Row &row, Schema *schema, RowId *new_rid) {
+  uint32_t serialized_size = row.GetSerializedSize(schema);
+  if (GetFreeSpaceRemaining() < serialized_size + SIZE_TUPLE) {
+    return false;
+  }
+  uint32_t i = 0;
+  while (i < GetTupleCount() && GetTupleSize(i) != 0) {
+    i++;
+  }
+  SetFreeSpacePointer(GetFreeSpacePointer() - serialized_size);
+  uint32_t __attribute__((unused)) write_bytes = row.SerializeTo(GetData() + GetFreeSpacePointer(), schema);
+  ASSERT(write_bytes == serialized_size, "Unexpected behavior in row serialize.");
+  SetTupleOffsetAtSlot(i, GetFreeSpacePointer());
+  SetTupleSize(i, static_cast<uint32_t>(serialized_size | MOVED_MASK));
+  if (i == GetTupleCount()) {
+    SetTupleCount(GetTupleCount() + 1);
+  }
+  new_rid->Set(GetTablePageId(), i);
   return true;
 }
 
+bool TablePage::GetForward(const RowId &rid, RowId *target) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount() || !IsForward(GetTupleSize(slot_num))) {
+    return false;
+  }
+  *target = MACH_READ_FROM(RowId, GetData() + GetTupleOffsetAtSlot(slot_num));
+  return true;
+}
+
+void TablePage::SetForward(uint32_t slot_num, const RowId &target) {
+  ASSERT(slot_num < GetTupleCount(), "Cannot have more slots than tuples.");
+  // a stub is never larger than a tuple, so this always fits
+  ResizeTuple(slot_num, sizeof(RowId));
+  MACH_WRITE_TO(RowId, GetData() + GetTupleOffsetAtSlot(slot_num), target);
+  SetTupleSize(slot_num, static_cast<uint32_t>(sizeof(RowId) | FORWARD_MASK));
+}
+
+bool TablePage::ReplaceForward(uint32_t slot_num, Row &row, Schema *schema) {
+  ASSERT(slot_num < GetTupleCount() && IsForward(GetTupleSize(slot_num)), "Slot holds no forwarding stub.");
+  uint32_t serialized_size = row.GetSerializedSize(schema);
+  if (GetFreeSpaceRemaining() + sizeof(RowId) < serialized_size) {
+    return false;
+  }
+  ResizeTuple(slot_num, serialized_size);
+  row.SetRowId(RowId(GetTablePageId(), slot_num));
+  row.SerializeTo(GetData() + GetTupleOffsetAtSlot(slot_num), schema);
+  return true;
+}
+
+void TablePage::RemapForwards(const std::function<page_id_t(page_id_t)> &remap) {
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    uint32_t tuple_size = GetTupleSize(i);
+    if (IsForward(tuple_size) || IsMoved(tuple_size)) {
+      // the target of a stub and the home of a moved tuple both sit at the start of the tuple
+      char *buf = GetData() + GetTupleOffsetAtSlot(i);
+      RowId rid = MACH_READ_FROM(RowId, buf);
+      MACH_WRITE_TO(RowId, buf, RowId(remap(rid.GetPageId()), rid.GetSlotNum()));
+    }
+  }
+}
+
+void TablePage::GetOverflows(uint32_t slot_num, Schema *schema, std::vector<page_id_t> &first_page_ids) {
+  uint32_t tuple_size = slot_num < GetTupleCount() ? GetTupleSize(slot_num) : 0;
+  if (tuple_size == 0 || IsForward(tuple_size)) {
+    return;
+  }
+  Row row;
+  row.DeserializeFrom(GetData() + GetTupleOffsetAtSlot(slot_num), schema);
+  for (auto &overflow : row.GetOverflows()) {
+    first_page_ids.push_back(overflow.first_page_id_);
+  }
+}
+
+void TablePage::RemapOverflows(Schema *schema, const std::function<page_id_t(page_id_t)> &remap) {
+  Row row;
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    uint32_t tuple_size = GetTupleSize(i);
+    if (tuple_size == 0 || IsForward(tuple_size)) {
+      continue;
+    }
+    char *buf = GetData() + GetTupleOffsetAtSlot(i);
+    // the fields of columns added later are not in the tuple and must not be written into it
+    row.DeserializeFrom(buf, schema, false);
+    if (row.GetOverflows().empty()) {
+      continue;
+    }
+    for (auto &overflow : row.GetOverflows()) {
+      overflow.first_page_id_ = remap(overflow.first_page_id_);
+    }
+    // the reference has a fixed size, the tuple is rewritten in place
+    row.SerializeTo(buf, schema);
+  }
+}
+
 bool TablePage::GetFirstTupleRid(RowId *first_rid) {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); i++) {
-    if (!IsDeleted(GetTupleSize(i))) {
+    if (!IsDeleted(GetTupleSize(i)) && !IsForward(GetTupleSize(i))) {
       first_rid->Set(GetTablePageId(), i);
       return true;
     }
@@ -180,7 +288,7 @@ bool TablePage::GetNextTupleRid(const RowId &cur_rid, RowId *next_rid) {
   ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
   // Find and return the first valid tuple after our current slot number.
   for (auto i = cur_rid.GetSlotNum() + 1; i < GetTupleCount(); i++) {
-    if (!IsDeleted(GetTupleSize(i))) {
+    if (!IsDeleted(GetTupleSize(i)) && !IsForward(GetTupleSize(i))) {
       next_rid->Set(GetTablePageId(), i);
       return true;
     }
@@ -189,3 +297,30 @@ bool TablePage::GetNextTupleRid(const RowId &cur_rid, RowId *next_rid) {
   next_rid->Set(INVALID_PAGE_ID, 0);
   return false;
 }
+
+bool TablePage::HasPendingDelete() {
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    if (GetTupleSize(i) & DELETE_MASK) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TablePage::IsCompact() {
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    if (IsDeleted(GetTupleSize(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TablePage::HasForwarding() {
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    if (IsForward(GetTupleSize(i)) || IsMoved(GetTupleSize(i))) {
+      return true;
+    }
+  }
+  return false;
+}
@@ -577,11 +577,56 @@ char *yytext;
 #line 1 "minisql.l"
 #line 2 "minisql.l"
     #include <stdio.h>
+    #include <string.h>
     #include "parser/parser.h"
     #include "parser/minisql_yacc.h"
     int yywrap();
     extern YYSTYPE yylval;
-#line 585 "../../parser/minisql_lex.c"
+
+    /*
+     * Option keywords are matched as identifiers first and then looked up here. They are
+     * tokens of their own but carry their text like an identifier, so the parser's name
+     * rule takes them as plain names wherever no option is expected.
+     */
+    static const struct {
+      const char *text_;
+      int token_;
+    } kOptionKeywords[] = {
+      {"page_size", PAGESIZE},
+      {"tablespace", TABLESPACE},
+      {"location", LOCATION},
+      {"vacuum", VACUUM},
+      {"copy", COPY},
+      {"storage", STORAGE},
+      {"truncate", TRUNCATE},
+      {"engine", ENGINE},
+      {"temporary", TEMPORARY},
+      {"partition", PARTITION},
+      {"partitions", PARTITIONS},
+      {"by", BY},
+      {"less", LESS},
+      {"than", THAN},
+      {"maxvalue", MAXVALUE},
+      {"alter", ALTER},
+      {"add", ADD},
+      {"column", COLUMN},
+      {"default", DEFAULT},
+      {"as", AS},
+      {"auto_increment", AUTOINCREMENT},
+      {"dictionary", DICTIONARY},
+      {"cluster", CLUSTER},
+    };
+
+    static int LookupOptionKeyword(const char *text) {
+      size_t i;
+      for (i = 0; i < sizeof(kOptionKeywords) / sizeof(kOptionKeywords[0]); i++) {
+        if (strcmp(kOptionKeywords[i].text_, text) == 0) {
+          return kOptionKeywords[i].token_;
+        }
+      }
+      return 0;
+    }
+#line 625 "../../parser/minisql_lex.c"
 
 #define INITIAL 0
 
@@ -763,10 +808,10 @@ YY_DECL
 	register char *yy_cp, *yy_bp;
 	register int yy_act;
     
-#line 15 "minisql.l"
+#line 60 "minisql.l"
 
 
-#line 770 "../../parser/minisql_lex.c"
+#line 810 "../../parser/minisql_lex.c"
 
 	if ( !(yy_init) )
 		{
@@ -862,7 +907,7 @@ do_action:	/* This label is used only to access EOF actions. */
 case 1:
 /* rule 1 can match eol */
 YY_RULE_SETUP
-#line 17 "minisql.l"
+#line 62 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   yylval.syntax_node = CreateSyntaxNode(kNodeString, yytext);
@@ -871,7 +916,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 2:
 YY_RULE_SETUP
-#line 23 "minisql.l"
+#line 68 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return CREATE;
@@ -879,7 +924,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 3:
 YY_RULE_SETUP
-#line 28 "minisql.l"
+#line 73 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return DROP;
@@ -887,7 +932,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 4:
 YY_RULE_SETUP
-#line 33 "minisql.l"
+#line 78 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return SELECT;
@@ -895,7 +940,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 5:
 YY_RULE_SETUP
-#line 38 "minisql.l"
+#line 83 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return INSERT;
@@ -903,7 +948,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 6:
 YY_RULE_SETUP
-#line 43 "minisql.l"
+#line 88 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return DELETE;
@@ -911,7 +956,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 7:
 YY_RULE_SETUP
-#line 48 "minisql.l"
+#line 93 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return UPDATE;
@@ -919,7 +964,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
-#line 53 "minisql.l"
+#line 98 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return TRXBEGIN;
@@ -927,7 +972,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 9:
 YY_RULE_SETUP
-#line 58 "minisql.l"
+#line 103 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return TRXCOMMIT;
@@ -935,7 +980,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 10:
 YY_RULE_SETUP
-#line 63 "minisql.l"
+#line 108 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return TRXROLLBACK;
@@ -943,7 +988,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 11:
 YY_RULE_SETUP
-#line 68 "minisql.l"
+#line 113 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return QUIT;
@@ -951,7 +996,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 12:
 YY_RULE_SETUP
-#line 73 "minisql.l"
+#line 118 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return EXECFILE;
@@ -959,7 +1004,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
-#line 78 "minisql.l"
+#line 123 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return SHOW;
@@ -967,7 +1012,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
-#line 83 "minisql.l"
+#line 128 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return USE;
@@ -975,7 +1020,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
-#line 88 "minisql.l"
+#line 133 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return USING;
@@ -983,7 +1028,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
-#line 93 "minisql.l"
+#line 138 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return DATABASE;
@@ -991,7 +1036,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
-#line 98 "minisql.l"
+#line 143 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return DATABASES;
@@ -999,7 +1044,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
-#line 103 "minisql.l"
+#line 148 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return TABLE;
@@ -1007,7 +1052,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 19:
 YY_RULE_SETUP
-#line 108 "minisql.l"
+#line 153 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return TABLES;
@@ -1015,7 +1060,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 20:
 YY_RULE_SETUP
-#line 113 "minisql.l"
+#line 158 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return INDEX;
@@ -1023,7 +1068,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 21:
 YY_RULE_SETUP
-#line 118 "minisql.l"
+#line 163 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return INDEXES;
@@ -1031,7 +1076,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
-#line 123 "minisql.l"
+#line 168 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ON;
@@ -1039,7 +1084,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 23:
 YY_RULE_SETUP
-#line 128 "minisql.l"
+#line 173 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return FROM;
@@ -1047,7 +1092,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 24:
 YY_RULE_SETUP
-#line 133 "minisql.l"
+#line 178 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return WHERE;
@@ -1055,7 +1100,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 25:
 YY_RULE_SETUP
-#line 138 "minisql.l"
+#line 183 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return INTO;
@@ -1063,7 +1108,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 26:
 YY_RULE_SETUP
-#line 143 "minisql.l"
+#line 188 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return SET;
@@ -1071,7 +1116,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 27:
 YY_RULE_SETUP
-#line 148 "minisql.l"
+#line 193 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return VALUES;
@@ -1079,7 +1124,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 28:
 YY_RULE_SETUP
-#line 153 "minisql.l"
+#line 198 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return PRIMARY;
@@ -1087,7 +1132,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 29:
 YY_RULE_SETUP
-#line 158 "minisql.l"
+#line 203 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return KEY;
@@ -1095,7 +1140,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 30:
 YY_RULE_SETUP
-#line 163 "minisql.l"
+#line 208 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return UNIQUE;
@@ -1103,7 +1148,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 31:
 YY_RULE_SETUP
-#line 168 "minisql.l"
+#line 213 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return CHAR;
@@ -1111,7 +1156,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 32:
 YY_RULE_SETUP
-#line 173 "minisql.l"
+#line 218 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return INT;
@@ -1119,7 +1164,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 33:
 YY_RULE_SETUP
-#line 178 "minisql.l"
+#line 223 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return FLOAT;
@@ -1127,7 +1172,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 34:
 YY_RULE_SETUP
-#line 183 "minisql.l"
+#line 228 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return AND;
@@ -1135,7 +1180,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 35:
 YY_RULE_SETUP
-#line 188 "minisql.l"
+#line 233 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return OR;
@@ -1143,7 +1188,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 36:
 YY_RULE_SETUP
-#line 193 "minisql.l"
+#line 238 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return NOT;
@@ -1151,7 +1196,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 37:
 YY_RULE_SETUP
-#line 198 "minisql.l"
+#line 243 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return IS;
@@ -1159,7 +1204,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 38:
 YY_RULE_SETUP
-#line 203 "minisql.l"
+#line 248 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return FLAGNULL;
@@ -1167,16 +1212,17 @@ YY_RULE_SETUP
 	YY_BREAK
 case 39:
 YY_RULE_SETUP
-#line 208 "minisql.l"
+#line 253 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   yylval.syntax_node = CreateSyntaxNode(kNodeIdentifier, yytext);
-  return IDENTIFIER;
+  int keyword = LookupOptionKeyword(yytext);
+  return keyword != 0 ? keyword : IDENTIFIER;
 }
 	YY_BREAK
 case 40:
 YY_RULE_SETUP
-#line 214 "minisql.l"
+#line 260 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   yylval.syntax_node = CreateSyntaxNode(kNodeNumber, yytext);
@@ -1185,7 +1231,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 41:
 YY_RULE_SETUP
-#line 220 "minisql.l"
+#line 266 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   yylval.syntax_node = CreateSyntaxNode(kNodeNumber, yytext);
@@ -1194,7 +1240,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 42:
 YY_RULE_SETUP
-#line 226 "minisql.l"
+#line 272 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return EQ;
@@ -1202,7 +1248,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 43:
 YY_RULE_SETUP
-#line 231 "minisql.l"
+#line 277 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return NE;
@@ -1210,7 +1256,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 44:
 YY_RULE_SETUP
-#line 236 "minisql.l"
+#line 282 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return LE;
@@ -1218,7 +1264,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 45:
 YY_RULE_SETUP
-#line 241 "minisql.l"
+#line 287 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return GE;
@@ -1226,7 +1272,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 46:
 YY_RULE_SETUP
-#line 246 "minisql.l"
+#line 292 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return (',');
@@ -1234,7 +1280,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 47:
 YY_RULE_SETUP
-#line 251 "minisql.l"
+#line 297 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ('*');
@@ -1242,7 +1288,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 48:
 YY_RULE_SETUP
-#line 256 "minisql.l"
+#line 302 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return (';');
@@ -1250,7 +1296,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 49:
 YY_RULE_SETUP
-#line 261 "minisql.l"
+#line 307 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ('\'');
@@ -1258,7 +1304,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 50:
 YY_RULE_SETUP
-#line 266 "minisql.l"
+#line 312 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ('<');
@@ -1266,7 +1312,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 51:
 YY_RULE_SETUP
-#line 271 "minisql.l"
+#line 317 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ('>');
@@ -1274,7 +1320,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 52:
 YY_RULE_SETUP
-#line 276 "minisql.l"
+#line 322 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ('(');
@@ -1282,7 +1328,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 53:
 YY_RULE_SETUP
-#line 281 "minisql.l"
+#line 327 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return (')');
@@ -1291,14 +1337,14 @@ YY_RULE_SETUP
 case 54:
 /* rule 54 can match eol */
 YY_RULE_SETUP
-#line 286 "minisql.l"
+#line 332 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
 }
 	YY_BREAK
 case 55:
 YY_RULE_SETUP
-#line 290 "minisql.l"
+#line 336 "minisql.l"
 {
   char str[128] = {0};
   sprintf(str, "Unrecognized token [%s] in input sql.", yytext);
@@ -1307,10 +1353,10 @@ YY_RULE_SETUP
 	YY_BREAK
 case 56:
 YY_RULE_SETUP
-#line 296 "minisql.l"
+#line 342 "minisql.l"
 ECHO;
 	YY_BREAK
-#line 1314 "../../parser/minisql_lex.c"
+#line 1358 "../../parser/minisql_lex.c"
 case YY_STATE_EOF(INITIAL):
 	yyterminate();
 
@@ -2319,7 +2365,7 @@ void yyfree (void * ptr )
 
 #define YYTABLES_NAME "yytables"
 
-#line 296 "minisql.l"
+#line 342 "minisql.l"
 
 
 int yywrap() {
@@ -26,7 +26,6 @@ pSyntaxNode CreateSyntaxNode(SyntaxNodeType type, char *val) {
       size_t len = strlen(val) + 1;
       node->val_ = (char *) malloc(len);
       strcpy(node->val_, val);
-      node->val_[len] = '\0';
     }
   } else {
     node->val_ = NULL;
@@ -169,6 +168,26 @@ const char *GetSyntaxNodeTypeStr(SyntaxNodeType type) {
       return "kNodeTrxCommit";
     case kNodeTrxRollback:
       return "kNodeTrxRollback";
+    case kNodeOption:
+      return "kNodeOption";
+    case kNodeCreateTablespace:
+      return "kNodeCreateTablespace";
+    case kNodeVacuumDB:
+      return "kNodeVacuumDB";
+    case kNodeCopy:
+      return "kNodeCopy";
+    case kNodeVacuumTable:
+      return "kNodeVacuumTable";
+    case kNodeTruncateTable:
+      return "kNodeTruncateTable";
+    case kNodePartition:
+      return "kNodePartition";
+    case kNodeAlterTable:
+      return "kNodeAlterTable";
+    case kNodeClusterTable:
+      return "kNodeClusterTable";
+    case kNodeSet:
+      return "kNodeSet";
     default:
       return "error type";
   }
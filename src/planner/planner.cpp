@@ -2,6 +2,7 @@
 // Created by njz on 2023/2/2.
 //
 #include <algorithm>
+#include <cmath>
 #include "planner/planner.h"
 
 void Planner::PlanQuery(pSyntaxNode ast) {
@@ -36,10 +37,24 @@ void Planner::PlanQuery(pSyntaxNode ast) {
 }
 AbstractPlanNodeRef Planner::PlanSelect(std::shared_ptr<SelectStatement> statement) {
   auto out_schema = MakeOutputSchema(statement->column_list_);
+  TableInfo *info = nullptr;
+  context_->GetCatalog()->GetTable(statement->table_name_, info);
+  if (info->IsPartitioned()) {
+    std::vector<AbstractPlanNodeRef> scans;
+    for (auto partition : PrunePartitions(info, statement->where_)) {
+      scans.push_back(PlanScan(out_schema, partition->GetTableName(), statement));
+    }
+    return make_shared<AppendPlanNode>(out_schema, std::move(scans));
+  }
+  return PlanScan(out_schema, statement->table_name_, statement);
+}
+
+AbstractPlanNodeRef Planner::PlanScan(const Schema *out_schema, const std::string &table_name,
+                                      const std::shared_ptr<SelectStatement> &statement) {
   vector<IndexInfo *> indexes;
   vector<IndexInfo *> available_index;
   vector<uint32_t> column_in_condition = statement->column_in_condition_;
-  context_->GetCatalog()->GetTableIndexes(statement->table_name_, indexes);
+  context_->GetCatalog()->GetTableIndexes(table_name, indexes);
   for (auto index : indexes) {
     if (index->GetIndexKeySchema()->GetColumns().size() == 1) {
       auto col_id = index->GetIndexKeySchema()->GetColumn(0)->GetTableInd();
@@ -51,21 +66,81 @@ AbstractPlanNodeRef Planner::PlanSelect(std::shared_ptr<SelectStatement> stateme
     }
   }
   if (available_index.empty() || statement->has_or) {
-    return make_shared<SeqScanPlanNode>(out_schema, statement->table_name_, statement->where_);
+    auto scan_plan = make_shared<SeqScanPlanNode>(out_schema, table_name, statement->where_);
+    TableInfo *info = nullptr;
+    context_->GetCatalog()->GetTable(table_name, info);
+    scan_plan->code_predicate_ = SeqScanPlanNode::EncodePredicate(statement->where_, info->GetSchema());
+    return scan_plan;
+  }
+  auto scan_plan = make_shared<IndexScanPlanNode>(out_schema, table_name, available_index,
+                                                  !column_in_condition.empty(), statement->where_);
+  // keys whose order is known not to follow the heap would fetch the pages of the heap back and forth, their rows are
+  // read page by page instead
+  for (auto index : available_index) {
+    IndexMetadata *meta = index->GetIndexMetadata();
+    if (meta->HasCorrelation() && std::fabs(meta->GetCorrelation()) < CLUSTERED_CORRELATION) {
+      scan_plan->heap_order_ = true;
+    }
   }
-  return make_shared<IndexScanPlanNode>(out_schema, statement->table_name_, available_index,
-                                        !column_in_condition.empty(),
-                                        statement->where_);
+  return scan_plan;
 }
 
 AbstractPlanNodeRef Planner::PlanInsert(std::shared_ptr<InsertStatement> statement) {
-  auto value_plan = std::make_shared<ValuesPlanNode>(nullptr, statement->raw_values_);
-  return std::make_shared<InsertPlanNode>(nullptr, value_plan, statement->table_name_);
+  TableInfo *info = nullptr;
+  context_->GetCatalog()->GetTable(statement->table_name_, info);
+  if (statement->select_ != nullptr) {
+    // insert ... select: the rows of the select are appended in bulk, so they cannot be routed to partitions
+    if (info->IsPartitioned()) {
+      throw std::logic_error("insert ... select into a partitioned table is not supported");
+    }
+    auto select_plan = PlanSelect(statement->select_);
+    const Schema *select_schema = select_plan->OutputSchema();
+    const Schema *table_schema = info->GetSchema();
+    if (select_schema->GetColumnCount() != table_schema->GetColumnCount()) {
+      throw std::logic_error("the selected columns do not match the columns of the table");
+    }
+    for (uint32_t i = 0; i < table_schema->GetColumnCount(); i++) {
+      if (select_schema->GetColumn(i)->GetType() != table_schema->GetColumn(i)->GetType()) {
+        throw std::logic_error("the selected columns do not match the columns of the table");
+      }
+    }
+    return std::make_shared<InsertPlanNode>(nullptr, select_plan, statement->table_name_);
+  }
+  if (!info->IsPartitioned()) {
+    auto value_plan = std::make_shared<ValuesPlanNode>(nullptr, statement->raw_values_);
+    return std::make_shared<InsertPlanNode>(nullptr, value_plan, statement->table_name_);
+  }
+  // every row goes to the partition that takes the value of its partition column
+  PartitionScheme *scheme = info->GetPartitionScheme();
+  std::vector<std::vector<std::vector<AbstractExpressionRef>>> partition_values(scheme->GetPartitionCount());
+  for (const auto &values : statement->raw_values_) {
+    uint32_t index;
+    if (!scheme->Locate(values[scheme->GetColumnIndex()]->Evaluate(nullptr), index)) {
+      throw std::logic_error("no partition of the table takes the inserted value");
+    }
+    partition_values[index].push_back(values);
+  }
+  std::vector<AbstractPlanNodeRef> inserts;
+  for (uint32_t i = 0; i < scheme->GetPartitionCount(); i++) {
+    if (!partition_values[i].empty()) {
+      auto value_plan = std::make_shared<ValuesPlanNode>(nullptr, std::move(partition_values[i]));
+      inserts.push_back(std::make_shared<InsertPlanNode>(nullptr, value_plan, info->GetPartitions()[i]->GetTableName()));
+    }
+  }
+  return std::make_shared<AppendPlanNode>(nullptr, std::move(inserts));
 }
 
 AbstractPlanNodeRef Planner::PlanDelete(std::shared_ptr<DeleteStatement> statement) {
   TableInfo *info = nullptr;
   context_->GetCatalog()->GetTable(statement->table_name_, info);
+  if (info->IsPartitioned()) {
+    std::vector<AbstractPlanNodeRef> deletes;
+    for (auto partition : PrunePartitions(info, statement->where_)) {
+      auto scan_plan = make_shared<SeqScanPlanNode>(info->GetSchema(), partition->GetTableName(), statement->where_);
+      deletes.push_back(std::make_shared<DeletePlanNode>(info->GetSchema(), scan_plan, partition->GetTableName()));
+    }
+    return std::make_shared<AppendPlanNode>(nullptr, std::move(deletes));
+  }
   auto scan_plan = make_shared<SeqScanPlanNode>(info->GetSchema(), statement->table_name_, statement->where_);
   return std::make_shared<DeletePlanNode>(info->GetSchema(), scan_plan, statement->table_name_);
 }
@@ -73,11 +148,40 @@ AbstractPlanNodeRef Planner::PlanDelete(std::shared_ptr<DeleteStatement> stateme
 AbstractPlanNodeRef Planner::PlanUpdate(std::shared_ptr<UpdateStatement> statement) {
   TableInfo *info = nullptr;
   context_->GetCatalog()->GetTable(statement->table_name_, info);
+  if (info->IsPartitioned()) {
+    // a row is updated where it is, it cannot move to another partition
+    if (statement->update_attrs.count(info->GetPartitionScheme()->GetColumnIndex()) != 0) {
+      throw std::logic_error("the partition column of a table cannot be updated");
+    }
+    std::vector<AbstractPlanNodeRef> updates;
+    for (auto partition : PrunePartitions(info, statement->where_)) {
+      auto scan_plan = make_shared<SeqScanPlanNode>(info->GetSchema(), partition->GetTableName(), statement->where_);
+      updates.push_back(std::make_shared<UpdatePlanNode>(info->GetSchema(), scan_plan, partition->GetTableName(),
+                                                         statement->update_attrs));
+    }
+    return std::make_shared<AppendPlanNode>(nullptr, std::move(updates));
+  }
   auto scan_plan = make_shared<SeqScanPlanNode>(info->GetSchema(), statement->table_name_, statement->where_);
   return std::make_shared<UpdatePlanNode>(info->GetSchema(), scan_plan, statement->table_name_,
                                           statement->update_attrs);
 }
 
+std::vector<TableInfo *> Planner::PrunePartitions(TableInfo *table_info, const AbstractExpressionRef &predicate) {
+  PartitionScheme *scheme = table_info->GetPartitionScheme();
+  std::vector<TableInfo *> partitions;
+  for (uint32_t i = 0; i < scheme->GetPartitionCount(); i++) {
+    // only comparisons on the partition column rule a partition out
+    if (predicate == nullptr ||
+        SeqScanPlanNode::MayMatch(predicate.get(), [&](uint32_t column_index, CompareOp op,
+                                                       const Field &constant) {
+          return column_index != scheme->GetColumnIndex() || scheme->MayMatch(i, op, constant);
+        })) {
+      partitions.push_back(table_info->GetPartitions()[i]);
+    }
+  }
+  return partitions;
+}
+
 Schema *Planner::MakeOutputSchema(const vector<std::pair<std::string, AbstractExpressionRef>> &exprs) {
   std::vector<Column *> cols;
   cols.reserve(exprs.size());
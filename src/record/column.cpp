@@ -34,11 +34,18 @@ Column::Column(const Column *other)
       len_(other->len_),
       table_ind_(other->table_ind_),
       nullable_(other->nullable_),
-      unique_(other->unique_) {}
+      unique_(other->unique_),
+      version_(other->version_),
+      dictionary_encoded_(other->dictionary_encoded_),
+      dictionary_(other->dictionary_) {
+  SetDefault(other->GetDefault());
+}
 
 uint32_t Column::SerializeTo(char *buf) const {
   char *buf_p = buf;
-  MACH_WRITE_UINT32(buf_p, COLUMN_MAGIC_NUM); // 魔数
+  uint32_t magic = version_ != 0 ? VERSIONED_COLUMN_MAGIC_NUM
+                   : dictionary_encoded_ ? ENCODED_COLUMN_MAGIC_NUM : COLUMN_MAGIC_NUM;
+  MACH_WRITE_UINT32(buf_p, magic); // 魔数
   buf_p += sizeof(uint32_t);
   MACH_WRITE_UINT32(buf_p, name_.length()); // 写入name长度
   buf_p += sizeof(uint32_t);
@@ -54,6 +61,16 @@ uint32_t Column::SerializeTo(char *buf) const {
   buf_p += sizeof(bool);
   MACH_WRITE_TO(bool, buf_p, unique_);
   buf_p += sizeof(bool);
+  // 后加的列：写入版本和默认值
+  if(version_ != 0){
+    MACH_WRITE_UINT32(buf_p, version_);
+    buf_p += sizeof(uint32_t);
+    MACH_WRITE_TO(bool, buf_p, default_ != nullptr);
+    buf_p += sizeof(bool);
+    if(default_ != nullptr){
+      buf_p += default_->SerializeTo(buf_p);
+    }
+  }
   return buf_p - buf;
 }
 
@@ -63,6 +80,12 @@ uint32_t Column::GetSerializedSize() const {
   cnt += name_.length();
   cnt += sizeof(TypeId);
   cnt += 2 * sizeof(bool);
+  if(version_ != 0){
+    cnt += sizeof(uint32_t) + sizeof(bool);
+    if(default_ != nullptr){
+      cnt += default_->GetSerializedSize();
+    }
+  }
   return cnt;
 }
 
@@ -71,7 +94,7 @@ uint32_t Column::DeserializeFrom(char *buf, Column *&column) {
   // 读魔数
   uint32_t magic = MACH_READ_UINT32(buf_p);
   buf_p += sizeof(uint32_t);
-  if(magic != COLUMN_MAGIC_NUM){
+  if(magic != COLUMN_MAGIC_NUM && magic != VERSIONED_COLUMN_MAGIC_NUM && magic != ENCODED_COLUMN_MAGIC_NUM){
     std::cerr<<"COLUMN_MAGIC_NUM error" << std::endl;
     return 0;
   }
@@ -103,5 +126,18 @@ uint32_t Column::DeserializeFrom(char *buf, Column *&column) {
   }else{
     column = new Column(name, type, table_ind, nullable, unique);
   }
+  column->dictionary_encoded_ = magic == ENCODED_COLUMN_MAGIC_NUM;
+  // 读版本和默认值
+  if(magic == VERSIONED_COLUMN_MAGIC_NUM){
+    column->version_ = MACH_READ_UINT32(buf_p);
+    buf_p += sizeof(uint32_t);
+    bool has_default = MACH_READ_FROM(bool, buf_p);
+    buf_p += sizeof(bool);
+    if(has_default){
+      Field *default_value = nullptr;
+      buf_p += Field::DeserializeFrom(buf_p, type, &default_value, false);
+      column->default_.reset(default_value);
+    }
+  }
   return buf_p - buf;
 }
@@ -0,0 +1,74 @@
+#include "record/dictionary.h"
+
+Dictionary::Dictionary(Append append) : append_(std::move(append)) {}
+
+void Dictionary::Load(const std::vector<std::string> &values) {
+  std::lock_guard<std::mutex> lock(latch_);
+  ASSERT(size_.load() == 0 && values.size() <= DICTIONARY_MAX_SIZE, "Invalid dictionary values.");
+  for (uint32_t code = 0; code < values.size(); code++) {
+    if (code % CHUNK_SIZE == 0) {
+      chunks_[code / CHUNK_SIZE].reset(new std::string[CHUNK_SIZE]);
+    }
+    chunks_[code / CHUNK_SIZE][code % CHUNK_SIZE] = values[code];
+    codes_.emplace(values[code], code);
+  }
+  size_.store(values.size(), std::memory_order_release);
+}
+
+bool Dictionary::Encode(const Field &value, int32_t &code) {
+  ASSERT(value.GetTypeId() == TypeId::kTypeChar && !value.IsNull(), "Only char values are encoded.");
+  std::string key(value.GetData(), value.GetLength());
+  std::lock_guard<std::mutex> lock(latch_);
+  auto iter = codes_.find(key);
+  if (iter != codes_.end()) {
+    code = iter->second;
+    return true;
+  }
+  uint32_t size = size_.load();
+  if (size == DICTIONARY_MAX_SIZE || !append_(key)) {
+    return false;
+  }
+  if (size % CHUNK_SIZE == 0) {
+    chunks_[size / CHUNK_SIZE].reset(new std::string[CHUNK_SIZE]);
+  }
+  chunks_[size / CHUNK_SIZE][size % CHUNK_SIZE] = key;
+  codes_.emplace(std::move(key), size);
+  // the value is in place before any reader can come across its code
+  size_.store(size + 1, std::memory_order_release);
+  code = static_cast<int32_t>(size);
+  return true;
+}
+
+bool Dictionary::Lookup(const Field &value, int32_t &code) const {
+  if (value.GetTypeId() != TypeId::kTypeChar || value.IsNull()) {
+    return false;
+  }
+  std::string key(value.GetData(), value.GetLength());
+  std::lock_guard<std::mutex> lock(latch_);
+  auto iter = codes_.find(key);
+  if (iter == codes_.end()) {
+    return false;
+  }
+  code = iter->second;
+  return true;
+}
+
+Field *Dictionary::Decode(int32_t code) const {
+  ASSERT(code >= 0 && static_cast<uint32_t>(code) < GetSize(), "Invalid dictionary code.");
+  const std::string &value = GetValue(code);
+  return new Field(TypeId::kTypeChar, const_cast<char *>(value.data()), value.size(), true);
+}
+
+Field *Dictionary::FindCeiling(const Field &value) const {
+  Field *ceiling = nullptr;
+  uint32_t size = GetSize();
+  for (uint32_t code = 0; code < size; code++) {
+    std::unique_ptr<Field> candidate(Decode(code));
+    if (candidate->CompareGreaterThan(value) == CmpBool::kTrue &&
+        (ceiling == nullptr || candidate->CompareLessThan(*ceiling) == CmpBool::kTrue)) {
+      delete ceiling;
+      ceiling = candidate.release();
+    }
+  }
+  return ceiling;
+}
@@ -2,7 +2,8 @@
 
 uint32_t Row::SerializeTo(char *buf, Schema *schema) const {
   ASSERT(schema != nullptr, "Invalid schema before serialize.");
-  ASSERT(schema->GetColumnCount() == fields_.size(), "Fields size do not match schema's column size.");
+  // a row read without the defaults of later columns is written back as it was
+  ASSERT(schema->GetColumnCount() >= fields_.size(), "Fields size do not match schema's column size.");
   char *buf_p = buf;
   /*// magic num
   MACH_WRITE_UINT32(buf_p, ROW_MAGIC_NUM);
@@ -11,17 +12,35 @@ uint32_t Row::SerializeTo(char *buf, Schema *schema) const {
   MACH_WRITE_TO(RowId, buf_p, rid_);
   buf_p += sizeof(RowId);
   // 写入fields数
-  MACH_WRITE_UINT32(buf_p, fields_.size());
+  uint32_t field_num = GetStoredFieldCount(schema);
+  MACH_WRITE_UINT32(buf_p, field_num);
   buf_p += sizeof(uint32_t);
-  // 写入fields
-  for(auto field: fields_){
-    buf_p += field->SerializeTo(buf_p);
+  // 写入fields，溢出的值只写前缀和溢出页链的首页
+  for(uint32_t i = 0; i < field_num; i++){
+    // 字典编码的列只写code
+    if (schema->GetColumn(i)->IsDictionaryEncoded()) {
+      MACH_WRITE_INT32(buf_p, fields_[i]->IsNull() ? NULL_CODE : GetCode(schema->GetColumn(i), i));
+      buf_p += sizeof(int32_t);
+      continue;
+    }
+    const OverflowRef *overflow = overflows_.empty() ? nullptr : FindOverflow(i);
+    if (overflow == nullptr) {
+      buf_p += fields_[i]->SerializeTo(buf_p);
+      continue;
+    }
+    MACH_WRITE_UINT32(buf_p, overflow->length_ | OVERFLOW_FLAG);
+    buf_p += sizeof(uint32_t);
+    memcpy(buf_p, fields_[i]->GetData(), OVERFLOW_PREFIX_SIZE);
+    buf_p += OVERFLOW_PREFIX_SIZE;
+    MACH_WRITE_TO(page_id_t, buf_p, overflow->first_page_id_);
+    buf_p += sizeof(page_id_t);
   }
   return buf_p - buf;
 }
 
-uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
-  fields_.clear();
+uint32_t Row::DeserializeFrom(char *buf, Schema *schema, bool fill_defaults) {
+  // a row read into again drops its old fields
+  destroy();
   ASSERT(schema != nullptr, "Invalid schema before serialize.");
   ASSERT(fields_.empty(), "Non empty field in row.");
   char *buf_p = buf;
@@ -37,27 +56,94 @@ uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
   buf_p += sizeof(uint32_t);
   assert(field_num <= schema->GetColumnCount());
   // 读fields
-  while(fields_.size() < field_num){
-    fields_.push_back(nullptr);
+  fields_.resize(field_num, nullptr);
+  for(uint32_t i = 0; i < field_num; i++){
+    const Column *column = schema->GetColumn(i);
+    TypeId type = column->GetType();
+    if (column->IsDictionaryEncoded()) {
+      // 没有字典时读出的是code本身
+      int32_t code = MACH_READ_INT32(buf_p);
+      buf_p += sizeof(int32_t);
+      if (code == NULL_CODE) {
+        fields_[i] = new Field(column->GetDictionary() != nullptr ? type : TypeId::kTypeInt);
+      } else {
+        fields_[i] = column->GetDictionary() != nullptr ? column->GetDictionary()->Decode(code)
+                                                        : new Field(TypeId::kTypeInt, code);
+      }
+      continue;
+    }
+    if (type == TypeId::kTypeChar && (MACH_READ_UINT32(buf_p) & OVERFLOW_FLAG)) {
+      // 溢出的值先只读前缀，由table heap按需读出整个值
+      uint32_t length = MACH_READ_UINT32(buf_p) & ~OVERFLOW_FLAG;
+      buf_p += sizeof(uint32_t);
+      fields_[i] = new Field(TypeId::kTypeChar, buf_p, OVERFLOW_PREFIX_SIZE, true);
+      buf_p += OVERFLOW_PREFIX_SIZE;
+      overflows_.push_back({i, MACH_READ_FROM(page_id_t, buf_p), length, false});
+      buf_p += sizeof(page_id_t);
+      continue;
+    }
+    buf_p += Field::DeserializeFrom(buf_p, type, &fields_[i], false);
   }
-  for(int i = 0; i < field_num; i++){
-    Column column = schema->GetColumn(i);
-    fields_[i] = new Field(column.GetType());
-    buf_p += Field::DeserializeFrom(buf_p, column.GetType(), &fields_[i], false);
+  // 旧版本schema写入的行没有后加的列，补上这些列的默认值
+  for(uint32_t i = field_num; fill_defaults && i < schema->GetColumnCount(); i++){
+    const Column *column = schema->GetColumn(i);
+    fields_.push_back(column->GetDefault() != nullptr ? new Field(*column->GetDefault()) : new Field(column->GetType()));
   }
   return buf_p - buf;
 }
 
 uint32_t Row::GetSerializedSize(Schema *schema) const {
   ASSERT(schema != nullptr, "Invalid schema before serialize.");
-  ASSERT(schema->GetColumnCount() == fields_.size(), "Fields size do not match schema's column size.");
+  ASSERT(schema->GetColumnCount() >= fields_.size(), "Fields size do not match schema's column size.");
   uint32_t cnt = sizeof(RowId) + sizeof(uint32_t);
-  for(auto field: fields_){
-    cnt += field->GetSerializedSize();
+  uint32_t field_num = GetStoredFieldCount(schema);
+  for(uint32_t i = 0; i < field_num; i++){
+    if (schema->GetColumn(i)->IsDictionaryEncoded()) {
+      cnt += sizeof(int32_t);
+    } else if (!overflows_.empty() && FindOverflow(i) != nullptr) {
+      cnt += sizeof(uint32_t) + OVERFLOW_PREFIX_SIZE + sizeof(page_id_t);
+    } else {
+      cnt += fields_[i]->GetSerializedSize();
+    }
   }
   return cnt;
 }
 
+const OverflowRef *Row::FindOverflow(uint32_t field_index) const {
+  for (auto &overflow : overflows_) {
+    if (overflow.field_index_ == field_index) {
+      return &overflow;
+    }
+  }
+  return nullptr;
+}
+
+int32_t Row::GetCode(const Column *column, uint32_t field_index) const {
+  const Field *field = fields_[field_index];
+  int32_t code;
+  if (field->GetTypeId() == TypeId::kTypeInt) {
+    char buf[sizeof(int32_t)];
+    field->SerializeTo(buf);
+    code = MACH_READ_INT32(buf);
+  } else {
+    [[maybe_unused]] bool found = column->GetDictionary() != nullptr && column->GetDictionary()->Lookup(*field, code);
+    ASSERT(found, "Value is not in the dictionary of its column.");
+  }
+  return code;
+}
+
+uint32_t Row::GetStoredFieldCount(const Schema *schema) const {
+  uint32_t field_num = fields_.size();
+  while (field_num > 0 && fields_[field_num - 1]->IsNull()) {
+    const Column *column = schema->GetColumn(field_num - 1);
+    if (column->GetVersion() == 0 || column->GetDefault() != nullptr) {
+      break;
+    }
+    field_num--;
+  }
+  return field_num;
+}
+
 void Row::GetKeyFromRow(const Schema *schema, const Schema *key_schema, Row &key_row) {
   auto columns = key_schema->GetColumns();
   std::vector<Field> fields;
@@ -1,5 +1,21 @@
 #include "record/schema.h"
 
+#include <algorithm>
+
+void Schema::AddColumn(Column *column) {
+  column->table_ind_ = columns_.size();
+  column->version_ = GetVersion() + 1;
+  columns_.push_back(column);
+}
+
+uint32_t Schema::GetVersion() const {
+  uint32_t version = 0;
+  for (auto column : columns_) {
+    version = std::max(version, column->version_);
+  }
+  return version;
+}
+
 uint32_t Schema::SerializeTo(char *buf) const {
   char *buf_p = buf;
   MACH_WRITE_UINT32(buf_p, SCHEMA_MAGIC_NUM);
@@ -0,0 +1,77 @@
+#include "storage/bloom_filter.h"
+
+#include <algorithm>
+#include <cstring>
+
+BloomFilter::BloomFilter(uint32_t key_count, uint32_t bits_per_key) {
+  // k = bits_per_key * ln 2 probes are best for a filter of this size
+  probes_ = std::clamp<uint32_t>(bits_per_key * 69 / 100, 1, 30);
+  bit_count_ = std::max<uint64_t>(64, static_cast<uint64_t>(key_count) * bits_per_key);
+  bits_.assign((bit_count_ + 63) / 64, 0);
+  bit_count_ = bits_.size() * 64;
+}
+
+void BloomFilter::Add(const std::string &key) {
+  if (bits_.empty()) {
+    return;
+  }
+  uint64_t hash = Hash(key);
+  // double hashing, the i-th probe is h1 + i * h2
+  uint64_t delta = (hash >> 33) | 1;
+  for (uint32_t i = 0; i < probes_; i++) {
+    uint64_t bit = hash % bit_count_;
+    bits_[bit / 64] |= uint64_t{1} << (bit % 64);
+    hash += delta;
+  }
+}
+
+bool BloomFilter::MayContain(const std::string &key) const {
+  if (bits_.empty()) {
+    return true;
+  }
+  uint64_t hash = Hash(key);
+  uint64_t delta = (hash >> 33) | 1;
+  for (uint32_t i = 0; i < probes_; i++) {
+    uint64_t bit = hash % bit_count_;
+    if ((bits_[bit / 64] & (uint64_t{1} << (bit % 64))) == 0) {
+      return false;
+    }
+    hash += delta;
+  }
+  return true;
+}
+
+uint32_t BloomFilter::GetSerializedSize() const {
+  return sizeof(uint32_t) + sizeof(uint32_t) + bits_.size() * sizeof(uint64_t);
+}
+
+void BloomFilter::SerializeTo(char *buf) const {
+  uint32_t words = bits_.size();
+  memcpy(buf, &probes_, sizeof(uint32_t));
+  memcpy(buf + sizeof(uint32_t), &words, sizeof(uint32_t));
+  memcpy(buf + 2 * sizeof(uint32_t), bits_.data(), words * sizeof(uint64_t));
+}
+
+void BloomFilter::DeserializeFrom(const char *buf) {
+  uint32_t words;
+  memcpy(&probes_, buf, sizeof(uint32_t));
+  memcpy(&words, buf + sizeof(uint32_t), sizeof(uint32_t));
+  bits_.resize(words);
+  memcpy(bits_.data(), buf + 2 * sizeof(uint32_t), words * sizeof(uint64_t));
+  bit_count_ = static_cast<uint64_t>(words) * 64;
+}
+
+uint64_t BloomFilter::Hash(const std::string &key) {
+  // FNV-1a, finished with the mixer of MurmurHash3 to spread the bits of short keys
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : key) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
@@ -0,0 +1,207 @@
+#include "storage/clustered_heap.h"
+
+#include <utility>
+
+#include "page/clustered_meta_page.h"
+#include "storage/disk_manager.h"
+
+ClusteredHeap::ClusteredHeap(BufferPoolManager *buffer_pool_manager, page_id_t meta_page_id,
+                             index_id_t primary_index_id, ClusteredTable *table)
+    : buffer_pool_manager_(buffer_pool_manager),
+      meta_page_id_(meta_page_id),
+      primary_index_id_(primary_index_id),
+      table_(table) {}
+
+ClusteredHeap *ClusteredHeap::Create(BufferPoolManager *buffer_pool_manager, Schema *schema,
+                                     const std::vector<uint32_t> &key_map, index_id_t first_index_id,
+                                     uint32_t space_id) {
+  ClusteredTable *table = ClusteredTable::Create(buffer_pool_manager, schema, key_map, first_index_id, space_id);
+  if (table == nullptr) {
+    return nullptr;
+  }
+  page_id_t meta_page_id;
+  auto page = reinterpret_cast<ClusteredMetaPage *>(buffer_pool_manager->NewPage(meta_page_id, space_id));
+  if (page == nullptr || table->CreateRowIdIndex(first_index_id + 1) != DB_SUCCESS) {
+    if (page != nullptr) {
+      buffer_pool_manager->UnpinPage(meta_page_id, false);
+      buffer_pool_manager->DeletePage(meta_page_id);
+    }
+    table->Destroy();
+    delete table;
+    return nullptr;
+  }
+  page->Init(meta_page_id, first_index_id, first_index_id + 1, key_map);
+  buffer_pool_manager->UnpinPage(meta_page_id, true);
+  return new ClusteredHeap(buffer_pool_manager, meta_page_id, first_index_id, table);
+}
+
+ClusteredHeap *ClusteredHeap::Open(BufferPoolManager *buffer_pool_manager, Schema *schema, page_id_t meta_page_id) {
+  auto page = reinterpret_cast<ClusteredMetaPage *>(buffer_pool_manager->FetchPage(meta_page_id));
+  ASSERT(page != nullptr, "Can not fetch the clustered meta page.");
+  index_id_t primary_index_id = page->GetPrimaryIndexId();
+  index_id_t row_id_index_id = page->GetRowIdIndexId();
+  std::vector<uint32_t> key_map = page->GetKeyMap();
+  uint64_t reserved = page->GetReservedRowIds();
+  buffer_pool_manager->UnpinPage(meta_page_id, false);
+  ClusteredTable *table = ClusteredTable::Create(buffer_pool_manager, schema, key_map, primary_index_id,
+                                                 DiskManager::GetTablespaceId(meta_page_id));
+  ASSERT(table != nullptr && table->CreateRowIdIndex(row_id_index_id) == DB_SUCCESS,
+         "Can not open the trees of a clustered table.");
+  auto *heap = new ClusteredHeap(buffer_pool_manager, meta_page_id, primary_index_id, table);
+  // the row ids up to the reserved one may have been handed out before
+  heap->next_sequence_ = reserved;
+  heap->reserved_sequence_ = reserved;
+  return heap;
+}
+
+bool ClusteredHeap::InsertTuple(Row &row) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  row.SetRowId(NextRowId());
+  return table_->InsertRow(row, nullptr) == DB_SUCCESS;
+}
+
+bool ClusteredHeap::MarkDelete(const RowId &rid) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  Row row;
+  if (table_->GetRowByRowId(rid, row, nullptr) != DB_SUCCESS) {
+    return false;
+  }
+  return marked_.insert(rid.Get()).second;
+}
+
+bool ClusteredHeap::UpdateTuple(Row &row, const RowId &rid) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  Row old_row;
+  if (marked_.count(rid.Get()) != 0 || table_->GetRowByRowId(rid, old_row, nullptr) != DB_SUCCESS) {
+    return false;
+  }
+  row.SetRowId(rid);
+  Row old_key = GetKey(old_row);
+  if (SameKey(old_key, GetKey(row))) {
+    return table_->UpdateRow(row, nullptr) == DB_SUCCESS;
+  }
+  // a new primary key moves the row to its place in the tree, the old one is put back if it can not go there
+  table_->RemoveRow(old_key, nullptr);
+  if (table_->InsertRow(row, nullptr) == DB_SUCCESS) {
+    return true;
+  }
+  dberr_t restored = table_->InsertRow(old_row, nullptr);
+  ASSERT(restored == DB_SUCCESS, "Can not put back a clustered row.");
+  return false;
+}
+
+void ClusteredHeap::ApplyDelete(const RowId &rid) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  marked_.erase(rid.Get());
+  Row row;
+  if (table_->GetRowByRowId(rid, row, nullptr) == DB_SUCCESS) {
+    table_->RemoveRow(GetKey(row), nullptr);
+  }
+}
+
+void ClusteredHeap::RollbackDelete(const RowId &rid) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  marked_.erase(rid.Get());
+}
+
+bool ClusteredHeap::GetTuple(Row *row) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  RowId rid = row->GetRowId();
+  return marked_.count(rid.Get()) == 0 && table_->GetRowByRowId(rid, *row, nullptr) == DB_SUCCESS;
+}
+
+bool ClusteredHeap::GetTupleByKey(const Row &key, Row *row) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return table_->GetRow(key, *row, nullptr) == DB_SUCCESS && marked_.count(row->GetRowId().Get()) == 0;
+}
+
+bool ClusteredHeap::ReadKeyRange(const Row *low, bool after, const Row *high, std::vector<Row> &rows,
+                                 size_t &row_count, Row &last_key) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<Row> batch;
+  table_->ScanRange(low, high, batch, true, CLUSTERED_ROWS_PER_PAGE);
+  size_t first = after && !batch.empty() && SameKey(GetKey(batch.front()), *low) ? 1 : 0;
+  row_count = 0;
+  if (first == batch.size()) {
+    return false;
+  }
+  last_key = GetKey(batch.back());
+  for (size_t i = first; i < batch.size(); i++) {
+    if (marked_.count(batch[i].GetRowId().Get()) != 0) {
+      continue;
+    }
+    if (rows.size() <= row_count) {
+      rows.resize(row_count + 1);
+    }
+    std::swap(rows[row_count++], batch[i]);
+  }
+  return true;
+}
+
+page_id_t ClusteredHeap::ReadPage(page_id_t page_id, std::vector<Row> &rows, size_t &row_count) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  page_id_t next_page_id = table_->ReadRowIdPage(page_id, rows, row_count, nullptr);
+  if (!marked_.empty()) {
+    size_t visible = 0;
+    for (size_t i = 0; i < row_count; i++) {
+      if (marked_.count(rows[i].GetRowId().Get()) == 0) {
+        if (visible != i) {
+          std::swap(rows[visible], rows[i]);
+        }
+        visible++;
+      }
+    }
+    row_count = visible;
+  }
+  return next_page_id;
+}
+
+std::vector<page_id_t> ClusteredHeap::GetPageIds() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return table_->GetRowIdPages();
+}
+
+void ClusteredHeap::Destroy(PageReclaimer *reclaimer) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  table_->Destroy(reclaimer);
+  if (reclaimer == nullptr) {
+    buffer_pool_manager_->DeletePage(meta_page_id_);
+  } else {
+    BufferPoolManager *buffer_pool_manager = buffer_pool_manager_;
+    page_id_t meta_page_id = meta_page_id_;
+    reclaimer->Submit([buffer_pool_manager, meta_page_id] { buffer_pool_manager->DeletePage(meta_page_id); });
+  }
+  meta_page_id_ = INVALID_PAGE_ID;
+}
+
+Row ClusteredHeap::GetKey(const Row &row) const {
+  std::vector<Field> fields;
+  for (auto column_index : table_->GetKeyMap()) {
+    fields.emplace_back(*row.GetField(column_index));
+  }
+  return Row(fields);
+}
+
+bool ClusteredHeap::SameKey(const Row &key, const Row &other) {
+  for (uint32_t i = 0; i < key.GetFieldCount(); i++) {
+    if (key.GetField(i)->CompareEquals(*other.GetField(i)) != CmpBool::kTrue) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RowId ClusteredHeap::NextRowId() {
+  if (next_sequence_ == reserved_sequence_) {
+    reserved_sequence_ += CLUSTERED_ROW_ID_CACHE_SIZE;
+    auto page = reinterpret_cast<ClusteredMetaPage *>(buffer_pool_manager_->FetchPage(meta_page_id_));
+    ASSERT(page != nullptr, "Can not fetch the clustered meta page.");
+    page->SetReservedRowIds(reserved_sequence_);
+    buffer_pool_manager_->UnpinPage(meta_page_id_, true);
+  }
+  return ToRowId(next_sequence_++);
+}
+
+RowId ClusteredHeap::ToRowId(uint64_t sequence) {
+  return RowId(static_cast<page_id_t>(sequence / CLUSTERED_ROWS_PER_PAGE), sequence % CLUSTERED_ROWS_PER_PAGE);
+}
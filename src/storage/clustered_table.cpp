@@ -0,0 +1,453 @@
+#include "storage/clustered_table.h"
+
+#include <limits>
+
+#include "glog/logging.h"
+#include "page/index_roots_page.h"
+
+// a tree with fewer entries to a page than this can not split a page in two useful halves
+static constexpr int MIN_ENTRIES_PER_PAGE = 4;
+
+static int32_t ReadIntField(const Field *field) {
+  char buf[sizeof(int32_t)];
+  field->SerializeTo(buf);
+  return MACH_READ_INT32(buf);
+}
+
+ClusteredTable *ClusteredTable::Create(BufferPoolManager *buffer_pool_manager, Schema *schema,
+                                       const std::vector<uint32_t> &key_map, index_id_t index_id, uint32_t space_id) {
+  auto *table = new ClusteredTable(buffer_pool_manager, schema, space_id);
+  bool is_new;
+  table->primary_ = table->OpenTree(key_map, Schema::ShallowCopySchema(schema, key_map), index_id,
+                                    MaxSerializedSize(schema), &is_new);
+  if (table->primary_ == nullptr) {
+    delete table;
+    return nullptr;
+  }
+  return table;
+}
+
+bool ClusteredTable::CanStore(uint32_t page_size, const Schema *schema, const std::vector<uint32_t> &key_map) {
+  std::unique_ptr<Schema> key_schema(Schema::ShallowCopySchema(schema, key_map));
+  uint32_t key_size = MaxSerializedSize(key_schema.get());
+  return FitsPage(page_size, key_size, key_size + MaxSerializedSize(schema));
+}
+
+dberr_t ClusteredTable::CreateSecondaryIndex(const std::vector<uint32_t> &key_map, index_id_t index_id) {
+  // the primary key behind the secondary one keeps the entries of rows with the same secondary key apart
+  std::vector<uint32_t> tree_key_map = key_map;
+  tree_key_map.insert(tree_key_map.end(), primary_->key_map_.begin(), primary_->key_map_.end());
+  bool is_new;
+  std::unique_ptr<KeyTree> secondary =
+      OpenTree(tree_key_map, Schema::ShallowCopySchema(schema_, tree_key_map), index_id, 0, &is_new);
+  if (secondary == nullptr) {
+    return DB_FAILED;
+  }
+  secondary->lookup_count_ = key_map.size();
+  if (is_new && !primary_->tree_->IsEmpty()) {
+    std::unique_ptr<char[]> entry(new char[secondary->entry_size_]);
+    Row row;
+    for (auto iter = primary_->tree_->Begin(); iter != primary_->tree_->End(); ++iter) {
+      row.DeserializeFrom(reinterpret_cast<char *>((*iter).first) + primary_->key_size_, schema_);
+      WriteKey(*secondary, row, entry.get());
+      secondary->tree_->Insert(AsKey(entry.get()), INVALID_ROWID);
+    }
+  }
+  secondaries_.push_back(std::move(secondary));
+  return DB_SUCCESS;
+}
+
+dberr_t ClusteredTable::CreateRowIdIndex(index_id_t index_id) {
+  std::vector<Column *> columns = {new Column("page_id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("slot", TypeId::kTypeInt, 1, false, false)};
+  bool is_new;
+  std::unique_ptr<KeyTree> row_ids = OpenTree({}, new Schema(columns), index_id, primary_->key_size_, &is_new);
+  if (row_ids == nullptr) {
+    return DB_FAILED;
+  }
+  row_ids_ = std::move(row_ids);
+  if (is_new && !primary_->tree_->IsEmpty()) {
+    std::unique_ptr<char[]> entry(new char[row_ids_->entry_size_]);
+    Row row;
+    for (auto iter = primary_->tree_->Begin(); iter != primary_->tree_->End(); ++iter) {
+      row.DeserializeFrom(reinterpret_cast<char *>((*iter).first) + primary_->key_size_, schema_);
+      WriteRowIdEntry(row, entry.get());
+      row_ids_->tree_->Insert(AsKey(entry.get()), INVALID_ROWID);
+    }
+  }
+  return DB_SUCCESS;
+}
+
+dberr_t ClusteredTable::InsertRow(const Row &row, Transaction *txn) {
+  if (row.GetFieldCount() != schema_->GetColumnCount() ||
+      row.GetSerializedSize(schema_) > primary_->entry_size_ - primary_->key_size_) {
+    return DB_FAILED;
+  }
+  std::unique_ptr<char[]> entry(new char[primary_->entry_size_]);
+  WriteKey(*primary_, row, entry.get());
+  row.SerializeTo(entry.get() + primary_->key_size_, schema_);
+  if (!primary_->tree_->Insert(AsKey(entry.get()), INVALID_ROWID, txn)) {
+    return DB_FAILED;
+  }
+  if (!InsertIndexEntries(row, txn)) {
+    primary_->tree_->Remove(AsKey(entry.get()), txn);
+    return DB_FAILED;
+  }
+  return DB_SUCCESS;
+}
+
+dberr_t ClusteredTable::UpdateRow(const Row &row, Transaction *txn) {
+  if (row.GetFieldCount() != schema_->GetColumnCount() ||
+      row.GetSerializedSize(schema_) > primary_->entry_size_ - primary_->key_size_) {
+    return DB_FAILED;
+  }
+  std::unique_ptr<char[]> entry(new char[primary_->entry_size_]);
+  std::unique_ptr<char[]> old_entry(new char[primary_->entry_size_]);
+  WriteKey(*primary_, row, entry.get());
+  if (!primary_->tree_->GetKey(AsKey(entry.get()), AsKey(old_entry.get()), txn)) {
+    return DB_KEY_NOT_FOUND;
+  }
+  Row old_row;
+  old_row.DeserializeFrom(old_entry.get() + primary_->key_size_, schema_);
+  // the primary key is the same, so only the secondary keys that change move, and no entry of theirs can be taken
+  for (auto &secondary : secondaries_) {
+    std::unique_ptr<char[]> new_key(new char[secondary->entry_size_]);
+    std::unique_ptr<char[]> old_key(new char[secondary->entry_size_]);
+    WriteKey(*secondary, row, new_key.get());
+    WriteKey(*secondary, old_row, old_key.get());
+    if (memcmp(new_key.get(), old_key.get(), secondary->key_size_) != 0) {
+      secondary->tree_->Remove(AsKey(old_key.get()), txn);
+      secondary->tree_->Insert(AsKey(new_key.get()), INVALID_ROWID, txn);
+    }
+  }
+  row.SerializeTo(entry.get() + primary_->key_size_, schema_);
+  RowId rid = old_row.GetRowId();
+  MACH_WRITE_TO(RowId, entry.get() + primary_->key_size_, rid);
+  primary_->tree_->ReplaceKey(AsKey(entry.get()), txn);
+  return DB_SUCCESS;
+}
+
+dberr_t ClusteredTable::RemoveRow(const Row &key, Transaction *txn) {
+  std::unique_ptr<char[]> entry(new char[primary_->entry_size_]);
+  WriteSearchKey(*primary_, key, entry.get());
+  if (!primary_->tree_->GetKey(AsKey(entry.get()), AsKey(entry.get()), txn)) {
+    return DB_KEY_NOT_FOUND;
+  }
+  Row row;
+  row.DeserializeFrom(entry.get() + primary_->key_size_, schema_);
+  RemoveIndexEntries(row, txn);
+  primary_->tree_->Remove(AsKey(entry.get()), txn);
+  return DB_SUCCESS;
+}
+
+dberr_t ClusteredTable::GetRow(const Row &key, Row &row, Transaction *txn) {
+  std::unique_ptr<char[]> entry(new char[primary_->entry_size_]);
+  WriteSearchKey(*primary_, key, entry.get());
+  if (!primary_->tree_->GetKey(AsKey(entry.get()), AsKey(entry.get()), txn)) {
+    return DB_KEY_NOT_FOUND;
+  }
+  row.DeserializeFrom(entry.get() + primary_->key_size_, schema_);
+  return DB_SUCCESS;
+}
+
+dberr_t ClusteredTable::GetRowsBySecondary(index_id_t index_id, const Row &key, std::vector<Row> &rows,
+                                           Transaction *txn) {
+  KeyTree *secondary = FindSecondary(index_id);
+  if (secondary == nullptr) {
+    return DB_INDEX_NOT_FOUND;
+  }
+  if (secondary->tree_->IsEmpty()) {
+    return DB_SUCCESS;
+  }
+  ASSERT(key.GetFieldCount() == secondary->lookup_count_, "field nums not match.");
+  // the entries of the key start behind the smallest primary key
+  std::vector<Field> fields;
+  for (uint32_t i = 0; i < secondary->key_map_.size(); i++) {
+    if (i < secondary->lookup_count_) {
+      fields.emplace_back(*key.GetField(i));
+    } else if (schema_->GetColumn(secondary->key_map_[i])->GetType() == TypeId::kTypeInt) {
+      fields.emplace_back(TypeId::kTypeInt, std::numeric_limits<int32_t>::min());
+    } else if (schema_->GetColumn(secondary->key_map_[i])->GetType() == TypeId::kTypeFloat) {
+      fields.emplace_back(TypeId::kTypeFloat, std::numeric_limits<float>::lowest());
+    } else {
+      fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(""), 0, true);
+    }
+  }
+  std::unique_ptr<char[]> low_key(new char[secondary->entry_size_]);
+  WriteSearchKey(*secondary, Row(fields), low_key.get());
+  std::unique_ptr<char[]> entry(new char[primary_->entry_size_]);
+  Row entry_key;
+  auto end = secondary->tree_->End();
+  for (auto iter = secondary->tree_->Begin(AsKey(low_key.get())); iter != end; ++iter) {
+    entry_key.DeserializeFrom(reinterpret_cast<char *>((*iter).first), secondary->key_schema_.get());
+    for (uint32_t i = 0; i < secondary->lookup_count_; i++) {
+      if (entry_key.GetField(i)->CompareEquals(*key.GetField(i)) != CmpBool::kTrue) {
+        return DB_SUCCESS;
+      }
+    }
+    std::vector<Field> primary_fields;
+    for (uint32_t i = secondary->lookup_count_; i < secondary->key_map_.size(); i++) {
+      primary_fields.emplace_back(*entry_key.GetField(i));
+    }
+    WriteSearchKey(*primary_, Row(primary_fields), entry.get());
+    if (!primary_->tree_->GetKey(AsKey(entry.get()), AsKey(entry.get()), txn)) {
+      return DB_FAILED;
+    }
+    rows.emplace_back();
+    rows.back().DeserializeFrom(entry.get() + primary_->key_size_, schema_);
+  }
+  return DB_SUCCESS;
+}
+
+dberr_t ClusteredTable::GetRowByRowId(const RowId &rid, Row &row, Transaction *txn) {
+  if (row_ids_ == nullptr) {
+    return DB_INDEX_NOT_FOUND;
+  }
+  std::unique_ptr<char[]> row_id_entry(new char[row_ids_->entry_size_]);
+  WriteRowIdKey(rid, row_id_entry.get());
+  if (!row_ids_->tree_->GetKey(AsKey(row_id_entry.get()), AsKey(row_id_entry.get()), txn)) {
+    return DB_KEY_NOT_FOUND;
+  }
+  // the primary key is stored behind the row id as a search key of the primary tree
+  std::unique_ptr<char[]> entry(new char[primary_->entry_size_]);
+  memset(entry.get(), 0, primary_->entry_size_);
+  memcpy(entry.get(), row_id_entry.get() + row_ids_->key_size_, primary_->key_size_);
+  if (!primary_->tree_->GetKey(AsKey(entry.get()), AsKey(entry.get()), txn)) {
+    return DB_KEY_NOT_FOUND;
+  }
+  row.DeserializeFrom(entry.get() + primary_->key_size_, schema_);
+  return DB_SUCCESS;
+}
+
+dberr_t ClusteredTable::ScanRange(const Row *low, const Row *high, std::vector<Row> &rows, bool include_high,
+                                  size_t limit) {
+  BPlusTree *tree = primary_->tree_.get();
+  if (tree->IsEmpty()) {
+    return DB_SUCCESS;
+  }
+  std::unique_ptr<char[]> low_key(new char[primary_->entry_size_]);
+  if (low != nullptr) {
+    WriteSearchKey(*primary_, *low, low_key.get());
+  }
+  auto end = tree->End();
+  size_t count = 0;
+  for (auto iter = low == nullptr ? tree->Begin() : tree->Begin(AsKey(low_key.get())); iter != end && count < limit;
+       ++iter, ++count) {
+    rows.emplace_back();
+    rows.back().DeserializeFrom(reinterpret_cast<char *>((*iter).first) + primary_->key_size_, schema_);
+    // the key fields of the row read decide, that spares the key manager deserializing both keys again
+    if (high != nullptr && CompareKey(*primary_, rows.back(), *high) >= (include_high ? 1 : 0)) {
+      rows.pop_back();
+      break;
+    }
+  }
+  return DB_SUCCESS;
+}
+
+page_id_t ClusteredTable::ReadRowIdPage(page_id_t page_id, std::vector<Row> &rows, size_t &row_count,
+                                        Transaction *txn) {
+  row_count = 0;
+  if (row_ids_ == nullptr || row_ids_->tree_->IsEmpty()) {
+    return INVALID_PAGE_ID;
+  }
+  std::unique_ptr<char[]> low_key(new char[row_ids_->entry_size_]);
+  WriteRowIdKey(RowId(page_id, 0), low_key.get());
+  std::unique_ptr<char[]> entry(new char[primary_->entry_size_]);
+  memset(entry.get(), 0, primary_->entry_size_);
+  Row rid_key;
+  auto end = row_ids_->tree_->End();
+  for (auto iter = row_ids_->tree_->Begin(AsKey(low_key.get())); iter != end; ++iter) {
+    char *row_id_entry = reinterpret_cast<char *>((*iter).first);
+    rid_key.DeserializeFrom(row_id_entry, row_ids_->key_schema_.get());
+    page_id_t next_page_id = static_cast<page_id_t>(ReadIntField(rid_key.GetField(0)));
+    if (next_page_id != page_id) {
+      return next_page_id;
+    }
+    memcpy(entry.get(), row_id_entry + row_ids_->key_size_, primary_->key_size_);
+    bool found = primary_->tree_->GetKey(AsKey(entry.get()), AsKey(entry.get()), txn);
+    ASSERT(found, "The row id tree refers to a missing row.");
+    if (rows.size() <= row_count) {
+      rows.resize(row_count + 1);
+    }
+    rows[row_count++].DeserializeFrom(entry.get() + primary_->key_size_, schema_);
+  }
+  return INVALID_PAGE_ID;
+}
+
+std::vector<page_id_t> ClusteredTable::GetRowIdPages() {
+  std::vector<page_id_t> page_ids;
+  if (row_ids_ == nullptr) {
+    return page_ids;
+  }
+  for (page_id_t page_id = SeekRowIdPage(0); page_id != INVALID_PAGE_ID; page_id = SeekRowIdPage(page_id + 1)) {
+    page_ids.push_back(page_id);
+  }
+  return page_ids;
+}
+
+void ClusteredTable::Destroy(PageReclaimer *reclaimer) {
+  std::vector<KeyTree *> trees{primary_.get(), row_ids_.get()};
+  for (auto &secondary : secondaries_) {
+    trees.push_back(secondary.get());
+  }
+  for (auto key_tree : trees) {
+    if (key_tree == nullptr) {
+      continue;
+    }
+    if (reclaimer != nullptr) {
+      key_tree->tree_->Detach(reclaimer, false);
+    } else {
+      key_tree->tree_->Destroy();
+    }
+  }
+}
+
+std::unique_ptr<ClusteredTable::KeyTree> ClusteredTable::OpenTree(const std::vector<uint32_t> &key_map,
+                                                                  Schema *key_schema, index_id_t index_id,
+                                                                  uint32_t payload_size, bool *is_new) {
+  auto key_tree = std::make_unique<KeyTree>();
+  key_tree->index_id_ = index_id;
+  key_tree->key_map_ = key_map;
+  key_tree->lookup_count_ = key_map.size();
+  key_tree->key_schema_.reset(key_schema);
+  key_tree->key_size_ = MaxSerializedSize(key_tree->key_schema_.get());
+  key_tree->entry_size_ = key_tree->key_size_ + payload_size;
+  if (!FitsPage(buffer_pool_manager_->GetPageSize(), key_tree->key_size_, key_tree->entry_size_)) {
+    LOG(WARNING) << "Entries of " << key_tree->entry_size_ << " bytes do not fit a tree of "
+                 << buffer_pool_manager_->GetPageSize() << " byte pages." << std::endl;
+    return nullptr;
+  }
+  // a new tree starts from a blank root, like the ones the catalog gives to new indexes
+  auto *index_roots_page =
+      reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  page_id_t root_page_id;
+  *is_new = !index_roots_page->GetRootId(index_id, &root_page_id);
+  if (*is_new) {
+    if (buffer_pool_manager_->NewPage(root_page_id, space_id_) == nullptr) {
+      buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+      return nullptr;
+    }
+    index_roots_page->Insert(index_id, root_page_id);
+    buffer_pool_manager_->UnpinPage(root_page_id, true);
+  }
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, *is_new);
+  key_tree->processor_ = std::make_unique<KeyManager>(key_tree->key_schema_.get(), key_tree->entry_size_);
+  // separators need the key only, internal pages leave the payload out and keep the fanout of a plain index
+  key_tree->tree_ = std::make_unique<BPlusTree>(index_id, buffer_pool_manager_, *key_tree->processor_, UNDEFINED_SIZE,
+                                                UNDEFINED_SIZE, space_id_, key_tree->key_size_);
+  return key_tree;
+}
+
+void ClusteredTable::WriteKey(const KeyTree &key_tree, const Row &row, char *entry) const {
+  std::vector<Field> fields;
+  for (auto i : key_tree.key_map_) {
+    fields.emplace_back(*row.GetField(i));
+  }
+  WriteSearchKey(key_tree, Row(fields), entry);
+}
+
+void ClusteredTable::WriteSearchKey(const KeyTree &key_tree, const Row &key, char *entry) const {
+  ASSERT(key.GetFieldCount() == key_tree.key_schema_->GetColumnCount(), "field nums not match.");
+  ASSERT(key.GetSerializedSize(key_tree.key_schema_.get()) <= key_tree.key_size_, "Key size exceed max key size.");
+  memset(entry, 0, key_tree.entry_size_);
+  key.SerializeTo(entry, key_tree.key_schema_.get());
+}
+
+void ClusteredTable::WriteRowIdEntry(const Row &row, char *entry) const {
+  WriteRowIdKey(row.GetRowId(), entry);
+  std::unique_ptr<char[]> primary_key(new char[primary_->entry_size_]);
+  WriteKey(*primary_, row, primary_key.get());
+  memcpy(entry + row_ids_->key_size_, primary_key.get(), primary_->key_size_);
+}
+
+void ClusteredTable::WriteRowIdKey(const RowId &rid, char *entry) const {
+  std::vector<Field> fields{Field(TypeId::kTypeInt, rid.GetPageId()),
+                            Field(TypeId::kTypeInt, static_cast<int32_t>(rid.GetSlotNum()))};
+  WriteSearchKey(*row_ids_, Row(fields), entry);
+}
+
+page_id_t ClusteredTable::SeekRowIdPage(page_id_t page_id) {
+  if (row_ids_->tree_->IsEmpty()) {
+    return INVALID_PAGE_ID;
+  }
+  std::unique_ptr<char[]> low_key(new char[row_ids_->entry_size_]);
+  WriteRowIdKey(RowId(page_id, 0), low_key.get());
+  auto iter = row_ids_->tree_->Begin(AsKey(low_key.get()));
+  if (iter == row_ids_->tree_->End()) {
+    return INVALID_PAGE_ID;
+  }
+  Row rid_key;
+  rid_key.DeserializeFrom(reinterpret_cast<char *>((*iter).first), row_ids_->key_schema_.get());
+  return static_cast<page_id_t>(ReadIntField(rid_key.GetField(0)));
+}
+
+bool ClusteredTable::InsertIndexEntries(const Row &row, Transaction *txn) {
+  if (row_ids_ != nullptr) {
+    std::unique_ptr<char[]> entry(new char[row_ids_->entry_size_]);
+    WriteRowIdEntry(row, entry.get());
+    if (!row_ids_->tree_->Insert(AsKey(entry.get()), INVALID_ROWID, txn)) {
+      return false;
+    }
+  }
+  // the primary key is new, so are the secondary entries that end with it
+  for (auto &secondary : secondaries_) {
+    std::unique_ptr<char[]> entry(new char[secondary->entry_size_]);
+    WriteKey(*secondary, row, entry.get());
+    secondary->tree_->Insert(AsKey(entry.get()), INVALID_ROWID, txn);
+  }
+  return true;
+}
+
+void ClusteredTable::RemoveIndexEntries(const Row &row, Transaction *txn) {
+  if (row_ids_ != nullptr) {
+    std::unique_ptr<char[]> entry(new char[row_ids_->entry_size_]);
+    WriteRowIdKey(row.GetRowId(), entry.get());
+    row_ids_->tree_->Remove(AsKey(entry.get()), txn);
+  }
+  for (auto &secondary : secondaries_) {
+    std::unique_ptr<char[]> entry(new char[secondary->entry_size_]);
+    WriteKey(*secondary, row, entry.get());
+    secondary->tree_->Remove(AsKey(entry.get()), txn);
+  }
+}
+
+bool ClusteredTable::FitsPage(uint32_t page_size, uint32_t key_size, uint32_t entry_size) {
+  int leaf_entries = (static_cast<int>(page_size) - LEAF_PAGE_HEADER_SIZE) /
+                         (static_cast<int>(entry_size) + static_cast<int>(sizeof(RowId))) - 1;
+  return leaf_entries >= MIN_ENTRIES_PER_PAGE &&
+         static_cast<int>(INTERNAL_PAGE_SIZE(page_size, key_size)) >= MIN_ENTRIES_PER_PAGE;
+}
+
+int ClusteredTable::CompareKey(const KeyTree &key_tree, const Row &row, const Row &key) {
+  for (uint32_t i = 0; i < key_tree.key_map_.size(); i++) {
+    const Field *value = row.GetField(key_tree.key_map_[i]);
+    if (value->CompareLessThan(*key.GetField(i)) == CmpBool::kTrue) {
+      return -1;
+    }
+    if (value->CompareGreaterThan(*key.GetField(i)) == CmpBool::kTrue) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+ClusteredTable::KeyTree *ClusteredTable::FindSecondary(index_id_t index_id) {
+  for (auto &secondary : secondaries_) {
+    if (secondary->index_id_ == index_id) {
+      return secondary.get();
+    }
+  }
+  return nullptr;
+}
+
+uint32_t ClusteredTable::MaxSerializedSize(const Schema *schema) {
+  // the row id and the field count in front, see Row::SerializeTo
+  uint32_t size = sizeof(RowId) + sizeof(uint32_t);
+  for (auto column : schema->GetColumns()) {
+    size += column->GetLength();
+    if (column->GetType() == TypeId::kTypeChar) {
+      size += sizeof(uint32_t);
+    }
+  }
+  return size;
+}
@@ -0,0 +1,268 @@
+#include "storage/column_kernels.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+template <CompareOp op, typename T>
+inline bool CompareScalar(T value, T constant) {
+  switch (op) {
+    case CompareOp::kEqual:
+      return value == constant;
+    case CompareOp::kNotEqual:
+      return value != constant;
+    case CompareOp::kLessThan:
+      return value < constant;
+    case CompareOp::kLessThanEquals:
+      return value <= constant;
+    case CompareOp::kGreaterThan:
+      return value > constant;
+    case CompareOp::kGreaterThanEquals:
+      return value >= constant;
+  }
+  return false;
+}
+
+#if defined(__SSE2__)
+/** @return a bit per lane of the four values that compare true */
+template <CompareOp op>
+inline uint32_t Compare4(const int32_t *values, __m128i constant) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values));
+  __m128i result;
+  switch (op) {
+    case CompareOp::kEqual:
+      result = _mm_cmpeq_epi32(v, constant);
+      break;
+    case CompareOp::kNotEqual:
+      result = _mm_xor_si128(_mm_cmpeq_epi32(v, constant), _mm_set1_epi32(-1));
+      break;
+    case CompareOp::kLessThan:
+      result = _mm_cmplt_epi32(v, constant);
+      break;
+    case CompareOp::kLessThanEquals:
+      result = _mm_xor_si128(_mm_cmpgt_epi32(v, constant), _mm_set1_epi32(-1));
+      break;
+    case CompareOp::kGreaterThan:
+      result = _mm_cmpgt_epi32(v, constant);
+      break;
+    case CompareOp::kGreaterThanEquals:
+      result = _mm_xor_si128(_mm_cmplt_epi32(v, constant), _mm_set1_epi32(-1));
+      break;
+  }
+  return _mm_movemask_ps(_mm_castsi128_ps(result));
+}
+
+template <CompareOp op>
+inline uint32_t Compare4(const float *values, __m128 constant) {
+  __m128 v = _mm_loadu_ps(values);
+  __m128 result;
+  switch (op) {
+    case CompareOp::kEqual:
+      result = _mm_cmpeq_ps(v, constant);
+      break;
+    case CompareOp::kNotEqual:
+      result = _mm_cmpneq_ps(v, constant);
+      break;
+    case CompareOp::kLessThan:
+      result = _mm_cmplt_ps(v, constant);
+      break;
+    case CompareOp::kLessThanEquals:
+      result = _mm_cmple_ps(v, constant);
+      break;
+    case CompareOp::kGreaterThan:
+      result = _mm_cmpgt_ps(v, constant);
+      break;
+    case CompareOp::kGreaterThanEquals:
+      result = _mm_cmpge_ps(v, constant);
+      break;
+  }
+  return _mm_movemask_ps(result);
+}
+
+inline __m128i Broadcast(int32_t constant) { return _mm_set1_epi32(constant); }
+
+inline __m128 Broadcast(float constant) { return _mm_set1_ps(constant); }
+
+/** @return all ones in the lanes whose bit is set in the low four bits of bits */
+inline __m128i LaneMask(uint64_t bits) {
+  const __m128i lane_bits = _mm_set_epi32(8, 4, 2, 1);
+  return _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(static_cast<int32_t>(bits & 0xF)), lane_bits), lane_bits);
+}
+#endif
+
+template <CompareOp op, typename T>
+void Filter(const T *values, uint32_t count, T constant, uint64_t *selection) {
+#if defined(__SSE2__)
+  auto vector_constant = Broadcast(constant);
+#endif
+  for (uint32_t word = 0; word * 64 < count; word++) {
+    if (selection[word] == 0) {
+      continue;
+    }
+    const T *base = values + word * 64;
+    uint32_t n = std::min<uint32_t>(64, count - word * 64);
+    uint64_t bits = 0;
+    uint32_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= n; i += 4) {
+      bits |= static_cast<uint64_t>(Compare4<op>(base + i, vector_constant)) << i;
+    }
+#endif
+    for (; i < n; i++) {
+      bits |= static_cast<uint64_t>(CompareScalar<op>(base[i], constant)) << i;
+    }
+    selection[word] &= bits;
+  }
+}
+
+template <typename T>
+void FilterByOp(const T *values, uint32_t count, CompareOp op, T constant, uint64_t *selection) {
+  switch (op) {
+    case CompareOp::kEqual:
+      return Filter<CompareOp::kEqual>(values, count, constant, selection);
+    case CompareOp::kNotEqual:
+      return Filter<CompareOp::kNotEqual>(values, count, constant, selection);
+    case CompareOp::kLessThan:
+      return Filter<CompareOp::kLessThan>(values, count, constant, selection);
+    case CompareOp::kLessThanEquals:
+      return Filter<CompareOp::kLessThanEquals>(values, count, constant, selection);
+    case CompareOp::kGreaterThan:
+      return Filter<CompareOp::kGreaterThan>(values, count, constant, selection);
+    case CompareOp::kGreaterThanEquals:
+      return Filter<CompareOp::kGreaterThanEquals>(values, count, constant, selection);
+  }
+}
+
+/** @return the selected slots of a word, without the slots behind count */
+inline uint64_t SelectedBits(const uint64_t *selection, uint32_t word, uint32_t count) {
+  uint32_t n = count - word * 64;
+  return n >= 64 ? selection[word] : selection[word] & ((uint64_t(1) << n) - 1);
+}
+
+template <typename T>
+uint32_t Project(const T *values, uint32_t count, const uint64_t *selection, T *out) {
+  uint32_t written = 0;
+  for (uint32_t word = 0; word * 64 < count; word++) {
+    uint64_t bits = SelectedBits(selection, word, count);
+    if (bits == ~uint64_t(0)) {
+      memcpy(out + written, values + word * 64, 64 * sizeof(T));
+      written += 64;
+      continue;
+    }
+    while (bits != 0) {
+      out[written++] = values[word * 64 + __builtin_ctzll(bits)];
+      bits &= bits - 1;
+    }
+  }
+  return written;
+}
+
+}  // namespace
+
+void ColumnKernels::FilterInt(const int32_t *values, uint32_t count, CompareOp op, int32_t constant,
+                              uint64_t *selection) {
+  FilterByOp(values, count, op, constant, selection);
+}
+
+void ColumnKernels::FilterFloat(const float *values, uint32_t count, CompareOp op, float constant,
+                                uint64_t *selection) {
+  FilterByOp(values, count, op, constant, selection);
+}
+
+void ColumnKernels::Exclude(const uint64_t *bitmap, uint32_t count, uint64_t *selection) {
+  for (uint32_t word = 0; word * 64 < count; word++) {
+    selection[word] &= ~bitmap[word];
+  }
+}
+
+uint32_t ColumnKernels::Count(const uint64_t *selection, uint32_t count) {
+  uint32_t result = 0;
+  for (uint32_t word = 0; word * 64 < count; word++) {
+    result += __builtin_popcountll(SelectedBits(selection, word, count));
+  }
+  return result;
+}
+
+int64_t ColumnKernels::SumInt(const int32_t *values, uint32_t count, const uint64_t *selection) {
+  int64_t sum = 0;
+#if defined(__SSE2__)
+  // two 64-bit lanes, the 32-bit values are sign extended into them
+  __m128i vector_sum = _mm_setzero_si128();
+#endif
+  for (uint32_t word = 0; word * 64 < count; word++) {
+    uint64_t bits = SelectedBits(selection, word, count);
+    if (bits == 0) {
+      continue;
+    }
+    const int32_t *base = values + word * 64;
+    uint32_t n = std::min<uint32_t>(64, count - word * 64);
+    uint32_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= n; i += 4) {
+      __m128i v = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(base + i)), LaneMask(bits >> i));
+      __m128i sign = _mm_srai_epi32(v, 31);
+      vector_sum = _mm_add_epi64(vector_sum, _mm_unpacklo_epi32(v, sign));
+      vector_sum = _mm_add_epi64(vector_sum, _mm_unpackhi_epi32(v, sign));
+    }
+#endif
+    for (; i < n; i++) {
+      if ((bits >> i) & 1) {
+        sum += base[i];
+      }
+    }
+  }
+#if defined(__SSE2__)
+  int64_t lanes[2];
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), vector_sum);
+  sum += lanes[0] + lanes[1];
+#endif
+  return sum;
+}
+
+double ColumnKernels::SumFloat(const float *values, uint32_t count, const uint64_t *selection) {
+  double sum = 0;
+#if defined(__SSE2__)
+  // floats are widened to doubles before they are added, as the scalar code does
+  __m128d vector_sum = _mm_setzero_pd();
+#endif
+  for (uint32_t word = 0; word * 64 < count; word++) {
+    uint64_t bits = SelectedBits(selection, word, count);
+    if (bits == 0) {
+      continue;
+    }
+    const float *base = values + word * 64;
+    uint32_t n = std::min<uint32_t>(64, count - word * 64);
+    uint32_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= n; i += 4) {
+      __m128 v = _mm_and_ps(_mm_loadu_ps(base + i), _mm_castsi128_ps(LaneMask(bits >> i)));
+      vector_sum = _mm_add_pd(vector_sum, _mm_cvtps_pd(v));
+      vector_sum = _mm_add_pd(vector_sum, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+#endif
+    for (; i < n; i++) {
+      if ((bits >> i) & 1) {
+        sum += base[i];
+      }
+    }
+  }
+#if defined(__SSE2__)
+  double lanes[2];
+  _mm_storeu_pd(lanes, vector_sum);
+  sum += lanes[0] + lanes[1];
+#endif
+  return sum;
+}
+
+uint32_t ColumnKernels::ProjectInt(const int32_t *values, uint32_t count, const uint64_t *selection, int32_t *out) {
+  return Project(values, count, selection, out);
+}
+
+uint32_t ColumnKernels::ProjectFloat(const float *values, uint32_t count, const uint64_t *selection, float *out) {
+  return Project(values, count, selection, out);
+}
@@ -0,0 +1,148 @@
+#include "storage/column_scan.h"
+
+ColumnScan::ColumnScan(TableHeap *table_heap, Transaction *txn) : table_heap_(table_heap), txn_(txn) {}
+
+bool ColumnScan::IsColumnOf(uint32_t column_index, TypeId type) const {
+  const ColumnLayout *layout = table_heap_->column_layout_.get();
+  return layout != nullptr && column_index < layout->GetColumnCount() && layout->GetType(column_index) == type;
+}
+
+dberr_t ColumnScan::AddFilter(uint32_t column_index, CompareOp op, const Field &constant) {
+  if (constant.IsNull() || !IsColumnOf(column_index, constant.GetTypeId()) ||
+      (constant.GetTypeId() != TypeId::kTypeInt && constant.GetTypeId() != TypeId::kTypeFloat)) {
+    return DB_FAILED;
+  }
+  Filter filter{column_index, op, 0, 0};
+  // an int or a float serializes to its 4 bytes as they are
+  char buf[sizeof(int32_t)];
+  constant.SerializeTo(buf);
+  if (constant.GetTypeId() == TypeId::kTypeInt) {
+    memcpy(&filter.int_constant_, buf, sizeof(int32_t));
+  } else {
+    memcpy(&filter.float_constant_, buf, sizeof(float));
+  }
+  filters_.push_back(filter);
+  return DB_SUCCESS;
+}
+
+dberr_t ColumnScan::Count(uint64_t &count) {
+  if (table_heap_->GetStorage() != TableStorage::kColumn) {
+    return DB_FAILED;
+  }
+  count = 0;
+  uint32_t capacity = table_heap_->column_layout_->GetCapacity();
+  ForEachPage(static_cast<uint32_t>(-1), [&](ColumnPage *, const uint64_t *selection) {
+    count += ColumnKernels::Count(selection, capacity);
+  });
+  return DB_SUCCESS;
+}
+
+dberr_t ColumnScan::Sum(uint32_t column_index, double &sum, uint64_t &count) {
+  bool is_int = IsColumnOf(column_index, TypeId::kTypeInt);
+  if (!is_int && !IsColumnOf(column_index, TypeId::kTypeFloat)) {
+    return DB_FAILED;
+  }
+  const ColumnLayout &layout = *table_heap_->column_layout_;
+  uint32_t capacity = layout.GetCapacity();
+  // ints are added up exactly and only converted at the end
+  int64_t int_sum = 0;
+  double float_sum = 0;
+  count = 0;
+  ForEachPage(column_index, [&](ColumnPage *page, const uint64_t *selection) {
+    const char *values = page->GetValues(column_index, layout);
+    if (is_int) {
+      int_sum += ColumnKernels::SumInt(reinterpret_cast<const int32_t *>(values), capacity, selection);
+    } else {
+      float_sum += ColumnKernels::SumFloat(reinterpret_cast<const float *>(values), capacity, selection);
+    }
+    count += ColumnKernels::Count(selection, capacity);
+  });
+  sum = is_int ? static_cast<double>(int_sum) : float_sum;
+  return DB_SUCCESS;
+}
+
+dberr_t ColumnScan::ProjectInt(uint32_t column_index, std::vector<int32_t> &values) {
+  if (!IsColumnOf(column_index, TypeId::kTypeInt)) {
+    return DB_FAILED;
+  }
+  const ColumnLayout &layout = *table_heap_->column_layout_;
+  uint32_t capacity = layout.GetCapacity();
+  values.clear();
+  ForEachPage(column_index, [&](ColumnPage *page, const uint64_t *selection) {
+    size_t size = values.size();
+    values.resize(size + capacity);
+    auto page_values = reinterpret_cast<const int32_t *>(page->GetValues(column_index, layout));
+    values.resize(size + ColumnKernels::ProjectInt(page_values, capacity, selection, values.data() + size));
+  });
+  return DB_SUCCESS;
+}
+
+dberr_t ColumnScan::ProjectFloat(uint32_t column_index, std::vector<float> &values) {
+  if (!IsColumnOf(column_index, TypeId::kTypeFloat)) {
+    return DB_FAILED;
+  }
+  const ColumnLayout &layout = *table_heap_->column_layout_;
+  uint32_t capacity = layout.GetCapacity();
+  values.clear();
+  ForEachPage(column_index, [&](ColumnPage *page, const uint64_t *selection) {
+    size_t size = values.size();
+    values.resize(size + capacity);
+    auto page_values = reinterpret_cast<const float *>(page->GetValues(column_index, layout));
+    values.resize(size + ColumnKernels::ProjectFloat(page_values, capacity, selection, values.data() + size));
+  });
+  return DB_SUCCESS;
+}
+
+uint32_t ColumnScan::SelectPage(page_id_t page_id, std::vector<uint64_t> &selection) {
+  const ColumnLayout &layout = *table_heap_->column_layout_;
+  selection.assign(layout.GetBitmapWords(), 0);
+  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+  auto page = reinterpret_cast<ColumnPage *>(buffer_pool_manager->FetchPage(page_id));
+  ASSERT(page != nullptr, "Can not fetch the column page.");
+  page->RLatch();
+  uint32_t count = Select(page, static_cast<uint32_t>(-1), selection.data())
+                       ? ColumnKernels::Count(selection.data(), layout.GetCapacity())
+                       : 0;
+  page->RUnlatch();
+  buffer_pool_manager->UnpinPage(page_id, false);
+  return count;
+}
+
+bool ColumnScan::Select(ColumnPage *page, uint32_t column_index, uint64_t *selection) {
+  const ColumnLayout &layout = *table_heap_->column_layout_;
+  uint32_t capacity = layout.GetCapacity();
+  if (page->GetVisibleBitmap(selection, layout) == 0) {
+    return false;
+  }
+  if (column_index < layout.GetColumnCount()) {
+    ColumnKernels::Exclude(page->GetNullBitmap(column_index, layout), capacity, selection);
+  }
+  for (auto &filter : filters_) {
+    ColumnKernels::Exclude(page->GetNullBitmap(filter.column_index_, layout), capacity, selection);
+    const char *values = page->GetValues(filter.column_index_, layout);
+    if (layout.GetType(filter.column_index_) == TypeId::kTypeInt) {
+      ColumnKernels::FilterInt(reinterpret_cast<const int32_t *>(values), capacity, filter.op_, filter.int_constant_,
+                               selection);
+    } else {
+      ColumnKernels::FilterFloat(reinterpret_cast<const float *>(values), capacity, filter.op_,
+                                 filter.float_constant_, selection);
+    }
+  }
+  return true;
+}
+
+void ColumnScan::ForEachPage(uint32_t column_index, const std::function<void(ColumnPage *, const uint64_t *)> &func) {
+  const ColumnLayout &layout = *table_heap_->column_layout_;
+  std::vector<uint64_t> selection(layout.GetBitmapWords());
+  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+  for (auto page_id : table_heap_->GetPageIds()) {
+    auto page = reinterpret_cast<ColumnPage *>(buffer_pool_manager->FetchPage(page_id));
+    ASSERT(page != nullptr, "Can not fetch the column page.");
+    page->RLatch();
+    if (Select(page, column_index, selection.data())) {
+      func(page, selection.data());
+    }
+    page->RUnlatch();
+    buffer_pool_manager->UnpinPage(page_id, false);
+  }
+}
@@ -0,0 +1,396 @@
+#include "storage/compressed_block.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+
+void BitWriter::Write(uint64_t value, uint32_t bits) {
+  while (bits > 0) {
+    uint32_t used = bits_ % 8;
+    if (used == 0) {
+      bytes_.push_back(0);
+    }
+    uint32_t take = std::min(8 - used, bits);
+    auto chunk = static_cast<uint8_t>((value >> (bits - take)) & ((1u << take) - 1));
+    bytes_.back() |= static_cast<uint8_t>(chunk << (8 - used - take));
+    bits_ += take;
+    bits -= take;
+  }
+}
+
+void BitWriter::Truncate(size_t bits) {
+  bytes_.resize((bits + 7) / 8);
+  if (bits % 8 != 0) {
+    bytes_.back() &= static_cast<uint8_t>(0xff << (8 - bits % 8));
+  }
+  bits_ = bits;
+}
+
+uint64_t BitReader::Read(uint32_t bits) {
+  uint64_t value = 0;
+  while (bits > 0) {
+    uint32_t used = offset_ % 8;
+    uint32_t take = std::min(8 - used, bits);
+    uint8_t byte = data_[offset_ / 8];
+    value = value << take | ((byte >> (8 - used - take)) & ((1u << take) - 1));
+    offset_ += take;
+    bits -= take;
+  }
+  return value;
+}
+
+int64_t BitReader::ReadSigned(uint32_t bits) {
+  uint64_t value = Read(bits);
+  if (bits < 64 && (value >> (bits - 1) & 1) != 0) {
+    value |= ~uint64_t{0} << bits;
+  }
+  return static_cast<int64_t>(value);
+}
+
+CompressedBlock::CompressedBlock(Schema *schema)
+    : schema_(schema), states_(schema->GetColumnCount()), streams_(schema->GetColumnCount()) {}
+
+bool CompressedBlock::Append(const Row &row, uint32_t capacity) {
+  ASSERT(row.GetFieldCount() == schema_->GetColumnCount(), "The row does not match the schema of the block.");
+  std::vector<ColumnState> saved_states = states_;
+  std::vector<size_t> saved_bits(streams_.size());
+  for (size_t i = 0; i < streams_.size(); i++) {
+    saved_bits[i] = streams_[i].GetBitCount();
+  }
+  for (uint32_t i = 0; i < streams_.size(); i++) {
+    AppendValue(i, *row.GetField(i));
+  }
+  if (row_count_++ % 8 == 0) {
+    deleted_.push_back(0);
+  }
+  if (GetSerializedSize() <= capacity) {
+    return true;
+  }
+  states_ = std::move(saved_states);
+  for (size_t i = 0; i < streams_.size(); i++) {
+    streams_[i].Truncate(saved_bits[i]);
+  }
+  row_count_--;
+  deleted_.resize((row_count_ + 7) / 8);
+  return false;
+}
+
+void CompressedBlock::Load(const char *buf, uint32_t size) {
+  ASSERT(row_count_ == 0, "Only an empty block can be loaded.");
+  std::vector<Row> rows;
+  size_t row_count = Decode(buf, schema_, INVALID_PAGE_ID, rows, true);
+  for (size_t i = 0; i < row_count; i++) {
+    Append(rows[i], UINT32_MAX);
+  }
+  // the encoding only depends on the rows, so the image comes out the same
+  ASSERT(GetSerializedSize() == size, "The block image does not match its rows.");
+  memcpy(deleted_.data(), buf + GetDeletedOffset(buf, schema_->GetColumnCount()), deleted_.size());
+}
+
+void CompressedBlock::SetDeleted(uint32_t slot) {
+  ASSERT(slot < row_count_, "Invalid slot of a compressed block.");
+  deleted_[slot / 8] |= static_cast<uint8_t>(1 << (slot % 8));
+}
+
+uint32_t CompressedBlock::GetSerializedSize() const {
+  uint32_t size = sizeof(uint32_t) + SIZE_COLUMN_HEADER * streams_.size() + deleted_.size();
+  for (auto &stream : streams_) {
+    size += stream.GetBytes().size();
+  }
+  return size;
+}
+
+void CompressedBlock::SerializeTo(char *buf) const {
+  MACH_WRITE_UINT32(buf, row_count_);
+  char *header = buf + sizeof(uint32_t);
+  for (uint32_t i = 0; i < streams_.size(); i++) {
+    const ColumnState &state = states_[i];
+    MACH_WRITE_UINT32(header, state.count_);
+    if (schema_->GetColumn(i)->GetType() == TypeId::kTypeFloat) {
+      MACH_WRITE_TO(float, header + 4, state.float_min_);
+      MACH_WRITE_TO(float, header + 8, state.float_max_);
+    } else {
+      MACH_WRITE_INT32(header + 4, state.int_min_);
+      MACH_WRITE_INT32(header + 8, state.int_max_);
+    }
+    MACH_WRITE_UINT32(header + 12, static_cast<uint32_t>(streams_[i].GetBitCount()));
+    header += SIZE_COLUMN_HEADER;
+  }
+  char *data = header;
+  for (auto &stream : streams_) {
+    memcpy(data, stream.GetBytes().data(), stream.GetBytes().size());
+    data += stream.GetBytes().size();
+  }
+  memcpy(data, deleted_.data(), deleted_.size());
+}
+
+size_t CompressedBlock::Decode(const char *buf, Schema *schema, page_id_t page_id, std::vector<Row> &rows,
+                               bool with_deleted) {
+  uint32_t column_count = schema->GetColumnCount();
+  uint32_t row_count = MACH_READ_UINT32(buf);
+  std::vector<BitReader> readers;
+  readers.reserve(column_count);
+  std::vector<ColumnState> states(column_count);
+  const char *stream = buf + sizeof(uint32_t) + SIZE_COLUMN_HEADER * column_count;
+  for (uint32_t i = 0; i < column_count; i++) {
+    readers.emplace_back(stream);
+    stream += (MACH_READ_UINT32(buf + sizeof(uint32_t) + SIZE_COLUMN_HEADER * i + 12) + 7) / 8;
+  }
+  // the deleted bitmap follows the last stream
+  auto deleted = reinterpret_cast<const uint8_t *>(stream);
+  size_t count = 0;
+  for (uint32_t slot = 0; slot < row_count; slot++) {
+    if (count == rows.size()) {
+      rows.emplace_back();
+    }
+    // every row is decoded to get on to the next one, a deleted row is overwritten by it
+    Row &row = rows[count];
+    row.destroy();
+    for (uint32_t i = 0; i < column_count; i++) {
+      row.GetFields().push_back(ReadValue(readers[i], schema->GetColumn(i), states[i]));
+    }
+    row.SetRowId(RowId(page_id, slot));
+    if (with_deleted || (deleted[slot / 8] >> (slot % 8) & 1) == 0) {
+      count++;
+    }
+  }
+  return count;
+}
+
+void CompressedBlock::ReadBounds(const char *buf, Schema *schema, Row &min_row, Row &max_row) {
+  uint32_t column_count = schema->GetColumnCount();
+  uint32_t row_count = MACH_READ_UINT32(buf);
+  min_row.destroy();
+  max_row.destroy();
+  const char *stream = buf + sizeof(uint32_t) + SIZE_COLUMN_HEADER * column_count;
+  for (uint32_t i = 0; i < column_count; i++) {
+    const Column *column = schema->GetColumn(i);
+    const char *header = buf + sizeof(uint32_t) + SIZE_COLUMN_HEADER * i;
+    uint32_t count = MACH_READ_UINT32(header);
+    const char *column_stream = stream;
+    stream += (MACH_READ_UINT32(header + 12) + 7) / 8;
+    if (count == 0) {
+      min_row.GetFields().push_back(new Field(column->GetType()));
+      max_row.GetFields().push_back(new Field(column->GetType()));
+      continue;
+    }
+    switch (column->GetType()) {
+      case TypeId::kTypeInt:
+        min_row.GetFields().push_back(new Field(TypeId::kTypeInt, MACH_READ_INT32(header + 4)));
+        max_row.GetFields().push_back(new Field(TypeId::kTypeInt, MACH_READ_INT32(header + 8)));
+        break;
+      case TypeId::kTypeFloat:
+        min_row.GetFields().push_back(new Field(TypeId::kTypeFloat, MACH_READ_FROM(float, header + 4)));
+        max_row.GetFields().push_back(new Field(TypeId::kTypeFloat, MACH_READ_FROM(float, header + 8)));
+        break;
+      default: {
+        // char values have no room in the header, their stream is read through
+        BitReader reader(column_stream);
+        ColumnState state;
+        std::unique_ptr<Field> min_value;
+        std::unique_ptr<Field> max_value;
+        for (uint32_t slot = 0; slot < row_count; slot++) {
+          std::unique_ptr<Field> value(ReadValue(reader, column, state));
+          if (value->IsNull()) {
+            continue;
+          }
+          if (min_value == nullptr || value->CompareLessThan(*min_value) == CmpBool::kTrue) {
+            min_value = std::make_unique<Field>(*value);
+          }
+          if (max_value == nullptr || value->CompareGreaterThan(*max_value) == CmpBool::kTrue) {
+            max_value = std::make_unique<Field>(*value);
+          }
+        }
+        min_row.GetFields().push_back(min_value.release());
+        max_row.GetFields().push_back(max_value.release());
+        break;
+      }
+    }
+  }
+}
+
+bool CompressedBlock::IsDeleted(const char *buf, Schema *schema, uint32_t slot) {
+  auto deleted = reinterpret_cast<const uint8_t *>(buf + GetDeletedOffset(buf, schema->GetColumnCount()));
+  return (deleted[slot / 8] >> (slot % 8) & 1) != 0;
+}
+
+void CompressedBlock::SetDeleted(char *buf, Schema *schema, uint32_t slot) {
+  ASSERT(slot < MACH_READ_UINT32(buf), "Invalid slot of a compressed block.");
+  auto deleted = reinterpret_cast<uint8_t *>(buf + GetDeletedOffset(buf, schema->GetColumnCount()));
+  deleted[slot / 8] |= static_cast<uint8_t>(1 << (slot % 8));
+}
+
+void CompressedBlock::AppendValue(uint32_t column_index, const Field &field) {
+  const Column *column = schema_->GetColumn(column_index);
+  BitWriter &stream = streams_[column_index];
+  ColumnState &state = states_[column_index];
+  if (column->IsNullable()) {
+    stream.Write(field.IsNull() ? 1 : 0, 1);
+  }
+  if (field.IsNull()) {
+    ASSERT(column->IsNullable(), "A null value in a column that is not nullable.");
+    return;
+  }
+  char buf[sizeof(int32_t)];
+  switch (column->GetType()) {
+    case TypeId::kTypeInt: {
+      field.SerializeTo(buf);
+      int32_t value = MACH_READ_INT32(buf);
+      state.int_min_ = state.count_ == 0 ? value : std::min(state.int_min_, value);
+      state.int_max_ = state.count_ == 0 ? value : std::max(state.int_max_, value);
+      if (state.count_ == 0) {
+        stream.Write(static_cast<uint32_t>(value), 32);
+      } else {
+        int64_t delta = value - state.prev_;
+        WriteDeltaOfDelta(stream, delta - state.prev_delta_);
+        state.prev_delta_ = delta;
+      }
+      state.prev_ = value;
+      break;
+    }
+    case TypeId::kTypeFloat: {
+      field.SerializeTo(buf);
+      float value = MACH_READ_FROM(float, buf);
+      uint32_t bits = MACH_READ_UINT32(buf);
+      state.float_min_ = state.count_ == 0 ? value : std::min(state.float_min_, value);
+      state.float_max_ = state.count_ == 0 ? value : std::max(state.float_max_, value);
+      if (state.count_ == 0) {
+        stream.Write(bits, 32);
+      } else {
+        WriteXor(stream, bits, state);
+      }
+      state.prev_ = bits;
+      break;
+    }
+    default: {
+      ASSERT(field.GetLength() <= UINT16_MAX, "A char value too long for a compressed block.");
+      stream.Write(field.GetLength(), 16);
+      for (uint32_t i = 0; i < field.GetLength(); i++) {
+        stream.Write(static_cast<uint8_t>(field.GetData()[i]), 8);
+      }
+      break;
+    }
+  }
+  state.count_++;
+}
+
+Field *CompressedBlock::ReadValue(BitReader &reader, const Column *column, ColumnState &state) {
+  if (column->IsNullable() && reader.Read(1) != 0) {
+    return new Field(column->GetType());
+  }
+  Field *field;
+  switch (column->GetType()) {
+    case TypeId::kTypeInt: {
+      int64_t value;
+      if (state.count_ == 0) {
+        value = static_cast<int32_t>(reader.Read(32));
+      } else {
+        state.prev_delta_ += ReadDeltaOfDelta(reader);
+        value = state.prev_ + state.prev_delta_;
+      }
+      state.prev_ = value;
+      field = new Field(TypeId::kTypeInt, static_cast<int32_t>(value));
+      break;
+    }
+    case TypeId::kTypeFloat: {
+      auto bits = static_cast<uint32_t>(state.count_ == 0 ? reader.Read(32)
+                                                          : ReadXor(reader, static_cast<uint32_t>(state.prev_), state.leading_,
+                                                                    state.trailing_));
+      state.prev_ = bits;
+      float value;
+      memcpy(&value, &bits, sizeof(float));
+      field = new Field(TypeId::kTypeFloat, value);
+      break;
+    }
+    default: {
+      auto length = static_cast<uint32_t>(reader.Read(16));
+      std::string value(length, '\0');
+      for (uint32_t i = 0; i < length; i++) {
+        value[i] = static_cast<char>(reader.Read(8));
+      }
+      field = new Field(TypeId::kTypeChar, value.data(), length, true);
+      break;
+    }
+  }
+  state.count_++;
+  return field;
+}
+
+void CompressedBlock::WriteDeltaOfDelta(BitWriter &stream, int64_t delta_of_delta) {
+  if (delta_of_delta == 0) {
+    stream.Write(0b0, 1);
+  } else if (delta_of_delta >= -64 && delta_of_delta < 64) {
+    stream.Write(0b10, 2);
+    stream.Write(static_cast<uint64_t>(delta_of_delta), 7);
+  } else if (delta_of_delta >= -256 && delta_of_delta < 256) {
+    stream.Write(0b110, 3);
+    stream.Write(static_cast<uint64_t>(delta_of_delta), 9);
+  } else if (delta_of_delta >= -2048 && delta_of_delta < 2048) {
+    stream.Write(0b1110, 4);
+    stream.Write(static_cast<uint64_t>(delta_of_delta), 12);
+  } else {
+    stream.Write(0b1111, 4);
+    stream.Write(static_cast<uint64_t>(delta_of_delta), 64);
+  }
+}
+
+int64_t CompressedBlock::ReadDeltaOfDelta(BitReader &reader) {
+  if (reader.Read(1) == 0) {
+    return 0;
+  }
+  if (reader.Read(1) == 0) {
+    return reader.ReadSigned(7);
+  }
+  if (reader.Read(1) == 0) {
+    return reader.ReadSigned(9);
+  }
+  if (reader.Read(1) == 0) {
+    return reader.ReadSigned(12);
+  }
+  return reader.ReadSigned(64);
+}
+
+void CompressedBlock::WriteXor(BitWriter &stream, uint32_t value, ColumnState &state) {
+  uint32_t xor_value = value ^ static_cast<uint32_t>(state.prev_);
+  if (xor_value == 0) {
+    stream.Write(0b0, 1);
+    return;
+  }
+  auto leading = static_cast<uint32_t>(__builtin_clz(xor_value));
+  auto trailing = static_cast<uint32_t>(__builtin_ctz(xor_value));
+  if (state.window_ && leading >= state.leading_ && trailing >= state.trailing_) {
+    stream.Write(0b10, 2);
+    stream.Write(xor_value >> state.trailing_, 32 - state.leading_ - state.trailing_);
+    return;
+  }
+  uint32_t length = 32 - leading - trailing;
+  stream.Write(0b11, 2);
+  stream.Write(leading, 5);
+  stream.Write(length - 1, 5);
+  stream.Write(xor_value >> trailing, length);
+  state.leading_ = leading;
+  state.trailing_ = trailing;
+  state.window_ = true;
+}
+
+uint32_t CompressedBlock::ReadXor(BitReader &reader, uint32_t prev, uint32_t &leading, uint32_t &trailing) {
+  if (reader.Read(1) == 0) {
+    return prev;
+  }
+  if (reader.Read(1) != 0) {
+    leading = static_cast<uint32_t>(reader.Read(5));
+    uint32_t length = static_cast<uint32_t>(reader.Read(5)) + 1;
+    trailing = 32 - leading - length;
+  }
+  auto xor_value = static_cast<uint32_t>(reader.Read(32 - leading - trailing) << trailing);
+  return prev ^ xor_value;
+}
+
+uint32_t CompressedBlock::GetDeletedOffset(const char *buf, uint32_t column_count) {
+  uint32_t offset = sizeof(uint32_t) + SIZE_COLUMN_HEADER * column_count;
+  for (uint32_t i = 0; i < column_count; i++) {
+    offset += (MACH_READ_UINT32(buf + sizeof(uint32_t) + SIZE_COLUMN_HEADER * i + 12) + 7) / 8;
+  }
+  return offset;
+}
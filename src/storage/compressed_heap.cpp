@@ -0,0 +1,227 @@
+#include "storage/compressed_heap.h"
+
+#include <utility>
+
+#include "storage/disk_manager.h"
+
+CompressedHeap::CompressedHeap(BufferPoolManager *buffer_pool_manager, Schema *schema)
+    : buffer_pool_manager_(buffer_pool_manager),
+      schema_(schema),
+      capacity_(CompressedBlockPage::GetCapacity(buffer_pool_manager->GetPageSize())),
+      open_block_(std::make_unique<CompressedBlock>(schema)) {}
+
+CompressedHeap *CompressedHeap::Create(BufferPoolManager *buffer_pool_manager, Schema *schema, uint32_t space_id) {
+  page_id_t page_id;
+  auto page = reinterpret_cast<CompressedBlockPage *>(buffer_pool_manager->NewPage(page_id, space_id));
+  if (page == nullptr) {
+    return nullptr;
+  }
+  page->Init(page_id);
+  buffer_pool_manager->UnpinPage(page_id, true);
+  auto *heap = new CompressedHeap(buffer_pool_manager, schema);
+  heap->first_page_id_ = page_id;
+  heap->page_ids_.push_back(page_id);
+  return heap;
+}
+
+CompressedHeap *CompressedHeap::Open(BufferPoolManager *buffer_pool_manager, Schema *schema,
+                                     page_id_t first_page_id) {
+  auto *heap = new CompressedHeap(buffer_pool_manager, schema);
+  heap->first_page_id_ = first_page_id;
+  for (page_id_t page_id = first_page_id; page_id != INVALID_PAGE_ID;) {
+    auto page = reinterpret_cast<CompressedBlockPage *>(buffer_pool_manager->FetchPage(page_id));
+    ASSERT(page != nullptr, "Can not fetch the compressed block page.");
+    heap->page_ids_.push_back(page_id);
+    page_id_t next_page_id = page->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID && page->GetBlockSize() != 0) {
+      heap->open_block_->Load(page->GetBlock(), page->GetBlockSize());
+    }
+    buffer_pool_manager->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  return heap;
+}
+
+bool CompressedHeap::InsertTuple(Row &row) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  bool inserted = AppendRow(row);
+  WriteOpenBlock();
+  return inserted;
+}
+
+bool CompressedHeap::InsertTuples(std::vector<Row> &rows) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  bool inserted = true;
+  for (size_t i = 0; i < rows.size() && inserted; i++) {
+    inserted = AppendRow(rows[i]);
+  }
+  WriteOpenBlock();
+  return inserted;
+}
+
+bool CompressedHeap::MarkDelete(const RowId &rid) {
+  Row row(rid);
+  if (!GetTuple(&row)) {
+    return false;
+  }
+  std::scoped_lock<std::mutex> lock(marked_latch_);
+  return marked_.insert(rid.Get()).second;
+}
+
+void CompressedHeap::ApplyDelete(const RowId &rid) {
+  {
+    std::scoped_lock<std::mutex> lock(marked_latch_);
+    marked_.erase(rid.Get());
+  }
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (rid.GetPageId() == page_ids_.back()) {
+    open_block_->SetDeleted(rid.GetSlotNum());
+    WriteOpenBlock();
+    return;
+  }
+  // a sealed block only has the bit of the row set, in place
+  auto page = reinterpret_cast<CompressedBlockPage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  ASSERT(page != nullptr, "Can not fetch the compressed block page.");
+  page->WLatch();
+  CompressedBlock::SetDeleted(page->GetBlock(), schema_, rid.GetSlotNum());
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
+}
+
+void CompressedHeap::RollbackDelete(const RowId &rid) {
+  std::scoped_lock<std::mutex> lock(marked_latch_);
+  marked_.erase(rid.Get());
+}
+
+bool CompressedHeap::GetTuple(Row *row) {
+  RowId rid = row->GetRowId();
+  if (IsMarked(rid)) {
+    return false;
+  }
+  auto page = reinterpret_cast<CompressedBlockPage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  if (page == nullptr) {
+    return false;
+  }
+  std::vector<Row> rows;
+  page->RLatch();
+  bool found = page->GetBlockSize() != 0 && rid.GetSlotNum() < MACH_READ_UINT32(page->GetBlock()) &&
+               !CompressedBlock::IsDeleted(page->GetBlock(), schema_, rid.GetSlotNum());
+  if (found) {
+    // the values of a row depend on those before it, the block is decoded up to it
+    CompressedBlock::Decode(page->GetBlock(), schema_, rid.GetPageId(), rows, true);
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
+  if (found) {
+    *row = rows[rid.GetSlotNum()];
+  }
+  return found;
+}
+
+page_id_t CompressedHeap::ReadPage(page_id_t page_id, std::vector<Row> &rows, size_t &row_count) {
+  auto page = reinterpret_cast<CompressedBlockPage *>(buffer_pool_manager_->FetchPage(page_id));
+  ASSERT(page != nullptr, "Can not fetch the compressed block page.");
+  page->RLatch();
+  row_count = page->GetBlockSize() == 0 ? 0 : CompressedBlock::Decode(page->GetBlock(), schema_, page_id, rows);
+  page_id_t next_page_id = page->GetNextPageId();
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  std::scoped_lock<std::mutex> lock(marked_latch_);
+  if (!marked_.empty()) {
+    size_t visible = 0;
+    for (size_t i = 0; i < row_count; i++) {
+      if (marked_.count(rows[i].GetRowId().Get()) == 0) {
+        if (visible != i) {
+          std::swap(rows[visible], rows[i]);
+        }
+        visible++;
+      }
+    }
+    row_count = visible;
+  }
+  return next_page_id;
+}
+
+bool CompressedHeap::ReadBounds(page_id_t page_id, Row &min_row, Row &max_row) {
+  auto page = reinterpret_cast<CompressedBlockPage *>(buffer_pool_manager_->FetchPage(page_id));
+  ASSERT(page != nullptr, "Can not fetch the compressed block page.");
+  page->RLatch();
+  bool has_rows = page->GetBlockSize() != 0 && MACH_READ_UINT32(page->GetBlock()) != 0;
+  if (has_rows) {
+    CompressedBlock::ReadBounds(page->GetBlock(), schema_, min_row, max_row);
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return has_rows;
+}
+
+std::vector<page_id_t> CompressedHeap::GetPageIds() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return page_ids_;
+}
+
+uint32_t CompressedHeap::GetBlockCount() const {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return page_ids_.size();
+}
+
+void CompressedHeap::Destroy() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  for (auto page_id : page_ids_) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+  page_ids_.clear();
+  first_page_id_ = INVALID_PAGE_ID;
+  open_block_ = std::make_unique<CompressedBlock>(schema_);
+}
+
+bool CompressedHeap::AppendRow(Row &row) {
+  if (open_block_->Append(row, capacity_)) {
+    row.SetRowId(RowId(page_ids_.back(), open_block_->GetRowCount() - 1));
+    return true;
+  }
+  // a row that does not even fit into an empty block leaves the open one as it is
+  if (open_block_->GetRowCount() == 0 || !CompressedBlock(schema_).Append(row, capacity_)) {
+    return false;
+  }
+  // seal the full block and link a page for the next one behind it
+  WriteOpenBlock();
+  page_id_t last_page_id = page_ids_.back();
+  page_id_t page_id;
+  auto page = reinterpret_cast<CompressedBlockPage *>(
+      buffer_pool_manager_->NewPage(page_id, DiskManager::GetTablespaceId(last_page_id)));
+  if (page == nullptr) {
+    return false;
+  }
+  page->Init(page_id);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  auto last_page = reinterpret_cast<CompressedBlockPage *>(buffer_pool_manager_->FetchPage(last_page_id));
+  ASSERT(last_page != nullptr, "Can not fetch the compressed block page.");
+  last_page->WLatch();
+  last_page->SetNextPageId(page_id);
+  last_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(last_page_id, true);
+  page_ids_.push_back(page_id);
+  open_block_ = std::make_unique<CompressedBlock>(schema_);
+  open_block_->Append(row, capacity_);
+  row.SetRowId(RowId(page_id, 0));
+  return true;
+}
+
+void CompressedHeap::WriteOpenBlock() {
+  if (page_ids_.empty()) {
+    return;
+  }
+  auto page = reinterpret_cast<CompressedBlockPage *>(buffer_pool_manager_->FetchPage(page_ids_.back()));
+  ASSERT(page != nullptr, "Can not fetch the compressed block page.");
+  page->WLatch();
+  open_block_->SerializeTo(page->GetBlock());
+  page->SetBlockSize(open_block_->GetSerializedSize());
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_ids_.back(), true);
+}
+
+bool CompressedHeap::IsMarked(const RowId &rid) {
+  std::scoped_lock<std::mutex> lock(marked_latch_);
+  return !marked_.empty() && marked_.count(rid.Get()) != 0;
+}
@@ -0,0 +1,221 @@
+#include "storage/disk_file.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+
+#include "glog/logging.h"
+
+DiskFile::DiskFile(const std::string &file_name, uint32_t page_size) : file_name_(file_name), page_size_(page_size) {
+  std::filesystem::path p = file_name;
+  if (p.has_parent_path()) std::filesystem::create_directories(p.parent_path());
+  fd_ = open(file_name.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd_ < 0) {
+    throw std::exception();
+  }
+  // an existing file keeps the page size it was created with
+  uint32_t stored_page_size = 0;
+  if (pread(fd_, &stored_page_size, sizeof(uint32_t), 0) == sizeof(uint32_t) && IsValidPageSize(stored_page_size)) {
+    page_size_ = stored_page_size;
+  }
+  ASSERT(IsValidPageSize(page_size_), "Unsupported page size.");
+  bitmap_size_ = 8 * (page_size_ - 2 * sizeof(uint32_t));
+  meta_data_ = new char[page_size_];
+  ReadPhysicalPage(META_PAGE_ID, meta_data_);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  meta_page->page_size_ = page_size_;
+  reserved_size_ = GetFileSize();
+}
+
+DiskFile::~DiskFile() {
+  if (!closed_) {
+    Close();
+  }
+  delete[] meta_data_;
+}
+
+void DiskFile::Close() {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  if (!closed_) {
+    WritePhysicalPage(META_PAGE_ID, meta_data_);
+    close(fd_);
+    closed_ = true;
+  }
+}
+
+void DiskFile::ReadPage(page_id_t logical_page_id, char *page_data) {
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  ReadPhysicalPage(MapPageId(logical_page_id), page_data);
+}
+
+void DiskFile::WritePage(page_id_t logical_page_id, const char *page_data) {
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  WritePhysicalPage(MapPageId(logical_page_id), page_data);
+}
+
+template <typename Func>
+bool DiskFile::VisitBitmap(char *buffer, Func &&func) {
+  switch (page_size_) {
+    case 8192:
+      return func(reinterpret_cast<BitmapPage<8192> *>(buffer));
+    case 16384:
+      return func(reinterpret_cast<BitmapPage<16384> *>(buffer));
+    case 32768:
+      return func(reinterpret_cast<BitmapPage<32768> *>(buffer));
+    default:
+      return func(reinterpret_cast<BitmapPage<PAGE_SIZE> *>(buffer));
+  }
+}
+
+page_id_t DiskFile::AllocatePage() {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  DiskFileMetaPage *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  uint32_t i;
+  for(i = 0; i < meta_page->GetExtentNums(); i++){
+    if(meta_page->extent_used_page_[i] < bitmap_size_){
+      //找到空间
+      break;
+    }
+  }
+  if(i == meta_page->GetExtentNums()){
+    if(i == DiskFileMetaPage::GetMaxExtentNums(page_size_)){
+      //full
+      return INVALID_PAGE_ID;
+    }
+    meta_page->num_extents_++;
+    meta_page->extent_used_page_[meta_page->num_extents_ - 1] = 0;
+  }
+  char buffer[MAX_PAGE_SIZE];
+  ReadPhysicalPage(1 + i * (bitmap_size_ + 1), buffer);
+  uint32_t page_offset = 0;
+  bool allocated = VisitBitmap(buffer, [&page_offset](auto *bitmap) {
+    // an out of range hint makes the bitmap pick its first free page
+    page_offset = bitmap->GetMaxSupportedSize();
+    return bitmap->AllocatePage(page_offset);
+  });
+  if (!allocated) {
+    return INVALID_PAGE_ID;
+  }
+  meta_page->num_allocated_pages_++;
+  meta_page->extent_used_page_[i]++;
+  WritePhysicalPage(1 + i * (bitmap_size_ + 1), buffer);
+  page_id_t page_id = i * bitmap_size_ + page_offset;
+  Reserve(MapPageId(page_id));
+  return page_id;
+}
+
+void DiskFile::DeAllocatePage(page_id_t logical_page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  uint32_t extent_num = logical_page_id / bitmap_size_;
+  uint32_t page_num = logical_page_id % bitmap_size_;
+  DiskFileMetaPage *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  if (extent_num >= meta_page->GetExtentNums()) {
+    return;
+  }
+  char buffer[MAX_PAGE_SIZE]; //bitmap
+  ReadPhysicalPage(1 + extent_num * (bitmap_size_ + 1), buffer);
+  if (VisitBitmap(buffer, [page_num](auto *bitmap) { return bitmap->DeAllocatePage(page_num); })) {
+    meta_page->num_allocated_pages_--;
+    meta_page->extent_used_page_[extent_num]--;
+    WritePhysicalPage(1 + extent_num * (bitmap_size_ + 1), buffer);
+  }
+}
+
+bool DiskFile::IsPageFree(page_id_t logical_page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  uint32_t extent_num = logical_page_id / bitmap_size_;
+  uint32_t page_num = logical_page_id % bitmap_size_;
+  char buffer[MAX_PAGE_SIZE];
+  ReadPhysicalPage(1 + extent_num * (bitmap_size_ + 1), buffer);
+  return VisitBitmap(buffer, [page_num](auto *bitmap) { return bitmap->IsPageFree(page_num); });
+}
+
+uint64_t DiskFile::Shrink(uint32_t page_count) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  uint64_t old_size = GetFileSize();
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  uint32_t extent_nums = (page_count + bitmap_size_ - 1) / bitmap_size_;
+  char buffer[MAX_PAGE_SIZE];
+  for (uint32_t i = 0; i < std::max(extent_nums, meta_page->GetExtentNums()); i++) {
+    uint32_t used = i < extent_nums ? std::min<uint32_t>(page_count - i * bitmap_size_, bitmap_size_) : 0;
+    meta_page->extent_used_page_[i] = used;
+    if (i >= extent_nums) {
+      continue;
+    }
+    memset(buffer, 0, page_size_);
+    VisitBitmap(buffer, [used](auto *bitmap) {
+      for (uint32_t offset = 0; offset < used; offset++) {
+        uint32_t page_offset = offset;
+        bitmap->AllocatePage(page_offset);
+      }
+      return true;
+    });
+    WritePhysicalPage(1 + i * (bitmap_size_ + 1), buffer);
+  }
+  meta_page->num_extents_ = extent_nums;
+  meta_page->num_allocated_pages_ = page_count;
+  WritePhysicalPage(META_PAGE_ID, meta_data_);
+  // a file without pages keeps only its meta page
+  uint64_t new_size = static_cast<uint64_t>(page_count == 0 ? 1 : MapPageId(page_count - 1) + 1) * page_size_;
+  if (new_size < old_size && ftruncate(fd_, static_cast<off_t>(new_size)) != 0) {
+    LOG(ERROR) << "Failed to truncate " << file_name_;
+    return 0;
+  }
+  reserved_size_ = GetFileSize();
+  return old_size > new_size ? old_size - new_size : 0;
+}
+
+void DiskFile::SetGrowthSize(uint64_t growth_size) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  growth_size_ = growth_size;
+}
+
+void DiskFile::Reserve(page_id_t physical_page_id) {
+  uint64_t end = static_cast<uint64_t>(physical_page_id + 1) * page_size_;
+  if (growth_size_ == 0 || end <= reserved_size_) {
+    return;
+  }
+  // round up to a whole number of chunks, so the file size stays a multiple of the growth size
+  uint64_t new_size = (end + growth_size_ - 1) / growth_size_ * growth_size_;
+  if (fallocate(fd_, 0, static_cast<off_t>(reserved_size_), static_cast<off_t>(new_size - reserved_size_)) != 0) {
+    LOG(WARNING) << "fallocate is not available for " << file_name_ << ", the file grows page by page";
+    growth_size_ = 0;
+    return;
+  }
+  reserved_size_ = new_size;
+}
+
+uint64_t DiskFile::GetFileSize() {
+  struct stat stat_buf;
+  return fstat(fd_, &stat_buf) == 0 ? static_cast<uint64_t>(stat_buf.st_size) : 0;
+}
+
+page_id_t DiskFile::MapPageId(page_id_t logical_page_id) const {
+  return logical_page_id + logical_page_id / bitmap_size_ + 2;
+}
+
+void DiskFile::ReadPhysicalPage(page_id_t physical_page_id, char *page_data) {
+  off_t offset = static_cast<off_t>(physical_page_id) * page_size_;
+  ssize_t read_count = pread(fd_, page_data, page_size_, offset);
+  if (read_count < 0) {
+    LOG(ERROR) << "I/O error while reading " << file_name_;
+    read_count = 0;
+  }
+  // reading beyond the end of file yields zeros
+  if (read_count < static_cast<ssize_t>(page_size_)) {
+#ifdef ENABLE_BPM_DEBUG
+    LOG(INFO) << "Read less than a page" << std::endl;
+#endif
+    memset(page_data + read_count, 0, page_size_ - read_count);
+  }
+}
+
+void DiskFile::WritePhysicalPage(page_id_t physical_page_id, const char *page_data) {
+  off_t offset = static_cast<off_t>(physical_page_id) * page_size_;
+  if (pwrite(fd_, page_data, page_size_, offset) != static_cast<ssize_t>(page_size_)) {
+    LOG(ERROR) << "I/O error while writing " << file_name_;
+  }
+}
@@ -1,158 +1,190 @@
 #include "storage/disk_manager.h"
 
-#include <sys/stat.h>
 #include <filesystem>
-#include <stdexcept>
+#include <fstream>
+#include <sstream>
 
 #include "glog/logging.h"
-#include "page/bitmap_page.h"
-
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
-  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    std::filesystem::path p = db_file;
-    if(p.has_parent_path()) std::filesystem::create_directories(p.parent_path());
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
-    db_io_.close();
-    // reopen with original mode
-    db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-    if (!db_io_.is_open()) {
-      throw std::exception();
-    }
+
+DiskManager::DiskManager(const std::string &db_file, uint32_t page_size) : file_name_(db_file) {
+  files_[DEFAULT_TABLESPACE_ID] = std::make_unique<DiskFile>(db_file, page_size);
+  space_names_["default"] = DEFAULT_TABLESPACE_ID;
+  LoadTablespaces();
+}
+
+void DiskManager::RemoveDatabaseFiles(const std::string &db_file) {
+  std::ifstream in(GetTablespaceFileName(db_file));
+  uint32_t space_id;
+  std::string name, path;
+  while (ReadTablespaceEntry(in, space_id, name, path)) {
+    remove(path.c_str());
   }
-  ReadPhysicalPage(META_PAGE_ID, meta_data_);
+  in.close();
+  remove(GetTablespaceFileName(db_file).c_str());
+  remove(db_file.c_str());
 }
 
 void DiskManager::Close() {
-  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-  WritePhysicalPage(META_PAGE_ID, meta_data_);
+  std::scoped_lock<std::mutex> lock(space_latch_);
   if (!closed) {
-    db_io_.close();
+    for (auto &file : files_) {
+      if (file != nullptr) {
+        file->Close();
+      }
+    }
     closed = true;
   }
 }
 
-void DiskManager::ReadPage(page_id_t logical_page_id, char *page_data) {
+DiskFile *DiskManager::GetFile(page_id_t logical_page_id, page_id_t &local_page_id) {
   ASSERT(logical_page_id >= 0, "Invalid page id.");
-  ReadPhysicalPage(MapPageId(logical_page_id), page_data);
+  uint32_t space_id = GetTablespaceId(logical_page_id);
+  ASSERT(files_[space_id] != nullptr, "Page id refers to an unknown tablespace.");
+  local_page_id = logical_page_id & ((1 << TABLESPACE_PAGE_BITS) - 1);
+  return files_[space_id].get();
+}
+
+void DiskManager::ReadPage(page_id_t logical_page_id, char *page_data) {
+  page_id_t local_page_id;
+  GetFile(logical_page_id, local_page_id)->ReadPage(local_page_id, page_data);
 }
 
 void DiskManager::WritePage(page_id_t logical_page_id, const char *page_data) {
-  ASSERT(logical_page_id >= 0, "Invalid page id.");
-  WritePhysicalPage(MapPageId(logical_page_id), page_data);
+  page_id_t local_page_id;
+  GetFile(logical_page_id, local_page_id)->WritePage(local_page_id, page_data);
+}
+
+page_id_t DiskManager::AllocatePage(uint32_t space_id) {
+  ASSERT(space_id < MAX_TABLESPACES && files_[space_id] != nullptr, "Unknown tablespace.");
+  DiskFile *file = files_[space_id].get();
+  page_id_t local_page_id = file->AllocatePage();
+  if (local_page_id == INVALID_PAGE_ID) {
+    return INVALID_PAGE_ID;
+  }
+  // the page id has no room left to address this page
+  if (local_page_id >= (1 << TABLESPACE_PAGE_BITS)) {
+    file->DeAllocatePage(local_page_id);
+    return INVALID_PAGE_ID;
+  }
+  return static_cast<page_id_t>(space_id << TABLESPACE_PAGE_BITS) | local_page_id;
+}
+
+void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
+  page_id_t local_page_id;
+  GetFile(logical_page_id, local_page_id)->DeAllocatePage(local_page_id);
 }
 
-page_id_t DiskManager::AllocatePage() {
-  DiskFileMetaPage *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
-  uint32_t i;
-  for(i = 0; i < meta_page->GetExtentNums(); i++){
-    if(meta_page->extent_used_page_[i] < DiskManager::BITMAP_SIZE){
-      //找到空间
+bool DiskManager::IsPageFree(page_id_t logical_page_id) {
+  page_id_t local_page_id;
+  return GetFile(logical_page_id, local_page_id)->IsPageFree(local_page_id);
+}
+
+dberr_t DiskManager::CreateTablespace(const std::string &name, const std::string &path, uint32_t &space_id) {
+  std::scoped_lock<std::mutex> lock(space_latch_);
+  if (space_names_.find(name) != space_names_.end()) {
+    return DB_ALREADY_EXIST;
+  }
+  for (space_id = DEFAULT_TABLESPACE_ID + 1; space_id < MAX_TABLESPACES; space_id++) {
+    if (files_[space_id] == nullptr) {
       break;
     }
   }
-  if(i == meta_page->GetExtentNums()){
-    if(i==PAGE_SIZE - 8){
-      //full
-      return INVALID_PAGE_ID;
-    }
-    meta_page->num_extents_++;
-    meta_page->extent_used_page_[meta_page->num_extents_ - 1] = 0;
-  }
-  char buffer[PAGE_SIZE];
-  memset(buffer, 0, PAGE_SIZE);
-  ReadPhysicalPage(1 + i * (DiskManager::BITMAP_SIZE + 1), buffer);
-  BitmapPage<PAGE_SIZE> * bitmap = reinterpret_cast<BitmapPage<PAGE_SIZE> * >(buffer);
-  auto page_num = bitmap->GetMaxSupportedSize();
-  for(uint32_t j = 0; j < page_num; j++){
-    if(bitmap->IsPageFree(j)){
-      bitmap->AllocatePage(j);
-      meta_page->num_allocated_pages_++;
-      WritePhysicalPage(1 + i * (DiskManager::BITMAP_SIZE + 1), buffer);
-      meta_page->extent_used_page_[i]++;
-      return meta_page->num_allocated_pages_ - 1;
-    }
+  if (space_id == MAX_TABLESPACES) {
+    return DB_FAILED;
+  }
+  std::string file_name = path.empty() ? file_name_ + "." + name + ".ts" : path;
+  // the file is not ours to overwrite, and its pages would be unknown to the catalog anyway
+  if (std::filesystem::exists(file_name)) {
+    LOG(ERROR) << "Data file " << file_name << " of tablespace " << name << " already exists";
+    return DB_ALREADY_EXIST;
   }
-  return INVALID_PAGE_ID;
+  files_[space_id] = std::make_unique<DiskFile>(file_name, GetPageSize());
+  files_[space_id]->SetGrowthSize(growth_size_);
+  space_names_[name] = space_id;
+  SaveTablespaces();
+  return DB_SUCCESS;
 }
 
+dberr_t DiskManager::GetTablespaceId(const std::string &name, uint32_t &space_id) {
+  std::scoped_lock<std::mutex> lock(space_latch_);
+  auto iter = space_names_.find(name);
+  if (iter == space_names_.end()) {
+    return DB_NOT_EXIST;
+  }
+  space_id = iter->second;
+  return DB_SUCCESS;
+}
 
-void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
-  uint32_t extent_num = logical_page_id / DiskManager::BITMAP_SIZE;
-  uint32_t page_num = logical_page_id % DiskManager::BITMAP_SIZE;
-  DiskFileMetaPage *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
-  char buffer[PAGE_SIZE]; //bitmap
-  memset(buffer, 0, PAGE_SIZE);
-  ReadPhysicalPage(1+extent_num*(DiskManager::BITMAP_SIZE + 1), buffer);
-  BitmapPage<PAGE_SIZE> *bitmap = reinterpret_cast<BitmapPage<PAGE_SIZE>*>(buffer);
-  if(!IsPageFree(logical_page_id)) {
-    meta_page->num_allocated_pages_--;
-    meta_page->extent_used_page_[extent_num]--;
-    bitmap->DeAllocatePage(page_num);
+std::vector<uint32_t> DiskManager::GetTablespaceIds() {
+  std::scoped_lock<std::mutex> lock(space_latch_);
+  std::vector<uint32_t> space_ids;
+  for (uint32_t space_id = 0; space_id < MAX_TABLESPACES; space_id++) {
+    if (files_[space_id] != nullptr) {
+      space_ids.push_back(space_id);
+    }
   }
+  return space_ids;
 }
 
-bool DiskManager::IsPageFree(page_id_t logical_page_id) {
-  uint32_t extent_num = logical_page_id / DiskManager::BITMAP_SIZE;
-  uint32_t page_num = logical_page_id % DiskManager::BITMAP_SIZE;
-  char buffer[PAGE_SIZE];
-  memset(buffer, 0, PAGE_SIZE);
-  ReadPhysicalPage(1 + extent_num * (DiskManager::BITMAP_SIZE + 1), buffer);
-  BitmapPage<PAGE_SIZE> * bitmap = reinterpret_cast<BitmapPage<PAGE_SIZE> *> (buffer);
-  if(bitmap->IsPageFree(page_num)){
-    return true ;
-  }else {
-    return false;
+uint32_t DiskManager::GetAllocatedPages(uint32_t space_id) {
+  ASSERT(space_id < MAX_TABLESPACES && files_[space_id] != nullptr, "Unknown tablespace.");
+  return files_[space_id]->GetAllocatedPages();
+}
+
+uint64_t DiskManager::ShrinkTablespace(uint32_t space_id, uint32_t page_count) {
+  ASSERT(space_id < MAX_TABLESPACES && files_[space_id] != nullptr, "Unknown tablespace.");
+  return files_[space_id]->Shrink(page_count);
+}
+
+uint64_t DiskManager::GetFileSize() {
+  uint64_t size = 0;
+  for (auto space_id : GetTablespaceIds()) {
+    size += files_[space_id]->GetFileSize();
   }
+  return size;
 }
 
-page_id_t DiskManager::MapPageId(page_id_t logical_page_id) {
-  return logical_page_id + logical_page_id / DiskManager::BITMAP_SIZE + 2;
-}
-
-int DiskManager::GetFileSize(const std::string &file_name) {
-  struct stat stat_buf;
-  int rc = stat(file_name.c_str(), &stat_buf);
-  return rc == 0 ? stat_buf.st_size : -1;
-}
-
-void DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data) {
-  int offset = physical_page_id * PAGE_SIZE;
-  // check if read beyond file length
-  if (offset >= GetFileSize(file_name_)) {
-#ifdef ENABLE_BPM_DEBUG
-    LOG(INFO) << "Read less than a page" << std::endl;
-#endif
-    memset(page_data, 0, PAGE_SIZE);
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < PAGE_SIZE) {
-#ifdef ENABLE_BPM_DEBUG
-      LOG(INFO) << "Read less than a page" << std::endl;
-#endif
-      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+void DiskManager::SetGrowthSize(uint64_t growth_size) {
+  std::scoped_lock<std::mutex> lock(space_latch_);
+  growth_size_ = growth_size;
+  for (auto &file : files_) {
+    if (file != nullptr) {
+      file->SetGrowthSize(growth_size);
     }
   }
 }
 
-void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
-  // set write cursor to offset
-  db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
-    LOG(ERROR) << "I/O error while writing";
-    return;
+void DiskManager::LoadTablespaces() {
+  std::ifstream in(GetTablespaceFileName(file_name_));
+  uint32_t space_id;
+  std::string name, path;
+  while (ReadTablespaceEntry(in, space_id, name, path)) {
+    ASSERT(space_id < MAX_TABLESPACES && files_[space_id] == nullptr, "Corrupted tablespace list.");
+    files_[space_id] = std::make_unique<DiskFile>(path, GetPageSize());
+    ASSERT(files_[space_id]->GetPageSize() == GetPageSize(), "Tablespace page size differs from the database.");
+    space_names_[name] = space_id;
+  }
+}
+
+bool DiskManager::ReadTablespaceEntry(std::istream &in, uint32_t &space_id, std::string &name, std::string &path) {
+  if (!(in >> space_id >> name)) {
+    return false;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
-}
\ No newline at end of file
+  // the path takes the rest of the line, spaces included
+  in.get();
+  return static_cast<bool>(std::getline(in, path));
+}
+
+void DiskManager::SaveTablespaces() {
+  std::ostringstream out;
+  for (auto &iter : space_names_) {
+    if (iter.second != DEFAULT_TABLESPACE_ID) {
+      out << iter.second << " " << iter.first << " " << files_[iter.second]->GetFileName() << "\n";
+    }
+  }
+  std::ofstream file(GetTablespaceFileName(file_name_), std::ios::trunc);
+  file << out.str();
+  if (!file.good()) {
+    LOG(ERROR) << "Failed to save tablespaces of " << file_name_;
+  }
+}
@@ -0,0 +1,129 @@
+#include "storage/lsm_heap.h"
+
+LsmHeap::LsmHeap(LsmTree *tree, Schema *schema) : tree_(tree), schema_(schema) {
+  std::string last_key;
+  if (tree_->GetLastKey(&last_key)) {
+    next_sequence_ = FromKey(last_key) + 1;
+  }
+}
+
+bool LsmHeap::InsertTuple(Row &row) {
+  uint64_t sequence = next_sequence_++;
+  row.SetRowId(ToRowId(sequence));
+  std::string value(row.GetSerializedSize(schema_), '\0');
+  row.SerializeTo(value.data(), schema_);
+  return tree_->Put(ToKey(sequence), value);
+}
+
+bool LsmHeap::MarkDelete(const RowId &rid) {
+  uint64_t sequence = ToSequence(rid);
+  std::string value;
+  if (!tree_->Get(ToKey(sequence), &value)) {
+    return false;
+  }
+  std::scoped_lock<std::mutex> lock(marked_latch_);
+  return marked_.insert(sequence).second;
+}
+
+bool LsmHeap::UpdateTuple(const Row &row, const RowId &rid) {
+  uint64_t sequence = ToSequence(rid);
+  std::string value;
+  if (IsMarked(sequence) || !tree_->Get(ToKey(sequence), &value)) {
+    return false;
+  }
+  Row new_row(row);
+  new_row.SetRowId(rid);
+  value.assign(new_row.GetSerializedSize(schema_), '\0');
+  new_row.SerializeTo(value.data(), schema_);
+  return tree_->Put(ToKey(sequence), value);
+}
+
+void LsmHeap::ApplyDelete(const RowId &rid) {
+  uint64_t sequence = ToSequence(rid);
+  {
+    std::scoped_lock<std::mutex> lock(marked_latch_);
+    marked_.erase(sequence);
+  }
+  tree_->Delete(ToKey(sequence));
+}
+
+void LsmHeap::RollbackDelete(const RowId &rid) {
+  std::scoped_lock<std::mutex> lock(marked_latch_);
+  marked_.erase(ToSequence(rid));
+}
+
+bool LsmHeap::GetTuple(Row *row) {
+  RowId rid = row->GetRowId();
+  uint64_t sequence = ToSequence(rid);
+  std::string value;
+  if (IsMarked(sequence) || !tree_->Get(ToKey(sequence), &value)) {
+    return false;
+  }
+  row->DeserializeFrom(value.data(), schema_);
+  row->SetRowId(rid);
+  return true;
+}
+
+page_id_t LsmHeap::ReadPage(page_id_t page_id, std::vector<Row> &rows, size_t &row_count) {
+  row_count = 0;
+  uint64_t next_sequence = next_sequence_;
+  uint64_t low = static_cast<uint64_t>(page_id) * LSM_ROWS_PER_PAGE;
+  if (page_id < 0 || low >= next_sequence) {
+    return INVALID_PAGE_ID;
+  }
+  std::vector<std::pair<std::string, std::string>> entries;
+  tree_->Scan(ToKey(low), ToKey(low + LSM_ROWS_PER_PAGE), entries);
+  for (auto &entry : entries) {
+    RowId rid = ToRowId(FromKey(entry.first));
+    if (IsMarked(ToSequence(rid))) {
+      continue;
+    }
+    if (row_count == rows.size()) {
+      rows.emplace_back();
+    }
+    rows[row_count].DeserializeFrom(entry.second.data(), schema_);
+    rows[row_count++].SetRowId(rid);
+  }
+  return low + LSM_ROWS_PER_PAGE < next_sequence ? page_id + 1 : INVALID_PAGE_ID;
+}
+
+std::vector<page_id_t> LsmHeap::GetPageIds() {
+  uint64_t next_sequence = next_sequence_;
+  std::vector<page_id_t> page_ids((next_sequence + LSM_ROWS_PER_PAGE - 1) / LSM_ROWS_PER_PAGE);
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    page_ids[i] = static_cast<page_id_t>(i);
+  }
+  return page_ids;
+}
+
+page_id_t LsmHeap::GetFirstPageId() { return next_sequence_ == 0 ? INVALID_PAGE_ID : 0; }
+
+uint64_t LsmHeap::ToSequence(const RowId &rid) {
+  return static_cast<uint64_t>(rid.GetPageId()) * LSM_ROWS_PER_PAGE + rid.GetSlotNum();
+}
+
+RowId LsmHeap::ToRowId(uint64_t sequence) {
+  return RowId(static_cast<page_id_t>(sequence / LSM_ROWS_PER_PAGE), sequence % LSM_ROWS_PER_PAGE);
+}
+
+std::string LsmHeap::ToKey(uint64_t sequence) {
+  std::string key(sizeof(uint64_t), '\0');
+  for (int i = sizeof(uint64_t) - 1; i >= 0; i--) {
+    key[i] = static_cast<char>(sequence & 0xff);
+    sequence >>= 8;
+  }
+  return key;
+}
+
+uint64_t LsmHeap::FromKey(const std::string &key) {
+  uint64_t sequence = 0;
+  for (unsigned char c : key) {
+    sequence = sequence << 8 | c;
+  }
+  return sequence;
+}
+
+bool LsmHeap::IsMarked(uint64_t sequence) {
+  std::scoped_lock<std::mutex> lock(marked_latch_);
+  return !marked_.empty() && marked_.count(sequence) != 0;
+}
@@ -0,0 +1,774 @@
+#include "storage/lsm_tree.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+#include "page/lsm_filter_page.h"
+#include "page/lsm_manifest_page.h"
+#include "page/lsm_run_page.h"
+
+// bytes a memtable entry takes beyond its key and value, a rough figure for the tree node and the strings
+static constexpr size_t MEMTABLE_ENTRY_OVERHEAD = 64;
+
+/**
+ * A sorted run on disk. Its pages are freed when the last reference to a run that was replaced goes away.
+ */
+struct LsmTree::Run {
+  Run(DiskManager *disk_manager, uint32_t key_count)
+      : disk_manager_(disk_manager), bloom_(key_count, LSM_BLOOM_BITS_PER_KEY) {}
+
+  ~Run() {
+    if (obsolete_) {
+      for (const auto *chain : {&page_ids_, &fence_page_ids_, &filter_page_ids_}) {
+        for (auto page_id : *chain) {
+          disk_manager_->DeAllocatePage(page_id);
+        }
+      }
+    }
+  }
+
+  DiskManager *disk_manager_;
+  std::vector<page_id_t> page_ids_;
+  std::vector<page_id_t> fence_page_ids_;
+  std::vector<page_id_t> filter_page_ids_;
+  // the first key of every page
+  std::vector<std::string> fence_keys_;
+  std::string last_key_;
+  BloomFilter bloom_;
+  uint32_t entry_count_{0};
+  std::atomic<bool> obsolete_{false};
+};
+
+/**
+ * Walks the entries of one source in key order, tombstones included.
+ */
+class LsmTree::Cursor {
+ public:
+  virtual ~Cursor() = default;
+
+  virtual bool Valid() const = 0;
+
+  virtual const std::string &Key() const = 0;
+
+  virtual const Entry &Value() const = 0;
+
+  virtual void Next() = 0;
+};
+
+class LsmTree::MemtableCursor : public Cursor {
+ public:
+  MemtableCursor(std::shared_ptr<const Memtable> memtable, const std::string &low)
+      : memtable_(std::move(memtable)), iter_(memtable_->lower_bound(low)) {}
+
+  bool Valid() const override { return iter_ != memtable_->end(); }
+
+  const std::string &Key() const override { return iter_->first; }
+
+  const Entry &Value() const override { return iter_->second; }
+
+  void Next() override { ++iter_; }
+
+ private:
+  std::shared_ptr<const Memtable> memtable_;
+  Memtable::const_iterator iter_;
+};
+
+class LsmTree::RunCursor : public Cursor {
+ public:
+  RunCursor(std::shared_ptr<Run> run, const std::string &low, uint32_t page_size)
+      : run_(std::move(run)), buf_(new char[page_size]), page_(buf_.get(), page_size) {
+    // the page before the first one whose fence is larger than low holds low, if the run has it
+    auto fence = std::upper_bound(run_->fence_keys_.begin(), run_->fence_keys_.end(), low);
+    page_index_ = fence == run_->fence_keys_.begin() ? 0 : fence - run_->fence_keys_.begin() - 1;
+    LoadPage();
+    while (Valid() && key_ < low) {
+      Next();
+    }
+  }
+
+  bool Valid() const override { return valid_; }
+
+  const std::string &Key() const override { return key_; }
+
+  const Entry &Value() const override { return entry_; }
+
+  void Next() override {
+    auto *run_page = static_cast<LsmRunPage *>(&page_);
+    if (offset_ == run_page->GetDataEnd()) {
+      page_index_++;
+      LoadPage();
+      return;
+    }
+    offset_ = run_page->ReadEntry(offset_, &key_, &entry_.value_, &entry_.deleted_);
+  }
+
+ private:
+  void LoadPage() {
+    if (page_index_ >= run_->page_ids_.size()) {
+      valid_ = false;
+      return;
+    }
+    run_->disk_manager_->ReadPage(run_->page_ids_[page_index_], buf_.get());
+    offset_ = LsmRunPage::GetFirstOffset();
+    Next();
+  }
+
+ private:
+  std::shared_ptr<Run> run_;
+  std::unique_ptr<char[]> buf_;
+  Page page_;
+  size_t page_index_{0};
+  // the offset behind the current entry
+  uint32_t offset_{0};
+  bool valid_{true};
+  std::string key_;
+  Entry entry_;
+};
+
+/**
+ * Merges sources given newest first, a key shows up once with the entry of the newest source that has it.
+ */
+class LsmTree::MergeCursor : public Cursor {
+ public:
+  explicit MergeCursor(std::vector<std::unique_ptr<Cursor>> sources) : sources_(std::move(sources)) { Settle(); }
+
+  bool Valid() const override { return current_ != nullptr; }
+
+  const std::string &Key() const override { return current_->Key(); }
+
+  const Entry &Value() const override { return current_->Value(); }
+
+  void Next() override {
+    std::string key = current_->Key();
+    for (auto &source : sources_) {
+      if (source->Valid() && source->Key() == key) {
+        source->Next();
+      }
+    }
+    Settle();
+  }
+
+ private:
+  void Settle() {
+    current_ = nullptr;
+    for (auto &source : sources_) {
+      // a tie keeps the source found first, the newer one
+      if (source->Valid() && (current_ == nullptr || source->Key() < current_->Key())) {
+        current_ = source.get();
+      }
+    }
+  }
+
+ private:
+  std::vector<std::unique_ptr<Cursor>> sources_;
+  Cursor *current_{nullptr};
+};
+
+LsmTree::LsmTree(DiskManager *disk_manager, page_id_t manifest_page_id, size_t memtable_size)
+    : disk_manager_(disk_manager),
+      space_id_(DiskManager::GetTablespaceId(manifest_page_id)),
+      page_size_(disk_manager->GetPageSize()),
+      // the entry header, and the page id a key takes as the fence of a page
+      max_entry_size_(LsmRunPage::GetCapacity(disk_manager->GetPageSize()) - 8 - sizeof(page_id_t)),
+      memtable_size_(memtable_size),
+      run_pages_(std::max<size_t>(1, memtable_size / disk_manager->GetPageSize())),
+      manifest_page_ids_{manifest_page_id},
+      version_(std::make_shared<const Version>()) {}
+
+LsmTree *LsmTree::Create(DiskManager *disk_manager, uint32_t space_id, size_t memtable_size) {
+  page_id_t manifest_page_id = disk_manager->AllocatePage(space_id);
+  ASSERT(manifest_page_id != INVALID_PAGE_ID, "Can not allocate the manifest of an LSM tree.");
+  auto *tree = new LsmTree(disk_manager, manifest_page_id, memtable_size);
+  tree->WriteManifest(*tree->version_);
+  tree->thread_ = std::thread(&LsmTree::BackgroundWork, tree);
+  return tree;
+}
+
+LsmTree *LsmTree::Open(DiskManager *disk_manager, page_id_t manifest_page_id, size_t memtable_size) {
+  auto *tree = new LsmTree(disk_manager, manifest_page_id, memtable_size);
+  tree->ReadManifest();
+  tree->thread_ = std::thread(&LsmTree::BackgroundWork, tree);
+  return tree;
+}
+
+LsmTree::~LsmTree() {
+  // the memtable goes out the way a full one does, so level 0 is back within its limit when the tree closes
+  if (!destroyed_) {
+    Flush();
+  }
+  StopBackgroundWork();
+}
+
+bool LsmTree::Put(const std::string &key, const std::string &value) {
+  if (key.size() + value.size() > max_entry_size_) {
+    return false;
+  }
+  Write(key, Entry{value, false});
+  return true;
+}
+
+void LsmTree::Delete(const std::string &key) { Write(key, Entry{std::string(), true}); }
+
+void LsmTree::Write(const std::string &key, Entry entry) {
+  std::unique_lock<std::mutex> lock(latch_);
+  memtable_bytes_ += key.size() + entry.value_.size() + MEMTABLE_ENTRY_OVERHEAD;
+  memtable_[key] = std::move(entry);
+  if (memtable_bytes_ >= memtable_size_) {
+    RotateMemtable(lock);
+  }
+}
+
+void LsmTree::RotateMemtable(std::unique_lock<std::mutex> &lock) {
+  if (immutable_ != nullptr) {
+    write_stalls_++;
+    writer_cv_.wait(lock, [this] { return immutable_ == nullptr; });
+  }
+  immutable_ = std::make_shared<const Memtable>(std::move(memtable_));
+  memtable_.clear();
+  memtable_bytes_ = 0;
+  work_cv_.notify_one();
+}
+
+bool LsmTree::Get(const std::string &key, std::string *value) {
+  std::shared_ptr<const Memtable> immutable;
+  std::shared_ptr<const Version> version;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    auto iter = memtable_.find(key);
+    if (iter != memtable_.end()) {
+      if (!iter->second.deleted_) {
+        *value = iter->second.value_;
+      }
+      return !iter->second.deleted_;
+    }
+    immutable = immutable_;
+    version = version_;
+  }
+  if (immutable != nullptr) {
+    auto iter = immutable->find(key);
+    if (iter != immutable->end()) {
+      if (!iter->second.deleted_) {
+        *value = iter->second.value_;
+      }
+      return !iter->second.deleted_;
+    }
+  }
+  std::unique_ptr<char[]> buf(new char[page_size_]);
+  Entry found;
+  for (const auto &level : *version) {
+    for (const auto &run : level) {
+      if (FindInRun(*run, key, &found, buf.get())) {
+        if (!found.deleted_) {
+          *value = std::move(found.value_);
+        }
+        return !found.deleted_;
+      }
+    }
+  }
+  return false;
+}
+
+bool LsmTree::FindInRun(const Run &run, const std::string &key, Entry *found, char *buf) {
+  if (key < run.fence_keys_.front() || run.last_key_ < key) {
+    return false;
+  }
+  if (!run.bloom_.MayContain(key)) {
+    bloom_skips_++;
+    return false;
+  }
+  auto fence = std::upper_bound(run.fence_keys_.begin(), run.fence_keys_.end(), key);
+  disk_manager_->ReadPage(run.page_ids_[fence - run.fence_keys_.begin() - 1], buf);
+  Page page(buf, page_size_);
+  auto *run_page = static_cast<LsmRunPage *>(&page);
+  std::string entry_key;
+  for (uint32_t offset = LsmRunPage::GetFirstOffset(); offset < run_page->GetDataEnd();) {
+    offset = run_page->ReadEntry(offset, &entry_key, &found->value_, &found->deleted_);
+    if (entry_key == key) {
+      return true;
+    }
+    if (key < entry_key) {
+      break;
+    }
+  }
+  return false;
+}
+
+void LsmTree::Scan(const std::string &low, const std::string &high,
+                   std::vector<std::pair<std::string, std::string>> &entries) {
+  std::vector<std::unique_ptr<Cursor>> sources;
+  {
+    // the memtable keeps changing, the part of it in range is copied
+    std::scoped_lock<std::mutex> lock(latch_);
+    auto memtable = std::make_shared<Memtable>(memtable_.lower_bound(low),
+                                               high.empty() ? memtable_.end() : memtable_.lower_bound(high));
+    sources.emplace_back(new MemtableCursor(memtable, low));
+    if (immutable_ != nullptr) {
+      sources.emplace_back(new MemtableCursor(immutable_, low));
+    }
+    for (const auto &level : *version_) {
+      for (const auto &run : level) {
+        if (run->last_key_ >= low && (high.empty() || run->fence_keys_.front() < high)) {
+          sources.emplace_back(new RunCursor(run, low, page_size_));
+        }
+      }
+    }
+  }
+  MergeCursor cursor(std::move(sources));
+  for (; cursor.Valid() && (high.empty() || cursor.Key() < high); cursor.Next()) {
+    if (!cursor.Value().deleted_) {
+      entries.emplace_back(cursor.Key(), cursor.Value().value_);
+    }
+  }
+}
+
+bool LsmTree::GetLastKey(std::string *key) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  bool found = false;
+  auto candidate = [&](const std::string &last_key) {
+    if (!found || *key < last_key) {
+      *key = last_key;
+      found = true;
+    }
+  };
+  if (!memtable_.empty()) {
+    candidate(memtable_.rbegin()->first);
+  }
+  if (immutable_ != nullptr && !immutable_->empty()) {
+    candidate(immutable_->rbegin()->first);
+  }
+  for (const auto &level : *version_) {
+    for (const auto &run : level) {
+      candidate(run->last_key_);
+    }
+  }
+  return found;
+}
+
+void LsmTree::Flush() {
+  std::unique_lock<std::mutex> lock(latch_);
+  if (!memtable_.empty()) {
+    RotateMemtable(lock);
+  }
+  idle_cv_.wait(lock, [this] { return immutable_ == nullptr && !busy_ && PickCompaction() < 0; });
+}
+
+void LsmTree::Clear(PageReclaimer *reclaimer) {
+  std::shared_ptr<const Version> old_version;
+  {
+    std::unique_lock<std::mutex> lock(latch_);
+    idle_cv_.wait(lock, [this] { return immutable_ == nullptr && !busy_; });
+    memtable_.clear();
+    memtable_bytes_ = 0;
+    old_version = version_;
+    version_ = std::make_shared<const Version>();
+    for (const auto &level : *old_version) {
+      for (const auto &run : level) {
+        run->obsolete_ = true;
+      }
+    }
+  }
+  WriteManifest(Version());
+  if (reclaimer != nullptr) {
+    // the runs are freed with the last reference to them, which the task drops
+    reclaimer->Submit([old_version]() mutable { old_version.reset(); });
+  }
+}
+
+void LsmTree::Destroy() {
+  StopBackgroundWork();
+  std::scoped_lock<std::mutex, std::mutex> lock(latch_, manifest_latch_);
+  memtable_.clear();
+  immutable_ = nullptr;
+  for (const auto &level : *version_) {
+    for (const auto &run : level) {
+      run->obsolete_ = true;
+    }
+  }
+  version_ = std::make_shared<const Version>();
+  for (auto page_id : manifest_page_ids_) {
+    disk_manager_->DeAllocatePage(page_id);
+  }
+  destroyed_ = true;
+}
+
+LsmStats LsmTree::GetStats() {
+  LsmStats stats;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    for (const auto &level : *version_) {
+      stats.level_runs_.push_back(level.size());
+      uint32_t pages = 0;
+      for (const auto &run : level) {
+        pages += run->page_ids_.size();
+      }
+      stats.level_pages_.push_back(pages);
+    }
+  }
+  stats.flushes_ = flushes_;
+  stats.compactions_ = compactions_;
+  stats.bloom_skips_ = bloom_skips_;
+  stats.write_stalls_ = write_stalls_;
+  return stats;
+}
+
+void LsmTree::BackgroundWork() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    work_cv_.wait(lock, [this] { return stop_ || immutable_ != nullptr || PickCompaction() >= 0; });
+    if (stop_) {
+      return;
+    }
+    busy_ = true;
+    if (immutable_ != nullptr) {
+      // flushes go first, writers may be waiting for them
+      std::shared_ptr<const Memtable> immutable = immutable_;
+      lock.unlock();
+      MemtableCursor cursor(immutable, "");
+      std::shared_ptr<Run> run = WriteRun(cursor, false, immutable->size());
+      lock.lock();
+      auto version = std::make_shared<Version>(*version_);
+      if (version->empty()) {
+        version->emplace_back();
+      }
+      if (run != nullptr) {
+        (*version)[0].insert((*version)[0].begin(), run);
+      }
+      version_ = version;
+      immutable_ = nullptr;
+      flushes_++;
+      writer_cv_.notify_all();
+      lock.unlock();
+      WriteManifest(*version);
+      lock.lock();
+    } else {
+      int level = PickCompaction();
+      lock.unlock();
+      Compact(level);
+      lock.lock();
+    }
+    busy_ = false;
+    idle_cv_.notify_all();
+  }
+}
+
+void LsmTree::StopBackgroundWork() {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    stop_ = true;
+  }
+  work_cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+uint64_t LsmTree::GetLevelTarget(size_t level) const {
+  uint64_t target = static_cast<uint64_t>(memtable_size_) * LSM_L0_RUNS;
+  for (size_t i = 1; i < level; i++) {
+    target *= LSM_LEVEL_RATIO;
+  }
+  return target;
+}
+
+int LsmTree::PickCompaction() const {
+  const Version &version = *version_;
+  if (!version.empty() && version[0].size() >= LSM_L0_RUNS) {
+    return 0;
+  }
+  for (size_t level = 1; level < version.size(); level++) {
+    uint64_t pages = 0;
+    for (const auto &run : version[level]) {
+      pages += run->page_ids_.size();
+    }
+    if (pages * page_size_ > GetLevelTarget(level)) {
+      return static_cast<int>(level);
+    }
+  }
+  return -1;
+}
+
+void LsmTree::Compact(int level) {
+  std::shared_ptr<const Version> version;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    version = version_;
+  }
+  // only this thread changes the runs, the version stays current until the result is installed
+  size_t next_level = level + 1;
+  const auto &runs = (*version)[level];
+  // the runs of level 0 overlap and go down together, a deeper level hands down the run behind the one it handed
+  // down last, starting over at its first run
+  std::vector<std::shared_ptr<Run>> inputs;
+  if (level == 0) {
+    inputs = runs;
+  } else {
+    if (compact_keys_.size() <= next_level) {
+      compact_keys_.resize(next_level + 1);
+    }
+    auto next = std::find_if(runs.begin(), runs.end(), [this, level](const std::shared_ptr<Run> &run) {
+      return compact_keys_[level] < run->fence_keys_.front();
+    });
+    inputs.push_back(next == runs.end() ? runs.front() : *next);
+    compact_keys_[level] = inputs.front()->last_key_;
+  }
+  std::string low = inputs.front()->fence_keys_.front();
+  std::string high = inputs.front()->last_key_;
+  for (const auto &run : inputs) {
+    low = std::min(low, run->fence_keys_.front());
+    high = std::max(high, run->last_key_);
+  }
+  // the runs of the next level outside that key range stay as they are
+  std::vector<std::shared_ptr<Run>> overlaps;
+  if (next_level < version->size()) {
+    for (const auto &run : (*version)[next_level]) {
+      if (!(run->last_key_ < low || high < run->fence_keys_.front())) {
+        overlaps.push_back(run);
+      }
+    }
+  }
+  bool deepest = true;
+  for (size_t i = next_level + 1; i < version->size(); i++) {
+    deepest = deepest && (*version)[i].empty();
+  }
+  std::vector<std::unique_ptr<Cursor>> sources;
+  uint64_t key_count = 0;
+  uint64_t input_pages = 0;
+  for (const auto *group : {&inputs, &overlaps}) {
+    for (const auto &run : *group) {
+      sources.emplace_back(new RunCursor(run, "", page_size_));
+      key_count += run->entry_count_;
+      input_pages += run->page_ids_.size();
+    }
+  }
+  // every output run sizes its filter for its share of the keys
+  auto run_keys = static_cast<uint32_t>(input_pages <= run_pages_ ? key_count : key_count * run_pages_ / input_pages + 1);
+  MergeCursor cursor(std::move(sources));
+  std::vector<std::shared_ptr<Run>> outputs;
+  while (cursor.Valid()) {
+    std::shared_ptr<Run> output = WriteRun(cursor, deepest, run_keys, run_pages_);
+    if (output == nullptr) {
+      break;
+    }
+    outputs.push_back(output);
+  }
+  auto new_version = std::make_shared<Version>(*version);
+  if (new_version->size() <= next_level) {
+    new_version->resize(next_level + 1);
+  }
+  auto replaced = [](const std::vector<std::shared_ptr<Run>> &group) {
+    return [&group](const std::shared_ptr<Run> &run) {
+      return std::find(group.begin(), group.end(), run) != group.end();
+    };
+  };
+  auto &from = (*new_version)[level];
+  from.erase(std::remove_if(from.begin(), from.end(), replaced(inputs)), from.end());
+  auto &to = (*new_version)[next_level];
+  to.erase(std::remove_if(to.begin(), to.end(), replaced(overlaps)), to.end());
+  to.insert(to.end(), outputs.begin(), outputs.end());
+  std::sort(to.begin(), to.end(), [](const std::shared_ptr<Run> &a, const std::shared_ptr<Run> &b) {
+    return a->fence_keys_.front() < b->fence_keys_.front();
+  });
+  while (new_version->size() > 1 && new_version->back().empty()) {
+    new_version->pop_back();
+  }
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    version_ = new_version;
+  }
+  WriteManifest(*new_version);
+  compactions_++;
+  // the inputs are freed once the readers still using them are done
+  for (const auto *group : {&inputs, &overlaps}) {
+    for (const auto &run : *group) {
+      run->obsolete_ = true;
+    }
+  }
+}
+
+std::shared_ptr<LsmTree::Run> LsmTree::WriteRun(Cursor &cursor, bool drop_tombstones, uint32_t key_count,
+                                                size_t max_pages) {
+  auto run = std::make_shared<Run>(disk_manager_, key_count);
+  std::unique_ptr<char[]> buf(new char[page_size_]);
+  Page page(buf.get(), page_size_);
+  auto *run_page = static_cast<LsmRunPage *>(&page);
+  page_id_t page_id = INVALID_PAGE_ID;
+  for (; cursor.Valid(); cursor.Next()) {
+    const Entry &entry = cursor.Value();
+    if (drop_tombstones && entry.deleted_) {
+      continue;
+    }
+    if (page_id == INVALID_PAGE_ID || !run_page->Append(cursor.Key(), entry.value_, entry.deleted_)) {
+      // a full run ends with its last page, the entry that did not fit starts the next one
+      if (max_pages != 0 && run->page_ids_.size() == max_pages) {
+        break;
+      }
+      // the pages of a run are allocated one after another, so it is laid out sequentially on disk
+      page_id_t next_page_id = disk_manager_->AllocatePage(space_id_);
+      ASSERT(next_page_id != INVALID_PAGE_ID, "Can not allocate a page of an LSM run.");
+      if (page_id != INVALID_PAGE_ID) {
+        run_page->SetNextPageId(next_page_id);
+        disk_manager_->WritePage(page_id, buf.get());
+      }
+      page_id = next_page_id;
+      run_page->Init(page_id);
+      run->page_ids_.push_back(page_id);
+      run->fence_keys_.push_back(cursor.Key());
+      bool appended = run_page->Append(cursor.Key(), entry.value_, entry.deleted_);
+      ASSERT(appended, "LSM entry larger than a page.");
+      (void)appended;
+    }
+    run->bloom_.Add(cursor.Key());
+    run->last_key_ = cursor.Key();
+    run->entry_count_++;
+  }
+  if (page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  disk_manager_->WritePage(page_id, buf.get());
+  WriteRunIndex(*run);
+  return run;
+}
+
+void LsmTree::WriteRunIndex(Run &run) {
+  std::unique_ptr<char[]> buf(new char[page_size_]);
+  Page page(buf.get(), page_size_);
+  // the fence of every page with its page id, then the last key with none
+  auto *fence_page = static_cast<LsmRunPage *>(&page);
+  page_id_t page_id = INVALID_PAGE_ID;
+  auto append_fence = [&](const std::string &key, page_id_t run_page_id) {
+    std::string value(reinterpret_cast<const char *>(&run_page_id), sizeof(page_id_t));
+    if (page_id != INVALID_PAGE_ID && fence_page->Append(key, value, false)) {
+      return;
+    }
+    page_id_t next_page_id = disk_manager_->AllocatePage(space_id_);
+    ASSERT(next_page_id != INVALID_PAGE_ID, "Can not allocate a fence page of an LSM run.");
+    if (page_id != INVALID_PAGE_ID) {
+      fence_page->SetNextPageId(next_page_id);
+      disk_manager_->WritePage(page_id, buf.get());
+    }
+    page_id = next_page_id;
+    fence_page->Init(page_id);
+    run.fence_page_ids_.push_back(page_id);
+    bool appended = fence_page->Append(key, value, false);
+    ASSERT(appended, "LSM fence larger than a page.");
+    (void)appended;
+  };
+  for (size_t i = 0; i < run.page_ids_.size(); i++) {
+    append_fence(run.fence_keys_[i], run.page_ids_[i]);
+  }
+  append_fence(run.last_key_, INVALID_PAGE_ID);
+  disk_manager_->WritePage(page_id, buf.get());
+  uint32_t filter_size = run.bloom_.GetSerializedSize();
+  std::unique_ptr<char[]> filter(new char[filter_size]);
+  run.bloom_.SerializeTo(filter.get());
+  auto *filter_page = static_cast<LsmFilterPage *>(&page);
+  page_id = INVALID_PAGE_ID;
+  for (uint32_t offset = 0; offset < filter_size;) {
+    page_id_t next_page_id = disk_manager_->AllocatePage(space_id_);
+    ASSERT(next_page_id != INVALID_PAGE_ID, "Can not allocate a filter page of an LSM run.");
+    if (page_id != INVALID_PAGE_ID) {
+      filter_page->SetNextPageId(next_page_id);
+      disk_manager_->WritePage(page_id, buf.get());
+    }
+    page_id = next_page_id;
+    filter_page->Init(page_id);
+    run.filter_page_ids_.push_back(page_id);
+    offset += filter_page->Fill(filter.get() + offset, filter_size - offset);
+  }
+  disk_manager_->WritePage(page_id, buf.get());
+}
+
+std::shared_ptr<LsmTree::Run> LsmTree::ReadRun(const LsmManifestPage::RunRecord &record) {
+  auto run = std::make_shared<Run>(disk_manager_, 0);
+  run->page_ids_.reserve(record.page_count_);
+  run->entry_count_ = record.entry_count_;
+  std::unique_ptr<char[]> buf(new char[page_size_]);
+  Page page(buf.get(), page_size_);
+  auto *fence_page = static_cast<LsmRunPage *>(&page);
+  std::string key;
+  std::string value;
+  bool deleted;
+  for (page_id_t page_id = record.fence_page_id_; page_id != INVALID_PAGE_ID; page_id = fence_page->GetNextPageId()) {
+    disk_manager_->ReadPage(page_id, buf.get());
+    run->fence_page_ids_.push_back(page_id);
+    for (uint32_t offset = LsmRunPage::GetFirstOffset(); offset < fence_page->GetDataEnd();) {
+      offset = fence_page->ReadEntry(offset, &key, &value, &deleted);
+      page_id_t run_page_id;
+      memcpy(&run_page_id, value.data(), sizeof(page_id_t));
+      if (run_page_id == INVALID_PAGE_ID) {
+        run->last_key_ = key;
+      } else {
+        run->page_ids_.push_back(run_page_id);
+        run->fence_keys_.push_back(key);
+      }
+    }
+  }
+  ASSERT(run->page_ids_.size() == record.page_count_, "The fences of an LSM run do not match its manifest record.");
+  auto *filter_page = static_cast<LsmFilterPage *>(&page);
+  std::string filter;
+  for (page_id_t page_id = record.filter_page_id_; page_id != INVALID_PAGE_ID;
+       page_id = filter_page->GetNextPageId()) {
+    disk_manager_->ReadPage(page_id, buf.get());
+    run->filter_page_ids_.push_back(page_id);
+    filter.append(filter_page->GetBytes(), filter_page->GetLength());
+  }
+  run->bloom_.DeserializeFrom(filter.data());
+  return run;
+}
+
+void LsmTree::WriteManifest(const Version &version) {
+  std::vector<LsmManifestPage::RunRecord> records;
+  for (size_t level = 0; level < version.size(); level++) {
+    for (const auto &run : version[level]) {
+      records.push_back({static_cast<uint32_t>(level), run->page_ids_.front(),
+                         static_cast<uint32_t>(run->page_ids_.size()), run->entry_count_,
+                         run->fence_page_ids_.front(), run->filter_page_ids_.front()});
+    }
+  }
+  std::scoped_lock<std::mutex> lock(manifest_latch_);
+  uint32_t capacity = LsmManifestPage::GetCapacity(page_size_);
+  size_t page_count = std::max<size_t>(1, (records.size() + capacity - 1) / capacity);
+  while (manifest_page_ids_.size() < page_count) {
+    page_id_t page_id = disk_manager_->AllocatePage(space_id_);
+    ASSERT(page_id != INVALID_PAGE_ID, "Can not allocate a manifest page of an LSM tree.");
+    manifest_page_ids_.push_back(page_id);
+  }
+  for (size_t i = page_count; i < manifest_page_ids_.size(); i++) {
+    disk_manager_->DeAllocatePage(manifest_page_ids_[i]);
+  }
+  manifest_page_ids_.resize(page_count);
+  std::unique_ptr<char[]> buf(new char[page_size_]);
+  Page page(buf.get(), page_size_);
+  auto *manifest_page = static_cast<LsmManifestPage *>(&page);
+  for (size_t i = 0; i < page_count; i++) {
+    memset(buf.get(), 0, page_size_);
+    manifest_page->Init(manifest_page_ids_[i]);
+    for (size_t j = i * capacity; j < std::min<size_t>(records.size(), (i + 1) * capacity); j++) {
+      manifest_page->Append(records[j]);
+    }
+    manifest_page->SetNextPageId(i + 1 < page_count ? manifest_page_ids_[i + 1] : INVALID_PAGE_ID);
+    disk_manager_->WritePage(manifest_page_ids_[i], buf.get());
+  }
+}
+
+void LsmTree::ReadManifest() {
+  std::unique_ptr<char[]> buf(new char[page_size_]);
+  Page page(buf.get(), page_size_);
+  auto *manifest_page = static_cast<LsmManifestPage *>(&page);
+  auto version = std::make_shared<Version>();
+  page_id_t page_id = manifest_page_ids_.front();
+  manifest_page_ids_.clear();
+  while (page_id != INVALID_PAGE_ID) {
+    manifest_page_ids_.push_back(page_id);
+    disk_manager_->ReadPage(page_id, buf.get());
+    for (uint32_t i = 0; i < manifest_page->GetCount(); i++) {
+      LsmManifestPage::RunRecord record = manifest_page->GetRecord(i);
+      if (version->size() <= record.level_) {
+        version->resize(record.level_ + 1);
+      }
+      (*version)[record.level_].push_back(ReadRun(record));
+    }
+    page_id = manifest_page->GetNextPageId();
+  }
+  version_ = version;
+}
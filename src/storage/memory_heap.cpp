@@ -0,0 +1,122 @@
+#include "storage/memory_heap.h"
+
+#include <mutex>
+
+void MemoryHeap::InsertTuple(Row &row) {
+  std::unique_lock<std::shared_mutex> lock(latch_);
+  RowId rid;
+  if (!free_slots_.empty()) {
+    rid = free_slots_.back();
+    free_slots_.pop_back();
+  } else {
+    if (next_slot_ == ROWS_PER_CHUNK) {
+      chunks_.push_back(std::make_unique<Chunk>());
+      next_slot_ = 0;
+    }
+    rid = RowId(static_cast<page_id_t>(chunks_.size() - 1), next_slot_++);
+  }
+  row.SetRowId(rid);
+  Chunk *chunk = chunks_[rid.GetPageId()].get();
+  chunk->rows_[rid.GetSlotNum()] = row;
+  chunk->states_[rid.GetSlotNum()] = SlotState::kLive;
+}
+
+bool MemoryHeap::MarkDelete(const RowId &rid) {
+  std::unique_lock<std::shared_mutex> lock(latch_);
+  SlotState *state = FindSlot(rid);
+  if (state == nullptr || *state != SlotState::kLive) {
+    return false;
+  }
+  *state = SlotState::kDeleted;
+  return true;
+}
+
+bool MemoryHeap::UpdateTuple(const Row &row, const RowId &rid) {
+  std::unique_lock<std::shared_mutex> lock(latch_);
+  SlotState *state = FindSlot(rid);
+  if (state == nullptr || *state != SlotState::kLive) {
+    return false;
+  }
+  Row &old_row = chunks_[rid.GetPageId()]->rows_[rid.GetSlotNum()];
+  old_row = row;
+  old_row.SetRowId(rid);
+  return true;
+}
+
+void MemoryHeap::ApplyDelete(const RowId &rid) {
+  std::unique_lock<std::shared_mutex> lock(latch_);
+  SlotState *state = FindSlot(rid);
+  if (state == nullptr || *state == SlotState::kFree) {
+    return;
+  }
+  *state = SlotState::kFree;
+  chunks_[rid.GetPageId()]->rows_[rid.GetSlotNum()].destroy();
+  free_slots_.push_back(rid);
+}
+
+void MemoryHeap::RollbackDelete(const RowId &rid) {
+  std::unique_lock<std::shared_mutex> lock(latch_);
+  SlotState *state = FindSlot(rid);
+  if (state != nullptr && *state == SlotState::kDeleted) {
+    *state = SlotState::kLive;
+  }
+}
+
+bool MemoryHeap::GetTuple(Row *row) {
+  std::shared_lock<std::shared_mutex> lock(latch_);
+  RowId rid = row->GetRowId();
+  SlotState *state = FindSlot(rid);
+  if (state == nullptr || *state != SlotState::kLive) {
+    return false;
+  }
+  *row = chunks_[rid.GetPageId()]->rows_[rid.GetSlotNum()];
+  return true;
+}
+
+page_id_t MemoryHeap::ReadChunk(page_id_t chunk_id, std::vector<Row> &rows, size_t &row_count) {
+  std::shared_lock<std::shared_mutex> lock(latch_);
+  row_count = 0;
+  if (chunk_id < 0 || static_cast<size_t>(chunk_id) >= chunks_.size()) {
+    return INVALID_PAGE_ID;
+  }
+  Chunk *chunk = chunks_[chunk_id].get();
+  for (uint32_t slot = 0; slot < ROWS_PER_CHUNK; slot++) {
+    if (chunk->states_[slot] != SlotState::kLive) {
+      continue;
+    }
+    if (row_count == rows.size()) {
+      rows.emplace_back();
+    }
+    rows[row_count++] = chunk->rows_[slot];
+  }
+  return static_cast<size_t>(chunk_id) + 1 < chunks_.size() ? chunk_id + 1 : INVALID_PAGE_ID;
+}
+
+std::vector<page_id_t> MemoryHeap::GetChunkIds() {
+  std::shared_lock<std::shared_mutex> lock(latch_);
+  std::vector<page_id_t> chunk_ids(chunks_.size());
+  for (size_t i = 0; i < chunk_ids.size(); i++) {
+    chunk_ids[i] = static_cast<page_id_t>(i);
+  }
+  return chunk_ids;
+}
+
+page_id_t MemoryHeap::GetFirstChunkId() {
+  std::shared_lock<std::shared_mutex> lock(latch_);
+  return chunks_.empty() ? INVALID_PAGE_ID : 0;
+}
+
+void MemoryHeap::Clear() {
+  std::unique_lock<std::shared_mutex> lock(latch_);
+  chunks_.clear();
+  free_slots_.clear();
+  next_slot_ = ROWS_PER_CHUNK;
+}
+
+MemoryHeap::SlotState *MemoryHeap::FindSlot(const RowId &rid) {
+  if (rid.GetPageId() < 0 || static_cast<size_t>(rid.GetPageId()) >= chunks_.size() ||
+      rid.GetSlotNum() >= ROWS_PER_CHUNK) {
+    return nullptr;
+  }
+  return &chunks_[rid.GetPageId()]->states_[rid.GetSlotNum()];
+}
@@ -0,0 +1,52 @@
+#include "storage/page_reclaimer.h"
+
+PageReclaimer::~PageReclaimer() {
+  if (!thread_.joinable()) {
+    return;
+  }
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    stop_ = true;
+  }
+  task_cv_.notify_all();
+  thread_.join();
+}
+
+void PageReclaimer::Submit(std::function<void()> task) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  tasks_.push_back(std::move(task));
+  pending_++;
+  if (!thread_.joinable()) {
+    thread_ = std::thread(&PageReclaimer::Run, this);
+  }
+  task_cv_.notify_one();
+}
+
+void PageReclaimer::Wait() {
+  std::unique_lock<std::mutex> lock(latch_);
+  idle_cv_.wait(lock, [this] { return pending_ == 0; });
+}
+
+size_t PageReclaimer::GetPendingCount() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return pending_;
+}
+
+void PageReclaimer::Run() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    task_cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+    // a stop still runs the tasks left, their pages would stay allocated otherwise
+    if (tasks_.empty()) {
+      return;
+    }
+    std::function<void()> task = std::move(tasks_.front());
+    tasks_.pop_front();
+    lock.unlock();
+    task();
+    lock.lock();
+    if (--pending_ == 0) {
+      idle_cv_.notify_all();
+    }
+  }
+}
@@ -1,42 +1,333 @@
 #include "storage/table_heap.h"
 
+#include <algorithm>
+
 bool TableHeap::InsertTuple(Row &row, Transaction *txn) {
-  uint32_t row_size = row.GetSerializedSize(schema_);
-  if(row_size + 32 > PAGE_SIZE) return false;
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
-  if(cur_page == nullptr) return false;
+  if (!ExternalizeValues(row)) return false;
+  if (storage_ == TableStorage::kMemory) {
+    memory_heap_->InsertTuple(row);
+    zone_map_.Widen(row.GetRowId().GetPageId(), row);
+    return true;
+  }
+  if (storage_ == TableStorage::kLsm) {
+    if (!lsm_heap_->InsertTuple(row)) {
+      return false;
+    }
+    zone_map_.Widen(row.GetRowId().GetPageId(), row);
+    return true;
+  }
+  if (storage_ == TableStorage::kCompressed) {
+    if (!compressed_heap_->InsertTuple(row)) {
+      return false;
+    }
+    zone_map_.Widen(row.GetRowId().GetPageId(), row);
+    return true;
+  }
+  if (storage_ == TableStorage::kClustered) {
+    if (!clustered_heap_->InsertTuple(row)) {
+      return false;
+    }
+    zone_map_.Widen(row.GetRowId().GetPageId(), row);
+    return true;
+  }
+  if (!CanStore(row)) {
+    DropOverflows(row);
+    return false;
+  }
+  uint32_t needed = GetSpaceNeeded(row);
+  while (true) {
+    // the page is latched without the latch of the map, other threads insert into pages of their own meanwhile
+    page_id_t page_id = ClaimInsertionPage(needed, txn);
+    if (page_id == INVALID_PAGE_ID) {
+      DropOverflows(row);
+      return false;
+    }
+    auto cur_page = buffer_pool_manager_->FetchPage(page_id);
+    if (cur_page == nullptr) {
+      DropOverflows(row);
+      return false;
+    }
+    cur_page->WLatch();
+    bool inserted = InsertInPage(cur_page, row, txn);
+    uint32_t free_bytes = GetFreeSpace(cur_page);
+    cur_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, inserted);
+    {
+      // a failed insert corrects the map, so the same page is not picked again
+      std::scoped_lock<std::mutex> lock(fsm_latch_);
+      UpdateFreeSpace(page_id, free_bytes);
+    }
+    if (inserted) {
+      zone_map_.Widen(page_id, row);
+      return true;
+    }
+  }
+}
+
+bool TableHeap::BulkInsertTuples(std::vector<Row> &rows, Transaction *txn) {
+  if (storage_ == TableStorage::kMemory || storage_ == TableStorage::kLsm || storage_ == TableStorage::kClustered) {
+    for (auto &row : rows) {
+      if (!InsertTuple(row, txn)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (storage_ == TableStorage::kCompressed) {
+    // the open block is written once for the whole batch
+    bool inserted = compressed_heap_->InsertTuples(rows);
+    for (auto &row : rows) {
+      if (row.GetRowId().GetPageId() != INVALID_PAGE_ID) {
+        zone_map_.Widen(row.GetRowId().GetPageId(), row);
+      }
+    }
+    return inserted;
+  }
+  std::scoped_lock<std::mutex> lock(fsm_latch_);
+  page_id_t page_id = heap_page_ids_.back();
+  auto cur_page = buffer_pool_manager_->FetchPage(page_id);
+  if (cur_page == nullptr) return false;
   cur_page->WLatch();
-  //RowId rid(cur_page->GetPageId(), i);
-  //row.SetRowId(rid);
-  while(!cur_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_)){
-    auto next_page_id = cur_page->GetNextPageId();
-    if(next_page_id != INVALID_PAGE_ID){
+  bool success = true;
+  for (auto &row : rows) {
+    if (!ExternalizeValues(row)) {
+      success = false;
+      break;
+    }
+    if (!CanStore(row)) {
+      DropOverflows(row);
+      success = false;
+      break;
+    }
+    while (!InsertInPage(cur_page, row, txn)) {
+      // the page is full, move on to a fresh one
+      uint32_t free_bytes = GetFreeSpace(cur_page);
       cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetPageId(), false);
-      cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
-      cur_page->WLatch();
-    }else{
-      auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(next_page_id));
-      if(new_page == nullptr){
-        cur_page->WUnlatch();
-        buffer_pool_manager_->UnpinPage(cur_page->GetPageId(), false);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      UpdateFreeSpace(page_id, free_bytes);
+      page_id = AppendPage(txn);
+      cur_page = page_id == INVALID_PAGE_ID ? nullptr : buffer_pool_manager_->FetchPage(page_id);
+      if (cur_page == nullptr) {
+        DropOverflows(row);
         return false;
-      }else{
-        new_page->WLatch();
-        cur_page->SetNextPageId(next_page_id);
-        new_page->Init(next_page_id, cur_page->GetPageId(), log_manager_, txn);
-        cur_page->WUnlatch();
-        buffer_pool_manager_->UnpinPage(cur_page->GetPageId(), true);
-        cur_page = new_page;
       }
+      cur_page->WLatch();
     }
+    zone_map_.Widen(page_id, row);
   }
+  uint32_t free_bytes = GetFreeSpace(cur_page);
   cur_page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(cur_page->GetPageId(), true);
-  return true;
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  UpdateFreeSpace(page_id, free_bytes);
+  return success;
+}
+
+void TableHeap::InitFreeSpaceMap(uint32_t space_id) {
+  page_id_t fsm_page_id;
+  auto fsm_page = static_cast<FreeSpaceMapPage *>(buffer_pool_manager_->NewPage(fsm_page_id, space_id));
+  ASSERT(fsm_page != nullptr, "Failed to allocate the free space map.");
+  fsm_page->Init(fsm_page_id);
+  uint32_t page_size = buffer_pool_manager_->GetPageSize();
+  // the first page is still empty, all of it but the header is free
+  uint32_t free_bytes = storage_ == TableStorage::kColumn
+                            ? column_layout_->GetCapacity() * column_layout_->GetSlotSpace()
+                            : TablePage::GetSpaceNeeded(TablePage::GetMaxRowSize(page_size));
+  uint8_t category = FreeSpaceMapPage::ToCategory(free_bytes, page_size);
+  fsm_page->Append(first_page_id_, category);
+  buffer_pool_manager_->UnpinPage(fsm_page_id, true);
+  fsm_page_ids_.push_back(fsm_page_id);
+  heap_page_ids_.push_back(first_page_id_);
+  fsm_slots_[first_page_id_] = 0;
+  fsm_categories_.push_back(category);
+  pages_by_free_space_.emplace(category, 0);
+}
+
+void TableHeap::LoadFreeSpaceMap() {
+  page_id_t fsm_page_id = fsm_page_ids_.front();
+  fsm_page_ids_.clear();
+  while (fsm_page_id != INVALID_PAGE_ID) {
+    auto fsm_page = static_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(fsm_page_id));
+    ASSERT(fsm_page != nullptr, "Failed to read the free space map.");
+    fsm_page_ids_.push_back(fsm_page_id);
+    for (uint32_t i = 0; i < fsm_page->GetCount(); i++) {
+      uint32_t slot = heap_page_ids_.size();
+      heap_page_ids_.push_back(fsm_page->GetHeapPageId(i));
+      fsm_slots_[heap_page_ids_.back()] = slot;
+      fsm_categories_.push_back(fsm_page->GetCategory(i));
+      pages_by_free_space_.emplace(fsm_categories_.back(), slot);
+    }
+    page_id_t next_page_id = fsm_page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(fsm_page_id, false);
+    fsm_page_id = next_page_id;
+  }
+  ASSERT(!heap_page_ids_.empty() && heap_page_ids_.front() == first_page_id_,
+         "Free space map does not belong to the table heap.");
+}
+
+page_id_t TableHeap::FindPageWithSpace(uint32_t needed) {
+  uint32_t category = FreeSpaceMapPage::ToNeededCategory(needed, buffer_pool_manager_->GetPageSize());
+  if (category > UINT8_MAX) {
+    return INVALID_PAGE_ID;
+  }
+  // the fullest page that still has room, which keeps the emptier pages for larger rows
+  auto iter = pages_by_free_space_.lower_bound(std::make_pair(static_cast<uint8_t>(category), 0U));
+  while (iter != pages_by_free_space_.end() && claimed_pages_.count(heap_page_ids_[iter->second]) != 0) {
+    ++iter;
+  }
+  return iter == pages_by_free_space_.end() ? INVALID_PAGE_ID : heap_page_ids_[iter->second];
+}
+
+page_id_t TableHeap::ClaimInsertionPage(uint32_t needed, Transaction *txn) {
+  std::scoped_lock<std::mutex> lock(fsm_latch_);
+  uint32_t category = FreeSpaceMapPage::ToNeededCategory(needed, buffer_pool_manager_->GetPageSize());
+  auto owned = insertion_pages_.find(std::this_thread::get_id());
+  if (owned != insertion_pages_.end()) {
+    auto slot = fsm_slots_.find(owned->second);
+    if (slot != fsm_slots_.end() && category <= fsm_categories_[slot->second]) {
+      return owned->second;
+    }
+    claimed_pages_.erase(owned->second);
+    insertion_pages_.erase(owned);
+  }
+  page_id_t page_id = FindPageWithSpace(needed);
+  if (page_id == INVALID_PAGE_ID) {
+    page_id = AppendPage(txn);
+    if (page_id == INVALID_PAGE_ID) {
+      return INVALID_PAGE_ID;
+    }
+  }
+  // threads that are gone keep their pages, they are all handed back once there are too many
+  if (insertion_pages_.size() >= MAX_INSERTION_PAGES) {
+    insertion_pages_.clear();
+    claimed_pages_.clear();
+  }
+  insertion_pages_.emplace(std::this_thread::get_id(), page_id);
+  claimed_pages_.insert(page_id);
+  return page_id;
+}
+
+page_id_t TableHeap::AppendPage(Transaction *txn) {
+  page_id_t last_page_id = heap_page_ids_.back();
+  page_id_t new_page_id;
+  auto new_page = buffer_pool_manager_->NewPage(new_page_id, DiskManager::GetTablespaceId(first_page_id_));
+  if (new_page == nullptr) {
+    return INVALID_PAGE_ID;
+  }
+  // column pages keep the links where table pages do
+  auto last_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id));
+  if (last_page == nullptr) {
+    buffer_pool_manager_->UnpinPage(new_page_id, false);
+    buffer_pool_manager_->DeletePage(new_page_id);
+    return INVALID_PAGE_ID;
+  }
+  new_page->WLatch();
+  InitPage(new_page, new_page_id, last_page_id, txn);
+  uint32_t free_bytes = GetFreeSpace(new_page);
+  new_page->WUnlatch();
+  last_page->WLatch();
+  last_page->SetNextPageId(new_page_id);
+  last_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(last_page_id, true);
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+  // add the page to the last map page, starting a new map page when it is full
+  page_id_t fsm_page_id = fsm_page_ids_.back();
+  auto fsm_page = static_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(fsm_page_id));
+  ASSERT(fsm_page != nullptr, "Failed to read the free space map.");
+  if (fsm_page->IsFull()) {
+    page_id_t next_fsm_page_id;
+    auto next_fsm_page = static_cast<FreeSpaceMapPage *>(
+        buffer_pool_manager_->NewPage(next_fsm_page_id, DiskManager::GetTablespaceId(first_page_id_)));
+    ASSERT(next_fsm_page != nullptr, "Failed to allocate the free space map.");
+    next_fsm_page->Init(next_fsm_page_id);
+    fsm_page->SetNextPageId(next_fsm_page_id);
+    buffer_pool_manager_->UnpinPage(fsm_page_id, true);
+    fsm_page_ids_.push_back(next_fsm_page_id);
+    fsm_page_id = next_fsm_page_id;
+    fsm_page = next_fsm_page;
+  }
+  uint8_t category = FreeSpaceMapPage::ToCategory(free_bytes, buffer_pool_manager_->GetPageSize());
+  fsm_page->Append(new_page_id, category);
+  buffer_pool_manager_->UnpinPage(fsm_page_id, true);
+  uint32_t slot = heap_page_ids_.size();
+  heap_page_ids_.push_back(new_page_id);
+  fsm_slots_[new_page_id] = slot;
+  fsm_categories_.push_back(category);
+  pages_by_free_space_.emplace(category, slot);
+  return new_page_id;
+}
+
+void TableHeap::InitPage(Page *page, page_id_t page_id, page_id_t prev_id, Transaction *txn) {
+  if (storage_ == TableStorage::kColumn) {
+    static_cast<ColumnPage *>(page)->Init(page_id, prev_id);
+  } else {
+    static_cast<TablePage *>(page)->Init(page_id, prev_id, log_manager_, txn);
+  }
+}
+
+uint32_t TableHeap::GetFreeSpace(Page *page) {
+  if (storage_ == TableStorage::kColumn) {
+    return static_cast<ColumnPage *>(page)->GetFreeSpaceRemaining(*column_layout_);
+  }
+  return static_cast<TablePage *>(page)->GetFreeSpaceRemaining();
+}
+
+bool TableHeap::CanStore(const Row &row) {
+  if (storage_ == TableStorage::kColumn) {
+    return column_layout_->CanStore(row);
+  }
+  return row.GetSerializedSize(schema_) <= TablePage::GetMaxRowSize(buffer_pool_manager_->GetPageSize());
+}
+
+uint32_t TableHeap::GetSpaceNeeded(const Row &row) {
+  if (storage_ == TableStorage::kColumn) {
+    return column_layout_->GetSlotSpace();
+  }
+  return TablePage::GetSpaceNeeded(row.GetSerializedSize(schema_));
+}
+
+bool TableHeap::InsertInPage(Page *page, Row &row, Transaction *txn) {
+  if (storage_ == TableStorage::kColumn) {
+    return static_cast<ColumnPage *>(page)->InsertTuple(row, *column_layout_);
+  }
+  return static_cast<TablePage *>(page)->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+}
+
+void TableHeap::UpdateFreeSpace(page_id_t page_id, uint32_t free_bytes) {
+  uint32_t page_size = buffer_pool_manager_->GetPageSize();
+  uint8_t category = FreeSpaceMapPage::ToCategory(free_bytes, page_size);
+  auto slot_iter = fsm_slots_.find(page_id);
+  ASSERT(slot_iter != fsm_slots_.end(), "Page is not part of the table heap.");
+  uint32_t slot = slot_iter->second;
+  if (fsm_categories_[slot] == category) {
+    return;
+  }
+  pages_by_free_space_.erase(std::make_pair(fsm_categories_[slot], slot));
+  pages_by_free_space_.emplace(category, slot);
+  fsm_categories_[slot] = category;
+  uint32_t capacity = FreeSpaceMapPage::GetCapacity(page_size);
+  page_id_t fsm_page_id = fsm_page_ids_[slot / capacity];
+  auto fsm_page = static_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(fsm_page_id));
+  ASSERT(fsm_page != nullptr, "Failed to read the free space map.");
+  fsm_page->SetCategory(slot % capacity, category);
+  buffer_pool_manager_->UnpinPage(fsm_page_id, true);
 }
 
 bool TableHeap::MarkDelete(const RowId &rid, Transaction *txn) {
+  if (storage_ == TableStorage::kColumn) {
+    return MarkColumnDelete(rid);
+  }
+  if (storage_ == TableStorage::kMemory) {
+    return memory_heap_->MarkDelete(rid);
+  }
+  if (storage_ == TableStorage::kLsm) {
+    return lsm_heap_->MarkDelete(rid);
+  }
+  if (storage_ == TableStorage::kCompressed) {
+    return compressed_heap_->MarkDelete(rid);
+  }
+  if (storage_ == TableStorage::kClustered) {
+    return clustered_heap_->MarkDelete(rid);
+  }
   // Find the page which contains the tuple.
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   // If the page could not be found, then abort the transaction.
@@ -46,97 +337,835 @@ bool TableHeap::MarkDelete(const RowId &rid, Transaction *txn) {
   // Otherwise, mark the tuple as deleted.
   page->WLatch();
   page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  RowId target;
+  bool forwarded = page->GetForward(rid, &target);
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  // a moved row is hidden from scans as well
+  if (forwarded) {
+    auto target_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(target.GetPageId()));
+    ASSERT(target_page != nullptr, "Can not fetch the page of a moved row.");
+    target_page->WLatch();
+    target_page->MarkDelete(target, txn, lock_manager_, log_manager_);
+    target_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(target.GetPageId(), true);
+  }
   return true;
 }
 
 bool TableHeap::UpdateTuple(Row &row, const RowId &rid, Transaction *txn) {
+  if (storage_ == TableStorage::kColumn) {
+    return UpdateColumnTuple(row, rid);
+  }
+  if (storage_ == TableStorage::kMemory) {
+    ExternalizeValues(row);
+    if (!memory_heap_->UpdateTuple(row, rid)) {
+      return false;
+    }
+    zone_map_.Widen(rid.GetPageId(), row);
+    return true;
+  }
+  if (storage_ == TableStorage::kLsm) {
+    if (!lsm_heap_->UpdateTuple(row, rid)) {
+      return false;
+    }
+    zone_map_.Widen(rid.GetPageId(), row);
+    return true;
+  }
+  if (storage_ == TableStorage::kClustered) {
+    if (!clustered_heap_->UpdateTuple(row, rid)) {
+      return false;
+    }
+    zone_map_.Widen(rid.GetPageId(), row);
+    return true;
+  }
+  // the rows of a compressed block are never rewritten
+  if (storage_ == TableStorage::kCompressed) {
+    return false;
+  }
+  std::vector<page_id_t> old_overflows;
+  GetTupleOverflows(rid, old_overflows);
+  if (!ExternalizeValues(row)) {
+    return false;
+  }
+  if (!UpdateRowTuple(row, rid, txn)) {
+    DropOverflows(row);
+    return false;
+  }
+  // the old values are not referred to any more
+  for (auto first_page_id : old_overflows) {
+    FreeOverflow(first_page_id);
+  }
+  return true;
+}
+
+bool TableHeap::UpdateRowTuple(Row &row, const RowId &rid, Transaction *txn) {
+  if (row.GetSerializedSize(schema_) > TablePage::GetMaxRowSize(buffer_pool_manager_->GetPageSize())) {
+    return false;
+  }
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   if(page == nullptr) return false;
   page->WLatch();
-  Row pre_row(rid);
+  // a moved row goes back to its home page as soon as that has room, otherwise it is updated where it lives now
+  RowId target;
+  if (page->GetForward(rid, &target) && page->ReplaceForward(rid.GetSlotNum(), row, schema_)) {
+    uint32_t free_bytes = page->GetFreeSpaceRemaining();
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
+    uint32_t target_free_bytes = DeleteInPage(target, txn);
+    zone_map_.Widen(rid.GetPageId(), row);
+    std::scoped_lock<std::mutex> lock(fsm_latch_);
+    UpdateFreeSpace(rid.GetPageId(), free_bytes);
+    UpdateFreeSpace(target.GetPageId(), target_free_bytes);
+    return true;
+  }
+  if (page->GetForward(rid, &target)) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
+    page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(target.GetPageId()));
+    ASSERT(page != nullptr, "Can not fetch the page of a moved row.");
+    page->WLatch();
+  } else {
+    target = rid;
+  }
+  Row pre_row(target);
   int flag = page->UpdateTuple(row, &pre_row, schema_, txn, lock_manager_, log_manager_);
+  uint32_t free_bytes = page->GetFreeSpaceRemaining();
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(target.GetPageId(), flag == 1);
   switch(flag){
     case 1:
-      page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
       break;
     case 0: // slotID越界，返回错误，不更新
-      page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
-      return false;
     case 2: // 标记删除/物理删除，不更新
-      page->ApplyDelete(rid, txn, log_manager_);
-      page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
-      break;
-    case 3:
-      page->ApplyDelete(rid, txn, log_manager_);
-      page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
-      InsertTuple(row, txn);
+      return false;
+    case 3: // 页内放不下，行搬走，原来的row id留下转发指针
+      return MoveTuple(row, rid, txn);
+  }
+  zone_map_.Widen(target.GetPageId(), row);
+  std::scoped_lock<std::mutex> lock(fsm_latch_);
+  UpdateFreeSpace(target.GetPageId(), free_bytes);
+  return true;
+}
+
+bool TableHeap::MoveTuple(Row &row, const RowId &rid, Transaction *txn) {
+  std::scoped_lock<std::mutex> lock(fsm_latch_);
+  auto home_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  ASSERT(home_page != nullptr, "Can not fetch the table page.");
+  home_page->WLatch();
+  RowId old_target;
+  bool forwarded = home_page->GetForward(rid, &old_target);
+  bool moved = false;
+  RowId new_target;
+  // the row keeps the row id of its home slot wherever it goes
+  row.SetRowId(rid);
+  uint32_t needed = TablePage::GetSpaceNeeded(row.GetSerializedSize(schema_));
+  while (!moved) {
+    page_id_t page_id = FindPageWithSpace(needed);
+    if (page_id == INVALID_PAGE_ID) {
+      page_id = AppendPage(txn);
+      if (page_id == INVALID_PAGE_ID) {
+        break;
+      }
+    }
+    // the home page has no room, the map may not know that yet
+    if (page_id == rid.GetPageId()) {
+      UpdateFreeSpace(page_id, home_page->GetFreeSpaceRemaining());
+      continue;
+    }
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    if (page == nullptr) {
       break;
+    }
+    page->WLatch();
+    moved = page->InsertMovedTuple(row, schema_, &new_target);
+    uint32_t free_bytes = page->GetFreeSpaceRemaining();
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, moved);
+    UpdateFreeSpace(page_id, free_bytes);
+  }
+  if (moved) {
+    home_page->SetForward(rid.GetSlotNum(), new_target);
+    zone_map_.Widen(new_target.GetPageId(), row);
+  }
+  uint32_t home_free_bytes = home_page->GetFreeSpaceRemaining();
+  home_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), moved);
+  if (!moved) {
+    return false;
+  }
+  UpdateFreeSpace(rid.GetPageId(), home_free_bytes);
+  // the old copy of a row that moved before is dropped, stubs never chain
+  if (forwarded) {
+    UpdateFreeSpace(old_target.GetPageId(), DeleteInPage(old_target, txn));
   }
   return true;
 }
 
+uint32_t TableHeap::DeleteInPage(const RowId &rid, Transaction *txn) {
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  ASSERT(page != nullptr, "Can not fetch the table page.");
+  page->WLatch();
+  page->ApplyDelete(rid, txn, log_manager_);
+  uint32_t free_bytes = page->GetFreeSpaceRemaining();
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
+  return free_bytes;
+}
+
 void TableHeap::ApplyDelete(const RowId &rid, Transaction *txn) {
+  if (storage_ == TableStorage::kColumn) {
+    ApplyColumnDelete(rid);
+    return;
+  }
+  if (storage_ == TableStorage::kMemory) {
+    memory_heap_->ApplyDelete(rid);
+    return;
+  }
+  if (storage_ == TableStorage::kLsm) {
+    lsm_heap_->ApplyDelete(rid);
+    return;
+  }
+  if (storage_ == TableStorage::kClustered) {
+    clustered_heap_->ApplyDelete(rid);
+    return;
+  }
+  if (storage_ == TableStorage::kCompressed) {
+    compressed_heap_->ApplyDelete(rid);
+    return;
+  }
+  std::vector<page_id_t> overflows;
+  GetTupleOverflows(rid, overflows);
   // Step1: Find the page which contains the tuple.
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   ASSERT(page != nullptr, "page is null!");
-  // Step2: Delete the tuple from the page.
+  // Step2: Delete the tuple from the page, and a moved row from the page it moved to.
   page->WLatch();
+  RowId target;
+  bool forwarded = page->GetForward(rid, &target);
   page->ApplyDelete(rid, txn, log_manager_);
+  uint32_t free_bytes = page->GetFreeSpaceRemaining();
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+  uint32_t target_free_bytes = forwarded ? DeleteInPage(target, txn) : 0;
+  // Step3: Let later inserts find the space that was freed.
+  std::scoped_lock<std::mutex> lock(fsm_latch_);
+  UpdateFreeSpace(rid.GetPageId(), free_bytes);
+  if (forwarded) {
+    UpdateFreeSpace(target.GetPageId(), target_free_bytes);
+  }
+  // Step4: Free the overflow chains of the tuple.
+  for (auto first_page_id : overflows) {
+    FreeOverflow(first_page_id);
+  }
 }
 
 void TableHeap::RollbackDelete(const RowId &rid, Transaction *txn) {
+  // a zone map built while the row was deleted does not cover it, aborts are rare enough to build the map again
+  zone_map_.Clear();
+  if (storage_ == TableStorage::kColumn) {
+    RollbackColumnDelete(rid);
+    return;
+  }
+  if (storage_ == TableStorage::kMemory) {
+    memory_heap_->RollbackDelete(rid);
+    return;
+  }
+  if (storage_ == TableStorage::kLsm) {
+    lsm_heap_->RollbackDelete(rid);
+    return;
+  }
+  if (storage_ == TableStorage::kClustered) {
+    clustered_heap_->RollbackDelete(rid);
+    return;
+  }
+  if (storage_ == TableStorage::kCompressed) {
+    compressed_heap_->RollbackDelete(rid);
+    return;
+  }
   // Find the page which contains the tuple.
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   assert(page != nullptr);
   // Rollback to delete.
   page->WLatch();
   page->RollbackDelete(rid, txn, log_manager_);
+  RowId target;
+  bool forwarded = page->GetForward(rid, &target);
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  if (forwarded) {
+    auto target_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(target.GetPageId()));
+    assert(target_page != nullptr);
+    target_page->WLatch();
+    target_page->RollbackDelete(target, txn, log_manager_);
+    target_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(target.GetPageId(), true);
+  }
 }
 
 bool TableHeap::GetTuple(Row *row, Transaction *txn) {
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(row->GetRowId().GetPageId()));
+  if (storage_ == TableStorage::kColumn) {
+    return GetColumnTuple(row);
+  }
+  if (storage_ == TableStorage::kMemory) {
+    return memory_heap_->GetTuple(row);
+  }
+  if (storage_ == TableStorage::kLsm) {
+    return lsm_heap_->GetTuple(row);
+  }
+  if (storage_ == TableStorage::kCompressed) {
+    return compressed_heap_->GetTuple(row);
+  }
+  if (storage_ == TableStorage::kClustered) {
+    return clustered_heap_->GetTuple(row);
+  }
+  RowId rid = row->GetRowId();
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   if(page == nullptr) return false;
   page->RLatch();
   bool success = page->GetTuple(row, schema_, txn, lock_manager_);
+  RowId target;
+  bool forwarded = !success && page->GetForward(rid, &target);
   page->RUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), success);
+  if (forwarded) {
+    // one hop at most, a moved row always keeps its stub at home
+    page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(target.GetPageId()));
+    if(page == nullptr) return false;
+    page->RLatch();
+    row->SetRowId(target);
+    success = page->GetTuple(row, schema_, txn, lock_manager_);
+    row->SetRowId(rid);
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(target.GetPageId(), false);
+  }
+  if (success) {
+    ResolveOverflows(*row, {});
+  }
+  return success;
+}
+
+bool TableHeap::MarkColumnDelete(const RowId &rid) {
+  auto page = reinterpret_cast<ColumnPage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  if (page == nullptr) {
+    return false;
+  }
+  page->WLatch();
+  bool success = page->MarkDelete(rid, *column_layout_);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), success);
+  return success;
+}
+
+bool TableHeap::UpdateColumnTuple(Row &row, const RowId &rid) {
+  if (!column_layout_->CanStore(row)) {
+    return false;
+  }
+  auto page = reinterpret_cast<ColumnPage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  if (page == nullptr) {
+    return false;
+  }
+  // the cells have a fixed width, an updated row always stays in its slot
+  page->WLatch();
+  bool success = page->UpdateTuple(row, rid, *column_layout_);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), success);
+  if (success) {
+    zone_map_.Widen(rid.GetPageId(), row);
+  }
   return success;
 }
 
+void TableHeap::ApplyColumnDelete(const RowId &rid) {
+  auto page = reinterpret_cast<ColumnPage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  ASSERT(page != nullptr, "page is null!");
+  page->WLatch();
+  page->ApplyDelete(rid, *column_layout_);
+  uint32_t free_bytes = page->GetFreeSpaceRemaining(*column_layout_);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
+  std::scoped_lock<std::mutex> lock(fsm_latch_);
+  UpdateFreeSpace(rid.GetPageId(), free_bytes);
+}
+
+void TableHeap::RollbackColumnDelete(const RowId &rid) {
+  auto page = reinterpret_cast<ColumnPage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  assert(page != nullptr);
+  page->WLatch();
+  page->RollbackDelete(rid, *column_layout_);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
+}
+
+bool TableHeap::GetColumnTuple(Row *row) {
+  page_id_t page_id = row->GetRowId().GetPageId();
+  auto page = reinterpret_cast<ColumnPage *>(buffer_pool_manager_->FetchPage(page_id));
+  if (page == nullptr) {
+    return false;
+  }
+  page->RLatch();
+  bool success = page->GetTuple(row, *column_layout_);
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return success;
+}
+
+bool TableHeap::ExternalizeValues(Row &row) {
+  // a row read from a table may hold only the prefix of a value, and its chain belongs to the tuple it came from
+  ResolveOverflows(row, {});
+  row.GetOverflows().clear();
+  if (storage_ != TableStorage::kRow) {
+    return true;
+  }
+  const uint32_t ref_size = sizeof(uint32_t) + OVERFLOW_PREFIX_SIZE + sizeof(page_id_t);
+  auto &fields = row.GetFields();
+  std::vector<uint32_t> candidates;
+  for (uint32_t i = 0; i < fields.size(); i++) {
+    if (fields[i]->GetTypeId() != TypeId::kTypeChar || fields[i]->IsNull()) {
+      continue;
+    }
+    // a value of an encoded column is stored as its code, which it gets here if it is new
+    Dictionary *dictionary = i < schema_->GetColumnCount() ? schema_->GetColumn(i)->GetDictionary() : nullptr;
+    if (dictionary != nullptr) {
+      int32_t code;
+      if (!dictionary->Encode(*fields[i], code)) {
+        return false;
+      }
+      continue;
+    }
+    if (sizeof(uint32_t) + fields[i]->GetLength() > ref_size) {
+      candidates.push_back(i);
+    }
+  }
+  if (candidates.empty()) {
+    return true;
+  }
+  // the longest values go first, so a wide row needs as few chains as possible
+  std::sort(candidates.begin(), candidates.end(),
+            [&](uint32_t a, uint32_t b) { return fields[a]->GetLength() > fields[b]->GetLength(); });
+  uint32_t max_size = TablePage::GetMaxRowSize(buffer_pool_manager_->GetPageSize());
+  uint32_t size = row.GetSerializedSize(schema_);
+  for (auto i : candidates) {
+    uint32_t length = fields[i]->GetLength();
+    if (length <= OVERFLOW_THRESHOLD && size <= max_size) {
+      break;
+    }
+    page_id_t first_page_id;
+    if (!WriteOverflow(fields[i]->GetData(), length, first_page_id)) {
+      DropOverflows(row);
+      return false;
+    }
+    row.GetOverflows().push_back({i, first_page_id, length, true});
+    size -= sizeof(uint32_t) + length - ref_size;
+  }
+  return true;
+}
+
+void TableHeap::DropOverflows(Row &row) {
+  for (auto &overflow : row.GetOverflows()) {
+    FreeOverflow(overflow.first_page_id_);
+  }
+  row.GetOverflows().clear();
+}
+
+void TableHeap::ResolveOverflows(Row &row, const std::vector<bool> &columns) {
+  for (auto &overflow : row.GetOverflows()) {
+    if (overflow.resolved_ || (!columns.empty() && !columns[overflow.field_index_])) {
+      continue;
+    }
+    std::unique_ptr<char[]> value(new char[overflow.length_]);
+    ReadOverflow(overflow.first_page_id_, overflow.length_, value.get());
+    Field *&field = row.GetFields()[overflow.field_index_];
+    delete field;
+    field = new Field(TypeId::kTypeChar, value.get(), overflow.length_, true);
+    overflow.resolved_ = true;
+  }
+}
+
+bool TableHeap::WriteOverflow(const char *data, uint32_t length, page_id_t &first_page_id) {
+  uint32_t capacity = OverflowPage::GetCapacity(buffer_pool_manager_->GetPageSize());
+  first_page_id = INVALID_PAGE_ID;
+  OverflowPage *prev_page = nullptr;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  for (uint32_t offset = 0; offset < length; offset += capacity) {
+    page_id_t page_id;
+    auto page = static_cast<OverflowPage *>(
+        buffer_pool_manager_->NewPage(page_id, DiskManager::GetTablespaceId(first_page_id_)));
+    if (page == nullptr) {
+      if (prev_page != nullptr) {
+        buffer_pool_manager_->UnpinPage(prev_page_id, true);
+        FreeOverflow(first_page_id);
+      }
+      return false;
+    }
+    page->Init(page_id);
+    page->SetValueData(data + offset, std::min(capacity, length - offset));
+    if (prev_page != nullptr) {
+      prev_page->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(prev_page_id, true);
+    } else {
+      first_page_id = page_id;
+    }
+    prev_page = page;
+    prev_page_id = page_id;
+  }
+  buffer_pool_manager_->UnpinPage(prev_page_id, true);
+  return true;
+}
+
+void TableHeap::ReadOverflow(page_id_t first_page_id, uint32_t length, char *data) {
+  uint32_t offset = 0;
+  page_id_t page_id = first_page_id;
+  while (offset < length) {
+    auto page = static_cast<OverflowPage *>(buffer_pool_manager_->FetchPage(page_id));
+    ASSERT(page != nullptr, "Can not fetch the overflow page.");
+    uint32_t size = page->GetDataSize();
+    ASSERT(offset + size <= length, "Overflow chain is longer than its value.");
+    memcpy(data + offset, page->GetValueData(), size);
+    offset += size;
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+void TableHeap::FreeOverflow(page_id_t first_page_id) {
+  page_id_t page_id = first_page_id;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = static_cast<OverflowPage *>(buffer_pool_manager_->FetchPage(page_id));
+    ASSERT(page != nullptr, "Can not fetch the overflow page.");
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    buffer_pool_manager_->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+}
+
+void TableHeap::GetTupleOverflows(const RowId &rid, std::vector<page_id_t> &first_page_ids) {
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  if (page == nullptr) {
+    return;
+  }
+  page->RLatch();
+  RowId target;
+  bool forwarded = page->GetForward(rid, &target);
+  if (!forwarded) {
+    page->GetOverflows(rid.GetSlotNum(), schema_, first_page_ids);
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
+  if (forwarded) {
+    page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(target.GetPageId()));
+    ASSERT(page != nullptr, "Can not fetch the page of a moved row.");
+    page->RLatch();
+    page->GetOverflows(target.GetSlotNum(), schema_, first_page_ids);
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(target.GetPageId(), false);
+  }
+}
+
+void TableHeap::FreeOverflows(TablePage *page) {
+  if (storage_ == TableStorage::kColumn) {
+    return;
+  }
+  std::vector<page_id_t> first_page_ids;
+  page->RemapOverflows(schema_, [&](page_id_t first_page_id) {
+    first_page_ids.push_back(first_page_id);
+    return first_page_id;
+  });
+  for (auto first_page_id : first_page_ids) {
+    FreeOverflow(first_page_id);
+  }
+}
+
 void TableHeap::DeleteTable(page_id_t page_id) {
-  if (page_id != INVALID_PAGE_ID) {
-    auto temp_table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));  // 删除table_heap
-    if (temp_table_page->GetNextPageId() != INVALID_PAGE_ID)
-      DeleteTable(temp_table_page->GetNextPageId());
+  if (page_id == INVALID_PAGE_ID) {
+    FreeTableHeap();
+    return;
+  }
+  // 沿着链表一页一页删，链再长也不会递归太深
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    ASSERT(page != nullptr, "Can not fetch the table page.");
+    page_id_t next_page_id = page->GetNextPageId();
+    FreeOverflows(page);
     buffer_pool_manager_->UnpinPage(page_id, false);
     buffer_pool_manager_->DeletePage(page_id);
-  } else {
-    DeleteTable(first_page_id_);
+    page_id = next_page_id;
   }
 }
 
-TableIterator TableHeap::Begin(Transaction *txn) {
-  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+page_id_t TableHeap::ReadPage(page_id_t page_id, std::vector<Row> &rows, size_t &row_count, Transaction *txn,
+                              const std::vector<bool> &columns, Schema *schema) {
+  if (storage_ == TableStorage::kMemory) {
+    return memory_heap_->ReadChunk(page_id, rows, row_count);
+  }
+  if (storage_ == TableStorage::kLsm) {
+    return lsm_heap_->ReadPage(page_id, rows, row_count);
+  }
+  if (storage_ == TableStorage::kCompressed) {
+    return compressed_heap_->ReadPage(page_id, rows, row_count);
+  }
+  if (storage_ == TableStorage::kClustered) {
+    return clustered_heap_->ReadPage(page_id, rows, row_count);
+  }
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  ASSERT(page != nullptr, "Can not fetch the table page.");
   page->RLatch();
-  RowId rid;
-  page->GetFirstTupleRid(&rid);
-  Row row(rid);
+  if (storage_ == TableStorage::kColumn) {
+    row_count = ReadLiveRows(reinterpret_cast<ColumnPage *>(page), rows);
+  } else {
+    row_count = ReadLiveRows(page, rows, txn, schema != nullptr ? schema : schema_);
+  }
+  page_id_t next_page_id = page->GetNextPageId();
   page->RUnlatch();
-  buffer_pool_manager_->UnpinPage(first_page_id_, false);
-  return TableIterator(this, row, txn);
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  // the chains never change once written, they are read without holding the page
+  for (size_t i = 0; i < row_count; i++) {
+    if (!rows[i].GetOverflows().empty()) {
+      ResolveOverflows(rows[i], columns);
+    }
+  }
+  return next_page_id;
 }
 
-TableIterator TableHeap::End() {
-  Row row;
-  return TableIterator(this, row, static_cast<Transaction * >(nullptr));
+size_t TableHeap::ReadLiveRows(TablePage *page, std::vector<Row> &rows, Transaction *txn, Schema *schema) {
+  size_t row_count = 0;
+  RowId rid;
+  for (bool found = page->GetFirstTupleRid(&rid); found; found = page->GetNextTupleRid(RowId(rid), &rid)) {
+    if (row_count == rows.size()) {
+      rows.emplace_back();
+    }
+    rows[row_count].SetRowId(rid);
+    if (page->GetTuple(&rows[row_count], schema, txn, lock_manager_)) {
+      row_count++;
+    }
+  }
+  return row_count;
+}
+
+size_t TableHeap::ReadLiveRows(ColumnPage *page, std::vector<Row> &rows) {
+  size_t row_count = 0;
+  RowId rid;
+  for (bool found = page->GetFirstTupleRid(&rid, *column_layout_); found;
+       found = page->GetNextTupleRid(RowId(rid), &rid, *column_layout_)) {
+    if (row_count == rows.size()) {
+      rows.emplace_back();
+    }
+    rows[row_count].SetRowId(rid);
+    if (page->GetTuple(&rows[row_count], *column_layout_)) {
+      row_count++;
+    }
+  }
+  return row_count;
+}
+
+double TableHeap::GetFreeSpaceRatio() {
+  std::scoped_lock<std::mutex> lock(fsm_latch_);
+  if (heap_page_ids_.empty()) {
+    return 0;
+  }
+  uint32_t page_size = buffer_pool_manager_->GetPageSize();
+  uint64_t free_bytes = 0;
+  for (auto category : fsm_categories_) {
+    // the map rounds down, so this is a lower bound
+    free_bytes += static_cast<uint64_t>(category) * (page_size / 256);
+  }
+  return static_cast<double>(free_bytes) / (static_cast<double>(heap_page_ids_.size()) * page_size);
 }
+
+uint32_t TableHeap::Vacuum(std::vector<std::pair<RowId, RowId>> &moved_rids, Transaction *txn) {
+  if (storage_ != TableStorage::kRow) {
+    return 0;
+  }
+  std::scoped_lock<std::mutex> lock(fsm_latch_);
+  // rows move between pages, the ranges are gathered again by the next scan
+  zone_map_.Clear();
+  std::vector<page_id_t> old_page_ids = heap_page_ids_;
+  std::vector<page_id_t> kept_page_ids;
+  std::vector<uint32_t> kept_free_bytes;
+  std::vector<Row> rows;
+  uint32_t freed_pages = 0;
+  // the last page kept that still takes tuples, it stays pinned and latched until the next one replaces it
+  TablePage *target = nullptr;
+  size_t target_index = 0;
+  bool target_dirty = false;
+  auto release_target = [&]() {
+    if (target != nullptr) {
+      kept_free_bytes[target_index] = target->GetFreeSpaceRemaining();
+      target->WUnlatch();
+      buffer_pool_manager_->UnpinPage(target->GetTablePageId(), target_dirty);
+      target = nullptr;
+    }
+  };
+  for (auto page_id : old_page_ids) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    ASSERT(page != nullptr, "Can not fetch the table page.");
+    page->WLatch();
+    // forwarding stubs and moved tuples pin each other's row ids
+    if (page->HasPendingDelete() || page->HasForwarding()) {
+      kept_page_ids.push_back(page_id);
+      kept_free_bytes.push_back(page->GetFreeSpaceRemaining());
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      continue;
+    }
+    size_t row_count = ReadLiveRows(page, rows, txn, schema_);
+    // fill the target from the front of this page
+    size_t moved = 0;
+    while (target != nullptr && moved < row_count) {
+      RowId old_rid = rows[moved].GetRowId();
+      if (!target->InsertTuple(rows[moved], schema_, txn, lock_manager_, log_manager_)) {
+        break;
+      }
+      moved_rids.emplace_back(old_rid, rows[moved].GetRowId());
+      target_dirty = true;
+      moved++;
+    }
+    page_id_t prev_page_id = page->GetPrevPageId();
+    page_id_t next_page_id = page->GetNextPageId();
+    if (moved == row_count && page_id != first_page_id_) {
+      // unlink the empty page, its predecessor is the last page kept
+      if (target != nullptr && target->GetTablePageId() == prev_page_id) {
+        target->SetNextPageId(next_page_id);
+      } else {
+        auto prev_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(prev_page_id));
+        prev_page->WLatch();
+        prev_page->SetNextPageId(next_page_id);
+        prev_page->WUnlatch();
+        buffer_pool_manager_->UnpinPage(prev_page_id, true);
+      }
+      if (next_page_id != INVALID_PAGE_ID) {
+        auto next_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
+        next_page->WLatch();
+        next_page->SetPrevPageId(prev_page_id);
+        next_page->WUnlatch();
+        buffer_pool_manager_->UnpinPage(next_page_id, true);
+      }
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+      freed_pages++;
+      continue;
+    }
+    bool dirty = moved > 0 || !page->IsCompact();
+    if (dirty) {
+      // rebuild the page so that the tuples left take its first slots
+      page->Init(page_id, prev_page_id, log_manager_, txn);
+      page->SetNextPageId(next_page_id);
+      for (size_t i = moved; i < row_count; i++) {
+        RowId old_rid = rows[i].GetRowId();
+        bool __attribute__((unused)) inserted = page->InsertTuple(rows[i], schema_, txn, lock_manager_, log_manager_);
+        ASSERT(inserted, "Tuples of a page must fit into it again.");
+        if (!(rows[i].GetRowId() == old_rid)) {
+          moved_rids.emplace_back(old_rid, rows[i].GetRowId());
+        }
+      }
+    }
+    release_target();
+    kept_page_ids.push_back(page_id);
+    kept_free_bytes.push_back(0);
+    target = page;
+    target_index = kept_page_ids.size() - 1;
+    target_dirty = dirty;
+  }
+  release_target();
+  freed_pages += RewriteFreeSpaceMap(kept_page_ids, kept_free_bytes);
+  return freed_pages;
+}
+
+uint32_t TableHeap::RewriteFreeSpaceMap(const std::vector<page_id_t> &page_ids, const std::vector<uint32_t> &free_bytes) {
+  uint32_t page_size = buffer_pool_manager_->GetPageSize();
+  uint32_t capacity = FreeSpaceMapPage::GetCapacity(page_size);
+  heap_page_ids_ = page_ids;
+  // the target pages may be gone, the threads pick new ones
+  insertion_pages_.clear();
+  claimed_pages_.clear();
+  fsm_slots_.clear();
+  fsm_categories_.clear();
+  pages_by_free_space_.clear();
+  for (uint32_t slot = 0; slot < page_ids.size(); slot++) {
+    fsm_slots_[page_ids[slot]] = slot;
+    fsm_categories_.push_back(FreeSpaceMapPage::ToCategory(free_bytes[slot], page_size));
+    pages_by_free_space_.emplace(fsm_categories_.back(), slot);
+  }
+  // the heap only shrinks, so the map pages at hand are enough and the first one stays where the table meta expects it
+  size_t map_page_count = (page_ids.size() + capacity - 1) / capacity;
+  for (size_t i = 0; i < map_page_count; i++) {
+    auto fsm_page = static_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(fsm_page_ids_[i]));
+    ASSERT(fsm_page != nullptr, "Failed to read the free space map.");
+    fsm_page->Init(fsm_page_ids_[i]);
+    for (size_t slot = i * capacity; slot < std::min<size_t>(page_ids.size(), (i + 1) * capacity); slot++) {
+      fsm_page->Append(page_ids[slot], fsm_categories_[slot]);
+    }
+    fsm_page->SetNextPageId(i + 1 < map_page_count ? fsm_page_ids_[i + 1] : INVALID_PAGE_ID);
+    buffer_pool_manager_->UnpinPage(fsm_page_ids_[i], true);
+  }
+  uint32_t freed_pages = fsm_page_ids_.size() - map_page_count;
+  for (size_t i = map_page_count; i < fsm_page_ids_.size(); i++) {
+    buffer_pool_manager_->DeletePage(fsm_page_ids_[i]);
+  }
+  fsm_page_ids_.resize(map_page_count);
+  return freed_pages;
+}
+
+std::vector<page_id_t> TableHeap::GetPageIds() {
+  if (storage_ == TableStorage::kMemory) {
+    return memory_heap_->GetChunkIds();
+  }
+  if (storage_ == TableStorage::kLsm) {
+    return lsm_heap_->GetPageIds();
+  }
+  if (storage_ == TableStorage::kCompressed) {
+    return compressed_heap_->GetPageIds();
+  }
+  if (storage_ == TableStorage::kClustered) {
+    return clustered_heap_->GetPageIds();
+  }
+  std::scoped_lock<std::mutex> lock(fsm_latch_);
+  return heap_page_ids_;
+}
+
+const ZoneMap &TableHeap::GetZoneMap(Transaction *txn) {
+  uint64_t build = zone_map_.StartBuild();
+  if (build != 0 && storage_ == TableStorage::kCompressed) {
+    // a block knows the bounds of its columns, the ranges are widened to them without decoding the block
+    Row min_row;
+    Row max_row;
+    for (auto page_id : GetPageIds()) {
+      if (compressed_heap_->ReadBounds(page_id, min_row, max_row)) {
+        zone_map_.Widen(page_id, min_row);
+        zone_map_.Widen(page_id, max_row);
+      }
+    }
+    zone_map_.FinishBuild(build);
+  } else if (build != 0) {
+    // the ranges of char values only need their prefix, the overflow chains are not read
+    std::vector<bool> columns(schema_->GetColumnCount(), false);
+    std::vector<Row> rows;
+    size_t row_count;
+    for (auto page_id : GetPageIds()) {
+      ReadPage(page_id, rows, row_count, txn, columns);
+      for (size_t i = 0; i < row_count; i++) {
+        zone_map_.Widen(page_id, rows[i]);
+      }
+    }
+    zone_map_.FinishBuild(build);
+  }
+  return zone_map_;
+}
+
+TableIterator TableHeap::Begin(Transaction *txn, const std::vector<bool> &columns) {
+  page_id_t first_page_id = first_page_id_;
+  if (storage_ == TableStorage::kMemory) {
+    first_page_id = memory_heap_->GetFirstChunkId();
+  } else if (storage_ == TableStorage::kLsm) {
+    first_page_id = lsm_heap_->GetFirstPageId();
+  } else if (storage_ == TableStorage::kClustered) {
+    // the first virtual page, reading it goes on to the first one with rows
+    first_page_id = 0;
+  }
+  return TableIterator(this, first_page_id, txn, columns);
+}
+
+TableIterator TableHeap::End() { return TableIterator(this, INVALID_PAGE_ID, nullptr); }
@@ -3,33 +3,27 @@
 #include "common/macros.h"
 #include "storage/table_heap.h"
 
-/**
- * TODO: Student Implement
- */
-TableIterator::TableIterator() {
+TableIterator::TableIterator() = default;
 
+TableIterator::TableIterator(TableHeap *table_heap, page_id_t page_id, Transaction *txn, std::vector<bool> columns)
+    : table_heap_(table_heap), txn_(txn), columns_(std::move(columns)) {
+  LoadPage(page_id);
 }
 
-TableIterator::TableIterator(TableHeap *table_heap, Row row_, Transaction *txn_) {
-  tableHeap = table_heap;
-  row = row_;
-  txn = txn_;
-  if(row.GetRowId().GetPageId() != INVALID_PAGE_ID)
-    table_heap->GetTuple(&row, txn);
-}
-
-TableIterator::TableIterator(const TableIterator &other) {
-  tableHeap = other.tableHeap;
-  row = other.row;
-  txn = other.txn;
-}
+TableIterator::TableIterator(const TableIterator &other)
+    : table_heap_(other.table_heap_),
+      txn_(other.txn_),
+      columns_(other.columns_),
+      next_page_id_(other.next_page_id_),
+      rows_(other.rows_.begin(), other.rows_.begin() + other.row_count_),
+      row_count_(other.row_count_),
+      pos_(other.pos_) {}
 
-TableIterator::~TableIterator() {
-
-}
+TableIterator::~TableIterator() = default;
 
 bool TableIterator::operator==(const TableIterator &itr) const {
-  return (this->row.GetRowId() == itr.row.GetRowId()) && (this->tableHeap == itr.tableHeap) && (this->txn == itr.txn);
+  // End() carries no transaction, so the transaction must not take part in the comparison
+  return GetRowId() == itr.GetRowId() && table_heap_ == itr.table_heap_;
 }
 
 bool TableIterator::operator!=(const TableIterator &itr) const {
@@ -37,53 +31,49 @@ bool TableIterator::operator!=(const TableIterator &itr) const {
 }
 
 const Row &TableIterator::operator*() {
-  assert(*this != tableHeap->End());
-  return row;
+  ASSERT(pos_ < row_count_, "Dereference the end of a table.");
+  return rows_[pos_];
 }
 
 Row *TableIterator::operator->() {
-  assert(*this != tableHeap->End());
-  return &row;
+  ASSERT(pos_ < row_count_, "Dereference the end of a table.");
+  return &rows_[pos_];
 }
 
-TableIterator &TableIterator::operator=(const TableIterator &itr) noexcept {
-  this->tableHeap = itr.tableHeap;
-  this->row = itr.row;
-  this->txn = itr.txn;
+TableIterator &TableIterator::operator=(const TableIterator &itr) {
+  if (this == &itr) {
+    return *this;
+  }
+  table_heap_ = itr.table_heap_;
+  txn_ = itr.txn_;
+  columns_ = itr.columns_;
+  next_page_id_ = itr.next_page_id_;
+  rows_.assign(itr.rows_.begin(), itr.rows_.begin() + itr.row_count_);
+  row_count_ = itr.row_count_;
+  pos_ = itr.pos_;
+  return *this;
 }
 
 // ++iter
 TableIterator &TableIterator::operator++() {
-  BufferPoolManager *bufferPoolManager = tableHeap->buffer_pool_manager_;
-  auto cur_page = static_cast<TablePage *>(bufferPoolManager->FetchPage(row.GetRowId().GetPageId()));
-  assert(cur_page != nullptr);
-  cur_page->RLatch();
-
-  RowId next_row_id;
-  if(!cur_page->GetNextTupleRid(row.GetRowId(), &next_row_id)){
-    while(cur_page->GetNextPageId() != INVALID_PAGE_ID){
-      auto next_page = static_cast<TablePage *>(bufferPoolManager->FetchPage(cur_page->GetNextPageId()));
-      cur_page->RUnlatch();
-      bufferPoolManager->UnpinPage(cur_page->GetPageId(), false);
-      cur_page = next_page;
-      cur_page->RLatch();
-      if(cur_page->GetFirstTupleRid(&next_row_id)) break;
-    }
-  }
-  row.SetRowId(next_row_id);
-  if(*this != tableHeap->End()){
-    tableHeap->GetTuple(&row, txn);
+  if (pos_ < row_count_ && ++pos_ == row_count_) {
+    LoadPage(next_page_id_);
   }
-  cur_page->RUnlatch();
-  bufferPoolManager->UnpinPage(cur_page->GetPageId(), false);
   return *this;
 }
 
 // iter++
 TableIterator TableIterator::operator++(int) {
-  TableHeap *ret_table_heap = tableHeap;
-  Row ret_row = row;
-  Transaction *ret_txn = txn;
+  TableIterator old(*this);
   ++(*this);
-  return TableIterator(ret_table_heap, ret_row, ret_txn);
+  return old;
+}
+
+void TableIterator::LoadPage(page_id_t page_id) {
+  row_count_ = 0;
+  pos_ = 0;
+  while (page_id != INVALID_PAGE_ID && row_count_ == 0) {
+    page_id = table_heap_->ReadPage(page_id, rows_, row_count_, txn_, columns_);
+  }
+  next_page_id_ = page_id;
 }
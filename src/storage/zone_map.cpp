@@ -0,0 +1,135 @@
+#include "storage/zone_map.h"
+
+#include <algorithm>
+
+ZoneMap::ZoneMap(const Schema *schema) {
+  for (auto column : schema->GetColumns()) {
+    types_.push_back(column->GetType());
+  }
+}
+
+uint64_t ZoneMap::StartBuild() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (state_ != State::kEmpty) {
+    return 0;
+  }
+  state_ = State::kBuilding;
+  return ++build_;
+}
+
+void ZoneMap::FinishBuild(uint64_t build) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (state_ == State::kBuilding && build_ == build) {
+    state_ = State::kComplete;
+  }
+}
+
+void ZoneMap::Clear() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  zones_.clear();
+  state_ = State::kEmpty;
+}
+
+void ZoneMap::Widen(page_id_t page_id, const Row &row) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (state_ == State::kEmpty) {
+    return;
+  }
+  auto &zones = zones_[page_id];
+  zones.resize(types_.size());
+  for (uint32_t i = 0; i < row.GetFieldCount() && i < types_.size(); i++) {
+    const Field *field = row.GetField(i);
+    if (field->IsNull()) {
+      continue;
+    }
+    Zone &zone = zones[i];
+    // ints and floats serialize to their 4 bytes as they are
+    char buf[sizeof(int32_t)];
+    switch (types_[i]) {
+      case TypeId::kTypeInt: {
+        field->SerializeTo(buf);
+        int32_t value;
+        memcpy(&value, buf, sizeof(value));
+        zone.int_min_ = zone.empty_ ? value : std::min(zone.int_min_, value);
+        zone.int_max_ = zone.empty_ ? value : std::max(zone.int_max_, value);
+        break;
+      }
+      case TypeId::kTypeFloat: {
+        field->SerializeTo(buf);
+        float value;
+        memcpy(&value, buf, sizeof(value));
+        zone.float_min_ = zone.empty_ ? value : std::min(zone.float_min_, value);
+        zone.float_max_ = zone.empty_ ? value : std::max(zone.float_max_, value);
+        break;
+      }
+      case TypeId::kTypeChar: {
+        std::string value(field->GetData(), std::min(field->GetLength(), PREFIX_SIZE));
+        if (zone.empty_ || value < zone.char_min_) {
+          zone.char_min_ = value;
+        }
+        if (zone.empty_ || value > zone.char_max_) {
+          zone.char_max_ = value;
+        }
+        break;
+      }
+      default:
+        continue;
+    }
+    zone.empty_ = false;
+  }
+}
+
+bool ZoneMap::MayMatch(page_id_t page_id, uint32_t column_index, CompareOp op, const Field &constant) const {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (state_ != State::kComplete || column_index >= types_.size() || constant.IsNull() ||
+      constant.GetTypeId() != types_[column_index]) {
+    return true;
+  }
+  auto iter = zones_.find(page_id);
+  // no row was ever written to the page, or none with a value in the column
+  if (iter == zones_.end() || iter->second[column_index].empty_) {
+    return false;
+  }
+  const Zone &zone = iter->second[column_index];
+  char buf[sizeof(int32_t)];
+  switch (types_[column_index]) {
+    case TypeId::kTypeInt: {
+      constant.SerializeTo(buf);
+      int32_t value;
+      memcpy(&value, buf, sizeof(value));
+      return MayMatchRange(zone.int_min_, zone.int_max_, op, value, false);
+    }
+    case TypeId::kTypeFloat: {
+      constant.SerializeTo(buf);
+      float value;
+      memcpy(&value, buf, sizeof(value));
+      return MayMatchRange(zone.float_min_, zone.float_max_, op, value, false);
+    }
+    case TypeId::kTypeChar: {
+      std::string value(constant.GetData(), std::min(constant.GetLength(), PREFIX_SIZE));
+      return MayMatchRange(zone.char_min_, zone.char_max_, op, value, true);
+    }
+    default:
+      return true;
+  }
+}
+
+template <typename T>
+bool ZoneMap::MayMatchRange(const T &min, const T &max, CompareOp op, const T &constant, bool prefix) {
+  // values cut to a prefix may tie with the constant where the whole values do not, so only ties are certain then
+  switch (op) {
+    case CompareOp::kEqual:
+      return min <= constant && constant <= max;
+    case CompareOp::kNotEqual:
+      return prefix || !(min == max && min == constant);
+    case CompareOp::kLessThan:
+      return prefix ? min <= constant : min < constant;
+    case CompareOp::kLessThanEquals:
+      return min <= constant;
+    case CompareOp::kGreaterThan:
+      return prefix ? max >= constant : max > constant;
+    case CompareOp::kGreaterThanEquals:
+      return max >= constant;
+  }
+  return true;
+}
@@ -0,0 +1,242 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/execute_engine.h"
+#include "gtest/gtest.h"
+#include "utils/sql_test_util.h"
+
+static const std::string add_column_db_file = "add_column_test.db";
+
+static Schema *MakeAddColumnSchema() {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("body", TypeId::kTypeChar, 10000, 1, true, false)};
+  return new Schema(columns);
+}
+
+static Row MakeAddColumnRow(int id) {
+  // every tenth value is too long for the tuple and goes to an overflow chain
+  std::string body(id % 10 == 0 ? 6000 : 20, static_cast<char>('a' + id % 26));
+  std::vector<Field> fields{Field(TypeId::kTypeInt, id),
+                            Field(TypeId::kTypeChar, const_cast<char *>(body.data()), body.size(), true)};
+  return Row(fields);
+}
+
+static Column *MakeFloatColumn(const std::string &name, float value) {
+  auto column = new Column(name, TypeId::kTypeFloat, 0, true, false);
+  Field default_value(TypeId::kTypeFloat, value);
+  column->SetDefault(&default_value);
+  return column;
+}
+
+/**
+ * Check every row of the heap: the fields it was written with and the added columns, which read their default.
+ */
+static void CheckAddedColumns(TableHeap *table_heap, uint32_t column_count, int row_nums) {
+  int count = 0;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+    const Row &row = *iter;
+    ASSERT_EQ(column_count, row.GetFieldCount());
+    int id = ReadInt(row.GetField(0));
+    std::string body(row.GetField(1)->GetData(), row.GetField(1)->GetLength());
+    ASSERT_EQ(id % 10 == 0 ? 6000 : 20, body.size());
+    ASSERT_EQ(static_cast<char>('a' + id % 26), body[0]);
+    if (column_count > 2) {
+      ASSERT_EQ(CmpBool::kTrue, row.GetField(2)->CompareEquals(Field(TypeId::kTypeFloat, 1.5f)));
+    }
+    if (column_count > 3) {
+      ASSERT_TRUE(row.GetField(3)->IsNull());
+    }
+    count++;
+  }
+  ASSERT_EQ(row_nums, count);
+}
+
+TEST(AddColumnTest, ColumnSerializeTest) {
+  Column plain("a", TypeId::kTypeInt, 0, false, false);
+  std::unique_ptr<Column> added(MakeFloatColumn("b", 2.5f));
+  std::vector<Column *> columns = {new Column(&plain)};
+  Schema schema(columns);
+  schema.AddColumn(added.release());
+  ASSERT_EQ(1, schema.GetVersion());
+  ASSERT_EQ(1, schema.GetColumn(1)->GetTableInd());
+  // a column of the first version is written the way it always was
+  ASSERT_EQ(Column(&plain).GetSerializedSize(), schema.GetColumn(0)->GetSerializedSize());
+  ASSERT_LT(schema.GetColumn(0)->GetSerializedSize(), schema.GetColumn(1)->GetSerializedSize());
+  std::vector<char> buf(schema.GetSerializedSize());
+  ASSERT_EQ(buf.size(), schema.SerializeTo(buf.data()));
+  Schema *copy = nullptr;
+  ASSERT_EQ(buf.size(), Schema::DeserializeFrom(buf.data(), copy));
+  ASSERT_EQ(2, copy->GetColumnCount());
+  ASSERT_EQ(0, copy->GetColumn(0)->GetVersion());
+  ASSERT_EQ(nullptr, copy->GetColumn(0)->GetDefault());
+  ASSERT_EQ(1, copy->GetColumn(1)->GetVersion());
+  ASSERT_EQ(CmpBool::kTrue, copy->GetColumn(1)->GetDefault()->CompareEquals(Field(TypeId::kTypeFloat, 2.5f)));
+  delete copy;
+
+  // a row written before the column was added reads its default
+  std::vector<Field> fields{Field(TypeId::kTypeInt, 7)};
+  Row row(fields);
+  std::vector<char> row_buf(row.GetSerializedSize(&schema));
+  row.SerializeTo(row_buf.data(), &schema);
+  Row read;
+  read.DeserializeFrom(row_buf.data(), &schema);
+  ASSERT_EQ(2, read.GetFieldCount());
+  ASSERT_EQ(CmpBool::kTrue, read.GetField(1)->CompareEquals(Field(TypeId::kTypeFloat, 2.5f)));
+  Row raw;
+  raw.DeserializeFrom(row_buf.data(), &schema, false);
+  ASSERT_EQ(1, raw.GetFieldCount());
+}
+
+TEST(AddColumnTest, AddColumnTest) {
+  const int row_nums = 1000;
+  remove(add_column_db_file.c_str());
+  {
+    DBStorageEngine engine(add_column_db_file, true);
+    CatalogManager *catalog = engine.catalog_mgr_;
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("t", MakeAddColumnSchema(), nullptr, table_info));
+    TableHeap *table_heap = table_info->GetTableHeap();
+    std::vector<RowId> rids;
+    for (int i = 0; i < row_nums; i++) {
+      Row row = MakeAddColumnRow(i);
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+      rids.push_back(row.GetRowId());
+    }
+    uint32_t pages = engine.disk_mgr_->GetAllocatedPages(DEFAULT_TABLESPACE_ID);
+    ASSERT_EQ(DB_SUCCESS, catalog->AddColumn("t", MakeFloatColumn("score", 1.5f)));
+    // no row is touched
+    ASSERT_EQ(pages, engine.disk_mgr_->GetAllocatedPages(DEFAULT_TABLESPACE_ID));
+    ASSERT_EQ(3, table_info->GetSchema()->GetColumnCount());
+    ASSERT_EQ(1, table_info->GetSchema()->GetVersion());
+    CheckAddedColumns(table_heap, 3, row_nums);
+    ASSERT_EQ(DB_FAILED, catalog->AddColumn("t", MakeFloatColumn("score", 2.0f)));
+    ASSERT_EQ(DB_FAILED, catalog->AddColumn("t", new Column("body", TypeId::kTypeInt, 0, true, false)));
+    ASSERT_EQ(DB_TABLE_NOT_EXIST, catalog->AddColumn("missing", MakeFloatColumn("score", 1.5f)));
+    ASSERT_EQ(DB_SUCCESS, catalog->AddColumn("t", new Column("tag", TypeId::kTypeChar, 8, 0, true, false)));
+    ASSERT_EQ(2, table_info->GetSchema()->GetVersion());
+    CheckAddedColumns(table_heap, 4, row_nums);
+
+    // new rows carry every column, an old row that is updated takes them on
+    std::string body(20, 'a' + (row_nums + 1) % 26);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, row_nums + 1),
+                              Field(TypeId::kTypeChar, const_cast<char *>(body.data()), body.size(), true),
+                              Field(TypeId::kTypeFloat, 1.5f), Field(TypeId::kTypeChar)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    Row old_row(rids[10]);
+    ASSERT_TRUE(table_heap->GetTuple(&old_row, nullptr));
+    Row updated(old_row);
+    ASSERT_TRUE(table_heap->UpdateTuple(updated, rids[10], nullptr));
+    CheckAddedColumns(table_heap, 4, row_nums + 1);
+
+    // tables that do not read their rows through the schema keep their columns
+    TableInfo *other = nullptr;
+    std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+    ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("c", new Schema(columns), nullptr, other, DEFAULT_TABLESPACE_ID,
+                                               TableStorage::kColumn));
+    ASSERT_EQ(DB_FAILED, catalog->AddColumn("c", MakeFloatColumn("score", 1.5f)));
+    columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+    ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("m", new Schema(columns), nullptr, other, DEFAULT_TABLESPACE_ID,
+                                               TableStorage::kMemory, true));
+    ASSERT_EQ(DB_FAILED, catalog->AddColumn("m", MakeFloatColumn("score", 1.5f)));
+
+    // the vacuum moves the overflow chains of old and new tuples alike
+    VacuumStats stats;
+    ASSERT_EQ(DB_SUCCESS, engine.VacuumDatabase(stats));
+    catalog = engine.catalog_mgr_;
+    ASSERT_EQ(DB_SUCCESS, catalog->GetTable("t", table_info));
+    CheckAddedColumns(table_info->GetTableHeap(), 4, row_nums + 1);
+
+    // every partition gets the column
+    auto scheme = new PartitionScheme(PartitionKind::kHash, 0, TypeId::kTypeInt);
+    scheme->AddPartition("p0", 0);
+    scheme->AddPartition("p1", 0);
+    ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("p", MakeAddColumnSchema(), nullptr, other, DEFAULT_TABLESPACE_ID,
+                                               TableStorage::kRow, false, scheme));
+    ASSERT_EQ(DB_SUCCESS, catalog->AddColumn("p", MakeFloatColumn("score", 1.5f)));
+    for (auto partition : other->GetPartitions()) {
+      ASSERT_EQ(3, partition->GetSchema()->GetColumnCount());
+    }
+  }
+  {
+    DBStorageEngine engine(add_column_db_file, false);
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("t", table_info));
+    ASSERT_EQ(2, table_info->GetSchema()->GetVersion());
+    CheckAddedColumns(table_info->GetTableHeap(), 4, row_nums + 1);
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("p#p1", table_info));
+    ASSERT_EQ(1, table_info->GetSchema()->GetVersion());
+  }
+  remove(add_column_db_file.c_str());
+}
+
+TEST(AddColumnTest, LsmAddColumnTest) {
+  const int row_nums = 2000;
+  remove(add_column_db_file.c_str());
+  {
+    DBStorageEngine engine(add_column_db_file, true);
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable("l", MakeAddColumnSchema(), nullptr, table_info,
+                                                           DEFAULT_TABLESPACE_ID, TableStorage::kLsm));
+    for (int i = 0; i < row_nums; i++) {
+      Row row = MakeAddColumnRow(i * 10 + 1);
+      ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+    }
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->AddColumn("l", MakeFloatColumn("score", 1.5f)));
+    CheckAddedColumns(table_info->GetTableHeap(), 3, row_nums);
+  }
+  {
+    DBStorageEngine engine(add_column_db_file, false);
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("l", table_info));
+    CheckAddedColumns(table_info->GetTableHeap(), 3, row_nums);
+  }
+  remove(add_column_db_file.c_str());
+}
+
+TEST(AddColumnTest, AddColumnStatementTest) {
+  ExecuteEngine engine;
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create database add_column_statement;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "use add_column_statement;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table t(id int, name char(16), primary key(id));"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into t values(1, \"one\");"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "alter table t add column c int default 5;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "alter table t add column d char(8) default \"dd\";"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "alter table t add column e float;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into t values(2, \"two\", 6, \"x\", 2.5);"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "select * from t where c = 5;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "update t set c = 7 where id = 1;"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "alter table t add column c int;"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "alter table t add column f int default \"x\";"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "alter table t add column f char(2) default \"long\";"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "alter table t add column f int unique;"));
+  ASSERT_EQ(DB_TABLE_NOT_EXIST, RunSql(engine, "alter table missing add column f int;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "drop table t;"));
+  RunSql(engine, "drop database add_column_statement;");
+}
+
+// adding a column writes the table meta page once, however many rows the table has
+TEST(AddColumnTest, AddColumnBenchmarkTest) {
+  const int row_nums = 200000;
+  DBStorageEngine engine("add_column_bench.db", true);
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable("t", MakeAddColumnSchema(), nullptr, table_info));
+  for (int i = 0; i < row_nums; i++) {
+    Row row = MakeAddColumnRow(i * 10 + 1);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+  }
+  uint32_t pages = engine.disk_mgr_->GetAllocatedPages(DEFAULT_TABLESPACE_ID);
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->AddColumn("t", MakeFloatColumn("score", 1.5f)));
+  auto added = std::chrono::steady_clock::now();
+  ASSERT_EQ(pages, engine.disk_mgr_->GetAllocatedPages(DEFAULT_TABLESPACE_ID));
+  CheckAddedColumns(table_info->GetTableHeap(), 3, row_nums);
+  auto scanned = std::chrono::steady_clock::now();
+  double add_ms = std::chrono::duration<double, std::milli>(added - start).count();
+  double scan_ms = std::chrono::duration<double, std::milli>(scanned - added).count();
+  std::cout << "add column: " << add_ms << " ms, scan of " << row_nums << " rows: " << scan_ms << " ms" << std::endl;
+  remove("add_column_bench.db");
+}
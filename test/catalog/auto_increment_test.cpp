@@ -0,0 +1,262 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catalog/auto_increment.h"
+#include "common/instance.h"
+#include "executor/execute_engine.h"
+#include "gtest/gtest.h"
+#include "utils/sql_test_util.h"
+
+static const std::string auto_increment_db_file = "auto_increment_test.db";
+
+static Schema *MakeAutoIncrementSchema() {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, true, false),
+                                   new Column("name", TypeId::kTypeChar, 16, 1, true, false)};
+  return new Schema(columns);
+}
+
+/** Insert a row whose id is filled in by the allocator of the table */
+static int32_t InsertAutoRow(TableInfo *table_info) {
+  std::string name = "row";
+  std::vector<Field> fields{Field(TypeId::kTypeInt),
+                            Field(TypeId::kTypeChar, const_cast<char *>(name.data()), name.size(), true)};
+  Row row(fields);
+  EXPECT_TRUE(table_info->GetAutoIncrement()->Fill(row));
+  EXPECT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+  return ReadInt(row.GetField(0));
+}
+
+static std::vector<int32_t> ReadIds(TableInfo *table_info) {
+  std::vector<int32_t> ids;
+  for (auto iter = table_info->GetTableHeap()->Begin(nullptr); iter != table_info->GetTableHeap()->End(); ++iter) {
+    ids.push_back(ReadInt(iter->GetField(0)));
+  }
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+TEST(AutoIncrementTest, AllocatorTest) {
+  std::vector<int32_t> limits;
+  AutoIncrement auto_increment(0, 1, [&limits](int32_t limit) {
+    limits.push_back(limit);
+    return true;
+  });
+  for (int32_t i = 1; i <= 2500; i++) {
+    int32_t value;
+    ASSERT_TRUE(auto_increment.Next(value));
+    ASSERT_EQ(i, value);
+  }
+  // a block is reserved each AUTO_INCREMENT_CACHE_SIZE values, not each value
+  ASSERT_EQ((std::vector<int32_t>{1 + AUTO_INCREMENT_CACHE_SIZE, 1 + 2 * AUTO_INCREMENT_CACHE_SIZE,
+                                  1 + 3 * AUTO_INCREMENT_CACHE_SIZE}),
+            limits);
+
+  // an explicit value is kept and the counter moves past it, a smaller one leaves the counter alone
+  std::vector<Field> fields{Field(TypeId::kTypeInt, 5000)};
+  Row row(fields);
+  ASSERT_TRUE(auto_increment.Fill(row));
+  ASSERT_EQ(5000, ReadInt(row.GetField(0)));
+  ASSERT_EQ(5000 + AUTO_INCREMENT_CACHE_SIZE, auto_increment.GetLimit());
+  std::vector<Field> small_fields{Field(TypeId::kTypeInt, 7)};
+  Row small(small_fields);
+  ASSERT_TRUE(auto_increment.Fill(small));
+  std::vector<Field> null_fields{Field(TypeId::kTypeInt)};
+  Row filled(null_fields);
+  ASSERT_TRUE(auto_increment.Fill(filled));
+  ASSERT_EQ(5001, ReadInt(filled.GetField(0)));
+
+  // the values run out at the largest int, and nothing is handed out if the limit cannot be written
+  AutoIncrement last(0, INT32_MAX, [](int32_t) { return true; });
+  int32_t value;
+  ASSERT_FALSE(last.Next(value));
+  // the last block is cut short at the largest int instead of failing
+  AutoIncrement near_last(0, INT32_MAX - 10, [](int32_t limit) { return limit == INT32_MAX; });
+  for (int32_t i = INT32_MAX - 10; i < INT32_MAX; i++) {
+    ASSERT_TRUE(near_last.Next(value));
+    ASSERT_EQ(i, value);
+  }
+  ASSERT_EQ(INT32_MAX, near_last.GetLimit());
+  ASSERT_FALSE(near_last.Next(value));
+  AutoIncrement failing(0, 1, [](int32_t) { return false; });
+  ASSERT_FALSE(failing.Next(value));
+}
+
+TEST(AutoIncrementTest, RestartTest) {
+  const int row_nums = 1500;
+  remove(auto_increment_db_file.c_str());
+  {
+    DBStorageEngine engine(auto_increment_db_file, true);
+    CatalogManager *catalog = engine.catalog_mgr_;
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("t", MakeAutoIncrementSchema(), nullptr, table_info));
+    ASSERT_EQ(DB_SUCCESS, catalog->SetAutoIncrement("t", "id"));
+    ASSERT_EQ(DB_FAILED, catalog->SetAutoIncrement("t", "id"));
+    ASSERT_EQ(DB_COLUMN_NAME_NOT_EXIST, catalog->SetAutoIncrement("t", "missing"));
+    for (int i = 1; i <= row_nums; i++) {
+      ASSERT_EQ(i, InsertAutoRow(table_info));
+    }
+
+    // a table with rows starts above the largest value it has
+    TableInfo *other = nullptr;
+    ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("u", MakeAutoIncrementSchema(), nullptr, other));
+    std::string name = "explicit";
+    std::vector<Field> fields{Field(TypeId::kTypeInt, 41),
+                              Field(TypeId::kTypeChar, const_cast<char *>(name.data()), name.size(), true)};
+    Row row(fields);
+    ASSERT_TRUE(other->GetTableHeap()->InsertTuple(row, nullptr));
+    ASSERT_EQ(DB_FAILED, catalog->SetAutoIncrement("u", "name"));
+    ASSERT_EQ(DB_SUCCESS, catalog->SetAutoIncrement("u", "id"));
+    ASSERT_EQ(42, InsertAutoRow(other));
+
+    // a partitioned table cannot have one
+    auto scheme = new PartitionScheme(PartitionKind::kHash, 0, TypeId::kTypeInt);
+    scheme->AddPartition("p0", 0);
+    ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("p", MakeAutoIncrementSchema(), nullptr, other, DEFAULT_TABLESPACE_ID,
+                                               TableStorage::kRow, false, scheme));
+    ASSERT_EQ(DB_FAILED, catalog->SetAutoIncrement("p", "id"));
+  }
+  {
+    // the values reserved but not handed out before the restart are skipped, none is handed out twice
+    DBStorageEngine engine(auto_increment_db_file, false);
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("t", table_info));
+    ASSERT_NE(nullptr, table_info->GetAutoIncrement());
+    int32_t next = InsertAutoRow(table_info);
+    ASSERT_EQ(1 + 2 * AUTO_INCREMENT_CACHE_SIZE, next);
+    std::vector<int32_t> ids = ReadIds(table_info);
+    ASSERT_EQ(row_nums + 1, ids.size());
+    ASSERT_EQ(ids.end(), std::adjacent_find(ids.begin(), ids.end()));
+
+    // the vacuum reloads the catalog and keeps the counter
+    VacuumStats stats;
+    ASSERT_EQ(DB_SUCCESS, engine.VacuumDatabase(stats));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("t", table_info));
+    ASSERT_LT(next, InsertAutoRow(table_info));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("u", table_info));
+    ASSERT_LT(42, InsertAutoRow(table_info));
+  }
+  remove(auto_increment_db_file.c_str());
+}
+
+TEST(AutoIncrementTest, ConcurrentTest) {
+  const int thread_nums = 8;
+  const int value_nums = 20000;
+  remove(auto_increment_db_file.c_str());
+  DBStorageEngine engine(auto_increment_db_file, true);
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable("t", MakeAutoIncrementSchema(), nullptr, table_info));
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->SetAutoIncrement("t", "id"));
+  AutoIncrement *auto_increment = table_info->GetAutoIncrement();
+  std::vector<std::vector<int32_t>> values(thread_nums);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_nums; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < value_nums; i++) {
+        int32_t value;
+        if (auto_increment->Next(value)) {
+          values[t].push_back(value);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::vector<int32_t> all;
+  for (auto &thread_values : values) {
+    ASSERT_EQ(value_nums, thread_values.size());
+    // every thread sees its values in increasing order
+    ASSERT_TRUE(std::is_sorted(thread_values.begin(), thread_values.end()));
+    all.insert(all.end(), thread_values.begin(), thread_values.end());
+  }
+  std::sort(all.begin(), all.end());
+  ASSERT_EQ(all.end(), std::adjacent_find(all.begin(), all.end()));
+  ASSERT_EQ(1, all.front());
+  ASSERT_EQ(thread_nums * value_nums, all.back());
+  ASSERT_EQ(1 + thread_nums * value_nums, table_info->GetTableMetadata()->GetAutoIncrementLimit());
+  remove(auto_increment_db_file.c_str());
+}
+
+TEST(AutoIncrementTest, AutoIncrementStatementTest) {
+  const std::string csv_file = "auto_increment_test.csv";
+  FILE *csv = fopen(csv_file.c_str(), "w");
+  for (int i = 0; i < 100; i++) {
+    fprintf(csv, ",name%d\n", i);
+  }
+  fclose(csv);
+  {
+    ExecuteEngine engine;
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create database auto_increment_statement;"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "use auto_increment_statement;"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table t(id int auto_increment, name char(16), primary key(id));"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into t values(null, \"a\");"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into t values(10, \"b\");"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into t values(null, \"c\");"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "copy t from \"" + csv_file + "\";"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table s(id int auto_increment, name char(16));"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into s select * from t;"));
+    ASSERT_EQ(DB_FAILED, RunSql(engine, "create table f(id float auto_increment);"));
+    ASSERT_EQ(DB_FAILED, RunSql(engine, "create table d(a int auto_increment, b int auto_increment);"));
+    ASSERT_EQ(DB_FAILED, RunSql(engine, "create table p(id int auto_increment) partition by hash(id) partitions 2;"));
+  }
+  {
+    DBStorageEngine engine("auto_increment_statement", false);
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("t", table_info));
+    std::vector<int32_t> ids = ReadIds(table_info);
+    ASSERT_EQ(103, ids.size());
+    ASSERT_EQ(1, ids[0]);
+    ASSERT_EQ(10, ids[1]);
+    ASSERT_EQ(11, ids[2]);
+    ASSERT_EQ(111, ids.back());
+    // the ids selected from t move the counter of s past them
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("s", table_info));
+    ASSERT_EQ(ids, ReadIds(table_info));
+    ASSERT_LT(111, InsertAutoRow(table_info));
+    TableInfo *missing = nullptr;
+    ASSERT_EQ(DB_TABLE_NOT_EXIST, engine.catalog_mgr_->GetTable("p", missing));
+  }
+  DiskManager::RemoveDatabaseFiles("./databases/auto_increment_statement");
+  remove(csv_file.c_str());
+}
+
+// inserters take their ids from the counter in memory instead of reading the largest id of the table first
+TEST(AutoIncrementTest, AutoIncrementBenchmarkTest) {
+  const int row_nums = 3000;
+  remove(auto_increment_db_file.c_str());
+  DBStorageEngine engine(auto_increment_db_file, true);
+  TableInfo *scanned = nullptr;
+  TableInfo *counted = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable("scanned", MakeAutoIncrementSchema(), nullptr, scanned));
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable("counted", MakeAutoIncrementSchema(), nullptr, counted));
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->SetAutoIncrement("counted", "id"));
+  std::string name = "row";
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < row_nums; i++) {
+    // select max(id), then insert max + 1
+    int32_t max_id = 0;
+    for (auto iter = scanned->GetTableHeap()->Begin(nullptr); iter != scanned->GetTableHeap()->End(); ++iter) {
+      max_id = std::max(max_id, ReadInt(iter->GetField(0)));
+    }
+    std::vector<Field> fields{Field(TypeId::kTypeInt, max_id + 1),
+                              Field(TypeId::kTypeChar, const_cast<char *>(name.data()), name.size(), true)};
+    Row row(fields);
+    ASSERT_TRUE(scanned->GetTableHeap()->InsertTuple(row, nullptr));
+  }
+  auto middle = std::chrono::steady_clock::now();
+  for (int i = 0; i < row_nums; i++) {
+    InsertAutoRow(counted);
+  }
+  auto end = std::chrono::steady_clock::now();
+  ASSERT_EQ(ReadIds(scanned), ReadIds(counted));
+  double scan_ms = std::chrono::duration<double, std::milli>(middle - start).count();
+  double counter_ms = std::chrono::duration<double, std::milli>(end - middle).count();
+  std::cout << "select max(id): " << scan_ms << " ms, auto_increment: " << counter_ms << " ms for " << row_nums
+            << " rows" << std::endl;
+  remove(auto_increment_db_file.c_str());
+}
@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/execute_engine.h"
+#include "executor/plans/index_scan_plan.h"
+#include "gtest/gtest.h"
+#include "planner/planner.h"
+#include "utils/sql_test_util.h"
+
+static const std::string cluster_db_file = "cluster_table_test.db";
+
+static Row MakeClusterRow(int id, int r) {
+  char name[65];
+  snprintf(name, sizeof(name), "%064d", id);
+  std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeInt, r),
+                            Field(TypeId::kTypeChar, name, 64, true)};
+  return Row(fields);
+}
+
+/**
+ * Create table t with an index on id and one on r, and insert the rows in a shuffled order of id. The values of r are
+ * another shuffle, so neither index follows the heap.
+ */
+static TableInfo *CreateAndFillShuffled(DBStorageEngine &engine, int row_nums) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, true),
+                                   new Column("r", TypeId::kTypeInt, 1, false, true),
+                                   new Column("name", TypeId::kTypeChar, 64, 2, false, false)};
+  TableInfo *table_info = nullptr;
+  IndexInfo *id_index = nullptr, *r_index = nullptr;
+  EXPECT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable("t", new Schema(columns), nullptr, table_info));
+  EXPECT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateIndex("t", "primary", {"id"}, nullptr, id_index, "bptree"));
+  EXPECT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateIndex("t", "r_index", {"r"}, nullptr, r_index, "bptree"));
+  std::vector<int> ids = ShuffledIds(row_nums, 49);
+  std::vector<int> rs = ShuffledIds(row_nums, 50);
+  for (int i = 0; i < row_nums; i++) {
+    Row row = MakeClusterRow(ids[i], rs[i]);
+    EXPECT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+    EXPECT_EQ(DB_SUCCESS, id_index->GetIndex()->InsertEntry(MakeIntKey(ids[i]), row.GetRowId(), nullptr));
+    EXPECT_EQ(DB_SUCCESS, r_index->GetIndex()->InsertEntry(MakeIntKey(rs[i]), row.GetRowId(), nullptr));
+  }
+  return table_info;
+}
+
+/** @return the number of rows in t, after checking that both indexes find each of them */
+static int CountAndCheck(DBStorageEngine &engine) {
+  TableInfo *table_info = nullptr;
+  IndexInfo *id_index = nullptr, *r_index = nullptr;
+  EXPECT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("t", table_info));
+  EXPECT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("t", "primary", id_index));
+  EXPECT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("t", "r_index", r_index));
+  int count = 0;
+  for (auto iter = table_info->GetTableHeap()->Begin(nullptr); iter != table_info->GetTableHeap()->End(); ++iter) {
+    std::vector<RowId> result;
+    EXPECT_EQ(DB_SUCCESS, id_index->GetIndex()->ScanKey(MakeIntKey(ReadInt(iter->GetField(0))), result, nullptr));
+    EXPECT_EQ(std::vector<RowId>{iter->GetRowId()}, result);
+    result.clear();
+    EXPECT_EQ(DB_SUCCESS, r_index->GetIndex()->ScanKey(MakeIntKey(ReadInt(iter->GetField(1))), result, nullptr));
+    EXPECT_EQ(std::vector<RowId>{iter->GetRowId()}, result);
+    count++;
+  }
+  return count;
+}
+
+/** @return the ids of the rows of t in heap order */
+static std::vector<int> ReadIds(TableInfo *table_info) {
+  std::vector<int> ids;
+  for (auto iter = table_info->GetTableHeap()->Begin(nullptr); iter != table_info->GetTableHeap()->End(); ++iter) {
+    ids.push_back(ReadInt(iter->GetField(0)));
+  }
+  return ids;
+}
+
+/**
+ * @return how many times the rows of a range scan of the index switch to another heap page, each one a fetch of the
+ * page that misses the buffer pool unless the page is still in it
+ */
+static uint32_t CountPageFetches(Index *index, int bound, std::vector<RowId> *rids = nullptr) {
+  std::vector<RowId> result;
+  EXPECT_EQ(DB_SUCCESS, index->ScanKey(MakeIntKey(bound), result, nullptr, "<"));
+  uint32_t fetches = 0;
+  page_id_t last_page_id = INVALID_PAGE_ID;
+  for (auto &rid : result) {
+    if (rid.GetPageId() != last_page_id) {
+      fetches++;
+      last_page_id = rid.GetPageId();
+    }
+  }
+  if (rids != nullptr) {
+    *rids = std::move(result);
+  }
+  return fetches;
+}
+
+/**
+ * Plan a select and run it.
+ * @param[out] heap_order whether the plan is an index scan that reads the rows in heap order
+ */
+static std::vector<Row> RunClusterQuery(DBStorageEngine &engine, const std::string &sql, PlanType &type,
+                                        bool &heap_order) {
+  return WithSyntaxTree(sql, [&](pSyntaxNode ast) {
+    EXPECT_NE(nullptr, ast) << sql;
+    ExecuteEngine executor;
+    ExecuteContext context(nullptr, engine.catalog_mgr_, engine.bpm_);
+    Planner planner(&context);
+    planner.PlanQuery(ast);
+    type = planner.plan_->GetType();
+    heap_order =
+        type == PlanType::IndexScan && static_cast<const IndexScanPlanNode *>(planner.plan_.get())->heap_order_;
+    std::vector<Row> result_set;
+    EXPECT_EQ(DB_SUCCESS, executor.ExecutePlan(planner.plan_, &result_set, nullptr, &context)) << sql;
+    return result_set;
+  });
+}
+
+TEST(ClusterTableTest, ClusterTableTest) {
+  const int row_nums = 10000;
+  {
+    DBStorageEngine engine(cluster_db_file, true);
+    TableInfo *table_info = CreateAndFillShuffled(engine, row_nums);
+    IndexInfo *id_index = nullptr, *r_index = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("t", "primary", id_index));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("t", "r_index", r_index));
+    ASSERT_FALSE(id_index->GetIndexMetadata()->HasCorrelation());
+    uint32_t fetches_before = CountPageFetches(id_index->GetIndex(), row_nums / 10);
+    ASSERT_EQ(DB_INDEX_NOT_FOUND, engine.catalog_mgr_->ClusterTable("t", "missing", nullptr));
+    ASSERT_EQ(DB_TABLE_NOT_EXIST, engine.catalog_mgr_->ClusterTable("missing", "primary", nullptr));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->ClusterTable("t", "primary", nullptr));
+    // the heap holds the rows in key order now, the indexes point to their new row ids
+    std::vector<int> ids = ReadIds(table_info);
+    ASSERT_EQ(IdRange(0, row_nums), ids);
+    ASSERT_EQ(row_nums, CountAndCheck(engine));
+    ASSERT_TRUE(id_index->GetIndexMetadata()->HasCorrelation());
+    ASSERT_NEAR(1.0, id_index->GetIndexMetadata()->GetCorrelation(), 1e-9);
+    ASSERT_LT(std::fabs(r_index->GetIndexMetadata()->GetCorrelation()), 0.1);
+    // a range of keys lies on a run of neighbouring pages
+    std::vector<RowId> rids;
+    uint32_t fetches_after = CountPageFetches(id_index->GetIndex(), row_nums / 10, &rids);
+    ASSERT_LT(fetches_after * 10, fetches_before);
+    ASSERT_TRUE(std::is_sorted(rids.begin(), rids.end(),
+                               [](const RowId &a, const RowId &b) { return a.Get() < b.Get(); }));
+    // clustering on the other index reverses the roles
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->ClusterTable("t", "r_index", nullptr));
+    ASSERT_EQ(row_nums, CountAndCheck(engine));
+    ASSERT_NEAR(1.0, r_index->GetIndexMetadata()->GetCorrelation(), 1e-9);
+    ASSERT_LT(std::fabs(id_index->GetIndexMetadata()->GetCorrelation()), 0.1);
+    // rows inserted afterwards go behind the clustered ones
+    Row row = MakeClusterRow(row_nums, row_nums);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+    ASSERT_EQ(DB_SUCCESS, id_index->GetIndex()->InsertEntry(MakeIntKey(row_nums), row.GetRowId(), nullptr));
+    ASSERT_EQ(DB_SUCCESS, r_index->GetIndex()->InsertEntry(MakeIntKey(row_nums), row.GetRowId(), nullptr));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->ClusterTable("t", "primary", nullptr));
+  }
+  // the table meta names the new heap, the index meta keeps the correlation
+  DBStorageEngine engine(cluster_db_file, false);
+  ASSERT_EQ(row_nums + 1, CountAndCheck(engine));
+  TableInfo *table_info = nullptr;
+  IndexInfo *id_index = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("t", table_info));
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("t", "primary", id_index));
+  std::vector<int> ids = ReadIds(table_info);
+  ASSERT_TRUE(std::is_sorted(ids.begin(), ids.end()));
+  ASSERT_NEAR(1.0, id_index->GetIndexMetadata()->GetCorrelation(), 1e-9);
+  VacuumStats stats;
+  ASSERT_EQ(DB_SUCCESS, engine.VacuumDatabase(stats));
+  ASSERT_EQ(row_nums + 1, CountAndCheck(engine));
+}
+
+TEST(ClusterTableTest, PlannerCorrelationTest) {
+  const int row_nums = 2000;
+  DBStorageEngine engine("cluster_planner_test.db", true);
+  CreateAndFillShuffled(engine, row_nums);
+  PlanType type;
+  bool heap_order;
+  // without a correlation an index scan keeps the order of the keys
+  std::vector<Row> rows = RunClusterQuery(engine, "select * from t where r < 100;", type, heap_order);
+  ASSERT_EQ(PlanType::IndexScan, type);
+  ASSERT_FALSE(heap_order);
+  ASSERT_EQ(100, rows.size());
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->ClusterTable("t", "primary", nullptr));
+  // the clustered index reads in key order, which is heap order, the other one reads the heap page by page
+  rows = RunClusterQuery(engine, "select * from t where id < 100;", type, heap_order);
+  ASSERT_EQ(PlanType::IndexScan, type);
+  ASSERT_FALSE(heap_order);
+  ASSERT_EQ(100, rows.size());
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(i, ReadInt(rows[i].GetField(0)));
+  }
+  rows = RunClusterQuery(engine, "select * from t where r < 100;", type, heap_order);
+  ASSERT_EQ(PlanType::IndexScan, type);
+  ASSERT_TRUE(heap_order);
+  ASSERT_EQ(100, rows.size());
+  for (size_t i = 1; i < rows.size(); i++) {
+    ASSERT_LT(rows[i - 1].GetRowId().Get(), rows[i].GetRowId().Get());
+    ASSERT_LT(ReadInt(rows[i - 1].GetField(0)), ReadInt(rows[i].GetField(0)));
+  }
+}
+
+TEST(ClusterTableTest, ClusterStatementTest) {
+  ExecuteEngine engine;
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create database cluster_statement;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "use cluster_statement;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table t(id int, name char(16), primary key(id));"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create index id_index on t(id);"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into t values(3, \"c\");"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into t values(1, \"a\");"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into t values(2, \"b\");"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "cluster t using id_index;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "cluster table t using id_index;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "select * from t where id > 1;"));
+  ASSERT_EQ(DB_INDEX_NOT_FOUND, RunSql(engine, "cluster t using missing;"));
+  ASSERT_EQ(DB_TABLE_NOT_EXIST, RunSql(engine, "cluster missing using id_index;"));
+  // a table in memory has no pages to lay out
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table m(id int, primary key(id)) engine = memory;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create index m_index on m(id);"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "cluster m using m_index;"));
+  RunSql(engine, "drop database cluster_statement;");
+}
+
+// a range scan through an index reads each heap page once after clustering, instead of once for nearly every row
+TEST(ClusterTableTest, RangeScanBenchmarkTest) {
+  const int row_nums = 100000;
+  // a buffer pool far smaller than the table, so that a page fetched again is read from disk again
+  DBStorageEngine engine("cluster_bench.db", true, 64);
+  TableInfo *table_info = CreateAndFillShuffled(engine, row_nums);
+  IndexInfo *id_index = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("t", "primary", id_index));
+  uint32_t heap_pages = table_info->GetTableHeap()->GetPageCount();
+  auto scan = [&](uint32_t &fetches) {
+    std::vector<RowId> rids;
+    fetches = CountPageFetches(id_index->GetIndex(), row_nums / 10, &rids);
+    auto start = std::chrono::steady_clock::now();
+    for (auto &rid : rids) {
+      Row row(rid);
+      EXPECT_TRUE(table_info->GetTableHeap()->GetTuple(&row, nullptr));
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+  };
+  uint32_t fetches_before, fetches_after;
+  double before_ms = scan(fetches_before);
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->ClusterTable("t", "primary", nullptr));
+  double after_ms = scan(fetches_after);
+  std::cout << "range scan of " << row_nums / 10 << " rows in a heap of " << heap_pages << " pages: "
+            << fetches_before << " page fetches in " << before_ms << " ms before cluster, " << fetches_after
+            << " page fetches in " << after_ms << " ms after" << std::endl;
+  ASSERT_LT(fetches_after * 20, fetches_before);
+  ASSERT_LE(fetches_after, heap_pages / 10 + 2);
+}
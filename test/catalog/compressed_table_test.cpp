@@ -0,0 +1,286 @@
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/execute_engine.h"
+#include "gtest/gtest.h"
+#include "storage/compressed_block.h"
+#include "utils/sql_test_util.h"
+
+static const std::string compressed_table_db_file = "compressed_table_test.db";
+
+static Schema *MakeSeriesSchema() {
+  std::vector<Column *> columns = {new Column("ts", TypeId::kTypeInt, 0, false, true),
+                                   new Column("value", TypeId::kTypeFloat, 1, true, false),
+                                   new Column("tag", TypeId::kTypeChar, 8, 2, true, false)};
+  return new Schema(columns);
+}
+
+/**
+ * A reading every second, with some jitter, nulls and a few jumps of the timestamp as large as an int allows.
+ */
+static int SeriesTimestamp(int i) {
+  if (i == 300) {
+    return INT_MIN;
+  }
+  if (i == 301) {
+    return INT_MAX;
+  }
+  return 1600000000 + i * 1000 + (i % 50 == 0 ? 3 : 0) - (i % 70 == 0 ? 200 : 0);
+}
+
+static Row MakeSeriesRow(int i) {
+  std::vector<Field> fields;
+  fields.emplace_back(TypeId::kTypeInt, SeriesTimestamp(i));
+  if (i % 7 == 3) {
+    fields.emplace_back(TypeId::kTypeFloat);
+  } else {
+    fields.emplace_back(TypeId::kTypeFloat, 20.0f + static_cast<float>(i % 10) * 0.5f);
+  }
+  if (i % 11 == 5) {
+    fields.emplace_back(TypeId::kTypeChar, nullptr, 0, false);
+  } else {
+    std::string tag = "s" + std::to_string(i % 3);
+    fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(tag.c_str()), tag.size(), true);
+  }
+  return Row(fields);
+}
+
+static bool SameRow(const Row &expected, const Row &actual) {
+  if (expected.GetFieldCount() != actual.GetFieldCount()) {
+    return false;
+  }
+  for (uint32_t i = 0; i < expected.GetFieldCount(); i++) {
+    const Field *a = expected.GetField(i);
+    const Field *b = actual.GetField(i);
+    if (a->IsNull() != b->IsNull() || (!a->IsNull() && a->CompareEquals(*b) != CmpBool::kTrue)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+TEST(CompressedTableTest, CompressedBlockTest) {
+  std::unique_ptr<Schema> schema(MakeSeriesSchema());
+  const uint32_t capacity = CompressedBlockPage::GetCapacity(PAGE_SIZE);
+  CompressedBlock block(schema.get());
+  std::vector<Row> rows;
+  while (true) {
+    Row row = MakeSeriesRow(rows.size());
+    if (!block.Append(row, capacity)) {
+      break;
+    }
+    rows.push_back(row);
+    ASSERT_LE(block.GetSerializedSize(), capacity);
+  }
+  // past the jumps, so every code of the delta of delta is in the block
+  ASSERT_GT(rows.size(), 400);
+  ASSERT_EQ(rows.size(), block.GetRowCount());
+  std::vector<char> image(block.GetSerializedSize());
+  block.SerializeTo(image.data());
+  std::vector<Row> decoded;
+  ASSERT_EQ(rows.size(), CompressedBlock::Decode(image.data(), schema.get(), 7, decoded));
+  for (size_t i = 0; i < rows.size(); i++) {
+    ASSERT_TRUE(SameRow(rows[i], decoded[i])) << "row " << i;
+    ASSERT_EQ(RowId(7, i), decoded[i].GetRowId());
+  }
+  // the bounds come from the header, char ones from their stream
+  Row min_row;
+  Row max_row;
+  CompressedBlock::ReadBounds(image.data(), schema.get(), min_row, max_row);
+  ASSERT_EQ(std::to_string(INT_MIN), min_row.GetField(0)->toString());
+  ASSERT_EQ(std::to_string(INT_MAX), max_row.GetField(0)->toString());
+  ASSERT_EQ(CmpBool::kTrue, min_row.GetField(1)->CompareEquals(Field(TypeId::kTypeFloat, 20.0f)));
+  ASSERT_EQ(CmpBool::kTrue, max_row.GetField(1)->CompareEquals(Field(TypeId::kTypeFloat, 24.5f)));
+  ASSERT_EQ("s0", min_row.GetField(2)->toString());
+  ASSERT_EQ("s2", max_row.GetField(2)->toString());
+  // deleted rows are skipped unless asked for
+  CompressedBlock::SetDeleted(image.data(), schema.get(), 0);
+  CompressedBlock::SetDeleted(image.data(), schema.get(), 42);
+  ASSERT_TRUE(CompressedBlock::IsDeleted(image.data(), schema.get(), 42));
+  ASSERT_FALSE(CompressedBlock::IsDeleted(image.data(), schema.get(), 43));
+  ASSERT_EQ(rows.size() - 2, CompressedBlock::Decode(image.data(), schema.get(), 7, decoded));
+  ASSERT_TRUE(SameRow(rows[1], decoded[0]));
+  ASSERT_TRUE(SameRow(rows[43], decoded[41]));
+  // a loaded block writes the same image and goes on where it stopped
+  CompressedBlock loaded(schema.get());
+  loaded.Load(image.data(), image.size());
+  std::vector<char> reloaded(loaded.GetSerializedSize());
+  loaded.SerializeTo(reloaded.data());
+  ASSERT_EQ(image, reloaded);
+  ASSERT_FALSE(loaded.Append(MakeSeriesRow(rows.size()), capacity));
+  ASSERT_TRUE(loaded.Append(MakeSeriesRow(rows.size()), capacity + 64));
+}
+
+TEST(CompressedTableTest, CompressedHeapTest) {
+  const int row_nums = 20000;
+  RowId deleted_rid;
+  uint32_t block_count;
+  {
+    DBStorageEngine engine(compressed_table_db_file, true);
+    TableInfo *table_info = nullptr;
+    IndexInfo *index_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable("s", MakeSeriesSchema(), nullptr, table_info,
+                                                           DEFAULT_TABLESPACE_ID, TableStorage::kCompressed));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateIndex("s", "ts_index", {"ts"}, nullptr, index_info, "bptree"));
+    TableHeap *table_heap = table_info->GetTableHeap();
+    ASSERT_EQ(TableStorage::kCompressed, table_heap->GetStorage());
+    ASSERT_EQ(INVALID_PAGE_ID, table_heap->GetFreeSpaceMapPageId());
+    for (int i = 0; i < row_nums; i++) {
+      Row row = MakeSeriesRow(i);
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+      ASSERT_EQ(DB_SUCCESS,
+                index_info->GetIndex()->InsertEntry(MakeIntKey(SeriesTimestamp(i)), row.GetRowId(), nullptr));
+    }
+    block_count = table_heap->GetPageCount();
+    ASSERT_GT(block_count, 1);
+    // a scan decodes the rows in insert order
+    int i = 0;
+    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter, i++) {
+      ASSERT_TRUE(SameRow(MakeSeriesRow(i), *iter)) << "row " << i;
+    }
+    ASSERT_EQ(row_nums, i);
+    std::vector<RowId> result;
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(MakeIntKey(SeriesTimestamp(12345)), result, nullptr));
+    Row row(result[0]);
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    ASSERT_TRUE(SameRow(MakeSeriesRow(12345), row));
+    // the zone map of the blocks comes from their headers
+    const ZoneMap &zone_map = table_heap->GetZoneMap(nullptr);
+    std::vector<page_id_t> page_ids = table_heap->GetPageIds();
+    Field late(TypeId::kTypeInt, SeriesTimestamp(row_nums - 1));
+    ASSERT_FALSE(zone_map.MayMatch(page_ids[1], 0, CompareOp::kEqual, late));
+    ASSERT_TRUE(zone_map.MayMatch(page_ids.back(), 0, CompareOp::kEqual, late));
+    // rows are never rewritten, deletes set a bit
+    Row updated = MakeSeriesRow(0);
+    ASSERT_FALSE(table_heap->UpdateTuple(updated, row.GetRowId(), nullptr));
+    ASSERT_TRUE(table_heap->MarkDelete(row.GetRowId(), nullptr));
+    ASSERT_FALSE(table_heap->GetTuple(&row, nullptr));
+    ASSERT_EQ(row_nums - 1, CountRows(table_heap));
+    table_heap->RollbackDelete(row.GetRowId(), nullptr);
+    ASSERT_EQ(row_nums, CountRows(table_heap));
+    ASSERT_TRUE(table_heap->MarkDelete(row.GetRowId(), nullptr));
+    table_heap->ApplyDelete(row.GetRowId(), nullptr);
+    ASSERT_EQ(DB_SUCCESS,
+              index_info->GetIndex()->RemoveEntry(MakeIntKey(SeriesTimestamp(12345)), row.GetRowId(), nullptr));
+    ASSERT_EQ(row_nums - 1, CountRows(table_heap));
+    deleted_rid = row.GetRowId();
+    // the last row goes into the open block, which is undone by a delete as well
+    Row last = MakeSeriesRow(row_nums);
+    ASSERT_TRUE(table_heap->InsertTuple(last, nullptr));
+    ASSERT_EQ(page_ids.back(), last.GetRowId().GetPageId());
+    table_heap->ApplyDelete(last.GetRowId(), nullptr);
+    ASSERT_EQ(row_nums - 1, CountRows(table_heap));
+    // a second table is emptied at once
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable("t", MakeSeriesSchema(), nullptr, table_info,
+                                                           DEFAULT_TABLESPACE_ID, TableStorage::kCompressed));
+    Row other = MakeSeriesRow(1);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(other, nullptr));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->TruncateTable("t", nullptr));
+  }
+  // the open block is loaded again and takes the next rows
+  {
+    DBStorageEngine engine(compressed_table_db_file, false);
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("s", table_info));
+    TableHeap *table_heap = table_info->GetTableHeap();
+    ASSERT_EQ(TableStorage::kCompressed, table_heap->GetStorage());
+    ASSERT_EQ(row_nums - 1, CountRows(table_heap));
+    Row row(deleted_rid);
+    ASSERT_FALSE(table_heap->GetTuple(&row, nullptr));
+    for (int i = row_nums + 1; i < row_nums + 100; i++) {
+      Row appended = MakeSeriesRow(i);
+      ASSERT_TRUE(table_heap->InsertTuple(appended, nullptr));
+    }
+    ASSERT_EQ(row_nums + 98, CountRows(table_heap));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("t", table_info));
+    ASSERT_EQ(0, CountRows(table_info->GetTableHeap()));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->DropTable("t"));
+    VacuumStats stats;
+    ASSERT_EQ(DB_SUCCESS, engine.VacuumDatabase(stats));
+  }
+  // the blocks are still found after the pages were moved
+  DBStorageEngine engine(compressed_table_db_file, false);
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("s", table_info));
+  ASSERT_EQ(row_nums + 98, CountRows(table_info->GetTableHeap()));
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("s", "ts_index", index_info));
+  std::vector<RowId> result;
+  ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(MakeIntKey(SeriesTimestamp(777)), result, nullptr));
+  Row row(result[0]);
+  ASSERT_TRUE(table_info->GetTableHeap()->GetTuple(&row, nullptr));
+  ASSERT_TRUE(SameRow(MakeSeriesRow(777), row));
+}
+
+TEST(CompressedTableTest, CompressedTableStatementTest) {
+  ExecuteEngine engine;
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create database compressed_statement;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "use compressed_statement;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table r(ts int, v float, primary key(ts)) storage = compressed;"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "create table x(ts int) storage = zipped;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into r values(1000, 20.5);"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into r values(2000, 21.0);"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into r values(3000, 21.0);"));
+  RunSql(engine, "insert into r values(3000, 22.0);");
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "select * from r where ts = 2000;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "select * from r where v > 20.7;"));
+  RunSql(engine, "update r set v = 0.0 where ts = 1000;");
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "delete from r where ts = 1000;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "select * from r;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "truncate table r;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "drop table r;"));
+  RunSql(engine, "drop database compressed_statement;");
+}
+
+// a reading every second from a slowly drifting sensor, stored by row and in compressed blocks
+TEST(CompressedTableTest, CompressedTableBenchmarkTest) {
+  const int row_nums = 200000;
+  std::vector<Row> rows;
+  rows.reserve(row_nums);
+  std::mt19937 random(23);
+  std::uniform_int_distribution<int> step(-1, 1);
+  int reading = 2150;
+  for (int i = 0; i < row_nums; i++) {
+    // a tenth of the readings arrive late or early
+    int jitter = i % 10 == 0 ? step(random) * 20 : 0;
+    reading += i % 4 == 0 ? step(random) : 0;
+    std::vector<Field> fields{Field(TypeId::kTypeInt, 1600000000 + i * 1000 + jitter),
+                              Field(TypeId::kTypeFloat, static_cast<float>(reading) / 100)};
+    rows.emplace_back(fields);
+  }
+  DBStorageEngine engine("compressed_bench.db", true);
+  std::vector<double> bytes_per_row;
+  std::vector<double> scan_ms;
+  for (auto storage : {TableStorage::kRow, TableStorage::kCompressed}) {
+    std::string name = storage == TableStorage::kRow ? "row" : "compressed";
+    std::vector<Column *> columns = {new Column("ts", TypeId::kTypeInt, 0, false, false),
+                                     new Column("value", TypeId::kTypeFloat, 1, false, false)};
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable(name, new Schema(columns), nullptr, table_info,
+                                                           DEFAULT_TABLESPACE_ID, storage));
+    TableHeap *table_heap = table_info->GetTableHeap();
+    std::vector<Row> batch(rows);
+    ASSERT_TRUE(table_heap->BulkInsertTuples(batch, nullptr));
+    bytes_per_row.push_back(static_cast<double>(table_heap->GetPageCount()) * PAGE_SIZE / row_nums);
+    double sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    int count = 0;
+    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter, count++) {
+      char buf[sizeof(float)];
+      iter->GetField(1)->SerializeTo(buf);
+      sum += MACH_READ_FROM(float, buf);
+    }
+    auto end = std::chrono::steady_clock::now();
+    ASSERT_EQ(row_nums, count);
+    scan_ms.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    std::cout << name << " table: " << table_heap->GetPageCount() << " pages, " << bytes_per_row.back()
+              << " bytes/row, scan of " << row_nums << " rows in " << scan_ms.back() << " ms, "
+              << row_nums / scan_ms.back() << " rows/ms, average " << sum / row_nums << std::endl;
+  }
+  ASSERT_LT(bytes_per_row[1] * 4, bytes_per_row[0]);
+}
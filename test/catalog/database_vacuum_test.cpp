@@ -0,0 +1,107 @@
+#include "catalog/database_vacuum.h"
+
+#include <cstdio>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+
+static const std::string vacuum_db_file = "vacuum_test.db";
+
+static Row MakeVacuumRow(int id) {
+  char name[65];
+  snprintf(name, sizeof(name), "%064d", id);
+  std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, name, 64, true)};
+  return Row(fields);
+}
+
+static int CountRows(TableInfo *table_info) {
+  int count = 0;
+  for (auto iter = table_info->GetTableHeap()->Begin(nullptr); iter != table_info->GetTableHeap()->End(); ++iter) {
+    count++;
+  }
+  return count;
+}
+
+static void CheckIndex(TableInfo *table_info, IndexInfo *index_info, int row_nums) {
+  for (int i = 0; i < row_nums; i += 97) {
+    std::vector<Field> key_fields{Field(TypeId::kTypeInt, i)};
+    std::vector<RowId> result;
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(Row(key_fields), result, nullptr));
+    ASSERT_EQ(1, result.size());
+    Row row(result[0]);
+    ASSERT_TRUE(table_info->GetTableHeap()->GetTuple(&row, nullptr));
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, i)));
+  }
+}
+
+TEST(DatabaseVacuumTest, VacuumTest) {
+  const int row_nums = 3000;
+  Transaction txn;
+  {
+    DBStorageEngine engine(vacuum_db_file, true);
+    uint32_t space_id;
+    ASSERT_EQ(DB_SUCCESS, engine.disk_mgr_->CreateTablespace("ts1", "", space_id));
+    std::vector<std::string> table_names{"kept", "dropped", "spaced"};
+    std::vector<TableInfo *> tables;
+    for (auto &table_name : table_names) {
+      std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, true),
+                                       new Column("name", TypeId::kTypeChar, 64, 1, false, false)};
+      TableInfo *table_info = nullptr;
+      ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable(table_name, new Schema(columns), &txn, table_info,
+                                                             table_name == "spaced" ? space_id : 0));
+      tables.push_back(table_info);
+    }
+    // interleaved inserts scatter the pages of every table over the file
+    for (int i = 0; i < row_nums; i++) {
+      for (auto table_info : tables) {
+        Row row = MakeVacuumRow(i);
+        ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+      }
+    }
+    IndexInfo *index_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateIndex("kept", "kept_id", {"id"}, &txn, index_info, "bptree"));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateIndex("spaced", "spaced_id", {"id"}, &txn, index_info, "bptree",
+                                                           space_id));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->DropTable("dropped"));
+
+    VacuumStats stats;
+    ASSERT_EQ(DB_SUCCESS, engine.VacuumDatabase(stats));
+    ASSERT_GT(stats.moved_pages_, 0);
+    ASSERT_LT(stats.bytes_after_, stats.bytes_before_);
+    ASSERT_EQ(stats.bytes_after_, engine.disk_mgr_->GetFileSize());
+    ASSERT_LT(stats.heap_locality_before_, stats.heap_locality_after_);
+    ASSERT_DOUBLE_EQ(1.0, stats.heap_locality_after_);
+    std::cout << "vacuum: " << stats.moved_pages_ << " of " << stats.live_pages_ << " pages moved, "
+              << stats.bytes_before_ << " -> " << stats.bytes_after_ << " bytes, sequential heap pages "
+              << stats.heap_locality_before_ * 100 << "% -> " << stats.heap_locality_after_ * 100 << "%" << std::endl;
+
+    // a second run finds nothing left to do
+    VacuumStats again;
+    ASSERT_EQ(DB_SUCCESS, engine.VacuumDatabase(again));
+    ASSERT_EQ(0, again.moved_pages_);
+    ASSERT_EQ(0, again.released_pages_);
+    ASSERT_EQ(stats.bytes_after_, again.bytes_after_);
+
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_TABLE_NOT_EXIST, engine.catalog_mgr_->GetTable("dropped", table_info));
+    for (std::string table_name : {"kept", "spaced"}) {
+      ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable(table_name, table_info));
+      ASSERT_EQ(row_nums, CountRows(table_info));
+      ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex(table_name, table_name + "_id", index_info));
+      CheckIndex(table_info, index_info, row_nums);
+    }
+    // the compacted files keep working
+    Row row = MakeVacuumRow(row_nums);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+  }
+  DBStorageEngine engine(vacuum_db_file, false);
+  TableInfo *table_info = nullptr;
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("kept", table_info));
+  ASSERT_EQ(row_nums, CountRows(table_info));
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("kept", "kept_id", index_info));
+  CheckIndex(table_info, index_info, row_nums);
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("spaced", table_info));
+  ASSERT_EQ(row_nums + 1, CountRows(table_info));
+}
@@ -0,0 +1,276 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/execute_engine.h"
+#include "executor/executors/seq_scan_executor.h"
+#include "gtest/gtest.h"
+#include "record/dictionary.h"
+#include "utils/sql_test_util.h"
+
+static const std::string dictionary_db_file = "dictionary_encoding_test.db";
+
+static Schema *MakeCitySchema(uint32_t city_length = 32) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, true, false),
+                                   new Column("city", TypeId::kTypeChar, city_length, 1, true, false)};
+  return new Schema(columns);
+}
+
+static std::string CityOf(int i, int city_nums) { return "city" + std::to_string(i % city_nums); }
+
+static Field MakeCharField(const std::string &value) {
+  return Field(TypeId::kTypeChar, const_cast<char *>(value.data()), value.size(), true);
+}
+
+static void InsertCities(TableInfo *table_info, int begin, int end, int city_nums) {
+  for (int i = begin; i < end; i++) {
+    std::string city = CityOf(i, city_nums);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), MakeCharField(city)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+  }
+}
+
+/** @return the number of rows of the table whose city is the given one */
+static int CountCity(TableInfo *table_info, const std::string &city) {
+  int count = 0;
+  for (auto iter = table_info->GetTableHeap()->Begin(nullptr); iter != table_info->GetTableHeap()->End(); ++iter) {
+    Field *field = iter->GetField(1);
+    EXPECT_EQ(TypeId::kTypeChar, field->GetTypeId());
+    if (!field->IsNull() && std::string(field->GetData(), field->GetLength()) == city) {
+      count++;
+    }
+  }
+  return count;
+}
+
+static size_t ScanIndex(IndexInfo *index_info, const std::string &city, const std::string &op) {
+  std::vector<Field> fields{MakeCharField(city)};
+  Row key(fields);
+  std::vector<RowId> result;
+  index_info->GetIndex()->ScanKey(key, result, nullptr, op);
+  return result.size();
+}
+
+TEST(DictionaryEncodingTest, DictionaryTest) {
+  std::vector<std::string> written;
+  bool writable = true;
+  Dictionary dictionary([&](const std::string &value) {
+    if (writable) {
+      written.push_back(value);
+    }
+    return writable;
+  });
+  dictionary.Load({"b", "d"});
+  int32_t code;
+  ASSERT_TRUE(dictionary.Lookup(MakeCharField("d"), code));
+  ASSERT_EQ(1, code);
+  ASSERT_FALSE(dictionary.Lookup(MakeCharField("a"), code));
+  // a new value gets the next code and is written before it is handed out
+  ASSERT_TRUE(dictionary.Encode(MakeCharField("a"), code));
+  ASSERT_EQ(2, code);
+  ASSERT_TRUE(dictionary.Encode(MakeCharField("b"), code));
+  ASSERT_EQ(0, code);
+  ASSERT_EQ(std::vector<std::string>{"a"}, written);
+  ASSERT_EQ(3, dictionary.GetSize());
+  std::unique_ptr<Field> value(dictionary.Decode(2));
+  ASSERT_EQ("a", std::string(value->GetData(), value->GetLength()));
+  // the next larger value, whatever its code
+  std::unique_ptr<Field> ceiling(dictionary.FindCeiling(MakeCharField("c")));
+  ASSERT_NE(nullptr, ceiling);
+  ASSERT_EQ("d", std::string(ceiling->GetData(), ceiling->GetLength()));
+  ASSERT_EQ(nullptr, dictionary.FindCeiling(MakeCharField("e")));
+  // a value that could not be written gets no code
+  writable = false;
+  ASSERT_FALSE(dictionary.Encode(MakeCharField("e"), code));
+  ASSERT_EQ(3, dictionary.GetSize());
+}
+
+TEST(DictionaryEncodingTest, EncodedTableTest) {
+  const int row_nums = 3000;
+  const int city_nums = 5;
+  remove(dictionary_db_file.c_str());
+  {
+    DBStorageEngine engine(dictionary_db_file, true);
+    CatalogManager *catalog = engine.catalog_mgr_;
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("t", MakeCitySchema(), nullptr, table_info));
+    ASSERT_EQ(DB_FAILED, catalog->SetDictionary("t", "id"));
+    ASSERT_EQ(DB_COLUMN_NAME_NOT_EXIST, catalog->SetDictionary("t", "country"));
+    ASSERT_EQ(DB_SUCCESS, catalog->SetDictionary("t", "city"));
+    ASSERT_EQ(DB_FAILED, catalog->SetDictionary("t", "city"));
+    InsertCities(table_info, 0, row_nums, city_nums);
+    // a null city reads back as null
+    std::vector<Field> fields{Field(TypeId::kTypeInt, row_nums), Field(TypeId::kTypeChar)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+    Row null_row(row.GetRowId());
+    ASSERT_TRUE(table_info->GetTableHeap()->GetTuple(&null_row, nullptr));
+    ASSERT_TRUE(null_row.GetField(1)->IsNull());
+
+    ASSERT_EQ(city_nums, table_info->GetSchema()->GetColumn(1)->GetDictionary()->GetSize());
+    ASSERT_EQ(row_nums / city_nums, CountCity(table_info, "city3"));
+
+    // index keys hold the codes but keep the order of the values
+    TableInfo *unique = nullptr;
+    ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("v", MakeCitySchema(), nullptr, unique));
+    ASSERT_EQ(DB_SUCCESS, catalog->SetDictionary("v", "city"));
+    InsertCities(unique, 0, 10, 10);
+    IndexInfo *index_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, catalog->CreateIndex("v", "idx_city", {"city"}, nullptr, index_info, "bptree"));
+    ASSERT_EQ(1, ScanIndex(index_info, "city3", "="));
+    ASSERT_EQ(7, ScanIndex(index_info, "city3", ">="));
+    ASSERT_EQ(3, ScanIndex(index_info, "city3", "<"));
+    // values the dictionary does not know: nothing is equal, ranges start at the next larger value
+    ASSERT_EQ(0, ScanIndex(index_info, "city35", "="));
+    ASSERT_EQ(10, ScanIndex(index_info, "city35", "<>"));
+    ASSERT_EQ(6, ScanIndex(index_info, "city35", ">"));
+    ASSERT_EQ(4, ScanIndex(index_info, "city35", "<="));
+    ASSERT_EQ(10, ScanIndex(index_info, "city99", "<"));
+    ASSERT_EQ(0, ScanIndex(index_info, "city99", ">="));
+    // a key of several columns has no ceiling to start at, the ranges compare the keys of the entries
+    IndexInfo *pair_index = nullptr;
+    ASSERT_EQ(DB_SUCCESS, catalog->CreateIndex("v", "idx_city_id", {"city", "id"}, nullptr, pair_index, "bptree"));
+    std::vector<Field> pair_fields{MakeCharField("city35"), Field(TypeId::kTypeInt, 0)};
+    Row pair_key(pair_fields);
+    for (auto [op, matches] : std::vector<std::pair<std::string, size_t>>{
+             {"=", 0}, {"<>", 10}, {">", 6}, {">=", 6}, {"<", 4}, {"<=", 4}}) {
+      std::vector<RowId> result;
+      pair_index->GetIndex()->ScanKey(pair_key, result, nullptr, op);
+      ASSERT_EQ(matches, result.size()) << op;
+    }
+
+    // a table with rows cannot be encoded any more
+    TableInfo *filled = nullptr;
+    ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("u", MakeCitySchema(), nullptr, filled));
+    InsertCities(filled, 0, 1, city_nums);
+    ASSERT_EQ(DB_FAILED, catalog->SetDictionary("u", "city"));
+  }
+  {
+    // the dictionary is read back from its pages and keeps growing behind them
+    DBStorageEngine engine(dictionary_db_file, false);
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("t", table_info));
+    ASSERT_TRUE(table_info->GetSchema()->GetColumn(1)->IsDictionaryEncoded());
+    ASSERT_EQ(row_nums / city_nums, CountCity(table_info, "city4"));
+    // enough new values to spill the dictionary over several pages
+    InsertCities(table_info, row_nums, row_nums + 1000, 1000);
+    ASSERT_EQ(1000, table_info->GetSchema()->GetColumn(1)->GetDictionary()->GetSize());
+
+    VacuumStats stats;
+    ASSERT_EQ(DB_SUCCESS, engine.VacuumDatabase(stats));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("t", table_info));
+    ASSERT_EQ(row_nums / city_nums + 1, CountCity(table_info, "city4"));
+    ASSERT_EQ(1, CountCity(table_info, "city999"));
+  }
+  {
+    DBStorageEngine engine(dictionary_db_file, false);
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("t", table_info));
+    ASSERT_EQ(1000, table_info->GetSchema()->GetColumn(1)->GetDictionary()->GetSize());
+    ASSERT_EQ(1, CountCity(table_info, "city999"));
+    IndexInfo *index_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("v", "idx_city", index_info));
+    ASSERT_EQ(1, ScanIndex(index_info, "city4", "="));
+    ASSERT_EQ(5, ScanIndex(index_info, "city45", ">="));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->DropTable("t"));
+  }
+  remove(dictionary_db_file.c_str());
+}
+
+TEST(DictionaryEncodingTest, DictionaryStatementTest) {
+  {
+    ExecuteEngine engine;
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create database dictionary_statement;"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "use dictionary_statement;"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table t(id int, city char(32) dictionary, primary key(id));"));
+    for (int i = 0; i < 20; i++) {
+      ASSERT_EQ(DB_SUCCESS,
+                RunSql(engine, "insert into t values(" + std::to_string(i) + ", \"" + CityOf(i, 4) + "\");"));
+    }
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "select * from t where city = \"city1\";"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "update t set city = \"city7\" where city = \"city2\";"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "delete from t where city <> \"city7\" and id > 15;"));
+    ASSERT_EQ(DB_FAILED, RunSql(engine, "create table f(id int dictionary);"));
+    ASSERT_EQ(DB_FAILED,
+              RunSql(engine, "create table p(id int, c char(8) dictionary) partition by hash(id) partitions 2;"));
+    ASSERT_EQ(DB_FAILED, RunSql(engine, "create table l(c char(300) dictionary);"));
+  }
+  {
+    DBStorageEngine engine("dictionary_statement", false);
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("t", table_info));
+    ASSERT_EQ(0, CountCity(table_info, "city2"));
+    ASSERT_EQ(5, CountCity(table_info, "city7"));
+    ASSERT_EQ(4, CountCity(table_info, "city1"));
+    TableInfo *missing = nullptr;
+    ASSERT_EQ(DB_TABLE_NOT_EXIST, engine.catalog_mgr_->GetTable("l", missing));
+  }
+  DiskManager::RemoveDatabaseFiles("./databases/dictionary_statement");
+}
+
+// SELECT * FROM t WHERE city = x on a char(64) column with 16 values, stored as values and as codes
+TEST(DictionaryEncodingTest, DictionaryBenchmarkTest) {
+  const int row_nums = 100000;
+  const int city_nums = 16;
+  remove(dictionary_db_file.c_str());
+  DBStorageEngine engine(dictionary_db_file, true);
+  CatalogManager *catalog = engine.catalog_mgr_;
+  TableInfo *plain = nullptr;
+  TableInfo *encoded = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("plain", MakeCitySchema(64), nullptr, plain));
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("encoded", MakeCitySchema(64), nullptr, encoded));
+  ASSERT_EQ(DB_SUCCESS, catalog->SetDictionary("encoded", "city"));
+  // the values are padded to the width of the column, as a fixed width char would be
+  auto padded = [](int i) {
+    std::string city = CityOf(i, city_nums);
+    return city + std::string(64 - city.size(), '.');
+  };
+  for (TableInfo *table_info : {plain, encoded}) {
+    for (int i = 0; i < row_nums; i++) {
+      std::string city = padded(i);
+      std::vector<Field> fields{Field(TypeId::kTypeInt, i), MakeCharField(city)};
+      Row row(fields);
+      ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+    }
+  }
+  std::string city = padded(3);
+  auto predicate = std::make_shared<ComparisonExpression>(
+      std::make_shared<ColumnValueExpression>(0, 1, TypeId::kTypeChar),
+      std::make_shared<ConstantValueExpression>(MakeCharField(city)), "=");
+  ExecuteContext context(nullptr, catalog, engine.bpm_);
+  auto scan = [&](TableInfo *table_info, bool codes, double &ms) {
+    SeqScanPlanNode plan(table_info->GetSchema(), table_info->GetTableName(), predicate);
+    if (codes) {
+      plan.code_predicate_ = SeqScanPlanNode::EncodePredicate(predicate, table_info->GetSchema());
+      EXPECT_NE(nullptr, plan.code_predicate_);
+    }
+    auto start = std::chrono::steady_clock::now();
+    SeqScanExecutor executor(&context, &plan);
+    executor.Init();
+    int count = 0;
+    Row row;
+    RowId rid;
+    while (executor.Next(&row, &rid)) {
+      EXPECT_EQ(city, std::string(row.GetField(1)->GetData(), row.GetField(1)->GetLength()));
+      count++;
+    }
+    ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return count;
+  };
+  double plain_ms, encoded_ms;
+  // the first scans build the zone maps
+  ASSERT_EQ(row_nums / city_nums, scan(plain, false, plain_ms));
+  ASSERT_EQ(row_nums / city_nums, scan(encoded, true, encoded_ms));
+  ASSERT_EQ(row_nums / city_nums, scan(plain, false, plain_ms));
+  ASSERT_EQ(row_nums / city_nums, scan(encoded, true, encoded_ms));
+  uint32_t plain_pages = plain->GetTableHeap()->GetPageCount();
+  uint32_t encoded_pages = encoded->GetTableHeap()->GetPageCount();
+  std::cout << row_nums << " rows: values in " << plain_pages << " pages, codes in " << encoded_pages
+            << " pages; scan for one value " << plain_ms << " ms on values, " << encoded_ms << " ms on codes, "
+            << plain_ms / encoded_ms << "x" << std::endl;
+  ASSERT_LT(encoded_pages * 3, plain_pages);
+  remove(dictionary_db_file.c_str());
+}
@@ -0,0 +1,151 @@
+#include <chrono>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/execute_engine.h"
+#include "gtest/gtest.h"
+#include "utils/sql_test_util.h"
+
+static const std::string lsm_table_db_file = "lsm_table_test.db";
+
+TEST(LsmTableTest, LsmTableTest) {
+  const int row_nums = 5000;
+  std::vector<int> ids = ShuffledIds(row_nums, 13);
+  RowId deleted_rid;
+  {
+    DBStorageEngine engine(lsm_table_db_file, true);
+    TableInfo *table_info = CreateAndFill(engine, "l", ids, TableStorage::kLsm);
+    TableHeap *table_heap = table_info->GetTableHeap();
+    ASSERT_EQ(TableStorage::kLsm, table_heap->GetStorage());
+    ASSERT_EQ(row_nums, CountRows(table_heap));
+    IndexInfo *index_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("l", "primary", index_info));
+    Index *index = index_info->GetIndex();
+    ASSERT_NE(nullptr, dynamic_cast<LsmIndex *>(index));
+    // the index keeps keys in order, negative numbers before positive ones
+    std::vector<RowId> result;
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeIntKey(42), result, nullptr));
+    ASSERT_EQ(1, result.size());
+    Row row(result[0]);
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    ASSERT_EQ("42", row.GetField(0)->toString());
+    result.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeIntKey(10), result, nullptr, "<"));
+    ASSERT_EQ(10, result.size());
+    for (int i = 0; i < 10; i++) {
+      Row ordered(result[i]);
+      ASSERT_TRUE(table_heap->GetTuple(&ordered, nullptr));
+      ASSERT_EQ(std::to_string(i), ordered.GetField(0)->toString());
+    }
+    result.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeIntKey(row_nums - 10), result, nullptr, ">="));
+    ASSERT_EQ(10, result.size());
+    result.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeIntKey(row_nums - 10), result, nullptr, ">"));
+    ASSERT_EQ(9, result.size());
+    result.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeIntKey(5), result, nullptr, "<>"));
+    ASSERT_EQ(row_nums - 1, result.size());
+    result.clear();
+    ASSERT_EQ(DB_FAILED, index->InsertEntry(MakeIntKey(5), RowId(0, 0), nullptr));
+    Row negative = MakeIdNameRow(-3);
+    ASSERT_TRUE(table_heap->InsertTuple(negative, nullptr));
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(MakeIntKey(-3), negative.GetRowId(), nullptr));
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeIntKey(0), result, nullptr, "<="));
+    ASSERT_EQ(2, result.size());
+    ASSERT_EQ(negative.GetRowId(), result[0]);
+    result.clear();
+    // update, delete and rollback
+    Row updated = MakeIdNameRow(42);
+    ASSERT_TRUE(table_heap->UpdateTuple(updated, row.GetRowId(), nullptr));
+    ASSERT_TRUE(table_heap->MarkDelete(row.GetRowId(), nullptr));
+    ASSERT_FALSE(table_heap->GetTuple(&row, nullptr));
+    ASSERT_EQ(row_nums, CountRows(table_heap));
+    table_heap->RollbackDelete(row.GetRowId(), nullptr);
+    ASSERT_EQ(row_nums + 1, CountRows(table_heap));
+    ASSERT_TRUE(table_heap->MarkDelete(row.GetRowId(), nullptr));
+    table_heap->ApplyDelete(row.GetRowId(), nullptr);
+    ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(MakeIntKey(42), row.GetRowId(), nullptr));
+    ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(MakeIntKey(42), result, nullptr));
+    ASSERT_EQ(row_nums, CountRows(table_heap));
+    deleted_rid = row.GetRowId();
+    // row ids are never taken again
+    Row appended = MakeIdNameRow(row_nums);
+    ASSERT_TRUE(table_heap->InsertTuple(appended, nullptr));
+    ASSERT_FALSE(deleted_rid == appended.GetRowId());
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(MakeIntKey(row_nums), appended.GetRowId(), nullptr));
+    // a second table is emptied at once
+    CreateAndFill(engine, "t", {1, 2, 3}, TableStorage::kLsm);
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->TruncateTable("t", nullptr));
+  }
+  // rows and index entries left in the memtables are written out when the database is closed
+  {
+    DBStorageEngine engine(lsm_table_db_file, false);
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("l", table_info));
+    ASSERT_EQ(TableStorage::kLsm, table_info->GetTableHeap()->GetStorage());
+    ASSERT_EQ(row_nums + 1, CountRows(table_info->GetTableHeap()));
+    Row row(deleted_rid);
+    ASSERT_FALSE(table_info->GetTableHeap()->GetTuple(&row, nullptr));
+    IndexInfo *index_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("l", "primary", index_info));
+    std::vector<RowId> result;
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(MakeIntKey(row_nums), result, nullptr));
+    result.clear();
+    ASSERT_EQ(DB_KEY_NOT_FOUND, index_info->GetIndex()->ScanKey(MakeIntKey(42), result, nullptr));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("t", table_info));
+    ASSERT_EQ(0, CountRows(table_info->GetTableHeap()));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->DropTable("t"));
+    VacuumStats stats;
+    ASSERT_EQ(DB_SUCCESS, engine.VacuumDatabase(stats));
+  }
+  // the runs and manifests are still found after the pages were moved
+  DBStorageEngine engine(lsm_table_db_file, false);
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("l", table_info));
+  ASSERT_EQ(row_nums + 1, CountRows(table_info->GetTableHeap()));
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("l", "primary", index_info));
+  std::vector<RowId> result;
+  ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(MakeIntKey(7), result, nullptr));
+  Row row(result[0]);
+  ASSERT_TRUE(table_info->GetTableHeap()->GetTuple(&row, nullptr));
+  ASSERT_EQ("7", row.GetField(0)->toString());
+}
+
+TEST(LsmTableTest, LsmTableStatementTest) {
+  ExecuteEngine engine;
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create database lsm_statement;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "use lsm_statement;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table e(id int, name char(16), primary key(id)) engine = lsm;"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "create temporary table t(id int) engine = lsm;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into e values(1, \"one\");"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into e values(2, \"two\");"));
+  RunSql(engine, "insert into e values(2, \"again\");");
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create index e_name on e(name);"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "select * from e where id = 2;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "select * from e where name = \"one\";"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "update e set name = \"zwei\" where id = 2;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "delete from e where id = 1;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "select * from e;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "truncate table e;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "drop table e;"));
+  RunSql(engine, "drop database lsm_statement;");
+}
+
+// an insert into an lsm table only writes into memtables, the heap and b+ tree update pages in place
+TEST(LsmTableTest, LsmTableBenchmarkTest) {
+  const int row_nums = 100000;
+  std::vector<int> ids = ShuffledIds(row_nums, 17);
+  DBStorageEngine engine("lsm_bench.db", true);
+  for (auto storage : {TableStorage::kRow, TableStorage::kLsm}) {
+    std::string name = storage == TableStorage::kRow ? "heap" : "lsm";
+    auto start = std::chrono::steady_clock::now();
+    TableInfo *table_info = CreateAndFill(engine, name, ids, storage);
+    auto end = std::chrono::steady_clock::now();
+    double insert_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    std::cout << name << " table: " << row_nums << " inserts in " << insert_ms << " ms, " << row_nums / insert_ms
+              << " rows/ms" << std::endl;
+    ASSERT_EQ(row_nums, CountRows(table_info->GetTableHeap()));
+  }
+}
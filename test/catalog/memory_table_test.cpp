@@ -0,0 +1,169 @@
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/execute_engine.h"
+#include "gtest/gtest.h"
+#include "utils/sql_test_util.h"
+
+static const std::string memory_db_file = "memory_table_test.db";
+
+TEST(MemoryTableTest, MemoryTableTest) {
+  const int row_nums = 2000;
+  {
+    DBStorageEngine engine(memory_db_file, true);
+    uint32_t pages_empty = engine.disk_mgr_->GetAllocatedPages(DEFAULT_TABLESPACE_ID);
+    TableInfo *table_info = CreateAndFill(engine, "m", ShuffledIds(row_nums, 11), TableStorage::kMemory, "bptree");
+    // the rows take no pages, only the meta pages of the table and its index are written
+    ASSERT_EQ(pages_empty + 2, engine.disk_mgr_->GetAllocatedPages(DEFAULT_TABLESPACE_ID));
+    TableHeap *table_heap = table_info->GetTableHeap();
+    ASSERT_EQ(row_nums, CountRows(table_heap));
+    IndexInfo *index_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("m", "primary", index_info));
+    Index *index = index_info->GetIndex();
+    // point lookups and ranges through the ordered index
+    std::vector<RowId> result;
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeIntKey(42), result, nullptr));
+    ASSERT_EQ(1, result.size());
+    Row row(result[0]);
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    ASSERT_EQ("42", row.GetField(0)->toString());
+    result.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeIntKey(10), result, nullptr, "<"));
+    ASSERT_EQ(10, result.size());
+    for (int i = 0; i < 10; i++) {
+      Row ordered(result[i]);
+      ASSERT_TRUE(table_heap->GetTuple(&ordered, nullptr));
+      ASSERT_EQ(std::to_string(i), ordered.GetField(0)->toString());
+    }
+    result.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeIntKey(row_nums - 10), result, nullptr, ">="));
+    ASSERT_EQ(10, result.size());
+    result.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeIntKey(5), result, nullptr, "<>"));
+    ASSERT_EQ(row_nums - 1, result.size());
+    result.clear();
+    ASSERT_EQ(DB_FAILED, index->InsertEntry(MakeIntKey(5), RowId(0, 0), nullptr));
+    // update, delete and rollback work on the rows in memory
+    Row updated = MakeIdNameRow(42);
+    ASSERT_TRUE(table_heap->UpdateTuple(updated, row.GetRowId(), nullptr));
+    ASSERT_TRUE(table_heap->MarkDelete(row.GetRowId(), nullptr));
+    ASSERT_FALSE(table_heap->GetTuple(&row, nullptr));
+    ASSERT_EQ(row_nums - 1, CountRows(table_heap));
+    table_heap->RollbackDelete(row.GetRowId(), nullptr);
+    ASSERT_EQ(row_nums, CountRows(table_heap));
+    ASSERT_TRUE(table_heap->MarkDelete(row.GetRowId(), nullptr));
+    table_heap->ApplyDelete(row.GetRowId(), nullptr);
+    ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(MakeIntKey(42), row.GetRowId(), nullptr));
+    ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(MakeIntKey(42), result, nullptr));
+    ASSERT_EQ(row_nums - 1, CountRows(table_heap));
+    // the freed slot is taken by the next insert
+    Row reinserted = MakeIdNameRow(row_nums);
+    ASSERT_TRUE(table_heap->InsertTuple(reinserted, nullptr));
+    ASSERT_EQ(row.GetRowId(), reinserted.GetRowId());
+    // a hash index finds keys and still answers ranges
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateIndex("m", "name_hash", {"name"}, nullptr, index_info, "hash"));
+    ASSERT_EQ(MemoryIndex::Kind::kHash, dynamic_cast<MemoryIndex *>(index_info->GetIndex())->GetKind());
+    Row name_key;
+    MakeIdNameRow(7).GetKeyFromRow(table_info->GetSchema(), index_info->GetIndexKeySchema(), name_key);
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(name_key, result, nullptr));
+    ASSERT_EQ(1, result.size());
+    result.clear();
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(name_key, result, nullptr, "<="));
+    ASSERT_EQ(8, result.size());
+    // a temporary table is known to this catalog only
+    TableInfo *temp_info = CreateAndFill(engine, "tmp", ShuffledIds(100, 11), TableStorage::kRow, "bptree", true);
+    ASSERT_TRUE(temp_info->IsTemporary());
+    ASSERT_EQ(TableStorage::kMemory, temp_info->GetTableHeap()->GetStorage());
+    ASSERT_EQ(100, CountRows(temp_info->GetTableHeap()));
+    CreateAndFill(engine, "tmp_dropped", ShuffledIds(10, 11), TableStorage::kMemory, "hash", true);
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->DropTable("tmp_dropped"));
+    // a disk table created after the temporary ones takes ids of its own
+    TableInfo *disk_info = CreateAndFill(engine, "d", ShuffledIds(100, 11), TableStorage::kRow, "bptree");
+    ASSERT_NE(temp_info->GetTableId(), disk_info->GetTableId());
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->TruncateTable("tmp", nullptr));
+    ASSERT_EQ(0, CountRows(temp_info->GetTableHeap()));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->TruncateTable("m", nullptr));
+    ASSERT_EQ(0, CountRows(table_info->GetTableHeap()));
+    table_heap = table_info->GetTableHeap();
+    Row after_truncate = MakeIdNameRow(1);
+    ASSERT_TRUE(table_heap->InsertTuple(after_truncate, nullptr));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("m", "primary", index_info));
+    result.clear();
+    ASSERT_EQ(DB_KEY_NOT_FOUND, index_info->GetIndex()->ScanKey(MakeIntKey(5), result, nullptr));
+  }
+  // the memory table comes back empty with its indexes, the temporary table is gone
+  DBStorageEngine engine(memory_db_file, false);
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("m", table_info));
+  ASSERT_EQ(TableStorage::kMemory, table_info->GetTableHeap()->GetStorage());
+  ASSERT_EQ(0, CountRows(table_info->GetTableHeap()));
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("m", "name_hash", index_info));
+  ASSERT_EQ(MemoryIndex::Kind::kHash, dynamic_cast<MemoryIndex *>(index_info->GetIndex())->GetKind());
+  ASSERT_EQ(DB_TABLE_NOT_EXIST, engine.catalog_mgr_->GetTable("tmp", table_info));
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("d", table_info));
+  ASSERT_EQ(100, CountRows(table_info->GetTableHeap()));
+  VacuumStats stats;
+  ASSERT_EQ(DB_SUCCESS, engine.VacuumDatabase(stats));
+}
+
+TEST(MemoryTableTest, MemoryTableStatementTest) {
+  ExecuteEngine engine;
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create database memory_statement;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "use memory_statement;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table m(id int, name char(16), primary key(id)) engine = memory;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create temporary table t(id int, primary key(id));"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "create temporary table u(id int) engine = disk;"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "create table u(id int) engine = tape;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table d(id int) engine = disk;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into m values(1, \"one\");"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into m values(2, \"two\");"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into t values(1);"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create index m_name on m(name) using hash;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "select * from m where id = 2;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "select * from m where name = \"one\";"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "update m set name = \"zwei\" where id = 2;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "delete from m where id = 1;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "select * from t;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "truncate table t;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "drop table t;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create temporary table t(id int);"));
+  RunSql(engine, "drop database memory_statement;");
+}
+
+// a memory table reads its rows without pins, slot lookups or deserialization
+TEST(MemoryTableTest, MemoryTableBenchmarkTest) {
+  const int row_nums = 50000;
+  const int lookups = 100000;
+  DBStorageEngine engine("memory_bench.db", true);
+  for (auto storage : {TableStorage::kRow, TableStorage::kMemory}) {
+    std::string name = storage == TableStorage::kRow ? "disk" : "memory";
+    TableInfo *table_info = CreateAndFill(engine, name, ShuffledIds(row_nums, 11), storage,
+                                          storage == TableStorage::kRow ? "bptree" : "hash");
+    IndexInfo *index_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex(name, "primary", index_info));
+    std::mt19937 random(3);
+    std::vector<Row> keys;
+    for (int i = 0; i < lookups; i++) {
+      keys.push_back(MakeIntKey(static_cast<int>(random() % row_nums)));
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::vector<RowId> result;
+    for (auto &key : keys) {
+      result.clear();
+      ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(key, result, nullptr));
+      Row row(result[0]);
+      ASSERT_TRUE(table_info->GetTableHeap()->GetTuple(&row, nullptr));
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (int i = 0; i < 10; i++) {
+      ASSERT_EQ(row_nums, CountRows(table_info->GetTableHeap()));
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::cout << name << " table: " << lookups << " point lookups in "
+              << std::chrono::duration<double, std::milli>(middle - start).count() << " ms, 10 scans in "
+              << std::chrono::duration<double, std::milli>(end - middle).count() << " ms" << std::endl;
+  }
+}
@@ -0,0 +1,322 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/execute_engine.h"
+#include "gtest/gtest.h"
+#include "planner/planner.h"
+#include "utils/sql_test_util.h"
+
+static const std::string partition_db_file = "partition_table_test.db";
+
+/**
+ * Plan a statement and run it.
+ * @param[out] plans number of partitions the plan reads, 1 for a table that is not partitioned
+ * @return the number of rows the plan produced, which is none for an insert, -1 if the planner rejects the statement
+ */
+static int RunPartitionQuery(ExecuteEngine &executor, DBStorageEngine &engine, const std::string &sql,
+                             size_t *plans = nullptr) {
+  return WithSyntaxTree(sql, [&](pSyntaxNode ast) {
+    EXPECT_NE(nullptr, ast) << sql;
+    ExecuteContext context(nullptr, engine.catalog_mgr_, engine.bpm_);
+    Planner planner(&context);
+    try {
+      planner.PlanQuery(ast);
+      if (plans != nullptr) {
+        *plans = planner.plan_->GetType() == PlanType::Append ? planner.plan_->GetChildren().size() : 1;
+      }
+      std::vector<Row> result_set;
+      EXPECT_EQ(DB_SUCCESS, executor.ExecutePlan(planner.plan_, &result_set, nullptr, &context)) << sql;
+      return static_cast<int>(result_set.size());
+    } catch (const std::logic_error &) {
+      return -1;
+    }
+  });
+}
+
+/**
+ * Run a statement on the table holding partition p0 of table h. The parser takes no '#' in a name, so the statement
+ * names h_p0 instead and its syntax tree is renamed.
+ */
+static dberr_t RunOnPartition(ExecuteEngine &engine, const std::string &sql) {
+  std::function<void(pSyntaxNode)> rename = [&rename](pSyntaxNode node) {
+    for (; node != nullptr; node = node->next_) {
+      if (node->val_ != nullptr && strcmp(node->val_, "h_p0") == 0) {
+        node->val_[1] = '#';
+      }
+      rename(node->child_);
+    }
+  };
+  return WithSyntaxTree(sql, [&](pSyntaxNode ast) {
+    if (ast == nullptr) {
+      return DB_FAILED;
+    }
+    rename(ast);
+    return engine.Execute(ast);
+  });
+}
+
+TEST(PartitionTableTest, PartitionSchemeTest) {
+  Field b100(TypeId::kTypeInt, 100), b200(TypeId::kTypeInt, 200), b150(TypeId::kTypeInt, 150);
+  PartitionScheme range(PartitionKind::kRange, 0, TypeId::kTypeInt);
+  ASSERT_TRUE(range.AddPartition("p0", 1, &b100));
+  ASSERT_TRUE(range.AddPartition("p1", 2, &b200));
+  ASSERT_FALSE(range.AddPartition("p2", 3, &b150));
+  ASSERT_TRUE(range.AddPartition("p2", 3));
+  ASSERT_FALSE(range.AddPartition("p3", 4, &b200));
+  ASSERT_TRUE(range.IsUnbounded());
+  uint32_t index;
+  ASSERT_TRUE(range.Locate(Field(TypeId::kTypeInt, 99), index));
+  ASSERT_EQ(0, index);
+  ASSERT_TRUE(range.Locate(Field(TypeId::kTypeInt, 100), index));
+  ASSERT_EQ(1, index);
+  ASSERT_TRUE(range.Locate(Field(TypeId::kTypeInt, 1000), index));
+  ASSERT_EQ(2, index);
+  ASSERT_TRUE(range.Locate(Field(TypeId::kTypeInt), index));
+  ASSERT_EQ(0, index);
+  using Op = CompareOp;
+  // p1 holds [100, 200)
+  ASSERT_TRUE(range.MayMatch(1, Op::kEqual, b100));
+  ASSERT_FALSE(range.MayMatch(1, Op::kEqual, b200));
+  ASSERT_FALSE(range.MayMatch(1, Op::kLessThan, b100));
+  ASSERT_TRUE(range.MayMatch(1, Op::kLessThanEquals, b100));
+  ASSERT_FALSE(range.MayMatch(1, Op::kGreaterThanEquals, b200));
+  ASSERT_TRUE(range.MayMatch(1, Op::kNotEqual, b100));
+  ASSERT_TRUE(range.MayMatch(2, Op::kGreaterThan, b200));
+  ASSERT_FALSE(range.MayMatch(2, Op::kLessThan, b200));
+
+  Schema *schema = MakeIdNameSchema(32);
+  std::vector<char> buf(range.GetSerializedSize());
+  ASSERT_EQ(buf.size(), range.SerializeTo(buf.data()));
+  PartitionScheme *copy = nullptr;
+  ASSERT_EQ(buf.size(), PartitionScheme::DeserializeFrom(buf.data(), schema, copy));
+  ASSERT_EQ(3, copy->GetPartitionCount());
+  ASSERT_EQ("p1", copy->GetPartitionName(1));
+  ASSERT_EQ(2, copy->GetTableId(1));
+  ASSERT_TRUE(copy->IsUnbounded());
+  ASSERT_TRUE(copy->Locate(Field(TypeId::kTypeInt, 150), index));
+  ASSERT_EQ(1, index);
+  delete copy;
+  delete schema;
+
+  // the values spread over all hash partitions, and an equality rules out all but one
+  PartitionScheme hash(PartitionKind::kHash, 0, TypeId::kTypeInt);
+  ASSERT_FALSE(hash.AddPartition("p0", 1, &b100));
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(hash.AddPartition("p" + std::to_string(i), i));
+  }
+  std::vector<int> counts(4, 0);
+  for (int i = 0; i < 4000; i++) {
+    ASSERT_TRUE(hash.Locate(Field(TypeId::kTypeInt, i), index));
+    counts[index]++;
+  }
+  for (auto count : counts) {
+    ASSERT_GT(count, 800);
+  }
+  int matches = 0;
+  for (uint32_t i = 0; i < 4; i++) {
+    matches += hash.MayMatch(i, Op::kEqual, b150);
+    ASSERT_TRUE(hash.MayMatch(i, Op::kLessThan, b150));
+  }
+  ASSERT_EQ(1, matches);
+}
+
+TEST(PartitionTableTest, PartitionTableTest) {
+  remove(partition_db_file.c_str());
+  {
+    ExecuteEngine executor;
+    DBStorageEngine engine(partition_db_file, true);
+    CatalogManager *catalog = engine.catalog_mgr_;
+    auto scheme = new PartitionScheme(PartitionKind::kRange, 0, TypeId::kTypeInt);
+    for (int i = 0; i < 3; i++) {
+      Field bound(TypeId::kTypeInt, (i + 1) * 1000);
+      ASSERT_TRUE(scheme->AddPartition("p" + std::to_string(i), 0, &bound));
+    }
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("orders", MakeIdNameSchema(32), nullptr, table_info,
+                                               DEFAULT_TABLESPACE_ID, TableStorage::kRow, false, scheme));
+    ASSERT_TRUE(table_info->IsPartitioned());
+    ASSERT_EQ(nullptr, table_info->GetTableHeap());
+    ASSERT_EQ(3, table_info->GetPartitions().size());
+    TableInfo *partition = nullptr;
+    ASSERT_EQ(DB_SUCCESS, catalog->GetTable("orders#p1", partition));
+    ASSERT_EQ(table_info, partition->GetParent());
+    ASSERT_EQ(DB_FAILED, catalog->DropTable("orders#p1"));
+    // an index of the table is an index on every partition
+    IndexInfo *index_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, catalog->CreateIndex("orders", "orders_id", {"id"}, nullptr, index_info, "bptree"));
+    ASSERT_EQ(DB_SUCCESS, catalog->GetIndex("orders#p2", "orders_id", index_info));
+
+    for (int id = 0; id < 3000; id += 10) {
+      ASSERT_EQ(0, RunPartitionQuery(executor, engine, "insert into orders values(" + std::to_string(id) + ", \"o\");"));
+    }
+    for (auto table : table_info->GetPartitions()) {
+      ASSERT_EQ(100, CountRows(table->GetTableHeap()));
+    }
+    ASSERT_EQ(-1, RunPartitionQuery(executor, engine, "insert into orders values(3000, \"o\");"));
+
+    size_t plans = 0;
+    ASSERT_EQ(300, RunPartitionQuery(executor, engine, "select * from orders;", &plans));
+    ASSERT_EQ(3, plans);
+    ASSERT_EQ(50, RunPartitionQuery(executor, engine, "select * from orders where id < 500;", &plans));
+    ASSERT_EQ(1, plans);
+    ASSERT_EQ(1, RunPartitionQuery(executor, engine, "select * from orders where id = 1500;", &plans));
+    ASSERT_EQ(1, plans);
+    ASSERT_EQ(100, RunPartitionQuery(executor, engine, "select * from orders where id >= 1500 and id < 2500;", &plans));
+    ASSERT_EQ(2, plans);
+    ASSERT_EQ(2, RunPartitionQuery(executor, engine, "select * from orders where id = 10 or id = 2990;", &plans));
+    ASSERT_EQ(2, plans);
+    ASSERT_EQ(0, RunPartitionQuery(executor, engine, "select * from orders where id >= 3000;", &plans));
+    ASSERT_EQ(0, plans);
+    ASSERT_EQ(4, RunPartitionQuery(executor, engine, "update orders set name = \"u\" where id > 2950;", &plans));
+    ASSERT_EQ(1, plans);
+    ASSERT_EQ(-1, RunPartitionQuery(executor, engine, "update orders set id = 5 where id = 10;"));
+    ASSERT_EQ(10, RunPartitionQuery(executor, engine, "delete from orders where id >= 900 and id < 1000;", &plans));
+    ASSERT_EQ(1, plans);
+    ASSERT_EQ(90, CountRows(table_info->GetPartitions()[0]->GetTableHeap()));
+
+    // a new partition takes the values above the others, with the same indexes
+    ASSERT_EQ(DB_FAILED, catalog->AddPartition("orders", "p1", nullptr, nullptr));
+    ASSERT_EQ(DB_SUCCESS, catalog->AddPartition("orders", "p3", nullptr, nullptr));
+    ASSERT_EQ(DB_SUCCESS, catalog->GetIndex("orders#p3", "orders_id", index_info));
+    ASSERT_EQ(0, RunPartitionQuery(executor, engine, "insert into orders values(5000, \"o\");"));
+    ASSERT_EQ(1, RunPartitionQuery(executor, engine, "select * from orders where id = 5000;", &plans));
+    ASSERT_EQ(1, plans);
+    ASSERT_EQ(DB_SUCCESS, catalog->TruncatePartition("orders", "p1", nullptr));
+    ASSERT_EQ(0, CountRows(table_info->GetPartitions()[1]->GetTableHeap()));
+    ASSERT_EQ(DB_SUCCESS, catalog->DropPartition("orders", "p0"));
+    ASSERT_EQ(DB_TABLE_NOT_EXIST, catalog->GetTable("orders#p0", partition));
+    ASSERT_EQ(3, table_info->GetPartitions().size());
+    ASSERT_EQ(101, RunPartitionQuery(executor, engine, "select * from orders;", &plans));
+    ASSERT_EQ(3, plans);
+    catalog->GetPageReclaimer()->Wait();
+  }
+  {
+    ExecuteEngine executor;
+    DBStorageEngine engine(partition_db_file, false);
+    CatalogManager *catalog = engine.catalog_mgr_;
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, catalog->GetTable("orders", table_info));
+    ASSERT_TRUE(table_info->IsPartitioned());
+    ASSERT_EQ(3, table_info->GetPartitions().size());
+    ASSERT_EQ("orders#p1", table_info->GetPartitions()[0]->GetTableName());
+    ASSERT_EQ(table_info, table_info->GetPartitions()[2]->GetParent());
+    size_t plans = 0;
+    ASSERT_EQ(100, RunPartitionQuery(executor, engine, "select * from orders where id >= 2000 and id < 3000;", &plans));
+    ASSERT_EQ(1, plans);
+    // the lowest partition takes the values below the bound of the one that was dropped
+    ASSERT_EQ(0, RunPartitionQuery(executor, engine, "insert into orders values(500, \"o\");"));
+    ASSERT_EQ(1, RunPartitionQuery(executor, engine, "select * from orders where id < 1000;", &plans));
+    ASSERT_EQ(1, plans);
+    uint32_t pages_reclaimed = 0, rows_moved = 0;
+    ASSERT_EQ(DB_SUCCESS, catalog->VacuumTable("orders", pages_reclaimed, rows_moved, nullptr));
+    ASSERT_EQ(DB_SUCCESS, catalog->DropTable("orders"));
+    std::vector<TableInfo *> tables;
+    catalog->GetTables(tables);
+    ASSERT_TRUE(tables.empty());
+  }
+  remove(partition_db_file.c_str());
+}
+
+TEST(PartitionTableTest, PartitionTableStatementTest) {
+  ExecuteEngine engine;
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create database partition_statement;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "use partition_statement;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table r(id int, name char(16), primary key(id)) "
+                                                "partition by range(id) (partition p0 values less than (100), "
+                                                "partition p1 values less than (200));"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table h(id int, name char(16)) partition by hash(id) "
+                                                "partitions 4;"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "create table x(id int) partition by range(id) "
+                                               "(partition p0 values less than (100), partition p1);"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "create table x(id int) partition by range(id) "
+                                               "(partition p0 values less than (\"a\"));"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "create table x(id int) partition by range(name) (partition p0);"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "create temporary table x(id int) partition by hash(id) partitions 2;"));
+  // each partition checks its own keys only, so a key has to decide the partition of its row
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "create table x(id int, name char(16), primary key(name)) "
+                                      "partition by hash(id) partitions 2;"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "create table x(id int, name char(16) unique) partition by hash(id) "
+                                      "partitions 2;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table k(id int, name char(16), primary key(id, name)) "
+                                       "partition by hash(id) partitions 2;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "drop table k;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into r values(1, \"one\");"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into r values(150, \"big\");"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "insert into r values(250, \"bigger\");"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into h values(7, \"seven\");"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "select * from r where id > 100;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "select * from h where id = 7;"));
+  // the tables holding the partitions are neither listed nor named by a statement
+  testing::internal::CaptureStdout();
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "show tables;"));
+  ASSERT_EQ(std::string::npos, testing::internal::GetCapturedStdout().find('#'));
+  ASSERT_EQ(DB_FAILED, RunOnPartition(engine, "select * from h_p0;"));
+  ASSERT_EQ(DB_FAILED, RunOnPartition(engine, "insert into h_p0 values(8, \"eight\");"));
+  ASSERT_EQ(DB_FAILED, RunOnPartition(engine, "update h_p0 set name = \"eight\";"));
+  ASSERT_EQ(DB_FAILED, RunOnPartition(engine, "delete from h_p0;"));
+  ASSERT_EQ(DB_FAILED, RunOnPartition(engine, "create table h_p0(id int);"));
+  ASSERT_EQ(DB_TABLE_NOT_EXIST, RunOnPartition(engine, "create index h_name on h_p0(name);"));
+  ASSERT_EQ(DB_TABLE_NOT_EXIST, RunOnPartition(engine, "truncate table h_p0;"));
+  ASSERT_EQ(DB_TABLE_NOT_EXIST, RunOnPartition(engine, "drop table h_p0;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "alter table r add partition p2 values less than maxvalue;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into r values(250, \"bigger\");"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "alter table r add partition p3 values less than (300);"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "alter table r truncate partition p1;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "alter table r drop partition p0;"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "alter table h drop partition p0;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "alter table h truncate partition p0;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "vacuum table r;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "truncate table h;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create index r_name on r(name);"));
+  RunSql(engine, "drop index r_name;");
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "drop table r;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "drop table h;"));
+  RunSql(engine, "drop database partition_statement;");
+}
+
+// a scan of a range of ids reads one partition of ten, the table without partitions reads all of its pages
+TEST(PartitionTableTest, PartitionPruningBenchmarkTest) {
+  const int row_nums = 100000;
+  const int partition_nums = 10;
+  // rows in random order, so the zone maps of the plain table cannot skip pages either
+  std::vector<int> ids = ShuffledIds(row_nums, 23);
+  ExecuteEngine executor;
+  DBStorageEngine engine("partition_bench.db", true);
+  CatalogManager *catalog = engine.catalog_mgr_;
+  TableInfo *plain = nullptr, *partitioned = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("plain", MakeIdNameSchema(32), nullptr, plain));
+  auto scheme = new PartitionScheme(PartitionKind::kRange, 0, TypeId::kTypeInt);
+  for (int i = 0; i < partition_nums; i++) {
+    Field bound(TypeId::kTypeInt, (i + 1) * row_nums / partition_nums);
+    scheme->AddPartition("p" + std::to_string(i), 0, &bound);
+  }
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("partitioned", MakeIdNameSchema(32), nullptr, partitioned,
+                                             DEFAULT_TABLESPACE_ID, TableStorage::kRow, false, scheme));
+  for (auto id : ids) {
+    Row row = MakeIdNameRow(id, 32);
+    ASSERT_TRUE(plain->GetTableHeap()->InsertTuple(row, nullptr));
+    uint32_t index;
+    ASSERT_TRUE(partitioned->GetPartitionScheme()->Locate(*row.GetField(0), index));
+    Row partition_row = MakeIdNameRow(id, 32);
+    ASSERT_TRUE(partitioned->GetPartitions()[index]->GetTableHeap()->InsertTuple(partition_row, nullptr));
+  }
+  std::vector<double> scan_ms;
+  for (std::string name : {"plain", "partitioned"}) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < partition_nums; i++) {
+      int low = i * row_nums / partition_nums;
+      std::string sql = "select * from " + name + " where id >= " + std::to_string(low) + " and id < " +
+                        std::to_string(low + row_nums / partition_nums) + ";";
+      ASSERT_EQ(row_nums / partition_nums, RunPartitionQuery(executor, engine, sql));
+    }
+    auto end = std::chrono::steady_clock::now();
+    scan_ms.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    std::cout << name << " table: " << partition_nums << " range scans in " << scan_ms.back() << " ms" << std::endl;
+  }
+  std::cout << "speedup: " << scan_ms[0] / scan_ms[1] << "x" << std::endl;
+  remove("partition_bench.db");
+}
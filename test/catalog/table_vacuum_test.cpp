@@ -0,0 +1,150 @@
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "utils/sql_test_util.h"
+
+static const std::string table_vacuum_db_file = "table_vacuum_test.db";
+
+static std::vector<int> ScanIds(TableHeap *table_heap) {
+  std::vector<int> ids;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+    ids.push_back(std::stoi(iter->GetField(0)->toString()));
+  }
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+/**
+ * Create table t, insert row_nums rows, delete all but every keep-th of them and index the rest on id.
+ * @return the ids of the rows left
+ */
+static std::vector<int> FillAndThin(DBStorageEngine &engine, int row_nums, int keep, std::vector<RowId> &rids) {
+  TableInfo *table_info = nullptr;
+  engine.catalog_mgr_->CreateTable("t", MakeIdNameSchema(), nullptr, table_info);
+  TableHeap *table_heap = table_info->GetTableHeap();
+  std::vector<int> left;
+  for (int i = 0; i < row_nums; i++) {
+    Row row = MakeIdNameRow(i);
+    table_heap->InsertTuple(row, nullptr);
+    rids.push_back(row.GetRowId());
+  }
+  for (int i = 0; i < row_nums; i++) {
+    if (i % keep == 0) {
+      left.push_back(i);
+      continue;
+    }
+    table_heap->MarkDelete(rids[i], nullptr);
+    table_heap->ApplyDelete(rids[i], nullptr);
+  }
+  IndexInfo *index_info = nullptr;
+  engine.catalog_mgr_->CreateIndex("t", "primary", {"id"}, nullptr, index_info, "bptree");
+  return left;
+}
+
+static void CheckIndex(DBStorageEngine &engine, const std::vector<int> &ids) {
+  TableInfo *table_info = nullptr;
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("t", table_info));
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("t", "primary", index_info));
+  for (auto id : ids) {
+    std::vector<RowId> result;
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(MakeIntKey(id), result, nullptr));
+    ASSERT_EQ(1, result.size());
+    Row row(result[0]);
+    ASSERT_TRUE(table_info->GetTableHeap()->GetTuple(&row, nullptr));
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, id)));
+  }
+}
+
+TEST(TableVacuumTest, VacuumTableTest) {
+  const int row_nums = 20000;
+  std::vector<int> left;
+  uint32_t pages_before, pages_after;
+  page_id_t pending_page_id;
+  {
+    DBStorageEngine engine(table_vacuum_db_file, true);
+    std::vector<RowId> rids;
+    left = FillAndThin(engine, row_nums, 4, rids);
+    TableInfo *table_info = nullptr;
+    engine.catalog_mgr_->GetTable("t", table_info);
+    TableHeap *table_heap = table_info->GetTableHeap();
+    // a delete that is not applied yet pins its page
+    pending_page_id = rids[row_nums / 2].GetPageId();
+    ASSERT_TRUE(table_heap->MarkDelete(rids[row_nums / 2], nullptr));
+    left.erase(std::find(left.begin(), left.end(), row_nums / 2));
+    pages_before = table_heap->GetPageCount();
+    uint32_t pages_reclaimed = 0, rows_moved = 0;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->VacuumTable("t", pages_reclaimed, rows_moved, nullptr));
+    pages_after = table_heap->GetPageCount();
+    ASSERT_GE(pages_reclaimed, pages_before - pages_after);
+    // a quarter of the rows is left, packed into about a quarter of the pages
+    ASSERT_LT(pages_after, pages_before / 4 + 3);
+    ASSERT_GT(rows_moved, 0);
+    std::vector<page_id_t> page_ids = table_heap->GetPageIds();
+    ASSERT_NE(page_ids.end(), std::find(page_ids.begin(), page_ids.end(), pending_page_id));
+    ASSERT_EQ(left, ScanIds(table_heap));
+    CheckIndex(engine, left);
+    // a second run has nothing left to do
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->VacuumTable("t", pages_reclaimed, rows_moved, nullptr));
+    ASSERT_EQ(0, pages_reclaimed);
+    ASSERT_EQ(0, rows_moved);
+    // the row with the pending delete is still where it was
+    table_heap->RollbackDelete(rids[row_nums / 2], nullptr);
+    Row pending_row(rids[row_nums / 2]);
+    ASSERT_TRUE(table_heap->GetTuple(&pending_row, nullptr));
+    ASSERT_EQ(CmpBool::kTrue, pending_row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, row_nums / 2)));
+    left.insert(std::lower_bound(left.begin(), left.end(), row_nums / 2), row_nums / 2);
+  }
+  DBStorageEngine engine(table_vacuum_db_file, false);
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("t", table_info));
+  ASSERT_EQ(pages_after, table_info->GetTableHeap()->GetPageCount());
+  ASSERT_EQ(left, ScanIds(table_info->GetTableHeap()));
+  CheckIndex(engine, left);
+  // freed space is used again
+  for (int i = row_nums; i < row_nums + 100; i++) {
+    Row row = MakeIdNameRow(i);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+  }
+  ASSERT_EQ(left.size() + 100, ScanIds(table_info->GetTableHeap()).size());
+}
+
+TEST(TableVacuumTest, StaleIndexTest) {
+  const int row_nums = 20000;
+  DBStorageEngine engine(table_vacuum_db_file, true);
+  std::vector<RowId> rids;
+  std::vector<int> left = FillAndThin(engine, row_nums, 4, rids);
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("t", "primary", index_info));
+  // the last row moves to the front, but the index lost its entry and cannot follow
+  ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->RemoveEntry(MakeIntKey(left.back()), rids[left.back()], nullptr));
+  uint32_t pages_reclaimed = 0, rows_moved = 0;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->VacuumTable("t", pages_reclaimed, rows_moved, nullptr));
+  ASSERT_GT(rows_moved, 0);
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("t", table_info));
+  ASSERT_EQ(left, ScanIds(table_info->GetTableHeap()));
+  // the index was built again from the heap, the lost entry included
+  CheckIndex(engine, left);
+}
+
+TEST(TableVacuumTest, AutoVacuumTest) {
+  DBStorageEngine engine(table_vacuum_db_file, true);
+  std::vector<RowId> rids;
+  std::vector<int> left = FillAndThin(engine, 10000, 10, rids);
+  TableInfo *table_info = nullptr;
+  engine.catalog_mgr_->GetTable("t", table_info);
+  uint32_t pages_before = table_info->GetTableHeap()->GetPageCount();
+  engine.StartAutoVacuum(10);
+  for (int i = 0; i < 500 && table_info->GetTableHeap()->GetPageCount() == pages_before; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  engine.StopAutoVacuum();
+  ASSERT_LT(table_info->GetTableHeap()->GetPageCount(), pages_before / 5);
+  ASSERT_EQ(left, ScanIds(table_info->GetTableHeap()));
+  CheckIndex(engine, left);
+}
@@ -0,0 +1,110 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/execute_engine.h"
+#include "gtest/gtest.h"
+#include "utils/sql_test_util.h"
+
+static const std::string truncate_db_file = "truncate_table_test.db";
+
+/** @return the number of rows in t, after checking that the index finds each of them */
+static int CountAndCheck(DBStorageEngine &engine) {
+  TableInfo *table_info = nullptr;
+  IndexInfo *index_info = nullptr;
+  EXPECT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("t", table_info));
+  EXPECT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("t", "primary", index_info));
+  int count = 0;
+  for (auto iter = table_info->GetTableHeap()->Begin(nullptr); iter != table_info->GetTableHeap()->End(); ++iter) {
+    std::vector<RowId> result;
+    int id = std::stoi(iter->GetField(0)->toString());
+    EXPECT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(MakeIntKey(id), result, nullptr));
+    EXPECT_EQ(std::vector<RowId>{iter->GetRowId()}, result);
+    count++;
+  }
+  return count;
+}
+
+TEST(TruncateTableTest, TruncateTableTest) {
+  const int row_nums = 10000;
+  uint32_t pages_empty;
+  {
+    DBStorageEngine engine(truncate_db_file, true);
+    pages_empty = engine.disk_mgr_->GetAllocatedPages(DEFAULT_TABLESPACE_ID);
+    TableInfo *table_info = CreateAndFill(engine, "t", IdRange(0, row_nums));
+    uint32_t pages_full = engine.disk_mgr_->GetAllocatedPages(DEFAULT_TABLESPACE_ID);
+    ASSERT_EQ(row_nums, CountAndCheck(engine));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->TruncateTable("t", nullptr));
+    ASSERT_EQ(DB_TABLE_NOT_EXIST, engine.catalog_mgr_->TruncateTable("missing", nullptr));
+    ASSERT_EQ(0, CountAndCheck(engine));
+    IndexInfo *index_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("t", "primary", index_info));
+    std::vector<RowId> result;
+    ASSERT_EQ(DB_KEY_NOT_FOUND, index_info->GetIndex()->ScanKey(MakeIntKey(5), result, nullptr));
+    // the old pages go back once the reclaimer is done, the new heap and a fresh meta page are all that is left
+    engine.catalog_mgr_->GetPageReclaimer()->Wait();
+    ASSERT_EQ(0, engine.catalog_mgr_->GetPageReclaimer()->GetPendingCount());
+    ASSERT_LT(engine.disk_mgr_->GetAllocatedPages(DEFAULT_TABLESPACE_ID), pages_empty + 10);
+    ASSERT_GT(pages_full, pages_empty + 100);
+    // the table takes rows again, the index grows a new tree
+    for (int i = row_nums; i < row_nums + 100; i++) {
+      Row row = MakeIdNameRow(i);
+      ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+      ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(MakeIntKey(i), row.GetRowId(), nullptr));
+    }
+    ASSERT_EQ(100, CountAndCheck(engine));
+    // a table dropped right after is freed in the background as well
+    CreateAndFill(engine, "d", IdRange(0, row_nums));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->DropTable("d"));
+  }
+  // the catalog waits for the reclaimer before it goes away, the table meta names the new heap
+  DBStorageEngine engine(truncate_db_file, false);
+  ASSERT_EQ(100, CountAndCheck(engine));
+  ASSERT_LT(engine.disk_mgr_->GetAllocatedPages(DEFAULT_TABLESPACE_ID), pages_empty + 20);
+  VacuumStats stats;
+  ASSERT_EQ(DB_SUCCESS, engine.VacuumDatabase(stats));
+  ASSERT_EQ(0, stats.released_pages_);
+  ASSERT_EQ(100, CountAndCheck(engine));
+}
+
+TEST(TruncateTableTest, TruncateStatementTest) {
+  ExecuteEngine engine;
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create database truncate_statement;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "use truncate_statement;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table t(id int, primary key(id));"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into t values(1);"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "truncate table t;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into t values(1);"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "truncate t;"));
+  ASSERT_EQ(DB_TABLE_NOT_EXIST, RunSql(engine, "truncate table missing;"));
+  RunSql(engine, "drop database truncate_statement;");
+}
+
+// drop and truncate return before the pages are freed, the reclaimer frees all of them afterwards
+TEST(TruncateTableTest, DropLargeTableBenchmarkTest) {
+  DBStorageEngine engine("truncate_bench.db", true);
+  PageReclaimer *reclaimer = engine.catalog_mgr_->GetPageReclaimer();
+  for (int row_nums : {1000, 100000}) {
+    uint32_t pages_empty = engine.disk_mgr_->GetAllocatedPages(DEFAULT_TABLESPACE_ID);
+    CreateAndFill(engine, "small", IdRange(0, 10));
+    TableInfo *large = CreateAndFill(engine, "large", IdRange(0, row_nums));
+    uint32_t heap_pages = large->GetTableHeap()->GetPageCount();
+    uint32_t pages_full = engine.disk_mgr_->GetAllocatedPages(DEFAULT_TABLESPACE_ID);
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->TruncateTable("small", nullptr));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->DropTable("large"));
+    auto middle = std::chrono::steady_clock::now();
+    reclaimer->Wait();
+    auto end = std::chrono::steady_clock::now();
+    uint32_t pages_left = engine.disk_mgr_->GetAllocatedPages(DEFAULT_TABLESPACE_ID);
+    std::cout << row_nums << " rows: truncate and drop returned after "
+              << std::chrono::duration<double, std::milli>(middle - start).count() << " ms, pages freed after "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+    // every page of the large heap and its index went to the reclaimer and is free again
+    ASSERT_EQ(0, reclaimer->GetPendingCount());
+    ASSERT_GE(pages_full - pages_left, heap_pages);
+    ASSERT_LT(pages_left, pages_empty + 10);
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->DropTable("small"));
+  }
+}
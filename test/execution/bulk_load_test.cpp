@@ -0,0 +1,245 @@
+#include "executor/bulk_loader.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/execute_engine.h"
+#include "gtest/gtest.h"
+#include "utils/sql_test_util.h"
+
+static const std::string bulk_db_file = "bulk_load_test.db";
+static const std::string bulk_csv_file = "bulk_load_test.csv";
+
+TEST(BulkLoadTest, CsvLoadTest) {
+  DBStorageEngine engine(bulk_db_file, true);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, true),
+                                   new Column("name", TypeId::kTypeChar, 16, 1, false, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, false, false)};
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable("t", new Schema(columns), nullptr, table_info));
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateIndex("t", "primary", {"id"}, nullptr, index_info, "bptree"));
+  {
+    std::ofstream out(bulk_csv_file);
+    out << "3,plain,1.5\n"
+        << "1,\"with, comma\",-2\r\n"
+        << "2,\"say \"\"hi\"\"\",0.25\n"
+        << "\n"
+        << "4,,3\n"
+        << "5,\"\",4";
+  }
+  std::vector<IndexInfo *> indexes;
+  engine.catalog_mgr_->GetTableIndexes("t", indexes);
+  uint64_t row_count = 0;
+  BulkLoader loader(table_info, indexes, nullptr);
+  ASSERT_EQ(DB_SUCCESS, loader.LoadCsv(bulk_csv_file, row_count));
+  ASSERT_EQ(5, row_count);
+  ASSERT_EQ(5, CountRows(table_info->GetTableHeap()));
+  std::vector<std::string> names{"with, comma", "say \"hi\"", "plain", "", ""};
+  for (int id = 1; id <= 5; id++) {
+    std::vector<Field> key_fields{Field(TypeId::kTypeInt, id)};
+    std::vector<RowId> result;
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(Row(key_fields), result, nullptr));
+    ASSERT_EQ(1, result.size());
+    Row row(result[0]);
+    ASSERT_TRUE(table_info->GetTableHeap()->GetTuple(&row, nullptr));
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, id)));
+    ASSERT_EQ(names[id - 1], std::string(row.GetField(1)->GetData(), row.GetField(1)->GetLength()));
+  }
+  // a duplicate key or a malformed line rejects the whole file
+  for (std::string content : {"6,a,1\n7,b,2\n3,c,3\n", "8,a,1\n9,b\n", "10,a,1\n11,b,x\n"}) {
+    {
+      std::ofstream out(bulk_csv_file);
+      out << content;
+    }
+    BulkLoader failed_loader(table_info, indexes, nullptr);
+    ASSERT_EQ(DB_FAILED, failed_loader.LoadCsv(bulk_csv_file, row_count));
+    ASSERT_EQ(5, CountRows(table_info->GetTableHeap()));
+  }
+  std::vector<Field> key_fields{Field(TypeId::kTypeInt, 6)};
+  std::vector<RowId> result;
+  index_info->GetIndex()->ScanKey(Row(key_fields), result, nullptr);
+  ASSERT_TRUE(result.empty());
+  remove(bulk_csv_file.c_str());
+}
+
+TEST(BulkLoadTest, IndexFailureTest) {
+  DBStorageEngine engine(bulk_db_file, true);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, true),
+                                   new Column("name", TypeId::kTypeChar, 16, 1, false, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, false, false)};
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable("t", new Schema(columns), nullptr, table_info));
+  IndexInfo *id_index = nullptr, *name_index = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateIndex("t", "primary", {"id"}, nullptr, id_index, "bptree"));
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateIndex("t", "name_index", {"name"}, nullptr, name_index, "bptree"));
+  std::vector<IndexInfo *> indexes;
+  engine.catalog_mgr_->GetTableIndexes("t", indexes);
+  uint64_t row_count = 0;
+  auto load = [&](const std::string &content) {
+    {
+      std::ofstream out(bulk_csv_file);
+      out << content;
+    }
+    BulkLoader loader(table_info, indexes, nullptr);
+    return loader.LoadCsv(bulk_csv_file, row_count);
+  };
+  auto scan = [](IndexInfo *index_info, const Row &key) {
+    std::vector<RowId> result;
+    index_info->GetIndex()->ScanKey(key, result, nullptr);
+    return result;
+  };
+  auto name_key = [](std::string name) {
+    std::vector<Field> key_fields{Field(TypeId::kTypeChar, name.data(), name.size(), true)};
+    return Row(key_fields);
+  };
+  ASSERT_EQ(DB_SUCCESS, load("1,m,1\n2,n,2\n"));
+  std::vector<RowId> m_rids = scan(name_index, name_key("m"));
+  ASSERT_EQ(1, m_rids.size());
+  // the name index is not unique, but the tree cannot hold a key twice: "a" goes in, "m" fails
+  ASSERT_EQ(DB_FAILED, load("3,a,1\n4,m,2\n5,z,3\n"));
+  ASSERT_EQ(2, CountRows(table_info->GetTableHeap()));
+  for (int id = 3; id <= 5; id++) {
+    ASSERT_TRUE(scan(id_index, MakeIntKey(id)).empty());
+  }
+  ASSERT_TRUE(scan(name_index, name_key("a")).empty());
+  ASSERT_TRUE(scan(name_index, name_key("z")).empty());
+  ASSERT_EQ(m_rids, scan(name_index, name_key("m")));
+  ASSERT_EQ(1, scan(id_index, MakeIntKey(1)).size());
+  remove(bulk_csv_file.c_str());
+}
+
+TEST(BulkLoadTest, CopyBenchmarkTest) {
+  const int row_nums = 20000;
+  const std::string script_file = "bulk_load_test.sql";
+  {
+    std::ofstream script(script_file);
+    std::ofstream csv(bulk_csv_file);
+    char name[32];
+    for (int i = 0; i < row_nums; i++) {
+      snprintf(name, sizeof(name), "name%08d", i);
+      script << "insert into scripted values(" << i << ", \"" << name << "\", " << i % 1000 << ".5);\n";
+      csv << i << "," << name << "," << i % 1000 << ".5\n";
+    }
+  }
+  ExecuteEngine engine;
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create database bulk_load_bench;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "use bulk_load_bench;"));
+  for (std::string table_name : {"scripted", "copied"}) {
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table " + table_name +
+                                             "(id int, name char(16), account float, primary key(id));"));
+  }
+  auto start = std::chrono::steady_clock::now();
+  // the statements echo to stdout, which is part of what a script costs
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "execfile \"" + script_file + "\";"));
+  auto middle = std::chrono::steady_clock::now();
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "copy copied from \"" + bulk_csv_file + "\";"));
+  auto end = std::chrono::steady_clock::now();
+  double script_ms = std::chrono::duration<double, std::milli>(middle - start).count();
+  double copy_ms = std::chrono::duration<double, std::milli>(end - middle).count();
+  std::cout << row_nums << " rows: execfile " << script_ms << " ms (" << row_nums / script_ms * 1000
+            << " rows/s), copy " << copy_ms << " ms (" << row_nums / copy_ms * 1000 << " rows/s), "
+            << script_ms / copy_ms << "x" << std::endl;
+  remove(script_file.c_str());
+  remove(bulk_csv_file.c_str());
+}
+
+static void WriteBulkCsv(int row_nums) {
+  std::ofstream csv(bulk_csv_file);
+  for (int i = 0; i < row_nums; i++) {
+    csv << i << ",name" << i << "," << i % 1000 << ".5\n";
+  }
+}
+
+TEST(BulkLoadTest, InsertSelectTest) {
+  const int row_nums = 1000;
+  WriteBulkCsv(row_nums);
+  {
+    ExecuteEngine engine;
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create database insert_select;"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "use insert_select;"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table src(id int, name char(16), account float, primary key(id));"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "copy src from \"" + bulk_csv_file + "\";"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table copy_all as select * from src;"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table copy_some engine = lsm as select name, id from src where id < 100;"));
+    ASSERT_EQ(DB_TABLE_ALREADY_EXIST, RunSql(engine, "create table copy_all as select * from src;"));
+    ASSERT_EQ(DB_FAILED, RunSql(engine, "create table bad as select id, id from src;"));
+    ASSERT_EQ(DB_FAILED, RunSql(engine, "create table bad as select * from missing;"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table keyed(id int, name char(16), account float, primary key(id));"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into keyed select * from src where id >= 500;"));
+    // a duplicate key, a value too long for its column or columns that do not match insert nothing
+    ASSERT_EQ(DB_FAILED, RunSql(engine, "insert into keyed select * from src;"));
+    ASSERT_EQ(DB_FAILED, RunSql(engine, "insert into keyed select name, id from copy_some;"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table narrow(id int, name char(6));"));
+    ASSERT_EQ(DB_FAILED, RunSql(engine, "insert into narrow select id, name from src;"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into narrow select id, name from src where id < 100;"));
+    // the rows a select reads from the table it inserts into are all read before the first one is written
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into copy_all select * from copy_all;"));
+  }
+  {
+    DBStorageEngine engine("insert_select", false);
+    CatalogManager *catalog = engine.catalog_mgr_;
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_TABLE_NOT_EXIST, catalog->GetTable("bad", table_info));
+    ASSERT_EQ(DB_SUCCESS, catalog->GetTable("copy_all", table_info));
+    ASSERT_EQ(2 * row_nums, CountRows(table_info->GetTableHeap()));
+    ASSERT_EQ(DB_SUCCESS, catalog->GetTable("copy_some", table_info));
+    ASSERT_EQ(100, CountRows(table_info->GetTableHeap()));
+    ASSERT_EQ(TableStorage::kLsm, table_info->GetTableHeap()->GetStorage());
+    ASSERT_EQ("name", table_info->GetSchema()->GetColumn(0)->GetName());
+    ASSERT_EQ(16, table_info->GetSchema()->GetColumn(0)->GetLength());
+    ASSERT_EQ(DB_SUCCESS, catalog->GetTable("narrow", table_info));
+    ASSERT_EQ(100, CountRows(table_info->GetTableHeap()));
+    ASSERT_EQ(DB_SUCCESS, catalog->GetTable("keyed", table_info));
+    ASSERT_EQ(row_nums / 2, CountRows(table_info->GetTableHeap()));
+    // the index was built from the sorted keys of the selected rows
+    IndexInfo *index_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, catalog->GetIndex("keyed", "primary", index_info));
+    for (int id = 0; id < row_nums; id += 7) {
+      std::vector<RowId> result;
+      index_info->GetIndex()->ScanKey(MakeIntKey(id), result, nullptr);
+      ASSERT_EQ(id >= row_nums / 2 ? 1 : 0, result.size());
+    }
+  }
+  DiskManager::RemoveDatabaseFiles("./databases/insert_select");
+  remove(bulk_csv_file.c_str());
+}
+
+TEST(BulkLoadTest, InsertSelectBenchmarkTest) {
+  const int row_nums = 20000;
+  const std::string script_file = "bulk_load_test.sql";
+  WriteBulkCsv(row_nums);
+  {
+    std::ofstream script(script_file);
+    for (int i = 0; i < row_nums; i++) {
+      script << "insert into scripted values(" << i << ", \"name" << i << "\", " << i % 1000 << ".5);\n";
+    }
+  }
+  ExecuteEngine engine;
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create database insert_select_bench;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "use insert_select_bench;"));
+  for (std::string table_name : {"src", "scripted", "selected"}) {
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table " + table_name +
+                                             "(id int, name char(16), account float, primary key(id));"));
+  }
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "copy src from \"" + bulk_csv_file + "\";"));
+  // the script is what copying a table took before: the rows exported as statements and replayed one by one
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "execfile \"" + script_file + "\";"));
+  auto scripted = std::chrono::steady_clock::now();
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into selected select * from src;"));
+  auto selected = std::chrono::steady_clock::now();
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table created as select * from src;"));
+  auto created = std::chrono::steady_clock::now();
+  double script_ms = std::chrono::duration<double, std::milli>(scripted - start).count();
+  double select_ms = std::chrono::duration<double, std::milli>(selected - scripted).count();
+  double create_ms = std::chrono::duration<double, std::milli>(created - selected).count();
+  std::cout << row_nums << " rows: execfile " << script_ms << " ms, insert ... select " << select_ms
+            << " ms, create table ... as select " << create_ms << " ms, " << script_ms / select_ms << "x" << std::endl;
+  RunSql(engine, "drop database insert_select_bench;");
+  remove(script_file.c_str());
+  remove(bulk_csv_file.c_str());
+}
@@ -1,6 +1,7 @@
 //
 // Created by njz on 2023/1/26.
 //
+#include "executor/executors/seq_scan_executor.h"
 #include "executor/plans/delete_plan.h"
 #include "executor/plans/insert_plan.h"
 #include "executor/plans/seq_scan_plan.h"
@@ -155,3 +156,65 @@ TEST_F(ExecutorTest, SimpleUpdateTest) {
     ASSERT_TRUE(row.GetField(1)->CompareEquals(Field(kTypeChar, const_cast<char *>("minisql"), 7, false)));
   }
 }
+
+// SELECT id FROM c WHERE ..., on a heap stored by column against the same rows stored by row
+TEST_F(ExecutorTest, ColumnSeqScanTest) {
+  const int row_nums = 5000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("score", TypeId::kTypeFloat, 1, false, false)};
+  TableInfo *row_table = nullptr;
+  TableInfo *column_table = nullptr;
+  CatalogManager *catalog = GetExecutorContext()->GetCatalog();
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("r", new Schema(columns), GetTxn(), row_table));
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("c", Schema::DeepCopySchema(row_table->GetSchema()), GetTxn(),
+                                             column_table, DEFAULT_TABLESPACE_ID, TableStorage::kColumn));
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeFloat, (i % 100) * 0.5f)};
+    Row row(fields);
+    ASSERT_TRUE(row_table->GetTableHeap()->InsertTuple(row, nullptr));
+    ASSERT_TRUE(column_table->GetTableHeap()->InsertTuple(row, nullptr));
+  }
+  const Schema *schema = column_table->GetSchema();
+  auto col_id = MakeColumnValueExpression(*schema, 0, "id");
+  auto col_score = MakeColumnValueExpression(*schema, 0, "score");
+  auto int_const = [this](int value) { return MakeConstantValueExpression(Field(kTypeInt, value)); };
+  auto float_const = [this](float value) { return MakeConstantValueExpression(Field(kTypeFloat, value)); };
+  auto scan = [&](const std::string &table_name, const AbstractExpressionRef &predicate, bool column_scan) {
+    SeqScanPlanNode plan(MakeOutputSchema({{"id", col_id}}), table_name, predicate);
+    SeqScanExecutor executor(GetExecutorContext(), &plan);
+    executor.Init();
+    EXPECT_EQ(column_scan, executor.UsesColumnScan());
+    std::vector<int> ids;
+    Row row;
+    RowId rid;
+    while (executor.Next(&row, &rid)) {
+      ids.push_back(std::stoi(row.GetField(0)->toString()));
+    }
+    return ids;
+  };
+  auto range = std::make_shared<LogicExpression>(MakeComparisonExpression(col_id, int_const(1000), ">="),
+                                                 MakeComparisonExpression(col_score, float_const(10.f), "<"),
+                                                 LogicType::And);
+  auto flipped = MakeComparisonExpression(int_const(4000), col_id, "<=");
+  auto not_equal = MakeComparisonExpression(col_score, float_const(0.f), "<>");
+  // an or is evaluated row by row
+  auto either = std::make_shared<LogicExpression>(MakeComparisonExpression(col_id, int_const(10), "<"),
+                                                  MakeComparisonExpression(col_id, int_const(4990), ">"), LogicType::Or);
+  std::vector<std::pair<AbstractExpressionRef, bool>> predicates = {
+      {range, true}, {flipped, true}, {not_equal, true}, {either, false}};
+  for (auto &predicate : predicates) {
+    std::vector<int> expected = scan("r", predicate.first, false);
+    ASSERT_FALSE(expected.empty());
+    ASSERT_EQ(expected, scan("c", predicate.first, predicate.second));
+  }
+  // deleted rows are not selected
+  std::vector<int> before = scan("c", range, true);
+  TableHeap *column_heap = column_table->GetTableHeap();
+  for (auto iter = column_heap->Begin(nullptr); iter != column_heap->End(); ++iter) {
+    if (std::stoi(iter->GetField(0)->toString()) == before.front()) {
+      ASSERT_TRUE(column_heap->MarkDelete(iter->GetRowId(), nullptr));
+      break;
+    }
+  }
+  ASSERT_EQ(std::vector<int>(before.begin() + 1, before.end()), scan("c", range, true));
+}
@@ -0,0 +1,132 @@
+#include "executor/executors/parallel_seq_scan_executor.h"
+
+#include <chrono>
+#include <thread>
+
+#include "executor_test_util.h"  // NOLINT
+#include "utils/sql_test_util.h"
+
+// SELECT id, name FROM table-1 WHERE id < 2500 on several threads returns what the serial scan returns
+TEST_F(ExecutorTest, ParallelSeqScanTest) {
+  TableInfo *table_info;
+  GetExecutorContext()->GetCatalog()->GetTable("table-1", table_info);
+  // grow the table to several morsels, so every thread gets work
+  for (int i = 1000; i < 5000; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, const_cast<char *>("name"), 4, true),
+                  Field(TypeId::kTypeFloat, 1.f)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+  }
+  ASSERT_GT(table_info->GetTableHeap()->GetPageCount(), 2 * SCAN_MORSEL_PAGES);
+  const Schema *schema = table_info->GetSchema();
+  auto col_a = MakeColumnValueExpression(*schema, 0, "id");
+  auto col_b = MakeColumnValueExpression(*schema, 0, "name");
+  auto const2500 = MakeConstantValueExpression(Field(kTypeInt, 2500));
+  auto predicate = MakeComparisonExpression(col_a, const2500, "<");
+  auto out_schema = MakeOutputSchema({{"id", col_a}, {"name", col_b}});
+  auto plan = make_shared<SeqScanPlanNode>(out_schema, table_info->GetTableName(), predicate);
+  std::vector<Row> serial_result;
+  GetExecutionEngine()->ExecutePlan(plan, &serial_result, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(2500, serial_result.size());
+  for (uint32_t threads : {2, 4, 16}) {
+    GetExecutorContext()->SetScanThreads(threads);
+    std::vector<Row> result;
+    GetExecutionEngine()->ExecutePlan(plan, &result, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(serial_result.size(), result.size());
+    for (size_t i = 0; i < result.size(); i++) {
+      ASSERT_EQ(CmpBool::kTrue, serial_result[i].GetField(0)->CompareEquals(*result[i].GetField(0)));
+      ASSERT_EQ(CmpBool::kTrue, serial_result[i].GetField(1)->CompareEquals(*result[i].GetField(1)));
+    }
+  }
+}
+
+// SELECT id, account FROM bench WHERE account < 0 at 1 to 16 threads
+TEST_F(ExecutorTest, ParallelSeqScanBenchmarkTest) {
+  const int row_nums = 400000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 32, 1, false, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, false, false)};
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, GetExecutorContext()->GetCatalog()->CreateTable("bench", new Schema(columns), GetTxn(),
+                                                                        table_info));
+  char name[33];
+  for (int i = 0; i < row_nums; i++) {
+    snprintf(name, sizeof(name), "%032d", i);
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 32, true),
+                  Field(TypeId::kTypeFloat, static_cast<float>(i % 200 - 100))};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+  }
+  const Schema *schema = table_info->GetSchema();
+  auto col_id = MakeColumnValueExpression(*schema, 0, "id");
+  auto col_account = MakeColumnValueExpression(*schema, 0, "account");
+  auto predicate = MakeComparisonExpression(col_account, MakeConstantValueExpression(Field(kTypeFloat, 0.f)), "<");
+  auto out_schema = MakeOutputSchema({{"id", col_id}, {"account", col_account}});
+  auto plan = make_shared<SeqScanPlanNode>(out_schema, table_info->GetTableName(), predicate);
+  std::vector<double> scan_ms;
+  for (uint32_t threads : {1, 2, 4, 8, 16}) {
+    GetExecutorContext()->SetScanThreads(threads);
+    std::vector<Row> result;
+    auto start = std::chrono::steady_clock::now();
+    GetExecutionEngine()->ExecutePlan(plan, &result, GetTxn(), GetExecutorContext());
+    auto end = std::chrono::steady_clock::now();
+    ASSERT_EQ(row_nums / 2, result.size());
+    scan_ms.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    std::cout << threads << " threads: " << row_nums / scan_ms.back() * 1000 << " tuples/s" << std::endl;
+  }
+}
+
+// the rows of the first morsels come out while the others are scanned, and a scan left early stops its workers
+TEST_F(ExecutorTest, ParallelSeqScanEarlyStopTest) {
+  TableInfo *table_info;
+  GetExecutorContext()->GetCatalog()->GetTable("table-1", table_info);
+  for (int i = 1000; i < 20000; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, const_cast<char *>("name"), 4, true),
+                  Field(TypeId::kTypeFloat, 1.f)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+  }
+  const Schema *schema = table_info->GetSchema();
+  auto col_a = MakeColumnValueExpression(*schema, 0, "id");
+  auto out_schema = MakeOutputSchema({{"id", col_a}});
+  auto plan = make_shared<SeqScanPlanNode>(out_schema, table_info->GetTableName(), nullptr);
+  GetExecutorContext()->SetScanThreads(4);
+  for (int taken : {0, 1, 100}) {
+    auto executor = std::make_unique<ParallelSeqScanExecutor>(GetExecutorContext(), plan.get());
+    executor->Init();
+    Row row;
+    RowId rid;
+    for (int i = 0; i < taken; i++) {
+      ASSERT_TRUE(executor->Next(&row, &rid));
+    }
+  }
+  // Init restarts a scan that is still running
+  ParallelSeqScanExecutor executor(GetExecutorContext(), plan.get());
+  Row row;
+  RowId rid;
+  executor.Init();
+  ASSERT_TRUE(executor.Next(&row, &rid));
+  executor.Init();
+  int count = 0;
+  while (executor.Next(&row, &rid)) {
+    count++;
+  }
+  ASSERT_EQ(CountRows(table_info->GetTableHeap()), count);
+}
+
+TEST(ParallelSeqScanSettingTest, SetScanThreadsTest) {
+  ExecuteEngine engine;
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "set scan_threads = 4;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create database scan_threads_test;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "use scan_threads_test;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table t(id int, name char(16));"));
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into t values(" + std::to_string(i) + ", \"name\");"));
+  }
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "select * from t where id < 50;"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "set scan_threads = 0;"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "set scan_threads = 1000;"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "set scan_thread = 2;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "set scan_threads = 1;"));
+  RunSql(engine, "drop database scan_threads_test;");
+}
@@ -0,0 +1,100 @@
+#include "executor/executors/update_executor.h"
+
+#include <chrono>
+#include <string>
+
+#include "executor/plans/update_plan.h"
+#include "executor_test_util.h"  // NOLINT
+
+// UPDATE table-1 SET name = "minisql" WHERE id < 500, then UPDATE table-1 SET id = 5000 WHERE id = 5
+TEST_F(ExecutorTest, UpdateIndexMaintenanceTest) {
+  TableInfo *table_info;
+  GetExecutorContext()->GetCatalog()->GetTable("table-1", table_info);
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, GetExecutorContext()->GetCatalog()->CreateIndex("table-1", "index-1", {"id"}, GetTxn(),
+                                                                        index_info, "bptree"));
+  const Schema *schema = table_info->GetSchema();
+  auto col_id = MakeColumnValueExpression(*schema, 0, "id");
+  auto scan_plan = make_shared<SeqScanPlanNode>(
+      schema, table_info->GetTableName(),
+      MakeComparisonExpression(col_id, MakeConstantValueExpression(Field(kTypeInt, 500)), "<"));
+  std::unordered_map<uint32_t, AbstractExpressionRef> update_attrs{};
+  update_attrs.emplace(1, MakeConstantValueExpression(Field(kTypeChar, const_cast<char *>("minisql"), 7, false)));
+  std::vector<Row> result_set{};
+  GetExecutionEngine()->ExecutePlan(std::make_shared<UpdatePlanNode>(schema, scan_plan, "table-1", update_attrs),
+                                    &result_set, GetTxn(), GetExecutorContext());
+  // the key did not change, so the index was left alone
+  ASSERT_EQ(0, GetExecutorContext()->GetIndexWrites());
+  ASSERT_EQ(2 * 500, GetExecutorContext()->GetIndexWritesSaved());
+
+  auto id_scan_plan = make_shared<SeqScanPlanNode>(
+      schema, table_info->GetTableName(),
+      MakeComparisonExpression(col_id, MakeConstantValueExpression(Field(kTypeInt, 5)), "="));
+  std::unordered_map<uint32_t, AbstractExpressionRef> id_attrs{};
+  id_attrs.emplace(0, MakeConstantValueExpression(Field(kTypeInt, 5000)));
+  GetExecutionEngine()->ExecutePlan(std::make_shared<UpdatePlanNode>(schema, id_scan_plan, "table-1", id_attrs),
+                                    &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(2, GetExecutorContext()->GetIndexWrites());
+  std::vector<RowId> rids;
+  Fields old_key{Field(kTypeInt, 5)};
+  index_info->GetIndex()->ScanKey(Row(old_key), rids, GetTxn());
+  ASSERT_TRUE(rids.empty());
+  Fields new_key{Field(kTypeInt, 5000)};
+  ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(Row(new_key), rids, GetTxn()));
+  ASSERT_EQ(1, rids.size());
+  Row row(rids[0]);
+  ASSERT_TRUE(table_info->GetTableHeap()->GetTuple(&row, GetTxn()));
+  ASSERT_EQ(CmpBool::kTrue, row.GetField(1)->CompareEquals(Field(kTypeChar, const_cast<char *>("minisql"), 7, false)));
+}
+
+// UPDATE bench SET name = <200 characters>, every row outgrows its page
+TEST_F(ExecutorTest, UpdateBenchmarkTest) {
+  const int row_nums = 20000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 255, 1, false, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, false, false)};
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, GetExecutorContext()->GetCatalog()->CreateTable("bench", new Schema(columns), GetTxn(),
+                                                                        table_info));
+  char name[9];
+  for (int i = 0; i < row_nums; i++) {
+    snprintf(name, sizeof(name), "%08d", i);
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 8, true),
+                  Field(TypeId::kTypeFloat, static_cast<float>(i))};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+  }
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, GetExecutorContext()->GetCatalog()->CreateIndex("bench", "bench_id", {"id"}, GetTxn(),
+                                                                        index_info, "bptree"));
+  uint32_t page_count = table_info->GetTableHeap()->GetPageCount();
+  const Schema *schema = table_info->GetSchema();
+  std::string long_name(200, 'x');
+  std::unordered_map<uint32_t, AbstractExpressionRef> update_attrs{};
+  update_attrs.emplace(1, MakeConstantValueExpression(Field(kTypeChar, const_cast<char *>(long_name.c_str()),
+                                                            long_name.size(), false)));
+  auto scan_plan = make_shared<SeqScanPlanNode>(schema, table_info->GetTableName(), nullptr);
+  std::vector<Row> result_set{};
+  auto start = std::chrono::steady_clock::now();
+  GetExecutionEngine()->ExecutePlan(std::make_shared<UpdatePlanNode>(schema, scan_plan, "bench", update_attrs),
+                                    &result_set, GetTxn(), GetExecutorContext());
+  auto end = std::chrono::steady_clock::now();
+  double update_ms = std::chrono::duration<double, std::milli>(end - start).count();
+  std::cout << row_nums << " updates in " << update_ms << " ms, heap " << page_count << " -> "
+            << table_info->GetTableHeap()->GetPageCount() << " pages, index writes "
+            << GetExecutorContext()->GetIndexWrites() << ", saved " << GetExecutorContext()->GetIndexWritesSaved()
+            << std::endl;
+  // every row moved, none was updated twice and the index still finds all of them
+  ASSERT_GT(table_info->GetTableHeap()->GetPageCount(), 2 * page_count);
+  ASSERT_EQ(0, GetExecutorContext()->GetIndexWrites());
+  ASSERT_EQ(2 * row_nums, GetExecutorContext()->GetIndexWritesSaved());
+  for (int i = 0; i < row_nums; i += 97) {
+    std::vector<RowId> rids;
+    Fields key{Field(kTypeInt, i)};
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(Row(key), rids, GetTxn()));
+    ASSERT_EQ(1, rids.size());
+    Row row(rids[0]);
+    ASSERT_TRUE(table_info->GetTableHeap()->GetTuple(&row, GetTxn()));
+    ASSERT_EQ(long_name.size(), row.GetField(1)->GetLength());
+  }
+}
@@ -0,0 +1,140 @@
+#include "storage/zone_map.h"
+
+#include <chrono>
+
+#include "executor/executors/seq_scan_executor.h"
+#include "planner/expressions/logic_expression.h"
+#include "executor_test_util.h"  // NOLINT
+
+static TableInfo *MakeTimeSeriesTable(ExecutorTest *test, const std::string &name, int row_nums) {
+  std::vector<Column *> columns = {new Column("ts", TypeId::kTypeInt, 0, false, false),
+                                   new Column("shuffled", TypeId::kTypeInt, 1, false, false),
+                                   new Column("value", TypeId::kTypeFloat, 2, false, false),
+                                   new Column("tag", TypeId::kTypeChar, 8, 3, false, false)};
+  TableInfo *table_info = nullptr;
+  EXPECT_EQ(DB_SUCCESS, test->GetExecutorContext()->GetCatalog()->CreateTable(name, new Schema(columns),
+                                                                              test->GetTxn(), table_info));
+  // room for any int, the tags used stay below eight characters
+  char tag[16];
+  for (int i = 0; i < row_nums; i++) {
+    snprintf(tag, sizeof(tag), "t%07d", i);
+    // the same values as ts, spread over the whole table
+    int shuffled = static_cast<int>((static_cast<int64_t>(i) * 7919) % row_nums);
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeInt, shuffled),
+                  Field(TypeId::kTypeFloat, i * 0.5f), Field(TypeId::kTypeChar, tag, 8, true)};
+    Row row(fields);
+    EXPECT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+  }
+  return table_info;
+}
+
+/** Run a scan of ts with the predicate, @return the ts values found */
+static std::vector<int> ScanTimeSeries(ExecutorTest *test, TableInfo *table_info, const AbstractExpressionRef &predicate,
+                                       size_t *pages_skipped = nullptr) {
+  auto col_ts = test->MakeColumnValueExpression(*table_info->GetSchema(), 0, "ts");
+  auto out_schema = test->MakeOutputSchema({{"ts", col_ts}});
+  SeqScanPlanNode plan(out_schema, table_info->GetTableName(), predicate);
+  SeqScanExecutor executor(test->GetExecutorContext(), &plan);
+  executor.Init();
+  std::vector<int> result;
+  Row row;
+  RowId rid;
+  while (executor.Next(&row, &rid)) {
+    result.push_back(std::stoi(row.GetField(0)->toString()));
+  }
+  if (pages_skipped != nullptr) {
+    *pages_skipped = executor.GetPagesSkipped();
+  }
+  return result;
+}
+
+TEST_F(ExecutorTest, ZoneMapTest) {
+  const int row_nums = 20000;
+  TableInfo *table_info = MakeTimeSeriesTable(this, "series", row_nums);
+  TableHeap *table_heap = table_info->GetTableHeap();
+  const Schema *schema = table_info->GetSchema();
+  auto col_ts = MakeColumnValueExpression(*schema, 0, "ts");
+  auto col_value = MakeColumnValueExpression(*schema, 0, "value");
+  auto col_tag = MakeColumnValueExpression(*schema, 0, "tag");
+  auto int_const = [this](int value) { return MakeConstantValueExpression(Field(kTypeInt, value)); };
+  // a narrow range of ts reads a page or two
+  size_t pages_skipped;
+  auto range = std::make_shared<LogicExpression>(MakeComparisonExpression(col_ts, int_const(5000), ">="),
+                                   MakeComparisonExpression(col_ts, int_const(5100), "<"), LogicType::And);
+  std::vector<int> result = ScanTimeSeries(this, table_info, range, &pages_skipped);
+  ASSERT_EQ(100, result.size());
+  ASSERT_EQ(5000, result.front());
+  ASSERT_GT(pages_skipped + 3, table_heap->GetPageCount());
+  // floats, a constant on the left and chars
+  auto value_range = MakeComparisonExpression(col_value, MakeConstantValueExpression(Field(kTypeFloat, 10.f)), "<=");
+  ASSERT_EQ(21, ScanTimeSeries(this, table_info, value_range).size());
+  ASSERT_EQ(100, ScanTimeSeries(this, table_info, MakeComparisonExpression(int_const(100), col_ts, ">")).size());
+  char tag[] = "t0012345";
+  auto tag_equal = MakeComparisonExpression(col_tag, MakeConstantValueExpression(Field(kTypeChar, tag, 8, true)), "=");
+  result = ScanTimeSeries(this, table_info, tag_equal, &pages_skipped);
+  ASSERT_EQ(std::vector<int>{12345}, result);
+  ASSERT_GT(pages_skipped + 3, table_heap->GetPageCount());
+  // a page is skipped only if both sides of an or rule it out
+  auto ends = std::make_shared<LogicExpression>(MakeComparisonExpression(col_ts, int_const(10), "<"),
+                                  MakeComparisonExpression(col_ts, int_const(row_nums - 10), ">="), LogicType::Or);
+  ASSERT_EQ(20, ScanTimeSeries(this, table_info, ends).size());
+  // the parallel scan skips the same pages
+  GetExecutorContext()->SetScanThreads(4);
+  std::vector<Row> parallel_result;
+  auto plan = std::make_shared<SeqScanPlanNode>(MakeOutputSchema({{"ts", col_ts}}), "series", range);
+  GetExecutionEngine()->ExecutePlan(plan, &parallel_result, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(100, parallel_result.size());
+  GetExecutorContext()->SetScanThreads(1);
+  // rows written after the map was built widen the ranges of their pages
+  char new_tag[] = "new";
+  Fields update_fields{Field(TypeId::kTypeInt, 1000000), Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeFloat, 0.f),
+                       Field(TypeId::kTypeChar, new_tag, 3, true)};
+  Row updated(update_fields);
+  ASSERT_TRUE(table_heap->UpdateTuple(updated, table_heap->Begin(nullptr)->GetRowId(), nullptr));
+  Fields insert_fields{Field(TypeId::kTypeInt, -5), Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeFloat, 0.f),
+                       Field(TypeId::kTypeChar, new_tag, 3, true)};
+  Row inserted(insert_fields);
+  ASSERT_TRUE(table_heap->InsertTuple(inserted, nullptr));
+  ASSERT_EQ(std::vector<int>{1000000}, ScanTimeSeries(this, table_info, MakeComparisonExpression(col_ts, int_const(row_nums), ">")));
+  ASSERT_EQ(std::vector<int>{-5}, ScanTimeSeries(this, table_info, MakeComparisonExpression(col_ts, int_const(0), "<")));
+  // a rolled back delete brings back a row the map may not have seen
+  RowId rid = inserted.GetRowId();
+  ASSERT_TRUE(table_heap->MarkDelete(rid, nullptr));
+  ASSERT_TRUE(ScanTimeSeries(this, table_info, MakeComparisonExpression(col_ts, int_const(0), "<")).empty());
+  table_heap->RollbackDelete(rid, nullptr);
+  ASSERT_EQ(std::vector<int>{-5}, ScanTimeSeries(this, table_info, MakeComparisonExpression(col_ts, int_const(0), "<")));
+}
+
+// SELECT ts FROM series WHERE ts >= x AND ts < x + 1000, against the same range of a column in random order
+TEST_F(ExecutorTest, ZoneMapBenchmarkTest) {
+  const int row_nums = 200000;
+  const int width = 1000;
+  TableInfo *table_info = MakeTimeSeriesTable(this, "bench", row_nums);
+  const Schema *schema = table_info->GetSchema();
+  auto range_of = [&](const std::string &column) {
+    auto col = MakeColumnValueExpression(*schema, 0, column);
+    return std::make_shared<LogicExpression>(
+        MakeComparisonExpression(col, MakeConstantValueExpression(Field(kTypeInt, row_nums / 2)), ">="),
+        MakeComparisonExpression(col, MakeConstantValueExpression(Field(kTypeInt, row_nums / 2 + width)), "<"), LogicType::And);
+  };
+  // the first scan builds the zone map
+  ScanTimeSeries(this, table_info, range_of("ts"));
+  auto start = std::chrono::steady_clock::now();
+  size_t pages_skipped;
+  std::vector<int> pruned = ScanTimeSeries(this, table_info, range_of("ts"), &pages_skipped);
+  auto middle = std::chrono::steady_clock::now();
+  size_t full_pages_skipped;
+  std::vector<int> full = ScanTimeSeries(this, table_info, range_of("shuffled"), &full_pages_skipped);
+  auto end = std::chrono::steady_clock::now();
+  double pruned_ms = std::chrono::duration<double, std::milli>(middle - start).count();
+  double full_ms = std::chrono::duration<double, std::milli>(end - middle).count();
+  std::cout << row_nums << " rows in " << table_info->GetTableHeap()->GetPageCount() << " pages: time range "
+            << pruned_ms << " ms skipping " << pages_skipped << " pages, unordered range " << full_ms << " ms, "
+            << full_ms / pruned_ms << "x" << std::endl;
+  ASSERT_EQ(width, pruned.size());
+  ASSERT_EQ(width, full.size());
+  // the time range lies on a few pages next to each other, the unordered one on all of them
+  uint32_t page_count = table_info->GetTableHeap()->GetPageCount();
+  ASSERT_GT(pages_skipped * 10, page_count * 9);
+  ASSERT_EQ(0, full_pages_skipped);
+}
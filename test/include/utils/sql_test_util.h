@@ -0,0 +1,112 @@
+#ifndef MINISQL_SQL_TEST_UTIL_H
+#define MINISQL_SQL_TEST_UTIL_H
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "common/instance.h"
+#include "executor/execute_engine.h"
+#include "gtest/gtest.h"
+
+extern "C" {
+int yyparse(void);
+#include "parser/minisql_lex.h"
+#include "parser/parser.h"
+}
+
+/**
+ * Parse one statement and call run with its syntax tree, or with nullptr if it does not parse.
+ * @return what run returns
+ */
+template <typename Func>
+auto WithSyntaxTree(const std::string &sql, Func run) {
+  YY_BUFFER_STATE bp = yy_scan_string(sql.c_str());
+  yy_switch_to_buffer(bp);
+  MinisqlParserInit();
+  yyparse();
+  auto result = run(MinisqlParserGetError() ? nullptr : MinisqlGetParserRootNode());
+  MinisqlParserFinish();
+  yy_delete_buffer(bp);
+  yylex_destroy();
+  return result;
+}
+
+/** Run one statement the way the shell does. */
+inline dberr_t RunSql(ExecuteEngine &engine, const std::string &sql) {
+  return WithSyntaxTree(sql, [&engine](pSyntaxNode ast) { return ast == nullptr ? DB_FAILED : engine.Execute(ast); });
+}
+
+inline Row MakeIntKey(int value) {
+  std::vector<Field> key_fields{Field(TypeId::kTypeInt, value)};
+  return Row(key_fields);
+}
+
+inline int ReadInt(const Field *field) {
+  char buf[sizeof(int32_t)];
+  field->SerializeTo(buf);
+  return MACH_READ_INT32(buf);
+}
+
+/** A row of id and a name that is the id padded with zeros to name_length characters. */
+inline Row MakeIdNameRow(int id, int name_length = 64) {
+  std::string name(name_length + 1, '\0');
+  snprintf(name.data(), name.size(), "%0*d", name_length, id);
+  std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, name.data(), name_length, true)};
+  return Row(fields);
+}
+
+/** The schema of MakeIdNameRow, with a unique id. */
+inline Schema *MakeIdNameSchema(uint32_t name_length = 64) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, true),
+                                   new Column("name", TypeId::kTypeChar, name_length, 1, false, false)};
+  return new Schema(columns);
+}
+
+inline int CountRows(TableHeap *table_heap) {
+  int count = 0;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+    count++;
+  }
+  return count;
+}
+
+/** @return the ids from first up to last */
+inline std::vector<int> IdRange(int first, int last) {
+  std::vector<int> ids;
+  for (int id = first; id < last; id++) {
+    ids.push_back(id);
+  }
+  return ids;
+}
+
+/** @return the ids from 0 up to row_nums in an order that only depends on the seed */
+inline std::vector<int> ShuffledIds(int row_nums, unsigned seed) {
+  std::vector<int> ids = IdRange(0, row_nums);
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(seed));
+  return ids;
+}
+
+/**
+ * Create a table of MakeIdNameSchema with an index named primary on id, and insert the rows of the ids in their order.
+ */
+inline TableInfo *CreateAndFill(DBStorageEngine &engine, const std::string &name, const std::vector<int> &ids,
+                                TableStorage storage = TableStorage::kRow, const std::string &index_type = "bptree",
+                                bool temporary = false) {
+  TableInfo *table_info = nullptr;
+  IndexInfo *index_info = nullptr;
+  EXPECT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable(name, MakeIdNameSchema(), nullptr, table_info,
+                                                         DEFAULT_TABLESPACE_ID, storage, temporary));
+  EXPECT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateIndex(name, "primary", {"id"}, nullptr, index_info, index_type));
+  for (auto id : ids) {
+    Row row = MakeIdNameRow(id);
+    EXPECT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+    EXPECT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(MakeIntKey(id), row.GetRowId(), nullptr));
+  }
+  return table_info;
+}
+
+#endif  // MINISQL_SQL_TEST_UTIL_H
@@ -69,4 +69,118 @@ TEST(BPlusTreeTests, SampleTest) {
     ASSERT_TRUE(tree.GetValue(delete_seq[i], ans));
     ASSERT_EQ(kv_map[delete_seq[i]], ans[ans.size() - 1]);
   }
-}
\ No newline at end of file
+}
+
+TEST(BPlusTreeTests, BulkLoadTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {
+      new Column("int", TypeId::kTypeInt, 0, false, false),
+  };
+  Schema *table_schema = new Schema(columns);
+  KeyManager KP(table_schema, 16);
+  // small nodes give a tree of several levels
+  BPlusTree tree(0, engine.bpm_, KP, 8, 8);
+  const int n = 2000;
+  vector<GenericKey *> keys;
+  vector<RowId> values;
+  for (int i = 0; i < n; i++) {
+    GenericKey *key = KP.InitKey();
+    std::vector<Field> fields{Field(TypeId::kTypeInt, 2 * i)};
+    KP.SerializeFromKey(key, Row(fields), table_schema);
+    keys.push_back(key);
+    values.push_back(RowId(2 * i));
+  }
+  ASSERT_TRUE(tree.BulkLoad(keys, values));
+  ASSERT_TRUE(tree.Check());
+  // only an empty tree is built bottom up
+  ASSERT_FALSE(tree.BulkLoad(keys, values));
+  vector<RowId> ans;
+  for (int i = 0; i < n; i++) {
+    ASSERT_TRUE(tree.GetValue(keys[i], ans));
+    ASSERT_EQ(values[i], ans.back());
+  }
+  // the loaded tree takes ordinary inserts and deletes
+  for (int i = 0; i < n; i++) {
+    GenericKey *key = KP.InitKey();
+    std::vector<Field> fields{Field(TypeId::kTypeInt, 2 * i + 1)};
+    KP.SerializeFromKey(key, Row(fields), table_schema);
+    ASSERT_TRUE(tree.Insert(key, RowId(2 * i + 1)));
+    ASSERT_TRUE(tree.GetValue(key, ans));
+  }
+  for (int i = 0; i < n; i += 2) {
+    tree.Remove(keys[i]);
+  }
+  ASSERT_TRUE(tree.Check());
+  for (int i = 0; i < n; i++) {
+    ASSERT_EQ(i % 2 == 1, tree.GetValue(keys[i], ans));
+  }
+  int count = 0;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    count++;
+  }
+  ASSERT_EQ(2 * n - n / 2, count);
+  // a tree built next to this one leaves it as it is until it takes its place
+  page_id_t root_page_id = tree.BuildTree(keys, values);
+  ASSERT_NE(INVALID_PAGE_ID, root_page_id);
+  ASSERT_FALSE(tree.GetValue(keys[0], ans));
+  PageReclaimer *reclaimer = engine.catalog_mgr_->GetPageReclaimer();
+  tree.ReplaceTree(root_page_id, reclaimer);
+  ASSERT_TRUE(tree.Check());
+  count = 0;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter, count++) {
+    ASSERT_EQ(values[count], (*iter).second);
+  }
+  ASSERT_EQ(n, count);
+  // no pairs give a blank root
+  tree.ReplaceTree(tree.BuildTree({}, {}), reclaimer);
+  ASSERT_TRUE(tree.Begin() == tree.End());
+  reclaimer->Wait();
+}
+
+TEST(BPlusTreeTests, RangeDeleteTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {
+      new Column("int", TypeId::kTypeInt, 0, false, false),
+  };
+  Schema *table_schema = new Schema(columns);
+  KeyManager KP(table_schema, 16);
+  // small nodes make every run of deletes merge and borrow on several levels
+  BPlusTree tree(0, engine.bpm_, KP, 6, 6);
+  const int n = 1000;
+  vector<GenericKey *> keys;
+  for (int i = 0; i < n; i++) {
+    GenericKey *key = KP.InitKey();
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    KP.SerializeFromKey(key, Row(fields), table_schema);
+    keys.push_back(key);
+    ASSERT_TRUE(tree.Insert(key, RowId(i)));
+  }
+  // runs of neighbouring keys empty whole pages, from the left end, the middle and the right end
+  auto removed = [](int i) { return i < 150 || (i >= 400 && i < 600) || i >= 900; };
+  for (int i = 0; i < n; i++) {
+    if (removed(i)) {
+      tree.Remove(keys[i]);
+    }
+  }
+  ASSERT_TRUE(tree.Check());
+  vector<RowId> ans;
+  std::vector<int64_t> scanned;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    scanned.push_back((*iter).second.Get());
+  }
+  std::vector<int64_t> expected;
+  for (int i = 0; i < n; i++) {
+    ASSERT_EQ(!removed(i), tree.GetValue(keys[i], ans));
+    if (!removed(i)) {
+      expected.push_back(RowId(i).Get());
+    }
+  }
+  ASSERT_EQ(expected, scanned);
+  // the tree shrinks back to an empty one
+  for (int i = 0; i < n; i++) {
+    if (!removed(i)) {
+      tree.Remove(keys[i]);
+    }
+  }
+  ASSERT_TRUE(tree.IsEmpty());
+}
@@ -0,0 +1,467 @@
+#include "storage/clustered_table.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "catalog/database_vacuum.h"
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/b_plus_tree_index.h"
+#include "page/index_roots_page.h"
+#include "planner/planner.h"
+#include "storage/table_heap.h"
+#include "utils/sql_test_util.h"
+
+static const std::string clustered_db_file = "clustered_table_test.db";
+
+static const index_id_t primary_index_id = 100;
+static const index_id_t code_index_id = 101;
+static const index_id_t name_index_id = 102;
+
+static Schema *MakeClusteredSchema() {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, true),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, false, false),
+                                   new Column("code", TypeId::kTypeInt, 2, false, true)};
+  return new Schema(columns);
+}
+
+static Row MakeClusteredRow(int id, int code, const std::string &prefix = "name") {
+  std::string name = prefix + std::to_string(id);
+  std::vector<Field> fields{Field(TypeId::kTypeInt, id),
+                            Field(TypeId::kTypeChar, const_cast<char *>(name.data()), name.size(), true),
+                            Field(TypeId::kTypeInt, code)};
+  return Row(fields);
+}
+
+static Row MakeCharKey(const std::string &value) {
+  std::vector<Field> fields{Field(TypeId::kTypeChar, const_cast<char *>(value.data()), value.size(), true)};
+  return Row(fields);
+}
+
+static int IntAt(const Row &row, uint32_t index) { return ReadInt(row.GetField(index)); }
+
+/** @return the first column of each row */
+static std::vector<int> Ids(const std::vector<Row> &rows) {
+  std::vector<int> ids;
+  for (auto &row : rows) {
+    ids.push_back(IntAt(row, 0));
+  }
+  return ids;
+}
+
+TEST(ClusteredTableTest, ClusteredTableTest) {
+  const int row_nums = 5000;
+  Schema *schema = MakeClusteredSchema();
+  {
+    DBStorageEngine engine(clustered_db_file, true);
+    std::unique_ptr<ClusteredTable> table(ClusteredTable::Create(engine.bpm_, schema, {0}, primary_index_id));
+    ASSERT_NE(nullptr, table);
+    ASSERT_EQ(DB_SUCCESS, table->CreateSecondaryIndex({2}, code_index_id));
+    for (int id : ShuffledIds(row_nums, 7)) {
+      ASSERT_EQ(DB_SUCCESS, table->InsertRow(MakeClusteredRow(id, id + row_nums), nullptr));
+    }
+    ASSERT_GT(table->GetDepth(), 1);
+    // a taken primary key fails and leaves no secondary entry behind, rows may share a secondary key
+    ASSERT_EQ(DB_FAILED, table->InsertRow(MakeClusteredRow(10, -1), nullptr));
+    std::vector<Row> rows;
+    ASSERT_EQ(DB_SUCCESS, table->GetRowsBySecondary(code_index_id, MakeIntKey(-1), rows, nullptr));
+    ASSERT_TRUE(rows.empty());
+    ASSERT_EQ(DB_SUCCESS, table->InsertRow(MakeClusteredRow(-1, 10 + row_nums), nullptr));
+    ASSERT_EQ(DB_SUCCESS, table->GetRowsBySecondary(code_index_id, MakeIntKey(10 + row_nums), rows, nullptr));
+    ASSERT_EQ((std::vector<int>{-1, 10}), Ids(rows));
+    ASSERT_EQ(DB_SUCCESS, table->RemoveRow(MakeIntKey(-1), nullptr));
+    Row row;
+    ASSERT_EQ(DB_KEY_NOT_FOUND, table->GetRow(MakeIntKey(-1), row, nullptr));
+    for (int id = 0; id < row_nums; id++) {
+      ASSERT_EQ(DB_SUCCESS, table->GetRow(MakeIntKey(id), row, nullptr));
+      ASSERT_EQ(id, IntAt(row, 0));
+      ASSERT_EQ("name" + std::to_string(id), row.GetField(1)->toString());
+      rows.clear();
+      ASSERT_EQ(DB_SUCCESS, table->GetRowsBySecondary(code_index_id, MakeIntKey(id + row_nums), rows, nullptr));
+      ASSERT_EQ(std::vector<int>{id}, Ids(rows));
+    }
+    // ranges come back in key order, the open ends run to the ends of the table
+    rows.clear();
+    Row low = MakeIntKey(1000);
+    Row high = MakeIntKey(1100);
+    ASSERT_EQ(DB_SUCCESS, table->ScanRange(&low, &high, rows));
+    ASSERT_EQ(100, rows.size());
+    for (int i = 0; i < 100; i++) {
+      ASSERT_EQ(1000 + i, IntAt(rows[i], 0));
+    }
+    rows.clear();
+    ASSERT_EQ(DB_SUCCESS, table->ScanRange(nullptr, nullptr, rows));
+    ASSERT_EQ(row_nums, rows.size());
+    ASSERT_TRUE(std::is_sorted(rows.begin(), rows.end(),
+                               [](const Row &a, const Row &b) { return IntAt(a, 0) < IntAt(b, 0); }));
+    // an update moves the secondary key, also to one another row has
+    ASSERT_EQ(DB_SUCCESS, table->UpdateRow(MakeClusteredRow(7, -7, "renamed"), nullptr));
+    rows.clear();
+    ASSERT_EQ(DB_SUCCESS, table->GetRowsBySecondary(code_index_id, MakeIntKey(7 + row_nums), rows, nullptr));
+    ASSERT_TRUE(rows.empty());
+    ASSERT_EQ(DB_SUCCESS, table->UpdateRow(MakeClusteredRow(8, -7), nullptr));
+    ASSERT_EQ(DB_SUCCESS, table->GetRowsBySecondary(code_index_id, MakeIntKey(-7), rows, nullptr));
+    ASSERT_EQ((std::vector<int>{7, 8}), Ids(rows));
+    ASSERT_EQ("renamed7", rows[0].GetField(1)->toString());
+    ASSERT_EQ(DB_KEY_NOT_FOUND, table->UpdateRow(MakeClusteredRow(-1, -1), nullptr));
+    // a removed row is gone from both trees
+    ASSERT_EQ(DB_SUCCESS, table->RemoveRow(MakeIntKey(9), nullptr));
+    ASSERT_EQ(DB_KEY_NOT_FOUND, table->GetRow(MakeIntKey(9), row, nullptr));
+    rows.clear();
+    ASSERT_EQ(DB_SUCCESS, table->GetRowsBySecondary(code_index_id, MakeIntKey(9 + row_nums), rows, nullptr));
+    ASSERT_TRUE(rows.empty());
+    ASSERT_EQ(DB_KEY_NOT_FOUND, table->RemoveRow(MakeIntKey(9), nullptr));
+  }
+  // the trees open again from the index roots page, a secondary index added later indexes the rows there
+  DBStorageEngine engine(clustered_db_file, false);
+  std::unique_ptr<ClusteredTable> table(ClusteredTable::Create(engine.bpm_, schema, {0}, primary_index_id));
+  ASSERT_EQ(DB_SUCCESS, table->CreateSecondaryIndex({2}, code_index_id));
+  ASSERT_EQ(DB_SUCCESS, table->CreateSecondaryIndex({1}, name_index_id));
+  Row row;
+  ASSERT_EQ(DB_SUCCESS, table->GetRow(MakeIntKey(7), row, nullptr));
+  ASSERT_EQ("renamed7", row.GetField(1)->toString());
+  std::vector<Row> rows;
+  ASSERT_EQ(DB_SUCCESS, table->GetRowsBySecondary(code_index_id, MakeIntKey(100 + row_nums), rows, nullptr));
+  ASSERT_EQ(DB_SUCCESS, table->GetRowsBySecondary(name_index_id, MakeCharKey("name4321"), rows, nullptr));
+  ASSERT_EQ((std::vector<int>{100, 4321}), Ids(rows));
+  ASSERT_EQ(DB_INDEX_NOT_FOUND, table->GetRowsBySecondary(103, MakeIntKey(0), rows, nullptr));
+  // a row wider than the schema allows does not fit an entry
+  ASSERT_EQ(DB_FAILED, table->InsertRow(MakeClusteredRow(-2, -2, std::string(100, 'x')), nullptr));
+  rows.clear();
+  ASSERT_EQ(DB_SUCCESS, table->ScanRange(nullptr, nullptr, rows));
+  ASSERT_EQ(row_nums - 1, rows.size());
+}
+
+TEST(ClusteredTableTest, RowIdTest) {
+  const int row_nums = 2000;
+  DBStorageEngine engine("clustered_row_id_test.db", true);
+  std::unique_ptr<Schema> schema(MakeClusteredSchema());
+  std::unique_ptr<ClusteredTable> table(ClusteredTable::Create(engine.bpm_, schema.get(), {0}, primary_index_id));
+  ASSERT_EQ(DB_SUCCESS, table->CreateRowIdIndex(primary_index_id + 1));
+  // the row ids go up with the insert order, the keys do not
+  std::vector<int> ids = ShuffledIds(row_nums, 3);
+  for (int i = 0; i < row_nums; i++) {
+    Row row = MakeClusteredRow(ids[i], i);
+    row.SetRowId(RowId(i / 100, i % 100));
+    ASSERT_EQ(DB_SUCCESS, table->InsertRow(row, nullptr));
+  }
+  Row row = MakeClusteredRow(-1, -1);
+  row.SetRowId(RowId(0, 5));
+  ASSERT_EQ(DB_FAILED, table->InsertRow(row, nullptr));
+  ASSERT_EQ(DB_KEY_NOT_FOUND, table->GetRow(MakeIntKey(-1), row, nullptr));
+  ASSERT_EQ(DB_SUCCESS, table->GetRowByRowId(RowId(3, 7), row, nullptr));
+  ASSERT_EQ(ids[307], IntAt(row, 0));
+  ASSERT_EQ(RowId(3, 7), row.GetRowId());
+  // an update keeps the row id, a removed row leaves the row id tree
+  ASSERT_EQ(DB_SUCCESS, table->UpdateRow(MakeClusteredRow(ids[307], -307, "renamed"), nullptr));
+  ASSERT_EQ(DB_SUCCESS, table->GetRowByRowId(RowId(3, 7), row, nullptr));
+  ASSERT_EQ(-307, IntAt(row, 2));
+  ASSERT_EQ(DB_SUCCESS, table->RemoveRow(MakeIntKey(ids[308]), nullptr));
+  ASSERT_EQ(DB_KEY_NOT_FOUND, table->GetRowByRowId(RowId(3, 8), row, nullptr));
+  // pages of row ids are read in row id order, a page without rows is passed over
+  for (int slot = 0; slot < 100; slot++) {
+    ASSERT_EQ(DB_SUCCESS, table->RemoveRow(MakeIntKey(ids[500 + slot]), nullptr));
+  }
+  std::vector<page_id_t> expected_pages;
+  for (page_id_t page_id = 0; page_id < row_nums / 100; page_id++) {
+    if (page_id != 5) {
+      expected_pages.push_back(page_id);
+    }
+  }
+  ASSERT_EQ(expected_pages, table->GetRowIdPages());
+  std::vector<Row> rows;
+  size_t row_count;
+  ASSERT_EQ(4, table->ReadRowIdPage(3, rows, row_count, nullptr));
+  ASSERT_EQ(99, row_count);
+  ASSERT_EQ(RowId(3, 9), rows[8].GetRowId());
+  ASSERT_EQ(6, table->ReadRowIdPage(4, rows, row_count, nullptr));
+  ASSERT_EQ(6, table->ReadRowIdPage(5, rows, row_count, nullptr));
+  ASSERT_EQ(0, row_count);
+  ASSERT_EQ(INVALID_PAGE_ID, table->ReadRowIdPage(row_nums / 100 - 1, rows, row_count, nullptr));
+  ASSERT_EQ(100, row_count);
+  // the trees leave the index roots page
+  table->Destroy();
+  auto *roots_page = reinterpret_cast<IndexRootsPage *>(engine.bpm_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  page_id_t root_page_id;
+  ASSERT_FALSE(roots_page->GetRootId(primary_index_id, &root_page_id));
+  ASSERT_FALSE(roots_page->GetRootId(primary_index_id + 1, &root_page_id));
+  engine.bpm_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+}
+
+/** @return the ids of a scan of the heap, in scan order */
+static std::vector<int> ScanIds(TableHeap *table_heap) {
+  std::vector<int> ids;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+    ids.push_back(IntAt(*iter, 0));
+  }
+  return ids;
+}
+
+TEST(ClusteredTableTest, ClusteredStorageTest) {
+  const int row_nums = 3000;
+  std::vector<int> ids = ShuffledIds(row_nums, 5);
+  uint32_t pages_empty;
+  {
+    DBStorageEngine engine("clustered_storage_test.db", true);
+    pages_empty = engine.disk_mgr_->GetAllocatedPages(DEFAULT_TABLESPACE_ID);
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_FAILED, engine.catalog_mgr_->CreateTable("k", MakeClusteredSchema(), nullptr, table_info,
+                                                          DEFAULT_TABLESPACE_ID, TableStorage::kClustered));
+    ASSERT_EQ(DB_COLUMN_NAME_NOT_EXIST,
+              engine.catalog_mgr_->CreateTable("k", MakeClusteredSchema(), nullptr, table_info, DEFAULT_TABLESPACE_ID,
+                                               TableStorage::kClustered, false, nullptr, {"missing"}));
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable("k", MakeClusteredSchema(), nullptr, table_info,
+                                                           DEFAULT_TABLESPACE_ID, TableStorage::kClustered, false,
+                                                           nullptr, {"id"}));
+    IndexInfo *index_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateIndex("k", "code_index", {"code"}, nullptr, index_info, "bptree"));
+    // the trees of the table take index ids no index has
+    ASSERT_EQ(TableStorage::kClustered, table_info->GetTableHeap()->GetStorage());
+    for (auto tree_id : table_info->GetTableHeap()->GetClusteredHeap()->GetIndexIds()) {
+      ASSERT_NE(index_info->GetIndexMetadata()->GetIndexId(), tree_id);
+    }
+    TableHeap *table_heap = table_info->GetTableHeap();
+    std::vector<RowId> rids(row_nums);
+    for (int i = 0; i < row_nums; i++) {
+      Row row = MakeClusteredRow(ids[i], ids[i] + row_nums);
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+      ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(MakeIntKey(ids[i] + row_nums), row.GetRowId(), nullptr));
+      rids[i] = row.GetRowId();
+    }
+    Row duplicate = MakeClusteredRow(ids[0], -1);
+    ASSERT_FALSE(table_heap->InsertTuple(duplicate, nullptr));
+    // a scan reads the rows in insert order, an index finds them by their row id
+    ASSERT_EQ(ids, ScanIds(table_heap));
+    std::vector<RowId> result;
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(MakeIntKey(ids[42] + row_nums), result, nullptr));
+    ASSERT_EQ(std::vector<RowId>{rids[42]}, result);
+    Row row(rids[42]);
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    ASSERT_EQ(ids[42], IntAt(row, 0));
+    // a new primary key moves the row in the tree but keeps its row id and its place in a scan
+    Row moved = MakeClusteredRow(row_nums + 42, -42);
+    ASSERT_TRUE(table_heap->UpdateTuple(moved, rids[42], nullptr));
+    Row taken = MakeClusteredRow(ids[43], -43);
+    ASSERT_FALSE(table_heap->UpdateTuple(taken, rids[42], nullptr));
+    row = Row(rids[42]);
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    ASSERT_EQ(row_nums + 42, IntAt(row, 0));
+    ids[42] = row_nums + 42;
+    ASSERT_EQ(ids, ScanIds(table_heap));
+    // a delete during a scan leaves the rest of the scan as it was
+    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+      if (IntAt(*iter, 0) % 2 == 0) {
+        ASSERT_TRUE(table_heap->MarkDelete(iter->GetRowId(), nullptr));
+        table_heap->ApplyDelete(iter->GetRowId(), nullptr);
+      }
+    }
+    ids.erase(std::remove_if(ids.begin(), ids.end(), [](int id) { return id % 2 == 0; }), ids.end());
+    ASSERT_EQ(ids, ScanIds(table_heap));
+    // a marked delete hides the row until it is rolled back
+    ASSERT_TRUE(table_heap->MarkDelete(rids[1], nullptr));
+    row = Row(rids[1]);
+    ASSERT_FALSE(table_heap->GetTuple(&row, nullptr));
+    table_heap->RollbackDelete(rids[1], nullptr);
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+  }
+  {
+    // the heap opens from its meta page, the row ids go on after the reserved ones
+    DBStorageEngine engine("clustered_storage_test.db", false);
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("k", table_info));
+    TableHeap *table_heap = table_info->GetTableHeap();
+    ASSERT_EQ(ids, ScanIds(table_heap));
+    Row row = MakeClusteredRow(-5, -5);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    ASSERT_GE(row.GetRowId().GetPageId(), static_cast<page_id_t>(CLUSTERED_ROW_ID_CACHE_SIZE / CLUSTERED_ROWS_PER_PAGE));
+    ids.push_back(-5);
+    VacuumStats stats;
+    ASSERT_EQ(DB_SUCCESS, engine.VacuumDatabase(stats));
+    ASSERT_EQ(0, stats.released_pages_);
+  }
+  DBStorageEngine engine("clustered_storage_test.db", false);
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("k", table_info));
+  ASSERT_EQ(ids, ScanIds(table_info->GetTableHeap()));
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("k", "code_index", index_info));
+  std::vector<RowId> result;
+  ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(MakeIntKey(ids[1] + row_nums), result, nullptr));
+  Row row(result[0]);
+  ASSERT_TRUE(table_info->GetTableHeap()->GetTuple(&row, nullptr));
+  ASSERT_EQ(ids[1], IntAt(row, 0));
+  // truncate and drop free the trees, their ids leave the index roots page right away
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->TruncateTable("k", nullptr));
+  ASSERT_TRUE(ScanIds(table_info->GetTableHeap()).empty());
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->DropTable("k"));
+  engine.catalog_mgr_->GetPageReclaimer()->Wait();
+  ASSERT_LT(engine.disk_mgr_->GetAllocatedPages(DEFAULT_TABLESPACE_ID), pages_empty + 10);
+}
+
+TEST(ClusteredTableTest, ClusteredStatementTest) {
+  ExecuteEngine engine;
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create database clustered_statement;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "use clustered_statement;"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "create table x(id int) storage = clustered;"));
+  ASSERT_EQ(DB_SUCCESS,
+            RunSql(engine, "create table c(id int, name char(16), primary key(id)) storage = clustered;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into c values(2, \"b\");"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into c values(1, \"a\");"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into c values(3, \"c\");"));
+  RunSql(engine, "insert into c values(3, \"d\");");
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "select * from c where id = 2;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "update c set id = 4 where id = 1;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "delete from c where id = 2;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "select * from c;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "truncate table c;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into c values(5, \"e\");"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "drop table c;"));
+  RunSql(engine, "drop database clustered_statement;");
+}
+
+// SELECT * FROM t WHERE id = x and WHERE id >= x AND id < x + 500, from the leaves against an index and a heap
+/** Plan a select the way the shell does and run it, @return the first column of the rows in the order they come */
+static std::vector<int> SelectIds(ExecuteEngine &executor, DBStorageEngine &engine, const std::string &sql) {
+  return WithSyntaxTree(sql, [&](pSyntaxNode ast) {
+    EXPECT_NE(nullptr, ast) << sql;
+    ExecuteContext context(nullptr, engine.catalog_mgr_, engine.bpm_);
+    Planner planner(&context);
+    planner.PlanQuery(ast);
+    std::vector<Row> result_set;
+    EXPECT_EQ(DB_SUCCESS, executor.ExecutePlan(planner.plan_, &result_set, nullptr, &context)) << sql;
+    return Ids(result_set);
+  });
+}
+
+TEST(ClusteredTableTest, ClusteredQueryTest) {
+  const int row_nums = 2000;
+  std::vector<int> ids = ShuffledIds(row_nums, 7);
+  {
+    ExecuteEngine executor;
+    ASSERT_EQ(DB_SUCCESS, RunSql(executor, "create database clustered_query;"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(executor, "use clustered_query;"));
+    ASSERT_EQ(DB_SUCCESS, RunSql(executor, "create table c(id int, code int, primary key(id)) storage = clustered;"));
+    for (int id : ids) {
+      ASSERT_EQ(DB_SUCCESS, RunSql(executor, "insert into c values(" + std::to_string(id) + ", " +
+                                                 std::to_string(id % 10) + ");"));
+    }
+  }
+  {
+    ExecuteEngine executor;
+    DBStorageEngine engine("clustered_query", false);
+    // the primary tree of the table is its primary key index
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("c", table_info));
+    std::vector<IndexInfo *> indexes;
+    engine.catalog_mgr_->GetTableIndexes("c", indexes);
+    ASSERT_TRUE(indexes.empty());
+    // a scan comes in key order whatever order the rows were inserted in
+    ASSERT_EQ(IdRange(0, row_nums), SelectIds(executor, engine, "select * from c;"));
+    ASSERT_EQ(std::vector<int>{1234}, SelectIds(executor, engine, "select * from c where id = 1234;"));
+    ASSERT_TRUE(SelectIds(executor, engine, "select * from c where id = 1234 and code = 0;").empty());
+    ASSERT_TRUE(SelectIds(executor, engine, "select * from c where id = -1;").empty());
+    ASSERT_EQ(IdRange(500, 1000), SelectIds(executor, engine, "select * from c where id >= 500 and id < 1000;"));
+    ASSERT_EQ(IdRange(1000, 1501), SelectIds(executor, engine, "select * from c where id > 999 and id <= 1500;"));
+    ASSERT_EQ(IdRange(0, 3), SelectIds(executor, engine, "select * from c where id < 3;"));
+    ASSERT_EQ(IdRange(row_nums - 3, row_nums), SelectIds(executor, engine, "select * from c where id > 1996;"));
+    // a bound on another column or behind an or still reads the whole table
+    std::vector<int> coded;
+    for (int id = 0; id < row_nums; id += 10) {
+      coded.push_back(id);
+    }
+    ASSERT_EQ(coded, SelectIds(executor, engine, "select * from c where code = 0;"));
+    ASSERT_EQ((std::vector<int>{0, 1, 1999}),
+              SelectIds(executor, engine, "select * from c where id < 2 or id > 1998;"));
+    // deleted rows are skipped in the middle of a batch
+    ClusteredHeap *heap = table_info->GetTableHeap()->GetClusteredHeap();
+    Row row;
+    ASSERT_TRUE(heap->GetTupleByKey(MakeIntKey(600), &row));
+    ASSERT_TRUE(table_info->GetTableHeap()->MarkDelete(row.GetRowId(), nullptr));
+    std::vector<int> expected = IdRange(500, 1000);
+    expected.erase(std::find(expected.begin(), expected.end(), 600));
+    ASSERT_EQ(expected, SelectIds(executor, engine, "select * from c where id >= 500 and id < 1000;"));
+    ASSERT_TRUE(SelectIds(executor, engine, "select * from c where id = 600;").empty());
+  }
+  DiskManager::RemoveDatabaseFiles("./databases/clustered_query");
+}
+
+TEST(ClusteredTableTest, ClusteredTableBenchmarkTest) {
+  const int row_nums = 100000;
+  const int point_nums = 20000;
+  const int range_nums = 100;
+  const int width = 500;
+  // a buffer pool smaller than the tables, so that the pages a lookup touches are read from disk
+  DBStorageEngine engine("clustered_bench.db", true, 1024);
+  Schema *schema = MakeClusteredSchema();
+  std::unique_ptr<ClusteredTable> table(ClusteredTable::Create(engine.bpm_, schema, {0}, primary_index_id));
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema, nullptr, nullptr, nullptr);
+  std::unique_ptr<Schema> key_schema(Schema::ShallowCopySchema(schema, {0}));
+  BPlusTreeIndex index(primary_index_id + 1, key_schema.get(), 16, engine.bpm_);
+  // rows arrive in random key order, the heap keeps them in that order
+  for (int id : ShuffledIds(row_nums, 7)) {
+    Row row = MakeClusteredRow(id, id);
+    ASSERT_EQ(DB_SUCCESS, table->InsertRow(row, nullptr));
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    ASSERT_EQ(DB_SUCCESS, index.InsertEntry(MakeIntKey(id), row.GetRowId(), nullptr));
+  }
+  std::mt19937 random(11);
+  std::vector<int> points(point_nums), ranges(range_nums);
+  for (auto &point : points) {
+    point = static_cast<int>(random() % row_nums);
+  }
+  for (auto &range : ranges) {
+    range = static_cast<int>(random() % (row_nums - width));
+  }
+  auto start = std::chrono::steady_clock::now();
+  int64_t heap_sum = 0;
+  for (int point : points) {
+    std::vector<RowId> result;
+    ASSERT_EQ(DB_SUCCESS, index.ScanKey(MakeIntKey(point), result, nullptr));
+    Row row(result[0]);
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    heap_sum += IntAt(row, 2);
+  }
+  auto heap_points_done = std::chrono::steady_clock::now();
+  for (int range : ranges) {
+    GenericKey *key = reinterpret_cast<GenericKey *>(new char[16]);
+    KeyManager(key_schema.get(), 16).SerializeFromKey(key, MakeIntKey(range), key_schema.get());
+    auto iter = index.GetBeginIterator(key);
+    for (int i = 0; i < width; i++, ++iter) {
+      Row row((*iter).second);
+      ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+      heap_sum += IntAt(row, 2);
+    }
+    delete[] reinterpret_cast<char *>(key);
+  }
+  auto middle = std::chrono::steady_clock::now();
+  int64_t clustered_sum = 0;
+  for (int point : points) {
+    Row row;
+    ASSERT_EQ(DB_SUCCESS, table->GetRow(MakeIntKey(point), row, nullptr));
+    clustered_sum += IntAt(row, 2);
+  }
+  auto points_done = std::chrono::steady_clock::now();
+  for (int range : ranges) {
+    std::vector<Row> rows;
+    Row low = MakeIntKey(range);
+    Row high = MakeIntKey(range + width);
+    ASSERT_EQ(DB_SUCCESS, table->ScanRange(&low, &high, rows));
+    ASSERT_EQ(width, rows.size());
+    for (auto &row : rows) {
+      clustered_sum += IntAt(row, 2);
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  ASSERT_EQ(heap_sum, clustered_sum);
+  auto ms = [](auto from, auto to) { return std::chrono::duration<double, std::milli>(to - from).count(); };
+  double heap_point_ms = ms(start, heap_points_done);
+  double heap_range_ms = ms(heap_points_done, middle);
+  double point_ms = ms(middle, points_done);
+  double range_ms = ms(points_done, end);
+  std::cout << row_nums << " rows, " << point_nums << " points: heap and index " << heap_point_ms << " ms, clustered "
+            << point_ms << " ms, " << heap_point_ms / point_ms << "x" << std::endl;
+  std::cout << range_nums << " ranges of " << width << ": heap and index " << heap_range_ms << " ms, clustered "
+            << range_ms << " ms, " << heap_range_ms / range_ms << "x" << std::endl;
+}
@@ -0,0 +1,200 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/execute_engine.h"
+#include "gtest/gtest.h"
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/column_scan.h"
+#include "storage/table_heap.h"
+#include "utils/sql_test_util.h"
+
+static const std::string column_db_file = "column_page_test.db";
+
+static Row MakeColumnRow(int id) {
+  // room for any int, the ids used stay below eight characters
+  char name[16];
+  snprintf(name, sizeof(name), "n%07d", id);
+  // every seventh score is null
+  std::vector<Field> fields{Field(TypeId::kTypeInt, id),
+                            id % 7 == 0 ? Field(TypeId::kTypeFloat) : Field(TypeId::kTypeFloat, id * 0.5f),
+                            Field(TypeId::kTypeChar, name, 8, true)};
+  return Row(fields);
+}
+
+TEST(ColumnPageTest, ColumnHeapTest) {
+  const int row_nums = 5000;
+  std::vector<RowId> rids;
+  {
+    DBStorageEngine engine(column_db_file, true);
+    std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, true),
+                                     new Column("score", TypeId::kTypeFloat, 1, true, false),
+                                     new Column("name", TypeId::kTypeChar, 8, 2, false, false)};
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable("t", new Schema(columns), nullptr, table_info,
+                                                           DEFAULT_TABLESPACE_ID, TableStorage::kColumn));
+    TableHeap *table_heap = table_info->GetTableHeap();
+    for (int i = 0; i < row_nums; i++) {
+      Row row = MakeColumnRow(i);
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+      rids.push_back(row.GetRowId());
+    }
+    // a name longer than its column is refused instead of cut
+    char long_name[] = "far too long";
+    std::vector<Field> long_fields{Field(TypeId::kTypeInt, -1), Field(TypeId::kTypeFloat, 0.0f),
+                                   Field(TypeId::kTypeChar, long_name, strlen(long_name), true)};
+    Row long_row(long_fields);
+    ASSERT_FALSE(table_heap->InsertTuple(long_row, nullptr));
+    for (int i = 0; i < row_nums; i += 97) {
+      Row row(rids[i]);
+      ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+      ASSERT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, i)));
+      ASSERT_EQ(i % 7 == 0, row.GetField(1)->IsNull());
+      ASSERT_EQ(rids[i], row.GetRowId());
+    }
+    // update in place, then delete every other row of the first thousand and roll one delete back
+    Row updated = MakeColumnRow(-3);
+    ASSERT_TRUE(table_heap->UpdateTuple(updated, rids[3], nullptr));
+    for (int i = 0; i < 1000; i += 2) {
+      ASSERT_TRUE(table_heap->MarkDelete(rids[i], nullptr));
+    }
+    ASSERT_FALSE(table_heap->MarkDelete(rids[0], nullptr));
+    table_heap->RollbackDelete(rids[0], nullptr);
+    for (int i = 2; i < 1000; i += 2) {
+      table_heap->ApplyDelete(rids[i], nullptr);
+    }
+    std::vector<std::pair<RowId, RowId>> moved_rids;
+    ASSERT_EQ(0, table_heap->Vacuum(moved_rids, nullptr));
+  }
+  DBStorageEngine engine(column_db_file, false);
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("t", table_info));
+  TableHeap *table_heap = table_info->GetTableHeap();
+  ASSERT_EQ(TableStorage::kColumn, table_heap->GetStorage());
+  // the scan kernels agree with a scan of the rows
+  int64_t id_sum = 0;
+  double score_sum = 0;
+  uint64_t count = 0, score_count = 0, filtered_count = 0;
+  std::vector<int32_t> filtered_ids;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+    int32_t id = std::stoi(iter->GetField(0)->toString());
+    count++;
+    id_sum += id;
+    if (!iter->GetField(1)->IsNull()) {
+      score_sum += std::stof(iter->GetField(1)->toString());
+      score_count++;
+      if (iter->GetField(1)->CompareGreaterThanEquals(Field(TypeId::kTypeFloat, 1000.0f)) == CmpBool::kTrue &&
+          id < 4000) {
+        filtered_count++;
+        filtered_ids.push_back(id);
+      }
+    }
+  }
+  ASSERT_EQ(row_nums - 499, count);
+  ColumnScan scan(table_heap, nullptr);
+  uint64_t scan_count = 0;
+  double sum = 0;
+  ASSERT_EQ(DB_SUCCESS, scan.Count(scan_count));
+  ASSERT_EQ(count, scan_count);
+  ASSERT_EQ(DB_SUCCESS, scan.Sum(0, sum, scan_count));
+  ASSERT_EQ(id_sum, static_cast<int64_t>(sum));
+  ASSERT_EQ(DB_SUCCESS, scan.Sum(1, sum, scan_count));
+  ASSERT_EQ(score_count, scan_count);
+  ASSERT_NEAR(score_sum, sum, 1e-6 * score_sum);
+  ASSERT_EQ(DB_FAILED, scan.Sum(2, sum, scan_count));
+  ASSERT_EQ(DB_FAILED, scan.AddFilter(0, CompareOp::kLessThan, Field(TypeId::kTypeFloat, 1.0f)));
+  ASSERT_EQ(DB_SUCCESS, scan.AddFilter(1, CompareOp::kGreaterThanEquals,
+                                       Field(TypeId::kTypeFloat, 1000.0f)));
+  ASSERT_EQ(DB_SUCCESS, scan.AddFilter(0, CompareOp::kLessThan, Field(TypeId::kTypeInt, 4000)));
+  ASSERT_EQ(DB_SUCCESS, scan.Count(scan_count));
+  ASSERT_EQ(filtered_count, scan_count);
+  std::vector<int32_t> ids;
+  ASSERT_EQ(DB_SUCCESS, scan.ProjectInt(0, ids));
+  ASSERT_EQ(filtered_ids, ids);
+  // a row heap has no minipages to scan
+  std::vector<Column *> row_columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+  TableInfo *row_table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable("r", new Schema(row_columns), nullptr, row_table_info));
+  ColumnScan row_scan(row_table_info->GetTableHeap(), nullptr);
+  ASSERT_EQ(DB_FAILED, row_scan.Count(scan_count));
+}
+
+TEST(ColumnPageTest, StorageOptionTest) {
+  ExecuteEngine engine;
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create database column_option;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "use column_option;"));
+  ASSERT_EQ(DB_SUCCESS,
+            RunSql(engine, "create table c(id int, score float, primary key(id)) storage = column;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table r(id int) storage = row;"));
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "create table x(id int) storage = sideways;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into c values(1, 2.5);"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into c values(2, 3.5);"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "update c set score = 4.5 where id = 2;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "delete from c where id = 1;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "select * from c where id = 2;"));
+  RunSql(engine, "drop database column_option;");
+}
+
+TEST(ColumnPageTest, SingleColumnScanBenchmarkTest) {
+  const int row_nums = 100000;
+  const int column_nums = 20;
+  DBStorageEngine engine("column_page_bench.db", true);
+  std::vector<Column *> columns;
+  for (int i = 0; i < column_nums; i++) {
+    if (i % 2 == 0) {
+      columns.push_back(new Column("i" + std::to_string(i), TypeId::kTypeInt, i, false, false));
+    } else {
+      columns.push_back(new Column("f" + std::to_string(i), TypeId::kTypeFloat, i, false, false));
+    }
+  }
+  Schema schema(columns);
+  TableHeap *row_heap = TableHeap::Create(engine.bpm_, &schema, nullptr, nullptr, nullptr);
+  TableHeap *column_heap =
+      TableHeap::Create(engine.bpm_, &schema, nullptr, nullptr, nullptr, DEFAULT_TABLESPACE_ID, TableStorage::kColumn);
+  for (int i = 0; i < row_nums; i++) {
+    std::vector<Field> fields;
+    for (int j = 0; j < column_nums; j++) {
+      if (j % 2 == 0) {
+        fields.emplace_back(TypeId::kTypeInt, (i * (j + 1)) % 1000);
+      } else {
+        fields.emplace_back(TypeId::kTypeFloat, static_cast<float>(i % 100) + 0.25f);
+      }
+    }
+    Row row(fields);
+    ASSERT_TRUE(row_heap->InsertTuple(row, nullptr));
+    ASSERT_TRUE(column_heap->InsertTuple(row, nullptr));
+  }
+  // select sum(f3) from t where i4 < 500
+  Field bound(TypeId::kTypeInt, 500);
+  auto start = std::chrono::steady_clock::now();
+  double row_sum = 0;
+  uint64_t row_count = 0;
+  for (auto iter = row_heap->Begin(nullptr); iter != row_heap->End(); ++iter) {
+    if (iter->GetField(4)->CompareLessThan(bound) == CmpBool::kTrue) {
+      row_count++;
+      float value;
+      iter->GetField(3)->SerializeTo(reinterpret_cast<char *>(&value));
+      row_sum += value;
+    }
+  }
+  auto middle = std::chrono::steady_clock::now();
+  ColumnScan scan(column_heap, nullptr);
+  ASSERT_EQ(DB_SUCCESS, scan.AddFilter(4, CompareOp::kLessThan, bound));
+  double column_sum = 0;
+  uint64_t count = 0;
+  ASSERT_EQ(DB_SUCCESS, scan.Sum(3, column_sum, count));
+  auto end = std::chrono::steady_clock::now();
+  double row_ms = std::chrono::duration<double, std::milli>(middle - start).count();
+  double column_ms = std::chrono::duration<double, std::milli>(end - middle).count();
+  std::cout << row_nums << " rows of " << column_nums << " columns: row scan " << row_ms << " ms over "
+            << row_heap->GetPageCount() << " pages, column scan " << column_ms << " ms over "
+            << column_heap->GetPageCount() << " pages, " << row_ms / column_ms << "x" << std::endl;
+  ASSERT_EQ(row_count, count);
+  ASSERT_NEAR(row_sum, column_sum, 1e-6 * row_sum);
+  // without a tuple header and slot per row the same rows take fewer pages
+  ASSERT_LT(column_heap->GetPageCount(), row_heap->GetPageCount());
+  delete row_heap;
+  delete column_heap;
+}
@@ -0,0 +1,82 @@
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+
+#include "gtest/gtest.h"
+#include "storage/disk_manager.h"
+
+static const std::string growth_db_file = "file_growth_test.db";
+
+TEST(FileGrowthTest, ChunkedGrowthTest) {
+  const uint64_t growth_size = 256 * PAGE_SIZE;
+  DiskManager::RemoveDatabaseFiles(growth_db_file);
+  {
+    DiskManager disk_mgr(growth_db_file);
+    disk_mgr.SetGrowthSize(growth_size);
+    uint32_t space_id;
+    ASSERT_EQ(DB_SUCCESS, disk_mgr.CreateTablespace("ts1", "", space_id));
+    ASSERT_EQ(growth_size, disk_mgr.GetGrowthSize());
+    // the first page reserves a whole chunk in each file
+    disk_mgr.AllocatePage();
+    disk_mgr.AllocatePage(space_id);
+    ASSERT_EQ(2 * growth_size, disk_mgr.GetFileSize());
+    // and the file only grows again once the chunk is used up
+    for (int i = 1; i < 250; i++) {
+      disk_mgr.AllocatePage();
+    }
+    ASSERT_EQ(2 * growth_size, disk_mgr.GetFileSize());
+    for (int i = 250; i < 300; i++) {
+      disk_mgr.AllocatePage();
+    }
+    ASSERT_EQ(3 * growth_size, disk_mgr.GetFileSize());
+    // reserved space reads as zeros
+    char buf[PAGE_SIZE];
+    memset(buf, 1, PAGE_SIZE);
+    disk_mgr.ReadPage(299, buf);
+    for (int i = 0; i < PAGE_SIZE; i++) {
+      ASSERT_EQ(0, buf[i]);
+    }
+    disk_mgr.Close();
+  }
+  // without a growth size the file only grows as pages get written
+  DiskManager::RemoveDatabaseFiles(growth_db_file);
+  DiskManager disk_mgr(growth_db_file);
+  disk_mgr.SetGrowthSize(0);
+  for (int i = 0; i < 10; i++) {
+    disk_mgr.AllocatePage();
+  }
+  ASSERT_EQ(2 * PAGE_SIZE, disk_mgr.GetFileSize());
+  disk_mgr.Close();
+  DiskManager::RemoveDatabaseFiles(growth_db_file);
+}
+
+TEST(FileGrowthTest, GrowthBenchmarkTest) {
+  // the page stream of a bulk insert: allocate a page, fill it, write it out, and sync the file at the end
+  const int page_nums = 20000;
+  const uint64_t growth_sizes[] = {0, DEFAULT_FILE_GROWTH_SIZE, 16 * DEFAULT_FILE_GROWTH_SIZE};
+  char data[PAGE_SIZE];
+  for (auto growth_size : growth_sizes) {
+    DiskManager::RemoveDatabaseFiles(growth_db_file);
+    auto start = std::chrono::steady_clock::now();
+    {
+      DiskManager disk_mgr(growth_db_file);
+      disk_mgr.SetGrowthSize(growth_size);
+      for (int i = 0; i < page_nums; i++) {
+        page_id_t page_id = disk_mgr.AllocatePage();
+        ASSERT_EQ(i, page_id);
+        memset(data, i & 0x7f, PAGE_SIZE);
+        disk_mgr.WritePage(page_id, data);
+      }
+      disk_mgr.Close();
+    }
+    FILE *file = fopen(growth_db_file.c_str(), "r+");
+    ASSERT_NE(nullptr, file);
+    fsync(fileno(file));
+    fclose(file);
+    auto end = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    std::cout << "growth size " << growth_size << ": " << page_nums << " pages appended in " << ms << " ms ("
+              << page_nums / ms * 1000 << " pages/s)" << std::endl;
+  }
+  DiskManager::RemoveDatabaseFiles(growth_db_file);
+}
@@ -0,0 +1,117 @@
+#include <chrono>
+#include <cstdio>
+#include <set>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+
+static const std::string fsm_db_file = "free_space_map_test.db";
+
+static Row MakeFsmRow(int id) {
+  char name[65];
+  snprintf(name, sizeof(name), "%064d", id);
+  std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, name, 64, true)};
+  return Row(fields);
+}
+
+TEST(FreeSpaceMapTest, ReuseAndPersistTest) {
+  const int row_nums = 40000;
+  Transaction txn;
+  uint32_t page_count;
+  {
+    DBStorageEngine engine(fsm_db_file, true);
+    std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, true),
+                                     new Column("name", TypeId::kTypeChar, 64, 1, false, false)};
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable("t", new Schema(columns), &txn, table_info));
+    TableHeap *table_heap = table_info->GetTableHeap();
+    std::vector<RowId> rids;
+    for (int i = 0; i < row_nums; i++) {
+      Row row = MakeFsmRow(i);
+      ASSERT_TRUE(table_heap->InsertTuple(row, &txn));
+      rids.push_back(row.GetRowId());
+    }
+    page_count = table_heap->GetPageCount();
+    // the map spans several pages at this size
+    ASSERT_GT(page_count, FreeSpaceMapPage::GetCapacity(PAGE_SIZE));
+    for (int i = 0; i < row_nums; i += 2) {
+      ASSERT_TRUE(table_heap->MarkDelete(rids[i], &txn));
+      table_heap->ApplyDelete(rids[i], &txn);
+    }
+  }
+  DBStorageEngine engine(fsm_db_file, false);
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("t", table_info));
+  TableHeap *table_heap = table_info->GetTableHeap();
+  ASSERT_EQ(page_count, table_heap->GetPageCount());
+  // the freed space is found again after reopening, only the slot overhead of the new rows spills into new pages
+  for (int i = 0; i < row_nums; i += 2) {
+    Row row = MakeFsmRow(i);
+    ASSERT_TRUE(table_heap->InsertTuple(row, &txn));
+  }
+  ASSERT_LT(table_heap->GetPageCount(), page_count + page_count / 5);
+  int count = 0;
+  for (auto iter = table_heap->Begin(&txn); iter != table_heap->End(); ++iter) {
+    count++;
+  }
+  ASSERT_EQ(row_nums, count);
+}
+
+TEST(FreeSpaceMapTest, InsertLatencyBenchmarkTest) {
+  // scaled down from ten million rows, the point is that the last batch costs as much as the first
+  const int batch_nums = 10;
+  const int batch_size = 50000;
+  DBStorageEngine engine("free_space_map_bench.db", true);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, false, false)};
+  Schema schema(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, &schema, nullptr, nullptr, nullptr);
+  std::vector<RowId> rids;
+  std::set<page_id_t> filled_pages;
+  for (int batch = 0; batch < batch_nums; batch++) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < batch_size; i++) {
+      Row row = MakeFsmRow(batch * batch_size + i);
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+      rids.push_back(row.GetRowId());
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "rows " << batch * batch_size << "-" << (batch + 1) * batch_size << ": "
+              << std::chrono::duration<double, std::micro>(end - start).count() / batch_size << " us per insert, "
+              << table_heap->GetPageCount() << " pages" << std::endl;
+  }
+  // the map sends each insert to the page being filled or a new one, a full page is never looked at again
+  for (size_t i = 1; i < rids.size(); i++) {
+    page_id_t page_id = rids[i].GetPageId();
+    if (page_id != rids[i - 1].GetPageId()) {
+      filled_pages.insert(rids[i - 1].GetPageId());
+      ASSERT_EQ(0, filled_pages.count(page_id)) << "row " << i << " went back to a full page";
+    }
+  }
+  ASSERT_EQ(filled_pages.size() + 1, table_heap->GetPageCount());
+  // space freed on the first page is found without growing the heap
+  page_id_t first_page_id = rids.front().GetPageId();
+  int freed = 0;
+  for (auto &rid : rids) {
+    if (rid.GetPageId() == first_page_id) {
+      ASSERT_TRUE(table_heap->MarkDelete(rid, nullptr));
+      table_heap->ApplyDelete(rid, nullptr);
+      freed++;
+    }
+  }
+  uint32_t page_count = table_heap->GetPageCount();
+  int reused = 0;
+  for (int i = 0; i < freed; i++) {
+    Row row = MakeFsmRow(i);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    reused += row.GetRowId().GetPageId() == first_page_id ? 1 : 0;
+  }
+  ASSERT_EQ(page_count, table_heap->GetPageCount());
+  ASSERT_GT(reused, 0);
+  table_heap->FreeTableHeap();
+  delete table_heap;
+}
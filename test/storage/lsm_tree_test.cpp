@@ -0,0 +1,123 @@
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "storage/lsm_tree.h"
+
+static const std::string lsm_db_file = "lsm_tree_test.db";
+
+static std::string MakeLsmKey(int id) {
+  char key[16];
+  snprintf(key, sizeof(key), "k%08d", id);
+  return key;
+}
+
+static std::string MakeLsmValue(int id, int version) { return std::string(40 + id % 50, 'a' + (id + version) % 26); }
+
+static void CheckScan(LsmTree *tree, const std::map<std::string, std::string> &expected, const std::string &low,
+                      const std::string &high) {
+  std::vector<std::pair<std::string, std::string>> entries;
+  tree->Scan(low, high, entries);
+  auto begin = expected.lower_bound(low);
+  auto end = high.empty() ? expected.end() : expected.lower_bound(high);
+  ASSERT_EQ(std::distance(begin, end), entries.size());
+  for (auto &entry : entries) {
+    ASSERT_EQ(begin->first, entry.first);
+    ASSERT_EQ(begin->second, entry.second);
+    ++begin;
+  }
+}
+
+TEST(LsmTreeTest, LsmTreeTest) {
+  const int key_nums = 20000;
+  // a small memtable flushes often enough to fill several levels
+  const size_t memtable_size = 64 * 1024;
+  std::map<std::string, std::string> expected;
+  page_id_t manifest_page_id;
+  uint32_t pages_empty;
+  {
+    DBStorageEngine engine(lsm_db_file, true);
+    pages_empty = engine.disk_mgr_->GetAllocatedPages(DEFAULT_TABLESPACE_ID);
+    std::unique_ptr<LsmTree> tree(LsmTree::Create(engine.disk_mgr_, DEFAULT_TABLESPACE_ID, memtable_size));
+    manifest_page_id = tree->GetManifestPageId();
+    std::mt19937 random(5);
+    // inserts, overwrites and deletes in random order, the map keeps what the tree has to answer
+    for (int i = 0; i < 3 * key_nums; i++) {
+      int id = static_cast<int>(random() % key_nums);
+      std::string key = MakeLsmKey(id);
+      if (i % 7 == 3) {
+        tree->Delete(key);
+        expected.erase(key);
+      } else {
+        ASSERT_TRUE(tree->Put(key, MakeLsmValue(id, i)));
+        expected[key] = MakeLsmValue(id, i);
+      }
+    }
+    ASSERT_FALSE(tree->Put("big", std::string(engine.disk_mgr_->GetPageSize(), 'x')));
+    tree->Flush();
+    LsmStats stats = tree->GetStats();
+    ASSERT_GT(stats.flushes_, LSM_L0_RUNS);
+    ASSERT_GT(stats.compactions_, 0);
+    ASSERT_LT(stats.level_runs_[0], LSM_L0_RUNS);
+    // the deeper levels are cut into runs about as large as a memtable, a merge rewrites the ones it overlaps only
+    ASSERT_GT(stats.level_runs_.size(), 1);
+    for (size_t level = 1; level < stats.level_runs_.size(); level++) {
+      ASSERT_LE(stats.level_pages_[level], stats.level_runs_[level] * memtable_size / engine.disk_mgr_->GetPageSize());
+    }
+    ASSERT_GT(stats.level_runs_.back(), 1);
+    std::string value;
+    for (int id = 0; id < key_nums; id++) {
+      auto iter = expected.find(MakeLsmKey(id));
+      ASSERT_EQ(iter != expected.end(), tree->Get(MakeLsmKey(id), &value));
+      if (iter != expected.end()) {
+        ASSERT_EQ(iter->second, value);
+      }
+    }
+    // keys that were never written are mostly ruled out by the bloom filters
+    uint64_t bloom_skips = tree->GetStats().bloom_skips_;
+    for (int id = 0; id < 1000; id++) {
+      ASSERT_FALSE(tree->Get(MakeLsmKey(id) + "x", &value));
+    }
+    ASSERT_GT(tree->GetStats().bloom_skips_ - bloom_skips, 900);
+    CheckScan(tree.get(), expected, "", "");
+    CheckScan(tree.get(), expected, MakeLsmKey(100), MakeLsmKey(200));
+    CheckScan(tree.get(), expected, MakeLsmKey(key_nums - 50), "");
+    std::string last_key;
+    ASSERT_TRUE(tree->GetLastKey(&last_key));
+    ASSERT_LE(expected.rbegin()->first, last_key);
+    // writes left in the memtable are flushed when the tree is closed, level 0 stays within its limit
+    tree->Put(MakeLsmKey(key_nums), "last");
+    expected[MakeLsmKey(key_nums)] = "last";
+    tree.reset();
+    tree.reset(LsmTree::Open(engine.disk_mgr_, manifest_page_id, memtable_size));
+    ASSERT_LT(tree->GetStats().level_runs_[0], LSM_L0_RUNS);
+    // the filters are read back with the runs
+    for (int id = 0; id < 1000; id++) {
+      ASSERT_FALSE(tree->Get(MakeLsmKey(id) + "x", &value));
+    }
+    ASSERT_GT(tree->GetStats().bloom_skips_, 900);
+  }
+  {
+    DBStorageEngine engine(lsm_db_file, false);
+    std::unique_ptr<LsmTree> tree(LsmTree::Open(engine.disk_mgr_, manifest_page_id, memtable_size));
+    CheckScan(tree.get(), expected, "", "");
+    std::string value;
+    ASSERT_TRUE(tree->Get(MakeLsmKey(key_nums), &value));
+    ASSERT_EQ("last", value);
+    // a cleared tree keeps its manifest, a destroyed one gives back every page
+    PageReclaimer reclaimer;
+    tree->Clear(&reclaimer);
+    reclaimer.Wait();
+    ASSERT_FALSE(tree->Get(MakeLsmKey(key_nums), &value));
+    ASSERT_EQ(pages_empty + 1, engine.disk_mgr_->GetAllocatedPages(DEFAULT_TABLESPACE_ID));
+    tree->Put(MakeLsmKey(1), "one");
+    tree->Flush();
+    tree->Destroy();
+    ASSERT_EQ(pages_empty, engine.disk_mgr_->GetAllocatedPages(DEFAULT_TABLESPACE_ID));
+  }
+  remove(lsm_db_file.c_str());
+}
@@ -0,0 +1,197 @@
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+
+static const std::string overflow_db_file = "overflow_test.db";
+
+static std::string MakeBody(int id, uint32_t length) {
+  std::string body(length, ' ');
+  for (uint32_t k = 0; k < length; k++) {
+    body[k] = static_cast<char>('a' + (id + k) % 26);
+  }
+  return body;
+}
+
+static uint32_t BodyLength(int id) {
+  // short values stay in the tuple, the others take from a part of one page to several pages
+  static const uint32_t lengths[] = {10, 300, 1000, 5000, 40000};
+  return lengths[id % 5];
+}
+
+static Row MakeOverflowRow(int id, uint32_t length) {
+  std::string body = MakeBody(id, length);
+  std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, const_cast<char *>(body.data()),
+                                                                 static_cast<uint32_t>(body.size()), true)};
+  return Row(fields);
+}
+
+static Schema *MakeOverflowSchema() {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("body", TypeId::kTypeChar, 100000, 1, true, false)};
+  return new Schema(columns);
+}
+
+static void CheckOverflowRow(const Row &row, int id, uint32_t length) {
+  ASSERT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, id)));
+  ASSERT_EQ(length, row.GetField(1)->GetLength());
+  ASSERT_EQ(0, memcmp(MakeBody(id, length).data(), row.GetField(1)->GetData(), length));
+}
+
+static uint32_t GetAllocatedPages(DBStorageEngine &engine) {
+  return engine.disk_mgr_->GetAllocatedPages(DEFAULT_TABLESPACE_ID);
+}
+
+TEST(OverflowTest, OverflowHeapTest) {
+  const int row_nums = 500;
+  std::vector<RowId> rids;
+  {
+    DBStorageEngine engine(overflow_db_file, true);
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable("t", MakeOverflowSchema(), nullptr, table_info));
+    TableHeap *table_heap = table_info->GetTableHeap();
+    for (int i = 0; i < row_nums; i++) {
+      Row row = MakeOverflowRow(i, BodyLength(i));
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+      rids.push_back(row.GetRowId());
+    }
+    // the tuples keep only a prefix of the long values, so they share few pages
+    ASSERT_LT(table_heap->GetPageCount(), 10);
+    for (int i = 0; i < row_nums; i++) {
+      Row row(rids[i]);
+      ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+      CheckOverflowRow(row, i, BodyLength(i));
+    }
+    // a scan that does not read the long column sees its prefix only
+    uint32_t count = 0;
+    for (auto iter = table_heap->Begin(nullptr, {true, false}); iter != table_heap->End(); ++iter) {
+      uint32_t length = BodyLength(std::stoi(iter->GetField(0)->toString()));
+      ASSERT_EQ(length > OVERFLOW_THRESHOLD ? OVERFLOW_PREFIX_SIZE : length, iter->GetField(1)->GetLength());
+      count++;
+    }
+    ASSERT_EQ(row_nums, count);
+    // an update replaces the chain of the old value, growing and shrinking values move between tuple and chain
+    for (int i = 0; i < 50; i++) {
+      Row row = MakeOverflowRow(i, BodyLength(i + 1));
+      ASSERT_TRUE(table_heap->UpdateTuple(row, rids[i], nullptr));
+    }
+    for (int i = 0; i < 50; i++) {
+      Row row(rids[i]);
+      ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+      CheckOverflowRow(row, i, BodyLength(i + 1));
+    }
+    // a row read back and stored again gets chains of its own
+    Row copy(rids[3]);
+    ASSERT_TRUE(table_heap->GetTuple(&copy, nullptr));
+    ASSERT_TRUE(table_heap->UpdateTuple(copy, rids[3], nullptr));
+    Row copied(rids[3]);
+    ASSERT_TRUE(table_heap->GetTuple(&copied, nullptr));
+    CheckOverflowRow(copied, 3, BodyLength(4));
+    // a row whose values are all short but too many for a page moves the longest of them out
+    std::vector<Column *> wide_columns;
+    std::vector<Field> wide_fields;
+    std::string wide_value = MakeBody(7, 200);
+    for (int i = 0; i < 30; i++) {
+      wide_columns.push_back(new Column("c" + std::to_string(i), TypeId::kTypeChar, 200, i, false, false));
+      wide_fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(wide_value.data()), 200, true);
+    }
+    TableInfo *wide_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable("w", new Schema(wide_columns), nullptr, wide_info));
+    Row wide_row(wide_fields);
+    ASSERT_TRUE(wide_info->GetTableHeap()->InsertTuple(wide_row, nullptr));
+    Row wide_read(wide_row.GetRowId());
+    ASSERT_TRUE(wide_info->GetTableHeap()->GetTuple(&wide_read, nullptr));
+    for (int i = 0; i < 30; i++) {
+      ASSERT_EQ(0, memcmp(wide_value.data(), wide_read.GetField(i)->GetData(), 200));
+    }
+    // applied deletes free the chains, a rolled back one keeps them
+    uint32_t pages_before_delete = GetAllocatedPages(engine);
+    for (int i = 100; i < row_nums; i++) {
+      ASSERT_TRUE(table_heap->MarkDelete(rids[i], nullptr));
+    }
+    table_heap->RollbackDelete(rids[104], nullptr);
+    for (int i = 100; i < row_nums; i++) {
+      if (i != 104) {
+        table_heap->ApplyDelete(rids[i], nullptr);
+      }
+    }
+    ASSERT_LT(GetAllocatedPages(engine), pages_before_delete / 2);
+    Row kept(rids[104]);
+    ASSERT_TRUE(table_heap->GetTuple(&kept, nullptr));
+    CheckOverflowRow(kept, 104, BodyLength(104));
+    // compact the database, the chains move with the other pages
+    VacuumStats stats;
+    ASSERT_EQ(DB_SUCCESS, engine.VacuumDatabase(stats));
+    ASSERT_EQ(0, stats.released_pages_);
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->DropTable("w"));
+  }
+  DBStorageEngine engine(overflow_db_file, false);
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("t", table_info));
+  TableHeap *table_heap = table_info->GetTableHeap();
+  uint32_t count = 0;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+    int id = std::stoi(iter->GetField(0)->toString());
+    CheckOverflowRow(*iter, id, BodyLength(id < 50 ? id + 1 : id));
+    count++;
+  }
+  ASSERT_EQ(101, count);
+  // dropping the table gives all of its chains back
+  uint32_t pages_before_drop = GetAllocatedPages(engine);
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->DropTable("t"));
+  engine.catalog_mgr_->GetPageReclaimer()->Wait();
+  ASSERT_LT(GetAllocatedPages(engine), pages_before_drop - 100);
+}
+
+TEST(OverflowTest, LargeTextScanBenchmarkTest) {
+  const int row_nums = 20000;
+  const uint32_t body_length = 2000;
+  DBStorageEngine engine("overflow_bench.db", true);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("score", TypeId::kTypeInt, 1, false, false),
+                                   new Column("body", TypeId::kTypeChar, body_length, 2, false, false)};
+  Schema schema(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, &schema, nullptr, nullptr, nullptr);
+  for (int i = 0; i < row_nums; i++) {
+    std::string body = MakeBody(i, body_length);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeInt, i % 100),
+                              Field(TypeId::kTypeChar, const_cast<char *>(body.data()), body_length, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  // select sum(id) from t where score < 50, first reading only the columns involved, then reading whole rows
+  Field bound(TypeId::kTypeInt, 50);
+  auto sum_ids = [&](const std::vector<bool> &columns, int64_t &sum, uint64_t &body_bytes) {
+    sum = 0;
+    body_bytes = 0;
+    for (auto iter = table_heap->Begin(nullptr, columns); iter != table_heap->End(); ++iter) {
+      if (iter->GetField(1)->CompareLessThan(bound) == CmpBool::kTrue) {
+        sum += std::stoi(iter->GetField(0)->toString());
+      }
+      body_bytes += iter->GetField(2)->GetLength();
+    }
+  };
+  int64_t narrow_sum, full_sum;
+  uint64_t narrow_bytes, full_bytes;
+  auto start = std::chrono::steady_clock::now();
+  sum_ids({true, true, false}, narrow_sum, narrow_bytes);
+  auto middle = std::chrono::steady_clock::now();
+  sum_ids({}, full_sum, full_bytes);
+  auto end = std::chrono::steady_clock::now();
+  double narrow_ms = std::chrono::duration<double, std::milli>(middle - start).count();
+  double full_ms = std::chrono::duration<double, std::milli>(end - middle).count();
+  std::cout << row_nums << " rows with " << body_length << " byte bodies in " << table_heap->GetPageCount()
+            << " heap pages: narrow scan " << narrow_ms << " ms, full scan " << full_ms << " ms, "
+            << full_ms / narrow_ms << "x" << std::endl;
+  ASSERT_EQ(narrow_sum, full_sum);
+  ASSERT_EQ(static_cast<uint64_t>(row_nums) * OVERFLOW_PREFIX_SIZE, narrow_bytes);
+  ASSERT_EQ(static_cast<uint64_t>(row_nums) * body_length, full_bytes);
+  // inline, every row would take half a page
+  ASSERT_LT(table_heap->GetPageCount(), row_nums / 20);
+  delete table_heap;
+}
@@ -0,0 +1,104 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/b_plus_tree.h"
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/disk_manager.h"
+#include "storage/table_heap.h"
+#include "utils/sql_test_util.h"
+
+static const std::string page_size_db_file = "page_size_test.db";
+
+TEST(PageSizeTest, PageSizePersistTest) {
+  remove(page_size_db_file.c_str());
+  char data[16384], buf[16384];
+  for (size_t i = 0; i < sizeof(data); i++) {
+    data[i] = static_cast<char>(i % 127);
+  }
+  page_id_t page_id;
+  {
+    DiskManager disk_mgr(page_size_db_file, 16384);
+    ASSERT_EQ(16384, disk_mgr.GetPageSize());
+    page_id = disk_mgr.AllocatePage();
+    disk_mgr.WritePage(page_id, data);
+    disk_mgr.Close();
+  }
+  // reopening ignores the requested size in favour of the one recorded in the meta page
+  DiskManager disk_mgr(page_size_db_file);
+  ASSERT_EQ(16384, disk_mgr.GetPageSize());
+  ASSERT_EQ(8 * (16384 - 8), disk_mgr.GetBitmapSize());
+  ASSERT_FALSE(disk_mgr.IsPageFree(page_id));
+  disk_mgr.ReadPage(page_id, buf);
+  ASSERT_EQ(0, memcmp(data, buf, sizeof(data)));
+  disk_mgr.Close();
+  remove(page_size_db_file.c_str());
+}
+
+TEST(PageSizeTest, PageSizeStatementTest) {
+  ExecuteEngine engine;
+  ASSERT_EQ(DB_FAILED, RunSql(engine, "create database page_size_statement page_size = 1000;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create database page_size_statement page_size = 8192;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "use page_size_statement;"));
+  // the option keywords are still plain names where no option is expected
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table t(id int, location char(10), primary key(id));"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create table storage(page_size int, by float, default char(4)) storage = column;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into t values(1, \"here\");"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "insert into storage values(2, 2.5, \"x\");"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "select location from t where location = \"here\";"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "select * from storage where page_size = 2 and by > 1.0;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "create index location on t(location);"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "drop table storage;"));
+  ASSERT_EQ(DB_SUCCESS, RunSql(engine, "drop table t;"));
+  RunSql(engine, "drop database page_size_statement;");
+}
+
+TEST(PageSizeTest, PageSizeBenchmarkTest) {
+  const int row_nums = 20000;
+  const uint32_t page_sizes[] = {4096, 8192, 16384, 32768};
+  int last_depth = INT32_MAX;
+  for (auto page_size : page_sizes) {
+    DBStorageEngine engine("page_size_bench_" + std::to_string(page_size) + ".db", true, DEFAULT_BUFFER_POOL_SIZE,
+                           page_size);
+    ASSERT_EQ(page_size, engine.bpm_->GetPageSize());
+    std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                     new Column("name", TypeId::kTypeChar, 64, 1, false, false),
+                                     new Column("account", TypeId::kTypeFloat, 2, false, false)};
+    Schema schema(columns);
+    std::vector<Column *> key_columns = {new Column("name", TypeId::kTypeChar, 64, 0, false, false)};
+    Schema key_schema(key_columns);
+    KeyManager km(&key_schema, 128);
+    BPlusTree tree(0, engine.bpm_, km);
+    TableHeap *table_heap = TableHeap::Create(engine.bpm_, &schema, nullptr, nullptr, nullptr);
+    GenericKey *key = km.InitKey();
+    char name[65];
+    for (int i = 0; i < row_nums; i++) {
+      snprintf(name, sizeof(name), "%064d", i);
+      std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true),
+                                Field(TypeId::kTypeFloat, 1.0f * i)};
+      Row row(fields);
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+      std::vector<Field> key_fields{Field(TypeId::kTypeChar, name, 64, true)};
+      km.SerializeFromKey(key, Row(key_fields), &key_schema);
+      ASSERT_TRUE(tree.Insert(key, row.GetRowId()));
+    }
+    free(key);
+    auto start = std::chrono::steady_clock::now();
+    int scanned = 0;
+    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+      scanned++;
+    }
+    auto end = std::chrono::steady_clock::now();
+    ASSERT_EQ(row_nums, scanned);
+    // larger pages mean a larger fanout and never a deeper tree
+    int depth = tree.GetDepth();
+    ASSERT_LE(depth, last_depth);
+    last_depth = depth;
+    std::cout << "page size " << page_size << ": index depth " << depth << ", full scan of " << scanned
+              << " rows in " << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+    delete table_heap;
+  }
+}
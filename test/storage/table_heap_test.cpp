@@ -60,3 +60,89 @@ TEST(TableHeapTest, TableHeapSampleTest) {
   }
   ASSERT_EQ(size, 0);
 }
+
+TEST(TableHeapTest, ForwardingUpdateTest) {
+  DBStorageEngine engine("table_heap_forward_test.db", true);
+  const int row_nums = 2000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 255, 1, false, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr);
+  auto make_row = [](int id, size_t len) {
+    std::string name(len, static_cast<char>('a' + id % 26));
+    Fields fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), len, true)};
+    return Row(fields);
+  };
+  auto check_row = [&](const RowId &rid, int id, size_t len) {
+    Row row(rid);
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    ASSERT_EQ(rid, row.GetRowId());
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, id)));
+    ASSERT_EQ(len, row.GetField(1)->GetLength());
+  };
+  auto scan = [&]() {
+    std::unordered_map<int64_t, int> ids;
+    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+      EXPECT_TRUE(ids.emplace(iter->GetRowId().Get(), std::stoi(iter->GetField(0)->toString())).second);
+    }
+    return ids;
+  };
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    Row row = make_row(i, 8);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  uint32_t page_count = table_heap->GetPageCount();
+  // the pages are full, so the grown rows move out and keep their row ids
+  for (int i = 0; i < row_nums; i += 2) {
+    Row row = make_row(i, 200);
+    ASSERT_TRUE(table_heap->UpdateTuple(row, rids[i], nullptr));
+  }
+  ASSERT_GT(table_heap->GetPageCount(), page_count);
+  for (int i = 0; i < row_nums; i++) {
+    check_row(rids[i], i, i % 2 == 0 ? 200 : 8);
+  }
+  auto ids = scan();
+  ASSERT_EQ(row_nums, ids.size());
+  for (int i = 0; i < row_nums; i++) {
+    ASSERT_EQ(i, ids[rids[i].Get()]);
+  }
+  // moved rows grow again without chaining, and shrink back into their home page once it has room
+  for (int i = 0; i < row_nums; i += 2) {
+    Row row = make_row(i, 250);
+    ASSERT_TRUE(table_heap->UpdateTuple(row, rids[i], nullptr));
+  }
+  for (int i = 1; i < row_nums; i += 2) {
+    table_heap->MarkDelete(rids[i], nullptr);
+    table_heap->ApplyDelete(rids[i], nullptr);
+  }
+  for (int i = 0; i < row_nums; i += 2) {
+    Row row = make_row(i, 4);
+    ASSERT_TRUE(table_heap->UpdateTuple(row, rids[i], nullptr));
+    check_row(rids[i], i, 4);
+  }
+  ASSERT_EQ(row_nums / 2, scan().size());
+  for (auto page_id : table_heap->GetPageIds()) {
+    auto page = reinterpret_cast<TablePage *>(engine.bpm_->FetchPage(page_id));
+    ASSERT_FALSE(page->HasForwarding());
+    engine.bpm_->UnpinPage(page_id, false);
+  }
+  // deletes of a moved row reach both its stub and its tuple
+  Row row = make_row(0, 250);
+  ASSERT_TRUE(table_heap->UpdateTuple(row, rids[0], nullptr));
+  Row grown = make_row(2, 250);
+  ASSERT_TRUE(table_heap->UpdateTuple(grown, rids[2], nullptr));
+  ASSERT_TRUE(table_heap->MarkDelete(rids[0], nullptr));
+  ASSERT_TRUE(table_heap->MarkDelete(rids[2], nullptr));
+  ASSERT_EQ(row_nums / 2 - 2, scan().size());
+  Row deleted(rids[0]);
+  ASSERT_FALSE(table_heap->GetTuple(&deleted, nullptr));
+  table_heap->RollbackDelete(rids[0], nullptr);
+  table_heap->ApplyDelete(rids[2], nullptr);
+  check_row(rids[0], 0, 250);
+  ids = scan();
+  ASSERT_EQ(row_nums / 2 - 1, ids.size());
+  ASSERT_EQ(ids.end(), ids.find(rids[2].Get()));
+  delete table_heap;
+}
@@ -0,0 +1,148 @@
+#include "storage/table_iterator.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "page/table_page.h"
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+
+static const std::string iterator_db_file = "table_iterator_test.db";
+
+static Row MakeScanRow(int id) {
+  char name[33];
+  snprintf(name, sizeof(name), "%032d", id);
+  std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, name, 32, true),
+                            Field(TypeId::kTypeFloat, id * 0.5f)};
+  return Row(fields);
+}
+
+static std::vector<Column *> MakeScanColumns() {
+  return {new Column("id", TypeId::kTypeInt, 0, false, false), new Column("name", TypeId::kTypeChar, 32, 1, false, false),
+          new Column("account", TypeId::kTypeFloat, 2, false, false)};
+}
+
+TEST(TableIteratorTest, ScanTest) {
+  DBStorageEngine engine(iterator_db_file, true);
+  Schema schema(MakeScanColumns());
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, &schema, nullptr, nullptr, nullptr);
+  ASSERT_TRUE(table_heap->Begin(nullptr) == table_heap->End());
+  const int row_nums = 5000;
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    Row row = MakeScanRow(i);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  // empty every page but the last, and every third row of the last one
+  page_id_t last_page_id = rids.back().GetPageId();
+  std::vector<bool> deleted(row_nums, false);
+  for (int i = 0; i < row_nums; i++) {
+    if (rids[i].GetPageId() != last_page_id || i % 3 == 0) {
+      ASSERT_TRUE(table_heap->MarkDelete(rids[i], nullptr));
+      table_heap->ApplyDelete(rids[i], nullptr);
+      deleted[i] = true;
+    }
+  }
+  std::vector<int> seen;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+    int id = std::stoi(iter->GetField(0)->toString());
+    ASSERT_EQ(rids[id], iter->GetRowId());
+    seen.push_back(id);
+  }
+  std::vector<int> expected;
+  for (int i = 0; i < row_nums; i++) {
+    if (!deleted[i]) {
+      expected.push_back(i);
+    }
+  }
+  ASSERT_FALSE(expected.empty());
+  ASSERT_EQ(expected, seen);
+  // a postfix increment hands back the row it stepped over
+  auto iter = table_heap->Begin(nullptr);
+  auto old = iter++;
+  ASSERT_EQ(rids[expected[0]], old->GetRowId());
+  ASSERT_EQ(rids[expected[1]], iter->GetRowId());
+  delete table_heap;
+}
+
+/**
+ * The scan the iterator used to do: every step fetches the page to find the next slot, then fetches it again to read
+ * the tuple, and the postfix increment copies the row once more.
+ * @param[out] fetches number of page fetches the scan made
+ */
+static int RowAtATimeScan(TableHeap *table_heap, BufferPoolManager *bpm, page_id_t first_page_id, int &fetches) {
+  int count = 0;
+  fetches = 1;
+  RowId rid;
+  auto page = reinterpret_cast<TablePage *>(bpm->FetchPage(first_page_id));
+  page->GetFirstTupleRid(&rid);
+  bpm->UnpinPage(first_page_id, false);
+  while (rid.GetPageId() != INVALID_PAGE_ID) {
+    Row row(rid);
+    table_heap->GetTuple(&row, nullptr);
+    Row copy(row);
+    count++;
+    fetches += 2;
+    page = reinterpret_cast<TablePage *>(bpm->FetchPage(rid.GetPageId()));
+    page->RLatch();
+    RowId next_rid;
+    if (!page->GetNextTupleRid(rid, &next_rid)) {
+      while (page->GetNextPageId() != INVALID_PAGE_ID) {
+        auto next_page = reinterpret_cast<TablePage *>(bpm->FetchPage(page->GetNextPageId()));
+        fetches++;
+        page->RUnlatch();
+        bpm->UnpinPage(page->GetTablePageId(), false);
+        page = next_page;
+        page->RLatch();
+        if (page->GetFirstTupleRid(&next_rid)) {
+          break;
+        }
+      }
+    }
+    page->RUnlatch();
+    bpm->UnpinPage(page->GetTablePageId(), false);
+    rid = next_rid;
+  }
+  return count;
+}
+
+TEST(TableIteratorTest, ScanBenchmarkTest) {
+  DBStorageEngine engine("table_iterator_bench.db", true);
+  Schema schema(MakeScanColumns());
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, &schema, nullptr, nullptr, nullptr);
+  const int row_nums = 200000;
+  for (int i = 0; i < row_nums; i++) {
+    Row row = MakeScanRow(i);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  int fetches_before = 0;
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_EQ(row_nums, RowAtATimeScan(table_heap, engine.bpm_, table_heap->GetFirstPageId(), fetches_before));
+  auto middle = std::chrono::steady_clock::now();
+  // the iterator decodes a page at once, so the rows of a page come in one run and each run is one fetch
+  int count = 0;
+  int fetches_after = 0;
+  page_id_t page_id = INVALID_PAGE_ID;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+    if (iter->GetRowId().GetPageId() != page_id) {
+      page_id = iter->GetRowId().GetPageId();
+      fetches_after++;
+    }
+    count++;
+  }
+  auto end = std::chrono::steady_clock::now();
+  ASSERT_EQ(row_nums, count);
+  ASSERT_EQ(table_heap->GetPageCount(), fetches_after);
+  ASSERT_GE(fetches_before, 2 * row_nums);
+  double before_ms = std::chrono::duration<double, std::milli>(middle - start).count();
+  double after_ms = std::chrono::duration<double, std::milli>(end - middle).count();
+  std::cout << row_nums << " rows: row at a time " << row_nums / before_ms * 1000 << " tuples/s, " << fetches_before
+            << " fetches, page at a time " << row_nums / after_ms * 1000 << " tuples/s, " << fetches_after
+            << " fetches" << std::endl;
+  delete table_heap;
+}
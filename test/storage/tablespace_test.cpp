@@ -0,0 +1,180 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk_manager.h"
+#include "storage/table_heap.h"
+
+static const std::string tablespace_db_file = "tablespace_test.db";
+
+TEST(TablespaceTest, TablespaceRoutingTest) {
+  DiskManager::RemoveDatabaseFiles(tablespace_db_file);
+  char data[PAGE_SIZE], buf[PAGE_SIZE];
+  page_id_t default_page, space_page;
+  uint32_t space_id;
+  {
+    DiskManager disk_mgr(tablespace_db_file);
+    ASSERT_EQ(DB_SUCCESS, disk_mgr.CreateTablespace("ts1", "", space_id));
+    ASSERT_EQ(DB_ALREADY_EXIST, disk_mgr.CreateTablespace("ts1", "", space_id));
+    ASSERT_NE(DEFAULT_TABLESPACE_ID, space_id);
+    default_page = disk_mgr.AllocatePage();
+    space_page = disk_mgr.AllocatePage(space_id);
+    // the first page of every file has the same local id, only the tablespace tells them apart
+    ASSERT_EQ(DEFAULT_TABLESPACE_ID, DiskManager::GetTablespaceId(default_page));
+    ASSERT_EQ(space_id, DiskManager::GetTablespaceId(space_page));
+    ASSERT_NE(default_page, space_page);
+    memset(data, 'a', PAGE_SIZE);
+    disk_mgr.WritePage(default_page, data);
+    memset(data, 'b', PAGE_SIZE);
+    disk_mgr.WritePage(space_page, data);
+    disk_mgr.Close();
+  }
+  ASSERT_TRUE(std::filesystem::exists(tablespace_db_file + ".ts1.ts"));
+  DiskManager disk_mgr(tablespace_db_file);
+  uint32_t reloaded_id;
+  ASSERT_EQ(DB_SUCCESS, disk_mgr.GetTablespaceId("ts1", reloaded_id));
+  ASSERT_EQ(space_id, reloaded_id);
+  ASSERT_EQ(DB_NOT_EXIST, disk_mgr.GetTablespaceId("ts2", reloaded_id));
+  ASSERT_FALSE(disk_mgr.IsPageFree(space_page));
+  disk_mgr.ReadPage(default_page, buf);
+  ASSERT_EQ('a', buf[PAGE_SIZE - 1]);
+  disk_mgr.ReadPage(space_page, buf);
+  ASSERT_EQ('b', buf[PAGE_SIZE - 1]);
+  disk_mgr.DeAllocatePage(space_page);
+  ASSERT_TRUE(disk_mgr.IsPageFree(space_page));
+  ASSERT_FALSE(disk_mgr.IsPageFree(default_page));
+  disk_mgr.Close();
+  DiskManager::RemoveDatabaseFiles(tablespace_db_file);
+  ASSERT_FALSE(std::filesystem::exists(tablespace_db_file + ".ts1.ts"));
+}
+
+TEST(TablespaceTest, TablespaceLocationTest) {
+  const std::string location = "tablespace test location.ts";
+  DiskManager::RemoveDatabaseFiles(tablespace_db_file);
+  remove(location.c_str());
+  // an existing file is never taken over
+  FILE *file = fopen(location.c_str(), "w");
+  ASSERT_NE(nullptr, file);
+  fputs("not a tablespace", file);
+  fclose(file);
+  uint32_t space_id;
+  {
+    DiskManager disk_mgr(tablespace_db_file);
+    ASSERT_EQ(DB_ALREADY_EXIST, disk_mgr.CreateTablespace("ts1", location, space_id));
+    ASSERT_EQ(DB_NOT_EXIST, disk_mgr.GetTablespaceId("ts1", space_id));
+    disk_mgr.Close();
+  }
+  ASSERT_EQ(strlen("not a tablespace"), std::filesystem::file_size(location));
+  remove(location.c_str());
+  // a path with spaces survives the tablespace list
+  page_id_t page_id;
+  {
+    DiskManager disk_mgr(tablespace_db_file);
+    ASSERT_EQ(DB_SUCCESS, disk_mgr.CreateTablespace("ts1", location, space_id));
+    page_id = disk_mgr.AllocatePage(space_id);
+    disk_mgr.Close();
+  }
+  ASSERT_TRUE(std::filesystem::exists(location));
+  {
+    DiskManager disk_mgr(tablespace_db_file);
+    uint32_t reloaded_id;
+    ASSERT_EQ(DB_SUCCESS, disk_mgr.GetTablespaceId("ts1", reloaded_id));
+    ASSERT_EQ(space_id, reloaded_id);
+    ASSERT_FALSE(disk_mgr.IsPageFree(page_id));
+    disk_mgr.Close();
+  }
+  DiskManager::RemoveDatabaseFiles(tablespace_db_file);
+  ASSERT_FALSE(std::filesystem::exists(location));
+}
+
+TEST(TablespaceTest, TablespaceCatalogTest) {
+  const int row_nums = 1000;
+  uint32_t space_id;
+  {
+    DBStorageEngine engine(tablespace_db_file, true);
+    ASSERT_EQ(DB_SUCCESS, engine.disk_mgr_->CreateTablespace("ts1", "", space_id));
+    std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, true),
+                                     new Column("name", TypeId::kTypeChar, 32, 1, true, false)};
+    auto *schema = new Schema(columns);
+    Transaction txn;
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable("t", schema, &txn, table_info, space_id));
+    IndexInfo *index_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateIndex("t", "idx", {"id"}, &txn, index_info, "bptree", space_id));
+    char name[33];
+    for (int i = 0; i < row_nums; i++) {
+      snprintf(name, sizeof(name), "name-%d", i);
+      std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, strlen(name), true)};
+      Row row(fields);
+      ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+      std::vector<Field> key_fields{Field(TypeId::kTypeInt, i)};
+      ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(Row(key_fields), row.GetRowId(), &txn));
+    }
+    delete schema;
+  }
+  DBStorageEngine engine(tablespace_db_file, false);
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetTable("t", table_info));
+  ASSERT_EQ(space_id, DiskManager::GetTablespaceId(table_info->GetRootPageId()));
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->GetIndex("t", "idx", index_info));
+  ASSERT_EQ(space_id, index_info->GetTablespaceId());
+  int scanned = 0;
+  for (auto iter = table_info->GetTableHeap()->Begin(nullptr); iter != table_info->GetTableHeap()->End(); ++iter) {
+    ASSERT_EQ(space_id, DiskManager::GetTablespaceId(iter->GetRowId().GetPageId()));
+    scanned++;
+  }
+  ASSERT_EQ(row_nums, scanned);
+  std::vector<Field> key_fields{Field(TypeId::kTypeInt, row_nums / 2)};
+  std::vector<RowId> result;
+  ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(Row(key_fields), result, nullptr));
+  ASSERT_EQ(1, result.size());
+  ASSERT_EQ(space_id, DiskManager::GetTablespaceId(result[0].GetPageId()));
+}
+
+TEST(TablespaceTest, TablespaceParallelIOBenchmarkTest) {
+  const int page_nums = 2000;
+  DiskManager::RemoveDatabaseFiles(tablespace_db_file);
+  DiskManager disk_mgr(tablespace_db_file);
+  uint32_t space_ids[2] = {DEFAULT_TABLESPACE_ID, 0};
+  ASSERT_EQ(DB_SUCCESS, disk_mgr.CreateTablespace("ts1", "", space_ids[1]));
+  std::vector<page_id_t> page_ids[2];
+  for (int s = 0; s < 2; s++) {
+    for (int i = 0; i < page_nums; i++) {
+      page_ids[s].push_back(disk_mgr.AllocatePage(space_ids[s]));
+    }
+  }
+  auto write_pages = [&disk_mgr](const std::vector<page_id_t> &ids) {
+    char data[PAGE_SIZE];
+    for (auto page_id : ids) {
+      memset(data, page_id & 0x7f, PAGE_SIZE);
+      disk_mgr.WritePage(page_id, data);
+    }
+  };
+  auto start = std::chrono::steady_clock::now();
+  write_pages(page_ids[0]);
+  write_pages(page_ids[1]);
+  auto serial = std::chrono::steady_clock::now() - start;
+  start = std::chrono::steady_clock::now();
+  std::thread writer(write_pages, std::cref(page_ids[1]));
+  write_pages(page_ids[0]);
+  writer.join();
+  auto parallel = std::chrono::steady_clock::now() - start;
+  char buf[PAGE_SIZE];
+  for (auto &ids : page_ids) {
+    for (auto page_id : ids) {
+      disk_mgr.ReadPage(page_id, buf);
+      ASSERT_EQ(page_id & 0x7f, buf[PAGE_SIZE - 1]);
+    }
+  }
+  std::cout << "writing " << 2 * page_nums << " pages to two files: serial "
+            << std::chrono::duration<double, std::milli>(serial).count() << " ms, parallel "
+            << std::chrono::duration<double, std::milli>(parallel).count() << " ms" << std::endl;
+  disk_mgr.Close();
+  DiskManager::RemoveDatabaseFiles(tablespace_db_file);
+}